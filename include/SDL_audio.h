@@ -520,6 +520,24 @@ extern DECLSPEC int SDLCALL SDL_BuildAudioCVT(SDL_AudioCVT * cvt,
  */
 extern DECLSPEC int SDLCALL SDL_ConvertAudio(SDL_AudioCVT * cvt);
 
+/**
+ *  Converts several independent buffers at once, as if by calling
+ *  SDL_ConvertAudio() on each element of \c cvts, spreading the work across
+ *  SDL's worker threads. This is meant for converting many sounds at load
+ *  time. Each \c cvt must be set up like it would be for SDL_ConvertAudio(),
+ *  and no two may share a buffer.
+ *
+ *  Nothing is converted unless every \c cvt has a buffer.
+ *
+ *  \param cvts An array of \c count conversions to run.
+ *  \param count The number of elements in \c cvts.
+ *  \return 0 on success or -1 if \c cvts is NULL or any \c buf is NULL.
+ *
+ *  \sa SDL_BuildAudioCVT
+ *  \sa SDL_ConvertAudio
+ */
+extern DECLSPEC int SDLCALL SDL_ConvertAudioBatch(SDL_AudioCVT * cvts, int count);
+
 /* SDL_AudioStream is a new audio conversion interface.
    The benefits vs SDL_AudioCVT:
     - it can handle resampling data in chunks without generating
@@ -634,6 +652,36 @@ extern DECLSPEC int SDLCALL SDL_AudioStreamFlush(SDL_AudioStream *stream);
  */
 extern DECLSPEC void SDLCALL SDL_AudioStreamClear(SDL_AudioStream *stream);
 
+/**
+ *  Resampler quality levels for SDL_AudioStreamSetResampleQuality().
+ *
+ *  Higher levels sound cleaner and cost more CPU time per sample frame.
+ */
+typedef enum
+{
+    SDL_RESAMPLE_NEAREST,   /**< Repeat or drop sample frames. Cheapest, very audible aliasing. */
+    SDL_RESAMPLE_LINEAR,    /**< Straight line between neighbouring sample frames. */
+    SDL_RESAMPLE_CUBIC,     /**< Catmull-Rom spline through four sample frames. */
+    SDL_RESAMPLE_SINC_LOW,  /**< Short windowed sinc filter. The default. */
+    SDL_RESAMPLE_SINC_HIGH  /**< Long windowed sinc filter with a steep, anti-aliased cutoff. */
+} SDL_AudioResampleQuality;
+
+/**
+ *  Set how an audio stream resamples, if it resamples at all.
+ *
+ *  This replaces the libsamplerate resampler, if SDL_HINT_AUDIO_RESAMPLING_MODE
+ *  selected it, with SDL's own resampler at the requested quality. It is
+ *  safe to call between SDL_AudioStreamPut() calls.
+ *
+ *  \param stream The stream to change
+ *  \param quality The resampler quality level to use
+ *  \return 0 on success, or -1 on error.
+ *
+ *  \sa SDL_NewAudioStream
+ *  \sa SDL_AudioStreamPut
+ */
+extern DECLSPEC int SDLCALL SDL_AudioStreamSetResampleQuality(SDL_AudioStream *stream, SDL_AudioResampleQuality quality);
+
 /**
  * Free an audio stream
  *
@@ -646,6 +694,100 @@ extern DECLSPEC void SDLCALL SDL_AudioStreamClear(SDL_AudioStream *stream);
  */
 extern DECLSPEC void SDLCALL SDL_FreeAudioStream(SDL_AudioStream *stream);
 
+/* SDL_WAVStream reads a WAVE file a piece at a time, instead of loading and
+ * decoding all of it up front like SDL_LoadWAV_RW() does.
+ */
+struct _SDL_WAVStream;
+typedef struct _SDL_WAVStream SDL_WAVStream;
+
+/**
+ *  Open a WAVE file for streaming.
+ *
+ *  This parses the headers the same way SDL_LoadWAV_RW() does, honoring the
+ *  same hints, and fills \c spec with the format SDL_WAVStreamRead() will
+ *  produce. None of the audio data is read yet. The data source must
+ *  support seeking and stays in use until SDL_CloseWAVStream().
+ *
+ *  \param src The data source with the WAVE data
+ *  \param freesrc A integer value that makes SDL_CloseWAVStream() (or this
+ *                 function, on error) close the data source if non-zero
+ *  \param spec A pointer filled with the audio format of the decoded data
+ *  \return the new stream, or NULL on error.
+ *
+ *  \sa SDL_WAVStreamRead
+ *  \sa SDL_WAVStreamPut
+ *  \sa SDL_WAVStreamSeek
+ *  \sa SDL_CloseWAVStream
+ */
+extern DECLSPEC SDL_WAVStream * SDLCALL SDL_OpenWAVStream_RW(SDL_RWops * src,
+                                                            int freesrc,
+                                                            SDL_AudioSpec * spec);
+
+/**
+ *  Opens a WAVE file for streaming from a file.
+ */
+#define SDL_OpenWAVStream(file, spec) \
+    SDL_OpenWAVStream_RW(SDL_RWFromFile(file, "rb"), 1, spec)
+
+/**
+ *  Get the total length of a WAVE stream, in sample frames.
+ *
+ *  \return the number of sample frames, or -1 on error.
+ */
+extern DECLSPEC Sint64 SDLCALL SDL_WAVStreamLength(SDL_WAVStream *wav);
+
+/**
+ *  Get the sample frame the next read from a WAVE stream starts at.
+ *
+ *  \return the sample frame, or -1 on error.
+ */
+extern DECLSPEC Sint64 SDLCALL SDL_WAVStreamTell(SDL_WAVStream *wav);
+
+/**
+ *  Decode audio from a WAVE stream into a buffer.
+ *
+ *  Compressed data is decoded one block at a time, as it is needed. Only
+ *  whole sample frames are written.
+ *
+ *  \param wav The stream to read from
+ *  \param buf The buffer to fill, in the format from SDL_OpenWAVStream_RW()
+ *  \param len The size of the buffer in bytes
+ *  \return the number of bytes written, 0 at the end of the data, or -1 on
+ *          error.
+ */
+extern DECLSPEC int SDLCALL SDL_WAVStreamRead(SDL_WAVStream *wav, void *buf, int len);
+
+/**
+ *  Decode audio from a WAVE stream into an audio stream.
+ *
+ *  This is like SDL_WAVStreamRead(), but hands each decoded block straight
+ *  to SDL_AudioStreamPut(), so the data is only copied once. The audio
+ *  stream's source format must match the spec from SDL_OpenWAVStream_RW().
+ *
+ *  \param wav The stream to read from
+ *  \param stream The audio stream to put the decoded audio into
+ *  \param len The most bytes of decoded audio to put
+ *  \return the number of bytes put, 0 at the end of the data, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_WAVStreamPut(SDL_WAVStream *wav, SDL_AudioStream *stream, int len);
+
+/**
+ *  Move a WAVE stream to another sample frame.
+ *
+ *  This jumps straight to the compressed block that holds the frame and
+ *  decodes only that block, so seeking costs the same anywhere in the file.
+ *
+ *  \param wav The stream to seek
+ *  \param frame The sample frame to seek to, clamped to the length
+ *  \return 0 on success, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_WAVStreamSeek(SDL_WAVStream *wav, Sint64 frame);
+
+/**
+ *  Close a WAVE stream, and its data source if it was opened with freesrc.
+ */
+extern DECLSPEC void SDLCALL SDL_CloseWAVStream(SDL_WAVStream *wav);
+
 #define SDL_MIX_MAXVOLUME 128
 /**
  *  This takes two audio buffers of the playing audio format and mixes
@@ -686,6 +828,11 @@ extern DECLSPEC void SDLCALL SDL_MixAudioFormat(Uint8 * dst,
  *  the difference. This means you will have skips in your audio playback
  *  if you aren't routinely queueing sufficient data.
  *
+ *  The audio thread reads queued data from a lock-free ring, sized by
+ *  SDL_HINT_AUDIO_QUEUE_SIZE. Queueing more than fits makes this function
+ *  allocate a bigger ring (and counts as an overrun, see
+ *  SDL_GetQueuedAudioStats()); the audio thread itself never allocates.
+ *
  *  This function copies the supplied data, so you are safe to free it when
  *  the function returns. This function is thread-safe, but queueing to the
  *  same device from two threads at once does not promise which buffer will
@@ -826,6 +973,201 @@ extern DECLSPEC Uint32 SDLCALL SDL_GetQueuedAudioSize(SDL_AudioDeviceID dev);
  */
 extern DECLSPEC void SDLCALL SDL_ClearQueuedAudio(SDL_AudioDeviceID dev);
 
+/**
+ *  Get underrun and overrun counts for a non-callback device's queue.
+ *
+ *  For playback devices, an underrun is each time the device ran out of
+ *  queued audio and had to play silence (a long stretch of silence counts
+ *  once), and an overrun is each time SDL_QueueAudio() was given more than
+ *  the queue could hold and had to allocate more room. Tune
+ *  SDL_HINT_AUDIO_QUEUE_SIZE so the latter doesn't happen in steady state.
+ *
+ *  For capture devices, an overrun is each time the device captured more
+ *  than there was room for because the app didn't dequeue fast enough; the
+ *  newest data is dropped. Capture devices never count underruns.
+ *
+ *  Counts start at zero when the device is opened, and wrap around.
+ *
+ *  \param dev The device ID to query.
+ *  \param underruns Filled in with the underrun count. May be NULL.
+ *  \param overruns Filled in with the overrun count. May be NULL.
+ *  \return 0 on success, or -1 on error (including if the device is using
+ *          an application-supplied callback).
+ *
+ *  \sa SDL_QueueAudio
+ *  \sa SDL_DequeueAudio
+ */
+extern DECLSPEC int SDLCALL SDL_GetQueuedAudioStats(SDL_AudioDeviceID dev, Uint32 *underruns, Uint32 *overruns);
+
+
+/**
+ *  Number of buckets in SDL_AudioDeviceStats::jitter_histogram.
+ */
+#define SDL_AUDIO_JITTER_BUCKETS 12
+
+/**
+ *  Timing of an open device's callbacks, from SDL_GetAudioDeviceStats().
+ *
+ *  A device's callbacks should start one buffer's length apart. Jitter is
+ *  how far the time between two callbacks was from that. Lateness is how
+ *  long after its place on an evenly spaced schedule a callback started;
+ *  the schedule starts over at the callback after any that was a whole
+ *  buffer or more late, or that started early.
+ *
+ *  Bucket 0 of the histogram counts callbacks with under 32 microseconds of
+ *  jitter, bucket n those under (32 << n) microseconds, and the last bucket
+ *  everything longer.
+ */
+typedef struct SDL_AudioDeviceStats
+{
+    Uint32 callbacks;           /**< Callbacks run since the device was opened */
+    Uint32 late_callbacks;      /**< Callbacks that started a buffer or more late */
+    Uint32 period_us;           /**< The length of one buffer, in microseconds */
+    Uint32 max_jitter_us;       /**< Most jitter seen, in microseconds */
+    Uint32 max_lateness_us;     /**< Most lateness seen, in microseconds */
+    Uint32 max_callback_us;     /**< Longest a callback took, in microseconds */
+    Uint32 jitter_histogram[SDL_AUDIO_JITTER_BUCKETS]; /**< Callbacks by jitter */
+} SDL_AudioDeviceStats;
+
+/**
+ *  Get timing statistics for an open device's callbacks.
+ *
+ *  This works for devices with and without an application callback; for
+ *  the latter, it's the times SDL takes data from the queue. Callbacks
+ *  aren't timed while the device is paused, and the first after unpausing
+ *  has no jitter or lateness. Counts wrap around.
+ *
+ *  \param dev The device ID to query.
+ *  \param stats Filled in with the statistics.
+ *  \return 0 on success, or -1 on error.
+ *
+ *  \sa SDL_HINT_AUDIO_DEADLINE_SCHEDULING
+ */
+extern DECLSPEC int SDLCALL SDL_GetAudioDeviceStats(SDL_AudioDeviceID dev, SDL_AudioDeviceStats * stats);
+
+/**
+ *  \name Audio voices
+ *
+ *  A voice is a stream of audio in any format that SDL mixes into a
+ *  non-callback playback device, on top of anything queued with
+ *  SDL_QueueAudio(). Each voice converts and resamples its own data to the
+ *  device's format, and has its own gain and pan, which change smoothly over
+ *  one device buffer instead of jumping. All playing voices are summed as
+ *  floats and then mixed into the device's buffer in a single pass.
+ *
+ *  Voices can be started and stopped from any thread without blocking the
+ *  audio device, and without blocking each other. Each voice's other
+ *  functions should only be called from one thread at a time.
+ */
+/* @{ */
+struct _SDL_AudioVoice;
+typedef struct _SDL_AudioVoice SDL_AudioVoice;
+
+/**
+ *  Create a voice for a non-callback playback device.
+ *
+ *  The new voice is stopped and has nothing queued; its gain is 1.0 and its
+ *  pan is 0.0.
+ *
+ *  \param dev The device ID the voice will play on. It must be a playback
+ *             device opened without a callback.
+ *  \param format The format of the data you'll put into the voice.
+ *  \param channels The number of channels of the data.
+ *  \param rate The sample rate of the data.
+ *  \return the new voice, or NULL on error.
+ *
+ *  \sa SDL_AudioVoicePut
+ *  \sa SDL_PlayAudioVoice
+ *  \sa SDL_FreeAudioVoice
+ */
+extern DECLSPEC SDL_AudioVoice * SDLCALL SDL_NewAudioVoice(SDL_AudioDeviceID dev,
+                                                           SDL_AudioFormat format,
+                                                           Uint8 channels,
+                                                           int rate);
+
+/**
+ *  Queue more audio on a voice.
+ *
+ *  Like SDL_QueueAudio(), this copies the data, and the voice's queue grows
+ *  as needed. The voice keeps playing whatever is queued, and plays silence
+ *  when it runs out, until it's stopped.
+ *
+ *  \param voice The voice to queue audio on.
+ *  \param data The data, in the format the voice was created with.
+ *  \param len The number of bytes to queue. This must be a whole number of
+ *             sample frames.
+ *  \return 0 on success, or -1 on error.
+ *
+ *  \sa SDL_AudioVoiceQueued
+ */
+extern DECLSPEC int SDLCALL SDL_AudioVoicePut(SDL_AudioVoice * voice, const void *data, Uint32 len);
+
+/**
+ *  Get the number of bytes queued on a voice that it hasn't started to play.
+ *
+ *  A few more sample frames may still be held inside the voice's resampler.
+ *
+ *  \param voice The voice to query.
+ *  \return Number of bytes (not samples!) still queued.
+ */
+extern DECLSPEC Uint32 SDLCALL SDL_AudioVoiceQueued(SDL_AudioVoice * voice);
+
+/**
+ *  Start mixing a voice into its device.
+ *
+ *  Playing a voice that's already playing does nothing. Playing a voice
+ *  that's being stopped cancels the stop.
+ *
+ *  \param voice The voice to play.
+ *  \return 0 on success, or -1 on error (such as the voice's device having
+ *          been closed).
+ *
+ *  \sa SDL_StopAudioVoice
+ */
+extern DECLSPEC int SDLCALL SDL_PlayAudioVoice(SDL_AudioVoice * voice);
+
+/**
+ *  Stop mixing a voice into its device.
+ *
+ *  This returns right away; the voice stops at the device's next buffer.
+ *  Its queued audio is kept, so playing it again picks up where it left off.
+ *
+ *  \param voice The voice to stop.
+ *
+ *  \sa SDL_PlayAudioVoice
+ */
+extern DECLSPEC void SDLCALL SDL_StopAudioVoice(SDL_AudioVoice * voice);
+
+/**
+ *  Set a voice's gain.
+ *
+ *  \param voice The voice to change.
+ *  \param gain The new gain. 1.0 plays the voice as is, 0.0 silences it.
+ */
+extern DECLSPEC void SDLCALL SDL_SetAudioVoiceGain(SDL_AudioVoice * voice, float gain);
+
+/**
+ *  Set a voice's pan, for stereo devices.
+ *
+ *  \param voice The voice to change.
+ *  \param pan The new pan, from -1.0 (which silences the right channel) to
+ *             1.0 (which silences the left channel). 0.0 leaves both
+ *             channels alone. Ignored on devices that aren't stereo.
+ */
+extern DECLSPEC void SDLCALL SDL_SetAudioVoicePan(SDL_AudioVoice * voice, float pan);
+
+/**
+ *  Free a voice, stopping it first if needed.
+ *
+ *  This returns right away. If the voice was playing, its memory is
+ *  reclaimed after the device's next buffer. Voices still around when their
+ *  device is closed stop, and must still be freed.
+ *
+ *  \param voice The voice to free.
+ */
+extern DECLSPEC void SDLCALL SDL_FreeAudioVoice(SDL_AudioVoice * voice);
+/* @} *//* Audio voices */
+
 
 /**
  *  \name Audio lock functions
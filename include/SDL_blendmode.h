@@ -50,6 +50,11 @@ typedef enum
     SDL_BLENDMODE_MOD = 0x00000004,      /**< color modulate
                                               dstRGB = srcRGB * dstRGB
                                               dstA = dstA */
+    SDL_BLENDMODE_BLEND_PREMULTIPLIED = 0x00000010, /**< pre-multiplied alpha blending
+                                              dstRGBA = srcRGBA + (dstRGBA * (1-srcA)) */
+    SDL_BLENDMODE_ADD_PREMULTIPLIED = 0x00000020,   /**< pre-multiplied additive blending
+                                              dstRGB = srcRGB + dstRGB
+                                              dstA = dstA */
     SDL_BLENDMODE_INVALID = 0x7FFFFFFF
 
     /* Additional custom blend modes can be returned by SDL_ComposeCustomBlendMode() */
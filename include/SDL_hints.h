@@ -223,6 +223,20 @@ extern "C" {
  */
 #define SDL_HINT_VIDEO_X11_NET_WM_BYPASS_COMPOSITOR "SDL_VIDEO_X11_NET_WM_BYPASS_COMPOSITOR"
 
+/**
+ *  \brief  A variable controlling how many MIT-SHM images the X11 window surface uses
+ *
+ *  This variable can be set to the following values:
+ *    "1"       - The X server reads the window surface directly and
+ *                SDL_UpdateWindowSurface() waits for it to finish
+ *    "2"       - The updated areas are copied to a second image, so the
+ *                application can draw the next frame while the server reads it
+ *    "3"       - Like "2", but with two images to alternate between
+ *
+ *  By default SDL uses 2 images. The hint is checked when the window surface is created.
+ */
+#define SDL_HINT_VIDEO_X11_SHM_BUFFERS "SDL_VIDEO_X11_SHM_BUFFERS"
+
 /**
  *  \brief  A variable controlling whether the window frame and title bar are interactive when the cursor is hidden 
  *
@@ -1049,6 +1063,40 @@ extern "C" {
  */
 #define SDL_HINT_AUDIO_RESAMPLING_MODE   "SDL_AUDIO_RESAMPLING_MODE"
 
+/**
+ *  \brief  A variable controlling how much audio a non-callback device's queue holds.
+ *
+ *  This is in milliseconds of audio in the format the device was opened
+ *  with. SDL_QueueAudio() allocates a bigger queue if it's handed more than
+ *  fits; capture devices drop data that doesn't fit. Either way, the audio
+ *  thread never allocates or locks to get at the queue.
+ *
+ *  The queue always holds at least two callbacks' worth of audio.
+ *
+ *  This hint is checked when the audio device is opened. The default is 500.
+ */
+#define SDL_HINT_AUDIO_QUEUE_SIZE   "SDL_AUDIO_QUEUE_SIZE"
+
+/**
+ *  \brief  A variable controlling how the audio thread keeps time when it has no device to wait on.
+ *
+ *  When a device is disconnected, or the driver doesn't block (like the
+ *  dummy and disk drivers), the audio thread sleeps for a buffer's worth of
+ *  time between callbacks.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Sleep for a buffer's length each time, so time spent in the
+ *                callback and oversleeping add up and the callbacks drift
+ *                late (default)
+ *    "1"       - Sleep until an absolute deadline for each buffer, computed
+ *                from SDL_GetPerformanceCounter(), with the highest
+ *                resolution sleep the platform has
+ *
+ *  Either way, SDL_GetAudioDeviceStats() reports how evenly the callbacks
+ *  ran. This hint is checked when the audio device is opened.
+ */
+#define SDL_HINT_AUDIO_DEADLINE_SCHEDULING   "SDL_AUDIO_DEADLINE_SCHEDULING"
+
 /**
  *  \brief  A variable controlling the audio category on iOS and Mac OS X
  *
@@ -1174,6 +1222,57 @@ extern "C" {
  */
 #define SDL_HINT_WAVE_FACT_CHUNK   "SDL_WAVE_FACT_CHUNK"
 
+/**
+ *  \brief  A variable controlling how many threads convert large YUV frames to RGB
+ *
+ *  SDL_ConvertPixels() and YUV textures on renderers without YUV support
+ *  split frames of 720p and larger into bands of rows that are converted
+ *  on SDL's worker threads at the same time.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Use one band per CPU core (default)
+ *    "1"       - Convert the whole frame on the calling thread
+ *    "N"       - Split the frame into at most N bands
+ */
+#define SDL_HINT_YUV_CONVERSION_THREADS "SDL_YUV_CONVERSION_THREADS"
+
+/**
+ *  \brief  A variable controlling how much pixel memory the surface pool keeps
+ *
+ *  The pixels of freed surfaces are kept for reuse by new surfaces of a
+ *  similar size, up to this many bytes in total.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Free surface pixels right away
+ *    "N"       - Keep up to N bytes of pixels (default 33554432, 32 MB)
+ */
+#define SDL_HINT_SURFACE_POOL_SIZE "SDL_SURFACE_POOL_SIZE"
+
+/**
+ *  \brief  A variable controlling whether large SIMD allocations use huge pages
+ *
+ *  On Linux, SDL_SIMDAlloc() can map blocks of 4 MB and larger, such as the
+ *  pixels of big surfaces, directly from the system so that they can be
+ *  backed by huge pages, which cuts TLB misses when blitting them. Those
+ *  blocks bypass any functions set with SDL_SetMemoryFunctions() and aren't
+ *  counted by SDL_GetNumAllocations().
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Allocate large blocks from the heap like small ones (default)
+ *    "1"       - Ask for transparent huge pages
+ *    "2"       - Use reserved hugetlbfs pages when available, falling back to transparent huge pages
+ */
+#define SDL_HINT_SIMD_HUGEPAGES "SDL_SIMD_HUGEPAGES"
+
+/**
+ *  \brief  A variable controlling whether large SIMD allocations stay on the local NUMA node
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Use the default memory policy of the process (default)
+ *    "1"       - Prefer the NUMA node of the thread calling SDL_SIMDAlloc()
+ */
+#define SDL_HINT_SIMD_NUMA_LOCAL "SDL_SIMD_NUMA_LOCAL"
+
 /**
  *  \brief  An enumeration of hint priorities
  */
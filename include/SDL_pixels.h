@@ -129,7 +129,10 @@ enum
     (SDL_ISPIXELFORMAT_FOURCC(X) ? \
         ((((X) == SDL_PIXELFORMAT_YUY2) || \
           ((X) == SDL_PIXELFORMAT_UYVY) || \
-          ((X) == SDL_PIXELFORMAT_YVYU)) ? 2 : 1) : (((X) >> 0) & 0xFF))
+          ((X) == SDL_PIXELFORMAT_YVYU) || \
+          ((X) == SDL_PIXELFORMAT_P010) || \
+          ((X) == SDL_PIXELFORMAT_P016) || \
+          ((X) == SDL_PIXELFORMAT_I010)) ? 2 : 1) : (((X) >> 0) & 0xFF))
 
 #define SDL_ISPIXELFORMAT_INDEXED(format)   \
     (!SDL_ISPIXELFORMAT_FOURCC(format) && \
@@ -167,6 +170,22 @@ enum
 #define SDL_ISPIXELFORMAT_FOURCC(format)    \
     ((format) && (SDL_PIXELFLAG(format) != 1))
 
+/* Block compressed formats are FOURCC formats made of fixed size blocks of pixels */
+#define SDL_ISPIXELFORMAT_COMPRESSED(format)    \
+    (((format) == SDL_PIXELFORMAT_BC1) || \
+     ((format) == SDL_PIXELFORMAT_BC2) || \
+     ((format) == SDL_PIXELFORMAT_BC3) || \
+     ((format) == SDL_PIXELFORMAT_BC4) || \
+     ((format) == SDL_PIXELFORMAT_BC5) || \
+     ((format) == SDL_PIXELFORMAT_BC7) || \
+     ((format) == SDL_PIXELFORMAT_ETC2_RGB8) || \
+     ((format) == SDL_PIXELFORMAT_ETC2_RGB8A1) || \
+     ((format) == SDL_PIXELFORMAT_ETC2_RGBA8) || \
+     ((format) == SDL_PIXELFORMAT_ASTC_4x4) || \
+     ((format) == SDL_PIXELFORMAT_ASTC_5x5) || \
+     ((format) == SDL_PIXELFORMAT_ASTC_6x6) || \
+     ((format) == SDL_PIXELFORMAT_ASTC_8x8))
+
 /* Note: If you modify this list, update SDL_GetPixelFormatName() */
 typedef enum
 {
@@ -288,8 +307,42 @@ typedef enum
         SDL_DEFINE_PIXELFOURCC('N', 'V', '1', '2'),
     SDL_PIXELFORMAT_NV21 =      /**< Planar mode: Y + V/U interleaved  (2 planes) */
         SDL_DEFINE_PIXELFOURCC('N', 'V', '2', '1'),
+    SDL_PIXELFORMAT_P010 =      /**< Planar mode: Y + U/V interleaved, 16-bit samples
+                                     with 10 bits in the high bits  (2 planes) */
+        SDL_DEFINE_PIXELFOURCC('P', '0', '1', '0'),
+    SDL_PIXELFORMAT_P016 =      /**< Planar mode: Y + U/V interleaved, 16-bit samples  (2 planes) */
+        SDL_DEFINE_PIXELFOURCC('P', '0', '1', '6'),
+    SDL_PIXELFORMAT_I010 =      /**< Planar mode: Y + U + V, 16-bit samples
+                                     with 10 bits in the low bits  (3 planes) */
+        SDL_DEFINE_PIXELFOURCC('I', '0', '1', '0'),
     SDL_PIXELFORMAT_EXTERNAL_OES =      /**< Android video texture format */
-        SDL_DEFINE_PIXELFOURCC('O', 'E', 'S', ' ')
+        SDL_DEFINE_PIXELFOURCC('O', 'E', 'S', ' '),
+    SDL_PIXELFORMAT_BC1 =       /**< Compressed: 4x4 blocks of 8 bytes, RGB with 1-bit alpha (DXT1) */
+        SDL_DEFINE_PIXELFOURCC('D', 'X', 'T', '1'),
+    SDL_PIXELFORMAT_BC2 =       /**< Compressed: 4x4 blocks of 16 bytes, RGB with 4-bit alpha (DXT3) */
+        SDL_DEFINE_PIXELFOURCC('D', 'X', 'T', '3'),
+    SDL_PIXELFORMAT_BC3 =       /**< Compressed: 4x4 blocks of 16 bytes, RGBA (DXT5) */
+        SDL_DEFINE_PIXELFOURCC('D', 'X', 'T', '5'),
+    SDL_PIXELFORMAT_BC4 =       /**< Compressed: 4x4 blocks of 8 bytes, R only */
+        SDL_DEFINE_PIXELFOURCC('B', 'C', '4', 'U'),
+    SDL_PIXELFORMAT_BC5 =       /**< Compressed: 4x4 blocks of 16 bytes, R and G only */
+        SDL_DEFINE_PIXELFOURCC('B', 'C', '5', 'U'),
+    SDL_PIXELFORMAT_BC7 =       /**< Compressed: 4x4 blocks of 16 bytes, RGBA */
+        SDL_DEFINE_PIXELFOURCC('B', 'C', '7', 'U'),
+    SDL_PIXELFORMAT_ETC2_RGB8 =     /**< Compressed: 4x4 blocks of 8 bytes, RGB */
+        SDL_DEFINE_PIXELFOURCC('E', 'T', 'C', '2'),
+    SDL_PIXELFORMAT_ETC2_RGB8A1 =   /**< Compressed: 4x4 blocks of 8 bytes, RGB with 1-bit alpha */
+        SDL_DEFINE_PIXELFOURCC('E', 'T', 'C', 'P'),
+    SDL_PIXELFORMAT_ETC2_RGBA8 =    /**< Compressed: 4x4 blocks of 16 bytes, RGBA (ETC2 + EAC alpha) */
+        SDL_DEFINE_PIXELFOURCC('E', 'T', 'C', 'A'),
+    SDL_PIXELFORMAT_ASTC_4x4 =      /**< Compressed: 4x4 blocks of 16 bytes, RGBA (ASTC LDR) */
+        SDL_DEFINE_PIXELFOURCC('A', '4', 'x', '4'),
+    SDL_PIXELFORMAT_ASTC_5x5 =      /**< Compressed: 5x5 blocks of 16 bytes, RGBA (ASTC LDR) */
+        SDL_DEFINE_PIXELFOURCC('A', '5', 'x', '5'),
+    SDL_PIXELFORMAT_ASTC_6x6 =      /**< Compressed: 6x6 blocks of 16 bytes, RGBA (ASTC LDR) */
+        SDL_DEFINE_PIXELFOURCC('A', '6', 'x', '6'),
+    SDL_PIXELFORMAT_ASTC_8x8 =      /**< Compressed: 8x8 blocks of 16 bytes, RGBA (ASTC LDR) */
+        SDL_DEFINE_PIXELFOURCC('A', '8', 'x', '8')
 } SDL_PixelFormatEnum;
 
 typedef struct SDL_Color
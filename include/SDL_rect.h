@@ -163,6 +163,24 @@ extern DECLSPEC SDL_bool SDLCALL SDL_IntersectRectAndLine(const SDL_Rect *
                                                           int *Y1, int *X2,
                                                           int *Y2);
 
+/**
+ *  \brief Reduce a list of dirty rectangles to fewer, covering the same area.
+ *
+ *  The rectangles are clipped to a \c width by \c height area starting at
+ *  0,0, the empty ones are dropped, and any two whose bounding box isn't
+ *  larger than both of them together are replaced by that box, so contained,
+ *  overlapping and abutting rectangles are merged.
+ *
+ *  \param width The width of the area to clip to.
+ *  \param height The height of the area to clip to.
+ *  \param rects The rectangles, rewritten in place.
+ *  \param numrects The number of rectangles.
+ *
+ *  \return The number of rectangles left at the start of \c rects, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_CoalesceRects(int width, int height,
+                                              SDL_Rect * rects, int numrects);
+
 /* Ends C function definitions when using C++ */
 #ifdef __cplusplus
 }
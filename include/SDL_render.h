@@ -411,6 +411,29 @@ extern DECLSPEC int SDLCALL SDL_UpdateYUVTexture(SDL_Texture * texture,
                                                  const Uint8 *Uplane, int Upitch,
                                                  const Uint8 *Vplane, int Vpitch);
 
+/**
+ *  \brief Update a rectangle within a planar NV12 or NV21 texture with new pixels.
+ *
+ *  \param texture   The texture to update
+ *  \param rect      A pointer to the rectangle of pixels to update, or NULL to
+ *                   update the entire texture.
+ *  \param Yplane    The raw pixel data for the Y plane.
+ *  \param Ypitch    The number of bytes between rows of pixel data for the Y plane.
+ *  \param UVplane   The raw pixel data for the interleaved UV (or VU for NV21) plane.
+ *  \param UVpitch   The number of bytes between rows of pixel data for the UV plane.
+ *
+ *  \return 0 on success, or -1 if the texture is not valid.
+ *
+ *  \note You can use SDL_UpdateTexture() as long as your pixel data is
+ *        a contiguous block of NV12/21 planes in the proper order, but
+ *        this function is available if your pixel data is not contiguous,
+ *        for example decoder output with separately allocated planes.
+ */
+extern DECLSPEC int SDLCALL SDL_UpdateNVTexture(SDL_Texture * texture,
+                                                const SDL_Rect * rect,
+                                                const Uint8 *Yplane, int Ypitch,
+                                                const Uint8 *UVplane, int UVpitch);
+
 /**
  *  \brief Lock a portion of the texture for write-only pixel access.
  *
@@ -430,6 +453,45 @@ extern DECLSPEC int SDLCALL SDL_LockTexture(SDL_Texture * texture,
                                             const SDL_Rect * rect,
                                             void **pixels, int *pitch);
 
+/**
+ *  \brief Lock a texture for write-only access to each of its planes.
+ *
+ *  \param texture   The texture to lock for access, which was created with
+ *                   ::SDL_TEXTUREACCESS_STREAMING.
+ *  \param rect      A pointer to the rectangle to lock for access. If the rect
+ *                   is NULL, the entire texture will be locked. YUV textures
+ *                   only support locking the entire texture.
+ *  \param planes    An array of 3 pointers, filled in with the start of each
+ *                   plane in the order the format stores them, e.g. Y, U, V
+ *                   for IYUV, Y, V, U for YV12 and Y, UV for NV12. Entries
+ *                   beyond the number of planes are set to NULL.
+ *  \param pitches   An array of 3 ints, filled in with the pitch of each plane.
+ *
+ *  \return 0 on success, or -1 if the texture is not valid or was not created with ::SDL_TEXTUREACCESS_STREAMING.
+ *
+ *  \note This lets decoders write straight into the texture memory instead
+ *        of into their own buffers followed by SDL_UpdateTexture().
+ *
+ *  \sa SDL_LockTexture()
+ *  \sa SDL_UnlockTexture()
+ */
+extern DECLSPEC int SDLCALL SDL_LockTexturePlanes(SDL_Texture * texture,
+                                                  const SDL_Rect * rect,
+                                                  Uint8 **planes, int *pitches);
+
+/**
+ *  \brief Get how many bytes SDL has copied to update YUV textures that the
+ *         renderer can't display directly.
+ *
+ *  Those textures keep their planes in system memory, so an update copies
+ *  the new planes there and then converts them into a texture the renderer
+ *  supports. This is meant for comparing ways of updating textures, such as
+ *  SDL_UpdateTexture(), SDL_UpdateNVTexture() and SDL_LockTexturePlanes().
+ *
+ *  \return The number of bytes copied since the program started.
+ */
+extern DECLSPEC Uint64 SDLCALL SDL_GetYUVTextureCopyBytes(void);
+
 /**
  *  \brief Unlock a texture, uploading the changes to video memory, if needed.
  *
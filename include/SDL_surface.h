@@ -54,6 +54,8 @@ extern "C" {
 #define SDL_RLEACCEL        0x00000002  /**< Surface is RLE encoded */
 #define SDL_DONTFREE        0x00000004  /**< Surface is referenced internally */
 #define SDL_SIMD_ALIGNED    0x00000008  /**< Surface uses aligned memory */
+#define SDL_PREMULTIPLIED   0x00000010  /**< Surface colors are premultiplied by alpha */
+#define SDL_POOLED          0x00000020  /**< Surface pixels are recycled through the surface pool */
 /* @} *//* Surface flags */
 
 /**
@@ -148,6 +150,34 @@ extern DECLSPEC SDL_Surface *SDLCALL SDL_CreateRGBSurfaceWithFormatFrom
     (void *pixels, int width, int height, int depth, int pitch, Uint32 format);
 extern DECLSPEC void SDLCALL SDL_FreeSurface(SDL_Surface * surface);
 
+/**
+ *  \brief Release pixel memory cached by the surface pool.
+ *
+ *  The pixels of freed surfaces between 1 KB and 16 MB are kept in size
+ *  classes and handed to the next surface of a similar size, which avoids
+ *  allocator churn from short lived scratch surfaces. The total size of the
+ *  cache is limited by ::SDL_HINT_SURFACE_POOL_SIZE.
+ *
+ *  \param max_bytes The number of cached bytes to keep, the largest buffers
+ *                   are released first. Use 0 to empty the pool.
+ *
+ *  \sa SDL_GetSurfacePoolStats()
+ */
+extern DECLSPEC void SDLCALL SDL_TrimSurfacePool(size_t max_bytes);
+
+/**
+ *  \brief Get the surface pool counters, for tuning ::SDL_HINT_SURFACE_POOL_SIZE.
+ *
+ *  \param hits Filled in with the number of surfaces that reused cached pixels, may be NULL
+ *  \param misses Filled in with the number of surfaces of a pooled size that
+ *                had to allocate new pixels, may be NULL
+ *  \param cached_bytes Filled in with the number of bytes in the pool, may be NULL
+ *
+ *  \sa SDL_TrimSurfacePool()
+ */
+extern DECLSPEC void SDLCALL SDL_GetSurfacePoolStats(Uint64 *hits, Uint64 *misses,
+                                                     size_t *cached_bytes);
+
 /**
  *  \brief Set the palette used by a surface.
  *
@@ -235,6 +265,28 @@ extern DECLSPEC int SDLCALL SDL_SaveBMP_RW
 extern DECLSPEC int SDLCALL SDL_SetSurfaceRLE(SDL_Surface * surface,
                                               int flag);
 
+/**
+ *  \brief RLE encode a surface for blitting onto \c dst now, instead of
+ *         on the first blit.
+ *
+ *  Encoding big surfaces takes a while, so this lets the work be done ahead
+ *  of time, for example on the thread that loads the images. It enables RLE
+ *  acceleration for the surface, like SDL_SetSurfaceRLE(), and sets it up
+ *  for blitting onto \c dst.
+ *
+ *  \param surface The surface to encode
+ *  \param dst The surface that \c surface will be blitted onto
+ *
+ *  \return 0 if the surface is now RLE encoded, or -1 if it can't be RLE
+ *          accelerated for that destination or there was an error.
+ *
+ *  \note This can be called from any thread, as long as nothing else uses
+ *        \c surface at the same time, and \c dst isn't freed or changed
+ *        until it returns.
+ */
+extern DECLSPEC int SDLCALL SDL_PrepareSurfaceRLE(SDL_Surface * surface,
+                                                  SDL_Surface * dst);
+
 /**
  *  \brief Sets the color key (transparent pixel) in a blittable surface.
  *
@@ -392,6 +444,12 @@ extern DECLSPEC SDL_Surface *SDLCALL SDL_DuplicateSurface(SDL_Surface * surface)
  *  semantics.  You can also pass ::SDL_RLEACCEL in the flags parameter and
  *  SDL will try to RLE accelerate colorkey and alpha blits in the resulting
  *  surface.
+ *
+ *  If \c flags contains ::SDL_PREMULTIPLIED and the new format has an alpha
+ *  channel, the colors of the new surface are premultiplied by alpha and its
+ *  blend mode is set to ::SDL_BLENDMODE_BLEND_PREMULTIPLIED.  Otherwise the
+ *  new surface has straight alpha, and a premultiplied source is converted
+ *  back.
  */
 extern DECLSPEC SDL_Surface *SDLCALL SDL_ConvertSurface
     (SDL_Surface * src, const SDL_PixelFormat * fmt, Uint32 flags);
@@ -409,6 +467,20 @@ extern DECLSPEC int SDLCALL SDL_ConvertPixels(int width, int height,
                                               Uint32 dst_format,
                                               void * dst, int dst_pitch);
 
+/**
+ * \brief Copy a block of pixels of one format to another format, multiplying
+ *        the color channels by alpha
+ *
+ *  The destination format must have an alpha channel.
+ *
+ *  \return 0 on success, or -1 if there was an error
+ */
+extern DECLSPEC int SDLCALL SDL_PremultiplyAlpha(int width, int height,
+                                                 Uint32 src_format,
+                                                 const void * src, int src_pitch,
+                                                 Uint32 dst_format,
+                                                 void * dst, int dst_pitch);
+
 /**
  *  Performs a fast fill of the given rectangle with \c color.
  *
@@ -312,7 +312,7 @@ SDL_ReserveSpaceInDataQueue(SDL_DataQueue *queue, const size_t len)
         return NULL;
     }
 
-    packet = queue->head;
+    packet = queue->tail;  /* writes append to the tail; the head is where reads come from. */
     if (packet) {
         const size_t avail = queue->packet_size - packet->datalen;
         if (len <= avail) {  /* we can use the space at end of this packet. */
@@ -51,6 +51,29 @@
 
 #include "SDL_config.h"
 
+/* Functions written for an instruction set newer than the one SDL is built
+   for are tagged with SDL_TARGETING() and only called after checking the
+   matching SDL_Has*() at runtime. */
+#if defined(__clang__) && defined(__has_attribute)
+#if __has_attribute(target)
+#define SDL_HAS_TARGET_ATTRIBS
+#endif
+#elif defined(__GNUC__) && (__GNUC__ + (__GNUC_MINOR__ >= 9) > 4) /* gcc >= 4.9 */
+#define SDL_HAS_TARGET_ATTRIBS
+#endif
+
+#ifdef SDL_HAS_TARGET_ATTRIBS
+#define SDL_TARGETING(x) __attribute__((target(x)))
+#else
+#define SDL_TARGETING(x)
+#endif
+
+#if defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H) && (defined(__AVX2__) || defined(SDL_HAS_TARGET_ATTRIBS))
+#define HAVE_AVX2_INTRINSICS 1
+#elif defined(_MSC_VER) && (_MSC_VER >= 1700) && (defined(_M_IX86) || defined(_M_X64)) && !defined(__clang__)
+#define HAVE_AVX2_INTRINSICS 1
+#endif
+
 #endif /* SDL_internal_h_ */
 
 /* vi: set ts=4 sw=4 expandtab: */
@@ -27,9 +27,18 @@
 #include "SDL_audio_c.h"
 #include "SDL_sysaudio.h"
 #include "../thread/SDL_systhread.h"
+#include "../timer/SDL_timer_c.h"
 
 #define _THIS SDL_AudioDevice *_this
 
+#ifdef __SSE__
+#define HAVE_SSE_INTRINSICS 1
+#endif
+
+#ifdef __ARM_NEON
+#define HAVE_NEON_INTRINSICS 1
+#endif
+
 static SDL_AudioDriver current_audio;
 static SDL_AudioDevice *open_devices[16];
 
@@ -555,43 +564,538 @@ SDL_RemoveAudioDevice(const int iscapture, void *handle)
 
 
 
-/* buffer queueing support... */
+/* buffer queueing support...
+
+   SDL_QueueAudio() and SDL_DequeueAudio() share a single-producer,
+   single-consumer ring with the audio thread. The audio thread's side of it
+   never locks or allocates; it only moves its own index forward.
+
+   If the app queues more than the ring holds, the app's side chains a bigger
+   block onto the end of it, and the audio thread moves on to that block once
+   it has played everything in the old one. Blocks the audio thread is done
+   with get freed on the app's side later. Capture devices can't grow the ring
+   from the audio thread, so captured data that doesn't fit is dropped. */
+
+#define SDL_AUDIORING_MIN_LEN 1024
+#define SDL_AUDIORING_MAX_LEN (1 << 30)
+
+typedef struct SDL_AudioRingBlock
+{
+    Uint8 *data;
+    Uint32 mask;  /* capacity - 1; capacity is always a power of two. */
+    SDL_atomic_t head;  /* total bytes ever written. Only the producer moves this. */
+    SDL_atomic_t tail;  /* total bytes ever read. The consumer moves this, and clearing can, too. */
+    void *next;  /* set once, after the producer's last write to this block. */
+} SDL_AudioRingBlock;
+
+struct SDL_AudioRing
+{
+    SDL_AudioRingBlock *first;  /* oldest block we haven't freed yet. */
+    SDL_AudioRingBlock *last;  /* block the producer writes to. */
+    void *reading;  /* block the consumer reads from. Only the consumer sets this. */
+};
+
+static SDL_AudioRingBlock *
+SDL_NewAudioRingBlock(const Uint32 len)
+{
+    SDL_AudioRingBlock *block;
+    Uint32 capacity = SDL_AUDIORING_MIN_LEN;
+
+    if (len > SDL_AUDIORING_MAX_LEN) {
+        SDL_SetError("Audio queue is too large");
+        return NULL;
+    }
+
+    while (capacity < len) {
+        capacity <<= 1;
+    }
+
+    block = (SDL_AudioRingBlock *) SDL_malloc(sizeof (SDL_AudioRingBlock) + capacity);
+    if (!block) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    block->data = (Uint8 *) (block + 1);
+    block->mask = capacity - 1;
+    SDL_AtomicSet(&block->head, 0);
+    SDL_AtomicSet(&block->tail, 0);
+    block->next = NULL;
+    return block;
+}
+
+static SDL_AudioRing *
+SDL_NewAudioRing(const Uint32 len)
+{
+    SDL_AudioRing *ring = (SDL_AudioRing *) SDL_malloc(sizeof (SDL_AudioRing));
+    if (!ring) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    ring->first = ring->last = SDL_NewAudioRingBlock(len);
+    if (!ring->first) {
+        SDL_free(ring);
+        return NULL;
+    }
+    ring->reading = ring->first;
+    return ring;
+}
+
+static void
+SDL_FreeAudioRing(SDL_AudioRing *ring)
+{
+    if (ring) {
+        SDL_AudioRingBlock *block = ring->first;
+        while (block) {
+            SDL_AudioRingBlock *next = (SDL_AudioRingBlock *) block->next;
+            SDL_free(block);
+            block = next;
+        }
+        SDL_free(ring);
+    }
+}
+
+/* Producer side. Writes as much of (data) as fits, returns bytes written. */
+static Uint32
+SDL_WriteToAudioRing(SDL_AudioRing *ring, const void *data, Uint32 len)
+{
+    SDL_AudioRingBlock *block = ring->last;
+    const Uint32 head = (Uint32) SDL_AtomicGet(&block->head);
+    const Uint32 tail = (Uint32) SDL_AtomicGet(&block->tail);
+    const Uint32 pos = head & block->mask;
+    const Uint32 avail = (block->mask + 1) - (head - tail);
+    Uint32 cpy;
+
+    if (len > avail) {
+        len = avail;
+    }
+
+    cpy = SDL_min(len, (block->mask + 1) - pos);
+    SDL_memcpy(block->data + pos, data, cpy);
+    SDL_memcpy(block->data, ((const Uint8 *) data) + cpy, len - cpy);
+
+    SDL_MemoryBarrierRelease();  /* data has to land before the consumer sees the new head. */
+    SDL_AtomicSet(&block->head, (int) (head + len));
+    return len;
+}
+
+/* Producer side. Chains on a block that can take at least (len) more bytes. */
+static int
+SDL_GrowAudioRing(SDL_AudioRing *ring, const Uint32 len)
+{
+    const Uint32 capacity = (ring->last->mask + 1) * 2;
+    SDL_AudioRingBlock *block = SDL_NewAudioRingBlock(SDL_max(len, capacity));
+    if (!block) {
+        return -1;
+    }
+
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSetPtr(&ring->last->next, block);
+    ring->last = block;
+    return 0;
+}
+
+/* Producer side. Frees blocks the consumer has moved past. */
+static void
+SDL_ReclaimAudioRing(SDL_AudioRing *ring)
+{
+    SDL_AudioRingBlock *reading = (SDL_AudioRingBlock *) SDL_AtomicGetPtr(&ring->reading);
+    while (ring->first != reading) {
+        SDL_AudioRingBlock *next = (SDL_AudioRingBlock *) ring->first->next;
+        SDL_free(ring->first);
+        ring->first = next;
+    }
+}
+
+/* Consumer side. Returns bytes read; (buf) past that is undefined. */
+static Uint32
+SDL_ReadFromAudioRing(SDL_AudioRing *ring, void *buf, Uint32 len)
+{
+    SDL_AudioRingBlock *block = (SDL_AudioRingBlock *) SDL_AtomicGetPtr(&ring->reading);
+    Uint8 *ptr = (Uint8 *) buf;
+    Uint32 total = 0;
+
+    while (len > 0) {
+        const Uint32 tail = (Uint32) SDL_AtomicGet(&block->tail);
+        const Uint32 head = (Uint32) SDL_AtomicGet(&block->head);
+        Uint32 pos, cpy, n;
+
+        SDL_MemoryBarrierAcquire();
+
+        if (head == tail) {
+            SDL_AudioRingBlock *next = (SDL_AudioRingBlock *) SDL_AtomicGetPtr(&block->next);
+            if (!next) {
+                break;  /* ran dry. */
+            } else if (SDL_AtomicGet(&block->head) != (int) tail) {
+                continue;  /* the producer finished this block off before moving on. */
+            }
+            /* the producer never writes to a block again once it links the
+               next one, so this one is empty for good. Move along. */
+            block = next;
+            SDL_MemoryBarrierRelease();
+            SDL_AtomicSetPtr(&ring->reading, block);
+            continue;
+        }
+
+        n = SDL_min(len, head - tail);
+        pos = tail & block->mask;
+        cpy = SDL_min(n, (block->mask + 1) - pos);
+        SDL_memcpy(ptr, block->data + pos, cpy);
+        SDL_memcpy(ptr + cpy, block->data, n - cpy);
+
+        if (!SDL_AtomicCAS(&block->tail, (int) tail, (int) (tail + n))) {
+            break;  /* the queue was cleared while we copied; drop what we got. */
+        }
+
+        ptr += n;
+        len -= n;
+        total += n;
+    }
+
+    return total;
+}
+
+/* Either side, as long as the producer isn't reclaiming blocks at the same time. */
+static Uint32
+SDL_CountAudioRing(SDL_AudioRing *ring)
+{
+    SDL_AudioRingBlock *block = (SDL_AudioRingBlock *) SDL_AtomicGetPtr(&ring->reading);
+    Uint32 total = 0;
+    while (block) {
+        const Uint32 tail = (Uint32) SDL_AtomicGet(&block->tail);
+        total += ((Uint32) SDL_AtomicGet(&block->head)) - tail;
+        block = (SDL_AudioRingBlock *) SDL_AtomicGetPtr(&block->next);
+    }
+    return total;
+}
+
+/* Either side, as long as the producer isn't reclaiming blocks at the same time. */
+static void
+SDL_ClearAudioRing(SDL_AudioRing *ring)
+{
+    SDL_AudioRingBlock *block = (SDL_AudioRingBlock *) SDL_AtomicGetPtr(&ring->reading);
+    while (block) {
+        int tail;
+        do {
+            tail = SDL_AtomicGet(&block->tail);
+        } while (!SDL_AtomicCAS(&block->tail, tail, SDL_AtomicGet(&block->head)));
+        block = (SDL_AudioRingBlock *) SDL_AtomicGetPtr(&block->next);
+    }
+}
+
+/* How big a queue for (format, channels, freq) SDL_HINT_AUDIO_QUEUE_SIZE
+   asks for, but no less than (minlen). */
+static Uint32
+SDL_GetAudioQueueLength(const SDL_AudioFormat format, const int channels, const int freq, const Uint32 minlen)
+{
+    const char *hint = SDL_GetHint(SDL_HINT_AUDIO_QUEUE_SIZE);
+    const int ms = (hint && *hint) ? SDL_atoi(hint) : SDL_AUDIOBUFFERQUEUE_DEFAULT_MS;
+    const Uint64 framesize = (SDL_AUDIO_BITSIZE(format) / 8) * channels;
+    Uint64 len = (((Uint64) freq) * framesize * SDL_max(ms, 0)) / 1000;
+
+    len = SDL_max(len, minlen);
+    len = SDL_min(len, SDL_AUDIORING_MAX_LEN);
+    return (Uint32) len;
+}
+
+
+/* Audio voices...
+
+   Each voice has its own ring, like the buffer queue's, that the app fills
+   and the audio thread drains into the voice's stream, so only the audio
+   thread ever touches the stream while the voice plays.
+
+   Starting and stopping a voice just flips its state. The audio thread is
+   the only one that links voices into or out of the list it mixes: new ones
+   arrive through the device's voices_added stack, which any thread can push
+   onto, and the audio thread notices stopped ones on its next pass. A voice
+   freed while playing is pushed onto voices_retired instead, and really
+   freed by whichever app thread next takes queue_lock. */
+
+#define SDL_AUDIOVOICE_STOPPED 0  /* the app owns it. */
+#define SDL_AUDIOVOICE_PLAYING 1  /* the audio thread owns it. */
+#define SDL_AUDIOVOICE_STOPPING 2  /* the audio thread owns it, until it unlinks it. */
+#define SDL_AUDIOVOICE_FREEING 3  /* the audio thread owns it, until it retires it. */
+
+struct _SDL_AudioVoice
+{
+    SDL_AudioDevice *device;  /* NULL once the device is closed. */
+    SDL_AudioRing *ring;
+    SDL_AudioStream *stream;  /* converts to floats in the callback's layout. */
+    Uint8 *chunk;  /* audio thread: staging between ring and stream. */
+    Uint32 chunk_len;
+    Uint32 framesize;
+    SDL_atomic_t state;
+    SDL_atomic_t gain;  /* the bits of a float. */
+    SDL_atomic_t pan;  /* the bits of a float. */
+    float gains[2];  /* audio thread: left and right gain the last ramp ended on. */
+    SDL_bool ramped;  /* audio thread: gains[] is valid. */
+    void *next;  /* link in exactly one of voices_added, voices or voices_retired. */
+    SDL_AudioVoice *all_prev;  /* links in all_voices, under queue_lock. */
+    SDL_AudioVoice *all_next;
+};
+
+static SDL_INLINE void
+SDL_SetAtomicFloat(SDL_atomic_t *a, const float f)
+{
+    int i;
+    SDL_memcpy(&i, &f, sizeof (i));
+    SDL_AtomicSet(a, i);
+}
+
+static SDL_INLINE float
+SDL_GetAtomicFloat(SDL_atomic_t *a)
+{
+    const int i = SDL_AtomicGet(a);
+    float f;
+    SDL_memcpy(&f, &i, sizeof (f));
+    return f;
+}
+
+/* Any thread. Pushes (voice) onto a stack that's only ever taken whole. */
+static void
+SDL_PushAudioVoice(void **stack, SDL_AudioVoice *voice)
+{
+    void *head;
+    do {
+        head = SDL_AtomicGetPtr(stack);
+        voice->next = head;
+    } while (!SDL_AtomicCASPtr(stack, head, voice));
+}
+
+/* Audio thread. Links in new voices, unlinks stopped and freed ones. */
+static void
+SDL_UpdateAudioVoices(SDL_AudioDevice *device)
+{
+    SDL_AudioVoice *added = (SDL_AudioVoice *) SDL_AtomicSetPtr(&device->voices_added, NULL);
+    SDL_AudioVoice **link = &device->voices;
+
+    while (added) {
+        SDL_AudioVoice *next = (SDL_AudioVoice *) added->next;
+        added->next = device->voices;
+        device->voices = added;
+        added = next;
+    }
+
+    while (*link) {
+        SDL_AudioVoice *voice = *link;
+
+        if (SDL_AtomicGet(&voice->state) == SDL_AUDIOVOICE_PLAYING) {
+            link = (SDL_AudioVoice **) &voice->next;
+            continue;
+        }
+
+        /* unlink it first: once the app gets it back, it may push it again. */
+        *link = (SDL_AudioVoice *) voice->next;
+
+        for (;;) {
+            const int state = SDL_AtomicGet(&voice->state);
+            if (state == SDL_AUDIOVOICE_STOPPING) {
+                if (SDL_AtomicCAS(&voice->state, SDL_AUDIOVOICE_STOPPING, SDL_AUDIOVOICE_STOPPED)) {
+                    break;  /* it's the app's again; don't touch it. */
+                }
+            } else if (state == SDL_AUDIOVOICE_FREEING) {
+                SDL_PushAudioVoice(&device->voices_retired, voice);
+                break;
+            } else {  /* played again before we got to it; put it back. */
+                voice->next = *link;
+                *link = voice;
+                link = (SDL_AudioVoice **) &voice->next;
+                break;
+            }
+        }
+    }
+}
+
+/* Audio thread. Gets up to (len) bytes of floats out of (voice). */
+static int
+SDL_PullAudioVoice(SDL_AudioVoice *voice, float *buf, const int len)
+{
+    while (SDL_AudioStreamAvailable(voice->stream) < len) {
+        const Uint32 got = SDL_ReadFromAudioRing(voice->ring, voice->chunk, voice->chunk_len);
+        if ((got == 0) || (SDL_AudioStreamPut(voice->stream, voice->chunk, (int) got) < 0)) {
+            break;
+        }
+    }
+    return SDL_AudioStreamGet(voice->stream, buf, len);
+}
+
+/* Audio thread. Adds (frames) frames of (src) into (bus) at the voice's
+   gain and pan, ramping from where the last call left off to the new
+   target over (rampframes) frames, so changes don't click. */
+static void
+SDL_AccumulateAudioVoice(SDL_AudioVoice *voice, float *bus, const float *src,
+                         const int frames, const int rampframes, const int channels)
+{
+    const float gain = SDL_GetAtomicFloat(&voice->gain);
+    const int total = frames * channels;
+    float target[2], start[2], step[2];
+    float lanes[4], deltas[4];
+    int i = 0;
+    int j;
+
+    if (channels == 2) {
+        const float pan = SDL_max(-1.0f, SDL_min(1.0f, SDL_GetAtomicFloat(&voice->pan)));
+        target[0] = gain * SDL_min(1.0f, 1.0f - pan);
+        target[1] = gain * SDL_min(1.0f, 1.0f + pan);
+    } else {
+        target[0] = target[1] = gain;
+    }
+
+    if (!voice->ramped) {
+        voice->gains[0] = target[0];
+        voice->gains[1] = target[1];
+        voice->ramped = SDL_TRUE;
+    }
+
+    for (j = 0; j < 2; j++) {
+        start[j] = voice->gains[j];
+        step[j] = (target[j] - start[j]) / (float) rampframes;
+        voice->gains[j] = (frames < rampframes) ? (start[j] + (step[j] * frames)) : target[j];
+    }
+
+    /* Work out each of four lanes' gain and how much it moves per four
+       floats, so all layouts share one loop. */
+    if (channels == 2) {
+        lanes[0] = start[0];
+        lanes[1] = start[1];
+        lanes[2] = start[0] + step[0];
+        lanes[3] = start[1] + step[1];
+        deltas[0] = deltas[2] = step[0] * 2.0f;
+        deltas[1] = deltas[3] = step[1] * 2.0f;
+    } else if ((step[0] == 0.0f) || (channels == 4)) {
+        lanes[0] = lanes[1] = lanes[2] = lanes[3] = start[0];
+        deltas[0] = deltas[1] = deltas[2] = deltas[3] = step[0];
+    } else if (channels == 1) {
+        for (j = 0; j < 4; j++) {
+            lanes[j] = start[0] + (step[0] * j);
+            deltas[j] = step[0] * 4.0f;
+        }
+    } else {  /* ramping, with frames that don't line up with the lanes. */
+        for (i = 0; i < frames; i++) {
+            const float g = start[0] + (step[0] * i);
+            for (j = 0; j < channels; j++) {
+                bus[(i * channels) + j] += src[(i * channels) + j] * g;
+            }
+        }
+        return;
+    }
+
+#if HAVE_SSE_INTRINSICS
+    if (SDL_HasSSE()) {
+        const __m128 d = _mm_loadu_ps(deltas);
+        __m128 g = _mm_loadu_ps(lanes);
+        for (; i + 4 <= total; i += 4) {
+            _mm_storeu_ps(bus + i, _mm_add_ps(_mm_loadu_ps(bus + i), _mm_mul_ps(_mm_loadu_ps(src + i), g)));
+            g = _mm_add_ps(g, d);
+        }
+        _mm_storeu_ps(lanes, g);
+    }
+#endif
+#if HAVE_NEON_INTRINSICS
+    if (SDL_HasNEON()) {
+        const float32x4_t d = vld1q_f32(deltas);
+        float32x4_t g = vld1q_f32(lanes);
+        for (; i + 4 <= total; i += 4) {
+            vst1q_f32(bus + i, vmlaq_f32(vld1q_f32(bus + i), vld1q_f32(src + i), g));
+            g = vaddq_f32(g, d);
+        }
+        vst1q_f32(lanes, g);
+    }
+#endif
+
+    for (; i + 4 <= total; i += 4) {
+        for (j = 0; j < 4; j++) {
+            bus[i + j] += src[i + j] * lanes[j];
+            lanes[j] += deltas[j];
+        }
+    }
+    for (j = 0; i < total; i++, j++) {
+        bus[i] += src[i] * lanes[j];
+    }
+}
+
+/* Audio thread. Sums every playing voice into the float bus, then mixes
+   that into (stream) in one pass. */
+static void
+SDL_MixAudioVoices(SDL_AudioDevice *device, Uint8 *stream, int len)
+{
+    const int channels = device->callbackspec.channels;
+    const int frames = len / ((SDL_AUDIO_BITSIZE(device->callbackspec.format) / 8) * channels);
+    const int buslen = frames * channels * (int) sizeof (float);
+    SDL_bool mixed = SDL_FALSE;
+    SDL_AudioVoice *voice;
+
+    SDL_UpdateAudioVoices(device);
+
+    for (voice = device->voices; voice != NULL; voice = (SDL_AudioVoice *) voice->next) {
+        const int got = SDL_PullAudioVoice(voice, device->voice_scratch, buslen);
+        if (got > 0) {
+            if (!mixed) {
+                SDL_memset(device->voice_bus, 0, buslen);
+                mixed = SDL_TRUE;
+            }
+            SDL_AccumulateAudioVoice(voice, device->voice_bus, device->voice_scratch,
+                                     got / (channels * (int) sizeof (float)), frames, channels);
+        }
+    }
+
+    if (mixed) {
+        if (device->voice_cvt.needed) {
+            device->voice_cvt.len = buslen;
+            SDL_ConvertAudio(&device->voice_cvt);
+        }
+        SDL_MixAudioFormat(stream, (const Uint8 *) device->voice_bus, device->callbackspec.format, (Uint32) len, SDL_MIX_MAXVOLUME);
+    }
+}
 
 static void SDLCALL
 SDL_BufferQueueDrainCallback(void *userdata, Uint8 *stream, int len)
 {
-    /* this function always holds the mixer lock before being called. */
+    /* this function runs on the audio thread and doesn't need the mixer lock. */
     SDL_AudioDevice *device = (SDL_AudioDevice *) userdata;
-    size_t dequeued;
+    Uint32 dequeued;
 
     SDL_assert(device != NULL);  /* this shouldn't ever happen, right?! */
     SDL_assert(!device->iscapture);  /* this shouldn't ever happen, right?! */
     SDL_assert(len >= 0);  /* this shouldn't ever happen, right?! */
 
-    dequeued = SDL_ReadFromDataQueue(device->buffer_queue, stream, len);
-    stream += dequeued;
-    len -= (int) dequeued;
+    dequeued = SDL_ReadFromAudioRing(device->buffer_ring, stream, (Uint32) len);
+
+    if (dequeued < (Uint32) len) {
+        /* count each time playback runs dry, not every callback while idle. */
+        if ((dequeued > 0) || !device->queue_starved) {
+            SDL_AtomicIncRef(&device->queue_underruns);
+        }
+        device->queue_starved = SDL_TRUE;
+
+        /* fill any remaining space in the stream with silence. */
+        SDL_memset(stream + dequeued, device->spec.silence, len - dequeued);
+    } else {
+        device->queue_starved = SDL_FALSE;
+    }
 
-    if (len > 0) {  /* fill any remaining space in the stream with silence. */
-        SDL_assert(SDL_CountDataQueue(device->buffer_queue) == 0);
-        SDL_memset(stream, device->spec.silence, len);
+    if (device->voices || SDL_AtomicGetPtr(&device->voices_added)) {
+        SDL_MixAudioVoices(device, stream, len);
     }
 }
 
 static void SDLCALL
 SDL_BufferQueueFillCallback(void *userdata, Uint8 *stream, int len)
 {
-    /* this function always holds the mixer lock before being called. */
+    /* this function runs on the audio thread and doesn't need the mixer lock. */
     SDL_AudioDevice *device = (SDL_AudioDevice *) userdata;
 
     SDL_assert(device != NULL);  /* this shouldn't ever happen, right?! */
     SDL_assert(device->iscapture);  /* this shouldn't ever happen, right?! */
     SDL_assert(len >= 0);  /* this shouldn't ever happen, right?! */
 
-    /* note that if this needs to allocate more space and run out of memory,
-       we have no choice but to quietly drop the data and hope it works out
-       later, but you probably have bigger problems in this case anyhow. */
-    SDL_WriteToDataQueue(device->buffer_queue, stream, len);
+    /* we can't allocate here, so if the app isn't dequeueing fast enough,
+       we have no choice but to drop the newest data and count it. */
+    if (SDL_WriteToAudioRing(device->buffer_ring, stream, (Uint32) len) < (Uint32) len) {
+        SDL_AtomicIncRef(&device->queue_overruns);
+    }
 }
 
 int
@@ -609,9 +1113,21 @@ SDL_QueueAudio(SDL_AudioDeviceID devid, const void *data, Uint32 len)
     }
 
     if (len > 0) {
-        current_audio.impl.LockDevice(device);
-        rc = SDL_WriteToDataQueue(device->buffer_queue, data, len);
-        current_audio.impl.UnlockDevice(device);
+        Uint32 written;
+
+        /* this only serializes app threads against each other. */
+        SDL_LockMutex(device->queue_lock);
+        SDL_ReclaimAudioRing(device->buffer_ring);
+        written = SDL_WriteToAudioRing(device->buffer_ring, data, len);
+        if (written < len) {
+            SDL_AtomicIncRef(&device->queue_overruns);
+            if (SDL_GrowAudioRing(device->buffer_ring, len - written) < 0) {
+                rc = -1;
+            } else {
+                SDL_WriteToAudioRing(device->buffer_ring, ((const Uint8 *) data) + written, len - written);
+            }
+        }
+        SDL_UnlockMutex(device->queue_lock);
     }
 
     return rc;
@@ -630,9 +1146,9 @@ SDL_DequeueAudio(SDL_AudioDeviceID devid, void *data, Uint32 len)
         return 0;  /* just report zero bytes dequeued. */
     }
 
-    current_audio.impl.LockDevice(device);
-    rc = (Uint32) SDL_ReadFromDataQueue(device->buffer_queue, data, len);
-    current_audio.impl.UnlockDevice(device);
+    SDL_LockMutex(device->queue_lock);
+    rc = SDL_ReadFromAudioRing(device->buffer_ring, data, len);
+    SDL_UnlockMutex(device->queue_lock);
     return rc;
 }
 
@@ -650,9 +1166,9 @@ SDL_GetQueuedAudioSize(SDL_AudioDeviceID devid)
     if (device->callbackspec.callback == SDL_BufferQueueDrainCallback ||
         device->callbackspec.callback == SDL_BufferQueueFillCallback)
     {
-        current_audio.impl.LockDevice(device);
-        retval = (Uint32) SDL_CountDataQueue(device->buffer_queue);
-        current_audio.impl.UnlockDevice(device);
+        SDL_LockMutex(device->queue_lock);
+        retval = SDL_CountAudioRing(device->buffer_ring);
+        SDL_UnlockMutex(device->queue_lock);
     }
 
     return retval;
@@ -667,13 +1183,376 @@ SDL_ClearQueuedAudio(SDL_AudioDeviceID devid)
         return;  /* nothing to do. */
     }
 
-    /* Blank out the device and release the mutex. Free it afterwards. */
-    current_audio.impl.LockDevice(device);
+    /* Nothing to do unless we're set up for queueing. */
+    if (device->callbackspec.callback == SDL_BufferQueueDrainCallback ||
+        device->callbackspec.callback == SDL_BufferQueueFillCallback)
+    {
+        SDL_LockMutex(device->queue_lock);
+        SDL_ClearAudioRing(device->buffer_ring);
+        SDL_UnlockMutex(device->queue_lock);
+    }
+}
 
-    /* Keep up to two packets in the pool to reduce future malloc pressure. */
-    SDL_ClearDataQueue(device->buffer_queue, SDL_AUDIOBUFFERQUEUE_PACKETLEN * 2);
+int
+SDL_GetQueuedAudioStats(SDL_AudioDeviceID devid, Uint32 *underruns, Uint32 *overruns)
+{
+    SDL_AudioDevice *device = get_audio_device(devid);
 
-    current_audio.impl.UnlockDevice(device);
+    if (!device) {
+        return -1;  /* get_audio_device() will have set the error state */
+    } else if ((device->callbackspec.callback != SDL_BufferQueueDrainCallback) &&
+               (device->callbackspec.callback != SDL_BufferQueueFillCallback)) {
+        return SDL_SetError("Audio device has a callback, queueing not in use");
+    }
+
+    if (underruns) {
+        *underruns = (Uint32) SDL_AtomicGet(&device->queue_underruns);
+    }
+    if (overruns) {
+        *overruns = (Uint32) SDL_AtomicGet(&device->queue_overruns);
+    }
+    return 0;
+}
+
+static void
+SDL_DestroyAudioVoice(SDL_AudioVoice *voice)
+{
+    SDL_FreeAudioStream(voice->stream);
+    SDL_FreeAudioRing(voice->ring);
+    SDL_free(voice->chunk);
+    SDL_free(voice);
+}
+
+/* App side, with queue_lock held. */
+static void
+SDL_UnlinkAudioVoice(SDL_AudioDevice *device, SDL_AudioVoice *voice)
+{
+    if (voice->all_prev) {
+        voice->all_prev->all_next = voice->all_next;
+    } else {
+        device->all_voices = voice->all_next;
+    }
+    if (voice->all_next) {
+        voice->all_next->all_prev = voice->all_prev;
+    }
+}
+
+/* App side, with queue_lock held. */
+static void
+SDL_FreeRetiredAudioVoices(SDL_AudioDevice *device)
+{
+    SDL_AudioVoice *voice = (SDL_AudioVoice *) SDL_AtomicSetPtr(&device->voices_retired, NULL);
+    while (voice) {
+        SDL_AudioVoice *next = (SDL_AudioVoice *) voice->next;
+        SDL_UnlinkAudioVoice(device, voice);
+        SDL_DestroyAudioVoice(voice);
+        voice = next;
+    }
+}
+
+SDL_AudioVoice *
+SDL_NewAudioVoice(SDL_AudioDeviceID devid, SDL_AudioFormat format, Uint8 channels, int rate)
+{
+    SDL_AudioDevice *device = get_audio_device(devid);
+    SDL_AudioVoice *voice;
+    Uint32 chunkframes;
+
+    if (!device) {
+        return NULL;  /* get_audio_device() will have set the error state */
+    } else if (device->iscapture) {
+        SDL_SetError("This is a capture device, voices not allowed");
+        return NULL;
+    } else if (device->callbackspec.callback != SDL_BufferQueueDrainCallback) {
+        SDL_SetError("Audio device has a callback, voices not allowed");
+        return NULL;
+    }
+
+    voice = (SDL_AudioVoice *) SDL_calloc(1, sizeof (SDL_AudioVoice));
+    if (!voice) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    voice->stream = SDL_NewAudioStream(format, channels, rate, AUDIO_F32SYS,
+                                       device->callbackspec.channels,
+                                       device->callbackspec.freq);
+    if (!voice->stream) {
+        SDL_free(voice);
+        return NULL;
+    }
+
+    /* enough source frames to fill a callback, plus a little resampler slack. */
+    chunkframes = (Uint32) ((((Uint64) device->callbackspec.samples) * rate) / device->callbackspec.freq) + 16;
+    voice->framesize = (SDL_AUDIO_BITSIZE(format) / 8) * channels;
+    voice->chunk_len = chunkframes * voice->framesize;
+    voice->chunk = (Uint8 *) SDL_malloc(voice->chunk_len);
+    voice->ring = SDL_NewAudioRing(SDL_GetAudioQueueLength(format, channels, rate, voice->chunk_len * 2));
+    if (!voice->chunk || !voice->ring) {
+        if (!voice->chunk) {
+            SDL_OutOfMemory();
+        }
+        SDL_DestroyAudioVoice(voice);
+        return NULL;
+    }
+
+    voice->device = device;
+    SDL_AtomicSet(&voice->state, SDL_AUDIOVOICE_STOPPED);
+    SDL_SetAtomicFloat(&voice->gain, 1.0f);
+    SDL_SetAtomicFloat(&voice->pan, 0.0f);
+
+    SDL_LockMutex(device->queue_lock);
+    SDL_FreeRetiredAudioVoices(device);
+
+    /* the first voice sets up the bus; the audio thread won't look at it
+       before a voice gets pushed to it. */
+    if (!device->voice_bus) {
+        const SDL_AudioSpec *spec = &device->callbackspec;
+        const size_t buslen = ((size_t) spec->samples) * spec->channels * sizeof (float);
+        if (SDL_BuildAudioCVT(&device->voice_cvt, AUDIO_F32SYS, spec->channels, spec->freq,
+                              spec->format, spec->channels, spec->freq) >= 0) {
+            device->voice_scratch = (float *) SDL_SIMDAlloc(buslen);
+            device->voice_bus = (float *) SDL_SIMDAlloc(buslen * SDL_max(device->voice_cvt.len_mult, 1));
+            device->voice_cvt.buf = (Uint8 *) device->voice_bus;
+            if (!device->voice_scratch || !device->voice_bus) {
+                SDL_SIMDFree(device->voice_scratch);
+                SDL_SIMDFree(device->voice_bus);
+                device->voice_scratch = device->voice_bus = NULL;
+                SDL_OutOfMemory();
+            }
+        }
+        if (!device->voice_bus) {
+            SDL_UnlockMutex(device->queue_lock);
+            SDL_DestroyAudioVoice(voice);
+            return NULL;
+        }
+    }
+
+    voice->all_next = device->all_voices;
+    if (device->all_voices) {
+        device->all_voices->all_prev = voice;
+    }
+    device->all_voices = voice;
+    SDL_UnlockMutex(device->queue_lock);
+
+    return voice;
+}
+
+int
+SDL_AudioVoicePut(SDL_AudioVoice *voice, const void *data, Uint32 len)
+{
+    Uint32 written;
+
+    if (!voice) {
+        return SDL_InvalidParamError("voice");
+    } else if (!data) {
+        return SDL_InvalidParamError("data");
+    } else if ((len % voice->framesize) != 0) {
+        return SDL_SetError("Can't add partial sample frames");
+    }
+
+    SDL_ReclaimAudioRing(voice->ring);
+    written = SDL_WriteToAudioRing(voice->ring, data, len);
+    if (written < len) {
+        if (SDL_GrowAudioRing(voice->ring, len - written) < 0) {
+            return -1;
+        }
+        SDL_WriteToAudioRing(voice->ring, ((const Uint8 *) data) + written, len - written);
+    }
+    return 0;
+}
+
+Uint32
+SDL_AudioVoiceQueued(SDL_AudioVoice *voice)
+{
+    return voice ? SDL_CountAudioRing(voice->ring) : 0;
+}
+
+int
+SDL_PlayAudioVoice(SDL_AudioVoice *voice)
+{
+    if (!voice) {
+        return SDL_InvalidParamError("voice");
+    } else if (!voice->device) {
+        return SDL_SetError("Audio device was closed");
+    }
+
+    for (;;) {
+        const int state = SDL_AtomicGet(&voice->state);
+        if (state == SDL_AUDIOVOICE_STOPPED) {
+            voice->ramped = SDL_FALSE;  /* start at its gain, don't ramp from where it stopped. */
+            if (SDL_AtomicCAS(&voice->state, SDL_AUDIOVOICE_STOPPED, SDL_AUDIOVOICE_PLAYING)) {
+                SDL_PushAudioVoice(&voice->device->voices_added, voice);
+                return 0;
+            }
+        } else if (state == SDL_AUDIOVOICE_STOPPING) {
+            /* still linked in on the audio thread, so just keep it there. */
+            if (SDL_AtomicCAS(&voice->state, SDL_AUDIOVOICE_STOPPING, SDL_AUDIOVOICE_PLAYING)) {
+                return 0;
+            }
+        } else {
+            return 0;  /* already playing. */
+        }
+    }
+}
+
+void
+SDL_StopAudioVoice(SDL_AudioVoice *voice)
+{
+    if (voice) {
+        SDL_AtomicCAS(&voice->state, SDL_AUDIOVOICE_PLAYING, SDL_AUDIOVOICE_STOPPING);
+    }
+}
+
+void
+SDL_SetAudioVoiceGain(SDL_AudioVoice *voice, float gain)
+{
+    if (voice) {
+        SDL_SetAtomicFloat(&voice->gain, gain);
+    }
+}
+
+void
+SDL_SetAudioVoicePan(SDL_AudioVoice *voice, float pan)
+{
+    if (voice) {
+        SDL_SetAtomicFloat(&voice->pan, pan);
+    }
+}
+
+void
+SDL_FreeAudioVoice(SDL_AudioVoice *voice)
+{
+    SDL_AudioDevice *device;
+
+    if (!voice) {
+        return;
+    }
+
+    for (;;) {
+        const int state = SDL_AtomicGet(&voice->state);
+        if (state == SDL_AUDIOVOICE_STOPPED) {
+            break;  /* ours to free right now. */
+        } else if (SDL_AtomicCAS(&voice->state, state, SDL_AUDIOVOICE_FREEING)) {
+            return;  /* the audio thread will retire it. */
+        }
+    }
+
+    device = voice->device;
+    if (device) {
+        SDL_LockMutex(device->queue_lock);
+        SDL_UnlinkAudioVoice(device, voice);
+        SDL_FreeRetiredAudioVoices(device);
+        SDL_UnlockMutex(device->queue_lock);
+    }
+    SDL_DestroyAudioVoice(voice);
+}
+
+/* Audio thread timing...
+
+   Without a device to block on, the audio thread sleeps a buffer's length
+   between buffers. With SDL_HINT_AUDIO_DEADLINE_SCHEDULING set, it sleeps
+   until each buffer's absolute deadline instead, so time spent in the
+   callback and oversleeping don't add up. Either way, each callback is
+   timed for SDL_GetAudioDeviceStats(). */
+
+static Uint32
+SDL_AudioTicksToMicroseconds(const Uint64 ticks)
+{
+    const Uint64 freq = SDL_GetPerformanceFrequency();
+    const Uint64 us = ((ticks / freq) * 1000000) + (((ticks % freq) * 1000000) / freq);
+    return (Uint32) SDL_min(us, 0x7FFFFFFF);
+}
+
+static void
+SDL_PaceAudioDevice(SDL_AudioDevice *device)
+{
+    if (device->deadline_scheduling) {
+        const Uint64 now = SDL_GetPerformanceCounter();
+        /* start over the first time, or after falling a whole buffer behind. */
+        if (!device->pace_deadline || (now >= device->pace_deadline + device->pace_period)) {
+            device->pace_deadline = now;
+        }
+        device->pace_deadline += device->pace_period;
+        SDL_DelayUntilCounter(device->pace_deadline);
+    } else {
+        SDL_Delay((device->spec.samples * 1000) / device->spec.freq);
+    }
+}
+
+/* Call right before the callback; returns the time to pass to SDL_EndAudioTiming(). */
+static Uint64
+SDL_BeginAudioTiming(SDL_AudioDevice *device)
+{
+    const Uint64 now = SDL_GetPerformanceCounter();
+    const Uint64 period = device->timing_period;
+
+    if (device->timing_last) {
+        const Uint64 interval = now - device->timing_last;
+        const Uint32 jitter = SDL_AudioTicksToMicroseconds((interval > period) ? (interval - period) : (period - interval));
+        Uint32 lateness = 0;
+        int bucket = 0;
+
+        while ((bucket < (SDL_AUDIO_JITTER_BUCKETS - 1)) && (jitter >= (32u << bucket))) {
+            bucket++;
+        }
+        SDL_AtomicIncRef(&device->timing_histogram[bucket]);
+        if (jitter > (Uint32) SDL_AtomicGet(&device->timing_max_jitter)) {
+            SDL_AtomicSet(&device->timing_max_jitter, (int) jitter);
+        }
+
+        device->timing_due += period;
+        if (now <= device->timing_due) {
+            device->timing_due = now;  /* early; the schedule follows it. */
+        } else {
+            lateness = SDL_AudioTicksToMicroseconds(now - device->timing_due);
+            if ((now - device->timing_due) >= period) {
+                SDL_AtomicIncRef(&device->timing_late);
+                device->timing_due = now;
+            }
+        }
+        if (lateness > (Uint32) SDL_AtomicGet(&device->timing_max_lateness)) {
+            SDL_AtomicSet(&device->timing_max_lateness, (int) lateness);
+        }
+    } else {
+        device->timing_due = now;
+    }
+
+    device->timing_last = now;
+    SDL_AtomicIncRef(&device->timing_callbacks);
+    return now;
+}
+
+static void
+SDL_EndAudioTiming(SDL_AudioDevice *device, const Uint64 start)
+{
+    const Uint32 us = SDL_AudioTicksToMicroseconds(SDL_GetPerformanceCounter() - start);
+    if (us > (Uint32) SDL_AtomicGet(&device->timing_max_callback)) {
+        SDL_AtomicSet(&device->timing_max_callback, (int) us);
+    }
+}
+
+int
+SDL_GetAudioDeviceStats(SDL_AudioDeviceID devid, SDL_AudioDeviceStats *stats)
+{
+    SDL_AudioDevice *device = get_audio_device(devid);
+    int i;
+
+    if (!device) {
+        return -1;  /* get_audio_device() will have set the error state */
+    } else if (!stats) {
+        return SDL_InvalidParamError("stats");
+    }
+
+    stats->callbacks = (Uint32) SDL_AtomicGet(&device->timing_callbacks);
+    stats->late_callbacks = (Uint32) SDL_AtomicGet(&device->timing_late);
+    stats->period_us = SDL_AudioTicksToMicroseconds(device->timing_period);
+    stats->max_jitter_us = (Uint32) SDL_AtomicGet(&device->timing_max_jitter);
+    stats->max_lateness_us = (Uint32) SDL_AtomicGet(&device->timing_max_lateness);
+    stats->max_callback_us = (Uint32) SDL_AtomicGet(&device->timing_max_callback);
+    for (i = 0; i < SDL_AUDIO_JITTER_BUCKETS; i++) {
+        stats->jitter_histogram[i] = (Uint32) SDL_AtomicGet(&device->timing_histogram[i]);
+    }
+    return 0;
 }
 
 
@@ -684,6 +1563,8 @@ SDL_RunAudio(void *devicep)
     SDL_AudioDevice *device = (SDL_AudioDevice *) devicep;
     void *udata = device->callbackspec.userdata;
     SDL_AudioCallback callback = device->callbackspec.callback;
+    /* the buffer queue is lock-free, so it doesn't need the mixer lock. */
+    const SDL_bool need_lock = (callback != SDL_BufferQueueDrainCallback);
     int data_len = 0;
     Uint8 *data;
 
@@ -728,13 +1609,23 @@ SDL_RunAudio(void *devicep)
         }
 
         /* !!! FIXME: this should be LockDevice. */
-        SDL_LockMutex(device->mixer_lock);
+        if (need_lock) {
+            SDL_LockMutex(device->mixer_lock);
+        }
         if (SDL_AtomicGet(&device->paused)) {
             SDL_memset(data, device->spec.silence, data_len);
+            if (callback == SDL_BufferQueueDrainCallback) {
+                SDL_UpdateAudioVoices(device);  /* so stopped voices don't wait for unpausing. */
+            }
+            device->timing_last = 0;
         } else {
+            const Uint64 start = SDL_BeginAudioTiming(device);
             callback(udata, data, data_len);
+            SDL_EndAudioTiming(device, start);
+        }
+        if (need_lock) {
+            SDL_UnlockMutex(device->mixer_lock);
         }
-        SDL_UnlockMutex(device->mixer_lock);
 
         if (device->stream) {
             /* Stream available audio to device, converting/resampling. */
@@ -748,8 +1639,7 @@ SDL_RunAudio(void *devicep)
                 SDL_assert((got < 0) || (got == device->spec.size));
 
                 if (data == NULL) {  /* device is having issues... */
-                    const Uint32 delay = ((device->spec.samples * 1000) / device->spec.freq);
-                    SDL_Delay(delay);  /* wait for as long as this buffer would have played. Maybe device recovers later? */
+                    SDL_PaceAudioDevice(device);  /* wait for as long as this buffer would have played. Maybe device recovers later? */
                 } else {
                     if (got != device->spec.size) {
                         SDL_memset(data, device->spec.silence, device->spec.size);
@@ -760,8 +1650,7 @@ SDL_RunAudio(void *devicep)
             }
         } else if (data == device->work_buffer) {
             /* nothing to do; pause like we queued a buffer to play. */
-            const Uint32 delay = ((device->spec.samples * 1000) / device->spec.freq);
-            SDL_Delay(delay);
+            SDL_PaceAudioDevice(device);
         } else {  /* writing directly to the device. */
             /* queue this buffer and wait for it to finish playing. */
             current_audio.impl.PlayDevice(device);
@@ -786,11 +1675,12 @@ SDL_CaptureAudio(void *devicep)
 {
     SDL_AudioDevice *device = (SDL_AudioDevice *) devicep;
     const int silence = (int) device->spec.silence;
-    const Uint32 delay = ((device->spec.samples * 1000) / device->spec.freq);
     const int data_len = device->spec.size;
     Uint8 *data;
     void *udata = device->callbackspec.userdata;
     SDL_AudioCallback callback = device->callbackspec.callback;
+    /* the buffer queue is lock-free, so it doesn't need the mixer lock. */
+    const SDL_bool need_lock = (callback != SDL_BufferQueueFillCallback);
 
     SDL_assert(device->iscapture);
 
@@ -817,7 +1707,8 @@ SDL_CaptureAudio(void *devicep)
         current_audio.impl.BeginLoopIteration(device);
 
         if (SDL_AtomicGet(&device->paused)) {
-            SDL_Delay(delay);  /* just so we don't cook the CPU. */
+            SDL_PaceAudioDevice(device);  /* just so we don't cook the CPU. */
+            device->timing_last = 0;
             if (device->stream) {
                 SDL_AudioStreamClear(device->stream);
             }
@@ -839,7 +1730,7 @@ SDL_CaptureAudio(void *devicep)
            But we don't process it further or call the app's callback. */
 
         if (!SDL_AtomicGet(&device->enabled)) {
-            SDL_Delay(delay);  /* try to keep callback firing at normal pace. */
+            SDL_PaceAudioDevice(device);  /* try to keep callback firing at normal pace. */
         } else {
             while (still_need > 0) {
                 const int rc = current_audio.impl.CaptureFromDevice(device, ptr, still_need);
@@ -871,19 +1762,31 @@ SDL_CaptureAudio(void *devicep)
                 }
 
                 /* !!! FIXME: this should be LockDevice. */
-                SDL_LockMutex(device->mixer_lock);
+                if (need_lock) {
+                    SDL_LockMutex(device->mixer_lock);
+                }
                 if (!SDL_AtomicGet(&device->paused)) {
+                    const Uint64 start = SDL_BeginAudioTiming(device);
                     callback(udata, device->work_buffer, device->callbackspec.size);
+                    SDL_EndAudioTiming(device, start);
+                }
+                if (need_lock) {
+                    SDL_UnlockMutex(device->mixer_lock);
                 }
-                SDL_UnlockMutex(device->mixer_lock);
             }
         } else {  /* feeding user callback directly without streaming. */
             /* !!! FIXME: this should be LockDevice. */
-            SDL_LockMutex(device->mixer_lock);
+            if (need_lock) {
+                SDL_LockMutex(device->mixer_lock);
+            }
             if (!SDL_AtomicGet(&device->paused)) {
+                const Uint64 start = SDL_BeginAudioTiming(device);
                 callback(udata, data, device->callbackspec.size);
+                SDL_EndAudioTiming(device, start);
+            }
+            if (need_lock) {
+                SDL_UnlockMutex(device->mixer_lock);
             }
-            SDL_UnlockMutex(device->mixer_lock);
         }
     }
 
@@ -1143,7 +2046,26 @@ close_audio_device(SDL_AudioDevice * device)
         current_audio.impl.CloseDevice(device);
     }
 
-    SDL_FreeDataQueue(device->buffer_queue);
+    /* every thread that mixes voices is gone now, so whatever list a voice
+       is on doesn't matter. Free the ones the app let go of; stop the rest. */
+    while (device->all_voices) {
+        SDL_AudioVoice *voice = device->all_voices;
+        device->all_voices = voice->all_next;
+        if (SDL_AtomicGet(&voice->state) == SDL_AUDIOVOICE_FREEING) {
+            SDL_DestroyAudioVoice(voice);
+        } else {
+            voice->device = NULL;
+            voice->all_prev = voice->all_next = NULL;
+            SDL_AtomicSet(&voice->state, SDL_AUDIOVOICE_STOPPED);
+        }
+    }
+    SDL_SIMDFree(device->voice_bus);
+    SDL_SIMDFree(device->voice_scratch);
+
+    SDL_FreeAudioRing(device->buffer_ring);
+    if (device->queue_lock != NULL) {
+        SDL_DestroyMutex(device->queue_lock);
+    }
 
     SDL_free(device);
 }
@@ -1408,17 +2330,24 @@ open_audio_device(const char *devname, int iscapture,
     }
 
     if (device->spec.callback == NULL) {  /* use buffer queueing? */
-        /* pool a few packets to start. Enough for two callbacks. */
-        device->buffer_queue = SDL_NewDataQueue(SDL_AUDIOBUFFERQUEUE_PACKETLEN, obtained->size * 2);
-        if (!device->buffer_queue) {
+        /* Enough for two callbacks, at least. */
+        device->buffer_ring = SDL_NewAudioRing(SDL_GetAudioQueueLength(obtained->format, obtained->channels,
+                                                                       obtained->freq, obtained->size * 2));
+        device->queue_lock = device->buffer_ring ? SDL_CreateMutex() : NULL;
+        if (!device->queue_lock) {
             close_audio_device(device);
             SDL_SetError("Couldn't create audio buffer queue");
             return 0;
         }
+        device->queue_starved = SDL_TRUE;  /* nothing queued yet isn't an underrun. */
         device->callbackspec.callback = iscapture ? SDL_BufferQueueFillCallback : SDL_BufferQueueDrainCallback;
         device->callbackspec.userdata = device;
     }
 
+    device->deadline_scheduling = SDL_GetHintBoolean(SDL_HINT_AUDIO_DEADLINE_SCHEDULING, SDL_FALSE);
+    device->pace_period = (SDL_GetPerformanceFrequency() * device->spec.samples) / device->spec.freq;
+    device->timing_period = (SDL_GetPerformanceFrequency() * device->callbackspec.samples) / device->callbackspec.freq;
+
     /* Allocate a scratch audio buffer */
     device->work_buffer_len = build_stream ? device->callbackspec.size : 0;
     if (device->spec.size > device->work_buffer_len) {
@@ -1613,8 +2542,6 @@ SDL_AudioQuit(void)
 #ifdef HAVE_LIBSAMPLERATE_H
     UnloadLibSampleRate();
 #endif
-
-    SDL_FreeResampleFilter();
 }
 
 #define NUM_FORMATS 10
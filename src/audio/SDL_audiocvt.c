@@ -32,6 +32,7 @@
 #include "SDL_loadso.h"
 #include "SDL_assert.h"
 #include "../SDL_dataqueue.h"
+#include "../thread/SDL_workers_c.h"
 #include "SDL_cpuinfo.h"
 
 #define DEBUG_AUDIOSTREAM 0
@@ -380,7 +381,6 @@ SDL_Convert51To71(SDL_AudioCVT * cvt, SDL_AudioFormat format)
 #define RESAMPLER_ZERO_CROSSINGS 5
 #define RESAMPLER_BITS_PER_SAMPLE 16
 #define RESAMPLER_SAMPLES_PER_ZERO_CROSSING  (1 << ((RESAMPLER_BITS_PER_SAMPLE / 2) + 1))
-#define RESAMPLER_FILTER_SIZE ((RESAMPLER_SAMPLES_PER_ZERO_CROSSING * RESAMPLER_ZERO_CROSSINGS) + 1)
 
 /* This is a "modified" bessel function, so you can't use POSIX j0() */
 static double
@@ -404,133 +404,623 @@ bessel(const double x)
     return i0;
 }
 
-/* build kaiser table with cardinal sine applied to it, and array of differences between elements. */
+static int
+ResamplerPadding(const int inrate, const int outrate)
+{
+    if (inrate == outrate) {
+        return 0;
+    } else if (inrate > outrate) {
+        return (int) SDL_ceil(((float) (RESAMPLER_SAMPLES_PER_ZERO_CROSSING * inrate) / ((float) outrate)));
+    }
+    return RESAMPLER_SAMPLES_PER_ZERO_CROSSING;
+}
+
+/* Every quality level is a polyphase filter: rational rate pairs (44100 <->
+   48000 and friends) only ever produce a few distinct fractional positions,
+   so the taps for each of those "phases" are computed once. Each output
+   frame is then a dot product of a few input frames with one row of
+   coefficients, done for all channels of the frame together. Rate pairs
+   with more phases than RESAMPLER_MAX_PHASES use the nearest row, so their
+   table has an extra row for t=1.0 that the last phases can round up to. */
+
+#define RESAMPLER_MAX_TAPS 32
+#define RESAMPLER_MAX_PHASES 1024
+#define RESAMPLER_MAX_CHANNELS 8
+
+/* The high quality sinc is longer, and is attenuated further in the stopband */
+#define RESAMPLER_SINC_HIGH_ZERO_CROSSINGS (RESAMPLER_MAX_TAPS / 2)
+#define RESAMPLER_SINC_HIGH_DB 100.0
+
+#ifdef __SSE__
+#define HAVE_SSE_INTRINSICS 1
+#endif
+
+#ifdef __ARM_NEON
+#define HAVE_NEON_INTRINSICS 1
+#endif
+
+typedef struct SDL_PolyphaseFilter SDL_PolyphaseFilter;
+
+typedef void (*SDL_PolyphaseKernel)(const SDL_PolyphaseFilter *filter, const int chans,
+                                    const float *inbuf, int srcindex, int phase,
+                                    float *dst, const int frames);
+
+struct SDL_PolyphaseFilter
+{
+    float *coefficients;  /* (taps) for each table row, 16 byte aligned. NULL for nearest and linear. */
+    int taps;  /* input frames read for each output frame, a multiple of 4 if there's a table. */
+    int left_taps;  /* how many of those come before the input frame at or before the output frame. */
+    int phases;  /* output frames per cycle of the rate ratio. */
+    int step;  /* input frames per cycle of the rate ratio. */
+    Uint64 phase_scale;  /* maps a phase to a table row, 32.32 fixed point. */
+    SDL_PolyphaseKernel kernel;
+};
+
+/* Advance to the next output frame: 'step' input frames per 'phases' output frames. */
+#define POLYPHASE_NEXT_FRAME() \
+    phase += step_rem; \
+    srcindex += step_quot; \
+    if (phase >= phases) { \
+        phase -= phases; \
+        ++srcindex; \
+    }
+
+#define POLYPHASE_KERNEL_SETUP() \
+    const int phases = filter->phases; \
+    const int step_quot = filter->step / phases; \
+    const int step_rem = filter->step % phases; \
+    const int taps = filter->taps; \
+    const int left_taps = filter->left_taps; \
+    int i
+
+#define POLYPHASE_ROW() \
+    (filter->coefficients + (size_t) (((((Uint64) phase) * filter->phase_scale) + 0x80000000u) >> 32) * taps)
+
 static void
-kaiser_and_sinc(float *table, float *diffs, const int tablelen, const double beta)
+SDL_ResampleNearest(const SDL_PolyphaseFilter *filter, const int chans,
+                    const float *inbuf, int srcindex, int phase,
+                    float *dst, const int frames)
 {
-    const int lenm1 = tablelen - 1;
-    const int lenm1div2 = lenm1 / 2;
-    int i;
+    POLYPHASE_KERNEL_SETUP();
+    int chan;
 
-    table[0] = 1.0f;
-    for (i = 1; i < tablelen; i++) {
-        const double kaiser = bessel(beta * SDL_sqrt(1.0 - SDL_pow(((i - lenm1) / 2.0) / lenm1div2, 2.0))) / bessel(beta);
-        table[tablelen - i] = (float) kaiser;
+    for (i = 0; i < frames; i++) {
+        const float *src = inbuf + (srcindex - left_taps + ((phase * 2 >= phases) ? 1 : 0)) * chans;
+        for (chan = 0; chan < chans; chan++) {
+            dst[chan] = src[chan];
+        }
+        dst += chans;
+
+        POLYPHASE_NEXT_FRAME();
     }
+    (void) taps;
+}
 
-    for (i = 1; i < tablelen; i++) {
-        const float x = (((float) i) / ((float) RESAMPLER_SAMPLES_PER_ZERO_CROSSING)) * ((float) M_PI);
-        table[i] *= SDL_sinf(x) / x;
-        diffs[i - 1] = table[i] - table[i - 1];
+static void
+SDL_ResampleLinear_Scalar(const SDL_PolyphaseFilter *filter, const int chans,
+                          const float *inbuf, int srcindex, int phase,
+                          float *dst, const int frames)
+{
+    POLYPHASE_KERNEL_SETUP();
+    const float scale = 1.0f / phases;
+    int chan;
+
+    for (i = 0; i < frames; i++) {
+        const float *src = inbuf + (srcindex - left_taps) * chans;
+        const float t = phase * scale;
+        for (chan = 0; chan < chans; chan++) {
+            dst[chan] = src[chan] + ((src[chans + chan] - src[chan]) * t);
+        }
+        dst += chans;
+
+        POLYPHASE_NEXT_FRAME();
     }
-    diffs[lenm1] = 0.0f;
+    (void) taps;
 }
 
+static void
+SDL_ResamplePolyphase_Scalar(const SDL_PolyphaseFilter *filter, const int chans,
+                             const float *inbuf, int srcindex, int phase,
+                             float *dst, const int frames)
+{
+    POLYPHASE_KERNEL_SETUP();
+    int j, chan;
 
-static SDL_SpinLock ResampleFilterSpinlock = 0;
-static float *ResamplerFilter = NULL;
-static float *ResamplerFilterDifference = NULL;
+    for (i = 0; i < frames; i++) {
+        const float *src = inbuf + (srcindex - left_taps) * chans;
+        const float *coeffs = POLYPHASE_ROW();
 
-int
-SDL_PrepareResampleFilter(void)
-{
-    SDL_AtomicLock(&ResampleFilterSpinlock);
-    if (!ResamplerFilter) {
-        /* if dB > 50, beta=(0.1102 * (dB - 8.7)), according to Matlab. */
-        const double dB = 80.0;
-        const double beta = 0.1102 * (dB - 8.7);
-        const size_t alloclen = RESAMPLER_FILTER_SIZE * sizeof (float);
-
-        ResamplerFilter = (float *) SDL_malloc(alloclen);
-        if (!ResamplerFilter) {
-            SDL_AtomicUnlock(&ResampleFilterSpinlock);
-            return SDL_OutOfMemory();
+        for (chan = 0; chan < chans; chan++) {
+            dst[chan] = 0.0f;
+        }
+        for (j = 0; j < taps; j++) {
+            const float c = coeffs[j];
+            for (chan = 0; chan < chans; chan++) {
+                dst[chan] += src[chan] * c;
+            }
+            src += chans;
         }
+        dst += chans;
+
+        POLYPHASE_NEXT_FRAME();
+    }
+}
 
-        ResamplerFilterDifference = (float *) SDL_malloc(alloclen);
-        if (!ResamplerFilterDifference) {
-            SDL_free(ResamplerFilter);
-            ResamplerFilter = NULL;
-            SDL_AtomicUnlock(&ResampleFilterSpinlock);
-            return SDL_OutOfMemory();
+#if HAVE_SSE_INTRINSICS
+static void
+SDL_ResampleLinear_SSE(const SDL_PolyphaseFilter *filter, const int chans,
+                       const float *inbuf, int srcindex, int phase,
+                       float *dst, const int frames)
+{
+    POLYPHASE_KERNEL_SETUP();
+    const float scale = 1.0f / phases;
+    int chan;
+
+    for (i = 0; i < frames; i++) {
+        const float *src = inbuf + (srcindex - left_taps) * chans;
+        const float t = phase * scale;
+
+        if (chans == 2) {
+            /* Both stereo frames fit in one register. */
+            const __m128 frames01 = _mm_loadu_ps(src);
+            const __m128 delta = _mm_sub_ps(_mm_movehl_ps(frames01, frames01), frames01);
+            _mm_storel_pi((__m64 *) dst, _mm_add_ps(frames01, _mm_mul_ps(delta, _mm_set1_ps(t))));
+        } else {
+            const __m128 t4 = _mm_set1_ps(t);
+            for (chan = 0; chan + 4 <= chans; chan += 4) {
+                const __m128 a = _mm_loadu_ps(src + chan);
+                const __m128 b = _mm_loadu_ps(src + chans + chan);
+                _mm_storeu_ps(dst + chan, _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), t4)));
+            }
+            for (; chan < chans; chan++) {
+                dst[chan] = src[chan] + ((src[chans + chan] - src[chan]) * t);
+            }
         }
-        kaiser_and_sinc(ResamplerFilter, ResamplerFilterDifference, RESAMPLER_FILTER_SIZE, beta);
+        dst += chans;
+
+        POLYPHASE_NEXT_FRAME();
     }
-    SDL_AtomicUnlock(&ResampleFilterSpinlock);
-    return 0;
+    (void) taps;
 }
 
-void
-SDL_FreeResampleFilter(void)
+static void
+SDL_ResamplePolyphase_SSE(const SDL_PolyphaseFilter *filter, const int chans,
+                          const float *inbuf, int srcindex, int phase,
+                          float *dst, const int frames)
+{
+    POLYPHASE_KERNEL_SETUP();
+    int j, chan;
+
+    for (i = 0; i < frames; i++) {
+        const float *src = inbuf + (srcindex - left_taps) * chans;
+        const float *coeffs = POLYPHASE_ROW();
+
+        if (chans == 1) {
+            /* The window is contiguous, so this is a plain dot product. */
+            __m128 sum = _mm_mul_ps(_mm_loadu_ps(src), _mm_load_ps(coeffs));
+            for (j = 4; j < taps; j += 4) {
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(src + j), _mm_load_ps(coeffs + j)));
+            }
+            sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+            sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 1, 1, 1)));
+            _mm_store_ss(dst, sum);
+        } else if (chans == 2) {
+            /* Two stereo frames per register, each coefficient duplicated for left and right. */
+            __m128 sum = _mm_setzero_ps();
+            for (j = 0; j < taps; j += 4) {
+                const __m128 c = _mm_load_ps(coeffs + j);
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(src + j * 2), _mm_unpacklo_ps(c, c)));
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(src + j * 2 + 4), _mm_unpackhi_ps(c, c)));
+            }
+            sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+            _mm_storel_pi((__m64 *) dst, sum);
+        } else {
+            /* Four channels at a time, then whatever is left over. */
+            for (chan = 0; chan + 4 <= chans; chan += 4) {
+                const float *s = src + chan;
+                __m128 sum = _mm_setzero_ps();
+                for (j = 0; j < taps; j++) {
+                    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(s), _mm_set1_ps(coeffs[j])));
+                    s += chans;
+                }
+                _mm_storeu_ps(dst + chan, sum);
+            }
+            for (; chan < chans; chan++) {
+                const float *s = src + chan;
+                float sum = 0.0f;
+                for (j = 0; j < taps; j++) {
+                    sum += *s * coeffs[j];
+                    s += chans;
+                }
+                dst[chan] = sum;
+            }
+        }
+        dst += chans;
+
+        POLYPHASE_NEXT_FRAME();
+    }
+}
+#endif /* HAVE_SSE_INTRINSICS */
+
+#if HAVE_AVX2_INTRINSICS
+/* 7.1 fits a whole frame in one register. */
+SDL_TARGETING("avx2") static void
+SDL_ResamplePolyphase_AVX2(const SDL_PolyphaseFilter *filter, const int chans,
+                           const float *inbuf, int srcindex, int phase,
+                           float *dst, const int frames)
+{
+    POLYPHASE_KERNEL_SETUP();
+    int j;
+
+    SDL_assert(chans == 8);
+
+    for (i = 0; i < frames; i++) {
+        const float *src = inbuf + (srcindex - left_taps) * 8;
+        const float *coeffs = POLYPHASE_ROW();
+        __m256 sum0 = _mm256_setzero_ps();
+        __m256 sum1 = _mm256_setzero_ps();
+
+        for (j = 0; j < taps; j += 2) {
+            sum0 = _mm256_add_ps(sum0, _mm256_mul_ps(_mm256_loadu_ps(src), _mm256_broadcast_ss(&coeffs[j])));
+            sum1 = _mm256_add_ps(sum1, _mm256_mul_ps(_mm256_loadu_ps(src + 8), _mm256_broadcast_ss(&coeffs[j + 1])));
+            src += 16;
+        }
+        _mm256_storeu_ps(dst, _mm256_add_ps(sum0, sum1));
+        dst += 8;
+
+        POLYPHASE_NEXT_FRAME();
+    }
+}
+#endif /* HAVE_AVX2_INTRINSICS */
+
+#if HAVE_NEON_INTRINSICS
+static void
+SDL_ResampleLinear_NEON(const SDL_PolyphaseFilter *filter, const int chans,
+                        const float *inbuf, int srcindex, int phase,
+                        float *dst, const int frames)
+{
+    POLYPHASE_KERNEL_SETUP();
+    const float scale = 1.0f / phases;
+    int chan;
+
+    for (i = 0; i < frames; i++) {
+        const float *src = inbuf + (srcindex - left_taps) * chans;
+        const float t = phase * scale;
+
+        if (chans == 2) {
+            /* Both stereo frames fit in one register. */
+            const float32x4_t frames01 = vld1q_f32(src);
+            const float32x2_t a = vget_low_f32(frames01);
+            vst1_f32(dst, vmla_n_f32(a, vsub_f32(vget_high_f32(frames01), a), t));
+        } else {
+            for (chan = 0; chan + 4 <= chans; chan += 4) {
+                const float32x4_t a = vld1q_f32(src + chan);
+                const float32x4_t b = vld1q_f32(src + chans + chan);
+                vst1q_f32(dst + chan, vmlaq_n_f32(a, vsubq_f32(b, a), t));
+            }
+            for (; chan < chans; chan++) {
+                dst[chan] = src[chan] + ((src[chans + chan] - src[chan]) * t);
+            }
+        }
+        dst += chans;
+
+        POLYPHASE_NEXT_FRAME();
+    }
+    (void) taps;
+}
+
+static void
+SDL_ResamplePolyphase_NEON(const SDL_PolyphaseFilter *filter, const int chans,
+                           const float *inbuf, int srcindex, int phase,
+                           float *dst, const int frames)
 {
-    SDL_free(ResamplerFilter);
-    SDL_free(ResamplerFilterDifference);
-    ResamplerFilter = NULL;
-    ResamplerFilterDifference = NULL;
+    POLYPHASE_KERNEL_SETUP();
+    int j, chan;
+
+    for (i = 0; i < frames; i++) {
+        const float *src = inbuf + (srcindex - left_taps) * chans;
+        const float *coeffs = POLYPHASE_ROW();
+
+        if (chans == 1) {
+            /* The window is contiguous, so this is a plain dot product. */
+            float32x4_t sum = vmulq_f32(vld1q_f32(src), vld1q_f32(coeffs));
+            float32x2_t half;
+            for (j = 4; j < taps; j += 4) {
+                sum = vmlaq_f32(sum, vld1q_f32(src + j), vld1q_f32(coeffs + j));
+            }
+            half = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+            dst[0] = vget_lane_f32(vpadd_f32(half, half), 0);
+        } else if (chans == 2) {
+            /* Two stereo frames per register, each coefficient duplicated for left and right. */
+            float32x4_t sum = vdupq_n_f32(0.0f);
+            for (j = 0; j < taps; j += 4) {
+                const float32x4x2_t c = vzipq_f32(vld1q_f32(coeffs + j), vld1q_f32(coeffs + j));
+                sum = vmlaq_f32(sum, vld1q_f32(src + j * 2), c.val[0]);
+                sum = vmlaq_f32(sum, vld1q_f32(src + j * 2 + 4), c.val[1]);
+            }
+            vst1_f32(dst, vadd_f32(vget_low_f32(sum), vget_high_f32(sum)));
+        } else {
+            /* Four channels at a time, then whatever is left over. */
+            for (chan = 0; chan + 4 <= chans; chan += 4) {
+                const float *s = src + chan;
+                float32x4_t sum = vdupq_n_f32(0.0f);
+                for (j = 0; j < taps; j++) {
+                    sum = vmlaq_n_f32(sum, vld1q_f32(s), coeffs[j]);
+                    s += chans;
+                }
+                vst1q_f32(dst + chan, sum);
+            }
+            for (; chan < chans; chan++) {
+                const float *s = src + chan;
+                float sum = 0.0f;
+                for (j = 0; j < taps; j++) {
+                    sum += *s * coeffs[j];
+                    s += chans;
+                }
+                dst[chan] = sum;
+            }
+        }
+        dst += chans;
+
+        POLYPHASE_NEXT_FRAME();
+    }
+}
+#endif /* HAVE_NEON_INTRINSICS */
+
+#undef POLYPHASE_ROW
+#undef POLYPHASE_KERNEL_SETUP
+#undef POLYPHASE_NEXT_FRAME
+
+static SDL_PolyphaseKernel
+SDL_ChoosePolyphaseKernel(const SDL_AudioResampleQuality quality, const int chans)
+{
+    if (quality == SDL_RESAMPLE_NEAREST) {
+        return SDL_ResampleNearest;
+    } else if (quality == SDL_RESAMPLE_LINEAR) {
+#if HAVE_SSE_INTRINSICS
+        if (SDL_HasSSE()) {
+            return SDL_ResampleLinear_SSE;
+        }
+#endif
+#if HAVE_NEON_INTRINSICS
+        if (SDL_HasNEON()) {
+            return SDL_ResampleLinear_NEON;
+        }
+#endif
+        return SDL_ResampleLinear_Scalar;
+    }
+
+#if HAVE_AVX2_INTRINSICS
+    if (chans == 8 && SDL_HasAVX2()) {
+        return SDL_ResamplePolyphase_AVX2;
+    }
+#endif
+#if HAVE_SSE_INTRINSICS
+    if (SDL_HasSSE()) {
+        return SDL_ResamplePolyphase_SSE;
+    }
+#endif
+#if HAVE_NEON_INTRINSICS
+    if (SDL_HasNEON()) {
+        return SDL_ResamplePolyphase_NEON;
+    }
+#endif
+    return SDL_ResamplePolyphase_Scalar;
 }
 
 static int
-ResamplerPadding(const int inrate, const int outrate)
+gcd(int a, int b)
 {
-    if (inrate == outrate) {
+    while (b) {
+        const int t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/* Catmull-Rom spline through the two frames on either side of (t). */
+static void
+cubic_taps(float *coeffs, const double t)
+{
+    const double t2 = t * t;
+    const double t3 = t2 * t;
+
+    coeffs[0] = (float) ((-t3 + (2.0 * t2) - t) / 2.0);
+    coeffs[1] = (float) (((3.0 * t3) - (5.0 * t2) + 2.0) / 2.0);
+    coeffs[2] = (float) ((-(3.0 * t3) + (4.0 * t2) + t) / 2.0);
+    coeffs[3] = (float) ((t3 - t2) / 2.0);
+}
+
+/* Kaiser windowed sinc, RESAMPLER_ZERO_CROSSINGS wide on either side of (t).
+   This is the 80 dB filter SDL_ResampleAudio() used to interpolate out of a
+   shared table, evaluated at the exact tap positions instead. */
+static void
+sinc_low_taps(float *coeffs, const double t)
+{
+    /* if dB > 50, beta=(0.1102 * (dB - 8.7)), according to Matlab. */
+    const double beta = 0.1102 * (80.0 - 8.7);
+    const double bessel_beta = bessel(beta);
+    int j;
+
+    for (j = 0; j < (RESAMPLER_ZERO_CROSSINGS + 1) * 2; j++) {
+        const double x = SDL_fabs((j - RESAMPLER_ZERO_CROSSINGS) - t);
+        const double r = x / RESAMPLER_ZERO_CROSSINGS;
+        if (r < 1.0) {
+            const double window = bessel(beta * SDL_sqrt(1.0 - (r * r))) / bessel_beta;
+            const double sinc = (x < 1.0e-9) ? 1.0 : SDL_sin(M_PI * x) / (M_PI * x);
+            coeffs[j] = (float) (window * sinc);
+        } else {
+            coeffs[j] = 0.0f;
+        }
+    }
+}
+
+/* Kaiser windowed sinc with its cutoff below both Nyquist frequencies, so
+   downsampling doesn't alias. Normalized so every phase has unity gain. */
+static void
+sinc_high_taps(float *coeffs, const double t, const double cutoff, const double beta)
+{
+    const double halfwidth = RESAMPLER_SINC_HIGH_ZERO_CROSSINGS;
+    double taps[RESAMPLER_MAX_TAPS];
+    double sum = 0.0;
+    int j;
+
+    for (j = 0; j < RESAMPLER_MAX_TAPS; j++) {
+        const double x = (j - (RESAMPLER_SINC_HIGH_ZERO_CROSSINGS - 1)) - t;
+        const double r = x / halfwidth;
+        const double window = (r * r < 1.0) ? bessel(beta * SDL_sqrt(1.0 - (r * r))) / bessel(beta) : 0.0;
+        const double phase = M_PI * cutoff * x;
+        const double sinc = (SDL_fabs(phase) < 1.0e-9) ? 1.0 : SDL_sin(phase) / phase;
+        taps[j] = cutoff * sinc * window;
+        sum += taps[j];
+    }
+    for (j = 0; j < RESAMPLER_MAX_TAPS; j++) {
+        coeffs[j] = (float) (taps[j] / sum);
+    }
+}
+
+/* Leaves (filter) empty if there's nothing to resample. */
+static int
+SDL_BuildPolyphaseFilter(SDL_PolyphaseFilter *filter, const SDL_AudioResampleQuality quality,
+                        const int chans, const int inrate, const int outrate)
+{
+    int divisor, rows, tablerows, row;
+
+    SDL_zerop(filter);
+
+    if (inrate <= 0 || outrate <= 0 || inrate == outrate || chans > RESAMPLER_MAX_CHANNELS) {
         return 0;
-    } else if (inrate > outrate) {
-        return (int) SDL_ceil(((float) (RESAMPLER_SAMPLES_PER_ZERO_CROSSING * inrate) / ((float) outrate)));
     }
-    return RESAMPLER_SAMPLES_PER_ZERO_CROSSING;
+
+    divisor = gcd(inrate, outrate);
+    filter->phases = outrate / divisor;
+    filter->step = inrate / divisor;
+    filter->kernel = SDL_ChoosePolyphaseKernel(quality, chans);
+
+    switch (quality) {
+    case SDL_RESAMPLE_NEAREST:
+    case SDL_RESAMPLE_LINEAR:
+        filter->taps = 2;
+        filter->left_taps = 0;
+        return 0;  /* these work straight from the phase, no table. */
+    case SDL_RESAMPLE_CUBIC:
+        filter->taps = 4;
+        filter->left_taps = 1;
+        break;
+    case SDL_RESAMPLE_SINC_LOW:
+        filter->taps = (RESAMPLER_ZERO_CROSSINGS + 1) * 2;
+        filter->left_taps = RESAMPLER_ZERO_CROSSINGS;
+        break;
+    default:
+        filter->taps = RESAMPLER_MAX_TAPS;
+        filter->left_taps = RESAMPLER_SINC_HIGH_ZERO_CROSSINGS - 1;
+        break;
+    }
+
+    SDL_assert((filter->taps % 4) == 0);  /* the SIMD kernels load the coefficients four at a time. */
+    SDL_assert(filter->taps <= RESAMPLER_MAX_TAPS);
+
+    rows = SDL_min(filter->phases, RESAMPLER_MAX_PHASES);
+    tablerows = (rows < filter->phases) ? (rows + 1) : rows;
+    filter->phase_scale = (((Uint64) rows) << 32) / filter->phases;
+    filter->coefficients = (float *) SDL_SIMDAlloc(tablerows * filter->taps * sizeof (float));
+    if (!filter->coefficients) {
+        SDL_zerop(filter);
+        return SDL_OutOfMemory();
+    }
+    SDL_memset(filter->coefficients, '\0', tablerows * filter->taps * sizeof (float));
+
+    for (row = 0; row < tablerows; row++) {
+        const double t = ((double) row) / ((double) rows);
+        float *coeffs = filter->coefficients + (row * filter->taps);
+
+        if (quality == SDL_RESAMPLE_CUBIC) {
+            cubic_taps(coeffs, t);
+        } else if (quality == SDL_RESAMPLE_SINC_LOW) {
+            sinc_low_taps(coeffs, t);
+        } else {
+            /* if dB > 50, beta=(0.1102 * (dB - 8.7)), according to Matlab. */
+            const double beta = 0.1102 * (RESAMPLER_SINC_HIGH_DB - 8.7);
+            const double cutoff = 0.95 * SDL_min(1.0, ((double) outrate) / ((double) inrate));
+            sinc_high_taps(coeffs, t, cutoff, beta);
+        }
+    }
+    return 0;
+}
+
+static void
+SDL_FreePolyphaseFilter(SDL_PolyphaseFilter *filter)
+{
+    SDL_SIMDFree(filter->coefficients);
+    SDL_zerop(filter);
 }
 
 /* lpadding and rpadding are expected to be buffers of (ResamplePadding(inrate, outrate) * chans * sizeof (float)) bytes. */
 static int
-SDL_ResampleAudio(const int chans, const int inrate, const int outrate,
-                        const float *lpadding, const float *rpadding,
-                        const float *inbuf, const int inbuflen,
-                        float *outbuf, const int outbuflen)
-{
-    const double finrate = (double) inrate;
-    const double outtimeincr = 1.0 / ((float) outrate);
-    const double  ratio = ((float) outrate) / ((float) inrate);
+SDL_ResampleAudio(const SDL_PolyphaseFilter *filter, const int chans,
+                  const int inrate, const int outrate,
+                  const float *lpadding, const float *rpadding,
+                  const float *inbuf, const int inbuflen,
+                  float *outbuf, const int outbuflen)
+{
+    const double ratio = ((float) outrate) / ((float) inrate);
     const int paddinglen = ResamplerPadding(inrate, outrate);
     const int framelen = chans * (int)sizeof (float);
     const int inframes = inbuflen / framelen;
     const int wantedoutframes = (int) ((inbuflen / framelen) * ratio);  /* outbuflen isn't total to write, it's total available. */
     const int maxoutframes = outbuflen / framelen;
     const int outframes = SDL_min(wantedoutframes, maxoutframes);
+    const int left_taps = filter->left_taps;
+    const int right_taps = filter->taps - filter->left_taps - 1;
+    const Sint64 phases = filter->phases;
+    const Sint64 step = filter->step;
+    Sint64 first, last;
+    float window[RESAMPLER_MAX_TAPS * RESAMPLER_MAX_CHANNELS];
     float *dst = outbuf;
-    double outtime = 0.0;
     int i, j, chan;
 
+    SDL_assert(paddinglen >= left_taps && paddinglen >= right_taps);
+
+    /* Output frames in [first, last] have all their taps inside inbuf. */
+    first = ((left_taps * phases) + step - 1) / step;
+    last = (((inframes - right_taps) * phases) - 1) / step;
+    if (inframes <= right_taps) {
+        last = -1;
+    }
+    first = SDL_min(first, outframes);
+    last = SDL_min(last, outframes - 1);
+
     for (i = 0; i < outframes; i++) {
-        const int srcindex = (int) (outtime * inrate);
-        const double intime = ((double) srcindex) / finrate;
-        const double innexttime = ((double) (srcindex + 1)) / finrate;
-        const double interpolation1 = 1.0 - ((innexttime - outtime) / (innexttime - intime));
-        const int filterindex1 = (int) (interpolation1 * RESAMPLER_SAMPLES_PER_ZERO_CROSSING);
-        const double interpolation2 = 1.0 - interpolation1;
-        const int filterindex2 = (int) (interpolation2 * RESAMPLER_SAMPLES_PER_ZERO_CROSSING);
+        const Sint64 position = i * step;
+        const int srcindex = (int) (position / phases);
+        const int phase = (int) (position % phases);
+
+        if (i >= first && i <= last) {
+            /* Everything up to (last) can read straight from inbuf. */
+            filter->kernel(filter, chans, inbuf, srcindex, phase, dst, (int) (last - i + 1));
+            dst += (last - i + 1) * chans;
+            i = (int) last;
+            continue;
+        }
 
-        for (chan = 0; chan < chans; chan++) {
-            float outsample = 0.0f;
-
-            /* do this twice to calculate the sample, once for the "left wing" and then same for the right. */
-            /* !!! FIXME: do both wings in one loop */
-            for (j = 0; (filterindex1 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)) < RESAMPLER_FILTER_SIZE; j++) {
-                const int srcframe = srcindex - j;
-                /* !!! FIXME: we can bubble this conditional out of here by doing a pre loop. */
-                const float insample = (srcframe < 0) ? lpadding[((paddinglen + srcframe) * chans) + chan] : inbuf[(srcframe * chans) + chan];
-                outsample += (float)(insample * (ResamplerFilter[filterindex1 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)] + (interpolation1 * ResamplerFilterDifference[filterindex1 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)])));
+        /* Gather the taps that hang off either end of inbuf. */
+        for (j = 0; j < filter->taps; j++) {
+            const int srcframe = srcindex - left_taps + j;
+            const float *src;
+            if (srcframe < 0) {
+                src = lpadding + ((paddinglen + srcframe) * chans);
+            } else if (srcframe >= inframes) {
+                src = rpadding + ((srcframe - inframes) * chans);
+            } else {
+                src = inbuf + (srcframe * chans);
             }
-
-            for (j = 0; (filterindex2 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)) < RESAMPLER_FILTER_SIZE; j++) {
-                const int srcframe = srcindex + 1 + j;
-                /* !!! FIXME: we can bubble this conditional out of here by doing a post loop. */
-                const float insample = (srcframe >= inframes) ? rpadding[((srcframe - inframes) * chans) + chan] : inbuf[(srcframe * chans) + chan];
-                outsample += (float)(insample * (ResamplerFilter[filterindex2 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)] + (interpolation2 * ResamplerFilterDifference[filterindex2 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)])));
+            for (chan = 0; chan < chans; chan++) {
+                window[(j * chans) + chan] = src[chan];
             }
-            *(dst++) = outsample;
         }
-
-        outtime += outtimeincr;
+        filter->kernel(filter, chans, window + (left_taps * chans), 0, phase, dst, 1);
+        dst += chans;
     }
 
     return outframes * chans * sizeof (float);
@@ -559,6 +1049,92 @@ SDL_ConvertAudio(SDL_AudioCVT * cvt)
     return 0;
 }
 
+typedef struct
+{
+    Sint64 cost;
+    int index;
+} SDL_AudioCVTBatchItem;
+
+typedef struct
+{
+    SDL_AudioCVT *cvts;
+    const SDL_AudioCVTBatchItem *order;
+} SDL_AudioCVTBatch;
+
+static int SDLCALL
+CompareAudioCVTBatchItems(const void *a, const void *b)
+{
+    const SDL_AudioCVTBatchItem *A = (const SDL_AudioCVTBatchItem *) a;
+    const SDL_AudioCVTBatchItem *B = (const SDL_AudioCVTBatchItem *) b;
+
+    if (A->cost != B->cost) {
+        return (A->cost > B->cost) ? -1 : 1;
+    }
+    return A->index - B->index;
+}
+
+static void
+SDL_ConvertAudioBatchItem(void *data, int index)
+{
+    const SDL_AudioCVTBatch *batch = (const SDL_AudioCVTBatch *) data;
+
+    if (batch->order) {
+        index = batch->order[index].index;
+    }
+    SDL_ConvertAudio(&batch->cvts[index]);
+}
+
+int
+SDL_ConvertAudioBatch(SDL_AudioCVT * cvts, int count)
+{
+    SDL_AudioCVTBatch batch;
+    SDL_AudioCVTBatchItem *order;
+    int i;
+
+    if (count < 0) {
+        return SDL_InvalidParamError("count");
+    } else if (count > 0 && cvts == NULL) {
+        return SDL_InvalidParamError("cvts");
+    }
+
+    /* Check everything up front: errors set on the worker threads would be
+       lost, and a half converted batch is no use to anybody. */
+    for (i = 0; i < count; i++) {
+        if (cvts[i].buf == NULL) {
+            return SDL_SetError("No buffer allocated for conversion %d", i);
+        }
+    }
+
+    /* The workers take the conversions in order, so start the biggest ones
+       first; otherwise a long one handed out last keeps everyone waiting.
+       If there's no memory for this, the given order works too. */
+    order = NULL;
+    if (count > 2) {
+        order = (SDL_AudioCVTBatchItem *) SDL_malloc(count * sizeof (*order));
+    }
+    if (order) {
+        for (i = 0; i < count; i++) {
+            const SDL_AudioCVT *cvt = &cvts[i];
+            Sint64 cost = cvt->len + (Sint64) (cvt->len * cvt->len_ratio);
+            if (cvt->rate_incr != 1.0) {
+                /* Resampling runs a many-tap filter for every output
+                   sample, which dwarfs the other filters. */
+                cost *= 16;
+            }
+            order[i].cost = cost;
+            order[i].index = i;
+        }
+        SDL_qsort(order, count, sizeof (*order), CompareAudioCVTBatchItems);
+    }
+
+    batch.cvts = cvts;
+    batch.order = order;
+    SDL_RunOnWorkers(SDL_ConvertAudioBatchItem, &batch, count);
+
+    SDL_free(order);
+    return 0;
+}
+
 static void SDLCALL
 SDL_Convert_Byteswap(SDL_AudioCVT *cvt, SDL_AudioFormat format)
 {
@@ -721,6 +1297,7 @@ SDL_ResampleCVT(SDL_AudioCVT *cvt, const int chans, const SDL_AudioFormat format
     const int requestedpadding = ResamplerPadding(inrate, outrate);
     int paddingsamples;
     float *padding;
+    SDL_PolyphaseFilter filter;
 
     if (requestedpadding < SDL_MAX_SINT32 / chans) {
         paddingsamples = requestedpadding * chans;
@@ -729,15 +1306,23 @@ SDL_ResampleCVT(SDL_AudioCVT *cvt, const int chans, const SDL_AudioFormat format
     }
     SDL_assert(format == AUDIO_F32SYS);
 
+    if (SDL_BuildPolyphaseFilter(&filter, SDL_RESAMPLE_SINC_LOW, chans, inrate, outrate) < 0) {
+        return;
+    }
+
     /* we keep no streaming state here, so pad with silence on both ends. */
     padding = (float *) SDL_calloc(paddingsamples ? paddingsamples : 1, sizeof (float));
     if (!padding) {
+        SDL_FreePolyphaseFilter(&filter);
         SDL_OutOfMemory();
         return;
     }
 
-    cvt->len_cvt = SDL_ResampleAudio(chans, inrate, outrate, padding, padding, src, srclen, dst, dstlen);
+    if (filter.kernel) {
+        cvt->len_cvt = SDL_ResampleAudio(&filter, chans, inrate, outrate, padding, padding, src, srclen, dst, dstlen);
+    }
 
+    SDL_FreePolyphaseFilter(&filter);
     SDL_free(padding);
 
     SDL_memmove(cvt->buf, dst, cvt->len_cvt);  /* !!! FIXME: remove this if we can get the resampler to work in-place again. */
@@ -793,10 +1378,6 @@ SDL_BuildAudioResampleCVT(SDL_AudioCVT * cvt, const int dst_channels,
         return SDL_SetError("No conversion available for these rates");
     }
 
-    if (SDL_PrepareResampleFilter() < 0) {
-        return -1;
-    }
-
     /* Update (cvt) with filter details... */
     if (SDL_AddAudioCVTFilter(cvt, filter) < 0) {
         return -1;
@@ -1090,17 +1671,22 @@ typedef int (*SDL_ResampleAudioStreamFunc)(SDL_AudioStream *stream, const void *
 typedef void (*SDL_ResetAudioStreamResamplerFunc)(SDL_AudioStream *stream);
 typedef void (*SDL_CleanupAudioStreamResamplerFunc)(SDL_AudioStream *stream);
 
+/* SDL_AudioStreamPut() converts a chunk at a time, sized so every stage of
+   the pipeline works on data that is still in L1 cache. */
+#define AUDIOSTREAM_CHUNK_BYTES (16 * 1024)
+#define AUDIOSTREAM_MIN_PACKET_LEN 4096
+
 struct _SDL_AudioStream
 {
     SDL_AudioCVT cvt_before_resampling;
     SDL_AudioCVT cvt_after_resampling;
     SDL_DataQueue *queue;
-    SDL_bool first_run;
-    Uint8 *staging_buffer;
-    int staging_buffer_size;
-    int staging_buffer_filled;
-    Uint8 *work_buffer_base;  /* maybe unaligned pointer from SDL_realloc(). */
-    int work_buffer_len;
+    Uint8 *work_buffer;  /* SDL_SIMDAlloc()'d once; resampler history, then chunk_buffer, then output_buffer. */
+    Uint8 *chunk_buffer;  /* each chunk is converted to float here, right after the resampler history. */
+    Uint8 *output_buffer;  /* resampled and/or converted output, when it can't go straight to the queue. */
+    int chunk_frames;  /* most source sample frames converted per pass. */
+    int output_buffer_len;
+    SDL_bool convert_in_queue;  /* cvt_after_resampling never needs more room than its output. */
     int src_sample_frame_size;
     SDL_AudioFormat src_format;
     Uint8 src_channels;
@@ -1112,37 +1698,19 @@ struct _SDL_AudioStream
     double rate_incr;
     Uint8 pre_resample_channels;
     int packetlen;
-    int resampler_padding_samples;
-    float *resampler_padding;
+    int resample_frames;  /* input frames kept from earlier chunks, right before chunk_buffer. */
+    int resample_srcindex;  /* input frame of the next output frame, counted from the first kept frame. */
+    int resample_phase;  /* ...and how far past it, in 1/phases of a frame. */
+    Sint64 total_in_frames;  /* since the last flush, so flushing knows how much output is still owed. */
+    Sint64 total_out_frames;
     void *resampler_state;
+    SDL_AudioResampleQuality resample_quality;
+    SDL_PolyphaseFilter resample_filter;
     SDL_ResampleAudioStreamFunc resampler_func;
     SDL_ResetAudioStreamResamplerFunc reset_resampler_func;
     SDL_CleanupAudioStreamResamplerFunc cleanup_resampler_func;
 };
 
-static Uint8 *
-EnsureStreamBufferSize(SDL_AudioStream *stream, const int newlen)
-{
-    Uint8 *ptr;
-    size_t offset;
-
-    if (stream->work_buffer_len >= newlen) {
-        ptr = stream->work_buffer_base;
-    } else {
-        ptr = (Uint8 *) SDL_realloc(stream->work_buffer_base, newlen + 32);
-        if (!ptr) {
-            SDL_OutOfMemory();
-            return NULL;
-        }
-        /* Make sure we're aligned to 16 bytes for SIMD code. */
-        stream->work_buffer_base = ptr;
-        stream->work_buffer_len = newlen;
-    }
-
-    offset = ((size_t) ptr) & 15;
-    return offset ? ptr + (16 - offset) : ptr;
-}
-
 #ifdef HAVE_LIBSAMPLERATE_H
 static int
 SDL_ResampleAudioStream_SRC(SDL_AudioStream *stream, const void *_inbuf, const int inbuflen, void *_outbuf, const int outbuflen)
@@ -1226,43 +1794,149 @@ SetupLibSampleRateResampling(SDL_AudioStream *stream)
 #endif /* HAVE_LIBSAMPLERATE_H */
 
 
+/* How many output frames SDL_ResampleAudioStream() makes from (inframes) more
+   input frames: everything whose taps are all available. */
+static int
+SDL_CountResampledFrames(const SDL_AudioStream *stream, const int inframes)
+{
+    const SDL_PolyphaseFilter *filter = &stream->resample_filter;
+    const int right_taps = filter->taps - filter->left_taps - 1;
+    const Sint64 position = (((Sint64) stream->resample_srcindex) * filter->phases) + stream->resample_phase;
+    const Sint64 end = ((Sint64) (stream->resample_frames + inframes - right_taps)) * filter->phases;
+    return (position < end) ? (int) (((end - position) + filter->step - 1) / filter->step) : 0;
+}
+
+/* (inbuf) is stream->chunk_buffer, and the input frames kept from earlier
+   chunks sit right before it, so the filter never needs padding: it
+   stops where it runs out of input and picks up there next time, phase
+   and all. */
 static int
 SDL_ResampleAudioStream(SDL_AudioStream *stream, const void *_inbuf, const int inbuflen, void *_outbuf, const int outbuflen)
 {
-    const Uint8 *inbufend = ((const Uint8 *) _inbuf) + inbuflen;
-    const float *inbuf = (const float *) _inbuf;
-    float *outbuf = (float *) _outbuf;
+    const SDL_PolyphaseFilter *filter = &stream->resample_filter;
     const int chans = (int) stream->pre_resample_channels;
-    const int inrate = stream->src_rate;
-    const int outrate = stream->dst_rate;
-    const int paddingsamples = stream->resampler_padding_samples;
-    const int paddingbytes = paddingsamples * sizeof (float);
-    float *lpadding = (float *) stream->resampler_state;
-    const float *rpadding = (const float *) inbufend; /* we set this up so there are valid padding samples at the end of the input buffer. */
-    const int cpy = SDL_min(inbuflen, paddingbytes);
-    int retval;
-
-    SDL_assert(inbuf != ((const float *) outbuf));  /* SDL_AudioStreamPut() shouldn't allow in-place resamples. */
+    const int framelen = chans * (int) sizeof (float);
+    const float *inbuf = ((const float *) _inbuf) - (stream->resample_frames * chans);
+    const int outframes = SDL_CountResampledFrames(stream, inbuflen / framelen);
+    int frames = stream->resample_frames + (inbuflen / framelen);
+    Sint64 position = (((Sint64) stream->resample_srcindex) * filter->phases) + stream->resample_phase;
+    int discard;
+
+    SDL_assert(_inbuf == stream->chunk_buffer);
+    SDL_assert((outframes * framelen) <= outbuflen);
+
+    if (outframes > 0) {
+        filter->kernel(filter, chans, inbuf, stream->resample_srcindex, stream->resample_phase, (float *) _outbuf, outframes);
+        position += ((Sint64) outframes) * filter->step;
+    }
+
+    /* keep just the frames the next output frame still needs. */
+    stream->resample_srcindex = (int) (position / filter->phases);
+    stream->resample_phase = (int) (position % filter->phases);
+    discard = SDL_min(stream->resample_srcindex - filter->left_taps, frames);
+    frames -= discard;
+    stream->resample_srcindex -= discard;
+    stream->resample_frames = frames;
+    SDL_assert(frames <= RESAMPLER_MAX_TAPS);
+    SDL_memmove(stream->chunk_buffer - (frames * framelen), inbuf + (discard * chans), frames * framelen);
+
+    return outframes * framelen;
+}
 
-    retval = SDL_ResampleAudio(chans, inrate, outrate, lpadding, rpadding, inbuf, inbuflen, outbuf, outbuflen);
+/* Make sure the kept input covers the left side of the current filter,
+   after a reset or a quality change. Missing frames are silence. */
+static void
+SDL_PadAudioStreamResampler(SDL_AudioStream *stream)
+{
+    const int framelen = stream->pre_resample_channels * (int) sizeof (float);
+    const int missing = stream->resample_filter.left_taps - stream->resample_srcindex;
 
-    /* update our left padding with end of current input, for next run. */
-    SDL_memcpy((lpadding + paddingsamples) - (cpy / sizeof (float)), inbufend - cpy, cpy);
-    return retval;
+    if (missing > 0) {
+        Uint8 *first = stream->chunk_buffer - (stream->resample_frames * framelen);
+        SDL_assert((stream->resample_frames + missing) <= RESAMPLER_MAX_TAPS);
+        SDL_memset(first - (missing * framelen), '\0', missing * framelen);
+        stream->resample_frames += missing;
+        stream->resample_srcindex += missing;
+    }
 }
 
 static void
 SDL_ResetAudioStreamResampler(SDL_AudioStream *stream)
 {
-    /* set all the padding to silence. */
-    const int len = stream->resampler_padding_samples;
-    SDL_memset(stream->resampler_state, '\0', len * sizeof (float));
+    /* start over from silence. */
+    stream->resample_frames = 0;
+    stream->resample_srcindex = 0;
+    stream->resample_phase = 0;
+    SDL_PadAudioStreamResampler(stream);
 }
 
 static void
 SDL_CleanupAudioStreamResampler(SDL_AudioStream *stream)
 {
-    SDL_free(stream->resampler_state);
+    SDL_FreePolyphaseFilter(&stream->resample_filter);
+}
+
+/* Size the chunks so the source, the float data and the output of one pass
+   together fit in AUDIOSTREAM_CHUNK_BYTES, with room for the resampler's
+   slack on top, and the queue's packets so one chunk's output fits in one,
+   so it can be written to reserved queue space. */
+static int
+SDL_SetupAudioStreamChunks(SDL_AudioStream *stream)
+{
+    const SDL_bool resampling = (stream->src_rate != stream->dst_rate);
+    const int floatframelen = stream->pre_resample_channels * (int) sizeof (float);
+    const Sint64 srcrate = resampling ? stream->src_rate : 1;
+    const Sint64 dstrate = resampling ? stream->dst_rate : 1;
+    int historylen = 0;
+    int slack = 0;  /* extra output frames a chunk might produce. */
+    Sint64 inframelen, outframelen, frames;
+    int outframes, worklen;
+
+    if (resampling) {
+        const SDL_AudioCVT *cvt = &stream->cvt_before_resampling;
+        historylen = RESAMPLER_MAX_TAPS * floatframelen;
+        historylen = (historylen + 15) & ~15;  /* keep chunk_buffer aligned for the converters. */
+        /* after a quality change, the history can release up to a filter's
+           worth of input at once. Plus rounding, and libsamplerate's own ideas. */
+        slack = (int) (((RESAMPLER_MAX_TAPS * dstrate) + srcrate - 1) / srcrate) + 3;
+        inframelen = cvt->needed ? (stream->src_sample_frame_size * cvt->len_mult) : floatframelen;
+        outframelen = floatframelen;
+    } else {
+        inframelen = stream->src_sample_frame_size;
+        outframelen = 0;
+    }
+    if (stream->cvt_after_resampling.needed) {
+        const SDL_AudioCVT *cvt = &stream->cvt_after_resampling;
+        stream->convert_in_queue = (cvt->len_mult <= cvt->len_ratio) ? SDL_TRUE : SDL_FALSE;
+        if (resampling) {
+            outframelen *= cvt->len_mult;
+        } else {
+            inframelen *= cvt->len_mult;
+        }
+    }
+
+    /* the slack isn't taken out of the budget: at big upsampling ratios it
+       can be more than AUDIOSTREAM_CHUNK_BYTES by itself (8kHz to 192kHz 7.1). */
+    frames = (AUDIOSTREAM_CHUNK_BYTES * srcrate) / ((inframelen * srcrate) + (outframelen * dstrate));
+    frames = SDL_max(frames, 1);
+    if (frames > 0x10000) {
+        frames = 0x10000;  /* plenty, even for big frames at low rates. */
+    }
+
+    stream->chunk_frames = (int) frames;
+    outframes = (int) (((frames * dstrate) + srcrate - 1) / srcrate) + slack;
+    stream->packetlen = SDL_max(AUDIOSTREAM_MIN_PACKET_LEN, outframes * stream->dst_sample_frame_size);
+    stream->output_buffer_len = (int) (outframes * outframelen);
+    stream->output_buffer_len = SDL_max(stream->output_buffer_len, outframes * stream->dst_sample_frame_size);
+
+    worklen = historylen + (int) (((frames * inframelen) + 15) & ~15) + stream->output_buffer_len;
+    stream->work_buffer = (Uint8 *) SDL_SIMDAlloc(worklen);
+    if (!stream->work_buffer) {
+        return SDL_OutOfMemory();
+    }
+    stream->chunk_buffer = stream->work_buffer + historylen;
+    stream->output_buffer = stream->chunk_buffer + (((frames * inframelen) + 15) & ~15);
+    return 0;
 }
 
 SDL_AudioStream *
@@ -1273,7 +1947,6 @@ SDL_NewAudioStream(const SDL_AudioFormat src_format,
                    const Uint8 dst_channels,
                    const int dst_rate)
 {
-    const int packetlen = 4096;  /* !!! FIXME: good enough for now. */
     Uint8 pre_resample_channels;
     SDL_AudioStream *retval;
 
@@ -1288,7 +1961,6 @@ SDL_NewAudioStream(const SDL_AudioFormat src_format,
        the resampled data (!!! FIXME: decide if that works in practice, though!). */
     pre_resample_channels = SDL_min(src_channels, dst_channels);
 
-    retval->first_run = SDL_TRUE;
     retval->src_sample_frame_size = (SDL_AUDIO_BITSIZE(src_format) / 8) * src_channels;
     retval->src_format = src_format;
     retval->src_channels = src_channels;
@@ -1298,26 +1970,8 @@ SDL_NewAudioStream(const SDL_AudioFormat src_format,
     retval->dst_channels = dst_channels;
     retval->dst_rate = dst_rate;
     retval->pre_resample_channels = pre_resample_channels;
-    retval->packetlen = packetlen;
+    retval->resample_quality = SDL_RESAMPLE_SINC_LOW;
     retval->rate_incr = ((double) dst_rate) / ((double) src_rate);
-    retval->resampler_padding_samples = ResamplerPadding(retval->src_rate, retval->dst_rate) * pre_resample_channels;
-    retval->resampler_padding = (float *) SDL_calloc(retval->resampler_padding_samples ? retval->resampler_padding_samples : 1, sizeof (float));
-
-    if (retval->resampler_padding == NULL) {
-        SDL_FreeAudioStream(retval);
-        SDL_OutOfMemory();
-        return NULL;
-    }
-
-    retval->staging_buffer_size = ((retval->resampler_padding_samples / retval->pre_resample_channels) * retval->src_sample_frame_size);
-    if (retval->staging_buffer_size > 0) {
-        retval->staging_buffer = (Uint8 *) SDL_malloc(retval->staging_buffer_size);
-        if (retval->staging_buffer == NULL) {
-            SDL_FreeAudioStream(retval);
-            SDL_OutOfMemory();
-            return NULL;
-        }
-    }
 
     /* Not resampling? It's an easy conversion (and maybe not even that!) */
     if (src_rate == dst_rate) {
@@ -1334,21 +1988,26 @@ SDL_NewAudioStream(const SDL_AudioFormat src_format,
             return NULL;  /* SDL_BuildAudioCVT should have called SDL_SetError. */
         }
 
+        /* Convert us to the final format after resampling. */
+        if (SDL_BuildAudioCVT(&retval->cvt_after_resampling, AUDIO_F32SYS, pre_resample_channels, dst_rate, dst_format, dst_channels, dst_rate) < 0) {
+            SDL_FreeAudioStream(retval);
+            return NULL;  /* SDL_BuildAudioCVT should have called SDL_SetError. */
+        }
+    }
+
+    /* Everything SDL_AudioStreamPut() needs is allocated here, up front. */
+    if (SDL_SetupAudioStreamChunks(retval) < 0) {
+        SDL_FreeAudioStream(retval);
+        return NULL;
+    }
+
+    if (src_rate != dst_rate) {
 #ifdef HAVE_LIBSAMPLERATE_H
         SetupLibSampleRateResampling(retval);
 #endif
 
         if (!retval->resampler_func) {
-            retval->resampler_state = SDL_calloc(retval->resampler_padding_samples, sizeof (float));
-            if (!retval->resampler_state) {
-                SDL_FreeAudioStream(retval);
-                SDL_OutOfMemory();
-                return NULL;
-            }
-
-            if (SDL_PrepareResampleFilter() < 0) {
-                SDL_free(retval->resampler_state);
-                retval->resampler_state = NULL;
+            if (SDL_BuildPolyphaseFilter(&retval->resample_filter, retval->resample_quality, pre_resample_channels, src_rate, dst_rate) < 0) {
                 SDL_FreeAudioStream(retval);
                 return NULL;
             }
@@ -1356,16 +2015,11 @@ SDL_NewAudioStream(const SDL_AudioFormat src_format,
             retval->resampler_func = SDL_ResampleAudioStream;
             retval->reset_resampler_func = SDL_ResetAudioStreamResampler;
             retval->cleanup_resampler_func = SDL_CleanupAudioStreamResampler;
-        }
-
-        /* Convert us to the final format after resampling. */
-        if (SDL_BuildAudioCVT(&retval->cvt_after_resampling, AUDIO_F32SYS, pre_resample_channels, dst_rate, dst_format, dst_channels, dst_rate) < 0) {
-            SDL_FreeAudioStream(retval);
-            return NULL;  /* SDL_BuildAudioCVT should have called SDL_SetError. */
+            SDL_ResetAudioStreamResampler(retval);
         }
     }
 
-    retval->queue = SDL_NewDataQueue(packetlen, packetlen * 2);
+    retval->queue = SDL_NewDataQueue(retval->packetlen, retval->packetlen * 2);
     if (!retval->queue) {
         SDL_FreeAudioStream(retval);
         return NULL;  /* SDL_NewDataQueue should have called SDL_SetError. */
@@ -1374,148 +2028,115 @@ SDL_NewAudioStream(const SDL_AudioFormat src_format,
     return retval;
 }
 
+/* Run one chunk through the whole pipeline: to float, resample, to the
+   output format, into the queue. The last stage writes into space reserved
+   in the queue wherever it can, instead of into a buffer that then gets
+   copied. A NULL (buf) resamples (frames) of silence, for flushing. */
 static int
-SDL_AudioStreamPutInternal(SDL_AudioStream *stream, const void *buf, int len, int *maxputbytes)
-{
-    int buflen = len;
-    int workbuflen;
-    Uint8 *workbuf;
-    Uint8 *resamplebuf = NULL;
-    int resamplebuflen = 0;
-    int neededpaddingbytes;
-    int paddingbytes;
-
-    /* !!! FIXME: several converters can take advantage of SIMD, but only
-       !!! FIXME:  if the data is aligned to 16 bytes. EnsureStreamBufferSize()
-       !!! FIXME:  guarantees the buffer will align, but the
-       !!! FIXME:  converters will iterate over the data backwards if
-       !!! FIXME:  the output grows, and this means we won't align if buflen
-       !!! FIXME:  isn't a multiple of 16. In these cases, we should chop off
-       !!! FIXME:  a few samples at the end and convert them separately. */
-
-    /* no padding prepended on first run. */
-    neededpaddingbytes = stream->resampler_padding_samples * sizeof (float);
-    paddingbytes = stream->first_run ? 0 : neededpaddingbytes;
-    stream->first_run = SDL_FALSE;
-
-    /* Make sure the work buffer can hold all the data we need at once... */
-    workbuflen = buflen;
-    if (stream->cvt_before_resampling.needed) {
-        workbuflen *= stream->cvt_before_resampling.len_mult;
-    }
-
-    if (stream->dst_rate != stream->src_rate) {
-        /* resamples can't happen in place, so make space for second buf. */
-        const int framesize = stream->pre_resample_channels * sizeof (float);
-        const int frames = workbuflen / framesize;
-        resamplebuflen = ((int) SDL_ceil(frames * stream->rate_incr)) * framesize;
-        #if DEBUG_AUDIOSTREAM
-        printf("AUDIOSTREAM: will resample %d bytes to %d (ratio=%.6f)\n", workbuflen, resamplebuflen, stream->rate_incr);
-        #endif
-        workbuflen += resamplebuflen;
-    }
-
-    if (stream->cvt_after_resampling.needed) {
-        /* !!! FIXME: buffer might be big enough already? */
-        workbuflen *= stream->cvt_after_resampling.len_mult;
-    }
-
-    workbuflen += neededpaddingbytes;
-
-    #if DEBUG_AUDIOSTREAM
-    printf("AUDIOSTREAM: Putting %d bytes of preconverted audio, need %d byte work buffer\n", buflen, workbuflen);
-    #endif
-
-    workbuf = EnsureStreamBufferSize(stream, workbuflen);
-    if (!workbuf) {
-        return -1;  /* probably out of memory. */
-    }
-
-    resamplebuf = workbuf;  /* default if not resampling. */
-
-    SDL_memcpy(workbuf + paddingbytes, buf, buflen);
-
-    if (stream->cvt_before_resampling.needed) {
-        stream->cvt_before_resampling.buf = workbuf + paddingbytes;
-        stream->cvt_before_resampling.len = buflen;
-        if (SDL_ConvertAudio(&stream->cvt_before_resampling) == -1) {
+SDL_AudioStreamPutChunk(SDL_AudioStream *stream, const Uint8 *buf, const int frames, int *maxputbytes)
+{
+    SDL_AudioCVT *cvt_after = &stream->cvt_after_resampling;
+    const int inlen = frames * stream->src_sample_frame_size;
+    Uint8 *outbuf = stream->output_buffer;
+    Uint8 *dst = NULL;
+    int outlen;
+
+    SDL_assert(frames <= stream->chunk_frames);
+
+    if (stream->src_rate == stream->dst_rate) {
+        /* no resampler: cvt_after_resampling does the whole conversion. */
+        SDL_assert(buf != NULL);
+        outlen = frames * stream->dst_sample_frame_size;
+        if (stream->convert_in_queue) {
+            dst = (Uint8 *) SDL_ReserveSpaceInDataQueue(stream->queue, outlen);
+            if (!dst) {
+                return -1;
+            }
+            SDL_memcpy(dst, buf, inlen);
+            cvt_after->buf = dst;
+        } else {
+            SDL_memcpy(stream->chunk_buffer, buf, inlen);
+            cvt_after->buf = outbuf = stream->chunk_buffer;
+        }
+        cvt_after->len = inlen;
+        if (SDL_ConvertAudio(cvt_after) == -1) {
             return -1;   /* uhoh! */
         }
-        buflen = stream->cvt_before_resampling.len_cvt;
-
-        #if DEBUG_AUDIOSTREAM
-        printf("AUDIOSTREAM: After initial conversion we have %d bytes\n", buflen);
-        #endif
-    }
-
-    if (stream->dst_rate != stream->src_rate) {
-        /* save off some samples at the end; they are used for padding now so
-           the resampler is coherent and then used at the start of the next
-           put operation. Prepend last put operation's padding, too. */
+        SDL_assert(cvt_after->len_cvt == outlen);
+    } else {
+        const int framelen = stream->pre_resample_channels * (int) sizeof (float);
+        int floatlen = frames * framelen;
 
-        /* prepend prior put's padding. :P */
-        if (paddingbytes) {
-            SDL_memcpy(workbuf, stream->resampler_padding, paddingbytes);
-            buflen += paddingbytes;
+        if (!buf) {
+            SDL_memset(stream->chunk_buffer, '\0', floatlen);
+        } else {
+            SDL_memcpy(stream->chunk_buffer, buf, inlen);
+            if (stream->cvt_before_resampling.needed) {
+                stream->cvt_before_resampling.buf = stream->chunk_buffer;
+                stream->cvt_before_resampling.len = inlen;
+                if (SDL_ConvertAudio(&stream->cvt_before_resampling) == -1) {
+                    return -1;   /* uhoh! */
+                }
+                SDL_assert(stream->cvt_before_resampling.len_cvt == floatlen);
+            }
+            stream->total_in_frames += frames;
         }
 
-        /* save off the data at the end for the next run. */
-        SDL_memcpy(stream->resampler_padding, workbuf + (buflen - neededpaddingbytes), neededpaddingbytes);
-
-        resamplebuf = workbuf + buflen;  /* skip to second piece of workbuf. */
-        SDL_assert(buflen >= neededpaddingbytes);
-        if (buflen > neededpaddingbytes) {
-            buflen = stream->resampler_func(stream, workbuf, buflen - neededpaddingbytes, resamplebuf, resamplebuflen);
+        if (!maxputbytes && (stream->resampler_func == SDL_ResampleAudioStream) &&
+            (!cvt_after->needed || stream->convert_in_queue)) {
+            /* we know how much is coming, so resample straight into the queue. */
+            const int outframes = SDL_CountResampledFrames(stream, frames);
+            if (outframes > 0) {
+                dst = (Uint8 *) SDL_ReserveSpaceInDataQueue(stream->queue, outframes * stream->dst_sample_frame_size);
+                if (!dst) {
+                    return -1;
+                }
+            }
+            floatlen = stream->resampler_func(stream, stream->chunk_buffer, floatlen, dst, outframes * framelen);
+            cvt_after->buf = dst;
         } else {
-            buflen = 0;
+            const int outbuflen = stream->output_buffer_len / (cvt_after->needed ? cvt_after->len_mult : 1);
+            floatlen = stream->resampler_func(stream, stream->chunk_buffer, floatlen, outbuf, outbuflen);
+            cvt_after->buf = outbuf;
         }
 
-        #if DEBUG_AUDIOSTREAM
-        printf("AUDIOSTREAM: After resampling we have %d bytes\n", buflen);
-        #endif
-    }
-
-    if (stream->cvt_after_resampling.needed && (buflen > 0)) {
-        stream->cvt_after_resampling.buf = resamplebuf;
-        stream->cvt_after_resampling.len = buflen;
-        if (SDL_ConvertAudio(&stream->cvt_after_resampling) == -1) {
-            return -1;   /* uhoh! */
+        if (cvt_after->needed && (floatlen > 0)) {
+            cvt_after->len = floatlen;
+            if (SDL_ConvertAudio(cvt_after) == -1) {
+                return -1;   /* uhoh! */
+            }
+            floatlen = cvt_after->len_cvt;
         }
-        buflen = stream->cvt_after_resampling.len_cvt;
-
-        #if DEBUG_AUDIOSTREAM
-        printf("AUDIOSTREAM: After final conversion we have %d bytes\n", buflen);
-        #endif
+        outlen = floatlen;
+        stream->total_out_frames += outlen / stream->dst_sample_frame_size;
     }
 
-    #if DEBUG_AUDIOSTREAM
-    printf("AUDIOSTREAM: Final output is %d bytes\n", buflen);
-    #endif
-
     if (maxputbytes) {
         const int maxbytes = *maxputbytes;
-        if (buflen > maxbytes)
-            buflen = maxbytes;
-        *maxputbytes -= buflen;
+        if (outlen > maxbytes)
+            outlen = maxbytes;
+        *maxputbytes -= outlen;
+    }
+
+    if (dst || (outlen == 0)) {
+        return 0;  /* already in the queue. */
     }
 
-    /* resamplebuf holds the final output, even if we didn't resample. */
-    return buflen ? SDL_WriteToDataQueue(stream->queue, resamplebuf, buflen) : 0;
+    dst = (Uint8 *) SDL_ReserveSpaceInDataQueue(stream->queue, outlen);
+    if (!dst) {
+        return -1;
+    }
+    SDL_memcpy(dst, outbuf, outlen);
+    return 0;
 }
 
 int
 SDL_AudioStreamPut(SDL_AudioStream *stream, const void *buf, int len)
 {
-    /* !!! FIXME: several converters can take advantage of SIMD, but only
-       !!! FIXME:  if the data is aligned to 16 bytes. EnsureStreamBufferSize()
-       !!! FIXME:  guarantees the buffer will align, but the
-       !!! FIXME:  converters will iterate over the data backwards if
-       !!! FIXME:  the output grows, and this means we won't align if buflen
-       !!! FIXME:  isn't a multiple of 16. In these cases, we should chop off
-       !!! FIXME:  a few samples at the end and convert them separately. */
+    const Uint8 *ptr = (const Uint8 *) buf;
 
     #if DEBUG_AUDIOSTREAM
-    printf("AUDIOSTREAM: wants to put %d preconverted bytes\n", buflen);
+    printf("AUDIOSTREAM: wants to put %d preconverted bytes\n", len);
     #endif
 
     if (!stream) {
@@ -1538,32 +2159,12 @@ SDL_AudioStreamPut(SDL_AudioStream *stream, const void *buf, int len)
     }
 
     while (len > 0) {
-        int amount;
-
-        /* If we don't have a staging buffer or we're given enough data that
-           we don't need to store it for later, skip the staging process.
-         */
-        if (!stream->staging_buffer_filled && len >= stream->staging_buffer_size) {
-            return SDL_AudioStreamPutInternal(stream, buf, len, NULL);
-        }
-
-        /* If there's not enough data to fill the staging buffer, just save it */
-        if ((stream->staging_buffer_filled + len) < stream->staging_buffer_size) {
-            SDL_memcpy(stream->staging_buffer + stream->staging_buffer_filled, buf, len);
-            stream->staging_buffer_filled += len;
-            return 0;
-        }
- 
-        /* Fill the staging buffer, process it, and continue */
-        amount = (stream->staging_buffer_size - stream->staging_buffer_filled);
-        SDL_assert(amount > 0);
-        SDL_memcpy(stream->staging_buffer + stream->staging_buffer_filled, buf, amount);
-        stream->staging_buffer_filled = 0;
-        if (SDL_AudioStreamPutInternal(stream, stream->staging_buffer, stream->staging_buffer_size, NULL) < 0) {
+        const int frames = SDL_min(len / stream->src_sample_frame_size, stream->chunk_frames);
+        if (SDL_AudioStreamPutChunk(stream, ptr, frames, NULL) < 0) {
             return -1;
         }
-        buf = (void *)((Uint8 *)buf + amount);
-        len -= amount;
+        ptr += frames * stream->src_sample_frame_size;
+        len -= frames * stream->src_sample_frame_size;
     }
     return 0;
 }
@@ -1575,47 +2176,28 @@ int SDL_AudioStreamFlush(SDL_AudioStream *stream)
     }
 
     #if DEBUG_AUDIOSTREAM
-    printf("AUDIOSTREAM: flushing! staging_buffer_filled=%d bytes\n", stream->staging_buffer_filled);
+    printf("AUDIOSTREAM: flushing! %d frames in, %d frames out\n", (int) stream->total_in_frames, (int) stream->total_out_frames);
     #endif
 
-    /* shouldn't use a staging buffer if we're not resampling. */
-    SDL_assert((stream->dst_rate != stream->src_rate) || (stream->staging_buffer_filled == 0));
-
-    if (stream->staging_buffer_filled > 0) {
-        /* push the staging buffer + silence. We need to flush out not just
-           the staging buffer, but the piece that the stream was saving off
-           for right-side resampler padding. */
-        const SDL_bool first_run = stream->first_run;
-        const int filled = stream->staging_buffer_filled;
-        int actual_input_frames = filled / stream->src_sample_frame_size;
-        if (!first_run)
-            actual_input_frames += stream->resampler_padding_samples / stream->pre_resample_channels;
-
-        if (actual_input_frames > 0) {  /* don't bother if nothing to flush. */
-            /* This is how many bytes we're expecting without silence appended. */
-            int flush_remaining = ((int) SDL_ceil(actual_input_frames * stream->rate_incr)) * stream->dst_sample_frame_size;
-
-            #if DEBUG_AUDIOSTREAM
-            printf("AUDIOSTREAM: flushing with padding to get max %d bytes!\n", flush_remaining);
-            #endif
-
-            SDL_memset(stream->staging_buffer + filled, '\0', stream->staging_buffer_size - filled);
-            if (SDL_AudioStreamPutInternal(stream, stream->staging_buffer, stream->staging_buffer_size, &flush_remaining) < 0) {
+    if (stream->src_rate != stream->dst_rate) {
+        /* the resampler is holding back the frames it needs to look ahead
+           at; push silence through until everything we were given is out. */
+        const Sint64 wanted = ((stream->total_in_frames * stream->dst_rate) + stream->src_rate - 1) / stream->src_rate;
+        while (stream->total_out_frames < wanted) {
+            int flush_remaining = (int) SDL_min(wanted - stream->total_out_frames, SDL_MAX_SINT32 / stream->dst_sample_frame_size) * stream->dst_sample_frame_size;
+            if (SDL_AudioStreamPutChunk(stream, NULL, stream->chunk_frames, &flush_remaining) < 0) {
                 return -1;
             }
+        }
 
-            /* we have flushed out (or initially filled) the pending right-side
-               resampler padding, but we need to push more silence to guarantee
-               the staging buffer is fully flushed out, too. */
-            SDL_memset(stream->staging_buffer, '\0', filled);
-            if (SDL_AudioStreamPutInternal(stream, stream->staging_buffer, stream->staging_buffer_size, &flush_remaining) < 0) {
-                return -1;
-            }
+        /* anything put after this starts over, with a gap. */
+        if (stream->reset_resampler_func) {
+            stream->reset_resampler_func(stream);
         }
     }
 
-    stream->staging_buffer_filled = 0;
-    stream->first_run = SDL_TRUE;
+    stream->total_in_frames = 0;
+    stream->total_out_frames = 0;
 
     return 0;
 }
@@ -1658,11 +2240,51 @@ SDL_AudioStreamClear(SDL_AudioStream *stream)
         if (stream->reset_resampler_func) {
             stream->reset_resampler_func(stream);
         }
-        stream->first_run = SDL_TRUE;
-        stream->staging_buffer_filled = 0;
+        stream->total_in_frames = 0;
+        stream->total_out_frames = 0;
     }
 }
 
+int
+SDL_AudioStreamSetResampleQuality(SDL_AudioStream *stream, SDL_AudioResampleQuality quality)
+{
+    SDL_PolyphaseFilter filter;
+
+    if (!stream) {
+        return SDL_InvalidParamError("stream");
+    } else if (quality < SDL_RESAMPLE_NEAREST || quality > SDL_RESAMPLE_SINC_HIGH) {
+        return SDL_InvalidParamError("quality");
+    }
+
+    stream->resample_quality = quality;
+    if (stream->src_rate == stream->dst_rate) {
+        return 0;  /* nothing to resample. */
+    }
+
+    if (SDL_BuildPolyphaseFilter(&filter, quality, stream->pre_resample_channels, stream->src_rate, stream->dst_rate) < 0) {
+        return -1;
+    }
+
+    if (stream->resampler_func != SDL_ResampleAudioStream) {
+        /* switch away from libsamplerate, starting from silence. */
+        if (stream->cleanup_resampler_func) {
+            stream->cleanup_resampler_func(stream);
+        }
+        stream->resampler_func = SDL_ResampleAudioStream;
+        stream->reset_resampler_func = SDL_ResetAudioStreamResampler;
+        stream->cleanup_resampler_func = SDL_CleanupAudioStreamResampler;
+        stream->resample_filter = filter;
+        SDL_ResetAudioStreamResampler(stream);
+    } else {
+        /* carry on from the same input frame and phase with the new filter. */
+        SDL_FreePolyphaseFilter(&stream->resample_filter);
+        stream->resample_filter = filter;
+        SDL_PadAudioStreamResampler(stream);
+    }
+
+    return 0;
+}
+
 /* dispose of a stream */
 void
 SDL_FreeAudioStream(SDL_AudioStream *stream)
@@ -1672,9 +2294,7 @@ SDL_FreeAudioStream(SDL_AudioStream *stream)
             stream->cleanup_resampler_func(stream);
         }
         SDL_FreeDataQueue(stream->queue);
-        SDL_free(stream->staging_buffer);
-        SDL_free(stream->work_buffer_base);
-        SDL_free(stream->resampler_padding);
+        SDL_SIMDFree(stream->work_buffer);
         SDL_free(stream);
     }
 }
@@ -85,10 +85,341 @@ static const Uint8 mix8[] = {
 #define ADJUST_VOLUME(s, v) (s = (s*v)/SDL_MIX_MAXVOLUME)
 #define ADJUST_VOLUME_U8(s, v)  (s = (((s-128)*v)/SDL_MIX_MAXVOLUME)+128)
 
+#ifdef __SSE2__
+#define HAVE_SSE2_INTRINSICS 1
+#endif
 
-void
-SDL_MixAudioFormat(Uint8 * dst, const Uint8 * src, SDL_AudioFormat format,
-                   Uint32 len, int volume)
+#ifdef __ARM_NEON
+#define HAVE_NEON_INTRINSICS 1
+#endif
+
+/* SIMD mixers for S16, S32 and F32 in either byte order. Each one mixes
+   (len) bytes, a multiple of SDL_MIXER_SIMD_BLOCK, from (src) at any
+   alignment into (dst), aligned to SDL_MIXER_SIMD_BLOCK; (swap) is set for
+   the byte order that isn't native. They only run for volumes up to
+   SDL_MIX_MAXVOLUME, where the scaled sample still fits its type, and give
+   the same results as the scalar code, except that F32 sums in single
+   precision instead of double. */
+#define SDL_MIXER_SIMD_BLOCK 32
+
+/* Scaling divides by shifting, rounding toward zero like C division. */
+SDL_COMPILE_TIME_ASSERT(mix_maxvolume, SDL_MIX_MAXVOLUME == 128);
+
+typedef void (*SDL_MixFunc)(Uint8 *dst, const Uint8 *src, Uint32 len, int volume, const SDL_bool swap);
+
+#if HAVE_SSE2_INTRINSICS
+static __m128i
+SDL_Swap16_SSE2(const __m128i x)
+{
+    return _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+}
+
+static __m128i
+SDL_Swap32_SSE2(const __m128i x)
+{
+    const __m128i y = SDL_Swap16_SSE2(x);
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(y, 0xB1), 0xB1);
+}
+
+static __m128i
+SDL_DivMaxVolume_SSE2(const __m128i x)
+{
+    return _mm_srai_epi32(_mm_add_epi32(x, _mm_srli_epi32(_mm_srai_epi32(x, 31), 25)), 7);
+}
+
+static __m128i
+SDL_AddSaturate32_SSE2(const __m128i a, const __m128i b)
+{
+    const __m128i sum = _mm_add_epi32(a, b);
+    /* it overflowed if a and b have the same sign, and the sum doesn't. */
+    const __m128i overflow = _mm_srai_epi32(_mm_andnot_si128(_mm_xor_si128(a, b), _mm_xor_si128(a, sum)), 31);
+    const __m128i clamped = _mm_xor_si128(_mm_srai_epi32(a, 31), _mm_set1_epi32(0x7FFFFFFF));
+    return _mm_or_si128(_mm_and_si128(overflow, clamped), _mm_andnot_si128(overflow, sum));
+}
+
+static void
+SDL_MixS16_SSE2(Uint8 *dst, const Uint8 *src, Uint32 len, int volume, const SDL_bool swap)
+{
+    const __m128i vol = _mm_set1_epi16((short) volume);
+
+    for (; len; len -= 16, src += 16, dst += 16) {
+        __m128i s = _mm_loadu_si128((const __m128i *) src);
+        __m128i d = _mm_load_si128((const __m128i *) dst);
+        __m128i lo, hi;
+        if (swap) {
+            s = SDL_Swap16_SSE2(s);
+            d = SDL_Swap16_SSE2(d);
+        }
+        lo = _mm_mullo_epi16(s, vol);
+        hi = _mm_mulhi_epi16(s, vol);
+        s = _mm_packs_epi32(SDL_DivMaxVolume_SSE2(_mm_unpacklo_epi16(lo, hi)),
+                            SDL_DivMaxVolume_SSE2(_mm_unpackhi_epi16(lo, hi)));
+        d = _mm_adds_epi16(s, d);
+        _mm_store_si128((__m128i *) dst, swap ? SDL_Swap16_SSE2(d) : d);
+    }
+}
+
+static void
+SDL_MixS32_SSE2(Uint8 *dst, const Uint8 *src, Uint32 len, int volume, const SDL_bool swap)
+{
+    /* sample * volume can need more than 32 bits, but a double holds it exactly. */
+    const __m128d vol = _mm_set1_pd(((double) volume) / SDL_MIX_MAXVOLUME);
+
+    for (; len; len -= 16, src += 16, dst += 16) {
+        __m128i s = _mm_loadu_si128((const __m128i *) src);
+        __m128i d = _mm_load_si128((const __m128i *) dst);
+        __m128i lo, hi;
+        if (swap) {
+            s = SDL_Swap32_SSE2(s);
+            d = SDL_Swap32_SSE2(d);
+        }
+        lo = _mm_cvttpd_epi32(_mm_mul_pd(_mm_cvtepi32_pd(s), vol));
+        hi = _mm_cvttpd_epi32(_mm_mul_pd(_mm_cvtepi32_pd(_mm_unpackhi_epi64(s, s)), vol));
+        d = SDL_AddSaturate32_SSE2(_mm_unpacklo_epi64(lo, hi), d);
+        _mm_store_si128((__m128i *) dst, swap ? SDL_Swap32_SSE2(d) : d);
+    }
+}
+
+static void
+SDL_MixF32_SSE2(Uint8 *dst, const Uint8 *src, Uint32 len, int volume, const SDL_bool swap)
+{
+    const __m128 vol = _mm_set1_ps((float) volume);
+    const __m128 maxvol = _mm_set1_ps(1.0f / ((float) SDL_MIX_MAXVOLUME));
+    const __m128 max_audioval = _mm_set1_ps(3.402823466e+38F);
+    const __m128 min_audioval = _mm_set1_ps(-3.402823466e+38F);
+
+    for (; len; len -= 16, src += 16, dst += 16) {
+        __m128i s = _mm_loadu_si128((const __m128i *) src);
+        __m128i d = _mm_load_si128((const __m128i *) dst);
+        __m128 sum;
+        if (swap) {
+            s = SDL_Swap32_SSE2(s);
+            d = SDL_Swap32_SSE2(d);
+        }
+        sum = _mm_mul_ps(_mm_mul_ps(_mm_castsi128_ps(s), vol), maxvol);
+        sum = _mm_add_ps(sum, _mm_castsi128_ps(d));
+        /* clamp overflow back to the largest float; NaN passes through, like the scalar code. */
+        sum = _mm_max_ps(min_audioval, _mm_min_ps(max_audioval, sum));
+        d = _mm_castps_si128(sum);
+        _mm_store_si128((__m128i *) dst, swap ? SDL_Swap32_SSE2(d) : d);
+    }
+}
+#endif /* HAVE_SSE2_INTRINSICS */
+
+#if HAVE_AVX2_INTRINSICS
+SDL_TARGETING("avx2") static __m256i
+SDL_DivMaxVolume_AVX2(const __m256i x)
+{
+    return _mm256_srai_epi32(_mm256_add_epi32(x, _mm256_srli_epi32(_mm256_srai_epi32(x, 31), 25)), 7);
+}
+
+SDL_TARGETING("avx2") static __m256i
+SDL_AddSaturate32_AVX2(const __m256i a, const __m256i b)
+{
+    const __m256i sum = _mm256_add_epi32(a, b);
+    const __m256i overflow = _mm256_srai_epi32(_mm256_andnot_si256(_mm256_xor_si256(a, b), _mm256_xor_si256(a, sum)), 31);
+    const __m256i clamped = _mm256_xor_si256(_mm256_srai_epi32(a, 31), _mm256_set1_epi32(0x7FFFFFFF));
+    return _mm256_blendv_epi8(sum, clamped, overflow);
+}
+
+SDL_TARGETING("avx2") static void
+SDL_MixS16_AVX2(Uint8 *dst, const Uint8 *src, Uint32 len, int volume, const SDL_bool swap)
+{
+    const __m256i vol = _mm256_set1_epi16((short) volume);
+    const __m256i swapmask = _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                                              1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+
+    for (; len; len -= 32, src += 32, dst += 32) {
+        __m256i s = _mm256_loadu_si256((const __m256i *) src);
+        __m256i d = _mm256_load_si256((const __m256i *) dst);
+        __m256i lo, hi;
+        if (swap) {
+            s = _mm256_shuffle_epi8(s, swapmask);
+            d = _mm256_shuffle_epi8(d, swapmask);
+        }
+        lo = _mm256_mullo_epi16(s, vol);
+        hi = _mm256_mulhi_epi16(s, vol);
+        /* unpack and pack both work within 128-bit lanes, so samples end up back in order. */
+        s = _mm256_packs_epi32(SDL_DivMaxVolume_AVX2(_mm256_unpacklo_epi16(lo, hi)),
+                               SDL_DivMaxVolume_AVX2(_mm256_unpackhi_epi16(lo, hi)));
+        d = _mm256_adds_epi16(s, d);
+        _mm256_store_si256((__m256i *) dst, swap ? _mm256_shuffle_epi8(d, swapmask) : d);
+    }
+}
+
+SDL_TARGETING("avx2") static void
+SDL_MixS32_AVX2(Uint8 *dst, const Uint8 *src, Uint32 len, int volume, const SDL_bool swap)
+{
+    const __m256d vol = _mm256_set1_pd(((double) volume) / SDL_MIX_MAXVOLUME);
+    const __m256i swapmask = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                              3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+
+    for (; len; len -= 32, src += 32, dst += 32) {
+        __m256i s = _mm256_loadu_si256((const __m256i *) src);
+        __m256i d = _mm256_load_si256((const __m256i *) dst);
+        __m128i lo, hi;
+        if (swap) {
+            s = _mm256_shuffle_epi8(s, swapmask);
+            d = _mm256_shuffle_epi8(d, swapmask);
+        }
+        lo = _mm256_cvttpd_epi32(_mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(s)), vol));
+        hi = _mm256_cvttpd_epi32(_mm256_mul_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(s, 1)), vol));
+        s = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        d = SDL_AddSaturate32_AVX2(s, d);
+        _mm256_store_si256((__m256i *) dst, swap ? _mm256_shuffle_epi8(d, swapmask) : d);
+    }
+}
+
+SDL_TARGETING("avx2") static void
+SDL_MixF32_AVX2(Uint8 *dst, const Uint8 *src, Uint32 len, int volume, const SDL_bool swap)
+{
+    const __m256 vol = _mm256_set1_ps((float) volume);
+    const __m256 maxvol = _mm256_set1_ps(1.0f / ((float) SDL_MIX_MAXVOLUME));
+    const __m256 max_audioval = _mm256_set1_ps(3.402823466e+38F);
+    const __m256 min_audioval = _mm256_set1_ps(-3.402823466e+38F);
+    const __m256i swapmask = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                              3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+
+    for (; len; len -= 32, src += 32, dst += 32) {
+        __m256i s = _mm256_loadu_si256((const __m256i *) src);
+        __m256i d = _mm256_load_si256((const __m256i *) dst);
+        __m256 sum;
+        if (swap) {
+            s = _mm256_shuffle_epi8(s, swapmask);
+            d = _mm256_shuffle_epi8(d, swapmask);
+        }
+        sum = _mm256_mul_ps(_mm256_mul_ps(_mm256_castsi256_ps(s), vol), maxvol);
+        sum = _mm256_add_ps(sum, _mm256_castsi256_ps(d));
+        sum = _mm256_max_ps(min_audioval, _mm256_min_ps(max_audioval, sum));
+        d = _mm256_castps_si256(sum);
+        _mm256_store_si256((__m256i *) dst, swap ? _mm256_shuffle_epi8(d, swapmask) : d);
+    }
+}
+#endif /* HAVE_AVX2_INTRINSICS */
+
+#if HAVE_NEON_INTRINSICS
+static int32x4_t
+SDL_DivMaxVolume32_NEON(const int32x4_t x)
+{
+    const uint32x4_t bias = vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(x, 31)), 25);
+    return vshrq_n_s32(vaddq_s32(x, vreinterpretq_s32_u32(bias)), 7);
+}
+
+static int64x2_t
+SDL_DivMaxVolume64_NEON(const int64x2_t x)
+{
+    const uint64x2_t bias = vshrq_n_u64(vreinterpretq_u64_s64(vshrq_n_s64(x, 63)), 57);
+    return vshrq_n_s64(vaddq_s64(x, vreinterpretq_s64_u64(bias)), 7);
+}
+
+static void
+SDL_MixS16_NEON(Uint8 *dst, const Uint8 *src, Uint32 len, int volume, const SDL_bool swap)
+{
+    const int16x4_t vol = vdup_n_s16((int16_t) volume);
+
+    for (; len; len -= 16, src += 16, dst += 16) {
+        uint8x16_t s = vld1q_u8(src);
+        uint8x16_t d = vld1q_u8(dst);
+        int16x8_t s16, sum;
+        if (swap) {
+            s = vrev16q_u8(s);
+            d = vrev16q_u8(d);
+        }
+        s16 = vreinterpretq_s16_u8(s);
+        s16 = vcombine_s16(vqmovn_s32(SDL_DivMaxVolume32_NEON(vmull_s16(vget_low_s16(s16), vol))),
+                           vqmovn_s32(SDL_DivMaxVolume32_NEON(vmull_s16(vget_high_s16(s16), vol))));
+        sum = vqaddq_s16(s16, vreinterpretq_s16_u8(d));
+        d = vreinterpretq_u8_s16(sum);
+        vst1q_u8(dst, swap ? vrev16q_u8(d) : d);
+    }
+}
+
+static void
+SDL_MixS32_NEON(Uint8 *dst, const Uint8 *src, Uint32 len, int volume, const SDL_bool swap)
+{
+    const int32x2_t vol = vdup_n_s32((int32_t) volume);
+
+    for (; len; len -= 16, src += 16, dst += 16) {
+        uint8x16_t s = vld1q_u8(src);
+        uint8x16_t d = vld1q_u8(dst);
+        int32x4_t s32, sum;
+        if (swap) {
+            s = vrev32q_u8(s);
+            d = vrev32q_u8(d);
+        }
+        s32 = vreinterpretq_s32_u8(s);
+        s32 = vcombine_s32(vmovn_s64(SDL_DivMaxVolume64_NEON(vmull_s32(vget_low_s32(s32), vol))),
+                           vmovn_s64(SDL_DivMaxVolume64_NEON(vmull_s32(vget_high_s32(s32), vol))));
+        sum = vqaddq_s32(s32, vreinterpretq_s32_u8(d));
+        d = vreinterpretq_u8_s32(sum);
+        vst1q_u8(dst, swap ? vrev32q_u8(d) : d);
+    }
+}
+
+static void
+SDL_MixF32_NEON(Uint8 *dst, const Uint8 *src, Uint32 len, int volume, const SDL_bool swap)
+{
+    const float fvolume = (float) volume;
+    const float fmaxvolume = 1.0f / ((float) SDL_MIX_MAXVOLUME);
+    const float32x4_t max_audioval = vdupq_n_f32(3.402823466e+38F);
+    const float32x4_t min_audioval = vdupq_n_f32(-3.402823466e+38F);
+
+    for (; len; len -= 16, src += 16, dst += 16) {
+        uint8x16_t s = vld1q_u8(src);
+        uint8x16_t d = vld1q_u8(dst);
+        float32x4_t sum;
+        if (swap) {
+            s = vrev32q_u8(s);
+            d = vrev32q_u8(d);
+        }
+        sum = vmulq_n_f32(vmulq_n_f32(vreinterpretq_f32_u8(s), fvolume), fmaxvolume);
+        sum = vaddq_f32(sum, vreinterpretq_f32_u8(d));
+        sum = vmaxq_f32(min_audioval, vminq_f32(max_audioval, sum));
+        d = vreinterpretq_u8_f32(sum);
+        vst1q_u8(dst, swap ? vrev32q_u8(d) : d);
+    }
+}
+#endif /* HAVE_NEON_INTRINSICS */
+
+static SDL_MixFunc
+SDL_ChooseMixer(const SDL_AudioFormat format, const int volume)
+{
+    if ((volume <= 0) || (volume > SDL_MIX_MAXVOLUME)) {
+        return NULL;
+    }
+
+#define CHOOSE_MIXER(fntype) \
+    switch (format) { \
+        case AUDIO_S16LSB: case AUDIO_S16MSB: return SDL_MixS16_##fntype; \
+        case AUDIO_S32LSB: case AUDIO_S32MSB: return SDL_MixS32_##fntype; \
+        case AUDIO_F32LSB: case AUDIO_F32MSB: return SDL_MixF32_##fntype; \
+        default: return NULL; \
+    }
+
+#if HAVE_AVX2_INTRINSICS
+    if (SDL_HasAVX2()) {
+        CHOOSE_MIXER(AVX2);
+    }
+#endif
+#if HAVE_SSE2_INTRINSICS
+    if (SDL_HasSSE2()) {
+        CHOOSE_MIXER(SSE2);
+    }
+#endif
+#if HAVE_NEON_INTRINSICS
+    if (SDL_HasNEON()) {
+        CHOOSE_MIXER(NEON);
+    }
+#endif
+
+#undef CHOOSE_MIXER
+
+    return NULL;
+}
+
+static void
+SDL_MixAudioFormat_Scalar(Uint8 * dst, const Uint8 * src, SDL_AudioFormat format,
+                          Uint32 len, int volume)
 {
     if (volume == 0) {
         return;
@@ -366,4 +697,30 @@ SDL_MixAudioFormat(Uint8 * dst, const Uint8 * src, SDL_AudioFormat format,
     }
 }
 
+void
+SDL_MixAudioFormat(Uint8 * dst, const Uint8 * src, SDL_AudioFormat format,
+                   Uint32 len, int volume)
+{
+    const SDL_MixFunc mix = SDL_ChooseMixer(format, volume);
+
+    if (mix) {
+        const Uint32 samplesize = SDL_AUDIO_BITSIZE(format) / 8;
+        const Uint32 head = (Uint32) ((SDL_MIXER_SIMD_BLOCK - ((size_t) dst & (SDL_MIXER_SIMD_BLOCK - 1))) & (SDL_MIXER_SIMD_BLOCK - 1));
+
+        /* the SIMD code needs (dst) aligned, so it's only an option if an
+           aligned address is on a sample boundary. The unaligned head and
+           the tail that doesn't fill a whole block are mixed here. */
+        if (((head % samplesize) == 0) && (len >= head + SDL_MIXER_SIMD_BLOCK)) {
+            const Uint32 body = (len - head) & ~(SDL_MIXER_SIMD_BLOCK - 1);
+            const SDL_bool swap = (SDL_AUDIO_ISBIGENDIAN(format) != 0) != (SDL_BYTEORDER == SDL_BIG_ENDIAN);
+            SDL_MixAudioFormat_Scalar(dst, src, format, head, volume);
+            mix(dst + head, src + head, body, volume, swap);
+            SDL_MixAudioFormat_Scalar(dst + head + body, src + head + body, format, len - head - body, volume);
+            return;
+        }
+    }
+
+    SDL_MixAudioFormat_Scalar(dst, src, format, len, volume);
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
@@ -25,7 +25,6 @@
 
 #include "SDL_mutex.h"
 #include "SDL_thread.h"
-#include "../SDL_dataqueue.h"
 #include "./SDL_audio_c.h"
 
 /* !!! FIXME: These are wordy and unlocalized... */
@@ -51,16 +50,15 @@ extern void SDL_RemoveAudioDevice(const int iscapture, void *handle);
    as appropriate so SDL's list of devices is accurate. */
 extern void SDL_OpenedAudioDeviceDisconnected(SDL_AudioDevice *device);
 
-/* This is the size of a packet when using SDL_QueueAudio(). We allocate
-   these as necessary and pool them, under the assumption that we'll
-   eventually end up with a handful that keep recycling, meeting whatever
-   the app needs. We keep packing data tightly as more arrives to avoid
-   wasting space, and if we get a giant block of data, we'll split them
-   into multiple packets behind the scenes. My expectation is that most
-   apps will have 2-3 of these in the pool. 8k should cover most needs, but
-   if this is crippling for some embedded system, we can #ifdef this.
-   The system preallocates enough packets for 2 callbacks' worth of data. */
-#define SDL_AUDIOBUFFERQUEUE_PACKETLEN (8 * 1024)
+/* This is how much audio, in milliseconds, SDL_QueueAudio() can hold before
+   it has to allocate a bigger ring (or, for capture devices, before the audio
+   thread starts dropping data the app hasn't dequeued). The ring is never
+   smaller than two callbacks' worth of data.
+   SDL_HINT_AUDIO_QUEUE_SIZE overrides this. */
+#define SDL_AUDIOBUFFERQUEUE_DEFAULT_MS 500
+
+/* Lock-free ring behind SDL_QueueAudio()/SDL_DequeueAudio(); see SDL_audio.c. */
+typedef struct SDL_AudioRing SDL_AudioRing;
 
 typedef struct SDL_AudioDriverImpl
 {
@@ -162,8 +160,39 @@ struct SDL_AudioDevice
     SDL_Thread *thread;
     SDL_threadID threadid;
 
-    /* Queued buffers (if app not using callback). */
-    SDL_DataQueue *buffer_queue;
+    /* Pacing and timing, written by the device's thread only. */
+    SDL_bool deadline_scheduling;
+    Uint64 pace_period;  /* one device buffer, in performance counter ticks. */
+    Uint64 pace_deadline;  /* when the next device buffer is due, or 0. */
+    Uint64 timing_period;  /* one callback buffer, in performance counter ticks. */
+    Uint64 timing_last;  /* when the last callback started, or 0. */
+    Uint64 timing_due;  /* when the last callback should have started. */
+    SDL_atomic_t timing_callbacks;
+    SDL_atomic_t timing_late;
+    SDL_atomic_t timing_max_jitter;
+    SDL_atomic_t timing_max_lateness;
+    SDL_atomic_t timing_max_callback;
+    SDL_atomic_t timing_histogram[SDL_AUDIO_JITTER_BUCKETS];
+
+    /* Queued buffers (if app not using callback). Only the app's side of
+       the queue takes queue_lock; the audio thread never locks or allocates. */
+    SDL_AudioRing *buffer_ring;
+    SDL_mutex *queue_lock;
+    SDL_atomic_t queue_underruns;
+    SDL_atomic_t queue_overruns;
+    SDL_bool queue_starved;  /* audio thread only: last callback ran dry. */
+
+    /* Voices mixed on top of the queue. Any thread pushes onto voices_added,
+       the audio thread takes them from there into voices, and pushes voices
+       it's done with onto voices_retired for the app's side to free.
+       all_voices is every voice made for this device; queue_lock guards it. */
+    void *voices_added;
+    SDL_AudioVoice *voices;
+    void *voices_retired;
+    SDL_AudioVoice *all_voices;
+    float *voice_bus;  /* one callback's worth of floats, len_mult'd for voice_cvt. */
+    float *voice_scratch;  /* one callback's worth of floats. */
+    SDL_AudioCVT voice_cvt;  /* voice_bus to the callback's format. */
 
     /* * * */
     /* Data private to this driver */
@@ -491,30 +491,44 @@ MS_ADPCM_Init(WaveFile *file, size_t datalength)
     return 0;
 }
 
-static Sint16
-MS_ADPCM_ProcessNibble(MS_ADPCM_ChannelState *cstate, Sint32 sample1, Sint32 sample2, Uint8 nybble)
+/* The factors MS ADPCM scales its delta with after each nibble, in 8.8 fixed point. */
+static const Uint16 MS_ADPCM_Adaptive[16] = {
+    230, 230, 230, 230, 307, 409, 512, 614,
+    768, 614, 512, 409, 307, 230, 230, 230
+};
+
+/* The state of one channel while decoding a block. It's kept in locals, so
+ * the compiler can keep it in registers.
+ */
+typedef struct MS_ADPCM_Predictor
+{
+    Sint32 sample1;
+    Sint32 sample2;
+    Sint32 coeff1;
+    Sint32 coeff2;
+    Uint32 delta;
+} MS_ADPCM_Predictor;
+
+static SDL_INLINE Sint16
+MS_ADPCM_ProcessNibble(MS_ADPCM_Predictor *p, Uint32 nybble)
 {
     const Sint32 max_audioval = 32767;
     const Sint32 min_audioval = -32768;
-    const Uint16 max_deltaval = 65535;
-    const Uint16 adaptive[] = {
-        230, 230, 230, 230, 307, 409, 512, 614,
-        768, 614, 512, 409, 307, 230, 230, 230
-    };
+    const Uint32 max_deltaval = 65535;
+    /* The nibble is a signed 4-bit error delta. */
+    const Sint32 errordelta = (Sint32)nybble - (Sint32)((nybble & 0x08) << 1);
     Sint32 new_sample;
-    Sint32 errordelta;
-    Uint32 delta = cstate->delta;
+    Uint32 delta;
 
-    new_sample = (sample1 * cstate->coeff1 + sample2 * cstate->coeff2) / 256;
-    /* The nibble is a signed 4-bit error delta. */
-    errordelta = (Sint32)nybble - (nybble >= 0x08 ? 0x10 : 0);
-    new_sample += (Sint32)delta * errordelta;
+    new_sample = (p->sample1 * p->coeff1 + p->sample2 * p->coeff2) / 256;
+    new_sample += (Sint32)p->delta * errordelta;
     if (new_sample < min_audioval) {
         new_sample = min_audioval;
     } else if (new_sample > max_audioval) {
         new_sample = max_audioval;
     }
-    delta = (delta * adaptive[nybble]) / 256;
+
+    delta = (p->delta * MS_ADPCM_Adaptive[nybble]) / 256;
     if (delta < 16) {
         delta = 16;
     } else if (delta > max_deltaval) {
@@ -524,7 +538,9 @@ MS_ADPCM_ProcessNibble(MS_ADPCM_ChannelState *cstate, Sint32 sample1, Sint32 sam
         delta = max_deltaval;
     }
 
-    cstate->delta = (Uint16)delta;
+    p->delta = delta;
+    p->sample2 = p->sample1;
+    p->sample1 = new_sample;
     return (Sint16)new_sample;
 }
 
@@ -592,49 +608,71 @@ MS_ADPCM_DecodeBlockHeader(ADPCM_DecoderState *state)
 static int
 MS_ADPCM_DecodeBlockData(ADPCM_DecoderState *state)
 {
-    Uint16 nybble = 0;
-    Sint16 sample1, sample2;
+    int retval = 0;
     const Uint32 channels = state->channels;
-    Uint32 c;
     MS_ADPCM_ChannelState *cstate = (MS_ADPCM_ChannelState *)state->cstate;
-
-    size_t blockpos = state->block.pos;
-    size_t blocksize = state->block.size;
-
-    size_t outpos = state->output.pos;
+    const Uint8 *data = state->block.data + state->block.pos;
+    const size_t nybbles = (state->block.size - state->block.pos) * 2;
+    Sint16 *out = state->output.data + state->output.pos;
+    MS_ADPCM_Predictor left, right;
+    size_t i, count;
 
     Sint64 blockframesleft = state->samplesperblock - 2;
     if (blockframesleft > state->framesleft) {
         blockframesleft = state->framesleft;
     }
+    if (blockframesleft < 0) {
+        /* The header had more sample frames than were left. */
+        blockframesleft = 0;
+    }
 
-    while (blockframesleft > 0) {
-        for (c = 0; c < channels; c++) {
-            if (nybble & 0x4000) {
-                nybble <<= 4;
-            } else if (blockpos < blocksize) {
-                nybble = state->block.data[blockpos++] | 0x4000;
-            } else {
-                /* Out of input data. Drop the incomplete frame and return. */
-                state->output.pos = outpos - c;
-                return -1;
-            }
+    if ((Uint64)blockframesleft * channels > nybbles) {
+        /* Out of input data. Decode the complete frames, drop the rest. */
+        blockframesleft = nybbles / channels;
+        retval = -1;
+    }
 
-            /* Load previous samples which may come from the block header. */
-            sample1 = state->output.data[outpos - channels];
-            sample2 = state->output.data[outpos - channels * 2];
+    /* Load previous samples which come from the block header. */
+    left.sample1 = out[-(Sint32)channels];
+    left.sample2 = out[-(Sint32)channels * 2];
+    left.coeff1 = cstate[0].coeff1;
+    left.coeff2 = cstate[0].coeff2;
+    left.delta = cstate[0].delta;
 
-            sample1 = MS_ADPCM_ProcessNibble(cstate + c, sample1, sample2, (nybble >> 4) & 0x0f);
-            state->output.data[outpos++] = sample1;
+    count = (size_t)blockframesleft * channels;
+    if (channels == 2) {
+        /* The high nibble is for the left channel, the low one for the right. */
+        right.sample1 = out[-1];
+        right.sample2 = out[-3];
+        right.coeff1 = cstate[1].coeff1;
+        right.coeff2 = cstate[1].coeff2;
+        right.delta = cstate[1].delta;
+
+        for (i = 0; i < count; i += 2) {
+            const Uint8 byte = data[i >> 1];
+            out[i] = MS_ADPCM_ProcessNibble(&left, byte >> 4);
+            out[i + 1] = MS_ADPCM_ProcessNibble(&right, byte & 0x0f);
         }
 
-        state->framesleft--;
-        blockframesleft--;
+        cstate[1].delta = (Uint16)right.delta;
+    } else {
+        for (i = 0; i + 1 < count; i += 2) {
+            const Uint8 byte = data[i >> 1];
+            out[i] = MS_ADPCM_ProcessNibble(&left, byte >> 4);
+            out[i + 1] = MS_ADPCM_ProcessNibble(&left, byte & 0x0f);
+        }
+        if (i < count) {
+            out[i] = MS_ADPCM_ProcessNibble(&left, data[i >> 1] >> 4);
+        }
     }
 
-    state->output.pos = outpos;
+    cstate[0].delta = (Uint16)left.delta;
 
-    return 0;
+    state->block.pos += (count + 1) / 2;
+    state->output.pos += count;
+    state->framesleft -= blockframesleft;
+
+    return retval;
 }
 
 static int
@@ -857,71 +895,154 @@ IMA_ADPCM_Init(WaveFile *file, size_t datalength)
     return 0;
 }
 
-static Sint16
-IMA_ADPCM_ProcessNibble(Sint8 *cindex, Sint16 lastsample, Uint8 nybble)
-{
-    const Sint32 max_audioval = 32767;
-    const Sint32 min_audioval = -32768;
-    const Sint8 index_table_4b[16] = {
-        -1, -1, -1, -1,
-        2, 4, 6, 8,
-        -1, -1, -1, -1,
-        2, 4, 6, 8
-    };
-    const Uint16 step_table[89] = {
-        7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31,
-        34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130,
-        143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408,
-        449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282,
-        1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
-        3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630,
-        9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350,
-        22385, 24623, 27086, 29794, 32767
-    };
-    Uint32 step;
-    Sint32 sample, delta;
-    Sint8 index = *cindex;
-
-    /* Clamp index into valid range. */
-    if (index > 88) {
-        index = 88;
-    } else if (index < 0) {
-        index = 0;
-    }
-
-    /* explicit cast to avoid gcc warning about using 'char' as array index */
-    step = step_table[(size_t)index];
-
-    /* Update index value */
-    *cindex = index + index_table_4b[nybble];
-
-    /* This calculation uses shifts and additions because multiplications were
-     * much slower back then. Sadly, this can't just be replaced with an actual
-     * multiplication now as the old algorithm drops some bits. The closest
-     * approximation I could find is something like this:
-     * (nybble & 0x8 ? -1 : 1) * ((nybble & 0x7) * step / 4 + step / 8)
-     */
-    delta = step >> 3;
-    if (nybble & 0x04)
-        delta += step;
-    if (nybble & 0x02)
-        delta += step >> 1;
-    if (nybble & 0x01)
-        delta += step >> 2;
-    if (nybble & 0x08)
-        delta = -delta;
-
-    sample = lastsample + delta;
-
-    /* Clamp output sample */
-    if (sample > max_audioval) {
-        sample = max_audioval;
-    } else if (sample < min_audioval) {
-        sample = min_audioval;
-    }
-
-    return (Sint16)sample;
-}
+/* Number of IMA ADPCM channels decoded side by side. */
+#define IMA_ADPCM_GROUP 8
+
+/* The IMA ADPCM step update, worked out ahead of time for every step index
+ * and the three magnitude bits of a nibble. IMA_ADPCM_StepDelta has the
+ * unsigned sample delta as the original shift-and-add algorithm computes it,
+ * dropped bits and all. IMA_ADPCM_NextIndex has the following step index,
+ * already clamped to the valid range.
+ */
+static const Uint16 IMA_ADPCM_StepDelta[89 * 8] = {
+    0, 1, 3, 4, 7, 8, 10, 11,
+    1, 3, 5, 7, 9, 11, 13, 15,
+    1, 3, 5, 7, 10, 12, 14, 16,
+    1, 3, 6, 8, 11, 13, 16, 18,
+    1, 3, 6, 8, 12, 14, 17, 19,
+    1, 4, 7, 10, 13, 16, 19, 22,
+    1, 4, 7, 10, 14, 17, 20, 23,
+    1, 4, 8, 11, 15, 18, 22, 25,
+    2, 6, 10, 14, 18, 22, 26, 30,
+    2, 6, 10, 14, 19, 23, 27, 31,
+    2, 6, 11, 15, 21, 25, 30, 34,
+    2, 7, 12, 17, 23, 28, 33, 38,
+    2, 7, 13, 18, 25, 30, 36, 41,
+    3, 9, 15, 21, 28, 34, 40, 46,
+    3, 10, 17, 24, 31, 38, 45, 52,
+    3, 10, 18, 25, 34, 41, 49, 56,
+    4, 12, 21, 29, 38, 46, 55, 63,
+    4, 13, 22, 31, 41, 50, 59, 68,
+    5, 15, 25, 35, 46, 56, 66, 76,
+    5, 16, 27, 38, 50, 61, 72, 83,
+    6, 18, 31, 43, 56, 68, 81, 93,
+    6, 19, 33, 46, 61, 74, 88, 101,
+    7, 22, 37, 52, 67, 82, 97, 112,
+    8, 24, 41, 57, 74, 90, 107, 123,
+    9, 27, 45, 63, 82, 100, 118, 136,
+    10, 30, 50, 70, 90, 110, 130, 150,
+    11, 33, 55, 77, 99, 121, 143, 165,
+    12, 36, 60, 84, 109, 133, 157, 181,
+    13, 39, 66, 92, 120, 146, 173, 199,
+    14, 43, 73, 102, 132, 161, 191, 220,
+    16, 48, 81, 113, 146, 178, 211, 243,
+    17, 52, 88, 123, 160, 195, 231, 266,
+    19, 58, 97, 136, 176, 215, 254, 293,
+    21, 64, 107, 150, 194, 237, 280, 323,
+    23, 70, 118, 165, 213, 260, 308, 355,
+    26, 78, 130, 182, 235, 287, 339, 391,
+    28, 85, 143, 200, 258, 315, 373, 430,
+    31, 94, 157, 220, 284, 347, 410, 473,
+    34, 103, 173, 242, 313, 382, 452, 521,
+    38, 114, 191, 267, 345, 421, 498, 574,
+    42, 126, 210, 294, 379, 463, 547, 631,
+    46, 138, 231, 323, 417, 509, 602, 694,
+    51, 153, 255, 357, 459, 561, 663, 765,
+    56, 168, 280, 392, 505, 617, 729, 841,
+    61, 184, 308, 431, 555, 678, 802, 925,
+    68, 204, 340, 476, 612, 748, 884, 1020,
+    74, 223, 373, 522, 672, 821, 971, 1120,
+    82, 246, 411, 575, 740, 904, 1069, 1233,
+    90, 271, 452, 633, 814, 995, 1176, 1357,
+    99, 298, 497, 696, 895, 1094, 1293, 1492,
+    109, 328, 547, 766, 985, 1204, 1423, 1642,
+    120, 360, 601, 841, 1083, 1323, 1564, 1804,
+    132, 397, 662, 927, 1192, 1457, 1722, 1987,
+    145, 436, 728, 1019, 1311, 1602, 1894, 2185,
+    160, 480, 801, 1121, 1442, 1762, 2083, 2403,
+    176, 528, 881, 1233, 1587, 1939, 2292, 2644,
+    194, 582, 970, 1358, 1746, 2134, 2522, 2910,
+    213, 639, 1066, 1492, 1920, 2346, 2773, 3199,
+    234, 703, 1173, 1642, 2112, 2581, 3051, 3520,
+    258, 774, 1291, 1807, 2324, 2840, 3357, 3873,
+    284, 852, 1420, 1988, 2556, 3124, 3692, 4260,
+    312, 936, 1561, 2185, 2811, 3435, 4060, 4684,
+    343, 1030, 1717, 2404, 3092, 3779, 4466, 5153,
+    378, 1134, 1890, 2646, 3402, 4158, 4914, 5670,
+    415, 1246, 2078, 2909, 3742, 4573, 5405, 6236,
+    457, 1372, 2287, 3202, 4117, 5032, 5947, 6862,
+    503, 1509, 2516, 3522, 4529, 5535, 6542, 7548,
+    553, 1660, 2767, 3874, 4981, 6088, 7195, 8302,
+    608, 1825, 3043, 4260, 5479, 6696, 7914, 9131,
+    669, 2008, 3348, 4687, 6027, 7366, 8706, 10045,
+    736, 2209, 3683, 5156, 6630, 8103, 9577, 11050,
+    810, 2431, 4052, 5673, 7294, 8915, 10536, 12157,
+    891, 2674, 4457, 6240, 8023, 9806, 11589, 13372,
+    980, 2941, 4902, 6863, 8825, 10786, 12747, 14708,
+    1078, 3235, 5393, 7550, 9708, 11865, 14023, 16180,
+    1186, 3559, 5932, 8305, 10679, 13052, 15425, 17798,
+    1305, 3915, 6526, 9136, 11747, 14357, 16968, 19578,
+    1435, 4306, 7178, 10049, 12922, 15793, 18665, 21536,
+    1579, 4737, 7896, 11054, 14214, 17372, 20531, 23689,
+    1737, 5211, 8686, 12160, 15636, 19110, 22585, 26059,
+    1911, 5733, 9555, 13377, 17200, 21022, 24844, 28666,
+    2102, 6306, 10511, 14715, 18920, 23124, 27329, 31533,
+    2312, 6937, 11562, 16187, 20812, 25437, 30062, 34687,
+    2543, 7630, 12718, 17805, 22893, 27980, 33068, 38155,
+    2798, 8394, 13990, 19586, 25183, 30779, 36375, 41971,
+    3077, 9232, 15388, 21543, 27700, 33855, 40011, 46166,
+    3385, 10156, 16928, 23699, 30471, 37242, 44014, 50785,
+    3724, 11172, 18621, 26069, 33518, 40966, 48415, 55863,
+    4095, 12286, 20478, 28669, 36862, 45053, 53245, 61436
+};
+
+static const Uint8 IMA_ADPCM_NextIndex[89 * 8] = {
+    0, 0, 0, 0, 2, 4, 6, 8, 0, 0, 0, 0, 3, 5, 7, 9,
+    1, 1, 1, 1, 4, 6, 8, 10, 2, 2, 2, 2, 5, 7, 9, 11,
+    3, 3, 3, 3, 6, 8, 10, 12, 4, 4, 4, 4, 7, 9, 11, 13,
+    5, 5, 5, 5, 8, 10, 12, 14, 6, 6, 6, 6, 9, 11, 13, 15,
+    7, 7, 7, 7, 10, 12, 14, 16, 8, 8, 8, 8, 11, 13, 15, 17,
+    9, 9, 9, 9, 12, 14, 16, 18, 10, 10, 10, 10, 13, 15, 17, 19,
+    11, 11, 11, 11, 14, 16, 18, 20, 12, 12, 12, 12, 15, 17, 19, 21,
+    13, 13, 13, 13, 16, 18, 20, 22, 14, 14, 14, 14, 17, 19, 21, 23,
+    15, 15, 15, 15, 18, 20, 22, 24, 16, 16, 16, 16, 19, 21, 23, 25,
+    17, 17, 17, 17, 20, 22, 24, 26, 18, 18, 18, 18, 21, 23, 25, 27,
+    19, 19, 19, 19, 22, 24, 26, 28, 20, 20, 20, 20, 23, 25, 27, 29,
+    21, 21, 21, 21, 24, 26, 28, 30, 22, 22, 22, 22, 25, 27, 29, 31,
+    23, 23, 23, 23, 26, 28, 30, 32, 24, 24, 24, 24, 27, 29, 31, 33,
+    25, 25, 25, 25, 28, 30, 32, 34, 26, 26, 26, 26, 29, 31, 33, 35,
+    27, 27, 27, 27, 30, 32, 34, 36, 28, 28, 28, 28, 31, 33, 35, 37,
+    29, 29, 29, 29, 32, 34, 36, 38, 30, 30, 30, 30, 33, 35, 37, 39,
+    31, 31, 31, 31, 34, 36, 38, 40, 32, 32, 32, 32, 35, 37, 39, 41,
+    33, 33, 33, 33, 36, 38, 40, 42, 34, 34, 34, 34, 37, 39, 41, 43,
+    35, 35, 35, 35, 38, 40, 42, 44, 36, 36, 36, 36, 39, 41, 43, 45,
+    37, 37, 37, 37, 40, 42, 44, 46, 38, 38, 38, 38, 41, 43, 45, 47,
+    39, 39, 39, 39, 42, 44, 46, 48, 40, 40, 40, 40, 43, 45, 47, 49,
+    41, 41, 41, 41, 44, 46, 48, 50, 42, 42, 42, 42, 45, 47, 49, 51,
+    43, 43, 43, 43, 46, 48, 50, 52, 44, 44, 44, 44, 47, 49, 51, 53,
+    45, 45, 45, 45, 48, 50, 52, 54, 46, 46, 46, 46, 49, 51, 53, 55,
+    47, 47, 47, 47, 50, 52, 54, 56, 48, 48, 48, 48, 51, 53, 55, 57,
+    49, 49, 49, 49, 52, 54, 56, 58, 50, 50, 50, 50, 53, 55, 57, 59,
+    51, 51, 51, 51, 54, 56, 58, 60, 52, 52, 52, 52, 55, 57, 59, 61,
+    53, 53, 53, 53, 56, 58, 60, 62, 54, 54, 54, 54, 57, 59, 61, 63,
+    55, 55, 55, 55, 58, 60, 62, 64, 56, 56, 56, 56, 59, 61, 63, 65,
+    57, 57, 57, 57, 60, 62, 64, 66, 58, 58, 58, 58, 61, 63, 65, 67,
+    59, 59, 59, 59, 62, 64, 66, 68, 60, 60, 60, 60, 63, 65, 67, 69,
+    61, 61, 61, 61, 64, 66, 68, 70, 62, 62, 62, 62, 65, 67, 69, 71,
+    63, 63, 63, 63, 66, 68, 70, 72, 64, 64, 64, 64, 67, 69, 71, 73,
+    65, 65, 65, 65, 68, 70, 72, 74, 66, 66, 66, 66, 69, 71, 73, 75,
+    67, 67, 67, 67, 70, 72, 74, 76, 68, 68, 68, 68, 71, 73, 75, 77,
+    69, 69, 69, 69, 72, 74, 76, 78, 70, 70, 70, 70, 73, 75, 77, 79,
+    71, 71, 71, 71, 74, 76, 78, 80, 72, 72, 72, 72, 75, 77, 79, 81,
+    73, 73, 73, 73, 76, 78, 80, 82, 74, 74, 74, 74, 77, 79, 81, 83,
+    75, 75, 75, 75, 78, 80, 82, 84, 76, 76, 76, 76, 79, 81, 83, 85,
+    77, 77, 77, 77, 80, 82, 84, 86, 78, 78, 78, 78, 81, 83, 85, 87,
+    79, 79, 79, 79, 82, 84, 86, 88, 80, 80, 80, 80, 83, 85, 87, 88,
+    81, 81, 81, 81, 84, 86, 88, 88, 82, 82, 82, 82, 85, 87, 88, 88,
+    83, 83, 83, 83, 86, 88, 88, 88, 84, 84, 84, 84, 87, 88, 88, 88,
+    85, 85, 85, 85, 88, 88, 88, 88, 86, 86, 86, 86, 88, 88, 88, 88,
+    87, 87, 87, 87, 88, 88, 88, 88
+};
 
 static int
 IMA_ADPCM_DecodeBlockHeader(ADPCM_DecoderState *state)
@@ -998,35 +1119,69 @@ IMA_ADPCM_DecodeBlockData(ADPCM_DecoderState *state)
     }
 
     /* Each channel has their nibbles packed into 32-bit blocks. These blocks
-     * are interleaved and make up the data part of the ADPCM block. This loop
-     * decodes the samples as they come from the input data and puts them at
-     * the appropriate places in the output data.
+     * are interleaved and make up the data part of the ADPCM block. Up to
+     * eight channels are decoded side by side, sample by sample, so the
+     * channels' independent dependency chains can overlap in the CPU. The
+     * samples go straight to their places in the interleaved output data.
      */
-    while (blockframesleft > 0) {
-        const size_t subblocksamples = blockframesleft < 8 ? (size_t)blockframesleft : 8;
+    for (c = 0; c < channels; c += IMA_ADPCM_GROUP) {
+        const Uint32 n = SDL_min(channels - c, IMA_ADPCM_GROUP);
+        const Uint8 *subblock = state->block.data + blockpos + c * 4;
+        Sint16 *out = state->output.data + outpos + c;
+        Sint64 framesleft = blockframesleft;
+        Sint32 sample[IMA_ADPCM_GROUP];
+        Uint32 index[IMA_ADPCM_GROUP];
+        Uint32 k;
 
-        for (c = 0; c < channels; c++) {
-            Uint8 nybble = 0;
-            /* Load previous sample which may come from the block header. */
-            Sint16 sample = state->output.data[outpos + c - channels];
+        for (k = 0; k < n; k++) {
+            /* Load previous sample which comes from the block header. */
+            const Sint8 cindex = ((Sint8 *)state->cstate)[c + k];
+            sample[k] = out[(Sint32)k - (Sint32)channels];
+            index[k] = cindex < 0 ? 0 : (cindex > 88 ? 88 : cindex);
+        }
+
+        while (framesleft > 0) {
+            const size_t subblocksamples = framesleft < 8 ? (size_t)framesleft : 8;
 
             for (i = 0; i < subblocksamples; i++) {
-                if (i & 1) {
-                    nybble >>= 4;
-                } else {
-                    nybble = state->block.data[blockpos++];
-                }
+                const Uint8 *in = subblock + (i >> 1);
+                const Uint32 shift = (Uint32)(i & 1) * 4;
+
+                for (k = 0; k < n; k++) {
+                    const Uint32 nybble = (in[k * 4] >> shift) & 0x0f;
+                    const Uint32 step = index[k] * 8 + (nybble & 0x07);
+                    const Sint32 sign = -(Sint32)(nybble >> 3);
+                    Sint32 value = sample[k] + (((Sint32)IMA_ADPCM_StepDelta[step] ^ sign) - sign);
+
+                    /* Clamp output sample */
+                    if (value > 32767) {
+                        value = 32767;
+                    } else if (value < -32768) {
+                        value = -32768;
+                    }
 
-                sample = IMA_ADPCM_ProcessNibble((Sint8 *)state->cstate + c, sample, nybble & 0x0f);
-                state->output.data[outpos + c + i * channels] = sample;
+                    sample[k] = value;
+                    index[k] = IMA_ADPCM_NextIndex[step];
+                    out[k] = (Sint16)value;
+                }
+                out += channels;
             }
+
+            subblock += subblockframesize;
+            framesleft -= subblocksamples;
         }
 
-        outpos += channels * subblocksamples;
-        state->framesleft -= subblocksamples;
-        blockframesleft -= subblocksamples;
+        for (k = 0; k < n; k++) {
+            ((Sint8 *)state->cstate)[c + k] = (Sint8)index[k];
+        }
     }
 
+    /* Full sub-blocks, and as many bytes as got used of the last one. */
+    blockpos += (size_t)(blockframesleft / 8) * subblockframesize;
+    blockpos += (size_t)((blockframesleft % 8 + 1) / 2) * channels;
+    outpos += (size_t)blockframesleft * channels;
+    state->framesleft -= blockframesleft;
+
     state->block.pos = blockpos;
     state->output.pos = outpos;
 
@@ -1166,53 +1321,94 @@ LAW_Init(WaveFile *file, size_t datalength)
     return 0;
 }
 
+/* The 16-bit values of all 256 A-law and mu-law bytes. */
+static const Sint16 alaw_lut[256] = {
+    -5504, -5248, -6016, -5760, -4480, -4224, -4992, -4736, -7552, -7296, -8064, -7808, -6528, -6272, -7040, -6784, -2752,
+    -2624, -3008, -2880, -2240, -2112, -2496, -2368, -3776, -3648, -4032, -3904, -3264, -3136, -3520, -3392, -22016,
+    -20992, -24064, -23040, -17920, -16896, -19968, -18944, -30208, -29184, -32256, -31232, -26112, -25088, -28160, -27136, -11008,
+    -10496, -12032, -11520, -8960, -8448, -9984, -9472, -15104, -14592, -16128, -15616, -13056, -12544, -14080, -13568, -344,
+    -328, -376, -360, -280, -264, -312, -296, -472, -456, -504, -488, -408, -392, -440, -424, -88,
+    -72, -120, -104, -24, -8, -56, -40, -216, -200, -248, -232, -152, -136, -184, -168, -1376,
+    -1312, -1504, -1440, -1120, -1056, -1248, -1184, -1888, -1824, -2016, -1952, -1632, -1568, -1760, -1696, -688,
+    -656, -752, -720, -560, -528, -624, -592, -944, -912, -1008, -976, -816, -784, -880, -848, 5504,
+    5248, 6016, 5760, 4480, 4224, 4992, 4736, 7552, 7296, 8064, 7808, 6528, 6272, 7040, 6784, 2752,
+    2624, 3008, 2880, 2240, 2112, 2496, 2368, 3776, 3648, 4032, 3904, 3264, 3136, 3520, 3392, 22016,
+    20992, 24064, 23040, 17920, 16896, 19968, 18944, 30208, 29184, 32256, 31232, 26112, 25088, 28160, 27136, 11008,
+    10496, 12032, 11520, 8960, 8448, 9984, 9472, 15104, 14592, 16128, 15616, 13056, 12544, 14080, 13568, 344,
+    328, 376, 360, 280, 264, 312, 296, 472, 456, 504, 488, 408, 392, 440, 424, 88,
+    72, 120, 104, 24, 8, 56, 40, 216, 200, 248, 232, 152, 136, 184, 168, 1376,
+    1312, 1504, 1440, 1120, 1056, 1248, 1184, 1888, 1824, 2016, 1952, 1632, 1568, 1760, 1696, 688,
+    656, 752, 720, 560, 528, 624, 592, 944, 912, 1008, 976, 816, 784, 880, 848
+};
+
+static const Sint16 mulaw_lut[256] = {
+    -32124, -31100, -30076, -29052, -28028, -27004, -25980, -24956, -23932, -22908, -21884, -20860, -19836, -18812, -17788, -16764, -15996,
+    -15484, -14972, -14460, -13948, -13436, -12924, -12412, -11900, -11388, -10876, -10364, -9852, -9340, -8828, -8316, -7932,
+    -7676, -7420, -7164, -6908, -6652, -6396, -6140, -5884, -5628, -5372, -5116, -4860, -4604, -4348, -4092, -3900,
+    -3772, -3644, -3516, -3388, -3260, -3132, -3004, -2876, -2748, -2620, -2492, -2364, -2236, -2108, -1980, -1884,
+    -1820, -1756, -1692, -1628, -1564, -1500, -1436, -1372, -1308, -1244, -1180, -1116, -1052, -988, -924, -876,
+    -844, -812, -780, -748, -716, -684, -652, -620, -588, -556, -524, -492, -460, -428, -396, -372,
+    -356, -340, -324, -308, -292, -276, -260, -244, -228, -212, -196, -180, -164, -148, -132, -120,
+    -112, -104, -96, -88, -80, -72, -64, -56, -48, -40, -32, -24, -16, -8, 0, 32124,
+    31100, 30076, 29052, 28028, 27004, 25980, 24956, 23932, 22908, 21884, 20860, 19836, 18812, 17788, 16764, 15996,
+    15484, 14972, 14460, 13948, 13436, 12924, 12412, 11900, 11388, 10876, 10364, 9852, 9340, 8828, 8316, 7932,
+    7676, 7420, 7164, 6908, 6652, 6396, 6140, 5884, 5628, 5372, 5116, 4860, 4604, 4348, 4092, 3900,
+    3772, 3644, 3516, 3388, 3260, 3132, 3004, 2876, 2748, 2620, 2492, 2364, 2236, 2108, 1980, 1884,
+    1820, 1756, 1692, 1628, 1564, 1500, 1436, 1372, 1308, 1244, 1180, 1116, 1052, 988, 924, 876,
+    844, 812, 780, 748, 716, 684, 652, 620, 588, 556, 524, 492, 460, 428, 396, 372,
+    356, 340, 324, 308, 292, 276, 260, 244, 228, 212, 196, 180, 164, 148, 132, 120,
+    112, 104, 96, 88, 80, 72, 64, 56, 48, 40, 32, 24, 16, 8, 0
+};
+
+/* Expands sample_count companded samples to 16 bits. Works backwards, so src
+ * and dst can point to the same buffer.
+ */
 static int
-LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
+LAW_ExpandSamples(Uint16 encoding, const Uint8 *src, Sint16 *dst, size_t sample_count)
 {
-#ifdef SDL_WAVE_LAW_LUT
-    const Sint16 alaw_lut[256] = {
-        -5504, -5248, -6016, -5760, -4480, -4224, -4992, -4736, -7552, -7296, -8064, -7808, -6528, -6272, -7040, -6784, -2752,
-        -2624, -3008, -2880, -2240, -2112, -2496, -2368, -3776, -3648, -4032, -3904, -3264, -3136, -3520, -3392, -22016,
-        -20992, -24064, -23040, -17920, -16896, -19968, -18944, -30208, -29184, -32256, -31232, -26112, -25088, -28160, -27136, -11008,
-        -10496, -12032, -11520, -8960, -8448, -9984, -9472, -15104, -14592, -16128, -15616, -13056, -12544, -14080, -13568, -344,
-        -328, -376, -360, -280, -264, -312, -296, -472, -456, -504, -488, -408, -392, -440, -424, -88,
-        -72, -120, -104, -24, -8, -56, -40, -216, -200, -248, -232, -152, -136, -184, -168, -1376,
-        -1312, -1504, -1440, -1120, -1056, -1248, -1184, -1888, -1824, -2016, -1952, -1632, -1568, -1760, -1696, -688,
-        -656, -752, -720, -560, -528, -624, -592, -944, -912, -1008, -976, -816, -784, -880, -848, 5504,
-        5248, 6016, 5760, 4480, 4224, 4992, 4736, 7552, 7296, 8064, 7808, 6528, 6272, 7040, 6784, 2752,
-        2624, 3008, 2880, 2240, 2112, 2496, 2368, 3776, 3648, 4032, 3904, 3264, 3136, 3520, 3392, 22016,
-        20992, 24064, 23040, 17920, 16896, 19968, 18944, 30208, 29184, 32256, 31232, 26112, 25088, 28160, 27136, 11008,
-        10496, 12032, 11520, 8960, 8448, 9984, 9472, 15104, 14592, 16128, 15616, 13056, 12544, 14080, 13568, 344,
-        328, 376, 360, 280, 264, 312, 296, 472, 456, 504, 488, 408, 392, 440, 424, 88,
-        72, 120, 104, 24, 8, 56, 40, 216, 200, 248, 232, 152, 136, 184, 168, 1376,
-        1312, 1504, 1440, 1120, 1056, 1248, 1184, 1888, 1824, 2016, 1952, 1632, 1568, 1760, 1696, 688,
-        656, 752, 720, 560, 528, 624, 592, 944, 912, 1008, 976, 816, 784, 880, 848
-    };
-    const Sint16 mulaw_lut[256] = {
-        -32124, -31100, -30076, -29052, -28028, -27004, -25980, -24956, -23932, -22908, -21884, -20860, -19836, -18812, -17788, -16764, -15996,
-        -15484, -14972, -14460, -13948, -13436, -12924, -12412, -11900, -11388, -10876, -10364, -9852, -9340, -8828, -8316, -7932,
-        -7676, -7420, -7164, -6908, -6652, -6396, -6140, -5884, -5628, -5372, -5116, -4860, -4604, -4348, -4092, -3900,
-        -3772, -3644, -3516, -3388, -3260, -3132, -3004, -2876, -2748, -2620, -2492, -2364, -2236, -2108, -1980, -1884,
-        -1820, -1756, -1692, -1628, -1564, -1500, -1436, -1372, -1308, -1244, -1180, -1116, -1052, -988, -924, -876,
-        -844, -812, -780, -748, -716, -684, -652, -620, -588, -556, -524, -492, -460, -428, -396, -372,
-        -356, -340, -324, -308, -292, -276, -260, -244, -228, -212, -196, -180, -164, -148, -132, -120,
-        -112, -104, -96, -88, -80, -72, -64, -56, -48, -40, -32, -24, -16, -8, 0, 32124,
-        31100, 30076, 29052, 28028, 27004, 25980, 24956, 23932, 22908, 21884, 20860, 19836, 18812, 17788, 16764, 15996,
-        15484, 14972, 14460, 13948, 13436, 12924, 12412, 11900, 11388, 10876, 10364, 9852, 9340, 8828, 8316, 7932,
-        7676, 7420, 7164, 6908, 6652, 6396, 6140, 5884, 5628, 5372, 5116, 4860, 4604, 4348, 4092, 3900,
-        3772, 3644, 3516, 3388, 3260, 3132, 3004, 2876, 2748, 2620, 2492, 2364, 2236, 2108, 1980, 1884,
-        1820, 1756, 1692, 1628, 1564, 1500, 1436, 1372, 1308, 1244, 1180, 1116, 1052, 988, 924, 876,
-        844, 812, 780, 748, 716, 684, 652, 620, 588, 556, 524, 492, 460, 428, 396, 372,
-        356, 340, 324, 308, 292, 276, 260, 244, 228, 212, 196, 180, 164, 148, 132, 120,
-        112, 104, 96, 88, 80, 72, 64, 56, 48, 40, 32, 24, 16, 8, 0
-    };
-#endif
+    const Sint16 *lut;
+    size_t i = sample_count;
 
+    switch (encoding) {
+    case ALAW_CODE:
+        lut = alaw_lut;
+        break;
+    case MULAW_CODE:
+        lut = mulaw_lut;
+        break;
+    default:
+        return SDL_SetError("Unknown companded encoding");
+    }
+
+    /* Four at a time, reading all four bytes before writing any of the
+     * samples, which is safe in-place too.
+     */
+    while (i >= 4) {
+        Sint16 s0, s1, s2, s3;
+        i -= 4;
+        s0 = lut[src[i]];
+        s1 = lut[src[i + 1]];
+        s2 = lut[src[i + 2]];
+        s3 = lut[src[i + 3]];
+        dst[i] = s0;
+        dst[i + 1] = s1;
+        dst[i + 2] = s2;
+        dst[i + 3] = s3;
+    }
+    while (i--) {
+        dst[i] = lut[src[i]];
+    }
+
+    return 0;
+}
+
+static int
+LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
+{
     WaveFormat *format = &file->format;
     WaveChunk *chunk = &file->chunk;
-    size_t i, sample_count, expanded_len;
+    size_t sample_count, expanded_len;
     Uint8 *src;
-    Sint16 *dst;
 
     if (chunk->length != chunk->size) {
         file->sampleframes = WaveAdjustToFactValue(file, chunk->size / format->blockalign);
@@ -1248,59 +1444,12 @@ LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
     chunk->data = NULL;
     chunk->size = 0;
 
-    dst = (Sint16 *)src;
-
-    /* Work backwards, since we're expanding in-place. SDL_AudioSpec.format will
-     * inform the caller about the byte order.
+    /* Expanding in-place. SDL_AudioSpec.format will inform the caller about
+     * the byte order.
      */
-    i = sample_count;
-    switch (file->format.encoding) {
-#ifdef SDL_WAVE_LAW_LUT
-    case ALAW_CODE:
-        while (i--) {
-            dst[i] = alaw_lut[src[i]];
-        }
-        break;
-    case MULAW_CODE:
-        while (i--) {
-            dst[i] = mulaw_lut[src[i]];
-        }
-        break;
-#else
-    case ALAW_CODE:
-        while (i--) {
-            Uint8 nibble = src[i];
-            Uint8 exponent = (nibble & 0x7f) ^ 0x55;
-            Sint16 mantissa = exponent & 0xf;
-
-            exponent >>= 4;
-            if (exponent > 0) {
-                mantissa |= 0x10;
-            }
-            mantissa = (mantissa << 4) | 0x8;
-            if (exponent > 1) {
-                mantissa <<= exponent - 1;
-            }
-
-            dst[i] = nibble & 0x80 ? mantissa : -mantissa;
-        }
-        break;
-    case MULAW_CODE:
-        while (i--) {
-            Uint8 nibble = ~src[i];
-            Sint16 mantissa = nibble & 0xf;
-            Uint8 exponent = (nibble >> 4) & 0x7;
-            Sint16 step = 4 << (exponent + 1);
-
-            mantissa = (0x80 << exponent) + step * mantissa + step / 2 - 132;
-
-            dst[i] = nibble & 0x80 ? -mantissa : mantissa;
-        }
-        break;
-#endif
-    default:
+    if (LAW_ExpandSamples(format->encoding, src, (Sint16 *)src, sample_count) < 0) {
         SDL_free(src);
-        return SDL_SetError("Unknown companded encoding");
+        return -1;
     }
 
     *audio_buf = src;
@@ -1352,12 +1501,37 @@ PCM_Init(WaveFile *file, size_t datalength)
     return 0;
 }
 
+/* Shifts sample_count 24-bit samples to 32 bits, in-place. ptr must have room
+ * for the 32-bit samples.
+ */
+static void
+PCM_ExpandSint24ToSint32(Uint8 *ptr, size_t sample_count)
+{
+    size_t i;
+
+    /* work from end to start, since we're expanding in-place. */
+    for (i = sample_count; i > 0; i--) {
+        const size_t o = i - 1;
+        uint8_t b[4];
+
+        b[0] = 0;
+        b[1] = ptr[o * 3];
+        b[2] = ptr[o * 3 + 1];
+        b[3] = ptr[o * 3 + 2];
+
+        ptr[o * 4 + 0] = b[0];
+        ptr[o * 4 + 1] = b[1];
+        ptr[o * 4 + 2] = b[2];
+        ptr[o * 4 + 3] = b[3];
+    }
+}
+
 static int
 PCM_ConvertSint24ToSint32(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
 {
     WaveFormat *format = &file->format;
     WaveChunk *chunk = &file->chunk;
-    size_t i, expanded_len, sample_count;
+    size_t expanded_len, sample_count;
     Uint8 *ptr;
 
     sample_count = (size_t)file->sampleframes;
@@ -1385,21 +1559,7 @@ PCM_ConvertSint24ToSint32(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
     *audio_buf = ptr;
     *audio_len = (Uint32)expanded_len;
 
-    /* work from end to start, since we're expanding in-place. */
-    for (i = sample_count; i > 0; i--) {
-        const size_t o = i - 1;
-        uint8_t b[4];
-
-        b[0] = 0;
-        b[1] = ptr[o * 3];
-        b[2] = ptr[o * 3 + 1];
-        b[3] = ptr[o * 3 + 2];
-
-        ptr[o * 4 + 0] = b[0];
-        ptr[o * 4 + 1] = b[1];
-        ptr[o * 4 + 2] = b[2];
-        ptr[o * 4 + 3] = b[3];
-    }
+    PCM_ExpandSint24ToSint32(ptr, sample_count);
 
     return 0;
 }
@@ -1783,8 +1943,11 @@ WaveCheckFormat(WaveFile *file, size_t datalength)
     return 0;
 }
 
+/* Parses the chunks up to the data chunk, leaving the data chunk, without its
+ * data, in file->chunk. endposition is set to where the WAVE file ends.
+ */
 static int
-WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf, Uint32 *audio_len)
+WaveReadHeaders(SDL_RWops *src, WaveFile *file, Sint64 *endposition)
 {
     int result;
     Uint32 chunkcount = 0;
@@ -1792,7 +1955,6 @@ WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf,
     char *envchunkcountlimit;
     Sint64 RIFFstart, RIFFend, lastchunkpos;
     SDL_bool RIFFlengthknown = SDL_FALSE;
-    WaveFormat *format = &file->format;
     WaveChunk *chunk = &file->chunk;
     WaveChunk RIFFchunk;
     WaveChunk fmtchunk;
@@ -1997,9 +2159,79 @@ WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf,
 
     WaveFreeChunkData(chunk);
 
-    /* Process data chunk. */
     *chunk = datachunk;
 
+    /* The position after the RIFF chunk, or after the last chunk if the RIFF
+     * length is unknown. The cleanup code leaves the data source there.
+     */
+    if (RIFFlengthknown) {
+        *endposition = RIFFend;
+    } else {
+        *endposition = lastchunkpos;
+    }
+
+    return 0;
+}
+
+static int
+WaveSetSpec(WaveFile *file, SDL_AudioSpec *spec)
+{
+    WaveFormat *format = &file->format;
+
+    /* Setting up the SDL_AudioSpec. All unsupported formats were filtered out
+     * by WaveCheckFormat.
+     */
+    SDL_zerop(spec);
+    spec->freq = format->frequency;
+    spec->channels = (Uint8)format->channels;
+    spec->samples = 4096;       /* Good default buffer size */
+
+    switch (format->encoding) {
+    case MS_ADPCM_CODE:
+    case IMA_ADPCM_CODE:
+    case ALAW_CODE:
+    case MULAW_CODE:
+        /* These can be easily stored in the byte order of the system. */
+        spec->format = AUDIO_S16SYS;
+        break;
+    case IEEE_FLOAT_CODE:
+        spec->format = AUDIO_F32LSB;
+        break;
+    case PCM_CODE:
+        switch (format->bitspersample) {
+        case 8:
+            spec->format = AUDIO_U8;
+            break;
+        case 16:
+            spec->format = AUDIO_S16LSB;
+            break;
+        case 24: /* Has been shifted to 32 bits. */
+        case 32:
+            spec->format = AUDIO_S32LSB;
+            break;
+        default:
+            /* Just in case something unexpected happened in the checks. */
+            return SDL_SetError("Unexpected %u-bit PCM data format", (unsigned int)format->bitspersample);
+        }
+        break;
+    }
+
+    return 0;
+}
+
+static int
+WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf, Uint32 *audio_len)
+{
+    int result;
+    Sint64 endposition;
+    WaveFormat *format = &file->format;
+    WaveChunk *chunk = &file->chunk;
+
+    if (WaveReadHeaders(src, file, &endposition) < 0) {
+        return -1;
+    }
+
+    /* Process data chunk. */
     if (chunk->length > 0) {
         result = WaveReadChunkData(src, chunk);
         if (result == -1) {
@@ -2043,50 +2275,12 @@ WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf,
         break;
     }
 
-    /* Setting up the SDL_AudioSpec. All unsupported formats were filtered out
-     * by checks earlier in this function.
-     */
-    SDL_zerop(spec);
-    spec->freq = format->frequency;
-    spec->channels = (Uint8)format->channels;
-    spec->samples = 4096;       /* Good default buffer size */
-
-    switch (format->encoding) {
-    case MS_ADPCM_CODE:
-    case IMA_ADPCM_CODE:
-    case ALAW_CODE:
-    case MULAW_CODE:
-        /* These can be easily stored in the byte order of the system. */
-        spec->format = AUDIO_S16SYS;
-        break;
-    case IEEE_FLOAT_CODE:
-        spec->format = AUDIO_F32LSB;
-        break;
-    case PCM_CODE:
-        switch (format->bitspersample) {
-        case 8:
-            spec->format = AUDIO_U8;
-            break;
-        case 16:
-            spec->format = AUDIO_S16LSB;
-            break;
-        case 24: /* Has been shifted to 32 bits. */
-        case 32:
-            spec->format = AUDIO_S32LSB;
-            break;
-        default:
-            /* Just in case something unexpected happened in the checks. */
-            return SDL_SetError("Unexpected %u-bit PCM data format", (unsigned int)format->bitspersample);
-        }
-        break;
+    if (WaveSetSpec(file, spec) < 0) {
+        return -1;
     }
 
     /* Report the end position back to the cleanup code. */
-    if (RIFFlengthknown) {
-        chunk->position = RIFFend;
-    } else {
-        chunk->position = lastchunkpos;
-    }
+    chunk->position = endposition;
 
     return 0;
 }
@@ -2150,4 +2344,386 @@ SDL_FreeWAV(Uint8 *audio_buf)
     SDL_free(audio_buf);
 }
 
+/* Number of sample frames read at a time from uncompressed data. */
+#define WAVE_STREAM_PCM_FRAMES 4096
+
+struct _SDL_WAVStream
+{
+    SDL_RWops *src;
+    int freesrc;
+    WaveFile file;
+    Sint64 endposition;  /* Where the data source is left on close. */
+    size_t datalength;   /* Bytes of the data chunk that are in the data source. */
+    size_t blocksize;    /* Bytes of the data chunk per block. */
+    size_t blockframes;  /* Sample frames per block. */
+    size_t framesize;    /* Bytes per decoded sample frame. */
+    Sint64 frame;        /* The next sample frame to return. */
+    Sint64 block;        /* The block in output, or -1 if there is none. */
+    Uint8 *input;        /* Encoded data of one ADPCM block. */
+    Uint8 *output;       /* Decoded data of one block. */
+    size_t outputlen;    /* Bytes of decoded data in output. */
+    void *cstate;        /* ADPCM decoding state for each channel. */
+};
+
+/* Works out how many sample frames are left if the data chunk is cut short,
+ * like the full decoders do when they can't read the whole chunk.
+ */
+static int
+WaveStreamTruncate(SDL_WAVStream *wav)
+{
+    WaveFile *file = &wav->file;
+
+    switch (file->format.encoding) {
+    case MS_ADPCM_CODE:
+        return MS_ADPCM_CalculateSampleFrames(file, wav->datalength);
+    case IMA_ADPCM_CODE:
+        return IMA_ADPCM_CalculateSampleFrames(file, wav->datalength);
+    default:
+        file->sampleframes = WaveAdjustToFactValue(file, wav->datalength / file->format.blockalign);
+        return file->sampleframes < 0 ? -1 : 0;
+    }
+}
+
+static int
+WaveStreamReadInput(SDL_WAVStream *wav, Sint64 block, void *buf, size_t len)
+{
+    const Sint64 position = wav->file.chunk.position + block * (Sint64)wav->blocksize;
+
+    if (SDL_RWseek(wav->src, position, RW_SEEK_SET) != position) {
+        return SDL_SetError("Could not seek data of WAVE data chunk");
+    } else if (SDL_RWread(wav->src, buf, 1, len) != len) {
+        return SDL_SetError("Could not read data of WAVE data chunk");
+    }
+    return 0;
+}
+
+/* Decodes one block into wav->output. The last block may be shorter. */
+static int
+WaveStreamDecodeBlock(SDL_WAVStream *wav, Sint64 block)
+{
+    WaveFile *file = &wav->file;
+    WaveFormat *format = &file->format;
+    const Sint64 firstframe = block * (Sint64)wav->blockframes;
+    const size_t frames = (size_t)SDL_min((Sint64)wav->blockframes, file->sampleframes - firstframe);
+    const size_t samples = frames * format->channels;
+    size_t decoded = frames;
+
+    /* Forget the old block first, in case this one fails. */
+    wav->block = -1;
+    wav->outputlen = 0;
+
+    switch (format->encoding) {
+    case PCM_CODE:
+    case IEEE_FLOAT_CODE:
+        if (WaveStreamReadInput(wav, block, wav->output, frames * format->blockalign) < 0) {
+            return -1;
+        }
+        if (format->encoding == PCM_CODE && format->bitspersample == 24) {
+            PCM_ExpandSint24ToSint32(wav->output, samples);
+        }
+        break;
+    case ALAW_CODE:
+    case MULAW_CODE:
+        if (WaveStreamReadInput(wav, block, wav->output, samples) < 0) {
+            return -1;
+        } else if (LAW_ExpandSamples(format->encoding, wav->output, (Sint16 *)wav->output, samples) < 0) {
+            return -1;
+        }
+        break;
+    case MS_ADPCM_CODE:
+    case IMA_ADPCM_CODE: {
+        const SDL_bool ms = (format->encoding == MS_ADPCM_CODE);
+        const size_t offset = (size_t)block * wav->blocksize;
+        ADPCM_DecoderState state;
+        int result;
+
+        SDL_zero(state);
+        state.channels = format->channels;
+        state.blocksize = wav->blocksize;
+        state.blockheadersize = (size_t)state.channels * (ms ? 7 : 4);
+        state.samplesperblock = format->samplesperblock;
+        state.framesize = state.channels * sizeof(Sint16);
+        state.ddata = file->decoderdata;
+        state.cstate = wav->cstate;
+        state.framestotal = frames;
+        state.framesleft = frames;
+
+        state.block.data = wav->input;
+        state.block.size = SDL_min(wav->blocksize, wav->datalength - offset);
+        state.block.pos = 0;
+
+        state.output.data = (Sint16 *)wav->output;
+        state.output.size = wav->blockframes * state.channels;
+        state.output.pos = 0;
+
+        if (WaveStreamReadInput(wav, block, wav->input, state.block.size) < 0) {
+            return -1;
+        }
+
+        /* The block header resets the channel states, so every block can be
+         * decoded on its own.
+         */
+        if (ms) {
+            result = MS_ADPCM_DecodeBlockHeader(&state);
+            if (result == 0) {
+                result = MS_ADPCM_DecodeBlockData(&state);
+            }
+        } else {
+            result = IMA_ADPCM_DecodeBlockHeader(&state);
+            if (result == 0) {
+                result = IMA_ADPCM_DecodeBlockData(&state);
+            }
+        }
+
+        if (result == -1) {
+            /* Unexpected end. Keep what the full decoder would have kept. */
+            if (file->trunchint == TruncVeryStrict) {
+                return SDL_SetError("Truncated data chunk");
+            } else if (file->trunchint != TruncDropFrame) {
+                decoded = 0;
+            } else if (decoded > state.output.pos / state.channels) {
+                decoded = state.output.pos / state.channels;
+            }
+        }
+        break;
+    }
+    }
+
+    wav->block = block;
+    wav->outputlen = decoded * wav->framesize;
+    return 0;
+}
+
+/* Points data at up to len bytes of decoded audio at the current frame and
+ * moves past them. Returns the number of bytes, 0 at the end, or -1 on error.
+ */
+static int
+WaveStreamNext(SDL_WAVStream *wav, const Uint8 **data, int len)
+{
+    const Sint64 block = wav->frame / (Sint64)wav->blockframes;
+    size_t offset, available;
+
+    if (wav->frame >= wav->file.sampleframes) {
+        return 0;
+    }
+
+    if (block != wav->block && WaveStreamDecodeBlock(wav, block) < 0) {
+        return -1;
+    }
+
+    offset = (size_t)(wav->frame - block * (Sint64)wav->blockframes) * wav->framesize;
+    if (offset >= wav->outputlen) {
+        /* A truncated block came up short. Nothing after it can be decoded. */
+        wav->file.sampleframes = wav->frame;
+        return 0;
+    }
+
+    available = wav->outputlen - offset;
+    if ((size_t)len > available) {
+        len = (int)available;
+    }
+    len -= len % wav->framesize;
+
+    *data = wav->output + offset;
+    wav->frame += len / wav->framesize;
+    return len;
+}
+
+SDL_WAVStream *
+SDL_OpenWAVStream_RW(SDL_RWops *src, int freesrc, SDL_AudioSpec *spec)
+{
+    SDL_WAVStream *wav;
+    WaveFile *file;
+    WaveFormat *format;
+    Sint64 srcsize;
+
+    /* Make sure we are passed a valid data source */
+    if (src == NULL) {
+        /* Error may come from RWops. */
+        return NULL;
+    } else if (spec == NULL) {
+        SDL_InvalidParamError("spec");
+        if (freesrc) {
+            SDL_RWclose(src);
+        }
+        return NULL;
+    }
+
+    wav = (SDL_WAVStream *)SDL_calloc(1, sizeof(*wav));
+    if (wav == NULL) {
+        SDL_OutOfMemory();
+        if (freesrc) {
+            SDL_RWclose(src);
+        }
+        return NULL;
+    }
+
+    wav->src = src;
+    wav->freesrc = freesrc;
+    wav->block = -1;
+    file = &wav->file;
+    format = &file->format;
+    file->riffhint = WaveGetRiffSizeHint();
+    file->trunchint = WaveGetTruncationHint();
+    file->facthint = WaveGetFactChunkHint();
+
+    if (WaveReadHeaders(src, file, &wav->endposition) < 0 || WaveSetSpec(file, spec) < 0) {
+        wav->endposition = file->chunk.position;
+        SDL_CloseWAVStream(wav);
+        return NULL;
+    }
+
+    /* Check how much of the data chunk is really there, without reading it. */
+    wav->datalength = file->chunk.length;
+    srcsize = SDL_RWsize(src);
+    if (srcsize >= 0 && srcsize - file->chunk.position < (Sint64)wav->datalength) {
+        wav->datalength = (size_t)SDL_max(srcsize - file->chunk.position, 0);
+    }
+
+    if (wav->datalength != file->chunk.length) {
+        /* I/O issues or corrupt file. */
+        if (file->trunchint == TruncVeryStrict || file->trunchint == TruncStrict) {
+            SDL_SetError("Could not read data of WAVE data chunk");
+            SDL_CloseWAVStream(wav);
+            return NULL;
+        } else if (WaveStreamTruncate(wav) < 0) {
+            SDL_CloseWAVStream(wav);
+            return NULL;
+        }
+    }
+
+    wav->framesize = (SDL_AUDIO_BITSIZE(spec->format) / 8) * format->channels;
+    if (format->encoding == MS_ADPCM_CODE || format->encoding == IMA_ADPCM_CODE) {
+        wav->blocksize = format->blockalign;
+        wav->blockframes = format->samplesperblock;
+        wav->input = (Uint8 *)SDL_malloc(wav->blocksize);
+        wav->cstate = SDL_calloc(format->channels, sizeof(MS_ADPCM_ChannelState));
+        if (wav->input == NULL || wav->cstate == NULL) {
+            SDL_OutOfMemory();
+            SDL_CloseWAVStream(wav);
+            return NULL;
+        }
+    } else {
+        /* The other encodings get expanded in-place in the output buffer,
+         * which is never smaller than the encoded data.
+         */
+        wav->blockframes = WAVE_STREAM_PCM_FRAMES;
+        wav->blocksize = wav->blockframes * format->blockalign;
+    }
+
+    wav->output = (Uint8 *)SDL_malloc(wav->blockframes * wav->framesize);
+    if (wav->output == NULL) {
+        SDL_OutOfMemory();
+        SDL_CloseWAVStream(wav);
+        return NULL;
+    }
+
+    return wav;
+}
+
+Sint64
+SDL_WAVStreamLength(SDL_WAVStream *wav)
+{
+    if (wav == NULL) {
+        return SDL_InvalidParamError("wav");
+    }
+    return wav->file.sampleframes;
+}
+
+Sint64
+SDL_WAVStreamTell(SDL_WAVStream *wav)
+{
+    if (wav == NULL) {
+        return SDL_InvalidParamError("wav");
+    }
+    return wav->frame;
+}
+
+int
+SDL_WAVStreamRead(SDL_WAVStream *wav, void *buf, int len)
+{
+    Uint8 *dst = (Uint8 *)buf;
+    int total = 0;
+
+    if (wav == NULL) {
+        return SDL_InvalidParamError("wav");
+    } else if (buf == NULL) {
+        return SDL_InvalidParamError("buf");
+    }
+
+    while (total < len) {
+        const Uint8 *data;
+        const int rc = WaveStreamNext(wav, &data, len - total);
+        if (rc < 0) {
+            return total > 0 ? total : -1;
+        } else if (rc == 0) {
+            break;
+        }
+        SDL_memcpy(dst + total, data, rc);
+        total += rc;
+    }
+
+    return total;
+}
+
+int
+SDL_WAVStreamPut(SDL_WAVStream *wav, SDL_AudioStream *stream, int len)
+{
+    int total = 0;
+
+    if (wav == NULL) {
+        return SDL_InvalidParamError("wav");
+    } else if (stream == NULL) {
+        return SDL_InvalidParamError("stream");
+    }
+
+    while (total < len) {
+        const Uint8 *data;
+        const int rc = WaveStreamNext(wav, &data, len - total);
+        if (rc < 0) {
+            return total > 0 ? total : -1;
+        } else if (rc == 0) {
+            break;
+        } else if (SDL_AudioStreamPut(stream, data, rc) < 0) {
+            wav->frame -= rc / wav->framesize;
+            return total > 0 ? total : -1;
+        }
+        total += rc;
+    }
+
+    return total;
+}
+
+int
+SDL_WAVStreamSeek(SDL_WAVStream *wav, Sint64 frame)
+{
+    if (wav == NULL) {
+        return SDL_InvalidParamError("wav");
+    }
+
+    /* The block that holds the frame gets decoded on the next read. */
+    wav->frame = SDL_max(SDL_min(frame, wav->file.sampleframes), 0);
+    return 0;
+}
+
+void
+SDL_CloseWAVStream(SDL_WAVStream *wav)
+{
+    if (wav == NULL) {
+        return;
+    }
+
+    if (wav->freesrc) {
+        SDL_RWclose(wav->src);
+    } else {
+        SDL_RWseek(wav->src, wav->endposition, RW_SEEK_SET);
+    }
+    WaveFreeChunkData(&wav->file.chunk);
+    SDL_free(wav->file.decoderdata);
+    SDL_free(wav->cstate);
+    SDL_free(wav->input);
+    SDL_free(wav->output);
+    SDL_free(wav);
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
@@ -39,6 +39,9 @@
 
 #include "SDL_cpuinfo.h"
 #include "SDL_assert.h"
+#include "SDL_atomic.h"
+#include "SDL_hints.h"
+#include "SDL_cpuinfo_c.h"
 
 #ifdef HAVE_SYSCONF
 #include <unistd.h>
@@ -83,6 +86,15 @@
 #endif
 #endif
 
+#if defined(__LINUX__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#if defined(MAP_ANONYMOUS) && defined(MADV_HUGEPAGE)
+#define SDL_SIMD_HUGEPAGES 1
+#endif
+#endif
+
 #define CPU_HAS_RDTSC   (1 << 0)
 #define CPU_HAS_ALTIVEC (1 << 1)
 #define CPU_HAS_MMX     (1 << 2)
@@ -611,6 +623,59 @@ SDL_GetCPUCacheLineSize(void)
     }
 }
 
+static int SDL_CPUCacheSize = 0;
+
+int
+SDL_GetCPUCacheSize(void)
+{
+    if (!SDL_CPUCacheSize) {
+#ifndef SDL_CPUINFO_DISABLED
+#if defined(HAVE_SYSCONF) && defined(_SC_LEVEL3_CACHE_SIZE)
+        if (SDL_CPUCacheSize <= 0) {
+            SDL_CPUCacheSize = (int)sysconf(_SC_LEVEL3_CACHE_SIZE);
+        }
+#endif
+#if defined(HAVE_SYSCONF) && defined(_SC_LEVEL2_CACHE_SIZE)
+        if (SDL_CPUCacheSize <= 0) {
+            SDL_CPUCacheSize = (int)sysconf(_SC_LEVEL2_CACHE_SIZE);
+        }
+#endif
+#ifdef HAVE_SYSCTLBYNAME
+        if (SDL_CPUCacheSize <= 0) {
+            Uint64 cachesize = 0;
+            size_t len = sizeof(cachesize);
+            if (sysctlbyname("hw.l3cachesize", &cachesize, &len, NULL, 0) == 0 ||
+                sysctlbyname("hw.l2cachesize", &cachesize, &len, NULL, 0) == 0) {
+                SDL_CPUCacheSize = (int)cachesize;
+            }
+        }
+#endif
+        if (SDL_CPUCacheSize <= 0) {
+            CPU_calcCPUIDFeatures();
+            if (CPU_CPUIDMaxFunction > 0) {
+                int a, b, c, d;
+                cpuid(0x80000000, a, b, c, d);
+                if ((unsigned int)a >= 0x80000006) {
+                    cpuid(0x80000006, a, b, c, d);
+                    if ((d >> 18) & 0x3fff) {
+                        /* L3 size in 512KB units (AMD) */
+                        SDL_CPUCacheSize = ((d >> 18) & 0x3fff) * 512 * 1024;
+                    } else {
+                        /* L2 size in KB */
+                        SDL_CPUCacheSize = ((c >> 16) & 0xffff) * 1024;
+                    }
+                }
+            }
+        }
+#endif
+        /* Just make a guess here... */
+        if (SDL_CPUCacheSize <= 0) {
+            SDL_CPUCacheSize = 1024 * 1024;
+        }
+    }
+    return SDL_CPUCacheSize;
+}
+
 static Uint32 SDL_CPUFeatures = 0xFFFFFFFF;
 static Uint32 SDL_SIMDAlignment = 0xFFFFFFFF;
 
@@ -819,6 +884,100 @@ SDL_SIMDGetAlignment(void)
     return SDL_SIMDAlignment;
 }
 
+#if SDL_SIMD_HUGEPAGES
+/* Blocks this large are mapped directly so they can be backed by huge pages */
+#define SDL_SIMD_HUGEPAGE_THRESHOLD (4 * 1024 * 1024)
+#define SDL_SIMD_HUGEPAGE_SIZE      (2 * 1024 * 1024)
+
+/* The hints are followed with callbacks, since any thread can allocate */
+static SDL_atomic_t SDL_SIMDHintsWatched;
+static SDL_atomic_t SDL_SIMDHugePages;
+static SDL_atomic_t SDL_SIMDNumaLocal;
+
+static void SDLCALL
+SDL_SIMDHugePagesChanged(void *userdata, const char *name, const char *oldValue, const char *hint)
+{
+    SDL_AtomicSet(&SDL_SIMDHugePages, (hint && *hint) ? SDL_atoi(hint) : 0);
+}
+
+static void SDLCALL
+SDL_SIMDNumaLocalChanged(void *userdata, const char *name, const char *oldValue, const char *hint)
+{
+    SDL_AtomicSet(&SDL_SIMDNumaLocal, (hint && *hint && *hint != '0' && SDL_strcasecmp(hint, "false") != 0));
+}
+
+static void
+SDL_SIMDBindToLocalNode(void *addr, size_t len)
+{
+#if defined(SYS_mbind) && defined(SYS_getcpu)
+    unsigned int cpu, node;
+    unsigned long nodemask;
+
+    if (syscall(SYS_getcpu, &cpu, &node, NULL) == 0 && node < sizeof (nodemask) * 8) {
+        /* MPOL_PREFERRED: take pages from this node while it has any free */
+        nodemask = 1UL << node;
+        syscall(SYS_mbind, addr, len, 1, &nodemask, sizeof (nodemask) * 8, 0);
+    }
+#endif
+}
+
+/* Map len bytes on a huge page boundary, storing the mapping size at the start */
+static Uint8 *
+SDL_SIMDAllocHuge(const size_t len)
+{
+    const size_t pagesize = (size_t) sysconf(_SC_PAGESIZE);
+    size_t mapped;
+    Uint8 *base = (Uint8 *) MAP_FAILED;
+    int mode;
+
+    if (SDL_AtomicCAS(&SDL_SIMDHintsWatched, 0, 1)) {
+        SDL_AddHintCallback(SDL_HINT_SIMD_HUGEPAGES, SDL_SIMDHugePagesChanged, NULL);
+        SDL_AddHintCallback(SDL_HINT_SIMD_NUMA_LOCAL, SDL_SIMDNumaLocalChanged, NULL);
+    }
+    mode = SDL_AtomicGet(&SDL_SIMDHugePages);
+    if (mode <= 0) {
+        return NULL;
+    }
+
+#ifdef MAP_HUGETLB
+    if (mode >= 2) {
+        /* This fails unless huge pages have been reserved in /proc/sys/vm/nr_hugepages */
+        mapped = (len + SDL_SIMD_HUGEPAGE_SIZE - 1) & ~((size_t) SDL_SIMD_HUGEPAGE_SIZE - 1);
+        base = (Uint8 *) mmap(NULL, mapped, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    }
+#endif
+    if (base == (Uint8 *) MAP_FAILED) {
+        /* Map an extra huge page and trim it so the block starts on a huge
+           page boundary; a partial huge page at the end uses small pages. */
+        Uint8 *ptr;
+        size_t lead;
+
+        mapped = (len + pagesize - 1) & ~(pagesize - 1);
+        ptr = (Uint8 *) mmap(NULL, mapped + SDL_SIMD_HUGEPAGE_SIZE, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == (Uint8 *) MAP_FAILED) {
+            return NULL;
+        }
+        lead = (SDL_SIMD_HUGEPAGE_SIZE - ((size_t) ptr % SDL_SIMD_HUGEPAGE_SIZE)) % SDL_SIMD_HUGEPAGE_SIZE;
+        if (lead) {
+            munmap(ptr, lead);
+        }
+        munmap(ptr + lead + mapped, SDL_SIMD_HUGEPAGE_SIZE - lead);
+        base = ptr + lead;
+        madvise(base, mapped, MADV_HUGEPAGE);
+    }
+
+    /* Nothing has been touched yet, so every page will come from the preferred node */
+    if (SDL_AtomicGet(&SDL_SIMDNumaLocal)) {
+        SDL_SIMDBindToLocalNode(base, mapped);
+    }
+
+    *(size_t *) base = mapped;
+    return base;
+}
+#endif /* SDL_SIMD_HUGEPAGES */
+
 void *
 SDL_SIMDAlloc(const size_t len)
 {
@@ -826,7 +985,24 @@ SDL_SIMDAlloc(const size_t len)
     const size_t padding = alignment - (len % alignment);
     const size_t padded = (padding != alignment) ? (len + padding) : len;
     Uint8 *retval = NULL;
-    Uint8 *ptr = (Uint8 *) SDL_malloc(padded + alignment + sizeof (void *));
+    Uint8 *ptr;
+
+#if SDL_SIMD_HUGEPAGES
+    if (padded >= SDL_SIMD_HUGEPAGE_THRESHOLD) {
+        /* the mapping size goes first, and the mapping pointer, tagged in its
+           low bit, right before our aligned pointer, so SDL_SIMDFree() knows
+           to unmap it. */
+        const size_t header = ((sizeof (size_t) + sizeof (void *) + alignment - 1) / alignment) * alignment;
+        ptr = SDL_SIMDAllocHuge(header + padded);
+        if (ptr) {
+            retval = ptr + header;
+            *(((void **) retval) - 1) = (void *) ((size_t) ptr | 1);
+            return retval;
+        }
+    }
+#endif
+
+    ptr = (Uint8 *) SDL_malloc(padded + alignment + sizeof (void *));
     if (ptr) {
         /* store the actual malloc pointer right before our aligned pointer. */
         retval = ptr + sizeof (void *);
@@ -840,10 +1016,29 @@ void
 SDL_SIMDFree(void *ptr)
 {
     if (ptr) {
-        void **realptr = (void **) ptr;
-        realptr--;
-        SDL_free(*(((void **) ptr) - 1));
+        void *realptr = *(((void **) ptr) - 1);
+#if SDL_SIMD_HUGEPAGES
+        if ((size_t) realptr & 1) {
+            Uint8 *base = (Uint8 *) ((size_t) realptr & ~(size_t) 1);
+            munmap(base, *(size_t *) base);
+            return;
+        }
+#endif
+        SDL_free(realptr);
+    }
+}
+
+void
+SDL_QuitSIMDAlloc(void)
+{
+#if SDL_SIMD_HUGEPAGES
+    if (SDL_AtomicCAS(&SDL_SIMDHintsWatched, 1, 0)) {
+        SDL_DelHintCallback(SDL_HINT_SIMD_HUGEPAGES, SDL_SIMDHugePagesChanged, NULL);
+        SDL_DelHintCallback(SDL_HINT_SIMD_NUMA_LOCAL, SDL_SIMDNumaLocalChanged, NULL);
     }
+    SDL_AtomicSet(&SDL_SIMDHugePages, 0);
+    SDL_AtomicSet(&SDL_SIMDNumaLocal, 0);
+#endif
 }
 
 
@@ -858,6 +1053,7 @@ main()
     printf("CPU type: %s\n", SDL_GetCPUType());
     printf("CPU name: %s\n", SDL_GetCPUName());
     printf("CacheLine size: %d\n", SDL_GetCPUCacheLineSize());
+    printf("Cache size: %d\n", SDL_GetCPUCacheSize());
     printf("RDTSC: %d\n", SDL_HasRDTSC());
     printf("Altivec: %d\n", SDL_HasAltiVec());
     printf("MMX: %d\n", SDL_HasMMX());
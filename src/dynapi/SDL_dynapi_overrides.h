@@ -724,3 +724,30 @@
 #define SDL_RWwrite SDL_RWwrite_REAL
 #define SDL_RWclose SDL_RWclose_REAL
 #define SDL_LoadFile SDL_LoadFile_REAL
+#define SDL_PremultiplyAlpha SDL_PremultiplyAlpha_REAL
+#define SDL_PrepareSurfaceRLE SDL_PrepareSurfaceRLE_REAL
+#define SDL_UpdateNVTexture SDL_UpdateNVTexture_REAL
+#define SDL_LockTexturePlanes SDL_LockTexturePlanes_REAL
+#define SDL_TrimSurfacePool SDL_TrimSurfacePool_REAL
+#define SDL_GetSurfacePoolStats SDL_GetSurfacePoolStats_REAL
+#define SDL_AudioStreamSetResampleQuality SDL_AudioStreamSetResampleQuality_REAL
+#define SDL_GetQueuedAudioStats SDL_GetQueuedAudioStats_REAL
+#define SDL_NewAudioVoice SDL_NewAudioVoice_REAL
+#define SDL_AudioVoicePut SDL_AudioVoicePut_REAL
+#define SDL_AudioVoiceQueued SDL_AudioVoiceQueued_REAL
+#define SDL_PlayAudioVoice SDL_PlayAudioVoice_REAL
+#define SDL_StopAudioVoice SDL_StopAudioVoice_REAL
+#define SDL_SetAudioVoiceGain SDL_SetAudioVoiceGain_REAL
+#define SDL_SetAudioVoicePan SDL_SetAudioVoicePan_REAL
+#define SDL_FreeAudioVoice SDL_FreeAudioVoice_REAL
+#define SDL_GetAudioDeviceStats SDL_GetAudioDeviceStats_REAL
+#define SDL_OpenWAVStream_RW SDL_OpenWAVStream_RW_REAL
+#define SDL_WAVStreamLength SDL_WAVStreamLength_REAL
+#define SDL_WAVStreamTell SDL_WAVStreamTell_REAL
+#define SDL_WAVStreamRead SDL_WAVStreamRead_REAL
+#define SDL_WAVStreamPut SDL_WAVStreamPut_REAL
+#define SDL_WAVStreamSeek SDL_WAVStreamSeek_REAL
+#define SDL_CloseWAVStream SDL_CloseWAVStream_REAL
+#define SDL_ConvertAudioBatch SDL_ConvertAudioBatch_REAL
+#define SDL_GetYUVTextureCopyBytes SDL_GetYUVTextureCopyBytes_REAL
+#define SDL_CoalesceRects SDL_CoalesceRects_REAL
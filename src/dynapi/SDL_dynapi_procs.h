@@ -780,3 +780,30 @@ SDL_DYNAPI_PROC(size_t,SDL_RWread,(SDL_RWops *a, void *b, size_t c, size_t d),(a
 SDL_DYNAPI_PROC(size_t,SDL_RWwrite,(SDL_RWops *a, const void *b, size_t c, size_t d),(a,b,c,d),return)
 SDL_DYNAPI_PROC(int,SDL_RWclose,(SDL_RWops *a),(a),return)
 SDL_DYNAPI_PROC(void*,SDL_LoadFile,(const char *a, size_t *b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_PremultiplyAlpha,(int a, int b, Uint32 c, const void *d, int e, Uint32 f, void *g, int h),(a,b,c,d,e,f,g,h),return)
+SDL_DYNAPI_PROC(int,SDL_PrepareSurfaceRLE,(SDL_Surface *a, SDL_Surface *b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_UpdateNVTexture,(SDL_Texture *a, const SDL_Rect *b, const Uint8 *c, int d, const Uint8 *e, int f),(a,b,c,d,e,f),return)
+SDL_DYNAPI_PROC(int,SDL_LockTexturePlanes,(SDL_Texture *a, const SDL_Rect *b, Uint8 **c, int *d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(void,SDL_TrimSurfacePool,(size_t a),(a),)
+SDL_DYNAPI_PROC(void,SDL_GetSurfacePoolStats,(Uint64 *a, Uint64 *b, size_t *c),(a,b,c),)
+SDL_DYNAPI_PROC(int,SDL_AudioStreamSetResampleQuality,(SDL_AudioStream *a, SDL_AudioResampleQuality b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_GetQueuedAudioStats,(SDL_AudioDeviceID a, Uint32 *b, Uint32 *c),(a,b,c),return)
+SDL_DYNAPI_PROC(SDL_AudioVoice*,SDL_NewAudioVoice,(SDL_AudioDeviceID a, SDL_AudioFormat b, Uint8 c, int d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(int,SDL_AudioVoicePut,(SDL_AudioVoice *a, const void *b, Uint32 c),(a,b,c),return)
+SDL_DYNAPI_PROC(Uint32,SDL_AudioVoiceQueued,(SDL_AudioVoice *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_PlayAudioVoice,(SDL_AudioVoice *a),(a),return)
+SDL_DYNAPI_PROC(void,SDL_StopAudioVoice,(SDL_AudioVoice *a),(a),)
+SDL_DYNAPI_PROC(void,SDL_SetAudioVoiceGain,(SDL_AudioVoice *a, float b),(a,b),)
+SDL_DYNAPI_PROC(void,SDL_SetAudioVoicePan,(SDL_AudioVoice *a, float b),(a,b),)
+SDL_DYNAPI_PROC(void,SDL_FreeAudioVoice,(SDL_AudioVoice *a),(a),)
+SDL_DYNAPI_PROC(int,SDL_GetAudioDeviceStats,(SDL_AudioDeviceID a, SDL_AudioDeviceStats *b),(a,b),return)
+SDL_DYNAPI_PROC(SDL_WAVStream*,SDL_OpenWAVStream_RW,(SDL_RWops *a, int b, SDL_AudioSpec *c),(a,b,c),return)
+SDL_DYNAPI_PROC(Sint64,SDL_WAVStreamLength,(SDL_WAVStream *a),(a),return)
+SDL_DYNAPI_PROC(Sint64,SDL_WAVStreamTell,(SDL_WAVStream *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_WAVStreamRead,(SDL_WAVStream *a, void *b, int c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_WAVStreamPut,(SDL_WAVStream *a, SDL_AudioStream *b, int c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_WAVStreamSeek,(SDL_WAVStream *a, Sint64 b),(a,b),return)
+SDL_DYNAPI_PROC(void,SDL_CloseWAVStream,(SDL_WAVStream *a),(a),)
+SDL_DYNAPI_PROC(int,SDL_ConvertAudioBatch,(SDL_AudioCVT *a, int b),(a,b),return)
+SDL_DYNAPI_PROC(Uint64,SDL_GetYUVTextureCopyBytes,(void),(),return)
+SDL_DYNAPI_PROC(int,SDL_CoalesceRects,(int a, int b, SDL_Rect *c, int d),(a,b,c,d),return)
@@ -28,6 +28,8 @@
 #include "SDL_render.h"
 #include "SDL_sysrender.h"
 #include "software/SDL_render_sw_c.h"
+#include "../video/SDL_yuv_c.h"
+#include "../video/SDL_blockcompress_c.h"
 
 #if defined(__ANDROID__)
 #  include "../core/android/SDL_android.h"
@@ -67,10 +69,18 @@
     SDL_COMPOSE_BLENDMODE(SDL_BLENDFACTOR_SRC_ALPHA, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD, \
                           SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD)
 
+#define SDL_BLENDMODE_BLEND_PREMULTIPLIED_FULL \
+    SDL_COMPOSE_BLENDMODE(SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD, \
+                          SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD)
+
 #define SDL_BLENDMODE_ADD_FULL \
     SDL_COMPOSE_BLENDMODE(SDL_BLENDFACTOR_SRC_ALPHA, SDL_BLENDFACTOR_ONE, SDL_BLENDOPERATION_ADD, \
                           SDL_BLENDFACTOR_ZERO, SDL_BLENDFACTOR_ONE, SDL_BLENDOPERATION_ADD)
 
+#define SDL_BLENDMODE_ADD_PREMULTIPLIED_FULL \
+    SDL_COMPOSE_BLENDMODE(SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE, SDL_BLENDOPERATION_ADD, \
+                          SDL_BLENDFACTOR_ZERO, SDL_BLENDFACTOR_ONE, SDL_BLENDOPERATION_ADD)
+
 #define SDL_BLENDMODE_MOD_FULL \
     SDL_COMPOSE_BLENDMODE(SDL_BLENDFACTOR_ZERO, SDL_BLENDFACTOR_SRC_COLOR, SDL_BLENDOPERATION_ADD, \
                           SDL_BLENDFACTOR_ZERO, SDL_BLENDFACTOR_ONE, SDL_BLENDOPERATION_ADD)
@@ -1063,7 +1073,7 @@ IsSupportedFormat(SDL_Renderer * renderer, Uint32 format)
             return SDL_TRUE;
         }
     }
-    return SDL_FALSE;
+    return renderer->SupportsTextureFormat && renderer->SupportsTextureFormat(renderer, format);
 }
 
 static Uint32
@@ -1071,7 +1081,20 @@ GetClosestSupportedFormat(SDL_Renderer * renderer, Uint32 format)
 {
     Uint32 i;
 
-    if (SDL_ISPIXELFORMAT_FOURCC(format)) {
+    if (SDL_ISPIXELFORMAT_COMPRESSED(format)) {
+        /* Compressed formats are decoded to ARGB8888, so prefer that */
+        for (i = 0; i < renderer->info.num_texture_formats; ++i) {
+            if (renderer->info.texture_formats[i] == SDL_PIXELFORMAT_ARGB8888) {
+                return renderer->info.texture_formats[i];
+            }
+        }
+        for (i = 0; i < renderer->info.num_texture_formats; ++i) {
+            if (!SDL_ISPIXELFORMAT_FOURCC(renderer->info.texture_formats[i]) &&
+                SDL_ISPIXELFORMAT_ALPHA(renderer->info.texture_formats[i])) {
+                return renderer->info.texture_formats[i];
+            }
+        }
+    } else if (SDL_ISPIXELFORMAT_FOURCC(format)) {
         /* Look for an exact match */
         for (i = 0; i < renderer->info.num_texture_formats; ++i) {
             if (renderer->info.texture_formats[i] == format) {
@@ -1130,6 +1153,10 @@ SDL_CreateTexture(SDL_Renderer * renderer, Uint32 format, int access, int w, int
         SDL_SetError("Texture dimensions can't be 0");
         return NULL;
     }
+    if (SDL_ISPIXELFORMAT_COMPRESSED(format) && access != SDL_TEXTUREACCESS_STATIC) {
+        SDL_SetError("Compressed textures must be created with SDL_TEXTUREACCESS_STATIC");
+        return NULL;
+    }
     if ((renderer->info.max_texture_width && w > renderer->info.max_texture_width) ||
         (renderer->info.max_texture_height && h > renderer->info.max_texture_height)) {
         SDL_SetError("Texture dimensions are limited to %dx%d", renderer->info.max_texture_width, renderer->info.max_texture_height);
@@ -1184,7 +1211,9 @@ SDL_CreateTexture(SDL_Renderer * renderer, Uint32 format, int access, int w, int
         texture->next = texture->native;
         renderer->textures = texture;
 
-        if (SDL_ISPIXELFORMAT_FOURCC(texture->format)) {
+        if (SDL_ISPIXELFORMAT_COMPRESSED(texture->format)) {
+            /* The blocks are decoded into the native texture as they're updated */
+        } else if (SDL_ISPIXELFORMAT_FOURCC(texture->format)) {
             texture->yuv = SDL_SW_CreateYUVTexture(format, w, h);
             if (!texture->yuv) {
                 SDL_DestroyTexture(texture);
@@ -1317,7 +1346,7 @@ SDL_CreateTextureFromSurface(SDL_Renderer * renderer, SDL_Surface * surface)
            SDL_DestroyTexture(texture);
            return NULL;
         }
-        temp = SDL_ConvertSurface(surface, dst_fmt, 0);
+        temp = SDL_ConvertSurface(surface, dst_fmt, surface->flags & SDL_PREMULTIPLIED);
         SDL_FreeFormat(dst_fmt);
         if (temp) {
             SDL_UpdateTexture(texture, NULL, temp->pixels, temp->pitch);
@@ -1340,7 +1369,9 @@ SDL_CreateTextureFromSurface(SDL_Renderer * renderer, SDL_Surface * surface)
 
         if (SDL_HasColorKey(surface)) {
             /* We converted to a texture with alpha format */
-            SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+            SDL_SetTextureBlendMode(texture, (surface->flags & SDL_PREMULTIPLIED) ?
+                                             SDL_BLENDMODE_BLEND_PREMULTIPLIED :
+                                             SDL_BLENDMODE_BLEND);
         } else {
             SDL_GetSurfaceBlendMode(surface, &blendMode);
             SDL_SetTextureBlendMode(texture, blendMode);
@@ -1464,16 +1495,13 @@ SDL_GetTextureBlendMode(SDL_Texture * texture, SDL_BlendMode *blendMode)
     return 0;
 }
 
+/* Convert the whole software YUV texture into its native texture */
 static int
-SDL_UpdateTextureYUV(SDL_Texture * texture, const SDL_Rect * rect,
-                     const void *pixels, int pitch)
+SDL_UpdateTextureFromSWYUV(SDL_Texture * texture)
 {
     SDL_Texture *native = texture->native;
     SDL_Rect full_rect;
-
-    if (SDL_SW_UpdateYUVTexture(texture->yuv, rect, pixels, pitch) < 0) {
-        return -1;
-    }
+    const SDL_Rect *rect;
 
     full_rect.x = 0;
     full_rect.y = 0;
@@ -1481,6 +1509,10 @@ SDL_UpdateTextureYUV(SDL_Texture * texture, const SDL_Rect * rect,
     full_rect.h = texture->h;
     rect = &full_rect;
 
+    if (!rect->w || !rect->h) {
+        return 0;  /* nothing to do. */
+    }
+
     if (texture->access == SDL_TEXTUREACCESS_STREAMING) {
         /* We can lock the texture and copy to it */
         void *native_pixels = NULL;
@@ -1504,12 +1536,44 @@ SDL_UpdateTextureYUV(SDL_Texture * texture, const SDL_Rect * rect,
             SDL_SW_CopyYUVToRGB(texture->yuv, rect, native->format,
                                 rect->w, rect->h, temp_pixels, temp_pitch);
             SDL_UpdateTexture(native, rect, temp_pixels, temp_pitch);
+            SDL_SW_AddYUVCopyBytes(alloclen);
             SDL_free(temp_pixels);
         }
     }
     return 0;
 }
 
+static int
+SDL_UpdateTextureYUV(SDL_Texture * texture, const SDL_Rect * rect,
+                     const void *pixels, int pitch)
+{
+    if (SDL_SW_UpdateYUVTexture(texture->yuv, rect, pixels, pitch) < 0) {
+        return -1;
+    }
+    return SDL_UpdateTextureFromSWYUV(texture);
+}
+
+/* Compressed textures are updated in whole blocks, except along the right and bottom edges */
+static SDL_bool
+IsBlockAlignedRect(SDL_Texture * texture, const SDL_Rect * rect)
+{
+    int block_w, block_h;
+
+    if (!SDL_GetCompressedBlockSize(texture->format, &block_w, &block_h, NULL)) {
+        return SDL_FALSE;
+    }
+    if ((rect->x % block_w) != 0 || (rect->y % block_h) != 0) {
+        return SDL_FALSE;
+    }
+    if ((rect->w % block_w) != 0 && (rect->x + rect->w) != texture->w) {
+        return SDL_FALSE;
+    }
+    if ((rect->h % block_h) != 0 && (rect->y + rect->h) != texture->h) {
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
 static int
 SDL_UpdateTextureNative(SDL_Texture * texture, const SDL_Rect * rect,
                         const void *pixels, int pitch)
@@ -1576,6 +1640,8 @@ SDL_UpdateTexture(SDL_Texture * texture, const SDL_Rect * rect,
 
     if ((rect->w == 0) || (rect->h == 0)) {
         return 0;  /* nothing to do. */
+    } else if (SDL_ISPIXELFORMAT_COMPRESSED(texture->format) && !IsBlockAlignedRect(texture, rect)) {
+        return SDL_SetError("Compressed texture updates must be aligned to the block size");
     } else if (texture->yuv) {
         return SDL_UpdateTextureYUV(texture, rect, pixels, pitch);
     } else if (texture->native) {
@@ -1595,50 +1661,10 @@ SDL_UpdateTextureYUVPlanar(SDL_Texture * texture, const SDL_Rect * rect,
                            const Uint8 *Uplane, int Upitch,
                            const Uint8 *Vplane, int Vpitch)
 {
-    SDL_Texture *native = texture->native;
-    SDL_Rect full_rect;
-
     if (SDL_SW_UpdateYUVTexturePlanar(texture->yuv, rect, Yplane, Ypitch, Uplane, Upitch, Vplane, Vpitch) < 0) {
         return -1;
     }
-
-    full_rect.x = 0;
-    full_rect.y = 0;
-    full_rect.w = texture->w;
-    full_rect.h = texture->h;
-    rect = &full_rect;
-
-    if (!rect->w || !rect->h) {
-        return 0;  /* nothing to do. */
-    }
-
-    if (texture->access == SDL_TEXTUREACCESS_STREAMING) {
-        /* We can lock the texture and copy to it */
-        void *native_pixels = NULL;
-        int native_pitch = 0;
-
-        if (SDL_LockTexture(native, rect, &native_pixels, &native_pitch) < 0) {
-            return -1;
-        }
-        SDL_SW_CopyYUVToRGB(texture->yuv, rect, native->format,
-                            rect->w, rect->h, native_pixels, native_pitch);
-        SDL_UnlockTexture(native);
-    } else {
-        /* Use a temporary buffer for updating */
-        const int temp_pitch = (((rect->w * SDL_BYTESPERPIXEL(native->format)) + 3) & ~3);
-        const size_t alloclen = rect->h * temp_pitch;
-        if (alloclen > 0) {
-            void *temp_pixels = SDL_malloc(alloclen);
-            if (!temp_pixels) {
-                return SDL_OutOfMemory();
-            }
-            SDL_SW_CopyYUVToRGB(texture->yuv, rect, native->format,
-                                rect->w, rect->h, temp_pixels, temp_pitch);
-            SDL_UpdateTexture(native, rect, temp_pixels, temp_pitch);
-            SDL_free(temp_pixels);
-        }
-    }
-    return 0;
+    return SDL_UpdateTextureFromSWYUV(texture);
 }
 
 int SDL_UpdateYUVTexture(SDL_Texture * texture, const SDL_Rect * rect,
@@ -1704,6 +1730,73 @@ int SDL_UpdateYUVTexture(SDL_Texture * texture, const SDL_Rect * rect,
     }
 }
 
+static int
+SDL_UpdateTextureNVPlanar(SDL_Texture * texture, const SDL_Rect * rect,
+                          const Uint8 *Yplane, int Ypitch,
+                          const Uint8 *UVplane, int UVpitch)
+{
+    if (SDL_SW_UpdateNVTexturePlanar(texture->yuv, rect, Yplane, Ypitch, UVplane, UVpitch) < 0) {
+        return -1;
+    }
+    return SDL_UpdateTextureFromSWYUV(texture);
+}
+
+int SDL_UpdateNVTexture(SDL_Texture * texture, const SDL_Rect * rect,
+                        const Uint8 *Yplane, int Ypitch,
+                        const Uint8 *UVplane, int UVpitch)
+{
+    SDL_Renderer *renderer;
+    SDL_Rect full_rect;
+
+    CHECK_TEXTURE_MAGIC(texture, -1);
+
+    if (!Yplane) {
+        return SDL_InvalidParamError("Yplane");
+    }
+    if (!Ypitch) {
+        return SDL_InvalidParamError("Ypitch");
+    }
+    if (!UVplane) {
+        return SDL_InvalidParamError("UVplane");
+    }
+    if (!UVpitch) {
+        return SDL_InvalidParamError("UVpitch");
+    }
+
+    if (texture->format != SDL_PIXELFORMAT_NV12 &&
+        texture->format != SDL_PIXELFORMAT_NV21) {
+        return SDL_SetError("Texture format must be NV12 or NV21");
+    }
+
+    if (!rect) {
+        full_rect.x = 0;
+        full_rect.y = 0;
+        full_rect.w = texture->w;
+        full_rect.h = texture->h;
+        rect = &full_rect;
+    }
+
+    if (!rect->w || !rect->h) {
+        return 0;  /* nothing to do. */
+    }
+
+    if (texture->yuv) {
+        return SDL_UpdateTextureNVPlanar(texture, rect, Yplane, Ypitch, UVplane, UVpitch);
+    } else {
+        SDL_assert(!texture->native);
+        renderer = texture->renderer;
+        SDL_assert(renderer->UpdateTextureNV);
+        if (renderer->UpdateTextureNV) {
+            if (FlushRenderCommandsIfTextureNeeded(texture) < 0) {
+                return -1;
+            }
+            return renderer->UpdateTextureNV(renderer, texture, rect, Yplane, Ypitch, UVplane, UVpitch);
+        } else {
+            return SDL_Unsupported();
+        }
+    }
+}
+
 static int
 SDL_LockTextureYUV(SDL_Texture * texture, const SDL_Rect * rect,
                    void **pixels, int *pitch)
@@ -1760,6 +1853,46 @@ SDL_LockTexture(SDL_Texture * texture, const SDL_Rect * rect,
     }
 }
 
+int
+SDL_LockTexturePlanes(SDL_Texture * texture, const SDL_Rect * rect,
+                      Uint8 **planes, int *pitches)
+{
+    void *pixels = NULL;
+    int pitch = 0;
+
+    CHECK_TEXTURE_MAGIC(texture, -1);
+
+    if (!planes) {
+        return SDL_InvalidParamError("planes");
+    }
+    if (!pitches) {
+        return SDL_InvalidParamError("pitches");
+    }
+
+    if (SDL_ISPIXELFORMAT_FOURCC(texture->format) && rect &&
+        (rect->x != 0 || rect->y != 0 || rect->w != texture->w || rect->h != texture->h)) {
+        return SDL_SetError("SDL_LockTexturePlanes(): YUV textures only support full surface locks");
+    }
+
+    if (SDL_LockTexture(texture, rect, &pixels, &pitch) < 0) {
+        return -1;
+    }
+
+    if (SDL_ISPIXELFORMAT_FOURCC(texture->format)) {
+        /* The locked pixels use the same contiguous layout as SDL_UpdateTexture() */
+        if (SDL_GetYUVPlaneLayout(texture->h, texture->format, pixels, pitch, planes, pitches) < 0) {
+            SDL_UnlockTexture(texture);
+            return -1;
+        }
+    } else {
+        planes[0] = (Uint8 *)pixels;
+        pitches[0] = pitch;
+        planes[1] = planes[2] = NULL;
+        pitches[1] = pitches[2] = 0;
+    }
+    return 0;
+}
+
 static void
 SDL_UnlockTextureYUV(SDL_Texture * texture)
 {
@@ -3300,9 +3433,15 @@ SDL_GetShortBlendMode(SDL_BlendMode blendMode)
     if (blendMode == SDL_BLENDMODE_BLEND_FULL) {
         return SDL_BLENDMODE_BLEND;
     }
+    if (blendMode == SDL_BLENDMODE_BLEND_PREMULTIPLIED_FULL) {
+        return SDL_BLENDMODE_BLEND_PREMULTIPLIED;
+    }
     if (blendMode == SDL_BLENDMODE_ADD_FULL) {
         return SDL_BLENDMODE_ADD;
     }
+    if (blendMode == SDL_BLENDMODE_ADD_PREMULTIPLIED_FULL) {
+        return SDL_BLENDMODE_ADD_PREMULTIPLIED;
+    }
     if (blendMode == SDL_BLENDMODE_MOD_FULL) {
         return SDL_BLENDMODE_MOD;
     }
@@ -3318,9 +3457,15 @@ SDL_GetLongBlendMode(SDL_BlendMode blendMode)
     if (blendMode == SDL_BLENDMODE_BLEND) {
         return SDL_BLENDMODE_BLEND_FULL;
     }
+    if (blendMode == SDL_BLENDMODE_BLEND_PREMULTIPLIED) {
+        return SDL_BLENDMODE_BLEND_PREMULTIPLIED_FULL;
+    }
     if (blendMode == SDL_BLENDMODE_ADD) {
         return SDL_BLENDMODE_ADD_FULL;
     }
+    if (blendMode == SDL_BLENDMODE_ADD_PREMULTIPLIED) {
+        return SDL_BLENDMODE_ADD_PREMULTIPLIED_FULL;
+    }
     if (blendMode == SDL_BLENDMODE_MOD) {
         return SDL_BLENDMODE_MOD_FULL;
     }
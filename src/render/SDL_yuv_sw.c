@@ -23,10 +23,55 @@
 /* This is the software implementation of the YUV texture support */
 
 #include "SDL_assert.h"
+#include "SDL_atomic.h"
 
 #include "SDL_yuv_sw_c.h"
 
 
+static SDL_SpinLock SDL_SW_YUVCopyLock;
+static Uint64 SDL_SW_YUVCopyBytes;
+
+void
+SDL_SW_AddYUVCopyBytes(size_t bytes)
+{
+    SDL_AtomicLock(&SDL_SW_YUVCopyLock);
+    SDL_SW_YUVCopyBytes += bytes;
+    SDL_AtomicUnlock(&SDL_SW_YUVCopyLock);
+}
+
+Uint64
+SDL_GetYUVTextureCopyBytes(void)
+{
+    Uint64 bytes;
+
+    SDL_AtomicLock(&SDL_SW_YUVCopyLock);
+    bytes = SDL_SW_YUVCopyBytes;
+    SDL_AtomicUnlock(&SDL_SW_YUVCopyLock);
+    return bytes;
+}
+
+/* The number of bytes of YUV data covering rect */
+static size_t
+SDL_SW_YUVRectBytes(Uint32 format, const SDL_Rect * rect)
+{
+    const size_t luma = (size_t)rect->w * rect->h;
+    const size_t chroma = 2 * (size_t)((rect->w + 1) / 2) * ((rect->h + 1) / 2);
+
+    switch (format) {
+    case SDL_PIXELFORMAT_YUY2:
+    case SDL_PIXELFORMAT_UYVY:
+    case SDL_PIXELFORMAT_YVYU:
+        return 4 * (size_t)((rect->w + 1) / 2) * rect->h;
+    case SDL_PIXELFORMAT_P010:
+    case SDL_PIXELFORMAT_P016:
+    case SDL_PIXELFORMAT_I010:
+        return 2 * (luma + chroma);
+    default:
+        return luma + chroma;
+    }
+}
+
+
 SDL_SW_YUVTexture *
 SDL_SW_CreateYUVTexture(Uint32 format, int w, int h)
 {
@@ -40,6 +85,9 @@ SDL_SW_CreateYUVTexture(Uint32 format, int w, int h)
     case SDL_PIXELFORMAT_YVYU:
     case SDL_PIXELFORMAT_NV12:
     case SDL_PIXELFORMAT_NV21:
+    case SDL_PIXELFORMAT_P010:
+    case SDL_PIXELFORMAT_P016:
+    case SDL_PIXELFORMAT_I010:
         break;
     default:
         SDL_SetError("Unsupported YUV format");
@@ -79,6 +127,12 @@ SDL_SW_CreateYUVTexture(Uint32 format, int w, int h)
                 dst_size = sz_plane + sz_plane_chroma + sz_plane_chroma;
                 break;
 
+            case SDL_PIXELFORMAT_P010: /**< Planar mode: Y + U/V interleaved, 16-bit samples (2 planes) */
+            case SDL_PIXELFORMAT_P016: /**< Planar mode: Y + U/V interleaved, 16-bit samples (2 planes) */
+            case SDL_PIXELFORMAT_I010: /**< Planar mode: Y + U + V, 16-bit samples (3 planes) */
+                dst_size = 2 * (sz_plane + sz_plane_chroma + sz_plane_chroma);
+                break;
+
             default:
                 SDL_assert(0 && "We should never get here (caught above)");
                 break;
@@ -117,6 +171,23 @@ SDL_SW_CreateYUVTexture(Uint32 format, int w, int h)
         swdata->planes[1] = swdata->planes[0] + swdata->pitches[0] * h;
         break;
 
+    case SDL_PIXELFORMAT_P010:
+    case SDL_PIXELFORMAT_P016:
+        swdata->pitches[0] = w * 2;
+        swdata->pitches[1] = ((w + 1) / 2) * 4;
+        swdata->planes[0] = swdata->pixels;
+        swdata->planes[1] = swdata->planes[0] + swdata->pitches[0] * h;
+        break;
+
+    case SDL_PIXELFORMAT_I010:
+        swdata->pitches[0] = w * 2;
+        swdata->pitches[1] = ((w + 1) / 2) * 2;
+        swdata->pitches[2] = ((w + 1) / 2) * 2;
+        swdata->planes[0] = swdata->pixels;
+        swdata->planes[1] = swdata->planes[0] + swdata->pitches[0] * h;
+        swdata->planes[2] = swdata->planes[1] + swdata->pitches[1] * ((h + 1) / 2);
+        break;
+
     default:
         SDL_assert(0 && "We should never get here (caught above)");
         break;
@@ -239,7 +310,44 @@ SDL_SW_UpdateYUVTexture(SDL_SW_YUVTexture * swdata, const SDL_Rect * rect,
                 }
             }
         }
+        break;
+    case SDL_PIXELFORMAT_P010:
+    case SDL_PIXELFORMAT_P016:
+    case SDL_PIXELFORMAT_I010:
+        {
+            /* I010 has separate U and V planes, P010 and P016 one plane of U/V pairs */
+            const SDL_bool planar = (swdata->format == SDL_PIXELFORMAT_I010);
+            const int sample_size = planar ? 2 : 4;
+            const int src_pitch_uv = planar ? ((pitch + 2) / 4) * 2 : ((pitch + 3) & ~3);
+            const Uint8 *src;
+            Uint8 *dst;
+            int row, plane;
+            size_t length;
+
+            /* Copy the Y plane */
+            src = (const Uint8 *) pixels;
+            dst = swdata->planes[0] + rect->y * swdata->pitches[0] + rect->x * 2;
+            length = rect->w * 2;
+            for (row = 0; row < rect->h; ++row) {
+                SDL_memcpy(dst, src, length);
+                src += pitch;
+                dst += swdata->pitches[0];
+            }
+
+            /* Copy the chroma planes */
+            length = ((rect->w + 1) / 2) * sample_size;
+            for (plane = 1; plane <= (planar ? 2 : 1); ++plane) {
+                dst = swdata->planes[plane] + (rect->y / 2) * swdata->pitches[plane] + (rect->x / 2) * sample_size;
+                for (row = 0; row < (rect->h + 1) / 2; ++row) {
+                    SDL_memcpy(dst, src, length);
+                    src += src_pitch_uv;
+                    dst += swdata->pitches[plane];
+                }
+            }
+        }
+        break;
     }
+    SDL_SW_AddYUVCopyBytes(SDL_SW_YUVRectBytes(swdata->format, rect));
     return 0;
 }
 
@@ -295,6 +403,41 @@ SDL_SW_UpdateYUVTexturePlanar(SDL_SW_YUVTexture * swdata, const SDL_Rect * rect,
         src += Vpitch;
         dst += (swdata->w + 1)/2;
     }
+    SDL_SW_AddYUVCopyBytes(SDL_SW_YUVRectBytes(swdata->format, rect));
+    return 0;
+}
+
+int
+SDL_SW_UpdateNVTexturePlanar(SDL_SW_YUVTexture * swdata, const SDL_Rect * rect,
+                             const Uint8 *Yplane, int Ypitch,
+                             const Uint8 *UVplane, int UVpitch)
+{
+    const Uint8 *src;
+    Uint8 *dst;
+    int row;
+    size_t length;
+
+    /* Copy the Y plane */
+    src = Yplane;
+    dst = swdata->pixels + rect->y * swdata->w + rect->x;
+    length = rect->w;
+    for (row = 0; row < rect->h; ++row) {
+        SDL_memcpy(dst, src, length);
+        src += Ypitch;
+        dst += swdata->w;
+    }
+
+    /* Copy the UV or VU plane */
+    src = UVplane;
+    dst = swdata->pixels + swdata->h * swdata->w;
+    dst += 2 * (rect->y/2) * ((swdata->w + 1)/2) + 2 * (rect->x/2);
+    length = 2 * ((rect->w + 1) / 2);
+    for (row = 0; row < (rect->h + 1)/2; ++row) {
+        SDL_memcpy(dst, src, length);
+        src += UVpitch;
+        dst += 2 * ((swdata->w + 1)/2);
+    }
+    SDL_SW_AddYUVCopyBytes(SDL_SW_YUVRectBytes(swdata->format, rect));
     return 0;
 }
 
@@ -307,11 +450,14 @@ SDL_SW_LockYUVTexture(SDL_SW_YUVTexture * swdata, const SDL_Rect * rect,
     case SDL_PIXELFORMAT_IYUV:
     case SDL_PIXELFORMAT_NV12:
     case SDL_PIXELFORMAT_NV21:
+    case SDL_PIXELFORMAT_P010:
+    case SDL_PIXELFORMAT_P016:
+    case SDL_PIXELFORMAT_I010:
         if (rect
             && (rect->x != 0 || rect->y != 0 || rect->w != swdata->w
                 || rect->h != swdata->h)) {
             return SDL_SetError
-                ("YV12, IYUV, NV12, NV21 textures only support full surface locks");
+                ("YV12, IYUV, NV12, NV21, P010, P016, I010 textures only support full surface locks");
         }
         break;
     }
@@ -393,9 +539,11 @@ SDL_SW_CopyYUVToRGB(SDL_SW_YUVTexture * swdata, const SDL_Rect * srcrect,
                           target_format, pixels, pitch) < 0) {
         return -1;
     }
+    SDL_SW_AddYUVCopyBytes((size_t)swdata->w * swdata->h * SDL_BYTESPERPIXEL(target_format));
     if (stretch) {
         SDL_Rect rect = *srcrect;
         SDL_SoftStretch(swdata->stretch, &rect, swdata->display, NULL);
+        SDL_SW_AddYUVCopyBytes((size_t)w * h * SDL_BYTESPERPIXEL(target_format));
     }
     return 0;
 }
@@ -28,6 +28,7 @@
 #include "SDL_opengl.h"
 #include "../SDL_sysrender.h"
 #include "SDL_shaders_gl.h"
+#include "../../video/SDL_blockcompress_c.h"
 
 #ifdef __MACOSX__
 #include <OpenGL/OpenGL.h>
@@ -107,6 +108,11 @@ typedef struct
     PFNGLACTIVETEXTUREARBPROC glActiveTextureARB;
     GLint num_texture_units;
 
+    /* Compressed texture support */
+    PFNGLCOMPRESSEDTEXIMAGE2DPROC glCompressedTexImage2D;
+    PFNGLCOMPRESSEDTEXSUBIMAGE2DPROC glCompressedTexSubImage2D;
+    Uint32 compressed_formats;  /* bit i is set if GL_compressed_formats[i] is supported */
+
     PFNGLGENFRAMEBUFFERSEXTPROC glGenFramebuffersEXT;
     PFNGLDELETEFRAMEBUFFERSEXTPROC glDeleteFramebuffersEXT;
     PFNGLFRAMEBUFFERTEXTURE2DEXTPROC glFramebufferTexture2DEXT;
@@ -130,6 +136,9 @@ typedef struct
     int pitch;
     SDL_Rect locked_rect;
 
+    /* Block compressed texture support */
+    SDL_bool compressed;
+
     /* YUV texture support */
     SDL_bool yuv;
     SDL_bool nv12;
@@ -438,6 +447,55 @@ convert_format(GL_RenderData *renderdata, Uint32 pixel_format,
     return SDL_TRUE;
 }
 
+static const struct
+{
+    const char *extension;
+    Uint32 format;
+    GLenum internalFormat;
+} GL_compressed_formats[] = {
+    { "GL_EXT_texture_compression_s3tc", SDL_PIXELFORMAT_BC1, GL_COMPRESSED_RGBA_S3TC_DXT1_EXT },
+    { "GL_EXT_texture_compression_s3tc", SDL_PIXELFORMAT_BC2, GL_COMPRESSED_RGBA_S3TC_DXT3_EXT },
+    { "GL_EXT_texture_compression_s3tc", SDL_PIXELFORMAT_BC3, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT },
+    { "GL_ARB_texture_compression_bptc", SDL_PIXELFORMAT_BC7, GL_COMPRESSED_RGBA_BPTC_UNORM },
+    { "GL_ARB_ES3_compatibility", SDL_PIXELFORMAT_ETC2_RGB8, GL_COMPRESSED_RGB8_ETC2 },
+    { "GL_ARB_ES3_compatibility", SDL_PIXELFORMAT_ETC2_RGB8A1, GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2 },
+    { "GL_ARB_ES3_compatibility", SDL_PIXELFORMAT_ETC2_RGBA8, GL_COMPRESSED_RGBA8_ETC2_EAC },
+    { "GL_KHR_texture_compression_astc_ldr", SDL_PIXELFORMAT_ASTC_4x4, GL_COMPRESSED_RGBA_ASTC_4x4_KHR },
+    { "GL_KHR_texture_compression_astc_ldr", SDL_PIXELFORMAT_ASTC_5x5, GL_COMPRESSED_RGBA_ASTC_5x5_KHR },
+    { "GL_KHR_texture_compression_astc_ldr", SDL_PIXELFORMAT_ASTC_6x6, GL_COMPRESSED_RGBA_ASTC_6x6_KHR },
+    { "GL_KHR_texture_compression_astc_ldr", SDL_PIXELFORMAT_ASTC_8x8, GL_COMPRESSED_RGBA_ASTC_8x8_KHR },
+    { "GL_ARB_texture_compression_rgtc", SDL_PIXELFORMAT_BC4, GL_COMPRESSED_RED_RGTC1 },
+    { "GL_ARB_texture_compression_rgtc", SDL_PIXELFORMAT_BC5, GL_COMPRESSED_RG_RGTC2 }
+};
+
+static SDL_bool
+convert_compressed_format(Uint32 pixel_format, GLenum *internalFormat)
+{
+    int i;
+
+    for (i = 0; i < SDL_arraysize(GL_compressed_formats); ++i) {
+        if (GL_compressed_formats[i].format == pixel_format) {
+            *internalFormat = GL_compressed_formats[i].internalFormat;
+            return SDL_TRUE;
+        }
+    }
+    return SDL_FALSE;
+}
+
+static SDL_bool
+GL_SupportsTextureFormat(SDL_Renderer * renderer, Uint32 format)
+{
+    GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+    int i;
+
+    for (i = 0; i < SDL_arraysize(GL_compressed_formats); ++i) {
+        if (GL_compressed_formats[i].format == format) {
+            return (data->compressed_formats & (1u << i)) ? SDL_TRUE : SDL_FALSE;
+        }
+    }
+    return SDL_FALSE;
+}
+
 static int
 GL_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
 {
@@ -458,8 +516,16 @@ GL_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
         return SDL_SetError("Render targets not supported by OpenGL");
     }
 
-    if (!convert_format(renderdata, texture->format, &internalFormat,
-                        &format, &type)) {
+    if (SDL_ISPIXELFORMAT_COMPRESSED(texture->format)) {
+        if (!renderdata->glCompressedTexImage2D ||
+            !convert_compressed_format(texture->format, &format)) {
+            return SDL_SetError("Texture format %s not supported by OpenGL",
+                                SDL_GetPixelFormatName(texture->format));
+        }
+        internalFormat = format;
+        type = GL_NONE;
+    } else if (!convert_format(renderdata, texture->format, &internalFormat,
+                               &format, &type)) {
         return SDL_SetError("Texture format %s not supported by OpenGL",
                             SDL_GetPixelFormatName(texture->format));
     }
@@ -468,6 +534,7 @@ GL_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
     if (!data) {
         return SDL_OutOfMemory();
     }
+    data->compressed = SDL_ISPIXELFORMAT_COMPRESSED(texture->format);
 
     if (texture->access == SDL_TEXTUREACCESS_STREAMING) {
         size_t size;
@@ -570,7 +637,12 @@ GL_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
     }
     else
 #endif
-    {
+    if (data->compressed) {
+        const GLsizei size = SDL_GetCompressedPitch(texture->format, texture_w) *
+                             SDL_GetCompressedRowCount(texture->format, texture_h);
+        renderdata->glCompressedTexImage2D(textype, 0, internalFormat, texture_w,
+                                           texture_h, 0, size, NULL);
+    } else {
         renderdata->glTexImage2D(textype, 0, internalFormat, texture_w,
                                  texture_h, 0, format, type, NULL);
     }
@@ -655,6 +727,31 @@ GL_UpdateTexture(SDL_Renderer * renderer, SDL_Texture * texture,
 
     renderdata->glEnable(textype);
     renderdata->glBindTexture(textype, data->texture);
+    if (data->compressed) {
+        /* Compressed uploads take tightly packed rows of blocks */
+        const int row_size = SDL_GetCompressedPitch(texture->format, rect->w);
+        const int rows = SDL_GetCompressedRowCount(texture->format, rect->h);
+        Uint8 *packed = NULL;
+
+        if (pitch != row_size) {
+            int row;
+
+            packed = (Uint8 *) SDL_malloc(row_size * rows);
+            if (!packed) {
+                renderdata->glDisable(textype);
+                return SDL_OutOfMemory();
+            }
+            for (row = 0; row < rows; ++row) {
+                SDL_memcpy(packed + row * row_size, (const Uint8 *) pixels + row * pitch, row_size);
+            }
+        }
+        renderdata->glCompressedTexSubImage2D(textype, 0, rect->x, rect->y, rect->w,
+                                              rect->h, data->format, row_size * rows,
+                                              packed ? packed : pixels);
+        SDL_free(packed);
+        renderdata->glDisable(textype);
+        return GL_CheckError("glCompressedTexSubImage2D()", renderer);
+    }
     renderdata->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
     renderdata->glPixelStorei(GL_UNPACK_ROW_LENGTH, (pitch / texturebpp));
     renderdata->glTexSubImage2D(textype, 0, rect->x, rect->y, rect->w,
@@ -740,6 +837,39 @@ GL_UpdateTextureYUV(SDL_Renderer * renderer, SDL_Texture * texture,
     return GL_CheckError("glTexSubImage2D()", renderer);
 }
 
+static int
+GL_UpdateTextureNV(SDL_Renderer * renderer, SDL_Texture * texture,
+                    const SDL_Rect * rect,
+                    const Uint8 *Yplane, int Ypitch,
+                    const Uint8 *UVplane, int UVpitch)
+{
+    GL_RenderData *renderdata = (GL_RenderData *) renderer->driverdata;
+    const GLenum textype = renderdata->textype;
+    GL_TextureData *data = (GL_TextureData *) texture->driverdata;
+
+    GL_ActivateRenderer(renderer);
+
+    renderdata->drawstate.texture = NULL;  /* we trash this state. */
+
+    renderdata->glEnable(textype);
+    renderdata->glBindTexture(textype, data->texture);
+    renderdata->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    renderdata->glPixelStorei(GL_UNPACK_ROW_LENGTH, Ypitch);
+    renderdata->glTexSubImage2D(textype, 0, rect->x, rect->y, rect->w,
+                                rect->h, data->format, data->formattype,
+                                Yplane);
+
+    /* The UV plane is uploaded straight from the caller's memory as 2 byte texels */
+    renderdata->glPixelStorei(GL_UNPACK_ROW_LENGTH, UVpitch / 2);
+    renderdata->glBindTexture(textype, data->utexture);
+    renderdata->glTexSubImage2D(textype, 0, rect->x/2, rect->y/2,
+                                (rect->w + 1)/2, (rect->h + 1)/2,
+                                GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE, UVplane);
+    renderdata->glDisable(textype);
+
+    return GL_CheckError("glTexSubImage2D()", renderer);
+}
+
 static int
 GL_LockTexture(SDL_Renderer * renderer, SDL_Texture * texture,
                const SDL_Rect * rect, void **pixels, int *pitch)
@@ -1029,7 +1159,8 @@ SetCopyState(GL_RenderData *data, const SDL_RenderCommand *cmd)
     const GL_TextureData *texturedata = (GL_TextureData *) texture->driverdata;
     GL_Shader shader;
 
-    if (texture->format == SDL_PIXELFORMAT_ABGR8888 || texture->format == SDL_PIXELFORMAT_ARGB8888) {
+    if (texture->format == SDL_PIXELFORMAT_ABGR8888 || texture->format == SDL_PIXELFORMAT_ARGB8888 ||
+        SDL_ISPIXELFORMAT_COMPRESSED(texture->format)) {
         shader = SHADER_RGBA;
     } else {
         shader = SHADER_RGB;
@@ -1536,6 +1667,7 @@ GL_CreateRenderer(SDL_Window * window, Uint32 flags)
     GLint value;
     Uint32 window_flags;
     int profile_mask = 0, major = 0, minor = 0;
+    int i;
     SDL_bool changed_window = SDL_FALSE;
 
     SDL_GL_GetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, &profile_mask);
@@ -1571,9 +1703,11 @@ GL_CreateRenderer(SDL_Window * window, Uint32 flags)
 
     renderer->GetOutputSize = GL_GetOutputSize;
     renderer->SupportsBlendMode = GL_SupportsBlendMode;
+    renderer->SupportsTextureFormat = GL_SupportsTextureFormat;
     renderer->CreateTexture = GL_CreateTexture;
     renderer->UpdateTexture = GL_UpdateTexture;
     renderer->UpdateTextureYUV = GL_UpdateTextureYUV;
+    renderer->UpdateTextureNV = GL_UpdateTextureNV;
     renderer->LockTexture = GL_LockTexture;
     renderer->UnlockTexture = GL_UnlockTexture;
     renderer->SetRenderTarget = GL_SetRenderTarget;
@@ -1695,6 +1829,38 @@ GL_CreateRenderer(SDL_Window * window, Uint32 flags)
     renderer->info.texture_formats[renderer->info.num_texture_formats++] = SDL_PIXELFORMAT_UYVY;
 #endif
 
+    /* Compressed textures are uploaded as is when the driver can sample them,
+       other compressed formats are decoded to ARGB8888 by SDL_UpdateTexture().
+       The blocks have to line up with the texture edges, so that needs NPOT textures.
+     */
+    if (data->GL_ARB_texture_non_power_of_two_supported) {
+        data->glCompressedTexImage2D = (PFNGLCOMPRESSEDTEXIMAGE2DPROC)
+            SDL_GL_GetProcAddress("glCompressedTexImage2D");
+        data->glCompressedTexSubImage2D = (PFNGLCOMPRESSEDTEXSUBIMAGE2DPROC)
+            SDL_GL_GetProcAddress("glCompressedTexSubImage2D");
+    }
+    if (data->glCompressedTexImage2D && data->glCompressedTexSubImage2D) {
+        /* The table is in order of preference, so if the renderer info runs
+           out of room it's the least common formats that aren't listed. They
+           still get created natively, through GL_SupportsTextureFormat().
+         */
+        for (i = 0; i < SDL_arraysize(GL_compressed_formats); ++i) {
+            if (!SDL_GL_ExtensionSupported(GL_compressed_formats[i].extension)) {
+                continue;
+            }
+            data->compressed_formats |= (1u << i);
+            if (renderer->info.num_texture_formats < SDL_arraysize(renderer->info.texture_formats)) {
+                renderer->info.texture_formats[renderer->info.num_texture_formats++] = GL_compressed_formats[i].format;
+            } else {
+                SDL_LogInfo(SDL_LOG_CATEGORY_RENDER, "OpenGL: %s is supported, but there's no room to list it in the renderer info",
+                            SDL_GetPixelFormatName(GL_compressed_formats[i].format));
+            }
+        }
+    } else {
+        data->glCompressedTexImage2D = NULL;
+        data->glCompressedTexSubImage2D = NULL;
+    }
+
     if (SDL_GL_ExtensionSupported("GL_EXT_framebuffer_object")) {
         data->GL_EXT_framebuffer_object_supported = SDL_TRUE;
         data->glGenFramebuffersEXT = (PFNGLGENFRAMEBUFFERSEXTPROC)
@@ -28,6 +28,8 @@ SDL_PROC(void, glBlendFuncSeparate, (GLenum, GLenum, GLenum, GLenum))
 SDL_PROC(void, glClear, (GLbitfield))
 SDL_PROC(void, glClearColor, (GLclampf, GLclampf, GLclampf, GLclampf))
 SDL_PROC(void, glCompileShader, (GLuint))
+SDL_PROC(void, glCompressedTexImage2D, (GLenum, GLint, GLenum, GLsizei, GLsizei, GLint, GLsizei, const void *))
+SDL_PROC(void, glCompressedTexSubImage2D, (GLenum, GLint, GLint, GLint, GLsizei, GLsizei, GLenum, GLsizei, const void *))
 SDL_PROC(GLuint, glCreateProgram, (void))
 SDL_PROC(GLuint, glCreateShader, (GLenum))
 SDL_PROC(void, glDeleteProgram, (GLuint))
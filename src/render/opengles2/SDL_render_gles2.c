@@ -24,9 +24,11 @@
 
 #include "SDL_assert.h"
 #include "SDL_hints.h"
+#include "SDL_log.h"
 #include "SDL_opengles2.h"
 #include "../SDL_sysrender.h"
 #include "../../video/SDL_blit.h"
+#include "../../video/SDL_blockcompress_c.h"
 #include "SDL_shaders_gles2.h"
 
 /* To prevent unnecessary window recreation,
@@ -59,6 +61,8 @@ typedef struct GLES2_TextureData
     GLenum pixel_type;
     void *pixel_data;
     int pitch;
+    /* Block compressed texture support */
+    SDL_bool compressed;
     /* YUV texture support */
     SDL_bool yuv;
     SDL_bool nv12;
@@ -165,6 +169,7 @@ typedef struct GLES2_RenderData
 #undef SDL_PROC
     GLES2_FBOList *framebuffers;
     GLuint window_framebuffer;
+    Uint32 compressed_formats;  /* bit i is set if GLES2_compressed_formats[i] is supported */
 
     int shader_format_count;
     GLenum *shader_formats;
@@ -1087,12 +1092,14 @@ SetCopyState(SDL_Renderer *renderer, const SDL_RenderCommand *cmd)
     GLES2_RenderData *data = (GLES2_RenderData *) renderer->driverdata;
     GLES2_ImageSource sourceType = GLES2_IMAGESOURCE_TEXTURE_ABGR;
     SDL_Texture *texture = cmd->data.draw.texture;
+    /* Compressed blocks are decoded by the GPU to RGBA, which samples like ABGR8888 */
+    const Uint32 texture_format = SDL_ISPIXELFORMAT_COMPRESSED(texture->format) ? SDL_PIXELFORMAT_ABGR8888 : texture->format;
 
     /* Pick an appropriate shader */
     if (renderer->target) {
         /* Check if we need to do color mapping between the source and render target textures */
-        if (renderer->target->format != texture->format) {
-            switch (texture->format) {
+        if (renderer->target->format != texture_format) {
+            switch (texture_format) {
             case SDL_PIXELFORMAT_ARGB8888:
                 switch (renderer->target->format) {
                 case SDL_PIXELFORMAT_ABGR8888:
@@ -1143,9 +1150,12 @@ SetCopyState(SDL_Renderer *renderer, const SDL_RenderCommand *cmd)
                 break;
             case SDL_PIXELFORMAT_IYUV:
             case SDL_PIXELFORMAT_YV12:
+            case SDL_PIXELFORMAT_I010:
                 sourceType = GLES2_IMAGESOURCE_TEXTURE_YUV;
                 break;
             case SDL_PIXELFORMAT_NV12:
+            case SDL_PIXELFORMAT_P010:
+            case SDL_PIXELFORMAT_P016:
                 sourceType = GLES2_IMAGESOURCE_TEXTURE_NV12;
                 break;
             case SDL_PIXELFORMAT_NV21:
@@ -1161,7 +1171,7 @@ SetCopyState(SDL_Renderer *renderer, const SDL_RenderCommand *cmd)
             sourceType = GLES2_IMAGESOURCE_TEXTURE_ABGR;   /* Texture formats match, use the non color mapping shader (even if the formats are not ABGR) */
         }
     } else {
-        switch (texture->format) {
+        switch (texture_format) {
             case SDL_PIXELFORMAT_ARGB8888:
                 sourceType = GLES2_IMAGESOURCE_TEXTURE_ARGB;
                 break;
@@ -1176,9 +1186,12 @@ SetCopyState(SDL_Renderer *renderer, const SDL_RenderCommand *cmd)
                 break;
             case SDL_PIXELFORMAT_IYUV:
             case SDL_PIXELFORMAT_YV12:
+            case SDL_PIXELFORMAT_I010:
                 sourceType = GLES2_IMAGESOURCE_TEXTURE_YUV;
                 break;
             case SDL_PIXELFORMAT_NV12:
+            case SDL_PIXELFORMAT_P010:
+            case SDL_PIXELFORMAT_P016:
                 sourceType = GLES2_IMAGESOURCE_TEXTURE_NV12;
                 break;
             case SDL_PIXELFORMAT_NV21:
@@ -1391,6 +1404,84 @@ GLES2_DestroyRenderer(SDL_Renderer *renderer)
     SDL_free(renderer);
 }
 
+#ifndef GL_COMPRESSED_RED_RGTC1_EXT
+#define GL_COMPRESSED_RED_RGTC1_EXT 0x8DBB
+#endif
+#ifndef GL_COMPRESSED_RED_GREEN_RGTC2_EXT
+#define GL_COMPRESSED_RED_GREEN_RGTC2_EXT 0x8DBD
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM_EXT
+#define GL_COMPRESSED_RGBA_BPTC_UNORM_EXT 0x8E8C
+#endif
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#endif
+#ifndef GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2
+#define GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2 0x9276
+#endif
+#ifndef GL_COMPRESSED_RGBA8_ETC2_EAC
+#define GL_COMPRESSED_RGBA8_ETC2_EAC 0x9278
+#endif
+
+/* ETC2 is part of OpenGL ES 3.0, the other formats always need an extension */
+static const struct
+{
+    const char *extension;
+    SDL_bool es3_core;
+    Uint32 format;
+    GLenum internalFormat;
+} GLES2_compressed_formats[] = {
+    { "GL_EXT_texture_compression_s3tc", SDL_FALSE, SDL_PIXELFORMAT_BC1, GL_COMPRESSED_RGBA_S3TC_DXT1_EXT },
+    { "GL_EXT_texture_compression_s3tc", SDL_FALSE, SDL_PIXELFORMAT_BC2, GL_COMPRESSED_RGBA_S3TC_DXT3_EXT },
+    { "GL_EXT_texture_compression_s3tc", SDL_FALSE, SDL_PIXELFORMAT_BC3, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT },
+    { "GL_EXT_texture_compression_bptc", SDL_FALSE, SDL_PIXELFORMAT_BC7, GL_COMPRESSED_RGBA_BPTC_UNORM_EXT },
+    { "GL_OES_compressed_ETC2_RGB8_texture", SDL_TRUE, SDL_PIXELFORMAT_ETC2_RGB8, GL_COMPRESSED_RGB8_ETC2 },
+    { "GL_OES_compressed_ETC2_punchthroughA_RGBA8_texture", SDL_TRUE, SDL_PIXELFORMAT_ETC2_RGB8A1, GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2 },
+    { "GL_OES_compressed_ETC2_RGBA8_texture", SDL_TRUE, SDL_PIXELFORMAT_ETC2_RGBA8, GL_COMPRESSED_RGBA8_ETC2_EAC },
+    { "GL_KHR_texture_compression_astc_ldr", SDL_FALSE, SDL_PIXELFORMAT_ASTC_4x4, GL_COMPRESSED_RGBA_ASTC_4x4_KHR },
+    { "GL_KHR_texture_compression_astc_ldr", SDL_FALSE, SDL_PIXELFORMAT_ASTC_5x5, GL_COMPRESSED_RGBA_ASTC_5x5_KHR },
+    { "GL_KHR_texture_compression_astc_ldr", SDL_FALSE, SDL_PIXELFORMAT_ASTC_6x6, GL_COMPRESSED_RGBA_ASTC_6x6_KHR },
+    { "GL_KHR_texture_compression_astc_ldr", SDL_FALSE, SDL_PIXELFORMAT_ASTC_8x8, GL_COMPRESSED_RGBA_ASTC_8x8_KHR },
+    { "GL_EXT_texture_compression_rgtc", SDL_FALSE, SDL_PIXELFORMAT_BC4, GL_COMPRESSED_RED_RGTC1_EXT },
+    { "GL_EXT_texture_compression_rgtc", SDL_FALSE, SDL_PIXELFORMAT_BC5, GL_COMPRESSED_RED_GREEN_RGTC2_EXT }
+};
+
+static SDL_bool
+GLES2_GetCompressedFormat(Uint32 pixel_format, GLenum *internalFormat)
+{
+    int i;
+
+    for (i = 0; i < SDL_arraysize(GLES2_compressed_formats); ++i) {
+        if (GLES2_compressed_formats[i].format == pixel_format) {
+            *internalFormat = GLES2_compressed_formats[i].internalFormat;
+            return SDL_TRUE;
+        }
+    }
+    return SDL_FALSE;
+}
+
+static SDL_bool
+GLES2_SupportsTextureFormat(SDL_Renderer * renderer, Uint32 format)
+{
+    GLES2_RenderData *data = (GLES2_RenderData *)renderer->driverdata;
+    int i;
+
+    for (i = 0; i < SDL_arraysize(GLES2_compressed_formats); ++i) {
+        if (GLES2_compressed_formats[i].format == format) {
+            return (data->compressed_formats & (1u << i)) ? SDL_TRUE : SDL_FALSE;
+        }
+    }
+    return SDL_FALSE;
+}
+
+static SDL_bool
+GLES2_Is16BitYUVFormat(Uint32 format)
+{
+    return (format == SDL_PIXELFORMAT_P010 ||
+            format == SDL_PIXELFORMAT_P016 ||
+            format == SDL_PIXELFORMAT_I010);
+}
+
 static int
 GLES2_CreateTexture(SDL_Renderer *renderer, SDL_Texture *texture)
 {
@@ -1418,6 +1509,10 @@ GLES2_CreateTexture(SDL_Renderer *renderer, SDL_Texture *texture)
     case SDL_PIXELFORMAT_YV12:
     case SDL_PIXELFORMAT_NV12:
     case SDL_PIXELFORMAT_NV21:
+    case SDL_PIXELFORMAT_P010:
+    case SDL_PIXELFORMAT_P016:
+    case SDL_PIXELFORMAT_I010:
+        /* 16-bit formats are narrowed to NV12 or IYUV when they're uploaded */
         format = GL_LUMINANCE;
         type = GL_UNSIGNED_BYTE;
         break;
@@ -1428,7 +1523,12 @@ GLES2_CreateTexture(SDL_Renderer *renderer, SDL_Texture *texture)
         break;
 #endif
     default:
-        return SDL_SetError("Texture format not supported");
+        if (!SDL_ISPIXELFORMAT_COMPRESSED(texture->format) ||
+            !GLES2_GetCompressedFormat(texture->format, &format)) {
+            return SDL_SetError("Texture format not supported");
+        }
+        type = GL_NONE;
+        break;
     }
 
     if (texture->format == SDL_PIXELFORMAT_EXTERNAL_OES &&
@@ -1449,8 +1549,11 @@ GLES2_CreateTexture(SDL_Renderer *renderer, SDL_Texture *texture)
 #endif
     data->pixel_format = format;
     data->pixel_type = type;
-    data->yuv = ((texture->format == SDL_PIXELFORMAT_IYUV) || (texture->format == SDL_PIXELFORMAT_YV12));
-    data->nv12 = ((texture->format == SDL_PIXELFORMAT_NV12) || (texture->format == SDL_PIXELFORMAT_NV21));
+    data->compressed = SDL_ISPIXELFORMAT_COMPRESSED(texture->format);
+    data->yuv = ((texture->format == SDL_PIXELFORMAT_IYUV) || (texture->format == SDL_PIXELFORMAT_YV12) ||
+                 (texture->format == SDL_PIXELFORMAT_I010));
+    data->nv12 = ((texture->format == SDL_PIXELFORMAT_NV12) || (texture->format == SDL_PIXELFORMAT_NV21) ||
+                  (texture->format == SDL_PIXELFORMAT_P010) || (texture->format == SDL_PIXELFORMAT_P016));
     data->texture_u = 0;
     data->texture_v = 0;
     scaleMode = (texture->scaleMode == SDL_ScaleModeNearest) ? GL_NEAREST : GL_LINEAR;
@@ -1460,7 +1563,10 @@ GLES2_CreateTexture(SDL_Renderer *renderer, SDL_Texture *texture)
         size_t size;
         data->pitch = texture->w * SDL_BYTESPERPIXEL(texture->format);
         size = texture->h * data->pitch;
-        if (data->yuv) {
+        if (GLES2_Is16BitYUVFormat(texture->format)) {
+            /* Need to add size for the 16-bit chroma samples */
+            size += ((texture->h + 1) / 2) * (((texture->w + 1) / 2) * 4);
+        } else if (data->yuv) {
             /* Need to add size for the U and V planes */
             size += 2 * ((texture->h + 1) / 2) * ((data->pitch + 1) / 2);
         } else if (data->nv12) {
@@ -1532,7 +1638,14 @@ GLES2_CreateTexture(SDL_Renderer *renderer, SDL_Texture *texture)
     renderdata->glTexParameteri(data->texture_type, GL_TEXTURE_MAG_FILTER, scaleMode);
     renderdata->glTexParameteri(data->texture_type, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     renderdata->glTexParameteri(data->texture_type, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    if (texture->format != SDL_PIXELFORMAT_EXTERNAL_OES) {
+    if (data->compressed) {
+        const GLsizei size = SDL_GetCompressedPitch(texture->format, texture->w) *
+                             SDL_GetCompressedRowCount(texture->format, texture->h);
+        renderdata->glCompressedTexImage2D(data->texture_type, 0, format, texture->w, texture->h, 0, size, NULL);
+        if (GL_CheckError("glCompressedTexImage2D()", renderer) < 0) {
+            return -1;
+        }
+    } else if (texture->format != SDL_PIXELFORMAT_EXTERNAL_OES) {
         renderdata->glTexImage2D(data->texture_type, 0, format, texture->w, texture->h, 0, format, type, NULL);
         if (GL_CheckError("glTexImage2D()", renderer) < 0) {
             return -1;
@@ -1591,6 +1704,8 @@ GLES2_UpdateTexture(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect
 {
     GLES2_RenderData *data = (GLES2_RenderData *)renderer->driverdata;
     GLES2_TextureData *tdata = (GLES2_TextureData *)texture->driverdata;
+    Uint8 *narrowed = NULL;
+    int bpp = SDL_BYTESPERPIXEL(texture->format);
 
     GLES2_ActivateRenderer(renderer);
 
@@ -1599,6 +1714,50 @@ GLES2_UpdateTexture(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect
         return 0;
     }
 
+    if (tdata->compressed) {
+        /* Compressed uploads take tightly packed rows of blocks */
+        const int row_size = SDL_GetCompressedPitch(texture->format, rect->w);
+        const int rows = SDL_GetCompressedRowCount(texture->format, rect->h);
+        Uint8 *packed = NULL;
+
+        if (pitch != row_size) {
+            int row;
+
+            packed = (Uint8 *)SDL_malloc(row_size * rows);
+            if (!packed) {
+                return SDL_OutOfMemory();
+            }
+            for (row = 0; row < rows; ++row) {
+                SDL_memcpy(packed + row * row_size, (const Uint8 *)pixels + row * pitch, row_size);
+            }
+        }
+
+        data->drawstate.texture = NULL;  /* we trash this state. */
+
+        data->glBindTexture(tdata->texture_type, tdata->texture);
+        data->glCompressedTexSubImage2D(tdata->texture_type, 0, rect->x, rect->y, rect->w, rect->h,
+                                        tdata->pixel_format, row_size * rows, packed ? packed : pixels);
+        SDL_free(packed);
+        return GL_CheckError("glCompressedTexSubImage2D()", renderer);
+    }
+
+    if (GLES2_Is16BitYUVFormat(texture->format)) {
+        /* The textures hold 8-bit samples, narrow the rect to NV12 or IYUV first */
+        const Uint32 format = tdata->yuv ? SDL_PIXELFORMAT_IYUV : SDL_PIXELFORMAT_NV12;
+
+        narrowed = (Uint8 *)SDL_malloc(rect->w * rect->h + 2 * ((rect->w + 1) / 2) * ((rect->h + 1) / 2));
+        if (!narrowed) {
+            return SDL_OutOfMemory();
+        }
+        if (SDL_ConvertPixels(rect->w, rect->h, texture->format, pixels, pitch, format, narrowed, rect->w) < 0) {
+            SDL_free(narrowed);
+            return -1;
+        }
+        pixels = narrowed;
+        pitch = rect->w;
+        bpp = 1;
+    }
+
     data->drawstate.texture = NULL;  /* we trash this state. */
 
     /* Create a texture subimage with the supplied data */
@@ -1610,7 +1769,7 @@ GLES2_UpdateTexture(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect
                     rect->h,
                     tdata->pixel_format,
                     tdata->pixel_type,
-                    pixels, pitch, SDL_BYTESPERPIXEL(texture->format));
+                    pixels, pitch, bpp);
 
     if (tdata->yuv) {
         /* Skip to the correct offset into the next texture */
@@ -1659,6 +1818,7 @@ GLES2_UpdateTexture(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect
                 pixels, 2 * ((pitch + 1) / 2), 2);
     }
 
+    SDL_free(narrowed);
     return GL_CheckError("glTexSubImage2D()", renderer);
 }
 
@@ -1714,6 +1874,47 @@ GLES2_UpdateTextureYUV(SDL_Renderer * renderer, SDL_Texture * texture,
     return GL_CheckError("glTexSubImage2D()", renderer);
 }
 
+static int
+GLES2_UpdateTextureNV(SDL_Renderer * renderer, SDL_Texture * texture,
+                    const SDL_Rect * rect,
+                    const Uint8 *Yplane, int Ypitch,
+                    const Uint8 *UVplane, int UVpitch)
+{
+    GLES2_RenderData *data = (GLES2_RenderData *)renderer->driverdata;
+    GLES2_TextureData *tdata = (GLES2_TextureData *)texture->driverdata;
+
+    GLES2_ActivateRenderer(renderer);
+
+    /* Bail out if we're supposed to update an empty rectangle */
+    if (rect->w <= 0 || rect->h <= 0) {
+        return 0;
+    }
+
+    data->drawstate.texture = NULL;  /* we trash this state. */
+
+    data->glBindTexture(tdata->texture_type, tdata->texture_u);
+    GLES2_TexSubImage2D(data, tdata->texture_type,
+                    rect->x / 2,
+                    rect->y / 2,
+                    (rect->w + 1) / 2,
+                    (rect->h + 1) / 2,
+                    GL_LUMINANCE_ALPHA,
+                    GL_UNSIGNED_BYTE,
+                    UVplane, UVpitch, 2);
+
+    data->glBindTexture(tdata->texture_type, tdata->texture);
+    GLES2_TexSubImage2D(data, tdata->texture_type,
+                    rect->x,
+                    rect->y,
+                    rect->w,
+                    rect->h,
+                    tdata->pixel_format,
+                    tdata->pixel_type,
+                    Yplane, Ypitch, 1);
+
+    return GL_CheckError("glTexSubImage2D()", renderer);
+}
+
 static int
 GLES2_LockTexture(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect *rect,
                   void **pixels, int *pitch)
@@ -1924,6 +2125,9 @@ GLES2_CreateRenderer(SDL_Window *window, Uint32 flags)
     GLint window_framebuffer;
     GLint value;
     int profile_mask = 0, major = 0, minor = 0;
+    const char *version;
+    SDL_bool es3;
+    int i;
     SDL_bool changed_window = SDL_FALSE;
 
     if (SDL_GL_GetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, &profile_mask) < 0) {
@@ -2059,9 +2263,11 @@ GLES2_CreateRenderer(SDL_Window *window, Uint32 flags)
     renderer->WindowEvent         = GLES2_WindowEvent;
     renderer->GetOutputSize       = GLES2_GetOutputSize;
     renderer->SupportsBlendMode   = GLES2_SupportsBlendMode;
+    renderer->SupportsTextureFormat = GLES2_SupportsTextureFormat;
     renderer->CreateTexture       = GLES2_CreateTexture;
     renderer->UpdateTexture       = GLES2_UpdateTexture;
     renderer->UpdateTextureYUV    = GLES2_UpdateTextureYUV;
+    renderer->UpdateTextureNV     = GLES2_UpdateTextureNV;
     renderer->LockTexture         = GLES2_LockTexture;
     renderer->UnlockTexture       = GLES2_UnlockTexture;
     renderer->SetRenderTarget     = GLES2_SetRenderTarget;
@@ -2084,10 +2290,36 @@ GLES2_CreateRenderer(SDL_Window *window, Uint32 flags)
     renderer->info.texture_formats[renderer->info.num_texture_formats++] = SDL_PIXELFORMAT_IYUV;
     renderer->info.texture_formats[renderer->info.num_texture_formats++] = SDL_PIXELFORMAT_NV12;
     renderer->info.texture_formats[renderer->info.num_texture_formats++] = SDL_PIXELFORMAT_NV21;
+    renderer->info.texture_formats[renderer->info.num_texture_formats++] = SDL_PIXELFORMAT_P010;
+    renderer->info.texture_formats[renderer->info.num_texture_formats++] = SDL_PIXELFORMAT_P016;
+    renderer->info.texture_formats[renderer->info.num_texture_formats++] = SDL_PIXELFORMAT_I010;
 #ifdef GL_TEXTURE_EXTERNAL_OES
     renderer->info.texture_formats[renderer->info.num_texture_formats++] = SDL_PIXELFORMAT_EXTERNAL_OES;
 #endif
 
+    /* Compressed textures are uploaded as is when the driver can sample them,
+       other compressed formats are decoded to ARGB8888 by SDL_UpdateTexture().
+     */
+    version = (const char *)data->glGetString(GL_VERSION);
+    es3 = (version && SDL_strncmp(version, "OpenGL ES ", 10) == 0 && SDL_atoi(version + 10) >= 3);
+    /* The table is in order of preference, so if the renderer info runs out
+       of room it's the least common formats that aren't listed. They still
+       get created natively, through GLES2_SupportsTextureFormat().
+     */
+    for (i = 0; i < SDL_arraysize(GLES2_compressed_formats); ++i) {
+        if (!(es3 && GLES2_compressed_formats[i].es3_core) &&
+            !SDL_GL_ExtensionSupported(GLES2_compressed_formats[i].extension)) {
+            continue;
+        }
+        data->compressed_formats |= (1u << i);
+        if (renderer->info.num_texture_formats < SDL_arraysize(renderer->info.texture_formats)) {
+            renderer->info.texture_formats[renderer->info.num_texture_formats++] = GLES2_compressed_formats[i].format;
+        } else {
+            SDL_LogInfo(SDL_LOG_CATEGORY_RENDER, "OpenGL ES 2: %s is supported, but there's no room to list it in the renderer info",
+                        SDL_GetPixelFormatName(GLES2_compressed_formats[i].format));
+        }
+    }
+
     /* Set up parameters for rendering */
     data->glActiveTexture(GL_TEXTURE0);
     data->glPixelStorei(GL_PACK_ALIGNMENT, 1);
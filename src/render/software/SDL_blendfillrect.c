@@ -223,6 +223,7 @@ SDL_BlendFillRect(SDL_Surface * dst, const SDL_Rect * rect,
         g = DRAW_MUL(g, a);
         b = DRAW_MUL(b, a);
     }
+    blendMode = DRAW_BASE_BLENDMODE(blendMode);
 
     switch (dst->format->BitsPerPixel) {
     case 15:
@@ -283,6 +284,7 @@ SDL_BlendFillRects(SDL_Surface * dst, const SDL_Rect * rects, int count,
         g = DRAW_MUL(g, a);
         b = DRAW_MUL(b, a);
     }
+    blendMode = DRAW_BASE_BLENDMODE(blendMode);
 
     /* FIXME: Does this function pointer slow things down significantly? */
     switch (dst->format->BitsPerPixel) {
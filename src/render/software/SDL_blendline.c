@@ -47,6 +47,7 @@ SDL_BlendLine_RGB2(SDL_Surface * dst, int x1, int y1, int x2, int y2,
         a = _a;
     }
     inva = (a ^ 0xff);
+    blendMode = DRAW_BASE_BLENDMODE(blendMode);
 
     if (y1 == y2) {
         switch (blendMode) {
@@ -138,6 +139,7 @@ SDL_BlendLine_RGB555(SDL_Surface * dst, int x1, int y1, int x2, int y2,
         a = _a;
     }
     inva = (a ^ 0xff);
+    blendMode = DRAW_BASE_BLENDMODE(blendMode);
 
     if (y1 == y2) {
         switch (blendMode) {
@@ -229,6 +231,7 @@ SDL_BlendLine_RGB565(SDL_Surface * dst, int x1, int y1, int x2, int y2,
         a = _a;
     }
     inva = (a ^ 0xff);
+    blendMode = DRAW_BASE_BLENDMODE(blendMode);
 
     if (y1 == y2) {
         switch (blendMode) {
@@ -321,6 +324,7 @@ SDL_BlendLine_RGB4(SDL_Surface * dst, int x1, int y1, int x2, int y2,
         a = _a;
     }
     inva = (a ^ 0xff);
+    blendMode = DRAW_BASE_BLENDMODE(blendMode);
 
     if (y1 == y2) {
         switch (blendMode) {
@@ -413,6 +417,7 @@ SDL_BlendLine_RGBA4(SDL_Surface * dst, int x1, int y1, int x2, int y2,
         a = _a;
     }
     inva = (a ^ 0xff);
+    blendMode = DRAW_BASE_BLENDMODE(blendMode);
 
     if (y1 == y2) {
         switch (blendMode) {
@@ -504,6 +509,7 @@ SDL_BlendLine_RGB888(SDL_Surface * dst, int x1, int y1, int x2, int y2,
         a = _a;
     }
     inva = (a ^ 0xff);
+    blendMode = DRAW_BASE_BLENDMODE(blendMode);
 
     if (y1 == y2) {
         switch (blendMode) {
@@ -595,6 +601,7 @@ SDL_BlendLine_ARGB8888(SDL_Surface * dst, int x1, int y1, int x2, int y2,
         a = _a;
     }
     inva = (a ^ 0xff);
+    blendMode = DRAW_BASE_BLENDMODE(blendMode);
 
     if (y1 == y2) {
         switch (blendMode) {
@@ -217,6 +217,7 @@ SDL_BlendPoint(SDL_Surface * dst, int x, int y, SDL_BlendMode blendMode, Uint8 r
         g = DRAW_MUL(g, a);
         b = DRAW_MUL(b, a);
     }
+    blendMode = DRAW_BASE_BLENDMODE(blendMode);
 
     switch (dst->format->BitsPerPixel) {
     case 15:
@@ -279,6 +280,7 @@ SDL_BlendPoints(SDL_Surface * dst, const SDL_Point * points, int count,
         g = DRAW_MUL(g, a);
         b = DRAW_MUL(b, a);
     }
+    blendMode = DRAW_BASE_BLENDMODE(blendMode);
 
     /* FIXME: Does this function pointer slow things down significantly? */
     switch (dst->format->BitsPerPixel) {
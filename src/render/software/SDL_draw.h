@@ -28,6 +28,13 @@
 
 #define DRAW_MUL(_a, _b) (((unsigned)(_a)*(_b))/255)
 
+/* The premultiplied blend modes take a color that is already multiplied by
+ * alpha, after that they draw exactly like the blend and add cases.
+ */
+#define DRAW_BASE_BLENDMODE(blendMode) \
+    ((blendMode) == SDL_BLENDMODE_BLEND_PREMULTIPLIED ? SDL_BLENDMODE_BLEND : \
+     (blendMode) == SDL_BLENDMODE_ADD_PREMULTIPLIED ? SDL_BLENDMODE_ADD : (blendMode))
+
 #define DRAW_FASTSETPIXEL(type) \
     *pixel = (type) color
 
@@ -649,6 +649,15 @@ SDLTest_PrintPixelFormat(char *text, size_t maxlen, Uint32 format)
     case SDL_PIXELFORMAT_NV21:
         SDL_snprintfcat(text, maxlen, "NV21");
         break;
+    case SDL_PIXELFORMAT_P010:
+        SDL_snprintfcat(text, maxlen, "P010");
+        break;
+    case SDL_PIXELFORMAT_P016:
+        SDL_snprintfcat(text, maxlen, "P016");
+        break;
+    case SDL_PIXELFORMAT_I010:
+        SDL_snprintfcat(text, maxlen, "I010");
+        break;
     default:
         SDL_snprintfcat(text, maxlen, "0x%8.8x", format);
         break;
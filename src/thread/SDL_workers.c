@@ -0,0 +1,217 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+#include "SDL_atomic.h"
+#include "SDL_cpuinfo.h"
+#include "SDL_mutex.h"
+#include "SDL_thread.h"
+#include "SDL_systhread.h"
+#include "SDL_workers_c.h"
+
+/* More than this and the pieces get too small to be worth handing out */
+#define SDL_MAX_WORKERS 16
+
+enum
+{
+    WORKERS_STOPPED,
+    WORKERS_STARTING,
+    WORKERS_RUNNING
+};
+
+typedef struct
+{
+    SDL_mutex *lock;        /* protects everything below */
+    SDL_cond *wake;         /* signaled when a job is posted or the pool quits */
+    SDL_cond *done;         /* signaled when the last piece of a job finishes */
+    SDL_Thread *threads[SDL_MAX_WORKERS];
+    int num_threads;
+    SDL_bool quit;
+    SDL_bool busy;
+    Uint32 generation;
+
+    /* The job currently being run */
+    SDL_WorkerFunc func;
+    void *data;
+    int count;
+    int next;
+    int pending;
+} SDL_WorkerPool;
+
+static SDL_WorkerPool pool;
+static SDL_atomic_t pool_state;
+
+/* Run pieces of the current job until there are none left.
+   This is called and returns with the pool lock held. */
+static void
+SDL_RunWorkerPieces(void)
+{
+    while (pool.next < pool.count) {
+        const SDL_WorkerFunc func = pool.func;
+        void *data = pool.data;
+        const int index = pool.next++;
+
+        SDL_UnlockMutex(pool.lock);
+        func(data, index);
+        SDL_LockMutex(pool.lock);
+
+        if (--pool.pending == 0) {
+            SDL_CondSignal(pool.done);
+        }
+    }
+}
+
+static int SDLCALL
+SDL_WorkerThread(void *unused)
+{
+    Uint32 generation = 0;
+
+    SDL_LockMutex(pool.lock);
+    for ( ; ; ) {
+        while (!pool.quit && pool.generation == generation) {
+            SDL_CondWait(pool.wake, pool.lock);
+        }
+        if (pool.quit) {
+            break;
+        }
+        generation = pool.generation;
+        SDL_RunWorkerPieces();
+    }
+    SDL_UnlockMutex(pool.lock);
+    return 0;
+}
+
+static void
+SDL_DestroyWorkers(void)
+{
+    int i;
+
+    if (pool.lock) {
+        SDL_LockMutex(pool.lock);
+        pool.quit = SDL_TRUE;
+        SDL_CondBroadcast(pool.wake);
+        SDL_UnlockMutex(pool.lock);
+    }
+    for (i = 0; i < pool.num_threads; ++i) {
+        SDL_WaitThread(pool.threads[i], NULL);
+    }
+    if (pool.done) {
+        SDL_DestroyCond(pool.done);
+    }
+    if (pool.wake) {
+        SDL_DestroyCond(pool.wake);
+    }
+    if (pool.lock) {
+        SDL_DestroyMutex(pool.lock);
+    }
+    SDL_zero(pool);
+}
+
+/* Returns SDL_TRUE if the pool is up and running */
+static SDL_bool
+SDL_StartWorkers(void)
+{
+    int state = SDL_AtomicGet(&pool_state);
+
+    if (state == WORKERS_RUNNING) {
+        return SDL_TRUE;
+    }
+    if (state != WORKERS_STOPPED ||
+        !SDL_AtomicCAS(&pool_state, WORKERS_STOPPED, WORKERS_STARTING)) {
+        /* Somebody else is starting the pool, don't wait for them */
+        return SDL_FALSE;
+    }
+
+#if !SDL_THREADS_DISABLED
+    pool.lock = SDL_CreateMutex();
+    pool.wake = SDL_CreateCond();
+    pool.done = SDL_CreateCond();
+    if (pool.lock && pool.wake && pool.done) {
+        int num_threads = SDL_min(SDL_GetCPUCount() - 1, SDL_MAX_WORKERS);
+        while (pool.num_threads < num_threads) {
+            SDL_Thread *thread = SDL_CreateThreadInternal(SDL_WorkerThread, "SDLWorker", 0, NULL);
+            if (!thread) {
+                break;
+            }
+            pool.threads[pool.num_threads++] = thread;
+        }
+    }
+    if (pool.num_threads == 0) {
+        SDL_DestroyWorkers();
+    }
+#endif
+
+    SDL_AtomicSet(&pool_state, WORKERS_RUNNING);
+    return SDL_TRUE;
+}
+
+int
+SDL_GetWorkerCount(void)
+{
+    if (!SDL_StartWorkers()) {
+        return 1;
+    }
+    return pool.num_threads + 1;
+}
+
+void
+SDL_RunOnWorkers(SDL_WorkerFunc func, void *data, int count)
+{
+    int i;
+
+    if (count > 1 && SDL_StartWorkers() && pool.num_threads > 0) {
+        SDL_LockMutex(pool.lock);
+        if (!pool.busy) {
+            pool.busy = SDL_TRUE;
+            pool.func = func;
+            pool.data = data;
+            pool.count = count;
+            pool.next = 0;
+            pool.pending = count;
+            ++pool.generation;
+            SDL_CondBroadcast(pool.wake);
+
+            SDL_RunWorkerPieces();
+            while (pool.pending > 0) {
+                SDL_CondWait(pool.done, pool.lock);
+            }
+            pool.busy = SDL_FALSE;
+            SDL_UnlockMutex(pool.lock);
+            return;
+        }
+        SDL_UnlockMutex(pool.lock);
+    }
+
+    for (i = 0; i < count; ++i) {
+        func(data, i);
+    }
+}
+
+void
+SDL_QuitWorkers(void)
+{
+    if (SDL_AtomicGet(&pool_state) == WORKERS_RUNNING) {
+        SDL_DestroyWorkers();
+        SDL_AtomicSet(&pool_state, WORKERS_STOPPED);
+    }
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,48 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+#ifndef SDL_workers_c_h_
+#define SDL_workers_c_h_
+
+/* A small pool of worker threads that SDL uses internally to split up large
+   pieces of work (fills, conversions, etc.) across the available CPUs.
+   The pool is started the first time it's needed and shut down by SDL_Quit().
+ */
+
+typedef void (*SDL_WorkerFunc)(void *data, int index);
+
+/* Returns how many pieces of work can run at the same time, including the
+   calling thread. This is 1 if there are no worker threads available. */
+extern int SDL_GetWorkerCount(void);
+
+/* Calls func(data, index) for every index from 0 to count-1, spread across
+   the worker threads and the calling thread, and returns once all of them
+   have finished. If the pool is already busy (for example when called from
+   inside a worker function) the calls all run on the calling thread. */
+extern void SDL_RunOnWorkers(SDL_WorkerFunc func, void *data, int count);
+
+/* Stops the worker threads, called from SDL_Quit() */
+extern void SDL_QuitWorkers(void);
+
+#endif /* SDL_workers_c_h_ */
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -370,4 +370,23 @@ SDL_RemoveTimer(SDL_TimerID id)
     return canceled;
 }
 
+#ifndef SDL_TIMER_UNIX  /* the Unix timer can sleep until a deadline itself. */
+void
+SDL_DelayUntilCounter(Uint64 deadline)
+{
+    const Uint64 freq = SDL_GetPerformanceFrequency();
+    Uint64 now = SDL_GetPerformanceCounter();
+
+    /* sleep whole milliseconds until less than one is left. */
+    while (now < deadline) {
+        const Uint64 ms = ((deadline - now) * 1000) / freq;
+        if (ms == 0) {
+            break;
+        }
+        SDL_Delay((Uint32) ms);
+        now = SDL_GetPerformanceCounter();
+    }
+}
+#endif
+
 /* vi: set ts=4 sw=4 expandtab: */
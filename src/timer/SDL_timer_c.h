@@ -35,6 +35,10 @@ extern void SDL_TicksQuit(void);
 extern int SDL_TimerInit(void);
 extern void SDL_TimerQuit(void);
 
+/* Sleeps until SDL_GetPerformanceCounter() reaches (deadline), as closely
+   as the platform allows. */
+extern void SDL_DelayUntilCounter(Uint64 deadline);
+
 #endif /* SDL_timer_c_h_ */
 
 /* vi: set ts=4 sw=4 expandtab: */
@@ -226,6 +226,68 @@ SDL_Delay(Uint32 ms)
     } while (was_error && (errno == EINTR));
 }
 
+/* clock_nanosleep() can sleep until an absolute time, so waking up late
+   from one period doesn't push back the next. */
+#if (HAVE_NANOSLEEP || HAVE_CLOCK_GETTIME) && defined(TIMER_ABSTIME) && defined(_POSIX_TIMERS) && (_POSIX_TIMERS > 0)
+static int
+SDL_AbsoluteSleep(const Uint64 deadline, const Uint64 now)
+{
+    struct timespec ts;
+    clockid_t clk;
+    int rc;
+
+    if (has_monotonic_time) {
+#if HAVE_CLOCK_GETTIME
+        /* the counter might be CLOCK_MONOTONIC_RAW, which can't be slept
+           on, so aim for the same moment on CLOCK_MONOTONIC. */
+        Uint64 ns;
+        clk = CLOCK_MONOTONIC;
+        clock_gettime(clk, &ts);
+        ns = ((Uint64) ts.tv_nsec) + (deadline - now);
+        ts.tv_sec += (time_t) (ns / 1000000000);
+        ts.tv_nsec = (long) (ns % 1000000000);
+#else
+        return -1;  /* mach_absolute_time() has nothing to sleep on. */
+#endif
+    } else {
+        /* the counter is gettimeofday() microseconds, on CLOCK_REALTIME. */
+        clk = CLOCK_REALTIME;
+        ts.tv_sec = (time_t) (deadline / 1000000);
+        ts.tv_nsec = (long) ((deadline % 1000000) * 1000);
+    }
+
+    do {
+        rc = clock_nanosleep(clk, TIMER_ABSTIME, &ts, NULL);
+    } while (rc == EINTR);
+
+    return rc;
+}
+#define HAVE_ABSOLUTE_SLEEP 1
+#endif
+
+void
+SDL_DelayUntilCounter(Uint64 deadline)
+{
+    const Uint64 freq = SDL_GetPerformanceFrequency();
+    Uint64 now = SDL_GetPerformanceCounter();
+
+#if HAVE_ABSOLUTE_SLEEP
+    if ((now < deadline) && (SDL_AbsoluteSleep(deadline, now) == 0)) {
+        return;
+    }
+#endif
+
+    /* sleep whole milliseconds until less than one is left. */
+    while (now < deadline) {
+        const Uint64 ms = ((deadline - now) * 1000) / freq;
+        if (ms == 0) {
+            break;
+        }
+        SDL_Delay((Uint32) ms);
+        now = SDL_GetPerformanceCounter();
+    }
+}
+
 #endif /* SDL_TIMER_UNIX */
 
 /* vi: set ts=4 sw=4 expandtab: */
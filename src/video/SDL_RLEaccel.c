@@ -89,6 +89,7 @@
 #include "SDL_sysvideo.h"
 #include "SDL_blit.h"
 #include "SDL_RLEaccel_c.h"
+#include "../thread/SDL_workers_c.h"
 
 #ifndef MIN
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
@@ -111,23 +112,193 @@
  * of each component, so the bits from the multiplication don't collide.
  * This can be used for any RGB permutation of course.
  */
+static SDL_INLINE Uint32
+Blend888(Uint32 s, Uint32 d, unsigned alpha)
+{
+    Uint32 s1 = s & 0xff00ff;
+    Uint32 d1 = d & 0xff00ff;
+    d1 = (d1 + ((s1 - d1) * alpha >> 8)) & 0xff00ff;
+    s &= 0xff00;
+    d &= 0xff00;
+    d = (d + ((s - d) * alpha >> 8)) & 0xff00;
+    return d1 | d;
+}
+
+/*
+ * Runs of 32bpp pixels are blended by a function chosen once per blit, so
+ * that the SIMD versions below can be used where the CPU has them. They all
+ * give exactly the same result as Blend888(), which works out to
+ * d + ((s - d) * alpha >> 8) on each component.
+ */
+typedef void (*RLEBlendRunFunc) (Uint32 * dst, const Uint32 * src, int n,
+                                 unsigned alpha);
+
+/* blend with per-surface alpha, clearing the top byte */
+static void
+BlendRun888(Uint32 * dst, const Uint32 * src, int n, unsigned alpha)
+{
+    while (n--) {
+        *dst = Blend888(*src++, *dst, alpha);
+        dst++;
+    }
+}
+
+/* blend encoded translucent pixels, which carry their alpha in the top byte */
+static void
+BlendTranslRun888(Uint32 * dst, const Uint32 * src, int n, unsigned unused)
+{
+    while (n--) {
+        Uint32 s = *src++;
+        *dst = Blend888(s, *dst, s >> 24) | 0xff000000;
+        dst++;
+    }
+}
+
+#if HAVE_SSE2_INTRINSICS
+
+static void
+BlendRun888SSE2(Uint32 * dst, const Uint32 * src, int n, unsigned alpha)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mm_alpha = _mm_set1_epi16((short) alpha);
+    const __m128i mm_rgb = _mm_set1_epi32(0x00ffffff);
+
+    for (; n >= 4; n -= 4, src += 4, dst += 4) {
+        const __m128i s = _mm_loadu_si128((const __m128i *) src);
+        const __m128i d = _mm_loadu_si128((const __m128i *) dst);
+        const __m128i lo = BlendLanesSSE2(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), mm_alpha);
+        const __m128i hi = BlendLanesSSE2(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), mm_alpha);
+        _mm_storeu_si128((__m128i *) dst, _mm_and_si128(_mm_packus_epi16(lo, hi), mm_rgb));
+    }
+    BlendRun888(dst, src, n, alpha);
+}
+
+static void
+BlendTranslRun888SSE2(Uint32 * dst, const Uint32 * src, int n, unsigned unused)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mm_opaque = _mm_set1_epi32((int) 0xff000000);
+
+    for (; n >= 4; n -= 4, src += 4, dst += 4) {
+        const __m128i s = _mm_loadu_si128((const __m128i *) src);
+        const __m128i d = _mm_loadu_si128((const __m128i *) dst);
+        /* copy each pixel's alpha into both halves of its 32 bits,
+           then spread it over the four 16-bit lanes of that pixel */
+        __m128i alpha = _mm_srli_epi32(s, 24);
+        __m128i lo, hi;
+        alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 16));
+        lo = BlendLanesSSE2(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi32(alpha, alpha));
+        hi = BlendLanesSSE2(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi32(alpha, alpha));
+        _mm_storeu_si128((__m128i *) dst, _mm_or_si128(_mm_packus_epi16(lo, hi), mm_opaque));
+    }
+    BlendTranslRun888(dst, src, n, unused);
+}
+
+#endif /* HAVE_SSE2_INTRINSICS */
+
+#if HAVE_AVX2_INTRINSICS
+
+SDL_TARGETING("avx2") static void
+BlendRun888AVX2(Uint32 * dst, const Uint32 * src, int n, unsigned alpha)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i mm_alpha = _mm256_set1_epi16((short) alpha);
+    const __m256i mm_rgb = _mm256_set1_epi32(0x00ffffff);
+
+    for (; n >= 8; n -= 8, src += 8, dst += 8) {
+        const __m256i s = _mm256_loadu_si256((const __m256i *) src);
+        const __m256i d = _mm256_loadu_si256((const __m256i *) dst);
+        const __m256i lo = BlendLanesAVX2(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero), mm_alpha);
+        const __m256i hi = BlendLanesAVX2(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero), mm_alpha);
+        _mm256_storeu_si256((__m256i *) dst, _mm256_and_si256(_mm256_packus_epi16(lo, hi), mm_rgb));
+    }
+    BlendRun888(dst, src, n, alpha);
+}
+
+SDL_TARGETING("avx2") static void
+BlendTranslRun888AVX2(Uint32 * dst, const Uint32 * src, int n, unsigned unused)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i mm_opaque = _mm256_set1_epi32((int) 0xff000000);
+
+    for (; n >= 8; n -= 8, src += 8, dst += 8) {
+        const __m256i s = _mm256_loadu_si256((const __m256i *) src);
+        const __m256i d = _mm256_loadu_si256((const __m256i *) dst);
+        /* the unpacks work within each 128-bit half, same as for SSE2 */
+        __m256i alpha = _mm256_srli_epi32(s, 24);
+        __m256i lo, hi;
+        alpha = _mm256_or_si256(alpha, _mm256_slli_epi32(alpha, 16));
+        lo = BlendLanesAVX2(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero), _mm256_unpacklo_epi32(alpha, alpha));
+        hi = BlendLanesAVX2(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero), _mm256_unpackhi_epi32(alpha, alpha));
+        _mm256_storeu_si256((__m256i *) dst, _mm256_or_si256(_mm256_packus_epi16(lo, hi), mm_opaque));
+    }
+    BlendTranslRun888(dst, src, n, unused);
+}
+
+#endif /* HAVE_AVX2_INTRINSICS */
+
+#if HAVE_NEON_INTRINSICS
+
+static void
+BlendRun888NEON(Uint32 * dst, const Uint32 * src, int n, unsigned alpha)
+{
+    const uint16x8_t mm_alpha = vdupq_n_u16((uint16_t) alpha);
+    const uint32x4_t mm_rgb = vdupq_n_u32(0x00ffffff);
+
+    for (; n >= 4; n -= 4, src += 4, dst += 4) {
+        const uint8x16_t s = vreinterpretq_u8_u32(vld1q_u32(src));
+        const uint8x16_t d = vreinterpretq_u8_u32(vld1q_u32(dst));
+        const uint8x16_t res = vcombine_u8(BlendLanesNEON(vget_low_u8(s), vget_low_u8(d), mm_alpha),
+                                           BlendLanesNEON(vget_high_u8(s), vget_high_u8(d), mm_alpha));
+        vst1q_u32(dst, vandq_u32(vreinterpretq_u32_u8(res), mm_rgb));
+    }
+    BlendRun888(dst, src, n, alpha);
+}
+
+static void
+BlendTranslRun888NEON(Uint32 * dst, const Uint32 * src, int n, unsigned unused)
+{
+    const uint32x4_t mm_opaque = vdupq_n_u32(0xff000000);
+
+    for (; n >= 4; n -= 4, src += 4, dst += 4) {
+        const uint32x4_t s32 = vld1q_u32(src);
+        const uint8x16_t s = vreinterpretq_u8_u32(s32);
+        const uint8x16_t d = vreinterpretq_u8_u32(vld1q_u32(dst));
+        /* spread each pixel's alpha over all four of its bytes */
+        const uint8x16_t alpha = vreinterpretq_u8_u32(vmulq_n_u32(vshrq_n_u32(s32, 24), 0x01010101));
+        const uint8x16_t res = vcombine_u8(BlendLanesNEON(vget_low_u8(s), vget_low_u8(d), vmovl_u8(vget_low_u8(alpha))),
+                                           BlendLanesNEON(vget_high_u8(s), vget_high_u8(d), vmovl_u8(vget_high_u8(alpha))));
+        vst1q_u32(dst, vorrq_u32(vreinterpretq_u32_u8(res), mm_opaque));
+    }
+    BlendTranslRun888(dst, src, n, unused);
+}
+
+#endif /* HAVE_NEON_INTRINSICS */
+
+static RLEBlendRunFunc
+ChooseBlendRun888(SDL_bool translucent)
+{
+#if HAVE_AVX2_INTRINSICS
+    if (SDL_HasAVX2()) {
+        return translucent ? BlendTranslRun888AVX2 : BlendRun888AVX2;
+    }
+#endif
+#if HAVE_SSE2_INTRINSICS
+    if (SDL_HasSSE2()) {
+        return translucent ? BlendTranslRun888SSE2 : BlendRun888SSE2;
+    }
+#endif
+#if HAVE_NEON_INTRINSICS
+    if (SDL_HasNEON()) {
+        return translucent ? BlendTranslRun888NEON : BlendRun888NEON;
+    }
+#endif
+    return translucent ? BlendTranslRun888 : BlendRun888;
+}
+
+/* blend_run is the function returned by ChooseBlendRun888(SDL_FALSE) */
 #define ALPHA_BLIT32_888(to, from, length, bpp, alpha)      \
-    do {                                                    \
-        int i;                                              \
-        Uint32 *src = (Uint32 *)(from);                     \
-        Uint32 *dst = (Uint32 *)(to);                       \
-        for (i = 0; i < (int)(length); i++) {               \
-            Uint32 s = *src++;                              \
-            Uint32 d = *dst;                                \
-            Uint32 s1 = s & 0xff00ff;                       \
-            Uint32 d1 = d & 0xff00ff;                       \
-            d1 = (d1 + ((s1 - d1) * alpha >> 8)) & 0xff00ff; \
-            s &= 0xff00;                                    \
-            d &= 0xff00;                                    \
-            d = (d + ((s - d) * alpha >> 8)) & 0xff00;      \
-            *dst++ = d1 | d;                                \
-        }                                                   \
-    } while (0)
+    blend_run((Uint32 *)(to), (const Uint32 *)(from), (int)(length), alpha)
 
 /*
  * For 16bpp pixels we can go a step further: put the middle component
@@ -391,6 +562,7 @@ RLEClipBlit(int w, Uint8 * srcbuf, SDL_Surface * surf_dst,
             Uint8 * dstbuf, SDL_Rect * srcrect, unsigned alpha)
 {
     SDL_PixelFormat *fmt = surf_dst->format;
+    const RLEBlendRunFunc blend_run = ChooseBlendRun888(SDL_FALSE);
 
 #define RLECLIPBLIT(bpp, Type, do_blit)                         \
     do {                                                        \
@@ -519,6 +691,7 @@ SDL_RLEBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
         RLEClipBlit(w, srcbuf, surf_dst, dstbuf, srcrect, alpha);
     } else {
         SDL_PixelFormat *fmt = surf_src->format;
+        const RLEBlendRunFunc blend_run = ChooseBlendRun888(SDL_FALSE);
 
 #define RLEBLIT(bpp, Type, do_blit)                       \
         do {                                  \
@@ -564,24 +737,6 @@ SDL_RLEBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
  * These use the same techniques as the per-surface blitting macros
  */
 
-/*
- * For 32bpp pixels, we have made sure the alpha is stored in the top
- * 8 bits, so proceed as usual
- */
-#define BLIT_TRANSL_888(src, dst)               \
-    do {                            \
-        Uint32 s = src;                     \
-    Uint32 d = dst;                     \
-    unsigned alpha = s >> 24;               \
-    Uint32 s1 = s & 0xff00ff;               \
-    Uint32 d1 = d & 0xff00ff;               \
-    d1 = (d1 + ((s1 - d1) * alpha >> 8)) & 0xff00ff;    \
-    s &= 0xff00;                        \
-    d &= 0xff00;                        \
-    d = (d + ((s - d) * alpha >> 8)) & 0xff00;      \
-    dst = d1 | d | 0xff000000;              \
-    } while(0)
-
 /*
  * For 16bpp pixels, we have stored the 5 most significant alpha bits in
  * bits 5-10. As before, we can process all 3 RGB components at the same time.
@@ -610,6 +765,28 @@ SDL_RLEBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
     dst = (Uint16)(d | d >> 16);            \
     } while(0)
 
+/*
+ * Blit a run of n translucent pixels. For 32bpp pixels, we have made sure
+ * the alpha is stored in the top 8 bits, so transl_run (from
+ * ChooseBlendRun888(SDL_TRUE)) can blend them as usual.
+ */
+#define BLIT_TRANSL_RUN_888(dst, src, n)        \
+    transl_run(dst, src, n, 0)
+
+#define BLIT_TRANSL_RUN_565(dst, src, n)        \
+    do {                                        \
+        int i;                                  \
+        for (i = 0; i < (int)(n); i++)          \
+            BLIT_TRANSL_565((src)[i], (dst)[i]); \
+    } while(0)
+
+#define BLIT_TRANSL_RUN_555(dst, src, n)        \
+    do {                                        \
+        int i;                                  \
+        for (i = 0; i < (int)(n); i++)          \
+            BLIT_TRANSL_555((src)[i], (dst)[i]); \
+    } while(0)
+
 /* used to save the destination format in the encoding. Designed to be
    macro-compatible with SDL_PixelFormat but without the unneeded fields */
 typedef struct
@@ -636,12 +813,13 @@ RLEAlphaClipBlit(int w, Uint8 * srcbuf, SDL_Surface * surf_dst,
                  Uint8 * dstbuf, SDL_Rect * srcrect)
 {
     SDL_PixelFormat *df = surf_dst->format;
+    const RLEBlendRunFunc transl_run = ChooseBlendRun888(SDL_TRUE);
     /*
      * clipped blitter: Ptype is the destination pixel type,
-     * Ctype the translucent count type, and do_blend the macro
-     * to blend one pixel.
+     * Ctype the translucent count type, and do_blend_run the macro
+     * to blend a run of pixels.
      */
-#define RLEALPHACLIPBLIT(Ptype, Ctype, do_blend)              \
+#define RLEALPHACLIPBLIT(Ptype, Ctype, do_blend_run)              \
     do {                                  \
     int linecount = srcrect->h;                   \
     int left = srcrect->x;                        \
@@ -694,13 +872,9 @@ RLEAlphaClipBlit(int w, Uint8 * srcbuf, SDL_Surface * surf_dst,
             }                             \
             if(crun > right - cofs)               \
             crun = right - cofs;                  \
-            if(crun > 0) {                    \
-            Ptype *dst = (Ptype *)dstbuf + cofs;          \
-            Uint32 *src = (Uint32 *)srcbuf + (cofs - ofs);    \
-            int i;                        \
-            for(i = 0; i < crun; i++)             \
-                do_blend(src[i], dst[i]);             \
-            }                             \
+            if(crun > 0)                      \
+            do_blend_run((Ptype *)dstbuf + cofs,          \
+                     (Uint32 *)srcbuf + (cofs - ofs), crun);  \
             srcbuf += run * 4;                    \
             ofs += run;                       \
         }                             \
@@ -712,12 +886,12 @@ RLEAlphaClipBlit(int w, Uint8 * srcbuf, SDL_Surface * surf_dst,
     switch (df->BytesPerPixel) {
     case 2:
         if (df->Gmask == 0x07e0 || df->Rmask == 0x07e0 || df->Bmask == 0x07e0)
-            RLEALPHACLIPBLIT(Uint16, Uint8, BLIT_TRANSL_565);
+            RLEALPHACLIPBLIT(Uint16, Uint8, BLIT_TRANSL_RUN_565);
         else
-            RLEALPHACLIPBLIT(Uint16, Uint8, BLIT_TRANSL_555);
+            RLEALPHACLIPBLIT(Uint16, Uint8, BLIT_TRANSL_RUN_555);
         break;
     case 4:
-        RLEALPHACLIPBLIT(Uint32, Uint16, BLIT_TRANSL_888);
+        RLEALPHACLIPBLIT(Uint32, Uint16, BLIT_TRANSL_RUN_888);
         break;
     }
 }
@@ -731,6 +905,7 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
     int w = surf_src->w;
     Uint8 *srcbuf, *dstbuf;
     SDL_PixelFormat *df = surf_dst->format;
+    const RLEBlendRunFunc transl_run = ChooseBlendRun888(SDL_TRUE);
 
     /* Lock the destination if necessary */
     if (SDL_MUSTLOCK(surf_dst)) {
@@ -807,10 +982,10 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
 
         /*
          * non-clipped blitter. Ptype is the destination pixel type,
-         * Ctype the translucent count type, and do_blend the
-         * macro to blend one pixel.
+         * Ctype the translucent count type, and do_blend_run the
+         * macro to blend a run of pixels.
          */
-#define RLEALPHABLIT(Ptype, Ctype, do_blend)                 \
+#define RLEALPHABLIT(Ptype, Ctype, do_blend_run)                 \
     do {                                 \
         int linecount = srcrect->h;                  \
         do {                             \
@@ -840,14 +1015,8 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
             run = ((Uint16 *)srcbuf)[1];             \
             srcbuf += 4;                     \
             if(run) {                        \
-            Ptype *dst = (Ptype *)dstbuf + ofs;      \
-            unsigned i;                  \
-            for(i = 0; i < run; i++) {           \
-                Uint32 src = *(Uint32 *)srcbuf;      \
-                do_blend(src, *dst);             \
-                srcbuf += 4;                 \
-                dst++;                   \
-            }                        \
+            do_blend_run((Ptype *)dstbuf + ofs, (Uint32 *)srcbuf, run); \
+            srcbuf += run * 4;               \
             ofs += run;                  \
             }                            \
         } while(ofs < w);                    \
@@ -859,12 +1028,12 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
         case 2:
             if (df->Gmask == 0x07e0 || df->Rmask == 0x07e0
                 || df->Bmask == 0x07e0)
-                RLEALPHABLIT(Uint16, Uint8, BLIT_TRANSL_565);
+                RLEALPHABLIT(Uint16, Uint8, BLIT_TRANSL_RUN_565);
             else
-                RLEALPHABLIT(Uint16, Uint8, BLIT_TRANSL_555);
+                RLEALPHABLIT(Uint16, Uint8, BLIT_TRANSL_RUN_555);
             break;
         case 4:
-            RLEALPHABLIT(Uint32, Uint16, BLIT_TRANSL_888);
+            RLEALPHABLIT(Uint32, Uint16, BLIT_TRANSL_RUN_888);
             break;
         }
     }
@@ -1021,21 +1190,275 @@ uncopy_32(Uint32 * dst, void *src, int n,
 #define ISTRANSL(pixel, fmt)    \
     ((unsigned)((((pixel) & fmt->Amask) >> fmt->Ashift) - 1U) < 254U)
 
+static Uint32
+getpix_8(Uint8 * srcbuf)
+{
+    return *srcbuf;
+}
+
+static Uint32
+getpix_16(Uint8 * srcbuf)
+{
+    return *(Uint16 *) srcbuf;
+}
+
+static Uint32
+getpix_24(Uint8 * srcbuf)
+{
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+    return srcbuf[0] + (srcbuf[1] << 8) + (srcbuf[2] << 16);
+#else
+    return (srcbuf[0] << 16) + (srcbuf[1] << 8) + srcbuf[2];
+#endif
+}
+
+static Uint32
+getpix_32(Uint8 * srcbuf)
+{
+    return *(Uint32 *) srcbuf;
+}
+
+typedef Uint32(*getpix_func) (Uint8 *);
+
+static const getpix_func getpixes[4] = {
+    getpix_8, getpix_16, getpix_24, getpix_32
+};
+
+/*
+ * Each scan line is encoded on its own; the lines only depend on each other
+ * through the trimming of trailing blank lines at the very end. Big surfaces
+ * are therefore split into bands of lines which are encoded in parallel into
+ * separate buffers, and then joined together.
+ */
+
+/* Surfaces with at least this many pixels are encoded on the worker threads */
+#define RLE_PARALLEL_PIXELS (256 * 256)
+
+/* Don't bother splitting into bands smaller than this */
+#define RLE_MIN_BAND_ROWS   16
+
+typedef struct RLEEncodeJob RLEEncodeJob;
+
+/* Encode h lines starting at line y to dst, and return the end of the
+   encoded data. *lastline is set to the end of the last line that isn't
+   blank, and left alone if they all are. */
+typedef Uint8 *(*RLEEncodeFunc) (const RLEEncodeJob * job, int y, int h,
+                                 Uint8 * dst, Uint8 ** lastline);
+
+typedef struct
+{
+    Uint8 *buf;
+    Uint8 *end;
+    Uint8 *lastline;
+} RLEBand;
+
+struct RLEEncodeJob
+{
+    SDL_Surface *surface;
+    RLEEncodeFunc encode;
+    size_t linesize;            /* worst case size of one encoded line */
+
+    /* used by RLEAlphaLines() */
+    SDL_PixelFormat *df;
+    int max_opaque_run;
+    int (*copy_opaque) (void *, Uint32 *, int,
+                        SDL_PixelFormat *, SDL_PixelFormat *);
+    int (*copy_transl) (void *, Uint32 *, int,
+                        SDL_PixelFormat *, SDL_PixelFormat *);
+
+    /* used by RLEColorkeyLines() */
+    getpix_func getpix;
+    Uint32 ckey;
+    Uint32 rgbmask;
+
+    int bands;
+    RLEBand *band;
+};
+
+static void
+RLEEncodeBand(void *data, int index)
+{
+    RLEEncodeJob *job = (RLEEncodeJob *) data;
+    RLEBand *band = &job->band[index];
+    const int y = (job->surface->h * index) / job->bands;
+    const int h = (job->surface->h * (index + 1)) / job->bands - y;
+
+    /* The band buffers are aligned at least as well as the final buffer,
+       which the 16bpp alpha encoding relies on for its padding. */
+    band->buf = (Uint8 *) SDL_malloc(h * job->linesize);
+    if (band->buf) {
+        band->lastline = NULL;
+        band->end = job->encode(job, y, h, band->buf, &band->lastline);
+    }
+}
+
+/* Encode all lines of the surface to dst, and return the end of the last
+   line that isn't blank, which is where the end marker goes */
+static Uint8 *
+RLEEncodeSurface(RLEEncodeJob * job, Uint8 * dst)
+{
+    SDL_Surface *surface = job->surface;
+    Uint8 *lastline = dst;
+    int i;
+
+    job->bands = 1;
+    if (surface->w * surface->h >= RLE_PARALLEL_PIXELS) {
+        job->bands = SDL_min(SDL_GetWorkerCount(), surface->h / RLE_MIN_BAND_ROWS);
+    }
+    if (job->bands > 1) {
+        job->band = (RLEBand *) SDL_calloc(job->bands, sizeof(RLEBand));
+    }
+    if (job->bands <= 1 || !job->band) {
+        job->encode(job, 0, surface->h, dst, &lastline);
+        return lastline;
+    }
+
+    SDL_RunOnWorkers(RLEEncodeBand, job, job->bands);
+
+    for (i = 0; i < job->bands; ++i) {
+        if (!job->band[i].buf) {
+            break;
+        }
+    }
+    if (i == job->bands) {
+        for (i = 0; i < job->bands; ++i) {
+            const RLEBand *band = &job->band[i];
+            const size_t size = band->end - band->buf;
+            SDL_memcpy(dst, band->buf, size);
+            if (band->lastline) {
+                lastline = dst + (band->lastline - band->buf);
+            }
+            dst += size;
+        }
+    } else {
+        /* Not enough memory for the bands, encode it in one go instead */
+        job->encode(job, 0, surface->h, dst, &lastline);
+    }
+
+    for (i = 0; i < job->bands; ++i) {
+        SDL_free(job->band[i].buf);
+    }
+    SDL_free(job->band);
+    job->band = NULL;
+
+    return lastline;
+}
+
+/* opaque counts are 8 or 16 bits, depending on target depth */
+#define ADD_OPAQUE_COUNTS(n, m)         \
+    if(df->BytesPerPixel == 4) {        \
+        ((Uint16 *)dst)[0] = n;     \
+        ((Uint16 *)dst)[1] = m;     \
+        dst += 4;               \
+    } else {                \
+        dst[0] = n;             \
+        dst[1] = m;             \
+        dst += 2;               \
+    }
+
+/* translucent counts are always 16 bit */
+#define ADD_TRANSL_COUNTS(n, m)     \
+    (((Uint16 *)dst)[0] = n, ((Uint16 *)dst)[1] = m, dst += 4)
+
+static Uint8 *
+RLEAlphaLines(const RLEEncodeJob * job, int y, int h,
+              Uint8 * dst, Uint8 ** lastline)
+{
+    SDL_Surface *surface = job->surface;
+    SDL_PixelFormat *sf = surface->format;
+    SDL_PixelFormat *df = job->df;
+    const int w = surface->w;
+    const int max_opaque_run = job->max_opaque_run;
+    const int max_transl_run = 65535;
+    Uint32 *src = (Uint32 *) ((Uint8 *) surface->pixels + y * surface->pitch);
+    int x;
+
+    for (; h > 0; --h) {
+        int runstart, skipstart;
+        int blankline = 0;
+        /* First encode all opaque pixels of a scan line */
+        x = 0;
+        do {
+            int run, skip, len;
+            skipstart = x;
+            while (x < w && !ISOPAQUE(src[x], sf))
+                x++;
+            runstart = x;
+            while (x < w && ISOPAQUE(src[x], sf))
+                x++;
+            skip = runstart - skipstart;
+            if (skip == w)
+                blankline = 1;
+            run = x - runstart;
+            while (skip > max_opaque_run) {
+                ADD_OPAQUE_COUNTS(max_opaque_run, 0);
+                skip -= max_opaque_run;
+            }
+            len = MIN(run, max_opaque_run);
+            ADD_OPAQUE_COUNTS(skip, len);
+            dst += job->copy_opaque(dst, src + runstart, len, sf, df);
+            runstart += len;
+            run -= len;
+            while (run) {
+                len = MIN(run, max_opaque_run);
+                ADD_OPAQUE_COUNTS(0, len);
+                dst += job->copy_opaque(dst, src + runstart, len, sf, df);
+                runstart += len;
+                run -= len;
+            }
+        } while (x < w);
+
+        /* Make sure the next output address is 32-bit aligned */
+        dst += (uintptr_t) dst & 2;
+
+        /* Next, encode all translucent pixels of the same scan line */
+        x = 0;
+        do {
+            int run, skip, len;
+            skipstart = x;
+            while (x < w && !ISTRANSL(src[x], sf))
+                x++;
+            runstart = x;
+            while (x < w && ISTRANSL(src[x], sf))
+                x++;
+            skip = runstart - skipstart;
+            blankline &= (skip == w);
+            run = x - runstart;
+            while (skip > max_transl_run) {
+                ADD_TRANSL_COUNTS(max_transl_run, 0);
+                skip -= max_transl_run;
+            }
+            len = MIN(run, max_transl_run);
+            ADD_TRANSL_COUNTS(skip, len);
+            dst += job->copy_transl(dst, src + runstart, len, sf, df);
+            runstart += len;
+            run -= len;
+            while (run) {
+                len = MIN(run, max_transl_run);
+                ADD_TRANSL_COUNTS(0, len);
+                dst += job->copy_transl(dst, src + runstart, len, sf, df);
+                runstart += len;
+                run -= len;
+            }
+            if (!blankline)
+                *lastline = dst;
+        } while (x < w);
+
+        src += surface->pitch >> 2;
+    }
+    return dst;
+}
+
 /* convert surface to be quickly alpha-blittable onto dest, if possible */
 static int
 RLEAlphaSurface(SDL_Surface * surface)
 {
+    RLEEncodeJob job;
     SDL_Surface *dest;
     SDL_PixelFormat *df;
-    int maxsize = 0;
-    int max_opaque_run;
-    int max_transl_run = 65535;
+    size_t maxsize = 0;
     unsigned masksum;
     Uint8 *rlebuf, *dst;
-    int (*copy_opaque) (void *, Uint32 *, int,
-                        SDL_PixelFormat *, SDL_PixelFormat *);
-    int (*copy_transl) (void *, Uint32 *, int,
-                        SDL_PixelFormat *, SDL_PixelFormat *);
 
     dest = surface->map->dst;
     if (!dest)
@@ -1044,6 +1467,11 @@ RLEAlphaSurface(SDL_Surface * surface)
     if (surface->format->BitsPerPixel != 32)
         return -1;              /* only 32bpp source supported */
 
+    SDL_zero(job);
+    job.surface = surface;
+    job.encode = RLEAlphaLines;
+    job.df = df;
+
     /* find out whether the destination is one we support,
        and determine the max size of the encoded result */
     masksum = df->Rmask | df->Gmask | df->Bmask;
@@ -1054,37 +1482,39 @@ RLEAlphaSurface(SDL_Surface * surface)
         case 0xffff:
             if (df->Gmask == 0x07e0
                 || df->Rmask == 0x07e0 || df->Bmask == 0x07e0) {
-                copy_opaque = copy_opaque_16;
-                copy_transl = copy_transl_565;
+                job.copy_opaque = copy_opaque_16;
+                job.copy_transl = copy_transl_565;
             } else
                 return -1;
             break;
         case 0x7fff:
             if (df->Gmask == 0x03e0
                 || df->Rmask == 0x03e0 || df->Bmask == 0x03e0) {
-                copy_opaque = copy_opaque_16;
-                copy_transl = copy_transl_555;
+                job.copy_opaque = copy_opaque_16;
+                job.copy_transl = copy_transl_555;
             } else
                 return -1;
             break;
         default:
             return -1;
         }
-        max_opaque_run = 255;   /* runs stored as bytes */
+        job.max_opaque_run = 255;       /* runs stored as bytes */
 
         /* worst case is alternating opaque and translucent pixels,
            with room for alignment padding between lines */
-        maxsize = surface->h * (2 + (4 + 2) * (surface->w + 1)) + 2;
+        job.linesize = 2 + (4 + 2) * (surface->w + 1);
+        maxsize = surface->h * job.linesize + 2;
         break;
     case 4:
         if (masksum != 0x00ffffff)
             return -1;          /* requires unused high byte */
-        copy_opaque = copy_32;
-        copy_transl = copy_32;
-        max_opaque_run = 255;   /* runs stored as short ints */
+        job.copy_opaque = copy_32;
+        job.copy_transl = copy_32;
+        job.max_opaque_run = 255;       /* runs stored as short ints */
 
         /* worst case is alternating opaque and translucent pixels */
-        maxsize = surface->h * 2 * 4 * (surface->w + 1) + 4;
+        job.linesize = 2 * 4 * (surface->w + 1);
+        maxsize = surface->h * job.linesize + 4;
         break;
     default:
         return -1;              /* anything else unsupported right now */
@@ -1112,118 +1542,13 @@ RLEAlphaSurface(SDL_Surface * surface)
         r->Bshift = df->Bshift;
         r->Ashift = df->Ashift;
     }
-    dst = rlebuf + sizeof(RLEDestFormat);
 
-    /* Do the actual encoding */
-    {
-        int x, y;
-        int h = surface->h, w = surface->w;
-        SDL_PixelFormat *sf = surface->format;
-        Uint32 *src = (Uint32 *) surface->pixels;
-        Uint8 *lastline = dst;  /* end of last non-blank line */
-
-        /* opaque counts are 8 or 16 bits, depending on target depth */
-#define ADD_OPAQUE_COUNTS(n, m)         \
-    if(df->BytesPerPixel == 4) {        \
-        ((Uint16 *)dst)[0] = n;     \
-        ((Uint16 *)dst)[1] = m;     \
-        dst += 4;               \
-    } else {                \
-        dst[0] = n;             \
-        dst[1] = m;             \
-        dst += 2;               \
-    }
-
-        /* translucent counts are always 16 bit */
-#define ADD_TRANSL_COUNTS(n, m)     \
-    (((Uint16 *)dst)[0] = n, ((Uint16 *)dst)[1] = m, dst += 4)
-
-        for (y = 0; y < h; y++) {
-            int runstart, skipstart;
-            int blankline = 0;
-            /* First encode all opaque pixels of a scan line */
-            x = 0;
-            do {
-                int run, skip, len;
-                skipstart = x;
-                while (x < w && !ISOPAQUE(src[x], sf))
-                    x++;
-                runstart = x;
-                while (x < w && ISOPAQUE(src[x], sf))
-                    x++;
-                skip = runstart - skipstart;
-                if (skip == w)
-                    blankline = 1;
-                run = x - runstart;
-                while (skip > max_opaque_run) {
-                    ADD_OPAQUE_COUNTS(max_opaque_run, 0);
-                    skip -= max_opaque_run;
-                }
-                len = MIN(run, max_opaque_run);
-                ADD_OPAQUE_COUNTS(skip, len);
-                dst += copy_opaque(dst, src + runstart, len, sf, df);
-                runstart += len;
-                run -= len;
-                while (run) {
-                    len = MIN(run, max_opaque_run);
-                    ADD_OPAQUE_COUNTS(0, len);
-                    dst += copy_opaque(dst, src + runstart, len, sf, df);
-                    runstart += len;
-                    run -= len;
-                }
-            } while (x < w);
-
-            /* Make sure the next output address is 32-bit aligned */
-            dst += (uintptr_t) dst & 2;
-
-            /* Next, encode all translucent pixels of the same scan line */
-            x = 0;
-            do {
-                int run, skip, len;
-                skipstart = x;
-                while (x < w && !ISTRANSL(src[x], sf))
-                    x++;
-                runstart = x;
-                while (x < w && ISTRANSL(src[x], sf))
-                    x++;
-                skip = runstart - skipstart;
-                blankline &= (skip == w);
-                run = x - runstart;
-                while (skip > max_transl_run) {
-                    ADD_TRANSL_COUNTS(max_transl_run, 0);
-                    skip -= max_transl_run;
-                }
-                len = MIN(run, max_transl_run);
-                ADD_TRANSL_COUNTS(skip, len);
-                dst += copy_transl(dst, src + runstart, len, sf, df);
-                runstart += len;
-                run -= len;
-                while (run) {
-                    len = MIN(run, max_transl_run);
-                    ADD_TRANSL_COUNTS(0, len);
-                    dst += copy_transl(dst, src + runstart, len, sf, df);
-                    runstart += len;
-                    run -= len;
-                }
-                if (!blankline)
-                    lastline = dst;
-            } while (x < w);
-
-            src += surface->pitch >> 2;
-        }
-        dst = lastline;         /* back up past trailing blank lines */
-        ADD_OPAQUE_COUNTS(0, 0);
-    }
-
-#undef ADD_OPAQUE_COUNTS
-#undef ADD_TRANSL_COUNTS
+    /* Do the actual encoding, and back up past trailing blank lines */
+    dst = RLEEncodeSurface(&job, rlebuf + sizeof(RLEDestFormat));
+    ADD_OPAQUE_COUNTS(0, 0);
 
     /* Now that we have it encoded, release the original pixels */
-    if (!(surface->flags & SDL_PREALLOC)) {
-        SDL_SIMDFree(surface->pixels);
-        surface->pixels = NULL;
-        surface->flags &= ~SDL_SIMD_ALIGNED;
-    }
+    SDL_FreeSurfacePixels(surface);
 
     /* realloc the buffer to release unused memory */
     {
@@ -1236,91 +1561,8 @@ RLEAlphaSurface(SDL_Surface * surface)
     return 0;
 }
 
-static Uint32
-getpix_8(Uint8 * srcbuf)
-{
-    return *srcbuf;
-}
-
-static Uint32
-getpix_16(Uint8 * srcbuf)
-{
-    return *(Uint16 *) srcbuf;
-}
-
-static Uint32
-getpix_24(Uint8 * srcbuf)
-{
-#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-    return srcbuf[0] + (srcbuf[1] << 8) + (srcbuf[2] << 16);
-#else
-    return (srcbuf[0] << 16) + (srcbuf[1] << 8) + srcbuf[2];
-#endif
-}
-
-static Uint32
-getpix_32(Uint8 * srcbuf)
-{
-    return *(Uint32 *) srcbuf;
-}
-
-typedef Uint32(*getpix_func) (Uint8 *);
-
-static const getpix_func getpixes[4] = {
-    getpix_8, getpix_16, getpix_24, getpix_32
-};
-
-static int
-RLEColorkeySurface(SDL_Surface * surface)
-{
-    Uint8 *rlebuf, *dst;
-    int maxn;
-    int y;
-    Uint8 *srcbuf, *lastline;
-    int maxsize = 0;
-    const int bpp = surface->format->BytesPerPixel;
-    getpix_func getpix;
-    Uint32 ckey, rgbmask;
-    int w, h;
-
-    /* calculate the worst case size for the compressed surface */
-    switch (bpp) {
-    case 1:
-        /* worst case is alternating opaque and transparent pixels,
-           starting with an opaque pixel */
-        maxsize = surface->h * 3 * (surface->w / 2 + 1) + 2;
-        break;
-    case 2:
-    case 3:
-        /* worst case is solid runs, at most 255 pixels wide */
-        maxsize = surface->h * (2 * (surface->w / 255 + 1)
-                                + surface->w * bpp) + 2;
-        break;
-    case 4:
-        /* worst case is solid runs, at most 65535 pixels wide */
-        maxsize = surface->h * (4 * (surface->w / 65535 + 1)
-                                + surface->w * 4) + 4;
-        break;
-
-    default:
-        return -1;
-    }
-
-    rlebuf = (Uint8 *) SDL_malloc(maxsize);
-    if (rlebuf == NULL) {
-        return SDL_OutOfMemory();
-    }
-
-    /* Set up the conversion */
-    srcbuf = (Uint8 *) surface->pixels;
-    maxn = bpp == 4 ? 65535 : 255;
-    dst = rlebuf;
-    rgbmask = ~surface->format->Amask;
-    ckey = surface->map->info.colorkey & rgbmask;
-    lastline = dst;
-    getpix = getpixes[bpp - 1];
-    w = surface->w;
-    h = surface->h;
+#undef ADD_OPAQUE_COUNTS
+#undef ADD_TRANSL_COUNTS
 
 #define ADD_COUNTS(n, m)            \
     if(bpp == 4) {              \
@@ -1333,7 +1575,20 @@ RLEColorkeySurface(SDL_Surface * surface)
         dst += 2;               \
     }
 
-    for (y = 0; y < h; y++) {
+static Uint8 *
+RLEColorkeyLines(const RLEEncodeJob * job, int y, int h,
+                 Uint8 * dst, Uint8 ** lastline)
+{
+    SDL_Surface *surface = job->surface;
+    const int bpp = surface->format->BytesPerPixel;
+    const int maxn = bpp == 4 ? 65535 : 255;
+    const getpix_func getpix = job->getpix;
+    const Uint32 rgbmask = job->rgbmask;
+    const Uint32 ckey = job->ckey;
+    const int w = surface->w;
+    Uint8 *srcbuf = (Uint8 *) surface->pixels + y * surface->pitch;
+
+    for (; h > 0; --h) {
         int x = 0;
         int blankline = 0;
         do {
@@ -1372,23 +1627,67 @@ RLEColorkeySurface(SDL_Surface * surface)
                 run -= len;
             }
             if (!blankline)
-                lastline = dst;
+                *lastline = dst;
         } while (x < w);
 
         srcbuf += surface->pitch;
     }
-    dst = lastline;             /* back up bast trailing blank lines */
-    ADD_COUNTS(0, 0);
+    return dst;
+}
 
-#undef ADD_COUNTS
+static int
+RLEColorkeySurface(SDL_Surface * surface)
+{
+    RLEEncodeJob job;
+    Uint8 *rlebuf, *dst;
+    size_t maxsize = 0;
+    const int bpp = surface->format->BytesPerPixel;
 
-    /* Now that we have it encoded, release the original pixels */
-    if (!(surface->flags & SDL_PREALLOC)) {
-        SDL_SIMDFree(surface->pixels);
-        surface->pixels = NULL;
-        surface->flags &= ~SDL_SIMD_ALIGNED;
+    SDL_zero(job);
+    job.surface = surface;
+    job.encode = RLEColorkeyLines;
+
+    /* calculate the worst case size for the compressed surface */
+    switch (bpp) {
+    case 1:
+        /* worst case is alternating opaque and transparent pixels,
+           starting with an opaque pixel */
+        job.linesize = 3 * (surface->w / 2 + 1);
+        maxsize = surface->h * job.linesize + 2;
+        break;
+    case 2:
+    case 3:
+        /* worst case is solid runs, at most 255 pixels wide */
+        job.linesize = 2 * (surface->w / 255 + 1) + surface->w * bpp;
+        maxsize = surface->h * job.linesize + 2;
+        break;
+    case 4:
+        /* worst case is solid runs, at most 65535 pixels wide */
+        job.linesize = 4 * (surface->w / 65535 + 1) + surface->w * 4;
+        maxsize = surface->h * job.linesize + 4;
+        break;
+
+    default:
+        return -1;
+    }
+
+    rlebuf = (Uint8 *) SDL_malloc(maxsize);
+    if (rlebuf == NULL) {
+        return SDL_OutOfMemory();
     }
 
+    /* Set up the conversion */
+    job.rgbmask = ~surface->format->Amask;
+    job.ckey = surface->map->info.colorkey & job.rgbmask;
+    job.getpix = getpixes[bpp - 1];
+
+    /* Do the actual encoding, and back up past trailing blank lines */
+    dst = RLEEncodeSurface(&job, rlebuf);
+    ADD_COUNTS(0, 0);
+
+    /* Now that we have it encoded, release the original pixels */
+    SDL_FreeSurfacePixels(surface);
+
     /* realloc the buffer to release unused memory */
     {
         /* If realloc returns NULL, the original block is left intact */
@@ -1401,6 +1700,8 @@ RLEColorkeySurface(SDL_Surface * surface)
     return 0;
 }
 
+#undef ADD_COUNTS
+
 int
 SDL_RLESurface(SDL_Surface * surface)
 {
@@ -1430,7 +1731,7 @@ SDL_RLESurface(SDL_Surface * surface)
     /* Pass on combinations not supported */
     if ((flags & SDL_COPY_MODULATE_COLOR) ||
         ((flags & SDL_COPY_MODULATE_ALPHA) && surface->format->Amask) ||
-        (flags & (SDL_COPY_ADD | SDL_COPY_MOD)) ||
+        (flags & (SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_BLEND_PREMULTIPLIED | SDL_COPY_ADD_PREMULTIPLIED)) ||
         (flags & SDL_COPY_NEAREST)) {
         return -1;
     }
@@ -1486,13 +1787,10 @@ UnRLEAlpha(SDL_Surface * surface)
         uncopy_opaque = uncopy_transl = uncopy_32;
     }
 
-    surface->pixels = SDL_SIMDAlloc(surface->h * surface->pitch);
-    if (!surface->pixels) {
+    /* fill background with transparent pixels */
+    if (SDL_AllocSurfacePixels(surface, SDL_TRUE) < 0) {
         return (SDL_FALSE);
     }
-    surface->flags |= SDL_SIMD_ALIGNED;
-    /* fill background with transparent pixels */
-    SDL_memset(surface->pixels, 0, surface->h * surface->pitch);
 
     dst = surface->pixels;
     srcbuf = (Uint8 *) (df + 1);
@@ -1552,13 +1850,11 @@ SDL_UnRLESurface(SDL_Surface * surface, int recode)
                 SDL_Rect full;
 
                 /* re-create the original surface */
-                surface->pixels = SDL_SIMDAlloc(surface->h * surface->pitch);
-                if (!surface->pixels) {
+                if (SDL_AllocSurfacePixels(surface, SDL_FALSE) < 0) {
                     /* Oh crap... */
                     surface->flags |= SDL_RLEACCEL;
                     return;
                 }
-                surface->flags |= SDL_SIMD_ALIGNED;
 
                 /* fill it with the background color */
                 SDL_FillRect(surface, NULL, surface->map->info.colorkey);
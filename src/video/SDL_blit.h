@@ -27,6 +27,14 @@
 #include "SDL_endian.h"
 #include "SDL_surface.h"
 
+#ifdef __SSE2__
+#define HAVE_SSE2_INTRINSICS 1
+#endif
+
+#ifdef __ARM_NEON
+#define HAVE_NEON_INTRINSICS 1
+#endif
+
 /* Table to do pixel byte expansion */
 extern Uint8* SDL_expand_byte[9];
 
@@ -36,12 +44,15 @@ extern Uint8* SDL_expand_byte[9];
 #define SDL_COPY_BLEND              0x00000010
 #define SDL_COPY_ADD                0x00000020
 #define SDL_COPY_MOD                0x00000040
+#define SDL_COPY_BLEND_PREMULTIPLIED 0x00000080
 #define SDL_COPY_COLORKEY           0x00000100
 #define SDL_COPY_NEAREST            0x00000200
+#define SDL_COPY_ADD_PREMULTIPLIED  0x00000400
 #define SDL_COPY_RLE_DESIRED        0x00001000
 #define SDL_COPY_RLE_COLORKEY       0x00002000
 #define SDL_COPY_RLE_ALPHAKEY       0x00004000
 #define SDL_COPY_RLE_MASK           (SDL_COPY_RLE_DESIRED|SDL_COPY_RLE_COLORKEY|SDL_COPY_RLE_ALPHAKEY)
+#define SDL_COPY_BLEND_MASK         (SDL_COPY_BLEND|SDL_COPY_BLEND_PREMULTIPLIED|SDL_COPY_ADD|SDL_COPY_ADD_PREMULTIPLIED|SDL_COPY_MOD)
 
 /* SDL blit CPU flags */
 #define SDL_CPU_ANY                 0x00000000
@@ -51,6 +62,8 @@ extern Uint8* SDL_expand_byte[9];
 #define SDL_CPU_SSE2                0x00000008
 #define SDL_CPU_ALTIVEC_PREFETCH    0x00000010
 #define SDL_CPU_ALTIVEC_NOPREFETCH  0x00000020
+#define SDL_CPU_AVX2                0x00000040
+#define SDL_CPU_NEON                0x00000080
 
 typedef struct
 {
@@ -99,6 +112,11 @@ typedef struct SDL_BlitMap
 
 /* Functions found in SDL_blit.c */
 extern int SDL_CalculateBlit(SDL_Surface * surface);
+extern Uint32 SDL_GetBlitCPUFeatures(void);
+
+/* Functions found in SDL_surface.c */
+extern int SDL_AllocSurfacePixels(SDL_Surface * surface, SDL_bool clear);
+extern void SDL_FreeSurfacePixels(SDL_Surface * surface);
 
 /* Functions found in SDL_blit_*.c */
 extern SDL_BlitFunc SDL_CalculateBlit0(SDL_Surface * surface);
@@ -543,6 +561,35 @@ do {                                                                    \
 
 #endif /* USE_DUFFS_LOOP */
 
+/* Lane helpers shared by the SIMD alpha blitters and the RLE blenders:
+   d + ((s - d) * a >> 8) on 16-bit lanes holding 8-bit values */
+#if HAVE_SSE2_INTRINSICS
+static SDL_INLINE __m128i
+BlendLanesSSE2(__m128i s, __m128i d, __m128i a)
+{
+    const __m128i x = _mm_mullo_epi16(_mm_sub_epi16(s, d), a);
+    return _mm_and_si128(_mm_add_epi16(d, _mm_srli_epi16(x, 8)), _mm_set1_epi16(0xff));
+}
+#endif
+
+#if HAVE_AVX2_INTRINSICS
+SDL_TARGETING("avx2") static SDL_INLINE __m256i
+BlendLanesAVX2(__m256i s, __m256i d, __m256i a)
+{
+    const __m256i x = _mm256_mullo_epi16(_mm256_sub_epi16(s, d), a);
+    return _mm256_and_si256(_mm256_add_epi16(d, _mm256_srli_epi16(x, 8)), _mm256_set1_epi16(0xff));
+}
+#endif
+
+#if HAVE_NEON_INTRINSICS
+/* same, narrowed back to the low 8 bits of each lane */
+static SDL_INLINE uint8x8_t
+BlendLanesNEON(uint8x8_t s, uint8x8_t d, uint16x8_t a)
+{
+    return vmovn_u16(vsraq_n_u16(vmovl_u8(d), vmulq_u16(vsubl_u8(s, d), a), 8));
+}
+#endif
+
 /* Prevent Visual C++ 6.0 from printing out stupid warnings */
 #if defined(_MSC_VER) && (_MSC_VER >= 600)
 #pragma warning(disable: 4550)
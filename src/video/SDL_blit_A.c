@@ -168,227 +168,6 @@ BlitNto1SurfaceAlphaKey(SDL_BlitInfo * info)
     }
 }
 
-#ifdef __MMX__
-
-/* fast RGB888->(A)RGB888 blending with surface alpha=128 special case */
-static void
-BlitRGBtoRGBSurfaceAlpha128MMX(SDL_BlitInfo * info)
-{
-    int width = info->dst_w;
-    int height = info->dst_h;
-    Uint32 *srcp = (Uint32 *) info->src;
-    int srcskip = info->src_skip >> 2;
-    Uint32 *dstp = (Uint32 *) info->dst;
-    int dstskip = info->dst_skip >> 2;
-    Uint32 dalpha = info->dst_fmt->Amask;
-
-    __m64 src1, src2, dst1, dst2, lmask, hmask, dsta;
-
-    hmask = _mm_set_pi32(0x00fefefe, 0x00fefefe);       /* alpha128 mask -> hmask */
-    lmask = _mm_set_pi32(0x00010101, 0x00010101);       /* !alpha128 mask -> lmask */
-    dsta = _mm_set_pi32(dalpha, dalpha);        /* dst alpha mask -> dsta */
-
-    while (height--) {
-        int n = width;
-        if (n & 1) {
-            Uint32 s = *srcp++;
-            Uint32 d = *dstp;
-            *dstp++ = ((((s & 0x00fefefe) + (d & 0x00fefefe)) >> 1)
-                       + (s & d & 0x00010101)) | dalpha;
-            n--;
-        }
-
-        for (n >>= 1; n > 0; --n) {
-            dst1 = *(__m64 *) dstp;     /* 2 x dst -> dst1(ARGBARGB) */
-            dst2 = dst1;        /* 2 x dst -> dst2(ARGBARGB) */
-
-            src1 = *(__m64 *) srcp;     /* 2 x src -> src1(ARGBARGB) */
-            src2 = src1;        /* 2 x src -> src2(ARGBARGB) */
-
-            dst2 = _mm_and_si64(dst2, hmask);   /* dst & mask -> dst2 */
-            src2 = _mm_and_si64(src2, hmask);   /* src & mask -> src2 */
-            src2 = _mm_add_pi32(src2, dst2);    /* dst2 + src2 -> src2 */
-            src2 = _mm_srli_pi32(src2, 1);      /* src2 >> 1 -> src2 */
-
-            dst1 = _mm_and_si64(dst1, src1);    /* src & dst -> dst1 */
-            dst1 = _mm_and_si64(dst1, lmask);   /* dst1 & !mask -> dst1 */
-            dst1 = _mm_add_pi32(dst1, src2);    /* src2 + dst1 -> dst1 */
-            dst1 = _mm_or_si64(dst1, dsta);     /* dsta(full alpha) | dst1 -> dst1 */
-
-            *(__m64 *) dstp = dst1;     /* dst1 -> 2 x dst pixels */
-            dstp += 2;
-            srcp += 2;
-        }
-
-        srcp += srcskip;
-        dstp += dstskip;
-    }
-    _mm_empty();
-}
-
-/* fast RGB888->(A)RGB888 blending with surface alpha */
-static void
-BlitRGBtoRGBSurfaceAlphaMMX(SDL_BlitInfo * info)
-{
-    SDL_PixelFormat *df = info->dst_fmt;
-    Uint32 chanmask;
-    unsigned alpha = info->a;
-
-    if (alpha == 128 && (df->Rmask | df->Gmask | df->Bmask) == 0x00FFFFFF) {
-        /* only call a128 version when R,G,B occupy lower bits */
-        BlitRGBtoRGBSurfaceAlpha128MMX(info);
-    } else {
-        int width = info->dst_w;
-        int height = info->dst_h;
-        Uint32 *srcp = (Uint32 *) info->src;
-        int srcskip = info->src_skip >> 2;
-        Uint32 *dstp = (Uint32 *) info->dst;
-        int dstskip = info->dst_skip >> 2;
-        Uint32 dalpha = df->Amask;
-        Uint32 amult;
-
-        __m64 src1, src2, dst1, dst2, mm_alpha, mm_zero, dsta;
-
-        mm_zero = _mm_setzero_si64();   /* 0 -> mm_zero */
-        /* form the alpha mult */
-        amult = alpha | (alpha << 8);
-        amult = amult | (amult << 16);
-        chanmask =
-            (0xff << df->Rshift) | (0xff << df->
-                                    Gshift) | (0xff << df->Bshift);
-        mm_alpha = _mm_set_pi32(0, amult & chanmask);   /* 0000AAAA -> mm_alpha, minus 1 chan */
-        mm_alpha = _mm_unpacklo_pi8(mm_alpha, mm_zero); /* 0A0A0A0A -> mm_alpha, minus 1 chan */
-        /* at this point mm_alpha can be 000A0A0A or 0A0A0A00 or another combo */
-        dsta = _mm_set_pi32(dalpha, dalpha);    /* dst alpha mask -> dsta */
-
-        while (height--) {
-            int n = width;
-            if (n & 1) {
-                /* One Pixel Blend */
-                src2 = _mm_cvtsi32_si64(*srcp); /* src(ARGB) -> src2 (0000ARGB) */
-                src2 = _mm_unpacklo_pi8(src2, mm_zero); /* 0A0R0G0B -> src2 */
-
-                dst1 = _mm_cvtsi32_si64(*dstp); /* dst(ARGB) -> dst1 (0000ARGB) */
-                dst1 = _mm_unpacklo_pi8(dst1, mm_zero); /* 0A0R0G0B -> dst1 */
-
-                src2 = _mm_sub_pi16(src2, dst1);        /* src2 - dst2 -> src2 */
-                src2 = _mm_mullo_pi16(src2, mm_alpha);  /* src2 * alpha -> src2 */
-                src2 = _mm_srli_pi16(src2, 8);  /* src2 >> 8 -> src2 */
-                dst1 = _mm_add_pi8(src2, dst1); /* src2 + dst1 -> dst1 */
-
-                dst1 = _mm_packs_pu16(dst1, mm_zero);   /* 0000ARGB -> dst1 */
-                dst1 = _mm_or_si64(dst1, dsta); /* dsta | dst1 -> dst1 */
-                *dstp = _mm_cvtsi64_si32(dst1); /* dst1 -> pixel */
-
-                ++srcp;
-                ++dstp;
-
-                n--;
-            }
-
-            for (n >>= 1; n > 0; --n) {
-                /* Two Pixels Blend */
-                src1 = *(__m64 *) srcp; /* 2 x src -> src1(ARGBARGB) */
-                src2 = src1;    /* 2 x src -> src2(ARGBARGB) */
-                src1 = _mm_unpacklo_pi8(src1, mm_zero); /* low - 0A0R0G0B -> src1 */
-                src2 = _mm_unpackhi_pi8(src2, mm_zero); /* high - 0A0R0G0B -> src2 */
-
-                dst1 = *(__m64 *) dstp; /* 2 x dst -> dst1(ARGBARGB) */
-                dst2 = dst1;    /* 2 x dst -> dst2(ARGBARGB) */
-                dst1 = _mm_unpacklo_pi8(dst1, mm_zero); /* low - 0A0R0G0B -> dst1 */
-                dst2 = _mm_unpackhi_pi8(dst2, mm_zero); /* high - 0A0R0G0B -> dst2 */
-
-                src1 = _mm_sub_pi16(src1, dst1);        /* src1 - dst1 -> src1 */
-                src1 = _mm_mullo_pi16(src1, mm_alpha);  /* src1 * alpha -> src1 */
-                src1 = _mm_srli_pi16(src1, 8);  /* src1 >> 8 -> src1 */
-                dst1 = _mm_add_pi8(src1, dst1); /* src1 + dst1(dst1) -> dst1 */
-
-                src2 = _mm_sub_pi16(src2, dst2);        /* src2 - dst2 -> src2 */
-                src2 = _mm_mullo_pi16(src2, mm_alpha);  /* src2 * alpha -> src2 */
-                src2 = _mm_srli_pi16(src2, 8);  /* src2 >> 8 -> src2 */
-                dst2 = _mm_add_pi8(src2, dst2); /* src2 + dst2(dst2) -> dst2 */
-
-                dst1 = _mm_packs_pu16(dst1, dst2);      /* 0A0R0G0B(res1), 0A0R0G0B(res2) -> dst1(ARGBARGB) */
-                dst1 = _mm_or_si64(dst1, dsta); /* dsta | dst1 -> dst1 */
-
-                *(__m64 *) dstp = dst1; /* dst1 -> 2 x pixel */
-
-                srcp += 2;
-                dstp += 2;
-            }
-            srcp += srcskip;
-            dstp += dstskip;
-        }
-        _mm_empty();
-    }
-}
-
-/* fast ARGB888->(A)RGB888 blending with pixel alpha */
-static void
-BlitRGBtoRGBPixelAlphaMMX(SDL_BlitInfo * info)
-{
-    int width = info->dst_w;
-    int height = info->dst_h;
-    Uint32 *srcp = (Uint32 *) info->src;
-    int srcskip = info->src_skip >> 2;
-    Uint32 *dstp = (Uint32 *) info->dst;
-    int dstskip = info->dst_skip >> 2;
-    SDL_PixelFormat *sf = info->src_fmt;
-    Uint32 amask = sf->Amask;
-    Uint32 ashift = sf->Ashift;
-    Uint64 multmask, multmask2;
-
-    __m64 src1, dst1, mm_alpha, mm_zero, mm_alpha2;
-
-    mm_zero = _mm_setzero_si64();       /* 0 -> mm_zero */
-    multmask = 0x00FF;
-    multmask <<= (ashift * 2);
-    multmask2 = 0x00FF00FF00FF00FFULL;
-
-    while (height--) {
-        /* *INDENT-OFF* */
-        DUFFS_LOOP4({
-        Uint32 alpha = *srcp & amask;
-        if (alpha == 0) {
-            /* do nothing */
-        } else if (alpha == amask) {
-            *dstp = *srcp;
-        } else {
-            src1 = _mm_cvtsi32_si64(*srcp); /* src(ARGB) -> src1 (0000ARGB) */
-            src1 = _mm_unpacklo_pi8(src1, mm_zero); /* 0A0R0G0B -> src1 */
-
-            dst1 = _mm_cvtsi32_si64(*dstp); /* dst(ARGB) -> dst1 (0000ARGB) */
-            dst1 = _mm_unpacklo_pi8(dst1, mm_zero); /* 0A0R0G0B -> dst1 */
-
-            mm_alpha = _mm_cvtsi32_si64(alpha); /* alpha -> mm_alpha (0000000A) */
-            mm_alpha = _mm_srli_si64(mm_alpha, ashift); /* mm_alpha >> ashift -> mm_alpha(0000000A) */
-            mm_alpha = _mm_unpacklo_pi16(mm_alpha, mm_alpha); /* 00000A0A -> mm_alpha */
-            mm_alpha2 = _mm_unpacklo_pi32(mm_alpha, mm_alpha); /* 0A0A0A0A -> mm_alpha2 */
-            mm_alpha = _mm_or_si64(mm_alpha2, *(__m64 *) & multmask);    /* 0F0A0A0A -> mm_alpha */
-            mm_alpha2 = _mm_xor_si64(mm_alpha2, *(__m64 *) & multmask2);    /* 255 - mm_alpha -> mm_alpha */
-
-            /* blend */            
-            src1 = _mm_mullo_pi16(src1, mm_alpha);
-            src1 = _mm_srli_pi16(src1, 8);
-            dst1 = _mm_mullo_pi16(dst1, mm_alpha2);
-            dst1 = _mm_srli_pi16(dst1, 8);
-            dst1 = _mm_add_pi16(src1, dst1);
-            dst1 = _mm_packs_pu16(dst1, mm_zero);
-            
-            *dstp = _mm_cvtsi64_si32(dst1); /* dst1 -> pixel */
-        }
-        ++srcp;
-        ++dstp;
-        }, width);
-        /* *INDENT-ON* */
-        srcp += srcskip;
-        dstp += dstskip;
-    }
-    _mm_empty();
-}
-
-#endif /* __MMX__ */
-
 /* fast RGB888->(A)RGB888 blending with surface alpha=128 special case */
 static void
 BlitRGBtoRGBSurfaceAlpha128(SDL_BlitInfo * info)
@@ -509,79 +288,6 @@ BlitRGBtoRGBPixelAlpha(SDL_BlitInfo * info)
     }
 }
 
-#ifdef __3dNOW__
-/* fast (as in MMX with prefetch) ARGB888->(A)RGB888 blending with pixel alpha */
-static void
-BlitRGBtoRGBPixelAlphaMMX3DNOW(SDL_BlitInfo * info)
-{
-    int width = info->dst_w;
-    int height = info->dst_h;
-    Uint32 *srcp = (Uint32 *) info->src;
-    int srcskip = info->src_skip >> 2;
-    Uint32 *dstp = (Uint32 *) info->dst;
-    int dstskip = info->dst_skip >> 2;
-    SDL_PixelFormat *sf = info->src_fmt;
-    Uint32 amask = sf->Amask;
-    Uint32 ashift = sf->Ashift;
-    Uint64 multmask, multmask2;
-
-    __m64 src1, dst1, mm_alpha, mm_zero, mm_alpha2;
-
-    mm_zero = _mm_setzero_si64();       /* 0 -> mm_zero */
-    multmask = 0x00FF;
-    multmask <<= (ashift * 2);
-    multmask2 = 0x00FF00FF00FF00FFULL;
-
-    while (height--) {
-        /* *INDENT-OFF* */
-        DUFFS_LOOP4({
-        Uint32 alpha;
-
-        _m_prefetch(srcp + 16);
-        _m_prefetch(dstp + 16);
-
-        alpha = *srcp & amask;
-        if (alpha == 0) {
-            /* do nothing */
-        } else if (alpha == amask) {
-            *dstp = *srcp;
-        } else {
-            src1 = _mm_cvtsi32_si64(*srcp); /* src(ARGB) -> src1 (0000ARGB) */
-            src1 = _mm_unpacklo_pi8(src1, mm_zero); /* 0A0R0G0B -> src1 */
-
-            dst1 = _mm_cvtsi32_si64(*dstp); /* dst(ARGB) -> dst1 (0000ARGB) */
-            dst1 = _mm_unpacklo_pi8(dst1, mm_zero); /* 0A0R0G0B -> dst1 */
-
-            mm_alpha = _mm_cvtsi32_si64(alpha); /* alpha -> mm_alpha (0000000A) */
-            mm_alpha = _mm_srli_si64(mm_alpha, ashift); /* mm_alpha >> ashift -> mm_alpha(0000000A) */
-            mm_alpha = _mm_unpacklo_pi16(mm_alpha, mm_alpha); /* 00000A0A -> mm_alpha */
-            mm_alpha2 = _mm_unpacklo_pi32(mm_alpha, mm_alpha); /* 0A0A0A0A -> mm_alpha2 */
-            mm_alpha = _mm_or_si64(mm_alpha2, *(__m64 *) & multmask);    /* 0F0A0A0A -> mm_alpha */
-            mm_alpha2 = _mm_xor_si64(mm_alpha2, *(__m64 *) & multmask2);    /* 255 - mm_alpha -> mm_alpha */
-
-
-            /* blend */            
-            src1 = _mm_mullo_pi16(src1, mm_alpha);
-            src1 = _mm_srli_pi16(src1, 8);
-            dst1 = _mm_mullo_pi16(dst1, mm_alpha2);
-            dst1 = _mm_srli_pi16(dst1, 8);
-            dst1 = _mm_add_pi16(src1, dst1);
-            dst1 = _mm_packs_pu16(dst1, mm_zero);
-            
-            *dstp = _mm_cvtsi64_si32(dst1); /* dst1 -> pixel */
-        }
-        ++srcp;
-        ++dstp;
-        }, width);
-        /* *INDENT-ON* */
-        srcp += srcskip;
-        dstp += dstskip;
-    }
-    _mm_empty();
-}
-
-#endif /* __3dNOW__ */
-
 /* 16bpp special case for per-surface alpha=50%: blend 2 pixels in parallel */
 
 /* blend a single 16 bit pixel at 50% */
@@ -692,11 +398,9 @@ Blit16to16SurfaceAlpha128(SDL_BlitInfo * info, Uint16 mask)
     }
 }
 
-#ifdef __MMX__
-
 /* fast RGB565->RGB565 blending with surface alpha */
 static void
-Blit565to565SurfaceAlphaMMX(SDL_BlitInfo * info)
+Blit565to565SurfaceAlpha(SDL_BlitInfo * info)
 {
     unsigned alpha = info->a;
     if (alpha == 128) {
@@ -708,55 +412,13 @@ Blit565to565SurfaceAlphaMMX(SDL_BlitInfo * info)
         int srcskip = info->src_skip >> 1;
         Uint16 *dstp = (Uint16 *) info->dst;
         int dstskip = info->dst_skip >> 1;
-        Uint32 s, d;
-
-        __m64 src1, dst1, src2, dst2, gmask, bmask, mm_res, mm_alpha;
-
-        alpha &= ~(1 + 2 + 4);  /* cut alpha to get the exact same behaviour */
-        mm_alpha = _mm_set_pi32(0, alpha);      /* 0000000A -> mm_alpha */
         alpha >>= 3;            /* downscale alpha to 5 bits */
 
-        mm_alpha = _mm_unpacklo_pi16(mm_alpha, mm_alpha);       /* 00000A0A -> mm_alpha */
-        mm_alpha = _mm_unpacklo_pi32(mm_alpha, mm_alpha);       /* 0A0A0A0A -> mm_alpha */
-        /* position alpha to allow for mullo and mulhi on diff channels
-           to reduce the number of operations */
-        mm_alpha = _mm_slli_si64(mm_alpha, 3);
-
-        /* Setup the 565 color channel masks */
-        gmask = _mm_set_pi32(0x07E007E0, 0x07E007E0);   /* MASKGREEN -> gmask */
-        bmask = _mm_set_pi32(0x001F001F, 0x001F001F);   /* MASKBLUE -> bmask */
-
         while (height--) {
             /* *INDENT-OFF* */
-            DUFFS_LOOP_124(
-            {
-                s = *srcp++;
-                d = *dstp;
-                /*
-                 * shift out the middle component (green) to
-                 * the high 16 bits, and process all three RGB
-                 * components at the same time.
-                 */
-                s = (s | s << 16) & 0x07e0f81f;
-                d = (d | d << 16) & 0x07e0f81f;
-                d += (s - d) * alpha >> 5;
-                d &= 0x07e0f81f;
-                *dstp++ = (Uint16)(d | d >> 16);
-            },{
-                s = *srcp++;
-                d = *dstp;
-                /*
-                 * shift out the middle component (green) to
-                 * the high 16 bits, and process all three RGB
-                 * components at the same time.
-                 */
-                s = (s | s << 16) & 0x07e0f81f;
-                d = (d | d << 16) & 0x07e0f81f;
-                d += (s - d) * alpha >> 5;
-                d &= 0x07e0f81f;
-                *dstp++ = (Uint16)(d | d >> 16);
-                s = *srcp++;
-                d = *dstp;
+            DUFFS_LOOP4({
+                Uint32 s = *srcp++;
+                Uint32 d = *dstp;
                 /*
                  * shift out the middle component (green) to
                  * the high 16 bits, and process all three RGB
@@ -767,75 +429,19 @@ Blit565to565SurfaceAlphaMMX(SDL_BlitInfo * info)
                 d += (s - d) * alpha >> 5;
                 d &= 0x07e0f81f;
                 *dstp++ = (Uint16)(d | d >> 16);
-            },{
-                src1 = *(__m64*)srcp; /* 4 src pixels -> src1 */
-                dst1 = *(__m64*)dstp; /* 4 dst pixels -> dst1 */
-
-                /* red */
-                src2 = src1;
-                src2 = _mm_srli_pi16(src2, 11); /* src2 >> 11 -> src2 [000r 000r 000r 000r] */
-
-                dst2 = dst1;
-                dst2 = _mm_srli_pi16(dst2, 11); /* dst2 >> 11 -> dst2 [000r 000r 000r 000r] */
-
-                /* blend */
-                src2 = _mm_sub_pi16(src2, dst2);/* src - dst -> src2 */
-                src2 = _mm_mullo_pi16(src2, mm_alpha); /* src2 * alpha -> src2 */
-                src2 = _mm_srli_pi16(src2, 11); /* src2 >> 11 -> src2 */
-                dst2 = _mm_add_pi16(src2, dst2); /* src2 + dst2 -> dst2 */
-                dst2 = _mm_slli_pi16(dst2, 11); /* dst2 << 11 -> dst2 */
-
-                mm_res = dst2; /* RED -> mm_res */
-
-                /* green -- process the bits in place */
-                src2 = src1;
-                src2 = _mm_and_si64(src2, gmask); /* src & MASKGREEN -> src2 */
-
-                dst2 = dst1;
-                dst2 = _mm_and_si64(dst2, gmask); /* dst & MASKGREEN -> dst2 */
-
-                /* blend */
-                src2 = _mm_sub_pi16(src2, dst2);/* src - dst -> src2 */
-                src2 = _mm_mulhi_pi16(src2, mm_alpha); /* src2 * alpha -> src2 */
-                src2 = _mm_slli_pi16(src2, 5); /* src2 << 5 -> src2 */
-                dst2 = _mm_add_pi16(src2, dst2); /* src2 + dst2 -> dst2 */
-
-                mm_res = _mm_or_si64(mm_res, dst2); /* RED | GREEN -> mm_res */
-
-                /* blue */
-                src2 = src1;
-                src2 = _mm_and_si64(src2, bmask); /* src & MASKBLUE -> src2[000b 000b 000b 000b] */
-
-                dst2 = dst1;
-                dst2 = _mm_and_si64(dst2, bmask); /* dst & MASKBLUE -> dst2[000b 000b 000b 000b] */
-
-                /* blend */
-                src2 = _mm_sub_pi16(src2, dst2);/* src - dst -> src2 */
-                src2 = _mm_mullo_pi16(src2, mm_alpha); /* src2 * alpha -> src2 */
-                src2 = _mm_srli_pi16(src2, 11); /* src2 >> 11 -> src2 */
-                dst2 = _mm_add_pi16(src2, dst2); /* src2 + dst2 -> dst2 */
-                dst2 = _mm_and_si64(dst2, bmask); /* dst2 & MASKBLUE -> dst2 */
-
-                mm_res = _mm_or_si64(mm_res, dst2); /* RED | GREEN | BLUE -> mm_res */
-
-                *(__m64*)dstp = mm_res; /* mm_res -> 4 dst pixels */
-
-                srcp += 4;
-                dstp += 4;
             }, width);
             /* *INDENT-ON* */
             srcp += srcskip;
             dstp += dstskip;
         }
-        _mm_empty();
     }
 }
 
 /* fast RGB555->RGB555 blending with surface alpha */
 static void
-Blit555to555SurfaceAlphaMMX(SDL_BlitInfo * info)
+Blit555to555SurfaceAlpha(SDL_BlitInfo * info)
 {
-    unsigned alpha = info->a;
+    unsigned alpha = info->a;   /* downscale alpha to 5 bits */
     if (alpha == 128) {
         Blit16to16SurfaceAlpha128(info, 0xfbde);
     } else {
@@ -845,56 +451,13 @@ Blit555to555SurfaceAlphaMMX(SDL_BlitInfo * info)
         int srcskip = info->src_skip >> 1;
         Uint16 *dstp = (Uint16 *) info->dst;
         int dstskip = info->dst_skip >> 1;
-        Uint32 s, d;
-
-        __m64 src1, dst1, src2, dst2, rmask, gmask, bmask, mm_res, mm_alpha;
-
-        alpha &= ~(1 + 2 + 4);  /* cut alpha to get the exact same behaviour */
-        mm_alpha = _mm_set_pi32(0, alpha);      /* 0000000A -> mm_alpha */
         alpha >>= 3;            /* downscale alpha to 5 bits */
 
-        mm_alpha = _mm_unpacklo_pi16(mm_alpha, mm_alpha);       /* 00000A0A -> mm_alpha */
-        mm_alpha = _mm_unpacklo_pi32(mm_alpha, mm_alpha);       /* 0A0A0A0A -> mm_alpha */
-        /* position alpha to allow for mullo and mulhi on diff channels
-           to reduce the number of operations */
-        mm_alpha = _mm_slli_si64(mm_alpha, 3);
-
-        /* Setup the 555 color channel masks */
-        rmask = _mm_set_pi32(0x7C007C00, 0x7C007C00);   /* MASKRED -> rmask */
-        gmask = _mm_set_pi32(0x03E003E0, 0x03E003E0);   /* MASKGREEN -> gmask */
-        bmask = _mm_set_pi32(0x001F001F, 0x001F001F);   /* MASKBLUE -> bmask */
-
         while (height--) {
             /* *INDENT-OFF* */
-            DUFFS_LOOP_124(
-            {
-                s = *srcp++;
-                d = *dstp;
-                /*
-                 * shift out the middle component (green) to
-                 * the high 16 bits, and process all three RGB
-                 * components at the same time.
-                 */
-                s = (s | s << 16) & 0x03e07c1f;
-                d = (d | d << 16) & 0x03e07c1f;
-                d += (s - d) * alpha >> 5;
-                d &= 0x03e07c1f;
-                *dstp++ = (Uint16)(d | d >> 16);
-            },{
-                s = *srcp++;
-                d = *dstp;
-                /*
-                 * shift out the middle component (green) to
-                 * the high 16 bits, and process all three RGB
-                 * components at the same time.
-                 */
-                s = (s | s << 16) & 0x03e07c1f;
-                d = (d | d << 16) & 0x03e07c1f;
-                d += (s - d) * alpha >> 5;
-                d &= 0x03e07c1f;
-                *dstp++ = (Uint16)(d | d >> 16);
-                    s = *srcp++;
-                d = *dstp;
+            DUFFS_LOOP4({
+                Uint32 s = *srcp++;
+                Uint32 d = *dstp;
                 /*
                  * shift out the middle component (green) to
                  * the high 16 bits, and process all three RGB
@@ -905,199 +468,1068 @@ Blit555to555SurfaceAlphaMMX(SDL_BlitInfo * info)
                 d += (s - d) * alpha >> 5;
                 d &= 0x03e07c1f;
                 *dstp++ = (Uint16)(d | d >> 16);
-            },{
-                src1 = *(__m64*)srcp; /* 4 src pixels -> src1 */
-                dst1 = *(__m64*)dstp; /* 4 dst pixels -> dst1 */
-
-                /* red -- process the bits in place */
-                src2 = src1;
-                src2 = _mm_and_si64(src2, rmask); /* src & MASKRED -> src2 */
-
-                dst2 = dst1;
-                dst2 = _mm_and_si64(dst2, rmask); /* dst & MASKRED -> dst2 */
-
-                /* blend */
-                src2 = _mm_sub_pi16(src2, dst2);/* src - dst -> src2 */
-                src2 = _mm_mulhi_pi16(src2, mm_alpha); /* src2 * alpha -> src2 */
-                src2 = _mm_slli_pi16(src2, 5); /* src2 << 5 -> src2 */
-                dst2 = _mm_add_pi16(src2, dst2); /* src2 + dst2 -> dst2 */
-                dst2 = _mm_and_si64(dst2, rmask); /* dst2 & MASKRED -> dst2 */
-
-                mm_res = dst2; /* RED -> mm_res */
-                
-                /* green -- process the bits in place */
-                src2 = src1;
-                src2 = _mm_and_si64(src2, gmask); /* src & MASKGREEN -> src2 */
-
-                dst2 = dst1;
-                dst2 = _mm_and_si64(dst2, gmask); /* dst & MASKGREEN -> dst2 */
-
-                /* blend */
-                src2 = _mm_sub_pi16(src2, dst2);/* src - dst -> src2 */
-                src2 = _mm_mulhi_pi16(src2, mm_alpha); /* src2 * alpha -> src2 */
-                src2 = _mm_slli_pi16(src2, 5); /* src2 << 5 -> src2 */
-                dst2 = _mm_add_pi16(src2, dst2); /* src2 + dst2 -> dst2 */
-
-                mm_res = _mm_or_si64(mm_res, dst2); /* RED | GREEN -> mm_res */
-
-                /* blue */
-                src2 = src1; /* src -> src2 */
-                src2 = _mm_and_si64(src2, bmask); /* src & MASKBLUE -> src2[000b 000b 000b 000b] */
-
-                dst2 = dst1; /* dst -> dst2 */
-                dst2 = _mm_and_si64(dst2, bmask); /* dst & MASKBLUE -> dst2[000b 000b 000b 000b] */
-
-                /* blend */
-                src2 = _mm_sub_pi16(src2, dst2);/* src - dst -> src2 */
-                src2 = _mm_mullo_pi16(src2, mm_alpha); /* src2 * alpha -> src2 */
-                src2 = _mm_srli_pi16(src2, 11); /* src2 >> 11 -> src2 */
-                dst2 = _mm_add_pi16(src2, dst2); /* src2 + dst2 -> dst2 */
-                dst2 = _mm_and_si64(dst2, bmask); /* dst2 & MASKBLUE -> dst2 */
-
-                mm_res = _mm_or_si64(mm_res, dst2); /* RED | GREEN | BLUE -> mm_res */
-
-                *(__m64*)dstp = mm_res; /* mm_res -> 4 dst pixels */
-
-                srcp += 4;
-                dstp += 4;
             }, width);
             /* *INDENT-ON* */
             srcp += srcskip;
             dstp += dstskip;
         }
-        _mm_empty();
     }
 }
 
-#endif /* __MMX__ */
-
-/* fast RGB565->RGB565 blending with surface alpha */
+/* fast ARGB8888->RGB565 blending with pixel alpha */
 static void
-Blit565to565SurfaceAlpha(SDL_BlitInfo * info)
+BlitARGBto565PixelAlpha(SDL_BlitInfo * info)
 {
-    unsigned alpha = info->a;
-    if (alpha == 128) {
-        Blit16to16SurfaceAlpha128(info, 0xf7de);
-    } else {
-        int width = info->dst_w;
-        int height = info->dst_h;
-        Uint16 *srcp = (Uint16 *) info->src;
-        int srcskip = info->src_skip >> 1;
-        Uint16 *dstp = (Uint16 *) info->dst;
-        int dstskip = info->dst_skip >> 1;
-        alpha >>= 3;            /* downscale alpha to 5 bits */
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint16 *dstp = (Uint16 *) info->dst;
+    int dstskip = info->dst_skip >> 1;
 
-        while (height--) {
-            /* *INDENT-OFF* */
-            DUFFS_LOOP4({
-                Uint32 s = *srcp++;
-                Uint32 d = *dstp;
-                /*
-                 * shift out the middle component (green) to
-                 * the high 16 bits, and process all three RGB
-                 * components at the same time.
-                 */
-                s = (s | s << 16) & 0x07e0f81f;
-                d = (d | d << 16) & 0x07e0f81f;
-                d += (s - d) * alpha >> 5;
-                d &= 0x07e0f81f;
-                *dstp++ = (Uint16)(d | d >> 16);
-            }, width);
-            /* *INDENT-ON* */
-            srcp += srcskip;
-            dstp += dstskip;
+    while (height--) {
+        /* *INDENT-OFF* */
+        DUFFS_LOOP4({
+        Uint32 s = *srcp;
+        unsigned alpha = s >> 27; /* downscale alpha to 5 bits */
+        /* FIXME: Here we special-case opaque alpha since the
+           compositioning used (>>8 instead of /255) doesn't handle
+           it correctly. Also special-case alpha=0 for speed?
+           Benchmark this! */
+        if(alpha) {   
+          if(alpha == (SDL_ALPHA_OPAQUE >> 3)) {
+            *dstp = (Uint16)((s >> 8 & 0xf800) + (s >> 5 & 0x7e0) + (s >> 3  & 0x1f));
+          } else {
+            Uint32 d = *dstp;
+            /*
+             * convert source and destination to G0RAB65565
+             * and blend all components at the same time
+             */
+            s = ((s & 0xfc00) << 11) + (s >> 8 & 0xf800)
+              + (s >> 3 & 0x1f);
+            d = (d | d << 16) & 0x07e0f81f;
+            d += (s - d) * alpha >> 5;
+            d &= 0x07e0f81f;
+            *dstp = (Uint16)(d | d >> 16);
+          }
+        }
+        srcp++;
+        dstp++;
+        }, width);
+        /* *INDENT-ON* */
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+
+/* fast ARGB8888->RGB555 blending with pixel alpha */
+static void
+BlitARGBto555PixelAlpha(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint16 *dstp = (Uint16 *) info->dst;
+    int dstskip = info->dst_skip >> 1;
+
+    while (height--) {
+        /* *INDENT-OFF* */
+        DUFFS_LOOP4({
+        unsigned alpha;
+        Uint32 s = *srcp;
+        alpha = s >> 27; /* downscale alpha to 5 bits */
+        /* FIXME: Here we special-case opaque alpha since the
+           compositioning used (>>8 instead of /255) doesn't handle
+           it correctly. Also special-case alpha=0 for speed?
+           Benchmark this! */
+        if(alpha) {   
+          if(alpha == (SDL_ALPHA_OPAQUE >> 3)) {
+            *dstp = (Uint16)((s >> 9 & 0x7c00) + (s >> 6 & 0x3e0) + (s >> 3  & 0x1f));
+          } else {
+            Uint32 d = *dstp;
+            /*
+             * convert source and destination to G0RAB65565
+             * and blend all components at the same time
+             */
+            s = ((s & 0xf800) << 10) + (s >> 9 & 0x7c00)
+              + (s >> 3 & 0x1f);
+            d = (d | d << 16) & 0x03e07c1f;
+            d += (s - d) * alpha >> 5;
+            d &= 0x03e07c1f;
+            *dstp = (Uint16)(d | d >> 16);
+          }
+        }
+        srcp++;
+        dstp++;
+        }, width);
+        /* *INDENT-ON* */
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+
+/*
+ * SIMD blitters.
+ *
+ * These produce exactly the same pixels as the scalar versions above: every
+ * color channel is blended as d + ((s - d) * alpha >> 8) (or >> 5 for the
+ * 5-bit alpha used with 16-bit destinations), which only needs the low 16
+ * bits of the product, so it maps directly onto 16-bit vector lanes.
+ */
+
+/* Blend all four bytes of an 8888 pixel with per-surface alpha */
+static SDL_INLINE Uint32
+BlendRGBtoRGBSurfaceAlpha(Uint32 s, Uint32 d, Uint32 alpha, Uint32 fill)
+{
+    Uint32 s1 = s & 0xff00ff;
+    Uint32 d1 = d & 0xff00ff;
+    Uint32 s2 = (s >> 8) & 0xff00ff;
+    Uint32 d2 = (d >> 8) & 0xff00ff;
+    d1 = (d1 + ((s1 - d1) * alpha >> 8)) & 0xff00ff;
+    d2 = (d2 + ((s2 - d2) * alpha >> 8)) & 0xff00ff;
+    return d1 | (d2 << 8) | fill;
+}
+
+/* Blend an 8888 pixel with its own alpha, which may be in any byte */
+static SDL_INLINE Uint32
+BlendRGBtoRGBPixelAlpha(Uint32 s, Uint32 d, Uint32 ashift)
+{
+    Uint32 alpha = (s >> ashift) & 0xff;
+    Uint32 dalpha;
+    if (alpha == 0) {
+        return d;
+    } else if (alpha == SDL_ALPHA_OPAQUE) {
+        return s;
+    }
+    dalpha = (d >> ashift) & 0xff;
+    dalpha = alpha + (dalpha * (alpha ^ 0xFF) >> 8);
+    return (BlendRGBtoRGBSurfaceAlpha(s, d, alpha, 0) & ~(0xffu << ashift)) | (dalpha << ashift);
+}
+
+/* Blend a 565 or 555 pixel with a 5-bit surface alpha */
+static SDL_INLINE Uint16
+Blend16to16SurfaceAlpha(Uint32 s, Uint32 d, Uint32 alpha, Uint32 mask)
+{
+    s = (s | s << 16) & mask;
+    d = (d | d << 16) & mask;
+    d += (s - d) * alpha >> 5;
+    d &= mask;
+    return (Uint16)(d | d >> 16);
+}
+
+/* Blend an ARGB8888 pixel onto a 565 (gshift 10) or 555 (gshift 11) pixel */
+static SDL_INLINE Uint16
+BlendARGBto16PixelAlpha(Uint32 s, Uint32 d, int gshift)
+{
+    const int rshift = (gshift == 10) ? 11 : 10;
+    const Uint32 gmask = (gshift == 10) ? 0x3f : 0x1f;
+    const Uint32 mask = (gshift == 10) ? 0x07e0f81f : 0x03e07c1f;
+    unsigned alpha = s >> 27;   /* downscale alpha to 5 bits */
+    if (alpha == 0) {
+        return (Uint16)d;
+    }
+    s = (((s >> 19) & 0x1f) << rshift) | (((s >> gshift) & gmask) << 5) | ((s >> 3) & 0x1f);
+    if (alpha == (SDL_ALPHA_OPAQUE >> 3)) {
+        return (Uint16)s;
+    }
+    return Blend16to16SurfaceAlpha(s, d, alpha, mask);
+}
+
+/* Add two pairs of 8-bit values held in 16-bit lanes, clamping at 255 */
+#define ADD_LANES_SATURATE(s, d)                                        \
+    ((((s) + (d)) | ((((s) + (d)) >> 8) & 0x10001) * 0xff) & 0xff00ff)
+
+/* Composite a premultiplied 8888 pixel over another: s + d * (255 - sA) / 255 */
+static SDL_INLINE Uint32
+BlendRGBtoRGBPremultiplied(Uint32 s, Uint32 d, Uint32 ashift)
+{
+    const Uint32 inva = ((s >> ashift) & 0xff) ^ 0xff;
+    Uint32 d1 = (d & 0xff00ff) * inva;
+    Uint32 d2 = ((d >> 8) & 0xff00ff) * inva;
+    /* exact division by 255 of both lanes */
+    d1 = ((d1 + 0x10001 + ((d1 >> 8) & 0xff00ff)) >> 8) & 0xff00ff;
+    d2 = ((d2 + 0x10001 + ((d2 >> 8) & 0xff00ff)) >> 8) & 0xff00ff;
+    d1 = ADD_LANES_SATURATE(s & 0xff00ff, d1);
+    d2 = ADD_LANES_SATURATE((s >> 8) & 0xff00ff, d2);
+    return d1 | (d2 << 8);
+}
+
+/* Add the color of a premultiplied 8888 pixel to another, leaving alpha alone */
+static SDL_INLINE Uint32
+BlendRGBtoRGBAddPremultiplied(Uint32 s, Uint32 d, Uint32 rgbmask)
+{
+    Uint32 d1, d2;
+    s &= rgbmask;
+    d1 = ADD_LANES_SATURATE(s & 0xff00ff, d & 0xff00ff);
+    d2 = ADD_LANES_SATURATE((s >> 8) & 0xff00ff, (d >> 8) & 0xff00ff);
+    return d1 | (d2 << 8);
+}
+
+/* Premultiplied ARGB8888->(A)RGB8888 blending */
+static void
+BlitRGBtoRGBPremultiplied(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint32 *dstp = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip >> 2;
+    const Uint32 ashift = info->src_fmt->Ashift;
+    const SDL_PixelFormat *df = info->dst_fmt;
+    const Uint32 dmask = df->Amask ? 0xffffffff : (df->Rmask | df->Gmask | df->Bmask);
+
+    while (height--) {
+        int n = width;
+        while (n--) {
+            *dstp = BlendRGBtoRGBPremultiplied(*srcp, *dstp, ashift) & dmask;
+            ++srcp;
+            ++dstp;
+        }
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+
+/* Premultiplied ARGB8888->(A)RGB8888 additive blending */
+static void
+BlitRGBtoRGBAddPremultiplied(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint32 *dstp = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip >> 2;
+    const SDL_PixelFormat *df = info->dst_fmt;
+    const Uint32 rgbmask = df->Rmask | df->Gmask | df->Bmask;
+    const Uint32 dmask = df->Amask ? 0xffffffff : rgbmask;
+
+    while (height--) {
+        int n = width;
+        while (n--) {
+            *dstp = BlendRGBtoRGBAddPremultiplied(*srcp, *dstp, rgbmask) & dmask;
+            ++srcp;
+            ++dstp;
+        }
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+
+#if HAVE_SSE2_INTRINSICS
+
+/* SSE2 (A)RGB8888->(A)RGB8888 blending with surface alpha, 4 pixels at a time */
+static void
+BlitRGBtoRGBSurfaceAlphaSSE2(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint32 *dstp = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip >> 2;
+    const SDL_PixelFormat *df = info->dst_fmt;
+    const Uint32 alpha = info->a;
+    const Uint32 fill = ~(df->Rmask | df->Gmask | df->Bmask);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mm_alpha = _mm_set1_epi16((short) alpha);
+    const __m128i mm_fill = _mm_set1_epi32((int) fill);
+
+    while (height--) {
+        int n = width;
+        for (; n >= 4; n -= 4, srcp += 4, dstp += 4) {
+            const __m128i s = _mm_loadu_si128((const __m128i *) srcp);
+            const __m128i d = _mm_loadu_si128((const __m128i *) dstp);
+            const __m128i lo = BlendLanesSSE2(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), mm_alpha);
+            const __m128i hi = BlendLanesSSE2(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), mm_alpha);
+            _mm_storeu_si128((__m128i *) dstp, _mm_or_si128(_mm_packus_epi16(lo, hi), mm_fill));
+        }
+        while (n--) {
+            *dstp = BlendRGBtoRGBSurfaceAlpha(*srcp, *dstp, alpha, fill);
+            ++srcp;
+            ++dstp;
+        }
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+
+/* SSE2 ARGB8888->(A)RGB8888 blending with pixel alpha, 4 pixels at a time */
+static void
+BlitRGBtoRGBPixelAlphaSSE2(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint32 *dstp = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip >> 2;
+    const Uint32 ashift = info->src_fmt->Ashift;
+    const __m128i mm_ashift = _mm_cvtsi32_si128((int) ashift);
+    const __m128i mm_amask = _mm_sll_epi32(_mm_set1_epi32(0xff), mm_ashift);
+    const __m128i mm_ff = _mm_set1_epi32(0xff);
+    const __m128i zero = _mm_setzero_si128();
+
+    while (height--) {
+        int n = width;
+        for (; n >= 4; n -= 4, srcp += 4, dstp += 4) {
+            const __m128i s = _mm_loadu_si128((const __m128i *) srcp);
+            const __m128i d = _mm_loadu_si128((const __m128i *) dstp);
+            const __m128i alpha = _mm_and_si128(_mm_srl_epi32(s, mm_ashift), mm_ff);
+            const __m128i clear = _mm_cmpeq_epi32(alpha, zero);
+            const __m128i opaque = _mm_cmpeq_epi32(alpha, mm_ff);
+            __m128i alpha8, dalpha, lo, hi, res;
+
+            if (_mm_movemask_epi8(clear) == 0xffff) {
+                continue;
+            } else if (_mm_movemask_epi8(opaque) == 0xffff) {
+                _mm_storeu_si128((__m128i *) dstp, s);
+                continue;
+            }
+
+            /* spread each pixel's alpha over all four of its bytes */
+            alpha8 = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 8));
+            alpha8 = _mm_or_si128(alpha8, _mm_slli_epi32(alpha8, 16));
+
+            lo = BlendLanesSSE2(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(alpha8, zero));
+            hi = BlendLanesSSE2(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(alpha8, zero));
+            res = _mm_packus_epi16(lo, hi);
+
+            /* dalpha = alpha + (dalpha * (255 - alpha) >> 8), all values fit in 16 bits */
+            dalpha = _mm_and_si128(_mm_srl_epi32(d, mm_ashift), mm_ff);
+            dalpha = _mm_mullo_epi16(dalpha, _mm_xor_si128(alpha, mm_ff));
+            dalpha = _mm_add_epi32(alpha, _mm_srli_epi32(dalpha, 8));
+            res = _mm_or_si128(_mm_andnot_si128(mm_amask, res), _mm_sll_epi32(dalpha, mm_ashift));
+
+            res = _mm_or_si128(_mm_and_si128(opaque, s), _mm_andnot_si128(opaque, res));
+            res = _mm_or_si128(_mm_and_si128(clear, d), _mm_andnot_si128(clear, res));
+            _mm_storeu_si128((__m128i *) dstp, res);
+        }
+        while (n--) {
+            *dstp = BlendRGBtoRGBPixelAlpha(*srcp, *dstp, ashift);
+            ++srcp;
+            ++dstp;
+        }
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+
+/* SSE2 RGB565/555->RGB565/555 blending with surface alpha, 8 pixels at a time */
+static void
+Blit16to16SurfaceAlphaSSE2(SDL_BlitInfo * info, int rshift, Uint16 gmask, Uint32 mask)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint16 *srcp = (Uint16 *) info->src;
+    int srcskip = info->src_skip >> 1;
+    Uint16 *dstp = (Uint16 *) info->dst;
+    int dstskip = info->dst_skip >> 1;
+    const unsigned alpha = info->a >> 3;    /* downscale alpha to 5 bits */
+    const __m128i mm_alpha = _mm_set1_epi16((short) alpha);
+    const __m128i mm_rshift = _mm_cvtsi32_si128(rshift);
+    const __m128i mm_gmask = _mm_set1_epi16((short) gmask);
+    const __m128i mm_5bits = _mm_set1_epi16(0x1f);
+
+    while (height--) {
+        int n = width;
+        for (; n >= 8; n -= 8, srcp += 8, dstp += 8) {
+            const __m128i s = _mm_loadu_si128((const __m128i *) srcp);
+            const __m128i d = _mm_loadu_si128((const __m128i *) dstp);
+            __m128i dr = _mm_and_si128(_mm_srl_epi16(d, mm_rshift), mm_5bits);
+            __m128i dg = _mm_and_si128(_mm_srli_epi16(d, 5), mm_gmask);
+            __m128i db = _mm_and_si128(d, mm_5bits);
+            const __m128i sr = _mm_and_si128(_mm_srl_epi16(s, mm_rshift), mm_5bits);
+            const __m128i sg = _mm_and_si128(_mm_srli_epi16(s, 5), mm_gmask);
+            const __m128i sb = _mm_and_si128(s, mm_5bits);
+
+            dr = _mm_add_epi16(dr, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(sr, dr), mm_alpha), 5));
+            dg = _mm_add_epi16(dg, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(sg, dg), mm_alpha), 5));
+            db = _mm_add_epi16(db, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(sb, db), mm_alpha), 5));
+            _mm_storeu_si128((__m128i *) dstp,
+                _mm_or_si128(_mm_or_si128(_mm_sll_epi16(dr, mm_rshift), _mm_slli_epi16(dg, 5)), db));
+        }
+        while (n--) {
+            *dstp = Blend16to16SurfaceAlpha(*srcp, *dstp, alpha, mask);
+            ++srcp;
+            ++dstp;
+        }
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+
+static void
+Blit565to565SurfaceAlphaSSE2(SDL_BlitInfo * info)
+{
+    Blit16to16SurfaceAlphaSSE2(info, 11, 0x3f, 0x07e0f81f);
+}
+
+static void
+Blit555to555SurfaceAlphaSSE2(SDL_BlitInfo * info)
+{
+    Blit16to16SurfaceAlphaSSE2(info, 10, 0x1f, 0x03e07c1f);
+}
+
+/* SSE2 ARGB8888->RGB565/555 blending with pixel alpha, 8 pixels at a time */
+static void
+BlitARGBto16PixelAlphaSSE2(SDL_BlitInfo * info, int gshift)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint16 *dstp = (Uint16 *) info->dst;
+    int dstskip = info->dst_skip >> 1;
+    const int rshift = (gshift == 10) ? 11 : 10;
+    const __m128i mm_rshift = _mm_cvtsi32_si128(rshift);
+    const __m128i mm_gshift = _mm_cvtsi32_si128(gshift);
+    const __m128i mm_gmask16 = _mm_set1_epi16((gshift == 10) ? 0x3f : 0x1f);
+    const __m128i mm_gmask32 = _mm_set1_epi32((gshift == 10) ? 0x3f : 0x1f);
+    const __m128i mm_5bits16 = _mm_set1_epi16(0x1f);
+    const __m128i mm_5bits32 = _mm_set1_epi32(0x1f);
+    const __m128i mm_opaque = _mm_set1_epi16(SDL_ALPHA_OPAQUE >> 3);
+    const __m128i zero = _mm_setzero_si128();
+
+    while (height--) {
+        int n = width;
+        for (; n >= 8; n -= 8, srcp += 8, dstp += 8) {
+            const __m128i s0 = _mm_loadu_si128((const __m128i *) srcp);
+            const __m128i s1 = _mm_loadu_si128((const __m128i *) (srcp + 4));
+            const __m128i d = _mm_loadu_si128((const __m128i *) dstp);
+            const __m128i alpha = _mm_packs_epi32(_mm_srli_epi32(s0, 27), _mm_srli_epi32(s1, 27));
+            const __m128i clear = _mm_cmpeq_epi16(alpha, zero);
+            const __m128i opaque = _mm_cmpeq_epi16(alpha, mm_opaque);
+            const __m128i sr = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(s0, 19), mm_5bits32),
+                                               _mm_and_si128(_mm_srli_epi32(s1, 19), mm_5bits32));
+            const __m128i sg = _mm_packs_epi32(_mm_and_si128(_mm_srl_epi32(s0, mm_gshift), mm_gmask32),
+                                               _mm_and_si128(_mm_srl_epi32(s1, mm_gshift), mm_gmask32));
+            const __m128i sb = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(s0, 3), mm_5bits32),
+                                               _mm_and_si128(_mm_srli_epi32(s1, 3), mm_5bits32));
+            __m128i dr, dg, db, res;
+
+            if (_mm_movemask_epi8(clear) == 0xffff) {
+                continue;
+            }
+
+            dr = _mm_and_si128(_mm_srl_epi16(d, mm_rshift), mm_5bits16);
+            dg = _mm_and_si128(_mm_srli_epi16(d, 5), mm_gmask16);
+            db = _mm_and_si128(d, mm_5bits16);
+            dr = _mm_add_epi16(dr, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(sr, dr), alpha), 5));
+            dg = _mm_add_epi16(dg, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(sg, dg), alpha), 5));
+            db = _mm_add_epi16(db, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(sb, db), alpha), 5));
+
+            /* opaque pixels take the source color as is */
+            dr = _mm_or_si128(_mm_and_si128(opaque, sr), _mm_andnot_si128(opaque, dr));
+            dg = _mm_or_si128(_mm_and_si128(opaque, sg), _mm_andnot_si128(opaque, dg));
+            db = _mm_or_si128(_mm_and_si128(opaque, sb), _mm_andnot_si128(opaque, db));
+            res = _mm_or_si128(_mm_or_si128(_mm_sll_epi16(dr, mm_rshift), _mm_slli_epi16(dg, 5)), db);
+
+            res = _mm_or_si128(_mm_and_si128(clear, d), _mm_andnot_si128(clear, res));
+            _mm_storeu_si128((__m128i *) dstp, res);
+        }
+        while (n--) {
+            *dstp = BlendARGBto16PixelAlpha(*srcp, *dstp, gshift);
+            ++srcp;
+            ++dstp;
+        }
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+
+static void
+BlitARGBto565PixelAlphaSSE2(SDL_BlitInfo * info)
+{
+    BlitARGBto16PixelAlphaSSE2(info, 10);
+}
+
+static void
+BlitARGBto555PixelAlphaSSE2(SDL_BlitInfo * info)
+{
+    BlitARGBto16PixelAlphaSSE2(info, 11);
+}
+
+/* SSE2 premultiplied ARGB8888->(A)RGB8888 blending, 4 pixels at a time */
+static void
+BlitRGBtoRGBPremultipliedSSE2(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint32 *dstp = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip >> 2;
+    const Uint32 ashift = info->src_fmt->Ashift;
+    const SDL_PixelFormat *df = info->dst_fmt;
+    const Uint32 dmask = df->Amask ? 0xffffffff : (df->Rmask | df->Gmask | df->Bmask);
+    const __m128i mm_ashift = _mm_cvtsi32_si128((int) ashift);
+    const __m128i mm_dmask = _mm_set1_epi32((int) dmask);
+    const __m128i mm_ff = _mm_set1_epi32(0xff);
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i zero = _mm_setzero_si128();
+
+    while (height--) {
+        int n = width;
+        for (; n >= 4; n -= 4, srcp += 4, dstp += 4) {
+            const __m128i s = _mm_loadu_si128((const __m128i *) srcp);
+            const __m128i d = _mm_loadu_si128((const __m128i *) dstp);
+            __m128i inva, lo, hi;
+
+            inva = _mm_xor_si128(_mm_and_si128(_mm_srl_epi32(s, mm_ashift), mm_ff), mm_ff);
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(s, zero)) == 0xffff) {
+                /* fully transparent, nothing to add, but masked like the rest */
+                _mm_storeu_si128((__m128i *) dstp, _mm_and_si128(d, mm_dmask));
+                continue;
+            } else if (_mm_movemask_epi8(_mm_cmpeq_epi32(inva, zero)) == 0xffff) {
+                /* fully opaque, the destination doesn't show through */
+                _mm_storeu_si128((__m128i *) dstp, _mm_and_si128(s, mm_dmask));
+                continue;
+            }
+
+            /* spread each pixel's 255 - alpha over all four of its bytes */
+            inva = _mm_or_si128(inva, _mm_slli_epi32(inva, 8));
+            inva = _mm_or_si128(inva, _mm_slli_epi32(inva, 16));
+
+            /* d * inva / 255, exactly, as (x + 1 + (x >> 8)) >> 8 */
+            lo = _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(inva, zero));
+            hi = _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(inva, zero));
+            lo = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(lo, one), _mm_srli_epi16(lo, 8)), 8);
+            hi = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(hi, one), _mm_srli_epi16(hi, 8)), 8);
+
+            _mm_storeu_si128((__m128i *) dstp, _mm_and_si128(_mm_adds_epu8(s, _mm_packus_epi16(lo, hi)), mm_dmask));
+        }
+        while (n--) {
+            *dstp = BlendRGBtoRGBPremultiplied(*srcp, *dstp, ashift) & dmask;
+            ++srcp;
+            ++dstp;
+        }
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+
+/* SSE2 premultiplied ARGB8888->(A)RGB8888 additive blending, 4 pixels at a time */
+static void
+BlitRGBtoRGBAddPremultipliedSSE2(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint32 *dstp = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip >> 2;
+    const SDL_PixelFormat *df = info->dst_fmt;
+    const Uint32 rgbmask = df->Rmask | df->Gmask | df->Bmask;
+    const Uint32 dmask = df->Amask ? 0xffffffff : rgbmask;
+    const __m128i mm_rgbmask = _mm_set1_epi32((int) rgbmask);
+    const __m128i mm_dmask = _mm_set1_epi32((int) dmask);
+
+    while (height--) {
+        int n = width;
+        for (; n >= 4; n -= 4, srcp += 4, dstp += 4) {
+            const __m128i s = _mm_and_si128(_mm_loadu_si128((const __m128i *) srcp), mm_rgbmask);
+            const __m128i d = _mm_loadu_si128((const __m128i *) dstp);
+            _mm_storeu_si128((__m128i *) dstp, _mm_and_si128(_mm_adds_epu8(s, d), mm_dmask));
+        }
+        while (n--) {
+            *dstp = BlendRGBtoRGBAddPremultiplied(*srcp, *dstp, rgbmask) & dmask;
+            ++srcp;
+            ++dstp;
+        }
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+
+#endif /* HAVE_SSE2_INTRINSICS */
+
+#if HAVE_AVX2_INTRINSICS
+
+/* AVX2 (A)RGB8888->(A)RGB8888 blending with surface alpha, 8 pixels at a time */
+SDL_TARGETING("avx2") static void
+BlitRGBtoRGBSurfaceAlphaAVX2(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint32 *dstp = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip >> 2;
+    const SDL_PixelFormat *df = info->dst_fmt;
+    const Uint32 alpha = info->a;
+    const Uint32 fill = ~(df->Rmask | df->Gmask | df->Bmask);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i mm_alpha = _mm256_set1_epi16((short) alpha);
+    const __m256i mm_fill = _mm256_set1_epi32((int) fill);
+
+    while (height--) {
+        int n = width;
+        for (; n >= 8; n -= 8, srcp += 8, dstp += 8) {
+            const __m256i s = _mm256_loadu_si256((const __m256i *) srcp);
+            const __m256i d = _mm256_loadu_si256((const __m256i *) dstp);
+            const __m256i lo = BlendLanesAVX2(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero), mm_alpha);
+            const __m256i hi = BlendLanesAVX2(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero), mm_alpha);
+            _mm256_storeu_si256((__m256i *) dstp, _mm256_or_si256(_mm256_packus_epi16(lo, hi), mm_fill));
+        }
+        while (n--) {
+            *dstp = BlendRGBtoRGBSurfaceAlpha(*srcp, *dstp, alpha, fill);
+            ++srcp;
+            ++dstp;
+        }
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+
+/* AVX2 ARGB8888->(A)RGB8888 blending with pixel alpha, 8 pixels at a time */
+SDL_TARGETING("avx2") static void
+BlitRGBtoRGBPixelAlphaAVX2(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint32 *dstp = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip >> 2;
+    const Uint32 ashift = info->src_fmt->Ashift;
+    const __m128i mm_ashift = _mm_cvtsi32_si128((int) ashift);
+    const __m256i mm_amask = _mm256_sll_epi32(_mm256_set1_epi32(0xff), mm_ashift);
+    const __m256i mm_ff = _mm256_set1_epi32(0xff);
+    const __m256i zero = _mm256_setzero_si256();
+
+    while (height--) {
+        int n = width;
+        for (; n >= 8; n -= 8, srcp += 8, dstp += 8) {
+            const __m256i s = _mm256_loadu_si256((const __m256i *) srcp);
+            const __m256i d = _mm256_loadu_si256((const __m256i *) dstp);
+            const __m256i alpha = _mm256_and_si256(_mm256_srl_epi32(s, mm_ashift), mm_ff);
+            const __m256i clear = _mm256_cmpeq_epi32(alpha, zero);
+            const __m256i opaque = _mm256_cmpeq_epi32(alpha, mm_ff);
+            __m256i alpha8, dalpha, lo, hi, res;
+
+            if (_mm256_movemask_epi8(clear) == -1) {
+                continue;
+            } else if (_mm256_movemask_epi8(opaque) == -1) {
+                _mm256_storeu_si256((__m256i *) dstp, s);
+                continue;
+            }
+
+            alpha8 = _mm256_or_si256(alpha, _mm256_slli_epi32(alpha, 8));
+            alpha8 = _mm256_or_si256(alpha8, _mm256_slli_epi32(alpha8, 16));
+
+            lo = BlendLanesAVX2(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero), _mm256_unpacklo_epi8(alpha8, zero));
+            hi = BlendLanesAVX2(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero), _mm256_unpackhi_epi8(alpha8, zero));
+            res = _mm256_packus_epi16(lo, hi);
+
+            dalpha = _mm256_and_si256(_mm256_srl_epi32(d, mm_ashift), mm_ff);
+            dalpha = _mm256_mullo_epi16(dalpha, _mm256_xor_si256(alpha, mm_ff));
+            dalpha = _mm256_add_epi32(alpha, _mm256_srli_epi32(dalpha, 8));
+            res = _mm256_or_si256(_mm256_andnot_si256(mm_amask, res), _mm256_sll_epi32(dalpha, mm_ashift));
+
+            res = _mm256_blendv_epi8(res, s, opaque);
+            res = _mm256_blendv_epi8(res, d, clear);
+            _mm256_storeu_si256((__m256i *) dstp, res);
+        }
+        while (n--) {
+            *dstp = BlendRGBtoRGBPixelAlpha(*srcp, *dstp, ashift);
+            ++srcp;
+            ++dstp;
+        }
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+
+/* AVX2 RGB565/555->RGB565/555 blending with surface alpha, 16 pixels at a time */
+SDL_TARGETING("avx2") static void
+Blit16to16SurfaceAlphaAVX2(SDL_BlitInfo * info, int rshift, Uint16 gmask, Uint32 mask)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint16 *srcp = (Uint16 *) info->src;
+    int srcskip = info->src_skip >> 1;
+    Uint16 *dstp = (Uint16 *) info->dst;
+    int dstskip = info->dst_skip >> 1;
+    const unsigned alpha = info->a >> 3;    /* downscale alpha to 5 bits */
+    const __m256i mm_alpha = _mm256_set1_epi16((short) alpha);
+    const __m128i mm_rshift = _mm_cvtsi32_si128(rshift);
+    const __m256i mm_gmask = _mm256_set1_epi16((short) gmask);
+    const __m256i mm_5bits = _mm256_set1_epi16(0x1f);
+
+    while (height--) {
+        int n = width;
+        for (; n >= 16; n -= 16, srcp += 16, dstp += 16) {
+            const __m256i s = _mm256_loadu_si256((const __m256i *) srcp);
+            const __m256i d = _mm256_loadu_si256((const __m256i *) dstp);
+            __m256i dr = _mm256_and_si256(_mm256_srl_epi16(d, mm_rshift), mm_5bits);
+            __m256i dg = _mm256_and_si256(_mm256_srli_epi16(d, 5), mm_gmask);
+            __m256i db = _mm256_and_si256(d, mm_5bits);
+            const __m256i sr = _mm256_and_si256(_mm256_srl_epi16(s, mm_rshift), mm_5bits);
+            const __m256i sg = _mm256_and_si256(_mm256_srli_epi16(s, 5), mm_gmask);
+            const __m256i sb = _mm256_and_si256(s, mm_5bits);
+
+            dr = _mm256_add_epi16(dr, _mm256_srai_epi16(_mm256_mullo_epi16(_mm256_sub_epi16(sr, dr), mm_alpha), 5));
+            dg = _mm256_add_epi16(dg, _mm256_srai_epi16(_mm256_mullo_epi16(_mm256_sub_epi16(sg, dg), mm_alpha), 5));
+            db = _mm256_add_epi16(db, _mm256_srai_epi16(_mm256_mullo_epi16(_mm256_sub_epi16(sb, db), mm_alpha), 5));
+            _mm256_storeu_si256((__m256i *) dstp,
+                _mm256_or_si256(_mm256_or_si256(_mm256_sll_epi16(dr, mm_rshift), _mm256_slli_epi16(dg, 5)), db));
+        }
+        while (n--) {
+            *dstp = Blend16to16SurfaceAlpha(*srcp, *dstp, alpha, mask);
+            ++srcp;
+            ++dstp;
+        }
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+
+SDL_TARGETING("avx2") static void
+Blit565to565SurfaceAlphaAVX2(SDL_BlitInfo * info)
+{
+    Blit16to16SurfaceAlphaAVX2(info, 11, 0x3f, 0x07e0f81f);
+}
+
+SDL_TARGETING("avx2") static void
+Blit555to555SurfaceAlphaAVX2(SDL_BlitInfo * info)
+{
+    Blit16to16SurfaceAlphaAVX2(info, 10, 0x1f, 0x03e07c1f);
+}
+
+/* AVX2 ARGB8888->RGB565/555 blending with pixel alpha, 16 pixels at a time */
+SDL_TARGETING("avx2") static void
+BlitARGBto16PixelAlphaAVX2(SDL_BlitInfo * info, int gshift)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint16 *dstp = (Uint16 *) info->dst;
+    int dstskip = info->dst_skip >> 1;
+    const int rshift = (gshift == 10) ? 11 : 10;
+    const __m128i mm_rshift = _mm_cvtsi32_si128(rshift);
+    const __m128i mm_gshift = _mm_cvtsi32_si128(gshift);
+    const __m256i mm_gmask16 = _mm256_set1_epi16((gshift == 10) ? 0x3f : 0x1f);
+    const __m256i mm_gmask32 = _mm256_set1_epi32((gshift == 10) ? 0x3f : 0x1f);
+    const __m256i mm_5bits16 = _mm256_set1_epi16(0x1f);
+    const __m256i mm_5bits32 = _mm256_set1_epi32(0x1f);
+    const __m256i mm_opaque = _mm256_set1_epi16(SDL_ALPHA_OPAQUE >> 3);
+    const __m256i zero = _mm256_setzero_si256();
+
+/* packs works within 128-bit lanes, put the pixels back in order afterwards */
+#define PACK_AVX2(a, b) _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), _MM_SHUFFLE(3, 1, 2, 0))
+
+    while (height--) {
+        int n = width;
+        for (; n >= 16; n -= 16, srcp += 16, dstp += 16) {
+            const __m256i s0 = _mm256_loadu_si256((const __m256i *) srcp);
+            const __m256i s1 = _mm256_loadu_si256((const __m256i *) (srcp + 8));
+            const __m256i d = _mm256_loadu_si256((const __m256i *) dstp);
+            const __m256i alpha = PACK_AVX2(_mm256_srli_epi32(s0, 27), _mm256_srli_epi32(s1, 27));
+            const __m256i clear = _mm256_cmpeq_epi16(alpha, zero);
+            const __m256i opaque = _mm256_cmpeq_epi16(alpha, mm_opaque);
+            const __m256i sr = PACK_AVX2(_mm256_and_si256(_mm256_srli_epi32(s0, 19), mm_5bits32),
+                                         _mm256_and_si256(_mm256_srli_epi32(s1, 19), mm_5bits32));
+            const __m256i sg = PACK_AVX2(_mm256_and_si256(_mm256_srl_epi32(s0, mm_gshift), mm_gmask32),
+                                         _mm256_and_si256(_mm256_srl_epi32(s1, mm_gshift), mm_gmask32));
+            const __m256i sb = PACK_AVX2(_mm256_and_si256(_mm256_srli_epi32(s0, 3), mm_5bits32),
+                                         _mm256_and_si256(_mm256_srli_epi32(s1, 3), mm_5bits32));
+            __m256i dr, dg, db, res;
+
+            if (_mm256_movemask_epi8(clear) == -1) {
+                continue;
+            }
+
+            dr = _mm256_and_si256(_mm256_srl_epi16(d, mm_rshift), mm_5bits16);
+            dg = _mm256_and_si256(_mm256_srli_epi16(d, 5), mm_gmask16);
+            db = _mm256_and_si256(d, mm_5bits16);
+            dr = _mm256_add_epi16(dr, _mm256_srai_epi16(_mm256_mullo_epi16(_mm256_sub_epi16(sr, dr), alpha), 5));
+            dg = _mm256_add_epi16(dg, _mm256_srai_epi16(_mm256_mullo_epi16(_mm256_sub_epi16(sg, dg), alpha), 5));
+            db = _mm256_add_epi16(db, _mm256_srai_epi16(_mm256_mullo_epi16(_mm256_sub_epi16(sb, db), alpha), 5));
+
+            dr = _mm256_blendv_epi8(dr, sr, opaque);
+            dg = _mm256_blendv_epi8(dg, sg, opaque);
+            db = _mm256_blendv_epi8(db, sb, opaque);
+            res = _mm256_or_si256(_mm256_or_si256(_mm256_sll_epi16(dr, mm_rshift), _mm256_slli_epi16(dg, 5)), db);
+
+            res = _mm256_blendv_epi8(res, d, clear);
+            _mm256_storeu_si256((__m256i *) dstp, res);
+        }
+        while (n--) {
+            *dstp = BlendARGBto16PixelAlpha(*srcp, *dstp, gshift);
+            ++srcp;
+            ++dstp;
         }
+        srcp += srcskip;
+        dstp += dstskip;
     }
+
+#undef PACK_AVX2
 }
 
-/* fast RGB555->RGB555 blending with surface alpha */
+SDL_TARGETING("avx2") static void
+BlitARGBto565PixelAlphaAVX2(SDL_BlitInfo * info)
+{
+    BlitARGBto16PixelAlphaAVX2(info, 10);
+}
+
+SDL_TARGETING("avx2") static void
+BlitARGBto555PixelAlphaAVX2(SDL_BlitInfo * info)
+{
+    BlitARGBto16PixelAlphaAVX2(info, 11);
+}
+
+/* AVX2 premultiplied ARGB8888->(A)RGB8888 blending, 8 pixels at a time */
+SDL_TARGETING("avx2") static void
+BlitRGBtoRGBPremultipliedAVX2(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint32 *dstp = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip >> 2;
+    const Uint32 ashift = info->src_fmt->Ashift;
+    const SDL_PixelFormat *df = info->dst_fmt;
+    const Uint32 dmask = df->Amask ? 0xffffffff : (df->Rmask | df->Gmask | df->Bmask);
+    const __m128i mm_ashift = _mm_cvtsi32_si128((int) ashift);
+    const __m256i mm_dmask = _mm256_set1_epi32((int) dmask);
+    const __m256i mm_ff = _mm256_set1_epi32(0xff);
+    const __m256i one = _mm256_set1_epi16(1);
+    const __m256i zero = _mm256_setzero_si256();
+
+    while (height--) {
+        int n = width;
+        for (; n >= 8; n -= 8, srcp += 8, dstp += 8) {
+            const __m256i s = _mm256_loadu_si256((const __m256i *) srcp);
+            const __m256i d = _mm256_loadu_si256((const __m256i *) dstp);
+            __m256i inva, lo, hi;
+
+            inva = _mm256_xor_si256(_mm256_and_si256(_mm256_srl_epi32(s, mm_ashift), mm_ff), mm_ff);
+            if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(s, zero)) == -1) {
+                _mm256_storeu_si256((__m256i *) dstp, _mm256_and_si256(d, mm_dmask));
+                continue;
+            } else if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(inva, zero)) == -1) {
+                _mm256_storeu_si256((__m256i *) dstp, _mm256_and_si256(s, mm_dmask));
+                continue;
+            }
+
+            inva = _mm256_or_si256(inva, _mm256_slli_epi32(inva, 8));
+            inva = _mm256_or_si256(inva, _mm256_slli_epi32(inva, 16));
+
+            lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), _mm256_unpacklo_epi8(inva, zero));
+            hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), _mm256_unpackhi_epi8(inva, zero));
+            lo = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(lo, one), _mm256_srli_epi16(lo, 8)), 8);
+            hi = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(hi, one), _mm256_srli_epi16(hi, 8)), 8);
+
+            _mm256_storeu_si256((__m256i *) dstp, _mm256_and_si256(_mm256_adds_epu8(s, _mm256_packus_epi16(lo, hi)), mm_dmask));
+        }
+        while (n--) {
+            *dstp = BlendRGBtoRGBPremultiplied(*srcp, *dstp, ashift) & dmask;
+            ++srcp;
+            ++dstp;
+        }
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+
+/* AVX2 premultiplied ARGB8888->(A)RGB8888 additive blending, 8 pixels at a time */
+SDL_TARGETING("avx2") static void
+BlitRGBtoRGBAddPremultipliedAVX2(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint32 *dstp = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip >> 2;
+    const SDL_PixelFormat *df = info->dst_fmt;
+    const Uint32 rgbmask = df->Rmask | df->Gmask | df->Bmask;
+    const Uint32 dmask = df->Amask ? 0xffffffff : rgbmask;
+    const __m256i mm_rgbmask = _mm256_set1_epi32((int) rgbmask);
+    const __m256i mm_dmask = _mm256_set1_epi32((int) dmask);
+
+    while (height--) {
+        int n = width;
+        for (; n >= 8; n -= 8, srcp += 8, dstp += 8) {
+            const __m256i s = _mm256_and_si256(_mm256_loadu_si256((const __m256i *) srcp), mm_rgbmask);
+            const __m256i d = _mm256_loadu_si256((const __m256i *) dstp);
+            _mm256_storeu_si256((__m256i *) dstp, _mm256_and_si256(_mm256_adds_epu8(s, d), mm_dmask));
+        }
+        while (n--) {
+            *dstp = BlendRGBtoRGBAddPremultiplied(*srcp, *dstp, rgbmask) & dmask;
+            ++srcp;
+            ++dstp;
+        }
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+
+#endif /* HAVE_AVX2_INTRINSICS */
+
+#if HAVE_NEON_INTRINSICS
+
+/* NEON (A)RGB8888->(A)RGB8888 blending with surface alpha, 4 pixels at a time */
 static void
-Blit555to555SurfaceAlpha(SDL_BlitInfo * info)
+BlitRGBtoRGBSurfaceAlphaNEON(SDL_BlitInfo * info)
 {
-    unsigned alpha = info->a;   /* downscale alpha to 5 bits */
-    if (alpha == 128) {
-        Blit16to16SurfaceAlpha128(info, 0xfbde);
-    } else {
-        int width = info->dst_w;
-        int height = info->dst_h;
-        Uint16 *srcp = (Uint16 *) info->src;
-        int srcskip = info->src_skip >> 1;
-        Uint16 *dstp = (Uint16 *) info->dst;
-        int dstskip = info->dst_skip >> 1;
-        alpha >>= 3;            /* downscale alpha to 5 bits */
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint32 *dstp = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip >> 2;
+    const SDL_PixelFormat *df = info->dst_fmt;
+    const Uint32 alpha = info->a;
+    const Uint32 fill = ~(df->Rmask | df->Gmask | df->Bmask);
+    const uint16x8_t mm_alpha = vdupq_n_u16((uint16_t) alpha);
+    const uint32x4_t mm_fill = vdupq_n_u32(fill);
 
-        while (height--) {
-            /* *INDENT-OFF* */
-            DUFFS_LOOP4({
-                Uint32 s = *srcp++;
-                Uint32 d = *dstp;
-                /*
-                 * shift out the middle component (green) to
-                 * the high 16 bits, and process all three RGB
-                 * components at the same time.
-                 */
-                s = (s | s << 16) & 0x03e07c1f;
-                d = (d | d << 16) & 0x03e07c1f;
-                d += (s - d) * alpha >> 5;
-                d &= 0x03e07c1f;
-                *dstp++ = (Uint16)(d | d >> 16);
-            }, width);
-            /* *INDENT-ON* */
-            srcp += srcskip;
-            dstp += dstskip;
+    while (height--) {
+        int n = width;
+        for (; n >= 4; n -= 4, srcp += 4, dstp += 4) {
+            const uint8x16_t s = vreinterpretq_u8_u32(vld1q_u32(srcp));
+            const uint8x16_t d = vreinterpretq_u8_u32(vld1q_u32(dstp));
+            /* d + ((s - d) * alpha >> 8), keeping the low 8 bits of each lane */
+            const uint16x8_t lo = vsraq_n_u16(vmovl_u8(vget_low_u8(d)),
+                                              vmulq_u16(vsubl_u8(vget_low_u8(s), vget_low_u8(d)), mm_alpha), 8);
+            const uint16x8_t hi = vsraq_n_u16(vmovl_u8(vget_high_u8(d)),
+                                              vmulq_u16(vsubl_u8(vget_high_u8(s), vget_high_u8(d)), mm_alpha), 8);
+            const uint8x16_t res = vcombine_u8(vmovn_u16(lo), vmovn_u16(hi));
+            vst1q_u32(dstp, vorrq_u32(vreinterpretq_u32_u8(res), mm_fill));
+        }
+        while (n--) {
+            *dstp = BlendRGBtoRGBSurfaceAlpha(*srcp, *dstp, alpha, fill);
+            ++srcp;
+            ++dstp;
         }
+        srcp += srcskip;
+        dstp += dstskip;
     }
 }
 
-/* fast ARGB8888->RGB565 blending with pixel alpha */
+/* NEON ARGB8888->(A)RGB8888 blending with pixel alpha, 4 pixels at a time */
 static void
-BlitARGBto565PixelAlpha(SDL_BlitInfo * info)
+BlitRGBtoRGBPixelAlphaNEON(SDL_BlitInfo * info)
 {
     int width = info->dst_w;
     int height = info->dst_h;
     Uint32 *srcp = (Uint32 *) info->src;
     int srcskip = info->src_skip >> 2;
+    Uint32 *dstp = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip >> 2;
+    const Uint32 ashift = info->src_fmt->Ashift;
+    const int32x4_t mm_ashift = vdupq_n_s32((int32_t) ashift);
+    const int32x4_t mm_ashift_right = vnegq_s32(mm_ashift);
+    const uint32x4_t mm_ff = vdupq_n_u32(0xff);
+    const uint32x4_t mm_amask = vshlq_u32(mm_ff, mm_ashift);
+    const uint32x4_t zero = vdupq_n_u32(0);
+
+    while (height--) {
+        int n = width;
+        for (; n >= 4; n -= 4, srcp += 4, dstp += 4) {
+            const uint32x4_t s = vld1q_u32(srcp);
+            const uint32x4_t d = vld1q_u32(dstp);
+            const uint32x4_t alpha = vandq_u32(vshlq_u32(s, mm_ashift_right), mm_ff);
+            const uint32x4_t clear = vceqq_u32(alpha, zero);
+            const uint32x4_t opaque = vceqq_u32(alpha, mm_ff);
+            const uint8x16_t s8 = vreinterpretq_u8_u32(s);
+            const uint8x16_t d8 = vreinterpretq_u8_u32(d);
+            /* spread each pixel's alpha over all four of its bytes */
+            const uint8x16_t alpha8 = vreinterpretq_u8_u32(vmulq_n_u32(alpha, 0x01010101));
+            uint16x8_t lo, hi;
+            uint32x4_t dalpha, res;
+
+            lo = vmulq_u16(vsubl_u8(vget_low_u8(s8), vget_low_u8(d8)), vmovl_u8(vget_low_u8(alpha8)));
+            hi = vmulq_u16(vsubl_u8(vget_high_u8(s8), vget_high_u8(d8)), vmovl_u8(vget_high_u8(alpha8)));
+            lo = vsraq_n_u16(vmovl_u8(vget_low_u8(d8)), lo, 8);
+            hi = vsraq_n_u16(vmovl_u8(vget_high_u8(d8)), hi, 8);
+            res = vreinterpretq_u32_u8(vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+
+            dalpha = vandq_u32(vshlq_u32(d, mm_ashift_right), mm_ff);
+            dalpha = vsraq_n_u32(alpha, vmulq_u32(dalpha, veorq_u32(alpha, mm_ff)), 8);
+            res = vbslq_u32(mm_amask, vshlq_u32(dalpha, mm_ashift), res);
+
+            res = vbslq_u32(opaque, s, res);
+            res = vbslq_u32(clear, d, res);
+            vst1q_u32(dstp, res);
+        }
+        while (n--) {
+            *dstp = BlendRGBtoRGBPixelAlpha(*srcp, *dstp, ashift);
+            ++srcp;
+            ++dstp;
+        }
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+
+/* NEON RGB565/555->RGB565/555 blending with surface alpha, 8 pixels at a time */
+static void
+Blit16to16SurfaceAlphaNEON(SDL_BlitInfo * info, int rshift, Uint16 gmask, Uint32 mask)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint16 *srcp = (Uint16 *) info->src;
+    int srcskip = info->src_skip >> 1;
     Uint16 *dstp = (Uint16 *) info->dst;
     int dstskip = info->dst_skip >> 1;
+    const unsigned alpha = info->a >> 3;    /* downscale alpha to 5 bits */
+    const int16x8_t mm_alpha = vdupq_n_s16((int16_t) alpha);
+    const int16x8_t mm_rshift = vdupq_n_s16((int16_t) rshift);
+    const int16x8_t mm_rshift_right = vdupq_n_s16((int16_t) -rshift);
+    const uint16x8_t mm_gmask = vdupq_n_u16(gmask);
+    const uint16x8_t mm_5bits = vdupq_n_u16(0x1f);
 
     while (height--) {
-        /* *INDENT-OFF* */
-        DUFFS_LOOP4({
-        Uint32 s = *srcp;
-        unsigned alpha = s >> 27; /* downscale alpha to 5 bits */
-        /* FIXME: Here we special-case opaque alpha since the
-           compositioning used (>>8 instead of /255) doesn't handle
-           it correctly. Also special-case alpha=0 for speed?
-           Benchmark this! */
-        if(alpha) {   
-          if(alpha == (SDL_ALPHA_OPAQUE >> 3)) {
-            *dstp = (Uint16)((s >> 8 & 0xf800) + (s >> 5 & 0x7e0) + (s >> 3  & 0x1f));
-          } else {
-            Uint32 d = *dstp;
-            /*
-             * convert source and destination to G0RAB65565
-             * and blend all components at the same time
-             */
-            s = ((s & 0xfc00) << 11) + (s >> 8 & 0xf800)
-              + (s >> 3 & 0x1f);
-            d = (d | d << 16) & 0x07e0f81f;
-            d += (s - d) * alpha >> 5;
-            d &= 0x07e0f81f;
-            *dstp = (Uint16)(d | d >> 16);
-          }
+        int n = width;
+        for (; n >= 8; n -= 8, srcp += 8, dstp += 8) {
+            const uint16x8_t s = vld1q_u16(srcp);
+            const uint16x8_t d = vld1q_u16(dstp);
+            int16x8_t dr = vreinterpretq_s16_u16(vandq_u16(vshlq_u16(d, mm_rshift_right), mm_5bits));
+            int16x8_t dg = vreinterpretq_s16_u16(vandq_u16(vshrq_n_u16(d, 5), mm_gmask));
+            int16x8_t db = vreinterpretq_s16_u16(vandq_u16(d, mm_5bits));
+            const int16x8_t sr = vreinterpretq_s16_u16(vandq_u16(vshlq_u16(s, mm_rshift_right), mm_5bits));
+            const int16x8_t sg = vreinterpretq_s16_u16(vandq_u16(vshrq_n_u16(s, 5), mm_gmask));
+            const int16x8_t sb = vreinterpretq_s16_u16(vandq_u16(s, mm_5bits));
+
+            dr = vsraq_n_s16(dr, vmulq_s16(vsubq_s16(sr, dr), mm_alpha), 5);
+            dg = vsraq_n_s16(dg, vmulq_s16(vsubq_s16(sg, dg), mm_alpha), 5);
+            db = vsraq_n_s16(db, vmulq_s16(vsubq_s16(sb, db), mm_alpha), 5);
+            vst1q_u16(dstp, vorrq_u16(vorrq_u16(vshlq_u16(vreinterpretq_u16_s16(dr), mm_rshift),
+                                                vshlq_n_u16(vreinterpretq_u16_s16(dg), 5)),
+                                      vreinterpretq_u16_s16(db)));
+        }
+        while (n--) {
+            *dstp = Blend16to16SurfaceAlpha(*srcp, *dstp, alpha, mask);
+            ++srcp;
+            ++dstp;
         }
-        srcp++;
-        dstp++;
-        }, width);
-        /* *INDENT-ON* */
         srcp += srcskip;
         dstp += dstskip;
     }
 }
 
-/* fast ARGB8888->RGB555 blending with pixel alpha */
 static void
-BlitARGBto555PixelAlpha(SDL_BlitInfo * info)
+Blit565to565SurfaceAlphaNEON(SDL_BlitInfo * info)
+{
+    Blit16to16SurfaceAlphaNEON(info, 11, 0x3f, 0x07e0f81f);
+}
+
+static void
+Blit555to555SurfaceAlphaNEON(SDL_BlitInfo * info)
+{
+    Blit16to16SurfaceAlphaNEON(info, 10, 0x1f, 0x03e07c1f);
+}
+
+/* NEON ARGB8888->RGB565/555 blending with pixel alpha, 8 pixels at a time */
+static void
+BlitARGBto16PixelAlphaNEON(SDL_BlitInfo * info, int gshift)
 {
     int width = info->dst_w;
     int height = info->dst_h;
@@ -1105,43 +1537,162 @@ BlitARGBto555PixelAlpha(SDL_BlitInfo * info)
     int srcskip = info->src_skip >> 2;
     Uint16 *dstp = (Uint16 *) info->dst;
     int dstskip = info->dst_skip >> 1;
+    const int rshift = (gshift == 10) ? 11 : 10;
+    const int16x8_t mm_rshift = vdupq_n_s16((int16_t) rshift);
+    const int16x8_t mm_rshift_right = vdupq_n_s16((int16_t) -rshift);
+    const int32x4_t mm_gshift_right = vdupq_n_s32(-gshift);
+    const uint16x8_t mm_gmask16 = vdupq_n_u16((gshift == 10) ? 0x3f : 0x1f);
+    const uint32x4_t mm_gmask32 = vdupq_n_u32((gshift == 10) ? 0x3f : 0x1f);
+    const uint16x8_t mm_5bits16 = vdupq_n_u16(0x1f);
+    const uint32x4_t mm_5bits32 = vdupq_n_u32(0x1f);
+    const uint16x8_t mm_opaque = vdupq_n_u16(SDL_ALPHA_OPAQUE >> 3);
+    const uint16x8_t zero = vdupq_n_u16(0);
 
     while (height--) {
-        /* *INDENT-OFF* */
-        DUFFS_LOOP4({
-        unsigned alpha;
-        Uint32 s = *srcp;
-        alpha = s >> 27; /* downscale alpha to 5 bits */
-        /* FIXME: Here we special-case opaque alpha since the
-           compositioning used (>>8 instead of /255) doesn't handle
-           it correctly. Also special-case alpha=0 for speed?
-           Benchmark this! */
-        if(alpha) {   
-          if(alpha == (SDL_ALPHA_OPAQUE >> 3)) {
-            *dstp = (Uint16)((s >> 9 & 0x7c00) + (s >> 6 & 0x3e0) + (s >> 3  & 0x1f));
-          } else {
-            Uint32 d = *dstp;
-            /*
-             * convert source and destination to G0RAB65565
-             * and blend all components at the same time
-             */
-            s = ((s & 0xf800) << 10) + (s >> 9 & 0x7c00)
-              + (s >> 3 & 0x1f);
-            d = (d | d << 16) & 0x03e07c1f;
-            d += (s - d) * alpha >> 5;
-            d &= 0x03e07c1f;
-            *dstp = (Uint16)(d | d >> 16);
-          }
+        int n = width;
+        for (; n >= 8; n -= 8, srcp += 8, dstp += 8) {
+            const uint32x4_t s0 = vld1q_u32(srcp);
+            const uint32x4_t s1 = vld1q_u32(srcp + 4);
+            const uint16x8_t d = vld1q_u16(dstp);
+            const uint16x8_t alpha = vcombine_u16(vmovn_u32(vshrq_n_u32(s0, 27)), vmovn_u32(vshrq_n_u32(s1, 27)));
+            const uint16x8_t clear = vceqq_u16(alpha, zero);
+            const uint16x8_t opaque = vceqq_u16(alpha, mm_opaque);
+            const int16x8_t sr = vreinterpretq_s16_u16(vcombine_u16(
+                vmovn_u32(vandq_u32(vshrq_n_u32(s0, 19), mm_5bits32)),
+                vmovn_u32(vandq_u32(vshrq_n_u32(s1, 19), mm_5bits32))));
+            const int16x8_t sg = vreinterpretq_s16_u16(vcombine_u16(
+                vmovn_u32(vandq_u32(vshlq_u32(s0, mm_gshift_right), mm_gmask32)),
+                vmovn_u32(vandq_u32(vshlq_u32(s1, mm_gshift_right), mm_gmask32))));
+            const int16x8_t sb = vreinterpretq_s16_u16(vcombine_u16(
+                vmovn_u32(vandq_u32(vshrq_n_u32(s0, 3), mm_5bits32)),
+                vmovn_u32(vandq_u32(vshrq_n_u32(s1, 3), mm_5bits32))));
+            const int16x8_t a = vreinterpretq_s16_u16(alpha);
+            int16x8_t dr, dg, db;
+            uint16x8_t res;
+
+            dr = vreinterpretq_s16_u16(vandq_u16(vshlq_u16(d, mm_rshift_right), mm_5bits16));
+            dg = vreinterpretq_s16_u16(vandq_u16(vshrq_n_u16(d, 5), mm_gmask16));
+            db = vreinterpretq_s16_u16(vandq_u16(d, mm_5bits16));
+            dr = vsraq_n_s16(dr, vmulq_s16(vsubq_s16(sr, dr), a), 5);
+            dg = vsraq_n_s16(dg, vmulq_s16(vsubq_s16(sg, dg), a), 5);
+            db = vsraq_n_s16(db, vmulq_s16(vsubq_s16(sb, db), a), 5);
+
+            /* opaque pixels take the source color as is */
+            dr = vbslq_s16(opaque, sr, dr);
+            dg = vbslq_s16(opaque, sg, dg);
+            db = vbslq_s16(opaque, sb, db);
+            res = vorrq_u16(vorrq_u16(vshlq_u16(vreinterpretq_u16_s16(dr), mm_rshift),
+                                      vshlq_n_u16(vreinterpretq_u16_s16(dg), 5)),
+                            vreinterpretq_u16_s16(db));
+
+            vst1q_u16(dstp, vbslq_u16(clear, d, res));
+        }
+        while (n--) {
+            *dstp = BlendARGBto16PixelAlpha(*srcp, *dstp, gshift);
+            ++srcp;
+            ++dstp;
+        }
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+
+static void
+BlitARGBto565PixelAlphaNEON(SDL_BlitInfo * info)
+{
+    BlitARGBto16PixelAlphaNEON(info, 10);
+}
+
+static void
+BlitARGBto555PixelAlphaNEON(SDL_BlitInfo * info)
+{
+    BlitARGBto16PixelAlphaNEON(info, 11);
+}
+
+/* NEON premultiplied ARGB8888->(A)RGB8888 blending, 4 pixels at a time */
+static void
+BlitRGBtoRGBPremultipliedNEON(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint32 *dstp = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip >> 2;
+    const Uint32 ashift = info->src_fmt->Ashift;
+    const SDL_PixelFormat *df = info->dst_fmt;
+    const Uint32 dmask = df->Amask ? 0xffffffff : (df->Rmask | df->Gmask | df->Bmask);
+    const int32x4_t mm_ashift_right = vdupq_n_s32(-(int32_t) ashift);
+    const uint32x4_t mm_dmask = vdupq_n_u32(dmask);
+    const uint32x4_t mm_ff = vdupq_n_u32(0xff);
+    const uint16x8_t one = vdupq_n_u16(1);
+
+    while (height--) {
+        int n = width;
+        for (; n >= 4; n -= 4, srcp += 4, dstp += 4) {
+            const uint32x4_t s = vld1q_u32(srcp);
+            const uint8x16_t d8 = vreinterpretq_u8_u32(vld1q_u32(dstp));
+            /* spread each pixel's 255 - alpha over all four of its bytes */
+            const uint32x4_t inva = veorq_u32(vandq_u32(vshlq_u32(s, mm_ashift_right), mm_ff), mm_ff);
+            const uint8x16_t inva8 = vreinterpretq_u8_u32(vmulq_n_u32(inva, 0x01010101));
+            uint16x8_t lo, hi;
+            uint8x16_t res;
+
+            /* d * inva / 255, exactly, as (x + 1 + (x >> 8)) >> 8 */
+            lo = vmull_u8(vget_low_u8(d8), vget_low_u8(inva8));
+            hi = vmull_u8(vget_high_u8(d8), vget_high_u8(inva8));
+            lo = vsraq_n_u16(vaddq_u16(lo, one), lo, 8);
+            hi = vsraq_n_u16(vaddq_u16(hi, one), hi, 8);
+            res = vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8));
+
+            res = vqaddq_u8(vreinterpretq_u8_u32(s), res);
+            vst1q_u32(dstp, vandq_u32(vreinterpretq_u32_u8(res), mm_dmask));
+        }
+        while (n--) {
+            *dstp = BlendRGBtoRGBPremultiplied(*srcp, *dstp, ashift) & dmask;
+            ++srcp;
+            ++dstp;
+        }
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+
+/* NEON premultiplied ARGB8888->(A)RGB8888 additive blending, 4 pixels at a time */
+static void
+BlitRGBtoRGBAddPremultipliedNEON(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint32 *dstp = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip >> 2;
+    const SDL_PixelFormat *df = info->dst_fmt;
+    const Uint32 rgbmask = df->Rmask | df->Gmask | df->Bmask;
+    const Uint32 dmask = df->Amask ? 0xffffffff : rgbmask;
+    const uint32x4_t mm_rgbmask = vdupq_n_u32(rgbmask);
+    const uint32x4_t mm_dmask = vdupq_n_u32(dmask);
+
+    while (height--) {
+        int n = width;
+        for (; n >= 4; n -= 4, srcp += 4, dstp += 4) {
+            const uint8x16_t s8 = vreinterpretq_u8_u32(vandq_u32(vld1q_u32(srcp), mm_rgbmask));
+            const uint8x16_t d8 = vreinterpretq_u8_u32(vld1q_u32(dstp));
+            vst1q_u32(dstp, vandq_u32(vreinterpretq_u32_u8(vqaddq_u8(s8, d8)), mm_dmask));
+        }
+        while (n--) {
+            *dstp = BlendRGBtoRGBAddPremultiplied(*srcp, *dstp, rgbmask) & dmask;
+            ++srcp;
+            ++dstp;
         }
-        srcp++;
-        dstp++;
-        }, width);
-        /* *INDENT-ON* */
         srcp += srcskip;
         dstp += dstskip;
     }
 }
 
+#endif /* HAVE_NEON_INTRINSICS */
+
 /* General (slow) N->N blending with per-surface alpha */
 static void
 BlitNtoNSurfaceAlpha(SDL_BlitInfo * info)
@@ -1270,6 +1821,7 @@ SDL_CalculateBlitA(SDL_Surface * surface)
 {
     SDL_PixelFormat *sf = surface->format;
     SDL_PixelFormat *df = surface->map->dst->format;
+    const Uint32 features = SDL_GetBlitCPUFeatures();
 
     switch (surface->map->info.flags & ~SDL_COPY_RLE_MASK) {
     case SDL_COPY_BLEND:
@@ -1288,10 +1840,35 @@ SDL_CalculateBlitA(SDL_Surface * surface)
                     && sf->Gmask == 0xff00
                     && ((sf->Rmask == 0xff && df->Rmask == 0x1f)
                         || (sf->Bmask == 0xff && df->Bmask == 0x1f))) {
-                if (df->Gmask == 0x7e0)
+                if (df->Gmask == 0x7e0) {
+#if HAVE_AVX2_INTRINSICS
+                    if ((features & SDL_CPU_AVX2))
+                        return BlitARGBto565PixelAlphaAVX2;
+#endif
+#if HAVE_SSE2_INTRINSICS
+                    if ((features & SDL_CPU_SSE2))
+                        return BlitARGBto565PixelAlphaSSE2;
+#endif
+#if HAVE_NEON_INTRINSICS
+                    if ((features & SDL_CPU_NEON))
+                        return BlitARGBto565PixelAlphaNEON;
+#endif
                     return BlitARGBto565PixelAlpha;
-                else if (df->Gmask == 0x3e0)
+                } else if (df->Gmask == 0x3e0) {
+#if HAVE_AVX2_INTRINSICS
+                    if ((features & SDL_CPU_AVX2))
+                        return BlitARGBto555PixelAlphaAVX2;
+#endif
+#if HAVE_SSE2_INTRINSICS
+                    if ((features & SDL_CPU_SSE2))
+                        return BlitARGBto555PixelAlphaSSE2;
+#endif
+#if HAVE_NEON_INTRINSICS
+                    if ((features & SDL_CPU_NEON))
+                        return BlitARGBto555PixelAlphaNEON;
+#endif
                     return BlitARGBto555PixelAlpha;
+                }
             }
             return BlitNtoNPixelAlpha;
 
@@ -1299,21 +1876,23 @@ SDL_CalculateBlitA(SDL_Surface * surface)
             if (sf->Rmask == df->Rmask
                 && sf->Gmask == df->Gmask
                 && sf->Bmask == df->Bmask && sf->BytesPerPixel == 4) {
-#if defined(__MMX__) || defined(__3dNOW__)
                 if (sf->Rshift % 8 == 0
                     && sf->Gshift % 8 == 0
                     && sf->Bshift % 8 == 0
-                    && sf->Ashift % 8 == 0 && sf->Aloss == 0) {
-#ifdef __3dNOW__
-                    if (SDL_Has3DNow())
-                        return BlitRGBtoRGBPixelAlphaMMX3DNOW;
+                    && sf->Ashift % 8 == 0 && sf->Amask && sf->Aloss == 0) {
+#if HAVE_AVX2_INTRINSICS
+                    if ((features & SDL_CPU_AVX2))
+                        return BlitRGBtoRGBPixelAlphaAVX2;
+#endif
+#if HAVE_SSE2_INTRINSICS
+                    if ((features & SDL_CPU_SSE2))
+                        return BlitRGBtoRGBPixelAlphaSSE2;
 #endif
-#ifdef __MMX__
-                    if (SDL_HasMMX())
-                        return BlitRGBtoRGBPixelAlphaMMX;
+#if HAVE_NEON_INTRINSICS
+                    if ((features & SDL_CPU_NEON))
+                        return BlitRGBtoRGBPixelAlphaNEON;
 #endif
                 }
-#endif /* __MMX__ || __3dNOW__ */
                 if (sf->Amask == 0xff000000) {
                     return BlitRGBtoRGBPixelAlpha;
                 }
@@ -1341,19 +1920,33 @@ SDL_CalculateBlitA(SDL_Surface * surface)
             case 2:
                 if (surface->map->identity) {
                     if (df->Gmask == 0x7e0) {
-#ifdef __MMX__
-                        if (SDL_HasMMX())
-                            return Blit565to565SurfaceAlphaMMX;
-                        else
+#if HAVE_AVX2_INTRINSICS
+                        if ((features & SDL_CPU_AVX2))
+                            return Blit565to565SurfaceAlphaAVX2;
+#endif
+#if HAVE_SSE2_INTRINSICS
+                        if ((features & SDL_CPU_SSE2))
+                            return Blit565to565SurfaceAlphaSSE2;
+#endif
+#if HAVE_NEON_INTRINSICS
+                        if ((features & SDL_CPU_NEON))
+                            return Blit565to565SurfaceAlphaNEON;
 #endif
-                            return Blit565to565SurfaceAlpha;
+                        return Blit565to565SurfaceAlpha;
                     } else if (df->Gmask == 0x3e0) {
-#ifdef __MMX__
-                        if (SDL_HasMMX())
-                            return Blit555to555SurfaceAlphaMMX;
-                        else
+#if HAVE_AVX2_INTRINSICS
+                        if ((features & SDL_CPU_AVX2))
+                            return Blit555to555SurfaceAlphaAVX2;
 #endif
-                            return Blit555to555SurfaceAlpha;
+#if HAVE_SSE2_INTRINSICS
+                        if ((features & SDL_CPU_SSE2))
+                            return Blit555to555SurfaceAlphaSSE2;
+#endif
+#if HAVE_NEON_INTRINSICS
+                        if ((features & SDL_CPU_NEON))
+                            return Blit555to555SurfaceAlphaNEON;
+#endif
+                        return Blit555to555SurfaceAlpha;
                     }
                 }
                 return BlitNtoNSurfaceAlpha;
@@ -1362,12 +1955,22 @@ SDL_CalculateBlitA(SDL_Surface * surface)
                 if (sf->Rmask == df->Rmask
                     && sf->Gmask == df->Gmask
                     && sf->Bmask == df->Bmask && sf->BytesPerPixel == 4) {
-#ifdef __MMX__
-                    if (sf->Rshift % 8 == 0
-                        && sf->Gshift % 8 == 0
-                        && sf->Bshift % 8 == 0 && SDL_HasMMX())
-                        return BlitRGBtoRGBSurfaceAlphaMMX;
+                    if (sf->Rshift % 8 == 0 && sf->Rloss == 0
+                        && sf->Gshift % 8 == 0 && sf->Gloss == 0
+                        && sf->Bshift % 8 == 0 && sf->Bloss == 0) {
+#if HAVE_AVX2_INTRINSICS
+                        if ((features & SDL_CPU_AVX2))
+                            return BlitRGBtoRGBSurfaceAlphaAVX2;
+#endif
+#if HAVE_SSE2_INTRINSICS
+                        if ((features & SDL_CPU_SSE2))
+                            return BlitRGBtoRGBSurfaceAlphaSSE2;
+#endif
+#if HAVE_NEON_INTRINSICS
+                        if ((features & SDL_CPU_NEON))
+                            return BlitRGBtoRGBSurfaceAlphaNEON;
 #endif
+                    }
                     if ((sf->Rmask | sf->Gmask | sf->Bmask) == 0xffffff) {
                         return BlitRGBtoRGBSurfaceAlpha;
                     }
@@ -1381,6 +1984,50 @@ SDL_CalculateBlitA(SDL_Surface * surface)
         }
         break;
 
+    case SDL_COPY_BLEND_PREMULTIPLIED:
+    case SDL_COPY_ADD_PREMULTIPLIED:
+        /* Premultiplied 8888 blits, any channel order as long as the
+           color channels (and alpha, if the destination has it) line up */
+        if (sf->BytesPerPixel == 4 && df->BytesPerPixel == 4
+            && sf->Rmask == df->Rmask
+            && sf->Gmask == df->Gmask
+            && sf->Bmask == df->Bmask
+            && (df->Amask == 0 || df->Amask == sf->Amask)
+            && (sf->Rmask | sf->Gmask | sf->Bmask | sf->Amask) == 0xffffffff
+            && sf->Rshift % 8 == 0 && sf->Gshift % 8 == 0
+            && sf->Bshift % 8 == 0 && sf->Ashift % 8 == 0) {
+            if (surface->map->info.flags & SDL_COPY_BLEND_PREMULTIPLIED) {
+#if HAVE_AVX2_INTRINSICS
+                if ((features & SDL_CPU_AVX2))
+                    return BlitRGBtoRGBPremultipliedAVX2;
+#endif
+#if HAVE_SSE2_INTRINSICS
+                if ((features & SDL_CPU_SSE2))
+                    return BlitRGBtoRGBPremultipliedSSE2;
+#endif
+#if HAVE_NEON_INTRINSICS
+                if ((features & SDL_CPU_NEON))
+                    return BlitRGBtoRGBPremultipliedNEON;
+#endif
+                return BlitRGBtoRGBPremultiplied;
+            } else {
+#if HAVE_AVX2_INTRINSICS
+                if ((features & SDL_CPU_AVX2))
+                    return BlitRGBtoRGBAddPremultipliedAVX2;
+#endif
+#if HAVE_SSE2_INTRINSICS
+                if ((features & SDL_CPU_SSE2))
+                    return BlitRGBtoRGBAddPremultipliedSSE2;
+#endif
+#if HAVE_NEON_INTRINSICS
+                if ((features & SDL_CPU_NEON))
+                    return BlitRGBtoRGBAddPremultipliedNEON;
+#endif
+                return BlitRGBtoRGBAddPremultiplied;
+            }
+        }
+        break;
+
     case SDL_COPY_COLORKEY | SDL_COPY_MODULATE_ALPHA | SDL_COPY_BLEND:
         if (sf->Amask == 0) {
             if (df->BytesPerPixel == 1) {
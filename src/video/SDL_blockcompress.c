@@ -0,0 +1,1567 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+/* CPU decoders for the block compressed pixel formats, used by renderers
+   that can't sample them natively. Every decoder writes ARGB8888 pixels.
+ */
+
+#include "SDL_video.h"
+#include "SDL_endian.h"
+#include "SDL_blockcompress_c.h"
+
+#define MAX_BLOCK_SIZE  8
+
+#define ARGB(a, r, g, b) \
+    (((Uint32)(a) << 24) | ((Uint32)(r) << 16) | ((Uint32)(g) << 8) | (Uint32)(b))
+
+/* Decode one block of pixels, writing block_w x block_h pixels to dst */
+typedef void (*SDL_DecodeBlockFunc)(const Uint8 *block, Uint8 *dst, int dst_pitch);
+
+static SDL_INLINE Uint8
+Clamp255(int value)
+{
+    return (Uint8) ((value < 0) ? 0 : (value > 255) ? 255 : value);
+}
+
+
+/* BC1, BC2 and BC3 color blocks */
+
+static void
+ExpandColors(const Uint32 palette[4], Uint32 indices, const Uint8 *alpha, Uint8 *dst, int dst_pitch)
+{
+    int x, y;
+
+    for (y = 0; y < 4; ++y) {
+        Uint32 *row = (Uint32 *) (dst + y * dst_pitch);
+        for (x = 0; x < 4; ++x) {
+            row[x] = palette[indices & 3];
+            indices >>= 2;
+        }
+        if (alpha) {
+            for (x = 0; x < 4; ++x) {
+                row[x] = (row[x] & 0x00FFFFFF) | ((Uint32) alpha[x] << 24);
+            }
+            alpha += 4;
+        }
+    }
+}
+
+static void
+DecodeColorBlock(const Uint8 *block, SDL_bool allow_transparent, const Uint8 *alpha, Uint8 *dst, int dst_pitch)
+{
+    const int c0 = block[0] | (block[1] << 8);
+    const int c1 = block[2] | (block[3] << 8);
+    const Uint32 indices = block[4] | (block[5] << 8) | (block[6] << 16) | ((Uint32) block[7] << 24);
+    const int r0 = ((c0 >> 8) & 0xF8) | (c0 >> 13);
+    const int g0 = ((c0 >> 3) & 0xFC) | ((c0 >> 9) & 0x03);
+    const int b0 = ((c0 << 3) & 0xF8) | ((c0 >> 2) & 0x07);
+    const int r1 = ((c1 >> 8) & 0xF8) | (c1 >> 13);
+    const int g1 = ((c1 >> 3) & 0xFC) | ((c1 >> 9) & 0x03);
+    const int b1 = ((c1 << 3) & 0xF8) | ((c1 >> 2) & 0x07);
+    Uint32 palette[4];
+
+    palette[0] = ARGB(255, r0, g0, b0);
+    palette[1] = ARGB(255, r1, g1, b1);
+    if (c0 > c1 || !allow_transparent) {
+        palette[2] = ARGB(255, (2 * r0 + r1) / 3, (2 * g0 + g1) / 3, (2 * b0 + b1) / 3);
+        palette[3] = ARGB(255, (r0 + 2 * r1) / 3, (g0 + 2 * g1) / 3, (b0 + 2 * b1) / 3);
+    } else {
+        palette[2] = ARGB(255, (r0 + r1) / 2, (g0 + g1) / 2, (b0 + b1) / 2);
+        palette[3] = 0;
+    }
+    ExpandColors(palette, indices, alpha, dst, dst_pitch);
+}
+
+/* BC4 blocks, also used for the BC3 alpha and the BC5 channels */
+static void
+DecodeChannelBlock(const Uint8 *block, Uint8 values[16])
+{
+    const int v0 = block[0];
+    const int v1 = block[1];
+    Uint32 bits;
+    Uint8 palette[8];
+    int i;
+
+    palette[0] = (Uint8) v0;
+    palette[1] = (Uint8) v1;
+    if (v0 > v1) {
+        for (i = 1; i < 7; ++i) {
+            palette[i + 1] = (Uint8) (((7 - i) * v0 + i * v1) / 7);
+        }
+    } else {
+        for (i = 1; i < 5; ++i) {
+            palette[i + 1] = (Uint8) (((5 - i) * v0 + i * v1) / 5);
+        }
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+
+    /* 16 3-bit indices, in two runs of 24 bits */
+    bits = block[2] | (block[3] << 8) | (block[4] << 16);
+    for (i = 0; i < 8; ++i, bits >>= 3) {
+        values[i] = palette[bits & 7];
+    }
+    bits = block[5] | (block[6] << 8) | (block[7] << 16);
+    for (i = 8; i < 16; ++i, bits >>= 3) {
+        values[i] = palette[bits & 7];
+    }
+}
+
+static void
+DecodeBlockBC1(const Uint8 *block, Uint8 *dst, int dst_pitch)
+{
+    DecodeColorBlock(block, SDL_TRUE, NULL, dst, dst_pitch);
+}
+
+static void
+DecodeBlockBC2(const Uint8 *block, Uint8 *dst, int dst_pitch)
+{
+    Uint8 alpha[16];
+    int i;
+
+    for (i = 0; i < 8; ++i) {
+        alpha[i * 2 + 0] = (Uint8) ((block[i] & 0x0F) * 17);
+        alpha[i * 2 + 1] = (Uint8) ((block[i] >> 4) * 17);
+    }
+    DecodeColorBlock(block + 8, SDL_FALSE, alpha, dst, dst_pitch);
+}
+
+static void
+DecodeBlockBC3(const Uint8 *block, Uint8 *dst, int dst_pitch)
+{
+    Uint8 alpha[16];
+
+    DecodeChannelBlock(block, alpha);
+    DecodeColorBlock(block + 8, SDL_FALSE, alpha, dst, dst_pitch);
+}
+
+static void
+DecodeBlockBC4(const Uint8 *block, Uint8 *dst, int dst_pitch)
+{
+    Uint8 red[16];
+    int x, y;
+
+    DecodeChannelBlock(block, red);
+    for (y = 0; y < 4; ++y) {
+        Uint32 *row = (Uint32 *) (dst + y * dst_pitch);
+        for (x = 0; x < 4; ++x) {
+            row[x] = ARGB(255, red[y * 4 + x], 0, 0);
+        }
+    }
+}
+
+static void
+DecodeBlockBC5(const Uint8 *block, Uint8 *dst, int dst_pitch)
+{
+    Uint8 red[16], green[16];
+    int x, y;
+
+    DecodeChannelBlock(block, red);
+    DecodeChannelBlock(block + 8, green);
+    for (y = 0; y < 4; ++y) {
+        Uint32 *row = (Uint32 *) (dst + y * dst_pitch);
+        for (x = 0; x < 4; ++x) {
+            row[x] = ARGB(255, red[y * 4 + x], green[y * 4 + x], 0);
+        }
+    }
+}
+
+
+/* BC7 blocks */
+
+/* Reads bits from a 128 bit block, least significant bit first */
+typedef struct
+{
+    Uint64 lo;
+    Uint64 hi;
+    int pos;
+} BitReader;
+
+static SDL_INLINE void
+InitBitReader(BitReader *reader, const Uint8 *block, int pos)
+{
+    SDL_memcpy(&reader->lo, block, sizeof(reader->lo));
+    SDL_memcpy(&reader->hi, block + 8, sizeof(reader->hi));
+    reader->lo = SDL_SwapLE64(reader->lo);
+    reader->hi = SDL_SwapLE64(reader->hi);
+    reader->pos = pos;
+}
+
+/* Get the 64 bits starting at pos, reading zeroes past the end of the block */
+static SDL_INLINE Uint64
+PeekBits(const BitReader *reader, int pos)
+{
+    if (pos >= 128) {
+        return 0;
+    } else if (pos >= 64) {
+        return reader->hi >> (pos - 64);
+    } else if (pos == 0) {
+        return reader->lo;
+    }
+    return (reader->lo >> pos) | (reader->hi << (64 - pos));
+}
+
+static SDL_INLINE int
+ReadBits(BitReader *reader, int count)
+{
+    const int value = (int) (PeekBits(reader, reader->pos) & ((1u << count) - 1));
+
+    reader->pos += count;
+    return value;
+}
+
+typedef struct
+{
+    Uint8 subsets;
+    Uint8 partition_bits;
+    Uint8 rotation_bits;
+    Uint8 index_selection_bits;
+    Uint8 color_bits;
+    Uint8 alpha_bits;
+    Uint8 endpoint_pbits;
+    Uint8 shared_pbits;
+    Uint8 index_bits;
+    Uint8 index2_bits;
+} BC7Mode;
+
+static const BC7Mode BC7_modes[8] = {
+    { 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+    { 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+    { 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+    { 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+    { 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+    { 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+    { 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+    { 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 }
+};
+
+static const Uint8 BC7_weights2[4] = { 0, 21, 43, 64 };
+static const Uint8 BC7_weights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+static const Uint8 BC7_weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+/* Pixels in subset 1 of the two subset partitions, one bit per pixel */
+static const Uint16 BC7_partitions2[64] = {
+    0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+    0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+    0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+    0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+    0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+    0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+    0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+    0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22
+};
+
+/* Subset of each pixel in the three subset partitions */
+static const Uint8 BC7_partitions3[64][16] = {
+    { 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 1, 2, 2, 2, 2 },
+    { 0, 0, 0, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 2, 1 },
+    { 0, 0, 0, 0, 2, 0, 0, 1, 2, 2, 1, 1, 2, 2, 1, 1 },
+    { 0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 1, 0, 1, 1, 1 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2 },
+    { 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 2, 2 },
+    { 0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1 },
+    { 0, 0, 1, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2 },
+    { 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2 },
+    { 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2 },
+    { 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2 },
+    { 0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2 },
+    { 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2 },
+    { 0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2, 1, 2, 2, 2 },
+    { 0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0, 2, 2, 2, 0 },
+    { 0, 0, 0, 1, 0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2 },
+    { 0, 1, 1, 1, 0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0 },
+    { 0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2 },
+    { 0, 0, 2, 2, 0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1 },
+    { 0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2, 0, 2, 2, 2 },
+    { 0, 0, 0, 1, 0, 0, 0, 1, 2, 2, 2, 1, 2, 2, 2, 1 },
+    { 0, 0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2 },
+    { 0, 0, 0, 0, 1, 1, 0, 0, 2, 2, 1, 0, 2, 2, 1, 0 },
+    { 0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1, 0, 0, 0, 0 },
+    { 0, 0, 1, 2, 0, 0, 1, 2, 1, 1, 2, 2, 2, 2, 2, 2 },
+    { 0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1, 0, 1, 1, 0 },
+    { 0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1 },
+    { 0, 0, 2, 2, 1, 1, 0, 2, 1, 1, 0, 2, 0, 0, 2, 2 },
+    { 0, 1, 1, 0, 0, 1, 1, 0, 2, 0, 0, 2, 2, 2, 2, 2 },
+    { 0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1 },
+    { 0, 0, 0, 0, 2, 0, 0, 0, 2, 2, 1, 1, 2, 2, 2, 1 },
+    { 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 2, 2, 2 },
+    { 0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 2, 0, 0, 1, 1 },
+    { 0, 0, 1, 1, 0, 0, 1, 2, 0, 0, 2, 2, 0, 2, 2, 2 },
+    { 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0 },
+    { 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0 },
+    { 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0 },
+    { 0, 1, 2, 0, 2, 0, 1, 2, 1, 2, 0, 1, 0, 1, 2, 0 },
+    { 0, 0, 1, 1, 2, 2, 0, 0, 1, 1, 2, 2, 0, 0, 1, 1 },
+    { 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0, 1, 1 },
+    { 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1 },
+    { 0, 0, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2, 1, 1, 2, 2 },
+    { 0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 1, 1 },
+    { 0, 2, 2, 0, 1, 2, 2, 1, 0, 2, 2, 0, 1, 2, 2, 1 },
+    { 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 0, 1, 0, 1 },
+    { 0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1 },
+    { 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2 },
+    { 0, 2, 2, 2, 0, 1, 1, 1, 0, 2, 2, 2, 0, 1, 1, 1 },
+    { 0, 0, 0, 2, 1, 1, 1, 2, 0, 0, 0, 2, 1, 1, 1, 2 },
+    { 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2 },
+    { 0, 2, 2, 2, 0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2 },
+    { 0, 0, 0, 2, 1, 1, 1, 2, 1, 1, 1, 2, 0, 0, 0, 2 },
+    { 0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2 },
+    { 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2, 2, 2, 2, 2 },
+    { 0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2 },
+    { 0, 0, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2 },
+    { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2 },
+    { 0, 0, 0, 2, 0, 0, 0, 1, 0, 0, 0, 2, 0, 0, 0, 1 },
+    { 0, 2, 2, 2, 1, 2, 2, 2, 0, 2, 2, 2, 1, 2, 2, 2 },
+    { 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2 },
+    { 0, 1, 1, 1, 2, 0, 1, 1, 2, 2, 0, 1, 2, 2, 2, 0 }
+};
+
+/* The anchor pixels, whose index has an implicit leading zero bit */
+static const Uint8 BC7_anchors2[64] = {
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15, 15, 15, 15, 15,
+    15,  2,  8,  2,  2,  8,  8, 15,
+     2,  8,  2,  2,  8,  8,  2,  2,
+    15, 15,  6,  8,  2,  8, 15, 15,
+     2,  8,  2,  2,  2, 15, 15,  6,
+     6,  2,  6,  8, 15, 15,  2,  2,
+    15, 15, 15, 15, 15,  2,  2, 15
+};
+
+static const Uint8 BC7_anchors3a[64] = {
+     3,  3, 15, 15,  8,  3, 15, 15,
+     8,  8,  6,  6,  6,  5,  3,  3,
+     3,  3,  8, 15,  3,  3,  6, 10,
+     5,  8,  8,  6,  8,  5, 15, 15,
+     8, 15,  3,  5,  6, 10,  8, 15,
+    15,  3, 15,  5, 15, 15, 15, 15,
+     3, 15,  5,  5,  5,  8,  5, 10,
+     5, 10,  8, 13, 15, 12,  3,  3
+};
+
+static const Uint8 BC7_anchors3b[64] = {
+    15,  8,  8,  3, 15, 15,  3,  8,
+    15, 15, 15, 15, 15, 15, 15,  8,
+    15,  8, 15,  3, 15,  8, 15,  8,
+     3, 15,  6, 10, 15, 15, 10,  8,
+    15,  3, 15, 10, 10,  8,  9, 10,
+     6, 15,  8, 15,  3,  6,  6,  8,
+    15,  3, 15, 15, 15, 15, 15, 15,
+    15, 15, 15, 15,  3, 15, 15,  8
+};
+
+static SDL_INLINE int
+BC7Interpolate(int e0, int e1, int weight)
+{
+    return ((64 - weight) * e0 + weight * e1 + 32) >> 6;
+}
+
+static const Uint8 *
+BC7Weights(int bits)
+{
+    return (bits == 2) ? BC7_weights2 : (bits == 3) ? BC7_weights3 : BC7_weights4;
+}
+
+static void
+DecodeBlockBC7(const Uint8 *block, Uint8 *dst, int dst_pitch)
+{
+    const BC7Mode *mode;
+    BitReader reader;
+    Uint8 endpoints[3][2][4];
+    Uint8 indices[16], indices2[16];
+    Uint8 subset_of[16];
+    Uint8 anchor[16];
+    const Uint8 *color_weights, *alpha_weights;
+    int partition, rotation, index_selection;
+    int m, s, e, c, i, bits;
+
+    for (m = 0; m < 8 && !(block[0] & (1 << m)); ++m) {
+        continue;
+    }
+    if (m == 8) {
+        /* Reserved mode, decodes to transparent black */
+        for (i = 0; i < 4; ++i) {
+            SDL_memset(dst + i * dst_pitch, 0, 4 * sizeof(Uint32));
+        }
+        return;
+    }
+    mode = &BC7_modes[m];
+    InitBitReader(&reader, block, m + 1);
+
+    partition = ReadBits(&reader, mode->partition_bits);
+    rotation = ReadBits(&reader, mode->rotation_bits);
+    index_selection = ReadBits(&reader, mode->index_selection_bits);
+
+    /* Endpoints are stored channel by channel */
+    for (c = 0; c < 3; ++c) {
+        for (s = 0; s < mode->subsets; ++s) {
+            for (e = 0; e < 2; ++e) {
+                endpoints[s][e][c] = (Uint8) ReadBits(&reader, mode->color_bits);
+            }
+        }
+    }
+    for (s = 0; s < mode->subsets; ++s) {
+        for (e = 0; e < 2; ++e) {
+            endpoints[s][e][3] = (Uint8) ReadBits(&reader, mode->alpha_bits);
+        }
+    }
+    if (mode->endpoint_pbits || mode->shared_pbits) {
+        for (s = 0; s < mode->subsets; ++s) {
+            int pbit = mode->shared_pbits ? ReadBits(&reader, 1) : 0;
+            for (e = 0; e < 2; ++e) {
+                if (mode->endpoint_pbits) {
+                    pbit = ReadBits(&reader, 1);
+                }
+                for (c = 0; c < 4; ++c) {
+                    endpoints[s][e][c] = (Uint8) ((endpoints[s][e][c] << 1) | pbit);
+                }
+            }
+        }
+    }
+
+    /* Expand the endpoints to 8 bits by replicating their top bits */
+    for (s = 0; s < mode->subsets; ++s) {
+        for (e = 0; e < 2; ++e) {
+            for (c = 0; c < 4; ++c) {
+                bits = (c < 3) ? mode->color_bits : mode->alpha_bits;
+                if (bits == 0) {
+                    endpoints[s][e][c] = 255;
+                    continue;
+                }
+                bits += (mode->endpoint_pbits || mode->shared_pbits) ? 1 : 0;
+                endpoints[s][e][c] = (Uint8) ((endpoints[s][e][c] << (8 - bits)) |
+                                              (endpoints[s][e][c] >> (2 * bits - 8)));
+            }
+        }
+    }
+
+    SDL_zero(anchor);
+    anchor[0] = 1;
+    for (i = 0; i < 16; ++i) {
+        if (mode->subsets == 2) {
+            subset_of[i] = (BC7_partitions2[partition] >> i) & 1;
+        } else if (mode->subsets == 3) {
+            subset_of[i] = BC7_partitions3[partition][i];
+        } else {
+            subset_of[i] = 0;
+        }
+    }
+    if (mode->subsets == 2) {
+        anchor[BC7_anchors2[partition]] = 1;
+    } else if (mode->subsets == 3) {
+        anchor[BC7_anchors3a[partition]] = 1;
+        anchor[BC7_anchors3b[partition]] = 1;
+    }
+
+    for (i = 0; i < 16; ++i) {
+        indices[i] = (Uint8) ReadBits(&reader, mode->index_bits - anchor[i]);
+    }
+    if (mode->index2_bits) {
+        for (i = 0; i < 16; ++i) {
+            indices2[i] = (Uint8) ReadBits(&reader, mode->index2_bits - (i == 0));
+        }
+    }
+
+    color_weights = BC7Weights(mode->index_bits);
+    alpha_weights = color_weights;
+    if (mode->index2_bits) {
+        if (index_selection) {
+            color_weights = BC7Weights(mode->index2_bits);
+        } else {
+            alpha_weights = BC7Weights(mode->index2_bits);
+        }
+    }
+
+    for (i = 0; i < 16; ++i) {
+        const Uint8 *e0 = endpoints[subset_of[i]][0];
+        const Uint8 *e1 = endpoints[subset_of[i]][1];
+        int color_index = indices[i];
+        int alpha_index = indices[i];
+        int rgba[4];
+
+        if (mode->index2_bits) {
+            if (index_selection) {
+                color_index = indices2[i];
+            } else {
+                alpha_index = indices2[i];
+            }
+        }
+        for (c = 0; c < 3; ++c) {
+            rgba[c] = BC7Interpolate(e0[c], e1[c], color_weights[color_index]);
+        }
+        rgba[3] = BC7Interpolate(e0[3], e1[3], alpha_weights[alpha_index]);
+        if (rotation) {
+            const int swap = rgba[3];
+            rgba[3] = rgba[rotation - 1];
+            rgba[rotation - 1] = swap;
+        }
+        ((Uint32 *) (dst + (i / 4) * dst_pitch))[i % 4] = ARGB(rgba[3], rgba[0], rgba[1], rgba[2]);
+    }
+}
+
+
+/* ETC2 blocks */
+
+static const Uint8 ETC_modifiers[8][2] = {
+    { 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 },
+    { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 }
+};
+
+static const Uint8 ETC_distances[8] = { 3, 6, 11, 16, 23, 32, 41, 64 };
+
+static const Sint8 EAC_modifiers[16][8] = {
+    { -3, -6, -9, -15, 2, 5, 8, 14 },
+    { -3, -7, -10, -13, 2, 6, 9, 12 },
+    { -2, -5, -8, -13, 1, 4, 7, 12 },
+    { -2, -4, -6, -13, 1, 3, 5, 12 },
+    { -3, -6, -8, -12, 2, 5, 7, 11 },
+    { -3, -7, -9, -11, 2, 6, 8, 10 },
+    { -4, -7, -8, -11, 3, 6, 7, 10 },
+    { -3, -5, -8, -11, 2, 4, 7, 10 },
+    { -2, -6, -8, -10, 1, 5, 7, 9 },
+    { -2, -5, -8, -10, 1, 4, 7, 9 },
+    { -2, -4, -8, -10, 1, 3, 7, 9 },
+    { -2, -5, -7, -10, 1, 4, 6, 9 },
+    { -3, -4, -7, -10, 2, 3, 6, 9 },
+    { -1, -2, -3, -10, 0, 1, 2, 9 },
+    { -4, -6, -8, -9, 3, 5, 7, 8 },
+    { -3, -5, -7, -9, 2, 4, 6, 8 }
+};
+
+static SDL_INLINE Uint32
+ETCColor(int r, int g, int b)
+{
+    return ARGB(255, Clamp255(r), Clamp255(g), Clamp255(b));
+}
+
+static SDL_INLINE Uint32
+ETCOffsetColor(const int rgb[3], int offset)
+{
+    return ETCColor(rgb[0] + offset, rgb[1] + offset, rgb[2] + offset);
+}
+
+/* Decode an ETC2 color block. With punchthrough alpha the differential bit
+   tells whether the block is opaque, and index 2 becomes transparent otherwise. */
+static void
+DecodeETC2Color(const Uint8 *block, SDL_bool punchthrough, Uint8 *dst, int dst_pitch)
+{
+    const Uint32 pixel_bits = ((Uint32) block[4] << 24) | (block[5] << 16) | (block[6] << 8) | block[7];
+    const SDL_bool differential = (block[3] & 0x02) ? SDL_TRUE : SDL_FALSE;
+    const SDL_bool opaque = punchthrough ? differential : SDL_TRUE;
+    Uint32 palette[2][4];
+    int x, y;
+
+    if (punchthrough || differential) {
+        const int r = block[0] >> 3, dr = ((block[0] & 7) ^ 4) - 4;
+        const int g = block[1] >> 3, dg = ((block[1] & 7) ^ 4) - 4;
+        const int b = block[2] >> 3, db = ((block[2] & 7) ^ 4) - 4;
+
+        if (r + dr < 0 || r + dr > 31) {
+            /* T mode */
+            int c1[3], c2[3], d;
+
+            c1[0] = (((block[0] >> 1) & 0x0C) | (block[0] & 0x03)) * 17;
+            c1[1] = (block[1] >> 4) * 17;
+            c1[2] = (block[1] & 0x0F) * 17;
+            c2[0] = (block[2] >> 4) * 17;
+            c2[1] = (block[2] & 0x0F) * 17;
+            c2[2] = (block[3] >> 4) * 17;
+            d = ETC_distances[((block[3] >> 1) & 0x06) | (block[3] & 0x01)];
+            palette[0][0] = ETCColor(c1[0], c1[1], c1[2]);
+            palette[0][1] = ETCOffsetColor(c2, d);
+            palette[0][2] = ETCColor(c2[0], c2[1], c2[2]);
+            palette[0][3] = ETCOffsetColor(c2, -d);
+        } else if (g + dg < 0 || g + dg > 31) {
+            /* H mode */
+            int c1[3], c2[3], d, order;
+
+            c1[0] = (block[0] >> 3) & 0x0F;
+            c1[1] = ((block[0] & 0x07) << 1) | ((block[1] >> 4) & 0x01);
+            c1[2] = (block[1] & 0x08) | ((block[1] & 0x03) << 1) | (block[2] >> 7);
+            c2[0] = (block[2] >> 3) & 0x0F;
+            c2[1] = ((block[2] & 0x07) << 1) | (block[3] >> 7);
+            c2[2] = (block[3] >> 3) & 0x0F;
+            order = ((c1[0] << 8) | (c1[1] << 4) | c1[2]) >= ((c2[0] << 8) | (c2[1] << 4) | c2[2]);
+            d = ETC_distances[(block[3] & 0x04) | ((block[3] & 0x01) << 1) | order];
+            for (x = 0; x < 3; ++x) {
+                c1[x] *= 17;
+                c2[x] *= 17;
+            }
+            palette[0][0] = ETCOffsetColor(c1, d);
+            palette[0][1] = ETCOffsetColor(c1, -d);
+            palette[0][2] = ETCOffsetColor(c2, d);
+            palette[0][3] = ETCOffsetColor(c2, -d);
+        } else if (b + db < 0 || b + db > 31) {
+            /* Planar mode, always opaque */
+            int ro, go, bo, rh, gh, bh, rv, gv, bv;
+
+            ro = (block[0] >> 1) & 0x3F;
+            go = ((block[0] & 0x01) << 6) | ((block[1] >> 1) & 0x3F);
+            bo = ((block[1] & 0x01) << 5) | (block[2] & 0x18) | ((block[2] & 0x03) << 1) | (block[3] >> 7);
+            rh = ((block[3] >> 1) & 0x3E) | (block[3] & 0x01);
+            gh = block[4] >> 1;
+            bh = ((block[4] & 0x01) << 5) | (block[5] >> 3);
+            rv = ((block[5] & 0x07) << 3) | (block[6] >> 5);
+            gv = ((block[6] & 0x1F) << 2) | (block[7] >> 6);
+            bv = block[7] & 0x3F;
+            ro = (ro << 2) | (ro >> 4); rh = (rh << 2) | (rh >> 4); rv = (rv << 2) | (rv >> 4);
+            go = (go << 1) | (go >> 6); gh = (gh << 1) | (gh >> 6); gv = (gv << 1) | (gv >> 6);
+            bo = (bo << 2) | (bo >> 4); bh = (bh << 2) | (bh >> 4); bv = (bv << 2) | (bv >> 4);
+            for (y = 0; y < 4; ++y) {
+                Uint32 *row = (Uint32 *) (dst + y * dst_pitch);
+                for (x = 0; x < 4; ++x) {
+                    row[x] = ETCColor((x * (rh - ro) + y * (rv - ro) + 4 * ro + 2) >> 2,
+                                      (x * (gh - go) + y * (gv - go) + 4 * go + 2) >> 2,
+                                      (x * (bh - bo) + y * (bv - bo) + 4 * bo + 2) >> 2);
+                }
+            }
+            return;
+        } else {
+            /* Differential mode */
+            int base[2][3], s;
+            base[0][0] = r; base[0][1] = g; base[0][2] = b;
+            base[1][0] = r + dr; base[1][1] = g + dg; base[1][2] = b + db;
+            for (s = 0; s < 2; ++s) {
+                const int a = opaque ? ETC_modifiers[(block[3] >> (s ? 2 : 5)) & 7][0] : 0;
+                const int m = ETC_modifiers[(block[3] >> (s ? 2 : 5)) & 7][1];
+                int rgb[3];
+                for (x = 0; x < 3; ++x) {
+                    rgb[x] = (base[s][x] << 3) | (base[s][x] >> 2);
+                }
+                palette[s][0] = ETCOffsetColor(rgb, a);
+                palette[s][1] = ETCOffsetColor(rgb, m);
+                palette[s][2] = ETCOffsetColor(rgb, -a);
+                palette[s][3] = ETCOffsetColor(rgb, -m);
+            }
+            goto individual_pixels;
+        }
+
+        /* T and H modes use one palette for the whole block */
+        if (!opaque) {
+            palette[0][2] = 0;
+        }
+        for (y = 0; y < 4; ++y) {
+            Uint32 *row = (Uint32 *) (dst + y * dst_pitch);
+            for (x = 0; x < 4; ++x) {
+                const int k = x * 4 + y;
+                const int index = (((pixel_bits >> (k + 16)) & 1) << 1) | ((pixel_bits >> k) & 1);
+                row[x] = palette[0][index];
+            }
+        }
+        return;
+    } else {
+        /* Individual mode */
+        int s;
+        for (s = 0; s < 2; ++s) {
+            const int shift = s ? 0 : 4;
+            const int a = ETC_modifiers[(block[3] >> (s ? 2 : 5)) & 7][0];
+            const int m = ETC_modifiers[(block[3] >> (s ? 2 : 5)) & 7][1];
+            int rgb[3];
+            rgb[0] = ((block[0] >> shift) & 0x0F) * 17;
+            rgb[1] = ((block[1] >> shift) & 0x0F) * 17;
+            rgb[2] = ((block[2] >> shift) & 0x0F) * 17;
+            palette[s][0] = ETCOffsetColor(rgb, a);
+            palette[s][1] = ETCOffsetColor(rgb, m);
+            palette[s][2] = ETCOffsetColor(rgb, -a);
+            palette[s][3] = ETCOffsetColor(rgb, -m);
+        }
+    }
+
+individual_pixels:
+    /* Without punchthrough alpha index 2 is the negative small modifier */
+    if (!opaque) {
+        palette[0][2] = palette[1][2] = 0;
+    }
+    for (y = 0; y < 4; ++y) {
+        Uint32 *row = (Uint32 *) (dst + y * dst_pitch);
+        for (x = 0; x < 4; ++x) {
+            const int k = x * 4 + y;
+            const int index = (((pixel_bits >> (k + 16)) & 1) << 1) | ((pixel_bits >> k) & 1);
+            const int subblock = (block[3] & 0x01) ? (y >= 2) : (x >= 2);
+            row[x] = palette[subblock][index];
+        }
+    }
+}
+
+static void
+DecodeBlockETC2RGB8(const Uint8 *block, Uint8 *dst, int dst_pitch)
+{
+    DecodeETC2Color(block, SDL_FALSE, dst, dst_pitch);
+}
+
+static void
+DecodeBlockETC2RGB8A1(const Uint8 *block, Uint8 *dst, int dst_pitch)
+{
+    DecodeETC2Color(block, SDL_TRUE, dst, dst_pitch);
+}
+
+static void
+DecodeBlockETC2RGBA8(const Uint8 *block, Uint8 *dst, int dst_pitch)
+{
+    const int base = block[0];
+    const int multiplier = block[1] >> 4;
+    const Sint8 *modifiers = EAC_modifiers[block[1] & 0x0F];
+    const Uint64 bits = ((Uint64) block[2] << 40) | ((Uint64) block[3] << 32) |
+                        ((Uint32) block[4] << 24) | (block[5] << 16) | (block[6] << 8) | block[7];
+    int x, y;
+
+    DecodeETC2Color(block + 8, SDL_FALSE, dst, dst_pitch);
+    for (y = 0; y < 4; ++y) {
+        Uint32 *row = (Uint32 *) (dst + y * dst_pitch);
+        for (x = 0; x < 4; ++x) {
+            const int index = (int) (bits >> (45 - 3 * (x * 4 + y))) & 7;
+            const Uint8 alpha = Clamp255(base + modifiers[index] * multiplier);
+            row[x] = (row[x] & 0x00FFFFFF) | ((Uint32) alpha << 24);
+        }
+    }
+}
+
+
+/* ASTC blocks, LDR profile */
+
+typedef struct
+{
+    Uint8 bits;
+    Uint8 trits;
+    Uint8 quints;
+} ASTCQuantLevel;
+
+/* The ranges 2, 3, 4, 5, 6, 8, 10, 12, 16, 20, 24, 32, 40, 48, 64, 80, 96, 128, 160, 192 and 256 */
+static const ASTCQuantLevel ASTC_quant_levels[] = {
+    { 1, 0, 0 }, { 0, 1, 0 }, { 2, 0, 0 }, { 0, 0, 1 }, { 1, 1, 0 }, { 3, 0, 0 }, { 1, 0, 1 },
+    { 2, 1, 0 }, { 4, 0, 0 }, { 2, 0, 1 }, { 3, 1, 0 }, { 5, 0, 0 }, { 3, 0, 1 }, { 4, 1, 0 },
+    { 6, 0, 0 }, { 4, 0, 1 }, { 5, 1, 0 }, { 7, 0, 0 }, { 5, 0, 1 }, { 6, 1, 0 }, { 8, 0, 0 }
+};
+
+#define ASTC_QUANT_6    4
+
+typedef struct
+{
+    int grid_w;
+    int grid_h;
+    SDL_bool dual_plane;
+    int weight_quant;
+    int partitions;
+    int partition_index;
+    int cem[4];
+    int ccs;
+    int color_start;
+    int color_quant;
+    int color_count;
+} ASTCBlockInfo;
+
+static int
+ASTCSequenceBits(int count, int quant)
+{
+    const ASTCQuantLevel *level = &ASTC_quant_levels[quant];
+
+    return count * level->bits + (count * 8 * level->trits + 4) / 5 + (count * 7 * level->quints + 2) / 3;
+}
+
+/* Copy a run of bits into a zeroed buffer, so reads past the end of an integer sequence return zero */
+static void
+ASTCExtractBits(const Uint8 *src, int start, int count, Uint8 dst[16])
+{
+    BitReader reader;
+    Uint64 lo, hi;
+
+    InitBitReader(&reader, src, start);
+    lo = PeekBits(&reader, start);
+    hi = PeekBits(&reader, start + 64);
+    if (count < 64) {
+        lo &= ((Uint64) 1 << count) - 1;
+        hi = 0;
+    } else if (count < 128) {
+        hi &= ((Uint64) 1 << (count - 64)) - 1;
+    }
+    lo = SDL_SwapLE64(lo);
+    hi = SDL_SwapLE64(hi);
+    SDL_memcpy(dst, &lo, sizeof(lo));
+    SDL_memcpy(dst + 8, &hi, sizeof(hi));
+}
+
+/* Decode an integer sequence, storing the trit or quint in the high bits of each value */
+static void
+ASTCDecodeSequence(const Uint8 *data, int count, int quant, Uint8 *values)
+{
+    const ASTCQuantLevel *level = &ASTC_quant_levels[quant];
+    const int n = level->bits;
+    BitReader reader;
+    int i, j;
+
+    InitBitReader(&reader, data, 0);
+    if (level->trits) {
+        for (i = 0; i < count; i += 5) {
+            static const Uint8 T_bits[5] = { 2, 2, 1, 2, 1 };
+            int m[5], t[5], T = 0, C, shift = 0;
+            for (j = 0; j < 5; ++j) {
+                m[j] = ReadBits(&reader, n);
+                T |= ReadBits(&reader, T_bits[j]) << shift;
+                shift += T_bits[j];
+            }
+            if (((T >> 2) & 7) == 7) {
+                C = ((T >> 5) << 2) | (T & 3);
+                t[4] = 2;
+                t[3] = 2;
+            } else {
+                C = T & 0x1F;
+                if (((T >> 5) & 3) == 3) {
+                    t[4] = 2;
+                    t[3] = T >> 7;
+                } else {
+                    t[4] = T >> 7;
+                    t[3] = (T >> 5) & 3;
+                }
+            }
+            if ((C & 3) == 3) {
+                t[2] = 2;
+                t[1] = C >> 4;
+                t[0] = (((C >> 3) & 1) << 1) | ((C >> 2) & ~(C >> 3) & 1);
+            } else if (((C >> 2) & 3) == 3) {
+                t[2] = 2;
+                t[1] = 2;
+                t[0] = C & 3;
+            } else {
+                t[2] = C >> 4;
+                t[1] = (C >> 2) & 3;
+                t[0] = (C & 2) | (C & ~(C >> 1) & 1);
+            }
+            for (j = 0; j < 5 && i + j < count; ++j) {
+                values[i + j] = (Uint8) ((t[j] << n) | m[j]);
+            }
+        }
+    } else if (level->quints) {
+        for (i = 0; i < count; i += 3) {
+            static const Uint8 Q_bits[3] = { 3, 2, 2 };
+            int m[3], q[3], Q = 0, C, shift = 0;
+            for (j = 0; j < 3; ++j) {
+                m[j] = ReadBits(&reader, n);
+                Q |= ReadBits(&reader, Q_bits[j]) << shift;
+                shift += Q_bits[j];
+            }
+            if (((Q >> 1) & 3) == 3 && ((Q >> 5) & 3) == 0) {
+                q[2] = ((Q & 1) << 2) | (((Q >> 4) & ~Q & 1) << 1) | ((Q >> 3) & ~Q & 1);
+                q[1] = 4;
+                q[0] = 4;
+            } else {
+                if (((Q >> 1) & 3) == 3) {
+                    q[2] = 4;
+                    C = (((Q >> 3) & 3) << 3) | ((~Q >> 5) & 3) << 1 | (Q & 1);
+                } else {
+                    q[2] = (Q >> 5) & 3;
+                    C = Q & 0x1F;
+                }
+                if ((C & 7) == 5) {
+                    q[1] = 4;
+                    q[0] = C >> 3;
+                } else {
+                    q[1] = C >> 3;
+                    q[0] = C & 7;
+                }
+            }
+            for (j = 0; j < 3 && i + j < count; ++j) {
+                values[i + j] = (Uint8) ((q[j] << n) | m[j]);
+            }
+        }
+    } else {
+        for (i = 0; i < count; ++i) {
+            values[i] = (Uint8) ReadBits(&reader, n);
+        }
+    }
+}
+
+/* Expand a sequence of color values to the range 0-255 */
+static void
+ASTCUnquantizeColors(Uint8 *values, int count, int quant)
+{
+    const ASTCQuantLevel *level = &ASTC_quant_levels[quant];
+    const int n = level->bits;
+    int i;
+
+    for (i = 0; i < count; ++i) {
+        const int m = values[i] & ((1 << n) - 1);
+        const int D = values[i] >> n;
+        const int A = (m & 1) ? 0x1FF : 0;
+        const int x = m >> 1;
+        int B = 0, C = 0, T;
+
+        if (!level->trits && !level->quints) {
+            int value = m << (8 - n);
+            for (T = n; T < 8; T += n) {
+                value |= value >> T;
+            }
+            values[i] = (Uint8) value;
+            continue;
+        }
+        if (level->trits) {
+            switch (n) {
+            case 1: C = 204; break;
+            case 2: C = 93; B = x * 0x116; break;
+            case 3: C = 44; B = (x << 7) | (x << 2) | x; break;
+            case 4: C = 22; B = (x << 6) | x; break;
+            case 5: C = 11; B = (x << 5) | (x >> 2); break;
+            case 6: C = 5; B = (x << 4) | (x >> 4); break;
+            }
+        } else {
+            switch (n) {
+            case 1: C = 113; break;
+            case 2: C = 54; B = x * 0x10C; break;
+            case 3: C = 26; B = (x << 7) | (x << 1) | (x >> 1); break;
+            case 4: C = 13; B = (x << 6) | (x >> 1); break;
+            case 5: C = 6; B = (x << 5) | (x >> 3); break;
+            }
+        }
+        T = (D * C + B) ^ A;
+        values[i] = (Uint8) ((A & 0x80) | (T >> 2));
+    }
+}
+
+/* Expand a sequence of weights to the range 0-64 */
+static void
+ASTCUnquantizeWeights(Uint8 *values, int count, int quant)
+{
+    const ASTCQuantLevel *level = &ASTC_quant_levels[quant];
+    const int n = level->bits;
+    int i;
+
+    for (i = 0; i < count; ++i) {
+        const int m = values[i] & ((1 << n) - 1);
+        const int D = values[i] >> n;
+        const int A = (m & 1) ? 0x7F : 0;
+        const int x = m >> 1;
+        int B = 0, C = 0, T;
+
+        if (!level->trits && !level->quints) {
+            T = m << (6 - n);
+            T |= T >> n;
+            T |= T >> (2 * n);
+            T |= T >> (4 * n);
+        } else if (n == 0) {
+            values[i] = (Uint8) (D * (level->trits ? 32 : 16));
+            continue;
+        } else {
+            if (level->trits) {
+                switch (n) {
+                case 1: C = 50; break;
+                case 2: C = 23; B = x * 0x45; break;
+                case 3: C = 11; B = (x << 5) | x; break;
+                }
+            } else {
+                switch (n) {
+                case 1: C = 28; break;
+                case 2: C = 13; B = x * 0x42; break;
+                }
+            }
+            T = (D * C + B) ^ A;
+            T = (A & 0x20) | (T >> 2);
+        }
+        if (T > 32) {
+            ++T;
+        }
+        values[i] = (Uint8) T;
+    }
+}
+
+static Uint32
+ASTCHash52(Uint32 p)
+{
+    p ^= p >> 15;
+    p -= p << 17;
+    p += p << 7;
+    p += p << 4;
+    p ^= p >> 5;
+    p += p << 16;
+    p ^= p >> 7;
+    p ^= p >> 3;
+    p ^= p << 6;
+    p ^= p >> 17;
+    return p;
+}
+
+static int
+ASTCSelectPartition(int seed, int x, int y, int partitions, SDL_bool small_block)
+{
+    Uint32 rnum;
+    Uint8 seeds[8];
+    int sh1, sh2, i, a, b, c, d;
+
+    if (small_block) {
+        x <<= 1;
+        y <<= 1;
+    }
+    seed += (partitions - 1) * 1024;
+    rnum = ASTCHash52((Uint32) seed);
+    for (i = 0; i < 8; ++i) {
+        seeds[i] = (Uint8) ((rnum >> (i * 4)) & 0xF);
+        seeds[i] *= seeds[i];
+    }
+    if (seed & 1) {
+        sh1 = (seed & 2) ? 4 : 5;
+        sh2 = (partitions == 3) ? 6 : 5;
+    } else {
+        sh1 = (partitions == 3) ? 6 : 5;
+        sh2 = (seed & 2) ? 4 : 5;
+    }
+    a = (((seeds[0] >> sh1) * x + (seeds[1] >> sh2) * y + (rnum >> 14))) & 0x3F;
+    b = (((seeds[2] >> sh1) * x + (seeds[3] >> sh2) * y + (rnum >> 10))) & 0x3F;
+    c = (partitions < 3) ? 0 : (((seeds[4] >> sh1) * x + (seeds[5] >> sh2) * y + (rnum >> 6))) & 0x3F;
+    d = (partitions < 4) ? 0 : (((seeds[6] >> sh1) * x + (seeds[7] >> sh2) * y + (rnum >> 2))) & 0x3F;
+    if (a >= b && a >= c && a >= d) {
+        return 0;
+    } else if (b >= c && b >= d) {
+        return 1;
+    } else if (c >= d) {
+        return 2;
+    }
+    return 3;
+}
+
+/* Decode the block mode and the block configuration, returns SDL_FALSE for an invalid block */
+static SDL_bool
+ASTCDecodeBlockInfo(const Uint8 *block, ASTCBlockInfo *info, int block_w, int block_h)
+{
+    const int mode = block[0] | ((block[1] & 0x07) << 8);
+    int R, A, B, H, weight_count, weight_bits, below_weights, color_bits, i;
+    BitReader reader;
+
+    if (mode & 3) {
+        R = ((mode >> 4) & 1) | ((mode & 3) << 1);
+        A = (mode >> 5) & 3;
+        B = (mode >> 7) & 3;
+        switch ((mode >> 2) & 3) {
+        case 0: info->grid_w = B + 4; info->grid_h = A + 2; break;
+        case 1: info->grid_w = B + 8; info->grid_h = A + 2; break;
+        case 2: info->grid_w = A + 2; info->grid_h = B + 8; break;
+        default:
+            B &= 1;
+            if (mode & 0x100) {
+                info->grid_w = B + 2;
+                info->grid_h = A + 2;
+            } else {
+                info->grid_w = A + 2;
+                info->grid_h = B + 6;
+            }
+            break;
+        }
+        H = (mode >> 9) & 1;
+        info->dual_plane = (mode & 0x400) ? SDL_TRUE : SDL_FALSE;
+    } else {
+        R = ((mode >> 4) & 1) | (((mode >> 2) & 3) << 1);
+        if (R < 2) {
+            return SDL_FALSE;
+        }
+        A = (mode >> 5) & 3;
+        H = (mode >> 9) & 1;
+        info->dual_plane = (mode & 0x400) ? SDL_TRUE : SDL_FALSE;
+        switch ((mode >> 7) & 3) {
+        case 0: info->grid_w = 12; info->grid_h = A + 2; break;
+        case 1: info->grid_w = A + 2; info->grid_h = 12; break;
+        case 2:
+            info->grid_w = A + 6;
+            info->grid_h = ((mode >> 9) & 3) + 6;
+            H = 0;
+            info->dual_plane = SDL_FALSE;
+            break;
+        default:
+            if (A == 0) {
+                info->grid_w = 6;
+                info->grid_h = 10;
+            } else if (A == 1) {
+                info->grid_w = 10;
+                info->grid_h = 6;
+            } else {
+                return SDL_FALSE;
+            }
+            break;
+        }
+    }
+    info->weight_quant = (R - 2) + 6 * H;
+
+    weight_count = info->grid_w * info->grid_h * (info->dual_plane ? 2 : 1);
+    if (weight_count > 64 || info->grid_w > block_w || info->grid_h > block_h) {
+        return SDL_FALSE;
+    }
+    weight_bits = ASTCSequenceBits(weight_count, info->weight_quant);
+    if (weight_bits < 24 || weight_bits > 96) {
+        return SDL_FALSE;
+    }
+    below_weights = 128 - weight_bits;
+
+    InitBitReader(&reader, block, 11);
+    info->partitions = ReadBits(&reader, 2) + 1;
+    if (info->partitions == 4 && info->dual_plane) {
+        return SDL_FALSE;
+    }
+    if (info->partitions == 1) {
+        info->partition_index = 0;
+        info->cem[0] = ReadBits(&reader, 4);
+    } else {
+        int cem_bits;
+
+        info->partition_index = ReadBits(&reader, 10);
+        cem_bits = ReadBits(&reader, 6);
+        if ((cem_bits & 3) == 0) {
+            for (i = 0; i < info->partitions; ++i) {
+                info->cem[i] = cem_bits >> 2;
+            }
+        } else {
+            /* The high bits of the endpoint modes are stored below the weights */
+            const int extra_bits = 3 * info->partitions - 4;
+            const int base_class = (cem_bits & 3) - 1;
+            BitReader extra;
+
+            below_weights -= extra_bits;
+            InitBitReader(&extra, block, below_weights);
+            cem_bits |= ReadBits(&extra, extra_bits) << 6;
+            for (i = 0; i < info->partitions; ++i) {
+                const int increment = (cem_bits >> (2 + i)) & 1;
+                const int mode_bits = (cem_bits >> (2 + info->partitions + 2 * i)) & 3;
+                info->cem[i] = ((base_class + increment) << 2) | mode_bits;
+            }
+        }
+    }
+    info->color_start = reader.pos;
+
+    if (info->dual_plane) {
+        BitReader ccs;
+
+        below_weights -= 2;
+        InitBitReader(&ccs, block, below_weights);
+        info->ccs = ReadBits(&ccs, 2);
+    }
+
+    info->color_count = 0;
+    for (i = 0; i < info->partitions; ++i) {
+        info->color_count += ((info->cem[i] >> 2) + 1) * 2;
+    }
+    if (info->color_count > 18) {
+        return SDL_FALSE;
+    }
+
+    /* Use the largest color range that fits in the remaining bits */
+    color_bits = below_weights - info->color_start;
+    for (info->color_quant = SDL_arraysize(ASTC_quant_levels) - 1; info->color_quant > 0; --info->color_quant) {
+        if (ASTCSequenceBits(info->color_count, info->color_quant) <= color_bits) {
+            break;
+        }
+    }
+    if (info->color_quant < ASTC_QUANT_6) {
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+static void
+ASTCBitTransferSigned(int *a, int *b)
+{
+    *b >>= 1;
+    *b |= *a & 0x80;
+    *a >>= 1;
+    *a &= 0x3F;
+    if (*a & 0x20) {
+        *a -= 0x40;
+    }
+}
+
+static void
+ASTCSetEndpoint(int endpoint[4], int r, int g, int b, int a)
+{
+    endpoint[0] = Clamp255(r);
+    endpoint[1] = Clamp255(g);
+    endpoint[2] = Clamp255(b);
+    endpoint[3] = Clamp255(a);
+}
+
+static void
+ASTCSetEndpointBlueContract(int endpoint[4], int r, int g, int b, int a)
+{
+    ASTCSetEndpoint(endpoint, (r + b) >> 1, (g + b) >> 1, b, a);
+}
+
+/* Decode the endpoints of one partition, returns SDL_FALSE for the HDR modes */
+static SDL_bool
+ASTCDecodeEndpoints(int cem, const Uint8 *values, int e0[4], int e1[4])
+{
+    int v[8], i;
+
+    for (i = 0; i < 8; ++i) {
+        v[i] = (i < ((cem >> 2) + 1) * 2) ? values[i] : 0;
+    }
+    switch (cem) {
+    case 0:
+        ASTCSetEndpoint(e0, v[0], v[0], v[0], 255);
+        ASTCSetEndpoint(e1, v[1], v[1], v[1], 255);
+        break;
+    case 1:
+    {
+        const int l0 = (v[0] >> 2) | (v[1] & 0xC0);
+        const int l1 = SDL_min(l0 + (v[1] & 0x3F), 255);
+        ASTCSetEndpoint(e0, l0, l0, l0, 255);
+        ASTCSetEndpoint(e1, l1, l1, l1, 255);
+        break;
+    }
+    case 4:
+        ASTCSetEndpoint(e0, v[0], v[0], v[0], v[2]);
+        ASTCSetEndpoint(e1, v[1], v[1], v[1], v[3]);
+        break;
+    case 5:
+        ASTCBitTransferSigned(&v[1], &v[0]);
+        ASTCBitTransferSigned(&v[3], &v[2]);
+        ASTCSetEndpoint(e0, v[0], v[0], v[0], v[2]);
+        ASTCSetEndpoint(e1, v[0] + v[1], v[0] + v[1], v[0] + v[1], v[2] + v[3]);
+        break;
+    case 6:
+        ASTCSetEndpoint(e0, (v[0] * v[3]) >> 8, (v[1] * v[3]) >> 8, (v[2] * v[3]) >> 8, 255);
+        ASTCSetEndpoint(e1, v[0], v[1], v[2], 255);
+        break;
+    case 8:
+    case 12:
+        if (cem == 8) {
+            v[6] = v[7] = 255;
+        }
+        if (v[1] + v[3] + v[5] >= v[0] + v[2] + v[4]) {
+            ASTCSetEndpoint(e0, v[0], v[2], v[4], v[6]);
+            ASTCSetEndpoint(e1, v[1], v[3], v[5], v[7]);
+        } else {
+            ASTCSetEndpointBlueContract(e0, v[1], v[3], v[5], v[7]);
+            ASTCSetEndpointBlueContract(e1, v[0], v[2], v[4], v[6]);
+        }
+        break;
+    case 9:
+    case 13:
+        if (cem == 9) {
+            v[6] = 255;
+            v[7] = 0;
+        } else {
+            ASTCBitTransferSigned(&v[7], &v[6]);
+        }
+        ASTCBitTransferSigned(&v[1], &v[0]);
+        ASTCBitTransferSigned(&v[3], &v[2]);
+        ASTCBitTransferSigned(&v[5], &v[4]);
+        if (v[1] + v[3] + v[5] >= 0) {
+            ASTCSetEndpoint(e0, v[0], v[2], v[4], v[6]);
+            ASTCSetEndpoint(e1, v[0] + v[1], v[2] + v[3], v[4] + v[5], v[6] + v[7]);
+        } else {
+            ASTCSetEndpointBlueContract(e0, v[0] + v[1], v[2] + v[3], v[4] + v[5], v[6] + v[7]);
+            ASTCSetEndpointBlueContract(e1, v[0], v[2], v[4], v[6]);
+        }
+        break;
+    case 10:
+        ASTCSetEndpoint(e0, (v[0] * v[3]) >> 8, (v[1] * v[3]) >> 8, (v[2] * v[3]) >> 8, v[4]);
+        ASTCSetEndpoint(e1, v[0], v[1], v[2], v[5]);
+        break;
+    default:
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+static void
+ASTCFillBlock(Uint32 color, Uint8 *dst, int dst_pitch, int block_w, int block_h)
+{
+    int x, y;
+
+    for (y = 0; y < block_h; ++y) {
+        Uint32 *row = (Uint32 *) (dst + y * dst_pitch);
+        for (x = 0; x < block_w; ++x) {
+            row[x] = color;
+        }
+    }
+}
+
+static void
+DecodeBlockASTC(const Uint8 *block, Uint8 *dst, int dst_pitch, int block_w, int block_h)
+{
+    const Uint32 error_color = ARGB(255, 255, 0, 255);
+    ASTCBlockInfo info;
+    Uint8 data[16], reversed[16];
+    Uint8 colors[18];
+    Uint8 weights[64 + 16];
+    int endpoints[4][2][4];
+    const int Ds = (1024 + block_w / 2) / (block_w - 1);
+    const int Dt = (1024 + block_h / 2) / (block_h - 1);
+    const SDL_bool small_block = (block_w * block_h < 31) ? SDL_TRUE : SDL_FALSE;
+    int x, y, i, c, weight_count;
+
+    if ((block[0] | ((block[1] & 0x01) << 8)) == 0x1FC) {
+        /* A void extent block has a single 16 bit color for every pixel */
+        BitReader reader;
+        int s_min, s_max, t_min, t_max;
+
+        InitBitReader(&reader, block, 12);
+        s_min = ReadBits(&reader, 13);
+        s_max = ReadBits(&reader, 13);
+        t_min = ReadBits(&reader, 13);
+        t_max = ReadBits(&reader, 13);
+        if ((block[1] & 0x02) ||
+            ((s_min & s_max & t_min & t_max) != 0x1FFF && (s_min >= s_max || t_min >= t_max))) {
+            ASTCFillBlock(error_color, dst, dst_pitch, block_w, block_h);
+        } else {
+            ASTCFillBlock(ARGB(block[15], block[9], block[11], block[13]), dst, dst_pitch, block_w, block_h);
+        }
+        return;
+    }
+    if (!ASTCDecodeBlockInfo(block, &info, block_w, block_h)) {
+        ASTCFillBlock(error_color, dst, dst_pitch, block_w, block_h);
+        return;
+    }
+
+    /* Color endpoints */
+    ASTCExtractBits(block, info.color_start, ASTCSequenceBits(info.color_count, info.color_quant), data);
+    ASTCDecodeSequence(data, info.color_count, info.color_quant, colors);
+    ASTCUnquantizeColors(colors, info.color_count, info.color_quant);
+    for (i = 0, c = 0; i < info.partitions; ++i) {
+        if (!ASTCDecodeEndpoints(info.cem[i], &colors[c], endpoints[i][0], endpoints[i][1])) {
+            ASTCFillBlock(error_color, dst, dst_pitch, block_w, block_h);
+            return;
+        }
+        c += ((info.cem[i] >> 2) + 1) * 2;
+    }
+
+    /* Weights are stored in reverse bit order from the end of the block */
+    for (i = 0; i < 16; ++i) {
+        Uint8 value = block[15 - i];
+        value = (Uint8) (((value & 0xF0) >> 4) | ((value & 0x0F) << 4));
+        value = (Uint8) (((value & 0xCC) >> 2) | ((value & 0x33) << 2));
+        value = (Uint8) (((value & 0xAA) >> 1) | ((value & 0x55) << 1));
+        reversed[i] = value;
+    }
+    weight_count = info.grid_w * info.grid_h * (info.dual_plane ? 2 : 1);
+    ASTCExtractBits(reversed, 0, ASTCSequenceBits(weight_count, info.weight_quant), data);
+    SDL_zero(weights);
+    ASTCDecodeSequence(data, weight_count, info.weight_quant, weights);
+    ASTCUnquantizeWeights(weights, weight_count, info.weight_quant);
+
+    for (y = 0; y < block_h; ++y) {
+        Uint32 *row = (Uint32 *) (dst + y * dst_pitch);
+        const int gt = ((Dt * y) * (info.grid_h - 1) + 32) >> 6;
+        const int jt = gt >> 4;
+        const int ft = gt & 0xF;
+
+        for (x = 0; x < block_w; ++x) {
+            const int gs = ((Ds * x) * (info.grid_w - 1) + 32) >> 6;
+            const int js = gs >> 4;
+            const int fs = gs & 0xF;
+            const int w11 = (fs * ft + 8) >> 4;
+            const int w10 = ft - w11;
+            const int w01 = fs - w11;
+            const int w00 = 16 - fs - ft + w11;
+            const int v0 = js + jt * info.grid_w;
+            const int partition = (info.partitions > 1) ? ASTCSelectPartition(info.partition_index, x, y, info.partitions, small_block) : 0;
+            int plane_weights[2], rgba[4], plane;
+
+            for (plane = 0; plane < (info.dual_plane ? 2 : 1); ++plane) {
+                const int stride = info.dual_plane ? 2 : 1;
+                const Uint8 *p = &weights[v0 * stride + plane];
+                const int p00 = p[0];
+                const int p01 = (w01 || w11) ? p[stride] : 0;
+                const int p10 = (w10 || w11) ? p[info.grid_w * stride] : 0;
+                const int p11 = w11 ? p[(info.grid_w + 1) * stride] : 0;
+                plane_weights[plane] = (p00 * w00 + p01 * w01 + p10 * w10 + p11 * w11 + 8) >> 4;
+            }
+            for (c = 0; c < 4; ++c) {
+                const int w = (info.dual_plane && c == info.ccs) ? plane_weights[1] : plane_weights[0];
+                const int c0 = endpoints[partition][0][c] * 257;
+                const int c1 = endpoints[partition][1][c] * 257;
+                rgba[c] = ((c0 * (64 - w) + c1 * w + 32) >> 6) >> 8;
+            }
+            row[x] = ARGB(rgba[3], rgba[0], rgba[1], rgba[2]);
+        }
+    }
+}
+
+static void
+DecodeBlockASTC4x4(const Uint8 *block, Uint8 *dst, int dst_pitch)
+{
+    DecodeBlockASTC(block, dst, dst_pitch, 4, 4);
+}
+
+static void
+DecodeBlockASTC5x5(const Uint8 *block, Uint8 *dst, int dst_pitch)
+{
+    DecodeBlockASTC(block, dst, dst_pitch, 5, 5);
+}
+
+static void
+DecodeBlockASTC6x6(const Uint8 *block, Uint8 *dst, int dst_pitch)
+{
+    DecodeBlockASTC(block, dst, dst_pitch, 6, 6);
+}
+
+static void
+DecodeBlockASTC8x8(const Uint8 *block, Uint8 *dst, int dst_pitch)
+{
+    DecodeBlockASTC(block, dst, dst_pitch, 8, 8);
+}
+
+
+typedef struct
+{
+    Uint32 format;
+    Uint8 block_w;
+    Uint8 block_h;
+    Uint8 block_bytes;
+    SDL_DecodeBlockFunc decode;
+} SDL_CompressedFormatInfo;
+
+static const SDL_CompressedFormatInfo SDL_compressed_formats[] = {
+    { SDL_PIXELFORMAT_BC1, 4, 4, 8, DecodeBlockBC1 },
+    { SDL_PIXELFORMAT_BC2, 4, 4, 16, DecodeBlockBC2 },
+    { SDL_PIXELFORMAT_BC3, 4, 4, 16, DecodeBlockBC3 },
+    { SDL_PIXELFORMAT_BC4, 4, 4, 8, DecodeBlockBC4 },
+    { SDL_PIXELFORMAT_BC5, 4, 4, 16, DecodeBlockBC5 },
+    { SDL_PIXELFORMAT_BC7, 4, 4, 16, DecodeBlockBC7 },
+    { SDL_PIXELFORMAT_ETC2_RGB8, 4, 4, 8, DecodeBlockETC2RGB8 },
+    { SDL_PIXELFORMAT_ETC2_RGB8A1, 4, 4, 8, DecodeBlockETC2RGB8A1 },
+    { SDL_PIXELFORMAT_ETC2_RGBA8, 4, 4, 16, DecodeBlockETC2RGBA8 },
+    { SDL_PIXELFORMAT_ASTC_4x4, 4, 4, 16, DecodeBlockASTC4x4 },
+    { SDL_PIXELFORMAT_ASTC_5x5, 5, 5, 16, DecodeBlockASTC5x5 },
+    { SDL_PIXELFORMAT_ASTC_6x6, 6, 6, 16, DecodeBlockASTC6x6 },
+    { SDL_PIXELFORMAT_ASTC_8x8, 8, 8, 16, DecodeBlockASTC8x8 },
+};
+
+static const SDL_CompressedFormatInfo *
+GetCompressedFormatInfo(Uint32 format)
+{
+    int i;
+
+    for (i = 0; i < SDL_arraysize(SDL_compressed_formats); ++i) {
+        if (SDL_compressed_formats[i].format == format) {
+            return &SDL_compressed_formats[i];
+        }
+    }
+    return NULL;
+}
+
+SDL_bool
+SDL_GetCompressedBlockSize(Uint32 format, int *block_w, int *block_h, int *block_bytes)
+{
+    const SDL_CompressedFormatInfo *info = GetCompressedFormatInfo(format);
+
+    if (!info) {
+        return SDL_FALSE;
+    }
+    if (block_w) {
+        *block_w = info->block_w;
+    }
+    if (block_h) {
+        *block_h = info->block_h;
+    }
+    if (block_bytes) {
+        *block_bytes = info->block_bytes;
+    }
+    return SDL_TRUE;
+}
+
+int
+SDL_GetCompressedPitch(Uint32 format, int width)
+{
+    const SDL_CompressedFormatInfo *info = GetCompressedFormatInfo(format);
+
+    if (!info) {
+        return 0;
+    }
+    return ((width + info->block_w - 1) / info->block_w) * info->block_bytes;
+}
+
+int
+SDL_GetCompressedRowCount(Uint32 format, int height)
+{
+    const SDL_CompressedFormatInfo *info = GetCompressedFormatInfo(format);
+
+    if (!info) {
+        return 0;
+    }
+    return (height + info->block_h - 1) / info->block_h;
+}
+
+static int
+SDL_ConvertPixels_Compressed_to_ARGB8888(int width, int height, const SDL_CompressedFormatInfo *info,
+                                         const Uint8 *src, int src_pitch, Uint8 *dst, int dst_pitch)
+{
+    Uint32 partial[MAX_BLOCK_SIZE * MAX_BLOCK_SIZE];
+    const int partial_pitch = info->block_w * sizeof(Uint32);
+    int x, y, row;
+
+    for (y = 0; y < height; y += info->block_h) {
+        const Uint8 *block = src;
+        const int rows = SDL_min(info->block_h, height - y);
+        Uint8 *out = dst;
+
+        for (x = 0; x < width; x += info->block_w) {
+            const int columns = SDL_min(info->block_w, width - x);
+            if (columns == info->block_w && rows == info->block_h) {
+                info->decode(block, out, dst_pitch);
+            } else {
+                /* Decode blocks hanging over the edge of the image on the side */
+                info->decode(block, (Uint8 *) partial, partial_pitch);
+                for (row = 0; row < rows; ++row) {
+                    SDL_memcpy(out + row * dst_pitch, &partial[row * info->block_w], columns * sizeof(Uint32));
+                }
+            }
+            block += info->block_bytes;
+            out += info->block_w * sizeof(Uint32);
+        }
+        src += src_pitch;
+        dst += info->block_h * dst_pitch;
+    }
+    return 0;
+}
+
+int
+SDL_ConvertPixels_Compressed_to_RGB(int width, int height, Uint32 src_format, const void *src, int src_pitch,
+                                    Uint32 dst_format, void *dst, int dst_pitch)
+{
+    const SDL_CompressedFormatInfo *info = GetCompressedFormatInfo(src_format);
+    void *tmp;
+    int tmp_pitch;
+    int retval;
+
+    if (!info) {
+        return SDL_SetError("Unsupported compressed format");
+    }
+    if (SDL_ISPIXELFORMAT_FOURCC(dst_format)) {
+        return SDL_SetError("Compressed pixels can only be converted to RGB formats");
+    }
+
+    if (dst_format == SDL_PIXELFORMAT_ARGB8888) {
+        return SDL_ConvertPixels_Compressed_to_ARGB8888(width, height, info, (const Uint8 *) src, src_pitch, (Uint8 *) dst, dst_pitch);
+    }
+
+    /* Decode to ARGB8888 first, then convert to the destination format */
+    tmp_pitch = width * sizeof(Uint32);
+    tmp = SDL_malloc((size_t) tmp_pitch * height);
+    if (!tmp) {
+        return SDL_OutOfMemory();
+    }
+    retval = SDL_ConvertPixels_Compressed_to_ARGB8888(width, height, info, (const Uint8 *) src, src_pitch, (Uint8 *) tmp, tmp_pitch);
+    if (retval == 0) {
+        retval = SDL_ConvertPixels(width, height, SDL_PIXELFORMAT_ARGB8888, tmp, tmp_pitch, dst_format, dst, dst_pitch);
+    }
+    SDL_free(tmp);
+    return retval;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
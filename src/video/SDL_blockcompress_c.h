@@ -0,0 +1,43 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef SDL_blockcompress_c_h_
+#define SDL_blockcompress_c_h_
+
+#include "../SDL_internal.h"
+
+
+/* Block compressed pixel formats */
+
+/* Get the size of the pixel blocks and of one encoded block, returns SDL_FALSE if the format isn't compressed */
+extern SDL_bool SDL_GetCompressedBlockSize(Uint32 format, int *block_w, int *block_h, int *block_bytes);
+
+/* Get the pitch of a tightly packed row of blocks for an image 'width' pixels wide */
+extern int SDL_GetCompressedPitch(Uint32 format, int width);
+
+/* Get the number of rows of blocks for an image 'height' pixels high */
+extern int SDL_GetCompressedRowCount(Uint32 format, int height);
+
+extern int SDL_ConvertPixels_Compressed_to_RGB(int width, int height, Uint32 src_format, const void *src, int src_pitch, Uint32 dst_format, void *dst, int dst_pitch);
+
+#endif /* SDL_blockcompress_c_h_ */
+
+/* vi: set ts=4 sw=4 expandtab: */
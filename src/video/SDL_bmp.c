@@ -37,6 +37,7 @@
 #include "SDL_assert.h"
 #include "SDL_endian.h"
 #include "SDL_pixels_c.h"
+#include "SDL_blit.h"
 
 #define SAVE_32BIT_BMP
 
@@ -83,6 +84,194 @@ static void CorrectAlphaChannel(SDL_Surface *surface)
     }
 }
 
+/* Copy a row of 32-bit pixels, setting the bits in 'alpha' on each one, and
+   return the alpha bits that were set in any of the source pixels */
+typedef Uint32 (*BMPCopyRow32Func)(Uint32 *dst, const Uint8 *src, int n, Uint32 alpha);
+
+static Uint32
+CopyRow32(Uint32 *dst, const Uint8 *src, int n, Uint32 alpha)
+{
+    Uint32 found = 0;
+
+    while (n--) {
+        Uint32 pixel;
+        SDL_memcpy(&pixel, src, sizeof(pixel));
+        found |= pixel;
+        *dst++ = pixel | alpha;
+        src += 4;
+    }
+    return found & 0xFF000000;
+}
+
+#if HAVE_SSE2_INTRINSICS
+static Uint32
+CopyRow32SSE2(Uint32 *dst, const Uint8 *src, int n, Uint32 alpha)
+{
+    const __m128i mm_alpha = _mm_set1_epi32((int) alpha);
+    __m128i found = _mm_setzero_si128();
+
+    for (; n >= 4; n -= 4, src += 16, dst += 4) {
+        const __m128i s = _mm_loadu_si128((const __m128i *) src);
+        found = _mm_or_si128(found, s);
+        _mm_storeu_si128((__m128i *) dst, _mm_or_si128(s, mm_alpha));
+    }
+    found = _mm_or_si128(found, _mm_srli_si128(found, 8));
+    found = _mm_or_si128(found, _mm_srli_si128(found, 4));
+    return ((Uint32) _mm_cvtsi128_si32(found) & 0xFF000000) | CopyRow32(dst, src, n, alpha);
+}
+#endif /* HAVE_SSE2_INTRINSICS */
+
+#if HAVE_AVX2_INTRINSICS
+SDL_TARGETING("avx2") static Uint32
+CopyRow32AVX2(Uint32 *dst, const Uint8 *src, int n, Uint32 alpha)
+{
+    const __m256i mm_alpha = _mm256_set1_epi32((int) alpha);
+    __m256i found = _mm256_setzero_si256();
+    __m128i found128;
+
+    for (; n >= 8; n -= 8, src += 32, dst += 8) {
+        const __m256i s = _mm256_loadu_si256((const __m256i *) src);
+        found = _mm256_or_si256(found, s);
+        _mm256_storeu_si256((__m256i *) dst, _mm256_or_si256(s, mm_alpha));
+    }
+    found128 = _mm_or_si128(_mm256_castsi256_si128(found), _mm256_extracti128_si256(found, 1));
+    found128 = _mm_or_si128(found128, _mm_srli_si128(found128, 8));
+    found128 = _mm_or_si128(found128, _mm_srli_si128(found128, 4));
+    return ((Uint32) _mm_cvtsi128_si32(found128) & 0xFF000000) | CopyRow32(dst, src, n, alpha);
+}
+#endif /* HAVE_AVX2_INTRINSICS */
+
+#if HAVE_NEON_INTRINSICS
+static Uint32
+CopyRow32NEON(Uint32 *dst, const Uint8 *src, int n, Uint32 alpha)
+{
+    const uint32x4_t mm_alpha = vdupq_n_u32(alpha);
+    uint32x4_t found = vdupq_n_u32(0);
+    uint32x2_t found64;
+
+    for (; n >= 4; n -= 4, src += 16, dst += 4) {
+        const uint32x4_t s = vreinterpretq_u32_u8(vld1q_u8(src));
+        found = vorrq_u32(found, s);
+        vst1q_u32(dst, vorrq_u32(s, mm_alpha));
+    }
+    found64 = vorr_u32(vget_low_u32(found), vget_high_u32(found));
+    return ((vget_lane_u32(found64, 0) | vget_lane_u32(found64, 1)) & 0xFF000000) | CopyRow32(dst, src, n, alpha);
+}
+#endif /* HAVE_NEON_INTRINSICS */
+
+static BMPCopyRow32Func
+ChooseCopyRow32(void)
+{
+#if HAVE_AVX2_INTRINSICS
+    if (SDL_HasAVX2()) {
+        return CopyRow32AVX2;
+    }
+#endif
+#if HAVE_SSE2_INTRINSICS
+    if (SDL_HasSSE2()) {
+        return CopyRow32SSE2;
+    }
+#endif
+#if HAVE_NEON_INTRINSICS
+    if (SDL_HasNEON()) {
+        return CopyRow32NEON;
+    }
+#endif
+    return CopyRow32;
+}
+
+/* Read blocks of this many bytes when the pixels can't be used in place */
+#define BMP_READ_BLOCK_SIZE (256 * 1024)
+
+/* Load uncompressed pixels without any per-row reads or a second pass over
+   the surface: memory sources are decoded in place and anything else is read
+   in large blocks, and each row is stored straight at its final position.
+   For 32-bit images without an alpha mask, pixels are made opaque as they
+   are copied and only put back if some alpha turns up later, which gives the
+   same result as CorrectAlphaChannel(). */
+static int
+LoadBMPPixels(SDL_RWops * src, SDL_Surface * surface, SDL_bool topDown,
+              SDL_bool correctAlpha, Uint32 biClrUsed)
+{
+    const int pitch = surface->pitch;
+    const int h = surface->h;
+    const SDL_bool checkPalette = (surface->format->palette && biClrUsed < 256);
+    BMPCopyRow32Func copyRow32 = NULL;
+    Uint32 alpha = 0;
+    Uint8 *block = NULL;
+    const Uint8 *rows;
+    int blockRows, row = 0;
+
+    if (correctAlpha) {
+        SDL_assert(surface->format->BytesPerPixel == 4);
+        copyRow32 = ChooseCopyRow32();
+        alpha = 0xFF000000;
+    }
+
+    if (src->type == SDL_RWOPS_MEMORY || src->type == SDL_RWOPS_MEMORY_RO) {
+        if ((src->hidden.mem.stop - src->hidden.mem.here) / pitch < h) {
+            return SDL_Error(SDL_EFREAD);
+        }
+        rows = src->hidden.mem.here;
+        blockRows = h;
+        SDL_RWseek(src, (Sint64) h * pitch, RW_SEEK_CUR);
+    } else {
+        blockRows = SDL_min(SDL_max(BMP_READ_BLOCK_SIZE / pitch, 1), h);
+        block = (Uint8 *) SDL_malloc(blockRows * pitch);
+        if (!block) {
+            return SDL_OutOfMemory();
+        }
+        rows = block;
+    }
+
+    while (row < h) {
+        const int n = SDL_min(blockRows, h - row);
+        int i;
+
+        if (block && SDL_RWread(src, block, pitch, n) != (size_t) n) {
+            SDL_free(block);
+            return SDL_Error(SDL_EFREAD);
+        }
+
+        for (i = 0; i < n; ++i, ++row) {
+            const Uint8 *srcrow = rows + i * pitch;
+            Uint8 *dstrow = (Uint8 *) surface->pixels + (topDown ? row : h - 1 - row) * pitch;
+
+            if (!copyRow32) {
+                SDL_memcpy(dstrow, srcrow, pitch);
+            } else if (copyRow32((Uint32 *) dstrow, srcrow, surface->w, alpha) && alpha) {
+                /* The image has alpha after all, undo the earlier rows */
+                int prev, x;
+                alpha = 0;
+                copyRow32((Uint32 *) dstrow, srcrow, surface->w, 0);
+                for (prev = 0; prev < row; ++prev) {
+                    Uint32 *pixels = (Uint32 *) ((Uint8 *) surface->pixels + (topDown ? prev : h - 1 - prev) * pitch);
+                    for (x = 0; x < surface->w; ++x) {
+                        pixels[x] &= ~0xFF000000;
+                    }
+                }
+            }
+
+            if (checkPalette) {
+                int x;
+                for (x = 0; x < surface->w; ++x) {
+                    if (dstrow[x] >= biClrUsed) {
+                        SDL_free(block);
+                        return SDL_SetError("A BMP image contains a pixel with a color out of the palette");
+                    }
+                }
+            }
+        }
+
+        if (!block) {
+            rows += n * pitch;
+        }
+    }
+
+    SDL_free(block);
+    return 0;
+}
+
 SDL_Surface *
 SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
 {
@@ -372,6 +561,13 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
         was_error = SDL_TRUE;
         goto done;
     }
+    if (!ExpandBMP &&
+        (SDL_BYTEORDER == SDL_LIL_ENDIAN || biBitCount == 8 || biBitCount == 24)) {
+        if (LoadBMPPixels(src, surface, topDown, correctAlpha, biClrUsed) < 0) {
+            was_error = SDL_TRUE;
+        }
+        goto done;
+    }
     top = (Uint8 *)surface->pixels;
     end = (Uint8 *)surface->pixels+(surface->h*surface->pitch);
     switch (ExpandBMP) {
@@ -22,8 +22,24 @@
 
 #include "SDL_video.h"
 #include "SDL_blit.h"
+#include "../cpuinfo/SDL_cpuinfo_c.h"
+#include "../thread/SDL_workers_c.h"
 
 
+/* Fills bigger than this are split into row bands across the worker threads */
+#define FILL_PARALLEL_BYTES (2 * 1024 * 1024)
+
+/* Don't bother splitting into bands smaller than this */
+#define FILL_MIN_BAND_ROWS  16
+
+typedef void (*SDL_FillRectFunc)(Uint8 *pixels, int pitch, Uint32 color, int w, int h);
+
+/* The SIMD fills come in two flavors, one using regular stores and one using
+   non-temporal (streaming) stores. Streaming stores bypass the cache, which is
+   what we want when the fill is bigger than the cache anyway, but a waste if
+   the pixels are going to be read back soon.
+ */
+
 #ifdef __SSE__
 /* *INDENT-OFF* */
 
@@ -45,20 +61,21 @@
     c128 = *(__m128 *)cccc;
 #endif
 
-#define SSE_WORK \
+#define SSE_WORK(store) \
     for (i = n / 64; i--;) { \
-        _mm_stream_ps((float *)(p+0), c128); \
-        _mm_stream_ps((float *)(p+16), c128); \
-        _mm_stream_ps((float *)(p+32), c128); \
-        _mm_stream_ps((float *)(p+48), c128); \
+        store((float *)(p+0), c128); \
+        store((float *)(p+16), c128); \
+        store((float *)(p+32), c128); \
+        store((float *)(p+48), c128); \
         p += 64; \
     }
 
 #define SSE_END
+#define SSE_STREAM_END  _mm_sfence()
 
-#define DEFINE_SSE_FILLRECT(bpp, type) \
+#define DEFINE_SSE_FILLRECT(bpp, type, suffix, store, end) \
 static void \
-SDL_FillRect##bpp##SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
+SDL_FillRect##bpp##suffix(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
 { \
     int i, n; \
     Uint8 *p = NULL; \
@@ -79,7 +96,7 @@ SDL_FillRect##bpp##SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
                     p += bpp; \
                 } \
             } \
-            SSE_WORK; \
+            SSE_WORK(store); \
         } \
         if (n & 63) { \
             int remainder = (n & 63); \
@@ -92,43 +109,164 @@ SDL_FillRect##bpp##SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
         pixels += pitch; \
     } \
  \
-    SSE_END; \
+    end; \
 }
 
-static void
-SDL_FillRect1SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h)
-{
-    int i, n;
+#define DEFINE_SSE_FILLRECT1(suffix, store, end) \
+static void \
+SDL_FillRect1##suffix(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
+{ \
+    int i, n; \
+ \
+    SSE_BEGIN; \
+    while (h--) { \
+        Uint8 *p = pixels; \
+        n = w; \
+ \
+        if (n > 63) { \
+            int adjust = 16 - ((uintptr_t)p & 15); \
+            if (adjust < 16) { \
+                n -= adjust; \
+                SDL_memset(p, color, adjust); \
+                p += adjust; \
+            } \
+            SSE_WORK(store); \
+        } \
+        if (n & 63) { \
+            int remainder = (n & 63); \
+            SDL_memset(p, color, remainder); \
+        } \
+        pixels += pitch; \
+    } \
+ \
+    end; \
+}
 
-    SSE_BEGIN;
-    while (h--) {
-        Uint8 *p = pixels;
-        n = w;
+DEFINE_SSE_FILLRECT1(SSE, _mm_store_ps, SSE_END)
+DEFINE_SSE_FILLRECT1(SSEStream, _mm_stream_ps, SSE_STREAM_END)
+DEFINE_SSE_FILLRECT(2, Uint16, SSE, _mm_store_ps, SSE_END)
+DEFINE_SSE_FILLRECT(2, Uint16, SSEStream, _mm_stream_ps, SSE_STREAM_END)
+DEFINE_SSE_FILLRECT(4, Uint32, SSE, _mm_store_ps, SSE_END)
+DEFINE_SSE_FILLRECT(4, Uint32, SSEStream, _mm_stream_ps, SSE_STREAM_END)
 
-        if (n > 63) {
-            int adjust = 16 - ((uintptr_t)p & 15);
-            if (adjust) {
-                n -= adjust;
-                SDL_memset(p, color, adjust);
-                p += adjust;
-            }
-            SSE_WORK;
-        }
-        if (n & 63) {
-            int remainder = (n & 63);
-            SDL_memset(p, color, remainder);
-        }
-        pixels += pitch;
+/* *INDENT-ON* */
+#endif /* __SSE__ */
+
+#if HAVE_AVX2_INTRINSICS
+/* *INDENT-OFF* */
+
+#define AVX2_WORK(store) \
+    for (i = n / 128; i--;) { \
+        store((__m256i *)(p+0), c256); \
+        store((__m256i *)(p+32), c256); \
+        store((__m256i *)(p+64), c256); \
+        store((__m256i *)(p+96), c256); \
+        p += 128; \
     }
 
-    SSE_END;
+#define AVX2_END
+#define AVX2_STREAM_END _mm_sfence()
+
+#define DEFINE_AVX2_FILLRECT(bpp, type, suffix, store, end) \
+SDL_TARGETING("avx2") static void \
+SDL_FillRect##bpp##suffix(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
+{ \
+    const __m256i c256 = _mm256_set1_epi32((int)color); \
+    int i, n; \
+    Uint8 *p = NULL; \
+ \
+    while (h--) { \
+        n = w * bpp; \
+        p = pixels; \
+ \
+        if (n > 127) { \
+            int adjust = 32 - ((uintptr_t)p & 31); \
+            if (adjust < 32) { \
+                n -= adjust; \
+                adjust /= bpp; \
+                while (adjust--) { \
+                    *((type *)p) = (type)color; \
+                    p += bpp; \
+                } \
+            } \
+            AVX2_WORK(store); \
+        } \
+        if (n & 127) { \
+            int remainder = (n & 127); \
+            remainder /= bpp; \
+            while (remainder--) { \
+                *((type *)p) = (type)color; \
+                p += bpp; \
+            } \
+        } \
+        pixels += pitch; \
+    } \
+ \
+    end; \
 }
-/* DEFINE_SSE_FILLRECT(1, Uint8) */
-DEFINE_SSE_FILLRECT(2, Uint16)
-DEFINE_SSE_FILLRECT(4, Uint32)
+
+DEFINE_AVX2_FILLRECT(1, Uint8, AVX2, _mm256_store_si256, AVX2_END)
+DEFINE_AVX2_FILLRECT(1, Uint8, AVX2Stream, _mm256_stream_si256, AVX2_STREAM_END)
+DEFINE_AVX2_FILLRECT(2, Uint16, AVX2, _mm256_store_si256, AVX2_END)
+DEFINE_AVX2_FILLRECT(2, Uint16, AVX2Stream, _mm256_stream_si256, AVX2_STREAM_END)
+DEFINE_AVX2_FILLRECT(4, Uint32, AVX2, _mm256_store_si256, AVX2_END)
+DEFINE_AVX2_FILLRECT(4, Uint32, AVX2Stream, _mm256_stream_si256, AVX2_STREAM_END)
 
 /* *INDENT-ON* */
-#endif /* __SSE__ */
+#endif /* HAVE_AVX2_INTRINSICS */
+
+#if HAVE_NEON_INTRINSICS
+/* *INDENT-OFF* */
+
+/* NEON has no non-temporal store intrinsics, so there's only one flavor */
+#define DEFINE_NEON_FILLRECT(bpp, type) \
+static void \
+SDL_FillRect##bpp##NEON(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
+{ \
+    const uint8x16_t c128 = vreinterpretq_u8_u32(vdupq_n_u32(color)); \
+    int i, n; \
+    Uint8 *p = NULL; \
+ \
+    while (h--) { \
+        n = w * bpp; \
+        p = pixels; \
+ \
+        if (n > 63) { \
+            int adjust = 16 - ((uintptr_t)p & 15); \
+            if (adjust < 16) { \
+                n -= adjust; \
+                adjust /= bpp; \
+                while (adjust--) { \
+                    *((type *)p) = (type)color; \
+                    p += bpp; \
+                } \
+            } \
+            for (i = n / 64; i--;) { \
+                vst1q_u8(p+0, c128); \
+                vst1q_u8(p+16, c128); \
+                vst1q_u8(p+32, c128); \
+                vst1q_u8(p+48, c128); \
+                p += 64; \
+            } \
+        } \
+        if (n & 63) { \
+            int remainder = (n & 63); \
+            remainder /= bpp; \
+            while (remainder--) { \
+                *((type *)p) = (type)color; \
+                p += bpp; \
+            } \
+        } \
+        pixels += pitch; \
+    } \
+}
+
+DEFINE_NEON_FILLRECT(1, Uint8)
+DEFINE_NEON_FILLRECT(2, Uint16)
+DEFINE_NEON_FILLRECT(4, Uint32)
+
+/* *INDENT-ON* */
+#endif /* HAVE_NEON_INTRINSICS */
 
 static void
 SDL_FillRect1(Uint8 * pixels, int pitch, Uint32 color, int w, int h)
@@ -230,14 +368,120 @@ SDL_FillRect4(Uint8 * pixels, int pitch, Uint32 color, int w, int h)
     }
 }
 
+static SDL_FillRectFunc
+SDL_ChooseFillRectFunc(int bpp, SDL_bool stream)
+{
+    switch (bpp) {
+    case 1:
+#if HAVE_AVX2_INTRINSICS
+        if (SDL_HasAVX2()) {
+            return stream ? SDL_FillRect1AVX2Stream : SDL_FillRect1AVX2;
+        }
+#endif
+#ifdef __SSE__
+        if (SDL_HasSSE()) {
+            return stream ? SDL_FillRect1SSEStream : SDL_FillRect1SSE;
+        }
+#endif
+#if HAVE_NEON_INTRINSICS
+        if (SDL_HasNEON()) {
+            return SDL_FillRect1NEON;
+        }
+#endif
+        return SDL_FillRect1;
+
+    case 2:
+#if HAVE_AVX2_INTRINSICS
+        if (SDL_HasAVX2()) {
+            return stream ? SDL_FillRect2AVX2Stream : SDL_FillRect2AVX2;
+        }
+#endif
+#ifdef __SSE__
+        if (SDL_HasSSE()) {
+            return stream ? SDL_FillRect2SSEStream : SDL_FillRect2SSE;
+        }
+#endif
+#if HAVE_NEON_INTRINSICS
+        if (SDL_HasNEON()) {
+            return SDL_FillRect2NEON;
+        }
+#endif
+        return SDL_FillRect2;
+
+    case 3:
+        /* 24-bit RGB is a slow path, at least for now. */
+        return SDL_FillRect3;
+
+    case 4:
+#if HAVE_AVX2_INTRINSICS
+        if (SDL_HasAVX2()) {
+            return stream ? SDL_FillRect4AVX2Stream : SDL_FillRect4AVX2;
+        }
+#endif
+#ifdef __SSE__
+        if (SDL_HasSSE()) {
+            return stream ? SDL_FillRect4SSEStream : SDL_FillRect4SSE;
+        }
+#endif
+#if HAVE_NEON_INTRINSICS
+        if (SDL_HasNEON()) {
+            return SDL_FillRect4NEON;
+        }
+#endif
+        return SDL_FillRect4;
+    }
+    return NULL;
+}
+
+typedef struct
+{
+    SDL_Surface *dst;
+    const SDL_Rect *rects;
+    int count;
+    Uint32 color;
+    SDL_FillRectFunc func;
+    int top;
+    int height;
+    int bands;
+} SDL_FillRectsJob;
+
+/* Fill the part of every rectangle that falls in one band of rows.
+   Bands never share rows, so they can be filled at the same time. */
+static void
+SDL_FillRectsBand(void *data, int index)
+{
+    const SDL_FillRectsJob *job = (const SDL_FillRectsJob *) data;
+    SDL_Surface *dst = job->dst;
+    const int bpp = dst->format->BytesPerPixel;
+    SDL_Rect band, clipped;
+    int i;
+
+    band.x = dst->clip_rect.x;
+    band.w = dst->clip_rect.w;
+    band.y = job->top + (job->height * index) / job->bands;
+    band.h = job->top + (job->height * (index + 1)) / job->bands - band.y;
+
+    for (i = 0; i < job->count; ++i) {
+        if (SDL_IntersectRect(&job->rects[i], &band, &clipped)) {
+            Uint8 *pixels = (Uint8 *) dst->pixels + clipped.y * dst->pitch +
+                                                    clipped.x * bpp;
+            job->func(pixels, dst->pitch, job->color, clipped.w, clipped.h);
+        }
+    }
+}
+
 /* 
- * This function performs a fast fill of the given rectangle with 'color'
+ * This function performs a fast fill of the given rectangles with 'color'
  */
 int
-SDL_FillRect(SDL_Surface * dst, const SDL_Rect * rect, Uint32 color)
+SDL_FillRects(SDL_Surface * dst, const SDL_Rect * rects, int count,
+              Uint32 color)
 {
+    SDL_FillRectsJob job;
     SDL_Rect clipped;
-    Uint8 *pixels;
+    size_t size = 0;
+    int top, bottom;
+    int i;
 
     if (!dst) {
         return SDL_SetError("Passed NULL destination surface");
@@ -248,96 +492,72 @@ SDL_FillRect(SDL_Surface * dst, const SDL_Rect * rect, Uint32 color)
         return SDL_SetError("SDL_FillRect(): Unsupported surface format");
     }
 
-    /* If 'rect' == NULL, then fill the whole surface */
-    if (rect) {
-        /* Perform clipping */
-        if (!SDL_IntersectRect(rect, &dst->clip_rect, &clipped)) {
-            return 0;
-        }
-        rect = &clipped;
-    } else {
-        rect = &dst->clip_rect;
-        /* Don't attempt to fill if the surface's clip_rect is empty */
-        if (SDL_RectEmpty(rect)) {
-            return 0;
+    if (!rects) {
+        return SDL_SetError("SDL_FillRects() passed NULL rects");
+    }
+
+    /* Perform clipping, and find out how much there is to fill */
+    top = dst->clip_rect.y + dst->clip_rect.h;
+    bottom = dst->clip_rect.y;
+    for (i = 0; i < count; ++i) {
+        if (SDL_IntersectRect(&rects[i], &dst->clip_rect, &clipped)) {
+            size += (size_t) clipped.w * clipped.h * dst->format->BytesPerPixel;
+            top = SDL_min(top, clipped.y);
+            bottom = SDL_max(bottom, clipped.y + clipped.h);
         }
     }
+    if (size == 0) {
+        return 0;
+    }
 
     /* Perform software fill */
     if (!dst->pixels) {
         return SDL_SetError("SDL_FillRect(): You must lock the surface");
     }
 
-    pixels = (Uint8 *) dst->pixels + rect->y * dst->pitch +
-                                     rect->x * dst->format->BytesPerPixel;
-
     switch (dst->format->BytesPerPixel) {
     case 1:
-        {
-            color |= (color << 8);
-            color |= (color << 16);
-#ifdef __SSE__
-            if (SDL_HasSSE()) {
-                SDL_FillRect1SSE(pixels, dst->pitch, color, rect->w, rect->h);
-                break;
-            }
-#endif
-            SDL_FillRect1(pixels, dst->pitch, color, rect->w, rect->h);
-            break;
-        }
-
+        color |= (color << 8);
+        color |= (color << 16);
+        break;
     case 2:
-        {
-            color |= (color << 16);
-#ifdef __SSE__
-            if (SDL_HasSSE()) {
-                SDL_FillRect2SSE(pixels, dst->pitch, color, rect->w, rect->h);
-                break;
-            }
-#endif
-            SDL_FillRect2(pixels, dst->pitch, color, rect->w, rect->h);
-            break;
-        }
-
-    case 3:
-        /* 24-bit RGB is a slow path, at least for now. */
-        {
-            SDL_FillRect3(pixels, dst->pitch, color, rect->w, rect->h);
-            break;
-        }
+        color |= (color << 16);
+        break;
+    }
 
-    case 4:
-        {
-#ifdef __SSE__
-            if (SDL_HasSSE()) {
-                SDL_FillRect4SSE(pixels, dst->pitch, color, rect->w, rect->h);
-                break;
-            }
-#endif
-            SDL_FillRect4(pixels, dst->pitch, color, rect->w, rect->h);
-            break;
-        }
+    job.dst = dst;
+    job.rects = rects;
+    job.count = count;
+    job.color = color;
+    /* If the fill wouldn't comfortably fit in the cache alongside everything
+       else, don't bother pulling the destination into it. */
+    job.func = SDL_ChooseFillRectFunc(dst->format->BytesPerPixel,
+                                      (size > (size_t) SDL_GetCPUCacheSize() / 4));
+    job.top = top;
+    job.height = bottom - top;
+    job.bands = 1;
+    if (size >= FILL_PARALLEL_BYTES) {
+        job.bands = SDL_min(SDL_GetWorkerCount(), job.height / FILL_MIN_BAND_ROWS);
+        job.bands = SDL_max(job.bands, 1);
     }
+    SDL_RunOnWorkers(SDL_FillRectsBand, &job, job.bands);
 
     /* We're done! */
     return 0;
 }
 
 int
-SDL_FillRects(SDL_Surface * dst, const SDL_Rect * rects, int count,
-              Uint32 color)
+SDL_FillRect(SDL_Surface * dst, const SDL_Rect * rect, Uint32 color)
 {
-    int i;
-    int status = 0;
-
-    if (!rects) {
-        return SDL_SetError("SDL_FillRects() passed NULL rects");
+    if (!dst) {
+        return SDL_SetError("Passed NULL destination surface");
     }
 
-    for (i = 0; i < count; ++i) {
-        status += SDL_FillRect(dst, &rects[i], color);
+    /* If 'rect' == NULL, then fill the whole surface */
+    if (!rect) {
+        rect = &dst->clip_rect;
     }
-    return status;
+    return SDL_FillRects(dst, rect, 1, color);
 }
 
 /* vi: set ts=4 sw=4 expandtab: */
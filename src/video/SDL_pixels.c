@@ -124,6 +124,22 @@ SDL_GetPixelFormatName(Uint32 format)
     CASE(SDL_PIXELFORMAT_YVYU)
     CASE(SDL_PIXELFORMAT_NV12)
     CASE(SDL_PIXELFORMAT_NV21)
+    CASE(SDL_PIXELFORMAT_P010)
+    CASE(SDL_PIXELFORMAT_P016)
+    CASE(SDL_PIXELFORMAT_I010)
+    CASE(SDL_PIXELFORMAT_BC1)
+    CASE(SDL_PIXELFORMAT_BC2)
+    CASE(SDL_PIXELFORMAT_BC3)
+    CASE(SDL_PIXELFORMAT_BC4)
+    CASE(SDL_PIXELFORMAT_BC5)
+    CASE(SDL_PIXELFORMAT_BC7)
+    CASE(SDL_PIXELFORMAT_ETC2_RGB8)
+    CASE(SDL_PIXELFORMAT_ETC2_RGB8A1)
+    CASE(SDL_PIXELFORMAT_ETC2_RGBA8)
+    CASE(SDL_PIXELFORMAT_ASTC_4x4)
+    CASE(SDL_PIXELFORMAT_ASTC_5x5)
+    CASE(SDL_PIXELFORMAT_ASTC_6x6)
+    CASE(SDL_PIXELFORMAT_ASTC_8x8)
 #undef CASE
     default:
         return "SDL_PIXELFORMAT_UNKNOWN";
@@ -968,6 +984,11 @@ SDL_AllocBlitMap(void)
     return (map);
 }
 
+/* Surfaces can be mapped onto the same destination from several threads at
+   once with SDL_PrepareSurfaceRLE(), so the references maps keep to their
+   destination are counted under this lock */
+static SDL_SpinLock map_dst_lock = 0;
+
 void
 SDL_InvalidateMap(SDL_BlitMap * map)
 {
@@ -975,8 +996,13 @@ SDL_InvalidateMap(SDL_BlitMap * map)
         return;
     }
     if (map->dst) {
+        SDL_bool last;
+
         /* Release our reference to the surface - see the note below */
-        if (--map->dst->refcount <= 0) {
+        SDL_AtomicLock(&map_dst_lock);
+        last = (--map->dst->refcount <= 0);
+        SDL_AtomicUnlock(&map_dst_lock);
+        if (last) {
             SDL_FreeSurface(map->dst);
         }
     }
@@ -1054,7 +1080,9 @@ SDL_MapSurface(SDL_Surface * src, SDL_Surface * dst)
            track of surfaces that are mapped to it and automatically
            invalidate them when it is freed, but this will do for now.
         */
+        SDL_AtomicLock(&map_dst_lock);
         ++map->dst->refcount;
+        SDL_AtomicUnlock(&map_dst_lock);
     }
 
     if (dstfmt->palette) {
@@ -528,4 +528,57 @@ SDL_GetSpanEnclosingRect(int width, int height,
     return SDL_FALSE;
 }
 
+/* Past this many rects the pairwise merging costs more than it saves */
+#define SDL_MAX_COALESCE_RECTS  64
+
+int
+SDL_CoalesceRects(int width, int height, SDL_Rect * rects, int numrects)
+{
+    const SDL_Rect bounds = { 0, 0, width, height };
+    SDL_bool merged;
+    int i, j, count = 0;
+
+    if (!rects && numrects > 0) {
+        return SDL_InvalidParamError("rects");
+    }
+    if (numrects < 0) {
+        return SDL_InvalidParamError("numrects");
+    }
+
+    /* Clip to the bounds and drop anything left empty */
+    for (i = 0; i < numrects; ++i) {
+        if (SDL_IntersectRect(&rects[i], &bounds, &rects[count])) {
+            ++count;
+        }
+    }
+
+    if (count > SDL_MAX_COALESCE_RECTS) {
+        return count;
+    }
+
+    /* Merge any two rects whose union doesn't cover more than the two of
+       them do separately: contained, overlapping or abutting rects. */
+    do {
+        merged = SDL_FALSE;
+        for (i = 0; i < count; ++i) {
+            for (j = i + 1; j < count; ) {
+                const SDL_Rect *a = &rects[i];
+                const SDL_Rect *b = &rects[j];
+                SDL_Rect u;
+
+                SDL_UnionRect(a, b, &u);
+                if ((Sint64)u.w * u.h <= (Sint64)a->w * a->h + (Sint64)b->w * b->h) {
+                    rects[i] = u;
+                    rects[j] = rects[--count];
+                    merged = SDL_TRUE;
+                } else {
+                    ++j;
+                }
+            }
+        }
+    } while (merged);
+
+    return count;
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
@@ -20,12 +20,14 @@
 */
 #include "../SDL_internal.h"
 
+#include "SDL_hints.h"
 #include "SDL_video.h"
 #include "SDL_sysvideo.h"
 #include "SDL_blit.h"
 #include "SDL_RLEaccel_c.h"
 #include "SDL_pixels_c.h"
 #include "SDL_yuv_c.h"
+#include "SDL_blockcompress_c.h"
 
 
 /* Check to make sure we can safely check multiplication of surface w and pitch and it won't overflow size_t */
@@ -59,17 +61,205 @@ SDL_CalculatePitch(Uint32 format, int width)
 }
 
 /*
- * Create an empty RGB surface of the appropriate depth using the given
- * enum SDL_PIXELFORMAT_* format
+ * The surface pool keeps the pixels of freed surfaces for reuse. Buffers
+ * are sorted into four size classes per power of two, so a buffer wastes at
+ * most a quarter of its size. Surfaces that fill their own pixels only get
+ * the row padding of a buffer cleared.
  */
-SDL_Surface *
-SDL_CreateRGBSurfaceWithFormat(Uint32 flags, int width, int height, int depth,
-                               Uint32 format)
+#define SURFACE_POOL_MIN_BITS       10  /* Smaller pixels go straight to the allocator */
+#define SURFACE_POOL_MAX_BITS       24
+#define SURFACE_POOL_CLASSES        ((SURFACE_POOL_MAX_BITS - SURFACE_POOL_MIN_BITS) * 4)
+#define SURFACE_POOL_DEPTH          8
+#define SURFACE_POOL_DEFAULT_SIZE   (32 * 1024 * 1024)
+
+typedef struct
 {
-    SDL_Surface *surface;
+    void *buffers[SURFACE_POOL_DEPTH];
+    int count;
+} SDL_SurfacePoolClass;
+
+static SDL_SpinLock surface_pool_lock;
+static SDL_SurfacePoolClass surface_pool[SURFACE_POOL_CLASSES];
+static size_t surface_pool_bytes;
+static size_t surface_pool_limit = SURFACE_POOL_DEFAULT_SIZE;
+static SDL_atomic_t surface_pool_watching;
+static Uint64 surface_pool_hits;
+static Uint64 surface_pool_misses;
+
+/* Find the smallest size class holding 'size' bytes, or -1 if it isn't pooled */
+static int
+SDL_GetSurfacePoolClass(size_t size, size_t *class_size)
+{
+    int bits = SURFACE_POOL_MIN_BITS;
+    size_t step;
+    int k;
 
-    /* The flags are no longer used, make the compiler happy */
-    (void)flags;
+    if (size <= ((size_t)1 << SURFACE_POOL_MIN_BITS) ||
+        size > ((size_t)1 << SURFACE_POOL_MAX_BITS)) {
+        *class_size = size;
+        return -1;
+    }
+    while (((size_t)1 << (bits + 1)) < size) {
+        ++bits;
+    }
+    step = (size_t)1 << (bits - 2);
+    k = (int)((size - ((size_t)1 << bits) + step - 1) / step);
+    *class_size = ((size_t)1 << bits) + k * step;
+    return (bits - SURFACE_POOL_MIN_BITS) * 4 + (k - 1);
+}
+
+static void SDLCALL
+SDL_SurfacePoolSizeChanged(void *userdata, const char *name, const char *oldValue, const char *hint)
+{
+    const size_t limit = (hint && *hint) ? (size_t)SDL_strtoull(hint, NULL, 10) : SURFACE_POOL_DEFAULT_SIZE;
+
+    SDL_AtomicLock(&surface_pool_lock);
+    surface_pool_limit = limit;
+    SDL_AtomicUnlock(&surface_pool_lock);
+}
+
+/*
+ * Allocate h * pitch bytes of pixels for a surface, reusing pooled memory if possible
+ */
+int
+SDL_AllocSurfacePixels(SDL_Surface * surface, SDL_bool clear)
+{
+    const size_t size = (size_t)surface->h * surface->pitch;
+    size_t class_size;
+    const int index = SDL_GetSurfacePoolClass(size, &class_size);
+    void *pixels = NULL;
+
+    if (index >= 0) {
+        SDL_AtomicLock(&surface_pool_lock);
+        if (surface_pool[index].count > 0) {
+            pixels = surface_pool[index].buffers[--surface_pool[index].count];
+            surface_pool_bytes -= class_size;
+            ++surface_pool_hits;
+        } else {
+            ++surface_pool_misses;
+        }
+        SDL_AtomicUnlock(&surface_pool_lock);
+    }
+
+    if (!pixels) {
+        pixels = SDL_SIMDAlloc(class_size);
+        if (!pixels) {
+            return SDL_OutOfMemory();
+        }
+    }
+    surface->pixels = pixels;
+    surface->flags |= SDL_SIMD_ALIGNED;
+    if (index >= 0) {
+        surface->flags |= SDL_POOLED;
+    }
+    if (clear) {
+        SDL_memset(pixels, 0, size);
+    } else {
+        /* The caller fills the pixels, but not the row padding, which may
+           hold whatever a recycled buffer had in it */
+        const size_t length = ((size_t)surface->w * surface->format->BitsPerPixel + 7) / 8;
+        if (length < (size_t)surface->pitch) {
+            Uint8 *row = (Uint8 *)pixels;
+            int y;
+            for (y = 0; y < surface->h; ++y) {
+                SDL_memset(row + length, 0, surface->pitch - length);
+                row += surface->pitch;
+            }
+        }
+    }
+    return 0;
+}
+
+/*
+ * Release the pixels of a surface, keeping them in the pool if there's room
+ */
+void
+SDL_FreeSurfacePixels(SDL_Surface * surface)
+{
+    if (surface->flags & SDL_PREALLOC) {
+        /* Don't free */
+        return;
+    }
+
+    if (surface->flags & SDL_POOLED) {
+        size_t class_size;
+        const int index = SDL_GetSurfacePoolClass((size_t)surface->h * surface->pitch, &class_size);
+        void *pixels = surface->pixels;
+
+        if (index >= 0) {
+            /* Follow the hint rather than looking it up on every free */
+            if (SDL_AtomicCAS(&surface_pool_watching, 0, 1)) {
+                SDL_AddHintCallback(SDL_HINT_SURFACE_POOL_SIZE, SDL_SurfacePoolSizeChanged, NULL);
+            }
+            SDL_AtomicLock(&surface_pool_lock);
+            if (surface_pool[index].count < SURFACE_POOL_DEPTH &&
+                surface_pool_bytes + class_size <= surface_pool_limit) {
+                surface_pool[index].buffers[surface_pool[index].count++] = pixels;
+                surface_pool_bytes += class_size;
+                pixels = NULL;
+            }
+            SDL_AtomicUnlock(&surface_pool_lock);
+        }
+        SDL_SIMDFree(pixels);
+    } else if (surface->flags & SDL_SIMD_ALIGNED) {
+        /* Free aligned */
+        SDL_SIMDFree(surface->pixels);
+    } else {
+        /* Normal */
+        SDL_free(surface->pixels);
+    }
+    surface->pixels = NULL;
+    surface->flags &= ~(SDL_SIMD_ALIGNED | SDL_POOLED);
+}
+
+void
+SDL_TrimSurfacePool(size_t max_bytes)
+{
+    int index;
+
+    SDL_AtomicLock(&surface_pool_lock);
+    for (index = SURFACE_POOL_CLASSES - 1; index >= 0 && surface_pool_bytes > max_bytes; --index) {
+        const int bits = SURFACE_POOL_MIN_BITS + index / 4;
+        const size_t class_size = ((size_t)1 << bits) + (index % 4 + 1) * ((size_t)1 << (bits - 2));
+
+        while (surface_pool[index].count > 0 && surface_pool_bytes > max_bytes) {
+            SDL_SIMDFree(surface_pool[index].buffers[--surface_pool[index].count]);
+            surface_pool_bytes -= class_size;
+        }
+    }
+    SDL_AtomicUnlock(&surface_pool_lock);
+}
+
+void
+SDL_GetSurfacePoolStats(Uint64 *hits, Uint64 *misses, size_t *cached_bytes)
+{
+    SDL_AtomicLock(&surface_pool_lock);
+    if (hits) {
+        *hits = surface_pool_hits;
+    }
+    if (misses) {
+        *misses = surface_pool_misses;
+    }
+    if (cached_bytes) {
+        *cached_bytes = surface_pool_bytes;
+    }
+    SDL_AtomicUnlock(&surface_pool_lock);
+}
+
+void
+SDL_QuitSurfacePool(void)
+{
+    SDL_TrimSurfacePool(0);
+    if (SDL_AtomicCAS(&surface_pool_watching, 1, 0)) {
+        SDL_DelHintCallback(SDL_HINT_SURFACE_POOL_SIZE, SDL_SurfacePoolSizeChanged, NULL);
+    }
+    surface_pool_limit = SURFACE_POOL_DEFAULT_SIZE;
+}
+
+static SDL_Surface *
+SDL_CreateSurface(int width, int height, Uint32 format, SDL_bool clear)
+{
+    SDL_Surface *surface;
 
     /* Allocate the surface */
     surface = (SDL_Surface *) SDL_calloc(1, sizeof(*surface));
@@ -119,15 +309,11 @@ SDL_CreateRGBSurfaceWithFormat(Uint32 flags, int width, int height, int depth,
             return NULL;
         }
 
-        surface->pixels = SDL_SIMDAlloc((size_t)size);
-        if (!surface->pixels) {
+        /* Clearing is important for bitmaps */
+        if (SDL_AllocSurfacePixels(surface, clear) < 0) {
             SDL_FreeSurface(surface);
-            SDL_OutOfMemory();
             return NULL;
         }
-        surface->flags |= SDL_SIMD_ALIGNED;
-        /* This is important for bitmaps */
-        SDL_memset(surface->pixels, 0, surface->h * surface->pitch);
     }
 
     /* Allocate an empty mapping */
@@ -147,6 +333,20 @@ SDL_CreateRGBSurfaceWithFormat(Uint32 flags, int width, int height, int depth,
     return surface;
 }
 
+/*
+ * Create an empty RGB surface of the appropriate depth using the given
+ * enum SDL_PIXELFORMAT_* format
+ */
+SDL_Surface *
+SDL_CreateRGBSurfaceWithFormat(Uint32 flags, int width, int height, int depth,
+                               Uint32 format)
+{
+    /* The flags are no longer used, make the compiler happy */
+    (void)flags;
+
+    return SDL_CreateSurface(width, height, format, SDL_TRUE);
+}
+
 /*
  * Create an empty RGB surface of the appropriate depth
  */
@@ -227,6 +427,20 @@ SDL_SetSurfacePalette(SDL_Surface * surface, SDL_Palette * palette)
     return 0;
 }
 
+/* Returns SDL_TRUE if src is set up for blitting onto dst */
+static SDL_bool
+SDL_IsMappedTo(SDL_Surface * src, SDL_Surface * dst)
+{
+    if ((src->map->dst != dst) ||
+        (dst->format->palette &&
+         src->map->dst_palette_version != dst->format->palette->version) ||
+        (src->format->palette &&
+         src->map->src_palette_version != src->format->palette->version)) {
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
 int
 SDL_SetSurfaceRLE(SDL_Surface * surface, int flag)
 {
@@ -248,6 +462,31 @@ SDL_SetSurfaceRLE(SDL_Surface * surface, int flag)
     return 0;
 }
 
+int
+SDL_PrepareSurfaceRLE(SDL_Surface * surface, SDL_Surface * dst)
+{
+    if (!surface) {
+        return SDL_InvalidParamError("surface");
+    }
+    if (!dst) {
+        return SDL_InvalidParamError("dst");
+    }
+
+    SDL_SetSurfaceRLE(surface, 1);
+
+    /* Mapping the surface onto dst does the encoding, and the first blit
+       onto dst will then find it ready to go */
+    if (!SDL_IsMappedTo(surface, dst)) {
+        if (SDL_MapSurface(surface, dst) < 0) {
+            return -1;
+        }
+    }
+    if (!(surface->flags & SDL_RLEACCEL)) {
+        return SDL_SetError("Surface can't be RLE accelerated for this destination");
+    }
+    return 0;
+}
+
 int
 SDL_SetColorKey(SDL_Surface * surface, int flag, Uint32 key)
 {
@@ -501,17 +740,22 @@ SDL_SetSurfaceBlendMode(SDL_Surface * surface, SDL_BlendMode blendMode)
 
     status = 0;
     flags = surface->map->info.flags;
-    surface->map->info.flags &=
-        ~(SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD);
+    surface->map->info.flags &= ~SDL_COPY_BLEND_MASK;
     switch (blendMode) {
     case SDL_BLENDMODE_NONE:
         break;
     case SDL_BLENDMODE_BLEND:
         surface->map->info.flags |= SDL_COPY_BLEND;
         break;
+    case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
+        surface->map->info.flags |= SDL_COPY_BLEND_PREMULTIPLIED;
+        break;
     case SDL_BLENDMODE_ADD:
         surface->map->info.flags |= SDL_COPY_ADD;
         break;
+    case SDL_BLENDMODE_ADD_PREMULTIPLIED:
+        surface->map->info.flags |= SDL_COPY_ADD_PREMULTIPLIED;
+        break;
     case SDL_BLENDMODE_MOD:
         surface->map->info.flags |= SDL_COPY_MOD;
         break;
@@ -538,14 +782,19 @@ SDL_GetSurfaceBlendMode(SDL_Surface * surface, SDL_BlendMode *blendMode)
         return 0;
     }
 
-    switch (surface->map->
-            info.flags & (SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD)) {
+    switch (surface->map->info.flags & SDL_COPY_BLEND_MASK) {
     case SDL_COPY_BLEND:
         *blendMode = SDL_BLENDMODE_BLEND;
         break;
+    case SDL_COPY_BLEND_PREMULTIPLIED:
+        *blendMode = SDL_BLENDMODE_BLEND_PREMULTIPLIED;
+        break;
     case SDL_COPY_ADD:
         *blendMode = SDL_BLENDMODE_ADD;
         break;
+    case SDL_COPY_ADD_PREMULTIPLIED:
+        *blendMode = SDL_BLENDMODE_ADD_PREMULTIPLIED;
+        break;
     case SDL_COPY_MOD:
         *blendMode = SDL_BLENDMODE_MOD;
         break;
@@ -604,11 +853,7 @@ SDL_LowerBlit(SDL_Surface * src, SDL_Rect * srcrect,
               SDL_Surface * dst, SDL_Rect * dstrect)
 {
     /* Check to make sure the blit mapping is valid */
-    if ((src->map->dst != dst) ||
-        (dst->format->palette &&
-         src->map->dst_palette_version != dst->format->palette->version) ||
-        (src->format->palette &&
-         src->map->src_palette_version != src->format->palette->version)) {
+    if (!SDL_IsMappedTo(src, dst)) {
         if (SDL_MapSurface(src, dst) < 0) {
             return (-1);
         }
@@ -881,7 +1126,8 @@ SDL_LowerBlitScaled(SDL_Surface * src, SDL_Rect * srcrect,
 {
     static const Uint32 complex_copy_flags = (
         SDL_COPY_MODULATE_COLOR | SDL_COPY_MODULATE_ALPHA |
-        SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD |
+        SDL_COPY_BLEND | SDL_COPY_BLEND_PREMULTIPLIED |
+        SDL_COPY_ADD | SDL_COPY_ADD_PREMULTIPLIED | SDL_COPY_MOD |
         SDL_COPY_COLORKEY
     );
 
@@ -947,6 +1193,70 @@ SDL_DuplicateSurface(SDL_Surface * surface)
     return SDL_ConvertSurface(surface, surface->format, surface->flags);
 }
 
+/*
+ * Multiply (or divide) the color channels of a block of pixels by alpha, in place
+ */
+static void
+SDL_PremultiplyPixels(int width, int height, const SDL_PixelFormat * fmt,
+                      void * pixels, int pitch, SDL_bool premultiply)
+{
+    const int bpp = fmt->BytesPerPixel;
+    Uint8 *row = (Uint8 *) pixels;
+    int x, y;
+
+    if (bpp == 4 && premultiply &&
+        fmt->Rmask == (0xFFu << fmt->Rshift) &&
+        fmt->Gmask == (0xFFu << fmt->Gshift) &&
+        fmt->Bmask == (0xFFu << fmt->Bshift) &&
+        fmt->Amask == (0xFFu << fmt->Ashift)) {
+        /* 8 bits per channel: scale two channels at a time in 16-bit lanes */
+        const Uint32 Amask = fmt->Amask;
+        const int Ashift = fmt->Ashift;
+
+        for (y = height; y--; row += pitch) {
+            Uint32 *spot = (Uint32 *) row;
+            for (x = width; x--; ++spot) {
+                const Uint32 pixel = *spot;
+                const Uint32 a = (pixel >> Ashift) & 0xFF;
+                Uint32 lo, hi;
+
+                if (a == 0xFF) {
+                    continue;
+                }
+                lo = (pixel & 0x00FF00FF) * a;
+                hi = ((pixel >> 8) & 0x00FF00FF) * a;
+                /* exact x / 255 for x <= 255*255 */
+                lo = ((lo + 0x00010001 + ((lo >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+                hi = ((hi + 0x00010001 + ((hi >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+                *spot = ((lo | (hi << 8)) & ~Amask) | (pixel & Amask);
+            }
+        }
+        return;
+    }
+
+    for (y = height; y--; row += pitch) {
+        Uint8 *spot = row;
+        for (x = width; x--; spot += bpp) {
+            Uint32 pixel;
+            unsigned r, g, b, a;
+
+            DISEMBLE_RGBA(spot, bpp, fmt, pixel, r, g, b, a);
+            if (premultiply) {
+                r = (r * a) / 255;
+                g = (g * a) / 255;
+                b = (b * a) / 255;
+            } else if (a) {
+                r = SDL_min((r * 255 + a / 2) / a, 255);
+                g = SDL_min((g * 255 + a / 2) / a, 255);
+                b = SDL_min((b * 255 + a / 2) / a, 255);
+            } else {
+                r = g = b = 0;
+            }
+            ASSEMBLE_RGBA(spot, bpp, fmt, r, g, b, a);
+        }
+    }
+}
+
 /*
  * Convert a surface into the specified pixel format.
  */
@@ -955,9 +1265,11 @@ SDL_ConvertSurface(SDL_Surface * surface, const SDL_PixelFormat * format,
                    Uint32 flags)
 {
     SDL_Surface *convert;
+    Uint32 pixel_format;
     Uint32 copy_flags;
     SDL_Color copy_color;
     SDL_Rect bounds;
+    SDL_bool premultiplied;
     int ret;
 
     if (!surface) {
@@ -984,11 +1296,17 @@ SDL_ConvertSurface(SDL_Surface * surface, const SDL_PixelFormat * format,
         }
     }
 
-    /* Create a new surface with the desired format */
-    convert = SDL_CreateRGBSurface(flags, surface->w, surface->h,
-                                   format->BitsPerPixel, format->Rmask,
-                                   format->Gmask, format->Bmask,
-                                   format->Amask);
+    /* Create a new surface with the desired format. The blit below writes
+       every pixel, so only bitmaps need their bits cleared first. */
+    pixel_format = SDL_MasksToPixelFormatEnum(format->BitsPerPixel, format->Rmask,
+                                              format->Gmask, format->Bmask,
+                                              format->Amask);
+    if (pixel_format == SDL_PIXELFORMAT_UNKNOWN) {
+        SDL_SetError("Unknown pixel format");
+        return (NULL);
+    }
+    convert = SDL_CreateSurface(surface->w, surface->h, pixel_format,
+                                (format->BitsPerPixel < 8) ? SDL_TRUE : SDL_FALSE);
     if (convert == NULL) {
         return (NULL);
     }
@@ -1028,7 +1346,7 @@ SDL_ConvertSurface(SDL_Surface * surface, const SDL_PixelFormat * format,
     convert->map->info.a = copy_color.a;
     convert->map->info.flags =
         (copy_flags &
-         ~(SDL_COPY_COLORKEY | SDL_COPY_BLEND
+         ~(SDL_COPY_COLORKEY | SDL_COPY_BLEND | SDL_COPY_BLEND_PREMULTIPLIED
            | SDL_COPY_RLE_DESIRED | SDL_COPY_RLE_COLORKEY |
            SDL_COPY_RLE_ALPHAKEY));
     surface->map->info.r = copy_color.r;
@@ -1103,12 +1421,41 @@ SDL_ConvertSurface(SDL_Surface * surface, const SDL_PixelFormat * format,
     }
     SDL_SetClipRect(convert, &surface->clip_rect);
 
+    /* Premultiply or unpremultiply the colors if the alpha state changed */
+    premultiplied = (convert->format->Amask && (flags & SDL_PREMULTIPLIED)) ? SDL_TRUE : SDL_FALSE;
+    if (convert->format->Amask &&
+        premultiplied != ((surface->flags & SDL_PREMULTIPLIED) ? SDL_TRUE : SDL_FALSE)) {
+        SDL_PremultiplyPixels(convert->w, convert->h, convert->format,
+                              convert->pixels, convert->pitch, premultiplied);
+    }
+
     /* Enable alpha blending by default if the new surface has an
      * alpha channel or alpha modulation */
     if ((surface->format->Amask && format->Amask) ||
         (copy_flags & SDL_COPY_MODULATE_ALPHA)) {
         SDL_SetSurfaceBlendMode(convert, SDL_BLENDMODE_BLEND);
     }
+
+    /* Premultiplied surfaces use the matching premultiplied blend modes */
+    if (premultiplied) {
+        SDL_BlendMode blendMode;
+
+        convert->flags |= SDL_PREMULTIPLIED;
+        SDL_GetSurfaceBlendMode(convert, &blendMode);
+        if (blendMode == SDL_BLENDMODE_BLEND) {
+            SDL_SetSurfaceBlendMode(convert, SDL_BLENDMODE_BLEND_PREMULTIPLIED);
+        } else if (blendMode == SDL_BLENDMODE_ADD) {
+            SDL_SetSurfaceBlendMode(convert, SDL_BLENDMODE_ADD_PREMULTIPLIED);
+        }
+    } else {
+        SDL_BlendMode blendMode;
+
+        SDL_GetSurfaceBlendMode(convert, &blendMode);
+        if (blendMode == SDL_BLENDMODE_ADD_PREMULTIPLIED) {
+            SDL_SetSurfaceBlendMode(convert, SDL_BLENDMODE_ADD);
+        }
+    }
+
     if ((copy_flags & SDL_COPY_RLE_DESIRED) || (flags & SDL_RLEACCEL)) {
         SDL_SetSurfaceRLE(convert, SDL_RLEACCEL);
     }
@@ -1192,6 +1539,22 @@ int SDL_ConvertPixels(int width, int height,
         return SDL_InvalidParamError("dst_pitch");
     }
 
+    if (SDL_ISPIXELFORMAT_COMPRESSED(src_format) && src_format == dst_format) {
+        int i;
+        const int rows = SDL_GetCompressedRowCount(src_format, height);
+        width = SDL_GetCompressedPitch(src_format, width);
+        for (i = rows; i--;) {
+            SDL_memcpy(dst, src, width);
+            src = (const Uint8*)src + src_pitch;
+            dst = (Uint8*)dst + dst_pitch;
+        }
+        return 0;
+    } else if (SDL_ISPIXELFORMAT_COMPRESSED(dst_format)) {
+        return SDL_SetError("Converting to compressed formats isn't supported");
+    } else if (SDL_ISPIXELFORMAT_COMPRESSED(src_format)) {
+        return SDL_ConvertPixels_Compressed_to_RGB(width, height, src_format, src, src_pitch, dst_format, dst, dst_pitch);
+    }
+
     if (SDL_ISPIXELFORMAT_FOURCC(src_format) && SDL_ISPIXELFORMAT_FOURCC(dst_format)) {
         return SDL_ConvertPixels_YUV_to_YUV(width, height, src_format, src, src_pitch, dst_format, dst, dst_pitch);
     } else if (SDL_ISPIXELFORMAT_FOURCC(src_format)) {
@@ -1231,6 +1594,35 @@ int SDL_ConvertPixels(int width, int height,
     return SDL_LowerBlit(&src_surface, &rect, &dst_surface, &rect);
 }
 
+/*
+ * Copy a block of pixels of one format to another format, multiplying
+ * the color channels by alpha along the way
+ */
+int SDL_PremultiplyAlpha(int width, int height,
+                         Uint32 src_format, const void * src, int src_pitch,
+                         Uint32 dst_format, void * dst, int dst_pitch)
+{
+    SDL_PixelFormat fmt;
+
+    if (!src) {
+        return SDL_InvalidParamError("src");
+    }
+    if (!SDL_ISPIXELFORMAT_ALPHA(dst_format) ||
+        SDL_ISPIXELFORMAT_INDEXED(dst_format) ||
+        SDL_ISPIXELFORMAT_FOURCC(dst_format)) {
+        return SDL_SetError("Destination format must have an alpha channel");
+    }
+    if (SDL_ConvertPixels(width, height, src_format, src, src_pitch,
+                          dst_format, dst, dst_pitch) < 0) {
+        return -1;
+    }
+    if (SDL_InitFormat(&fmt, dst_format) < 0) {
+        return -1;
+    }
+    SDL_PremultiplyPixels(width, height, &fmt, dst, dst_pitch, SDL_TRUE);
+    return 0;
+}
+
 /*
  * Free a surface created by the above function.
  */
@@ -1259,15 +1651,7 @@ SDL_FreeSurface(SDL_Surface * surface)
         SDL_FreeFormat(surface->format);
         surface->format = NULL;
     }
-    if (surface->flags & SDL_PREALLOC) {
-        /* Don't free */
-    } else if (surface->flags & SDL_SIMD_ALIGNED) {
-        /* Free aligned */
-        SDL_SIMDFree(surface->pixels);
-    } else {
-        /* Normal */
-        SDL_free(surface->pixels);
-    }
+    SDL_FreeSurfacePixels(surface);
     if (surface->map) {
         SDL_FreeBlitMap(surface->map);
     }
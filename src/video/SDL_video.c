@@ -2348,6 +2348,23 @@ SDL_UpdateWindowSurfaceRects(SDL_Window * window, const SDL_Rect * rects,
         return SDL_SetError("Window surface is invalid, please call SDL_GetWindowSurface() to get a new surface");
     }
 
+    if (numrects > 0) {
+        SDL_Rect *dirty;
+        SDL_bool isstack;
+        int retval;
+
+        /* Hand the driver as few, as small updates as we can */
+        dirty = SDL_small_alloc(SDL_Rect, numrects, &isstack);
+        if (!dirty) {
+            return SDL_OutOfMemory();
+        }
+        SDL_memcpy(dirty, rects, numrects * sizeof(*rects));
+        numrects = SDL_CoalesceRects(window->w, window->h, dirty, numrects);
+        retval = _this->UpdateWindowFramebuffer(_this, window, dirty, numrects);
+        SDL_small_free(dirty, isstack);
+        return retval;
+    }
+
     return _this->UpdateWindowFramebuffer(_this, window, rects, numrects);
 }
 
@@ -21,14 +21,22 @@
 #include "../SDL_internal.h"
 
 #include "SDL_endian.h"
+#include "SDL_hints.h"
 #include "SDL_video.h"
 #include "SDL_pixels_c.h"
 #include "SDL_yuv_c.h"
+#include "../thread/SDL_workers_c.h"
 
 #include "yuv2rgb/yuv_rgb.h"
 
 #define SDL_YUV_SD_THRESHOLD    576
 
+/* Frames smaller than this are converted on the calling thread */
+#define YUV_PARALLEL_PIXELS     (1280 * 720)
+
+/* Don't bother splitting into bands smaller than this */
+#define YUV_MIN_BAND_ROWS       32
+
 
 static SDL_YUV_CONVERSION_MODE SDL_YUV_ConversionMode = SDL_YUV_CONVERSION_BT601;
 
@@ -89,11 +97,12 @@ static SDL_bool IsPacked4Format(Uint32 format)
             format == SDL_PIXELFORMAT_YVYU);
 }
 
-static int GetYUVPlanes(int width, int height, Uint32 format, const void *yuv, int yuv_pitch,
-                        const Uint8 **y, const Uint8 **u, const Uint8 **v, Uint32 *y_stride, Uint32 *uv_stride)
+/* Find the planes of a contiguous YUV image, in the order they are stored */
+int
+SDL_GetYUVPlaneLayout(int height, Uint32 format, void *yuv, int yuv_pitch, Uint8 *planes[3], int pitches[3])
 {
-    const Uint8 *planes[3] = { NULL, NULL, NULL };
-    int pitches[3] = { 0, 0, 0 };
+    planes[0] = planes[1] = planes[2] = NULL;
+    pitches[0] = pitches[1] = pitches[2] = 0;
 
     switch (format) {
     case SDL_PIXELFORMAT_YV12:
@@ -101,7 +110,7 @@ static int GetYUVPlanes(int width, int height, Uint32 format, const void *yuv, i
         pitches[0] = yuv_pitch;
         pitches[1] = (pitches[0] + 1) / 2;
         pitches[2] = (pitches[0] + 1) / 2;
-        planes[0] = (const Uint8 *)yuv;
+        planes[0] = (Uint8 *)yuv;
         planes[1] = planes[0] + pitches[0] * height;
         planes[2] = planes[1] + pitches[1] * ((height + 1) / 2);
         break;
@@ -109,17 +118,46 @@ static int GetYUVPlanes(int width, int height, Uint32 format, const void *yuv, i
     case SDL_PIXELFORMAT_UYVY:
     case SDL_PIXELFORMAT_YVYU:
         pitches[0] = yuv_pitch;
-        planes[0] = (const Uint8 *)yuv;
+        planes[0] = (Uint8 *)yuv;
         break;
     case SDL_PIXELFORMAT_NV12:
     case SDL_PIXELFORMAT_NV21:
         pitches[0] = yuv_pitch;
         pitches[1] = 2 * ((pitches[0] + 1) / 2);
-        planes[0] = (const Uint8 *)yuv;
+        planes[0] = (Uint8 *)yuv;
+        planes[1] = planes[0] + pitches[0] * height;
+        break;
+    case SDL_PIXELFORMAT_P010:
+    case SDL_PIXELFORMAT_P016:
+        /* The U/V plane holds whole 4 byte U/V pairs */
+        pitches[0] = yuv_pitch;
+        pitches[1] = (pitches[0] + 3) & ~3;
+        planes[0] = (Uint8 *)yuv;
+        planes[1] = planes[0] + pitches[0] * height;
+        break;
+    case SDL_PIXELFORMAT_I010:
+        /* U and V planes hold half as many 2 byte samples as the Y plane, rounded up */
+        pitches[0] = yuv_pitch;
+        pitches[1] = ((pitches[0] + 2) / 4) * 2;
+        pitches[2] = pitches[1];
+        planes[0] = (Uint8 *)yuv;
         planes[1] = planes[0] + pitches[0] * height;
+        planes[2] = planes[1] + pitches[1] * ((height + 1) / 2);
         break;
     default:
-        return SDL_SetError("GetYUVPlanes(): Unsupported YUV format: %s", SDL_GetPixelFormatName(format));
+        return SDL_SetError("SDL_GetYUVPlaneLayout(): Unsupported YUV format: %s", SDL_GetPixelFormatName(format));
+    }
+    return 0;
+}
+
+static int GetYUVPlanes(int width, int height, Uint32 format, const void *yuv, int yuv_pitch,
+                        const Uint8 **y, const Uint8 **u, const Uint8 **v, Uint32 *y_stride, Uint32 *uv_stride)
+{
+    Uint8 *planes[3];
+    int pitches[3];
+
+    if (SDL_GetYUVPlaneLayout(height, format, (void *)yuv, yuv_pitch, planes, pitches) < 0) {
+        return -1;
     }
 
     switch (format) {
@@ -172,6 +210,21 @@ static int GetYUVPlanes(int width, int height, Uint32 format, const void *yuv, i
         *u = *v + 1;
         *uv_stride = pitches[1];
         break;
+    case SDL_PIXELFORMAT_P010:
+    case SDL_PIXELFORMAT_P016:
+        *y = planes[0];
+        *y_stride = pitches[0];
+        *u = planes[1];
+        *v = *u + 2;
+        *uv_stride = pitches[1];
+        break;
+    case SDL_PIXELFORMAT_I010:
+        *y = planes[0];
+        *y_stride = pitches[0];
+        *u = planes[1];
+        *v = planes[2];
+        *uv_stride = pitches[1];
+        break;
     default:
         /* Should have caught this above */
         return SDL_SetError("GetYUVPlanes[2]: Unsupported YUV format: %s", SDL_GetPixelFormatName(format));
@@ -179,6 +232,419 @@ static int GetYUVPlanes(int width, int height, Uint32 format, const void *yuv, i
     return 0;
 }
 
+/* 16-bit YUV formats are converted by narrowing them to the 8-bit format with
+   the same plane layout, NV12 for P010 and P016 and IYUV for I010, or by
+   widening that format back up to 16 bits */
+static SDL_bool Is16BitYUVFormat(Uint32 format)
+{
+    return (format == SDL_PIXELFORMAT_P010 ||
+            format == SDL_PIXELFORMAT_P016 ||
+            format == SDL_PIXELFORMAT_I010);
+}
+
+static Uint32 Get8BitYUVFormat(Uint32 format)
+{
+    return (format == SDL_PIXELFORMAT_I010) ? SDL_PIXELFORMAT_IYUV : SDL_PIXELFORMAT_NV12;
+}
+
+/* Returns the size of an 8-bit 4:2:0 image whose pitch is its width */
+static size_t GetYUV420Size(int width, int height)
+{
+    return (size_t)width * height + 2 * (size_t)((width + 1) / 2) * ((height + 1) / 2);
+}
+
+/* Narrowing computes value >> shift, saturated to 255, and widening computes
+   ((value * 257) >> shift) & mask, which replicates the high bits of the 8-bit
+   value into the low bits so narrowing it again gives back the same value */
+static int GetYUV16NarrowShift(Uint32 format)
+{
+    return (format == SDL_PIXELFORMAT_I010) ? 2 : 8;
+}
+
+static void GetYUV16WidenParams(Uint32 format, int *shift, Uint16 *mask)
+{
+    switch (format) {
+    case SDL_PIXELFORMAT_P010:
+        *shift = 0;
+        *mask = 0xFFC0;
+        break;
+    case SDL_PIXELFORMAT_I010:
+        *shift = 6;
+        *mask = 0x03FF;
+        break;
+    default:
+        *shift = 0;
+        *mask = 0xFFFF;
+        break;
+    }
+}
+
+typedef int (*YUV16NarrowFunc)(const Uint16 *src, Uint8 *dst, int count, int shift);
+typedef int (*YUV16WidenFunc)(const Uint8 *src, Uint16 *dst, int count, int shift, Uint16 mask);
+
+#if HAVE_SSE2_INTRINSICS
+static int
+YUV16_NarrowSSE2(const Uint16 *src, Uint8 *dst, int count, int shift)
+{
+    const __m128i shift_count = _mm_cvtsi32_si128(shift);
+    int i;
+
+    for (i = 0; i + 16 <= count; i += 16) {
+        const __m128i a = _mm_srl_epi16(_mm_loadu_si128((const __m128i *)(src + i)), shift_count);
+        const __m128i b = _mm_srl_epi16(_mm_loadu_si128((const __m128i *)(src + i + 8)), shift_count);
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(a, b));
+    }
+    return i;
+}
+
+static int
+YUV16_WidenSSE2(const Uint8 *src, Uint16 *dst, int count, int shift, Uint16 mask)
+{
+    const __m128i shift_count = _mm_cvtsi32_si128(shift);
+    const __m128i mask16 = _mm_set1_epi16((short)mask);
+    int i;
+
+    for (i = 0; i + 16 <= count; i += 16) {
+        const __m128i a = _mm_loadu_si128((const __m128i *)(src + i));
+        /* Interleaving a byte with itself multiplies it by 257 */
+        const __m128i lo = _mm_srl_epi16(_mm_unpacklo_epi8(a, a), shift_count);
+        const __m128i hi = _mm_srl_epi16(_mm_unpackhi_epi8(a, a), shift_count);
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_and_si128(lo, mask16));
+        _mm_storeu_si128((__m128i *)(dst + i + 8), _mm_and_si128(hi, mask16));
+    }
+    return i;
+}
+#endif /* HAVE_SSE2_INTRINSICS */
+
+#if HAVE_AVX2_INTRINSICS
+SDL_TARGETING("avx2") static int
+YUV16_NarrowAVX2(const Uint16 *src, Uint8 *dst, int count, int shift)
+{
+    const __m128i shift_count = _mm_cvtsi32_si128(shift);
+    int i;
+
+    for (i = 0; i + 32 <= count; i += 32) {
+        const __m256i a = _mm256_srl_epi16(_mm256_loadu_si256((const __m256i *)(src + i)), shift_count);
+        const __m256i b = _mm256_srl_epi16(_mm256_loadu_si256((const __m256i *)(src + i + 16)), shift_count);
+        /* The pack works within 128-bit lanes, put the quarters back in order */
+        _mm256_storeu_si256((__m256i *)(dst + i),
+                            _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+    return i;
+}
+
+SDL_TARGETING("avx2") static int
+YUV16_WidenAVX2(const Uint8 *src, Uint16 *dst, int count, int shift, Uint16 mask)
+{
+    const __m128i shift_count = _mm_cvtsi32_si128(shift);
+    const __m256i mask16 = _mm256_set1_epi16((short)mask);
+    int i;
+
+    for (i = 0; i + 16 <= count; i += 16) {
+        __m256i a = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(src + i)));
+        a = _mm256_or_si256(a, _mm256_slli_epi16(a, 8));
+        a = _mm256_and_si256(_mm256_srl_epi16(a, shift_count), mask16);
+        _mm256_storeu_si256((__m256i *)(dst + i), a);
+    }
+    return i;
+}
+#endif /* HAVE_AVX2_INTRINSICS */
+
+#if HAVE_NEON_INTRINSICS
+static int
+YUV16_NarrowNEON(const Uint16 *src, Uint8 *dst, int count, int shift)
+{
+    const int16x8_t shift_right = vdupq_n_s16((int16_t)-shift);
+    int i;
+
+    for (i = 0; i + 16 <= count; i += 16) {
+        const uint16x8_t a = vshlq_u16(vld1q_u16(src + i), shift_right);
+        const uint16x8_t b = vshlq_u16(vld1q_u16(src + i + 8), shift_right);
+        vst1q_u8(dst + i, vcombine_u8(vqmovn_u16(a), vqmovn_u16(b)));
+    }
+    return i;
+}
+
+static int
+YUV16_WidenNEON(const Uint8 *src, Uint16 *dst, int count, int shift, Uint16 mask)
+{
+    const int16x8_t shift_right = vdupq_n_s16((int16_t)-shift);
+    const uint16x8_t mask16 = vdupq_n_u16(mask);
+    int i;
+
+    for (i = 0; i + 16 <= count; i += 16) {
+        const uint8x16_t a = vld1q_u8(src + i);
+        const uint16x8_t lo = vmovl_u8(vget_low_u8(a));
+        const uint16x8_t hi = vmovl_u8(vget_high_u8(a));
+        vst1q_u16(dst + i, vandq_u16(vshlq_u16(vorrq_u16(lo, vshlq_n_u16(lo, 8)), shift_right), mask16));
+        vst1q_u16(dst + i + 8, vandq_u16(vshlq_u16(vorrq_u16(hi, vshlq_n_u16(hi, 8)), shift_right), mask16));
+    }
+    return i;
+}
+#endif /* HAVE_NEON_INTRINSICS */
+
+static YUV16NarrowFunc
+YUV16_ChooseNarrowFunc(void)
+{
+#if HAVE_AVX2_INTRINSICS
+    if (SDL_HasAVX2()) {
+        return YUV16_NarrowAVX2;
+    }
+#endif
+#if HAVE_SSE2_INTRINSICS
+    if (SDL_HasSSE2()) {
+        return YUV16_NarrowSSE2;
+    }
+#endif
+#if HAVE_NEON_INTRINSICS
+    if (SDL_HasNEON()) {
+        return YUV16_NarrowNEON;
+    }
+#endif
+    return NULL;
+}
+
+static YUV16WidenFunc
+YUV16_ChooseWidenFunc(void)
+{
+#if HAVE_AVX2_INTRINSICS
+    if (SDL_HasAVX2()) {
+        return YUV16_WidenAVX2;
+    }
+#endif
+#if HAVE_SSE2_INTRINSICS
+    if (SDL_HasSSE2()) {
+        return YUV16_WidenSSE2;
+    }
+#endif
+#if HAVE_NEON_INTRINSICS
+    if (SDL_HasNEON()) {
+        return YUV16_WidenNEON;
+    }
+#endif
+    return NULL;
+}
+
+static void
+YUV16_NarrowPlane(const Uint8 *src, Uint32 src_stride, Uint8 *dst, Uint32 dst_stride,
+                  int count, int rows, int shift)
+{
+    const YUV16NarrowFunc narrow = YUV16_ChooseNarrowFunc();
+    int i;
+
+    while (rows--) {
+        const Uint16 *samples = (const Uint16 *)src;
+
+        i = narrow ? narrow(samples, dst, count, shift) : 0;
+        for (; i < count; ++i) {
+            const int value = samples[i] >> shift;
+            dst[i] = (Uint8)SDL_min(value, 255);
+        }
+        src += src_stride;
+        dst += dst_stride;
+    }
+}
+
+static void
+YUV16_WidenPlane(const Uint8 *src, Uint32 src_stride, Uint8 *dst, Uint32 dst_stride,
+                 int count, int rows, int shift, Uint16 mask)
+{
+    const YUV16WidenFunc widen = YUV16_ChooseWidenFunc();
+    int i;
+
+    while (rows--) {
+        Uint16 *samples = (Uint16 *)dst;
+
+        i = widen ? widen(src, samples, count, shift, mask) : 0;
+        for (; i < count; ++i) {
+            samples[i] = (Uint16)(((src[i] * 257) >> shift) & mask);
+        }
+        src += src_stride;
+        dst += dst_stride;
+    }
+}
+
+/* Narrows the planes of a 16-bit image into the planes of its 8-bit format.
+   For P010 and P016 the interleaved U/V plane is passed as u. */
+static void
+YUV16_NarrowPlanes(Uint32 format, int width, int height,
+                   const Uint8 *y, const Uint8 *u, const Uint8 *v, Uint32 y_stride, Uint32 uv_stride,
+                   Uint8 *y8, Uint8 *u8, Uint8 *v8, Uint32 y8_stride, Uint32 uv8_stride)
+{
+    const int shift = GetYUV16NarrowShift(format);
+    const int uv_width = (width + 1) / 2;
+    const int uv_height = (height + 1) / 2;
+
+    YUV16_NarrowPlane(y, y_stride, y8, y8_stride, width, height, shift);
+    if (format == SDL_PIXELFORMAT_I010) {
+        YUV16_NarrowPlane(u, uv_stride, u8, uv8_stride, uv_width, uv_height, shift);
+        YUV16_NarrowPlane(v, uv_stride, v8, uv8_stride, uv_width, uv_height, shift);
+    } else {
+        YUV16_NarrowPlane(u, uv_stride, u8, uv8_stride, 2 * uv_width, uv_height, shift);
+    }
+}
+
+static int
+SDL_ConvertPixels_YUV16_to_YUV8(int width, int height,
+         Uint32 src_format, const void *src, int src_pitch, void *dst, int dst_pitch)
+{
+    const Uint8 *y, *u, *v;
+    const Uint8 *y8, *u8, *v8;
+    Uint32 y_stride, uv_stride;
+    Uint32 y8_stride, uv8_stride;
+
+    if (GetYUVPlanes(width, height, src_format, src, src_pitch, &y, &u, &v, &y_stride, &uv_stride) < 0) {
+        return -1;
+    }
+    if (GetYUVPlanes(width, height, Get8BitYUVFormat(src_format), dst, dst_pitch, &y8, &u8, &v8, &y8_stride, &uv8_stride) < 0) {
+        return -1;
+    }
+
+    YUV16_NarrowPlanes(src_format, width, height, y, u, v, y_stride, uv_stride,
+                       (Uint8 *)y8, (Uint8 *)u8, (Uint8 *)v8, y8_stride, uv8_stride);
+    return 0;
+}
+
+static int
+SDL_ConvertPixels_YUV8_to_YUV16(int width, int height,
+         const void *src, int src_pitch, Uint32 dst_format, void *dst, int dst_pitch)
+{
+    const Uint8 *y8, *u8, *v8;
+    const Uint8 *y, *u, *v;
+    Uint32 y8_stride, uv8_stride;
+    Uint32 y_stride, uv_stride;
+    const int uv_width = (width + 1) / 2;
+    const int uv_height = (height + 1) / 2;
+    int shift;
+    Uint16 mask;
+
+    if (GetYUVPlanes(width, height, Get8BitYUVFormat(dst_format), src, src_pitch, &y8, &u8, &v8, &y8_stride, &uv8_stride) < 0) {
+        return -1;
+    }
+    if (GetYUVPlanes(width, height, dst_format, dst, dst_pitch, &y, &u, &v, &y_stride, &uv_stride) < 0) {
+        return -1;
+    }
+
+    GetYUV16WidenParams(dst_format, &shift, &mask);
+    YUV16_WidenPlane(y8, y8_stride, (Uint8 *)y, y_stride, width, height, shift, mask);
+    if (dst_format == SDL_PIXELFORMAT_I010) {
+        YUV16_WidenPlane(u8, uv8_stride, (Uint8 *)u, uv_stride, uv_width, uv_height, shift, mask);
+        YUV16_WidenPlane(v8, uv8_stride, (Uint8 *)v, uv_stride, uv_width, uv_height, shift, mask);
+    } else {
+        YUV16_WidenPlane(u8, uv8_stride, (Uint8 *)u, uv_stride, 2 * uv_width, uv_height, shift, mask);
+    }
+    return 0;
+}
+
+static SDL_bool yuv_rgb_avx2(
+    Uint32 src_format, Uint32 dst_format,
+    Uint32 width, Uint32 height, 
+    const Uint8 *y, const Uint8 *u, const Uint8 *v, Uint32 y_stride, Uint32 uv_stride, 
+    Uint8 *rgb, Uint32 rgb_stride, 
+    YCbCrType yuv_type)
+{
+#if HAVE_AVX2_INTRINSICS
+    if (!SDL_HasAVX2()) {
+        return SDL_FALSE;
+    }
+
+    if (src_format == SDL_PIXELFORMAT_YV12 ||
+        src_format == SDL_PIXELFORMAT_IYUV) {
+
+        switch (dst_format) {
+        case SDL_PIXELFORMAT_RGB565:
+            yuv420_rgb565_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_RGB24:
+            yuv420_rgb24_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_RGBX8888:
+        case SDL_PIXELFORMAT_RGBA8888:
+            yuv420_rgba_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_BGRX8888:
+        case SDL_PIXELFORMAT_BGRA8888:
+            yuv420_bgra_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_RGB888:
+        case SDL_PIXELFORMAT_ARGB8888:
+            yuv420_argb_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_BGR888:
+        case SDL_PIXELFORMAT_ABGR8888:
+            yuv420_abgr_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        default:
+            break;
+        }
+    }
+
+    if (src_format == SDL_PIXELFORMAT_YUY2 ||
+        src_format == SDL_PIXELFORMAT_UYVY ||
+        src_format == SDL_PIXELFORMAT_YVYU) {
+
+        switch (dst_format) {
+        case SDL_PIXELFORMAT_RGB565:
+            yuv422_rgb565_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_RGB24:
+            yuv422_rgb24_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_RGBX8888:
+        case SDL_PIXELFORMAT_RGBA8888:
+            yuv422_rgba_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_BGRX8888:
+        case SDL_PIXELFORMAT_BGRA8888:
+            yuv422_bgra_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_RGB888:
+        case SDL_PIXELFORMAT_ARGB8888:
+            yuv422_argb_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_BGR888:
+        case SDL_PIXELFORMAT_ABGR8888:
+            yuv422_abgr_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        default:
+            break;
+        }
+    }
+
+    if (src_format == SDL_PIXELFORMAT_NV12 ||
+        src_format == SDL_PIXELFORMAT_NV21) {
+
+        switch (dst_format) {
+        case SDL_PIXELFORMAT_RGB565:
+            yuvnv12_rgb565_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_RGB24:
+            yuvnv12_rgb24_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_RGBX8888:
+        case SDL_PIXELFORMAT_RGBA8888:
+            yuvnv12_rgba_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_BGRX8888:
+        case SDL_PIXELFORMAT_BGRA8888:
+            yuvnv12_bgra_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_RGB888:
+        case SDL_PIXELFORMAT_ARGB8888:
+            yuvnv12_argb_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_BGR888:
+        case SDL_PIXELFORMAT_ABGR8888:
+            yuvnv12_abgr_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        default:
+            break;
+        }
+    }
+#endif
+    return SDL_FALSE;
+}
+
 static SDL_bool yuv_rgb_sse(
     Uint32 src_format, Uint32 dst_format,
     Uint32 width, Uint32 height, 
@@ -203,19 +669,128 @@ static SDL_bool yuv_rgb_sse(
             return SDL_TRUE;
         case SDL_PIXELFORMAT_RGBX8888:
         case SDL_PIXELFORMAT_RGBA8888:
-            yuv420_rgba_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            yuv420_rgba_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_BGRX8888:
+        case SDL_PIXELFORMAT_BGRA8888:
+            yuv420_bgra_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_RGB888:
+        case SDL_PIXELFORMAT_ARGB8888:
+            yuv420_argb_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_BGR888:
+        case SDL_PIXELFORMAT_ABGR8888:
+            yuv420_abgr_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        default:
+            break;
+        }
+    }
+
+    if (src_format == SDL_PIXELFORMAT_YUY2 ||
+        src_format == SDL_PIXELFORMAT_UYVY ||
+        src_format == SDL_PIXELFORMAT_YVYU) {
+
+        switch (dst_format) {
+        case SDL_PIXELFORMAT_RGB565:
+            yuv422_rgb565_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_RGB24:
+            yuv422_rgb24_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_RGBX8888:
+        case SDL_PIXELFORMAT_RGBA8888:
+            yuv422_rgba_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_BGRX8888:
+        case SDL_PIXELFORMAT_BGRA8888:
+            yuv422_bgra_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_RGB888:
+        case SDL_PIXELFORMAT_ARGB8888:
+            yuv422_argb_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_BGR888:
+        case SDL_PIXELFORMAT_ABGR8888:
+            yuv422_abgr_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        default:
+            break;
+        }
+    }
+
+    if (src_format == SDL_PIXELFORMAT_NV12 ||
+        src_format == SDL_PIXELFORMAT_NV21) {
+
+        switch (dst_format) {
+        case SDL_PIXELFORMAT_RGB565:
+            yuvnv12_rgb565_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_RGB24:
+            yuvnv12_rgb24_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_RGBX8888:
+        case SDL_PIXELFORMAT_RGBA8888:
+            yuvnv12_rgba_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_BGRX8888:
+        case SDL_PIXELFORMAT_BGRA8888:
+            yuvnv12_bgra_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_RGB888:
+        case SDL_PIXELFORMAT_ARGB8888:
+            yuvnv12_argb_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_BGR888:
+        case SDL_PIXELFORMAT_ABGR8888:
+            yuvnv12_abgr_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        default:
+            break;
+        }
+    }
+#endif
+    return SDL_FALSE;
+}
+
+static SDL_bool yuv_rgb_neon(
+    Uint32 src_format, Uint32 dst_format,
+    Uint32 width, Uint32 height, 
+    const Uint8 *y, const Uint8 *u, const Uint8 *v, Uint32 y_stride, Uint32 uv_stride, 
+    Uint8 *rgb, Uint32 rgb_stride, 
+    YCbCrType yuv_type)
+{
+#if HAVE_NEON_INTRINSICS && SDL_BYTEORDER == SDL_LIL_ENDIAN
+    if (!SDL_HasNEON()) {
+        return SDL_FALSE;
+    }
+
+    if (src_format == SDL_PIXELFORMAT_YV12 ||
+        src_format == SDL_PIXELFORMAT_IYUV) {
+
+        switch (dst_format) {
+        case SDL_PIXELFORMAT_RGB565:
+            yuv420_rgb565_neon(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_RGB24:
+            yuv420_rgb24_neon(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return SDL_TRUE;
+        case SDL_PIXELFORMAT_RGBX8888:
+        case SDL_PIXELFORMAT_RGBA8888:
+            yuv420_rgba_neon(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
             return SDL_TRUE;
         case SDL_PIXELFORMAT_BGRX8888:
         case SDL_PIXELFORMAT_BGRA8888:
-            yuv420_bgra_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            yuv420_bgra_neon(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
             return SDL_TRUE;
         case SDL_PIXELFORMAT_RGB888:
         case SDL_PIXELFORMAT_ARGB8888:
-            yuv420_argb_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            yuv420_argb_neon(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
             return SDL_TRUE;
         case SDL_PIXELFORMAT_BGR888:
         case SDL_PIXELFORMAT_ABGR8888:
-            yuv420_abgr_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            yuv420_abgr_neon(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
             return SDL_TRUE;
         default:
             break;
@@ -228,26 +803,26 @@ static SDL_bool yuv_rgb_sse(
 
         switch (dst_format) {
         case SDL_PIXELFORMAT_RGB565:
-            yuv422_rgb565_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            yuv422_rgb565_neon(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
             return SDL_TRUE;
         case SDL_PIXELFORMAT_RGB24:
-            yuv422_rgb24_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            yuv422_rgb24_neon(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
             return SDL_TRUE;
         case SDL_PIXELFORMAT_RGBX8888:
         case SDL_PIXELFORMAT_RGBA8888:
-            yuv422_rgba_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            yuv422_rgba_neon(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
             return SDL_TRUE;
         case SDL_PIXELFORMAT_BGRX8888:
         case SDL_PIXELFORMAT_BGRA8888:
-            yuv422_bgra_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            yuv422_bgra_neon(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
             return SDL_TRUE;
         case SDL_PIXELFORMAT_RGB888:
         case SDL_PIXELFORMAT_ARGB8888:
-            yuv422_argb_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            yuv422_argb_neon(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
             return SDL_TRUE;
         case SDL_PIXELFORMAT_BGR888:
         case SDL_PIXELFORMAT_ABGR8888:
-            yuv422_abgr_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            yuv422_abgr_neon(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
             return SDL_TRUE;
         default:
             break;
@@ -259,26 +834,26 @@ static SDL_bool yuv_rgb_sse(
 
         switch (dst_format) {
         case SDL_PIXELFORMAT_RGB565:
-            yuvnv12_rgb565_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            yuvnv12_rgb565_neon(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
             return SDL_TRUE;
         case SDL_PIXELFORMAT_RGB24:
-            yuvnv12_rgb24_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            yuvnv12_rgb24_neon(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
             return SDL_TRUE;
         case SDL_PIXELFORMAT_RGBX8888:
         case SDL_PIXELFORMAT_RGBA8888:
-            yuvnv12_rgba_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            yuvnv12_rgba_neon(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
             return SDL_TRUE;
         case SDL_PIXELFORMAT_BGRX8888:
         case SDL_PIXELFORMAT_BGRA8888:
-            yuvnv12_bgra_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            yuvnv12_bgra_neon(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
             return SDL_TRUE;
         case SDL_PIXELFORMAT_RGB888:
         case SDL_PIXELFORMAT_ARGB8888:
-            yuvnv12_argb_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            yuvnv12_argb_neon(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
             return SDL_TRUE;
         case SDL_PIXELFORMAT_BGR888:
         case SDL_PIXELFORMAT_ABGR8888:
-            yuvnv12_abgr_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            yuvnv12_abgr_neon(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
             return SDL_TRUE;
         default:
             break;
@@ -391,6 +966,153 @@ static SDL_bool yuv_rgb_std(
     return SDL_FALSE;
 }
 
+static SDL_bool yuv_rgb(
+    Uint32 src_format, Uint32 dst_format,
+    Uint32 width, Uint32 height, 
+    const Uint8 *y, const Uint8 *u, const Uint8 *v, Uint32 y_stride, Uint32 uv_stride, 
+    Uint8 *rgb, Uint32 rgb_stride, 
+    YCbCrType yuv_type)
+{
+    if (yuv_rgb_avx2(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type)) {
+        return SDL_TRUE;
+    }
+
+    if (yuv_rgb_sse(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type)) {
+        return SDL_TRUE;
+    }
+
+    if (yuv_rgb_neon(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type)) {
+        return SDL_TRUE;
+    }
+
+    return yuv_rgb_std(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+}
+
+/* Returns SDL_TRUE if yuv_rgb() can convert directly to the RGB format */
+static SDL_bool yuv_rgb_supported(Uint32 dst_format)
+{
+    switch (dst_format) {
+    case SDL_PIXELFORMAT_RGB565:
+    case SDL_PIXELFORMAT_RGB24:
+    case SDL_PIXELFORMAT_RGBX8888:
+    case SDL_PIXELFORMAT_RGBA8888:
+    case SDL_PIXELFORMAT_BGRX8888:
+    case SDL_PIXELFORMAT_BGRA8888:
+    case SDL_PIXELFORMAT_RGB888:
+    case SDL_PIXELFORMAT_ARGB8888:
+    case SDL_PIXELFORMAT_BGR888:
+    case SDL_PIXELFORMAT_ABGR8888:
+        return SDL_TRUE;
+    default:
+        return SDL_FALSE;
+    }
+}
+
+typedef struct
+{
+    Uint32 src_format;
+    Uint32 dst_format;
+    Uint32 width;
+    Uint32 height;
+    const Uint8 *y;
+    const Uint8 *u;
+    const Uint8 *v;
+    Uint32 y_stride;
+    Uint32 uv_stride;
+    Uint8 *rgb;
+    Uint32 rgb_stride;
+    YCbCrType yuv_type;
+    Uint32 band_rows;
+    int bands;
+    Uint8 *scratch;     /* 8-bit rows for each band of a 16-bit image */
+} YUVToRGBJob;
+
+/* Rows of a 16-bit image narrowed at a time, few enough to stay in cache */
+#define YUV16_CHUNK_ROWS    16
+
+/* Converts a band of a 16-bit image by narrowing a chunk of rows at a time
+   into the band's scratch buffer and converting them from there */
+static void
+yuv16_rgb_band(const YUVToRGBJob *job, int index, Uint32 top, Uint32 rows)
+{
+    const Uint32 format = Get8BitYUVFormat(job->src_format);
+    const Uint32 y8_stride = job->width;
+    const Uint32 uv8_stride = (format == SDL_PIXELFORMAT_IYUV) ? (job->width + 1) / 2 : 2 * ((job->width + 1) / 2);
+    Uint8 *y8 = job->scratch + index * GetYUV420Size(job->width, YUV16_CHUNK_ROWS);
+    Uint8 *u8 = y8 + y8_stride * YUV16_CHUNK_ROWS;
+    Uint8 *v8 = (format == SDL_PIXELFORMAT_IYUV) ? (u8 + uv8_stride * (YUV16_CHUNK_ROWS / 2)) : (u8 + 1);
+    Uint32 row;
+
+    for (row = top; row < top + rows; row += YUV16_CHUNK_ROWS) {
+        const Uint32 chunk = SDL_min(YUV16_CHUNK_ROWS, top + rows - row);
+
+        YUV16_NarrowPlanes(job->src_format, job->width, chunk,
+                           job->y + row * job->y_stride,
+                           job->u + (row / 2) * job->uv_stride,
+                           job->v + (row / 2) * job->uv_stride,
+                           job->y_stride, job->uv_stride,
+                           y8, u8, v8, y8_stride, uv8_stride);
+        yuv_rgb(format, job->dst_format, job->width, chunk,
+                y8, u8, v8, y8_stride, uv8_stride,
+                job->rgb + row * job->rgb_stride, job->rgb_stride,
+                job->yuv_type);
+    }
+}
+
+/* Convert one band of rows. Every band but the last starts and ends on an
+   even row, so 4:2:0 chroma rows are never shared between bands. */
+static void
+yuv_rgb_band(void *data, int index)
+{
+    const YUVToRGBJob *job = (const YUVToRGBJob *) data;
+    const Uint32 top = index * job->band_rows;
+    const Uint32 rows = (index == job->bands - 1) ? (job->height - top) : job->band_rows;
+    Uint32 uv_top = top;
+
+    if (job->scratch) {
+        yuv16_rgb_band(job, index, top, rows);
+        return;
+    }
+
+    switch (job->src_format) {
+    case SDL_PIXELFORMAT_YV12:
+    case SDL_PIXELFORMAT_IYUV:
+    case SDL_PIXELFORMAT_NV12:
+    case SDL_PIXELFORMAT_NV21:
+        uv_top = top / 2;
+        break;
+    default:
+        break;
+    }
+
+    yuv_rgb(job->src_format, job->dst_format, job->width, rows,
+            job->y + top * job->y_stride,
+            job->u + uv_top * job->uv_stride,
+            job->v + uv_top * job->uv_stride,
+            job->y_stride, job->uv_stride,
+            job->rgb + top * job->rgb_stride, job->rgb_stride,
+            job->yuv_type);
+}
+
+/* Returns how many bands to split a conversion into */
+static int
+GetYUVConversionBands(int width, int height)
+{
+    const char *hint;
+    int bands;
+
+    if ((Sint64)width * height < YUV_PARALLEL_PIXELS) {
+        return 1;
+    }
+
+    hint = SDL_GetHint(SDL_HINT_YUV_CONVERSION_THREADS);
+    bands = hint ? SDL_atoi(hint) : 0;
+    if (bands <= 0) {
+        bands = SDL_GetWorkerCount();
+    }
+    return SDL_max(SDL_min(bands, height / YUV_MIN_BAND_ROWS), 1);
+}
+
 int
 SDL_ConvertPixels_YUV_to_RGB(int width, int height,
          Uint32 src_format, const void *src, int src_pitch,
@@ -411,11 +1133,32 @@ SDL_ConvertPixels_YUV_to_RGB(int width, int height,
         return -1;
     }
 
-    if (yuv_rgb_sse(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, (Uint8*)dst, dst_pitch, yuv_type)) {
-        return 0;
-    }
-
-    if (yuv_rgb_std(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, (Uint8*)dst, dst_pitch, yuv_type)) {
+    if (yuv_rgb_supported(dst_format)) {
+        YUVToRGBJob job;
+
+        job.src_format = src_format;
+        job.dst_format = dst_format;
+        job.width = width;
+        job.height = height;
+        job.y = y;
+        job.u = u;
+        job.v = v;
+        job.y_stride = y_stride;
+        job.uv_stride = uv_stride;
+        job.rgb = (Uint8 *)dst;
+        job.rgb_stride = dst_pitch;
+        job.yuv_type = yuv_type;
+        job.bands = GetYUVConversionBands(width, height);
+        job.band_rows = (height / job.bands) & ~1;
+        job.scratch = NULL;
+        if (Is16BitYUVFormat(src_format)) {
+            job.scratch = (Uint8 *)SDL_malloc(job.bands * GetYUV420Size(width, YUV16_CHUNK_ROWS));
+            if (job.scratch == NULL) {
+                return SDL_OutOfMemory();
+            }
+        }
+        SDL_RunOnWorkers(yuv_rgb_band, &job, job.bands);
+        SDL_free(job.scratch);
         return 0;
     }
 
@@ -454,17 +1197,42 @@ struct RGB2YUVFactors
     float v[3]; /* Rfactor, Gfactor, Bfactor */
 };
 
-static int
-SDL_ConvertPixels_ARGB8888_to_YUV(int width, int height, const void *src, int src_pitch, Uint32 dst_format, void *dst, int dst_pitch)
-{
-    const int src_pitch_x_2    = src_pitch * 2;
-    const int height_half      = height / 2;
-    const int height_remainder = (height & 0x1);
-    const int width_half       = width / 2;
-    const int width_remainder  = (width & 0x1);
-    int i, j;
- 
-    static struct RGB2YUVFactors RGB2YUVFactorTables[SDL_YUV_CONVERSION_BT709 + 1] =
+/* The RGB to YUV conversion is done in fixed point, with this many
+   fractional bits, so the scalar and SIMD code give identical results.
+   The coefficients and the (r, g) pairs both fit in 16 bits. */
+#define RGB2YUV_SHIFT   14
+
+typedef struct
+{
+    /* Where each channel lives in a 32-bit source pixel */
+    int r_shift, g_shift, b_shift;
+    int y[3], u[3], v[3];
+    int y_offset;
+} RGB2YUVParams;
+
+/* How the Y, U and V values are laid out in the destination */
+typedef enum
+{
+    RGB2YUV_PLANES,     /* YV12, IYUV */
+    RGB2YUV_UV,         /* NV12 */
+    RGB2YUV_VU,         /* NV21 */
+    RGB2YUV_YUYV,       /* YUY2 */
+    RGB2YUV_UYVY,       /* UYVY */
+    RGB2YUV_YVYU        /* YVYU */
+} RGB2YUVLayout;
+
+/* Converts a pair of rows, row1 is the same as row0 for the last row of an
+   odd height image and for the packed formats. y1 is NULL if it shouldn't be
+   written, and for the interleaved layouts u points at the UV plane or
+   packed pixels. Returns how many pixels were converted, always even. */
+typedef int (*RGB2YUVFunc)(const Uint8 *row0, const Uint8 *row1, int width,
+                           Uint8 *y0, Uint8 *y1, Uint8 *u, Uint8 *v,
+                           RGB2YUVLayout layout, const RGB2YUVParams *p);
+
+static SDL_bool
+GetRGB2YUVParams(int width, int height, Uint32 src_format, RGB2YUVParams *params)
+{
+    static const struct RGB2YUVFactors RGB2YUVFactorTables[SDL_YUV_CONVERSION_BT709 + 1] =
     {
         /* ITU-T T.871 (JPEG) */
         {
@@ -489,54 +1257,452 @@ SDL_ConvertPixels_ARGB8888_to_YUV(int width, int height, const void *src, int sr
         },
     };
     const struct RGB2YUVFactors *cvt = &RGB2YUVFactorTables[SDL_GetYUVConversionModeForResolution(width, height)];
+    Uint32 Rmask, Gmask, Bmask, Amask;
+    int bpp, i;
+
+    /* Any 32-bit format with 8-bit channels can be read directly */
+    if (!SDL_PixelFormatEnumToMasks(src_format, &bpp, &Rmask, &Gmask, &Bmask, &Amask) || bpp != 32) {
+        return SDL_FALSE;
+    }
+    for (i = 0; i < 32; i += 8) {
+        if (Rmask == (0xFFu << i)) {
+            params->r_shift = i;
+        }
+        if (Gmask == (0xFFu << i)) {
+            params->g_shift = i;
+        }
+        if (Bmask == (0xFFu << i)) {
+            params->b_shift = i;
+        }
+    }
+    if (Rmask != (0xFFu << params->r_shift) ||
+        Gmask != (0xFFu << params->g_shift) ||
+        Bmask != (0xFFu << params->b_shift)) {
+        return SDL_FALSE;
+    }
+
+    for (i = 0; i < 3; ++i) {
+        params->y[i] = (int)SDL_floor(cvt->y[i] * (1 << RGB2YUV_SHIFT) + 0.5);
+        params->u[i] = (int)SDL_floor(cvt->u[i] * (1 << RGB2YUV_SHIFT) + 0.5);
+        params->v[i] = (int)SDL_floor(cvt->v[i] * (1 << RGB2YUV_SHIFT) + 0.5);
+    }
+    params->y_offset = cvt->y_offset;
+    return SDL_TRUE;
+}
+
+static SDL_INLINE Uint8
+RGB2YUV_Dot(const int *factors, int offset, int r, int g, int b)
+{
+    int value = factors[0] * r + factors[1] * g + factors[2] * b;
+    value = (value + (offset << RGB2YUV_SHIFT) + (1 << (RGB2YUV_SHIFT - 1))) >> RGB2YUV_SHIFT;
+    return (Uint8)SDL_max(0, SDL_min(value, 255));
+}
+
+#define RGB2YUV_CHANNEL(pixel, shift)   (((pixel) >> (shift)) & 0xFF)
+#define RGB2YUV_Y(pixel) \
+    RGB2YUV_Dot(p->y, p->y_offset, RGB2YUV_CHANNEL(pixel, p->r_shift), \
+                RGB2YUV_CHANNEL(pixel, p->g_shift), RGB2YUV_CHANNEL(pixel, p->b_shift))
+
+static void
+RGB2YUV_std(const Uint8 *row0, const Uint8 *row1, int x, int width,
+            Uint8 *y0, Uint8 *y1, Uint8 *u, Uint8 *v,
+            RGB2YUVLayout layout, const RGB2YUVParams *p)
+{
+    const Uint32 *src0 = (const Uint32 *)row0;
+    const Uint32 *src1 = (const Uint32 *)row1;
+
+    for (; x < width; x += 2) {
+        /* The last column of an odd width image is used twice */
+        const int x1 = (x + 1 < width) ? (x + 1) : x;
+        const Uint32 p00 = src0[x], p01 = src0[x1];
+        const Uint32 p10 = src1[x], p11 = src1[x1];
+        const int r = (RGB2YUV_CHANNEL(p00, p->r_shift) + RGB2YUV_CHANNEL(p01, p->r_shift) +
+                       RGB2YUV_CHANNEL(p10, p->r_shift) + RGB2YUV_CHANNEL(p11, p->r_shift)) >> 2;
+        const int g = (RGB2YUV_CHANNEL(p00, p->g_shift) + RGB2YUV_CHANNEL(p01, p->g_shift) +
+                       RGB2YUV_CHANNEL(p10, p->g_shift) + RGB2YUV_CHANNEL(p11, p->g_shift)) >> 2;
+        const int b = (RGB2YUV_CHANNEL(p00, p->b_shift) + RGB2YUV_CHANNEL(p01, p->b_shift) +
+                       RGB2YUV_CHANNEL(p10, p->b_shift) + RGB2YUV_CHANNEL(p11, p->b_shift)) >> 2;
+        const Uint8 U = RGB2YUV_Dot(p->u, 128, r, g, b);
+        const Uint8 V = RGB2YUV_Dot(p->v, 128, r, g, b);
+        Uint8 *packed = y0 + 2 * x;
+
+        switch (layout) {
+        case RGB2YUV_PLANES:
+            u[x / 2] = U;
+            v[x / 2] = V;
+            break;
+        case RGB2YUV_UV:
+            u[x] = U;
+            u[x + 1] = V;
+            break;
+        case RGB2YUV_VU:
+            u[x] = V;
+            u[x + 1] = U;
+            break;
+        case RGB2YUV_YUYV:
+            packed[0] = RGB2YUV_Y(p00);
+            packed[1] = U;
+            packed[2] = RGB2YUV_Y(p01);
+            packed[3] = V;
+            continue;
+        case RGB2YUV_UYVY:
+            packed[0] = U;
+            packed[1] = RGB2YUV_Y(p00);
+            packed[2] = V;
+            packed[3] = RGB2YUV_Y(p01);
+            continue;
+        case RGB2YUV_YVYU:
+            packed[0] = RGB2YUV_Y(p00);
+            packed[1] = V;
+            packed[2] = RGB2YUV_Y(p01);
+            packed[3] = U;
+            continue;
+        }
+
+        y0[x] = RGB2YUV_Y(p00);
+        y0[x1] = RGB2YUV_Y(p01);
+        if (y1) {
+            y1[x] = RGB2YUV_Y(p10);
+            y1[x1] = RGB2YUV_Y(p11);
+        }
+    }
+}
+
+#if HAVE_SSE2_INTRINSICS || HAVE_AVX2_INTRINSICS
+/* Stores 16 Y values from each row and the 8 U and V values between them */
+static SDL_INLINE void
+RGB2YUV_StoreSSE2(__m128i Y0, __m128i Y1, __m128i U, __m128i V, int x,
+                  Uint8 *y0, Uint8 *y1, Uint8 *u, Uint8 *v, RGB2YUVLayout layout)
+{
+    __m128i chroma;
+
+    switch (layout) {
+    case RGB2YUV_PLANES:
+        _mm_storel_epi64((__m128i *)(u + x / 2), U);
+        _mm_storel_epi64((__m128i *)(v + x / 2), V);
+        break;
+    case RGB2YUV_UV:
+        _mm_storeu_si128((__m128i *)(u + x), _mm_unpacklo_epi8(U, V));
+        break;
+    case RGB2YUV_VU:
+        _mm_storeu_si128((__m128i *)(u + x), _mm_unpacklo_epi8(V, U));
+        break;
+    case RGB2YUV_YUYV:
+        chroma = _mm_unpacklo_epi8(U, V);
+        _mm_storeu_si128((__m128i *)(y0 + 2 * x), _mm_unpacklo_epi8(Y0, chroma));
+        _mm_storeu_si128((__m128i *)(y0 + 2 * x + 16), _mm_unpackhi_epi8(Y0, chroma));
+        return;
+    case RGB2YUV_UYVY:
+        chroma = _mm_unpacklo_epi8(U, V);
+        _mm_storeu_si128((__m128i *)(y0 + 2 * x), _mm_unpacklo_epi8(chroma, Y0));
+        _mm_storeu_si128((__m128i *)(y0 + 2 * x + 16), _mm_unpackhi_epi8(chroma, Y0));
+        return;
+    case RGB2YUV_YVYU:
+        chroma = _mm_unpacklo_epi8(V, U);
+        _mm_storeu_si128((__m128i *)(y0 + 2 * x), _mm_unpacklo_epi8(Y0, chroma));
+        _mm_storeu_si128((__m128i *)(y0 + 2 * x + 16), _mm_unpackhi_epi8(Y0, chroma));
+        return;
+    }
+
+    _mm_storeu_si128((__m128i *)(y0 + x), Y0);
+    if (y1) {
+        _mm_storeu_si128((__m128i *)(y1 + x), Y1);
+    }
+}
+#endif
+
+#if HAVE_SSE2_INTRINSICS
+/* Pairs up the 32-bit channel values as 16-bit (r, g) and (b, 1), so two
+   multiply-adds give r*fr + g*fg + b*fb + rounding in each lane */
+static SDL_INLINE __m128i
+RGB2YUV_DotSSE2(__m128i r, __m128i g, __m128i b, __m128i rg_factors, __m128i b_factors, __m128i offset)
+{
+    const __m128i rg = _mm_or_si128(r, _mm_slli_epi32(g, 16));
+    const __m128i b1 = _mm_or_si128(b, _mm_set1_epi32(1 << 16));
+    const __m128i sum = _mm_add_epi32(_mm_madd_epi16(rg, rg_factors), _mm_madd_epi16(b1, b_factors));
+    return _mm_srai_epi32(_mm_add_epi32(sum, offset), RGB2YUV_SHIFT);
+}
+
+static int
+RGB2YUV_SSE2(const Uint8 *row0, const Uint8 *row1, int width,
+             Uint8 *y0, Uint8 *y1, Uint8 *u, Uint8 *v,
+             RGB2YUVLayout layout, const RGB2YUVParams *p)
+{
+    const __m128i r_shift = _mm_cvtsi32_si128(p->r_shift);
+    const __m128i g_shift = _mm_cvtsi32_si128(p->g_shift);
+    const __m128i b_shift = _mm_cvtsi32_si128(p->b_shift);
+    const __m128i mask = _mm_set1_epi32(0xFF);
+    const __m128i ones = _mm_set1_epi16(1);
+    const __m128i round = _mm_set1_epi32((1 << (RGB2YUV_SHIFT - 1)) << 16);
+    const __m128i y_rg = _mm_set1_epi32((p->y[0] & 0xFFFF) | (p->y[1] << 16));
+    const __m128i y_b = _mm_or_si128(_mm_set1_epi32(p->y[2] & 0xFFFF), round);
+    const __m128i u_rg = _mm_set1_epi32((p->u[0] & 0xFFFF) | (p->u[1] << 16));
+    const __m128i u_b = _mm_or_si128(_mm_set1_epi32(p->u[2] & 0xFFFF), round);
+    const __m128i v_rg = _mm_set1_epi32((p->v[0] & 0xFFFF) | (p->v[1] << 16));
+    const __m128i v_b = _mm_or_si128(_mm_set1_epi32(p->v[2] & 0xFFFF), round);
+    const __m128i y_offset = _mm_set1_epi32(p->y_offset << RGB2YUV_SHIFT);
+    const __m128i uv_offset = _mm_set1_epi32(128 << RGB2YUV_SHIFT);
+    int x, i;
+
+    for (x = 0; x + 16 <= width; x += 16) {
+        __m128i r[2][4], g[2][4], b[2][4], y[2][4], R[2], G[2], B[2], Y0, Y1, U, V;
+
+        for (i = 0; i < 4; ++i) {
+            const __m128i a = _mm_loadu_si128((const __m128i *)(row0 + 4 * x) + i);
+            const __m128i c = _mm_loadu_si128((const __m128i *)(row1 + 4 * x) + i);
+            r[0][i] = _mm_and_si128(_mm_srl_epi32(a, r_shift), mask);
+            g[0][i] = _mm_and_si128(_mm_srl_epi32(a, g_shift), mask);
+            b[0][i] = _mm_and_si128(_mm_srl_epi32(a, b_shift), mask);
+            r[1][i] = _mm_and_si128(_mm_srl_epi32(c, r_shift), mask);
+            g[1][i] = _mm_and_si128(_mm_srl_epi32(c, g_shift), mask);
+            b[1][i] = _mm_and_si128(_mm_srl_epi32(c, b_shift), mask);
+            y[0][i] = RGB2YUV_DotSSE2(r[0][i], g[0][i], b[0][i], y_rg, y_b, y_offset);
+            y[1][i] = RGB2YUV_DotSSE2(r[1][i], g[1][i], b[1][i], y_rg, y_b, y_offset);
+        }
+        Y0 = _mm_packus_epi16(_mm_packs_epi32(y[0][0], y[0][1]), _mm_packs_epi32(y[0][2], y[0][3]));
+        Y1 = _mm_packus_epi16(_mm_packs_epi32(y[1][0], y[1][1]), _mm_packs_epi32(y[1][2], y[1][3]));
+
+        /* Sum the two rows, then the horizontal pairs, and average */
+        for (i = 0; i < 2; ++i) {
+            R[i] = _mm_packs_epi32(_mm_add_epi32(r[0][2 * i], r[1][2 * i]), _mm_add_epi32(r[0][2 * i + 1], r[1][2 * i + 1]));
+            G[i] = _mm_packs_epi32(_mm_add_epi32(g[0][2 * i], g[1][2 * i]), _mm_add_epi32(g[0][2 * i + 1], g[1][2 * i + 1]));
+            B[i] = _mm_packs_epi32(_mm_add_epi32(b[0][2 * i], b[1][2 * i]), _mm_add_epi32(b[0][2 * i + 1], b[1][2 * i + 1]));
+            R[i] = _mm_srli_epi32(_mm_madd_epi16(R[i], ones), 2);
+            G[i] = _mm_srli_epi32(_mm_madd_epi16(G[i], ones), 2);
+            B[i] = _mm_srli_epi32(_mm_madd_epi16(B[i], ones), 2);
+        }
+        U = _mm_packs_epi32(RGB2YUV_DotSSE2(R[0], G[0], B[0], u_rg, u_b, uv_offset),
+                            RGB2YUV_DotSSE2(R[1], G[1], B[1], u_rg, u_b, uv_offset));
+        V = _mm_packs_epi32(RGB2YUV_DotSSE2(R[0], G[0], B[0], v_rg, v_b, uv_offset),
+                            RGB2YUV_DotSSE2(R[1], G[1], B[1], v_rg, v_b, uv_offset));
+        U = _mm_packus_epi16(U, U);
+        V = _mm_packus_epi16(V, V);
+
+        RGB2YUV_StoreSSE2(Y0, Y1, U, V, x, y0, y1, u, v, layout);
+    }
+    return x;
+}
+#endif /* HAVE_SSE2_INTRINSICS */
+
+#if HAVE_AVX2_INTRINSICS
+SDL_TARGETING("avx2") static SDL_INLINE __m256i
+RGB2YUV_DotAVX2(__m256i r, __m256i g, __m256i b, __m256i rg_factors, __m256i b_factors, __m256i offset)
+{
+    const __m256i rg = _mm256_or_si256(r, _mm256_slli_epi32(g, 16));
+    const __m256i b1 = _mm256_or_si256(b, _mm256_set1_epi32(1 << 16));
+    const __m256i sum = _mm256_add_epi32(_mm256_madd_epi16(rg, rg_factors), _mm256_madd_epi16(b1, b_factors));
+    return _mm256_srai_epi32(_mm256_add_epi32(sum, offset), RGB2YUV_SHIFT);
+}
+
+SDL_TARGETING("avx2") static int
+RGB2YUV_AVX2(const Uint8 *row0, const Uint8 *row1, int width,
+             Uint8 *y0, Uint8 *y1, Uint8 *u, Uint8 *v,
+             RGB2YUVLayout layout, const RGB2YUVParams *p)
+{
+    const __m128i r_shift = _mm_cvtsi32_si128(p->r_shift);
+    const __m128i g_shift = _mm_cvtsi32_si128(p->g_shift);
+    const __m128i b_shift = _mm_cvtsi32_si128(p->b_shift);
+    const __m256i mask = _mm256_set1_epi32(0xFF);
+    const __m256i ones = _mm256_set1_epi16(1);
+    const __m256i round = _mm256_set1_epi32((1 << (RGB2YUV_SHIFT - 1)) << 16);
+    const __m256i y_rg = _mm256_set1_epi32((p->y[0] & 0xFFFF) | (p->y[1] << 16));
+    const __m256i y_b = _mm256_or_si256(_mm256_set1_epi32(p->y[2] & 0xFFFF), round);
+    const __m256i u_rg = _mm256_set1_epi32((p->u[0] & 0xFFFF) | (p->u[1] << 16));
+    const __m256i u_b = _mm256_or_si256(_mm256_set1_epi32(p->u[2] & 0xFFFF), round);
+    const __m256i v_rg = _mm256_set1_epi32((p->v[0] & 0xFFFF) | (p->v[1] << 16));
+    const __m256i v_b = _mm256_or_si256(_mm256_set1_epi32(p->v[2] & 0xFFFF), round);
+    const __m256i y_offset = _mm256_set1_epi32(p->y_offset << RGB2YUV_SHIFT);
+    const __m256i uv_offset = _mm256_set1_epi32(128 << RGB2YUV_SHIFT);
+    int x, i;
+
+    for (x = 0; x + 16 <= width; x += 16) {
+        __m256i r[2][2], g[2][2], b[2][2], y[2], R, G, B, UV;
+        __m128i Y[2], U, V;
+
+        for (i = 0; i < 2; ++i) {
+            const __m256i a = _mm256_loadu_si256((const __m256i *)(row0 + 4 * x) + i);
+            const __m256i c = _mm256_loadu_si256((const __m256i *)(row1 + 4 * x) + i);
+            r[0][i] = _mm256_and_si256(_mm256_srl_epi32(a, r_shift), mask);
+            g[0][i] = _mm256_and_si256(_mm256_srl_epi32(a, g_shift), mask);
+            b[0][i] = _mm256_and_si256(_mm256_srl_epi32(a, b_shift), mask);
+            r[1][i] = _mm256_and_si256(_mm256_srl_epi32(c, r_shift), mask);
+            g[1][i] = _mm256_and_si256(_mm256_srl_epi32(c, g_shift), mask);
+            b[1][i] = _mm256_and_si256(_mm256_srl_epi32(c, b_shift), mask);
+        }
+        for (i = 0; i < 2; ++i) {
+            y[0] = RGB2YUV_DotAVX2(r[i][0], g[i][0], b[i][0], y_rg, y_b, y_offset);
+            y[1] = RGB2YUV_DotAVX2(r[i][1], g[i][1], b[i][1], y_rg, y_b, y_offset);
+            /* packs works within 128-bit lanes, so put the quarters back in order */
+            y[0] = _mm256_permute4x64_epi64(_mm256_packs_epi32(y[0], y[1]), 0xD8);
+            Y[i] = _mm_packus_epi16(_mm256_castsi256_si128(y[0]), _mm256_extracti128_si256(y[0], 1));
+        }
+
+        /* Sum the two rows, then the horizontal pairs, and average. The
+           chroma ends up in the order 0 1 4 5 2 3 6 7, fixed up below. */
+        R = _mm256_packs_epi32(_mm256_add_epi32(r[0][0], r[1][0]), _mm256_add_epi32(r[0][1], r[1][1]));
+        G = _mm256_packs_epi32(_mm256_add_epi32(g[0][0], g[1][0]), _mm256_add_epi32(g[0][1], g[1][1]));
+        B = _mm256_packs_epi32(_mm256_add_epi32(b[0][0], b[1][0]), _mm256_add_epi32(b[0][1], b[1][1]));
+        R = _mm256_srli_epi32(_mm256_madd_epi16(R, ones), 2);
+        G = _mm256_srli_epi32(_mm256_madd_epi16(G, ones), 2);
+        B = _mm256_srli_epi32(_mm256_madd_epi16(B, ones), 2);
+        UV = _mm256_packs_epi32(RGB2YUV_DotAVX2(R, G, B, u_rg, u_b, uv_offset),
+                                RGB2YUV_DotAVX2(R, G, B, v_rg, v_b, uv_offset));
+        U = _mm256_castsi256_si128(UV);
+        V = _mm256_extracti128_si256(UV, 1);
+        U = _mm_packus_epi16(_mm_unpacklo_epi32(U, V), _mm_unpackhi_epi32(U, V));
+        V = _mm_srli_si128(U, 8);
+
+        RGB2YUV_StoreSSE2(Y[0], Y[1], U, V, x, y0, y1, u, v, layout);
+    }
+    return x;
+}
+#endif /* HAVE_AVX2_INTRINSICS */
+
+#if HAVE_NEON_INTRINSICS && SDL_BYTEORDER == SDL_LIL_ENDIAN
+static SDL_INLINE int32x4_t
+RGB2YUV_DotNEON(int16x4_t r, int16x4_t g, int16x4_t b, const int *factors, int offset)
+{
+    int32x4_t sum = vdupq_n_s32((offset << RGB2YUV_SHIFT) + (1 << (RGB2YUV_SHIFT - 1)));
+    sum = vmlal_n_s16(sum, r, (int16_t)factors[0]);
+    sum = vmlal_n_s16(sum, g, (int16_t)factors[1]);
+    sum = vmlal_n_s16(sum, b, (int16_t)factors[2]);
+    return vshrq_n_s32(sum, RGB2YUV_SHIFT);
+}
+
+/* Converts 8 sets of 16-bit r, g and b values */
+static SDL_INLINE uint8x8_t
+RGB2YUV_Dot8NEON(uint16x8_t r, uint16x8_t g, uint16x8_t b, const int *factors, int offset)
+{
+    const int16x8_t R = vreinterpretq_s16_u16(r);
+    const int16x8_t G = vreinterpretq_s16_u16(g);
+    const int16x8_t B = vreinterpretq_s16_u16(b);
+    const int32x4_t lo = RGB2YUV_DotNEON(vget_low_s16(R), vget_low_s16(G), vget_low_s16(B), factors, offset);
+    const int32x4_t hi = RGB2YUV_DotNEON(vget_high_s16(R), vget_high_s16(G), vget_high_s16(B), factors, offset);
+    return vqmovn_u16(vcombine_u16(vqmovun_s32(lo), vqmovun_s32(hi)));
+}
+
+static SDL_INLINE uint8x16_t
+RGB2YUV_LumaNEON(uint8x16_t r, uint8x16_t g, uint8x16_t b, const RGB2YUVParams *p)
+{
+    const uint8x8_t lo = RGB2YUV_Dot8NEON(vmovl_u8(vget_low_u8(r)), vmovl_u8(vget_low_u8(g)), vmovl_u8(vget_low_u8(b)), p->y, p->y_offset);
+    const uint8x8_t hi = RGB2YUV_Dot8NEON(vmovl_u8(vget_high_u8(r)), vmovl_u8(vget_high_u8(g)), vmovl_u8(vget_high_u8(b)), p->y, p->y_offset);
+    return vcombine_u8(lo, hi);
+}
+
+static int
+RGB2YUV_NEON(const Uint8 *row0, const Uint8 *row1, int width,
+             Uint8 *y0, Uint8 *y1, Uint8 *u, Uint8 *v,
+             RGB2YUVLayout layout, const RGB2YUVParams *p)
+{
+    /* On little endian the channel at bit N is byte N/8 of the pixel */
+    const int r_index = p->r_shift / 8;
+    const int g_index = p->g_shift / 8;
+    const int b_index = p->b_shift / 8;
+    int x;
+
+    for (x = 0; x + 16 <= width; x += 16) {
+        const uint8x16x4_t a = vld4q_u8(row0 + 4 * x);
+        const uint8x16x4_t c = vld4q_u8(row1 + 4 * x);
+        const uint8x16_t Y0 = RGB2YUV_LumaNEON(a.val[r_index], a.val[g_index], a.val[b_index], p);
+        uint16x8_t R, G, B;
+        uint8x8_t U, V;
+        uint8x8x2_t chroma, luma;
+        uint8x8x4_t packed;
+
+        /* Sum the horizontal pairs, then the two rows, and average */
+        R = vshrq_n_u16(vpadalq_u8(vpaddlq_u8(a.val[r_index]), c.val[r_index]), 2);
+        G = vshrq_n_u16(vpadalq_u8(vpaddlq_u8(a.val[g_index]), c.val[g_index]), 2);
+        B = vshrq_n_u16(vpadalq_u8(vpaddlq_u8(a.val[b_index]), c.val[b_index]), 2);
+        U = RGB2YUV_Dot8NEON(R, G, B, p->u, 128);
+        V = RGB2YUV_Dot8NEON(R, G, B, p->v, 128);
+
+        switch (layout) {
+        case RGB2YUV_PLANES:
+            vst1_u8(u + x / 2, U);
+            vst1_u8(v + x / 2, V);
+            break;
+        case RGB2YUV_UV:
+            chroma.val[0] = U;
+            chroma.val[1] = V;
+            vst2_u8(u + x, chroma);
+            break;
+        case RGB2YUV_VU:
+            chroma.val[0] = V;
+            chroma.val[1] = U;
+            vst2_u8(u + x, chroma);
+            break;
+        case RGB2YUV_YUYV:
+        case RGB2YUV_UYVY:
+        case RGB2YUV_YVYU:
+            /* Split the Y values into even and odd pixels */
+            luma = vuzp_u8(vget_low_u8(Y0), vget_high_u8(Y0));
+            if (layout == RGB2YUV_YUYV) {
+                packed.val[0] = luma.val[0];
+                packed.val[1] = U;
+                packed.val[2] = luma.val[1];
+                packed.val[3] = V;
+            } else if (layout == RGB2YUV_UYVY) {
+                packed.val[0] = U;
+                packed.val[1] = luma.val[0];
+                packed.val[2] = V;
+                packed.val[3] = luma.val[1];
+            } else {
+                packed.val[0] = luma.val[0];
+                packed.val[1] = V;
+                packed.val[2] = luma.val[1];
+                packed.val[3] = U;
+            }
+            vst4_u8(y0 + 2 * x, packed);
+            continue;
+        }
+
+        vst1q_u8(y0 + x, Y0);
+        if (y1) {
+            vst1q_u8(y1 + x, RGB2YUV_LumaNEON(c.val[r_index], c.val[g_index], c.val[b_index], p));
+        }
+    }
+    return x;
+}
+#endif /* HAVE_NEON_INTRINSICS */
+
+static RGB2YUVFunc
+RGB2YUV_ChooseFunc(void)
+{
+#if HAVE_AVX2_INTRINSICS
+    if (SDL_HasAVX2()) {
+        return RGB2YUV_AVX2;
+    }
+#endif
+#if HAVE_SSE2_INTRINSICS
+    if (SDL_HasSSE2()) {
+        return RGB2YUV_SSE2;
+    }
+#endif
+#if HAVE_NEON_INTRINSICS && SDL_BYTEORDER == SDL_LIL_ENDIAN
+    if (SDL_HasNEON()) {
+        return RGB2YUV_NEON;
+    }
+#endif
+    return NULL;
+}
 
-#define MAKE_Y(r, g, b) (Uint8)((int)(cvt->y[0] * (r) + cvt->y[1] * (g) + cvt->y[2] * (b) + 0.5f) + cvt->y_offset)
-#define MAKE_U(r, g, b) (Uint8)((int)(cvt->u[0] * (r) + cvt->u[1] * (g) + cvt->u[2] * (b) + 0.5f) + 128)
-#define MAKE_V(r, g, b) (Uint8)((int)(cvt->v[0] * (r) + cvt->v[1] * (g) + cvt->v[2] * (b) + 0.5f) + 128)
-
-#define READ_2x2_PIXELS                                                                                         \
-        const Uint32 p1 = ((const Uint32 *)curr_row)[2 * i];                                                    \
-        const Uint32 p2 = ((const Uint32 *)curr_row)[2 * i + 1];                                                \
-        const Uint32 p3 = ((const Uint32 *)next_row)[2 * i];                                                    \
-        const Uint32 p4 = ((const Uint32 *)next_row)[2 * i + 1];                                                \
-        const Uint32 r = ((p1 & 0x00ff0000) + (p2 & 0x00ff0000) + (p3 & 0x00ff0000) + (p4 & 0x00ff0000)) >> 18; \
-        const Uint32 g = ((p1 & 0x0000ff00) + (p2 & 0x0000ff00) + (p3 & 0x0000ff00) + (p4 & 0x0000ff00)) >> 10; \
-        const Uint32 b = ((p1 & 0x000000ff) + (p2 & 0x000000ff) + (p3 & 0x000000ff) + (p4 & 0x000000ff)) >> 2;  \
-
-#define READ_2x1_PIXELS                                                                                         \
-        const Uint32 p1 = ((const Uint32 *)curr_row)[2 * i];                                                    \
-        const Uint32 p2 = ((const Uint32 *)next_row)[2 * i];                                                    \
-        const Uint32 r = ((p1 & 0x00ff0000) + (p2 & 0x00ff0000)) >> 17;                                         \
-        const Uint32 g = ((p1 & 0x0000ff00) + (p2 & 0x0000ff00)) >> 9;                                          \
-        const Uint32 b = ((p1 & 0x000000ff) + (p2 & 0x000000ff)) >> 1;                                          \
-
-#define READ_1x2_PIXELS                                                                                         \
-        const Uint32 p1 = ((const Uint32 *)curr_row)[2 * i];                                                    \
-        const Uint32 p2 = ((const Uint32 *)curr_row)[2 * i + 1];                                                \
-        const Uint32 r = ((p1 & 0x00ff0000) + (p2 & 0x00ff0000)) >> 17;                                         \
-        const Uint32 g = ((p1 & 0x0000ff00) + (p2 & 0x0000ff00)) >> 9;                                          \
-        const Uint32 b = ((p1 & 0x000000ff) + (p2 & 0x000000ff)) >> 1;                                          \
-
-#define READ_1x1_PIXEL                                                                                          \
-        const Uint32 p = ((const Uint32 *)curr_row)[2 * i];                                                     \
-        const Uint32 r = (p & 0x00ff0000) >> 16;                                                                \
-        const Uint32 g = (p & 0x0000ff00) >> 8;                                                                 \
-        const Uint32 b = (p & 0x000000ff);                                                                      \
-
-#define READ_TWO_RGB_PIXELS                                                                                     \
-        const Uint32 p = ((const Uint32 *)curr_row)[2 * i];                                                     \
-        const Uint32 r = (p & 0x00ff0000) >> 16;                                                                \
-        const Uint32 g = (p & 0x0000ff00) >> 8;                                                                 \
-        const Uint32 b = (p & 0x000000ff);                                                                      \
-        const Uint32 p1 = ((const Uint32 *)curr_row)[2 * i + 1];                                                \
-        const Uint32 r1 = (p1 & 0x00ff0000) >> 16;                                                              \
-        const Uint32 g1 = (p1 & 0x0000ff00) >> 8;                                                               \
-        const Uint32 b1 = (p1 & 0x000000ff);                                                                    \
-        const Uint32 R = (r + r1)/2;                                                                            \
-        const Uint32 G = (g + g1)/2;                                                                            \
-        const Uint32 B = (b + b1)/2;                                                                            \
-
-#define READ_ONE_RGB_PIXEL  READ_1x1_PIXEL
+static int
+SDL_ConvertPixels_RGB32_to_YUV(int width, int height, const RGB2YUVParams *params,
+                               const void *src, int src_pitch,
+                               Uint32 dst_format, void *dst, int dst_pitch)
+{
+    const RGB2YUVFunc convert = RGB2YUV_ChooseFunc();
+    RGB2YUVLayout layout;
+    int j;
+
+#define CONVERT_ROWS(row0, row1, y0, y1, u, v)                                  \
+    {                                                                           \
+        int x = 0;                                                              \
+        if (convert) {                                                          \
+            x = convert(row0, row1, width, y0, y1, u, v, layout, params);       \
+        }                                                                       \
+        RGB2YUV_std(row0, row1, x, width, y0, y1, u, v, layout, params);        \
+    }
 
     switch (dst_format) 
     {
@@ -545,135 +1711,34 @@ SDL_ConvertPixels_ARGB8888_to_YUV(int width, int height, const void *src, int sr
     case SDL_PIXELFORMAT_NV12:
     case SDL_PIXELFORMAT_NV21:
         {
-            const Uint8 *curr_row, *next_row;
-            
             Uint8 *plane_y;
             Uint8 *plane_u;
             Uint8 *plane_v;
-            Uint8 *plane_interleaved_uv;
-            Uint32 y_stride, uv_stride, y_skip, uv_skip;
-
-            GetYUVPlanes(width, height, dst_format, dst, dst_pitch,
-                         (const Uint8 **)&plane_y, (const Uint8 **)&plane_u, (const Uint8 **)&plane_v,
-                         &y_stride, &uv_stride);
-            plane_interleaved_uv = (plane_y + height * y_stride);
-            y_skip = (y_stride - width);
+            Uint32 y_stride, uv_stride;
 
-            curr_row = (const Uint8*)src;
-
-            /* Write Y plane */
-            for (j = 0; j < height; j++) {
-                for (i = 0; i < width; i++) {
-                    const Uint32 p1 = ((const Uint32 *)curr_row)[i];
-                    const Uint32 r = (p1 & 0x00ff0000) >> 16;
-                    const Uint32 g = (p1 & 0x0000ff00) >> 8;
-                    const Uint32 b = (p1 & 0x000000ff);
-                    *plane_y++ = MAKE_Y(r, g, b);
-                }
-                plane_y += y_skip;
-                curr_row += src_pitch;
+            if (GetYUVPlanes(width, height, dst_format, dst, dst_pitch,
+                             (const Uint8 **)&plane_y, (const Uint8 **)&plane_u, (const Uint8 **)&plane_v,
+                             &y_stride, &uv_stride) < 0) {
+                return -1;
             }
 
-            curr_row = (const Uint8*)src;
-            next_row = (const Uint8*)src;
-            next_row += src_pitch;
-
-            if (dst_format == SDL_PIXELFORMAT_YV12 || dst_format == SDL_PIXELFORMAT_IYUV)
-            {
-                /* Write UV planes, not interleaved */
-                uv_skip = (uv_stride - (width + 1)/2);
-                for (j = 0; j < height_half; j++) {
-                    for (i = 0; i < width_half; i++) {
-                        READ_2x2_PIXELS;
-                        *plane_u++ = MAKE_U(r, g, b);
-                        *plane_v++ = MAKE_V(r, g, b);
-                    }
-                    if (width_remainder) {
-                        READ_2x1_PIXELS;
-                        *plane_u++ = MAKE_U(r, g, b);
-                        *plane_v++ = MAKE_V(r, g, b);
-                    }
-                    plane_u += uv_skip;
-                    plane_v += uv_skip;
-                    curr_row += src_pitch_x_2;
-                    next_row += src_pitch_x_2;
-                }
-                if (height_remainder) {
-                    for (i = 0; i < width_half; i++) {
-                        READ_1x2_PIXELS;
-                        *plane_u++ = MAKE_U(r, g, b);
-                        *plane_v++ = MAKE_V(r, g, b);
-                    }
-                    if (width_remainder) {
-                        READ_1x1_PIXEL;
-                        *plane_u++ = MAKE_U(r, g, b);
-                        *plane_v++ = MAKE_V(r, g, b);
-                    }
-                    plane_u += uv_skip;
-                    plane_v += uv_skip;
-                }
+            if (dst_format == SDL_PIXELFORMAT_NV12 || dst_format == SDL_PIXELFORMAT_NV21) {
+                layout = (dst_format == SDL_PIXELFORMAT_NV12) ? RGB2YUV_UV : RGB2YUV_VU;
+                plane_u = plane_y + height * y_stride;
+                plane_v = NULL;
+            } else {
+                layout = RGB2YUV_PLANES;
             }
-            else if (dst_format == SDL_PIXELFORMAT_NV12)
-            {
-                uv_skip = (uv_stride - ((width + 1)/2)*2);
-                for (j = 0; j < height_half; j++) {
-                    for (i = 0; i < width_half; i++) {
-                        READ_2x2_PIXELS;
-                        *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                        *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                    }
-                    if (width_remainder) {
-                        READ_2x1_PIXELS;
-                        *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                        *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                    }
-                    plane_interleaved_uv += uv_skip;
-                    curr_row += src_pitch_x_2;
-                    next_row += src_pitch_x_2;
-                }
-                if (height_remainder) {
-                    for (i = 0; i < width_half; i++) {
-                        READ_1x2_PIXELS;
-                        *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                        *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                    }
-                    if (width_remainder) {
-                        READ_1x1_PIXEL;
-                        *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                        *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                    }
-                }
-            } 
-            else /* dst_format == SDL_PIXELFORMAT_NV21 */
-            {
-                uv_skip = (uv_stride - ((width + 1)/2)*2);
-                for (j = 0; j < height_half; j++) {
-                    for (i = 0; i < width_half; i++) {
-                        READ_2x2_PIXELS;
-                        *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                        *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                    }
-                    if (width_remainder) {
-                        READ_2x1_PIXELS;
-                        *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                        *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                    }
-                    plane_interleaved_uv += uv_skip;
-                    curr_row += src_pitch_x_2;
-                    next_row += src_pitch_x_2;
-                }
-                if (height_remainder) {
-                    for (i = 0; i < width_half; i++) {
-                        READ_1x2_PIXELS;
-                        *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                        *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                    }
-                    if (width_remainder) {
-                        READ_1x1_PIXEL;
-                        *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                        *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                    }
-                }
+
+            for (j = 0; j < height; j += 2) {
+                const Uint8 *row0 = (const Uint8 *)src + j * src_pitch;
+                const Uint8 *row1 = (j + 1 < height) ? (row0 + src_pitch) : row0;
+                Uint8 *y0 = plane_y + j * y_stride;
+                Uint8 *y1 = (j + 1 < height) ? (y0 + y_stride) : NULL;
+                Uint8 *u = plane_u + (j / 2) * uv_stride;
+                Uint8 *v = plane_v ? (plane_v + (j / 2) * uv_stride) : NULL;
+
+                CONVERT_ROWS(row0, row1, y0, y1, u, v);
             }
         }
         break;
@@ -682,85 +1747,26 @@ SDL_ConvertPixels_ARGB8888_to_YUV(int width, int height, const void *src, int sr
     case SDL_PIXELFORMAT_UYVY:
     case SDL_PIXELFORMAT_YVYU:
         {
-            const Uint8 *curr_row = (const Uint8*) src;
-            Uint8 *plane           = (Uint8*) dst;
             const int row_size = (4 * ((width + 1) / 2));
-            int plane_skip;
 
             if (dst_pitch < row_size) {
                 return SDL_SetError("Destination pitch is too small, expected at least %d\n", row_size);
             }
-            plane_skip = (dst_pitch - row_size);
-
-            /* Write YUV plane, packed */
-            if (dst_format == SDL_PIXELFORMAT_YUY2) 
-            {
-                for (j = 0; j < height; j++) {
-                    for (i = 0; i < width_half; i++) {
-                        READ_TWO_RGB_PIXELS;
-                        /* Y U Y1 V */
-                        *plane++ = MAKE_Y(r, g, b);
-                        *plane++ = MAKE_U(R, G, B);
-                        *plane++ = MAKE_Y(r1, g1, b1);
-                        *plane++ = MAKE_V(R, G, B);
-                    }
-                    if (width_remainder) {
-                        READ_ONE_RGB_PIXEL;
-                        /* Y U Y V */
-                        *plane++ = MAKE_Y(r, g, b);
-                        *plane++ = MAKE_U(r, g, b);
-                        *plane++ = MAKE_Y(r, g, b);
-                        *plane++ = MAKE_V(r, g, b);
-                    }
-                    plane += plane_skip;
-                    curr_row += src_pitch;
-                }
-            } 
-            else if (dst_format == SDL_PIXELFORMAT_UYVY)
-            {
-                for (j = 0; j < height; j++) {
-                    for (i = 0; i < width_half; i++) {
-                        READ_TWO_RGB_PIXELS;
-                        /* U Y V Y1 */
-                        *plane++ = MAKE_U(R, G, B);
-                        *plane++ = MAKE_Y(r, g, b);
-                        *plane++ = MAKE_V(R, G, B);
-                        *plane++ = MAKE_Y(r1, g1, b1);
-                    }
-                    if (width_remainder) {
-                        READ_ONE_RGB_PIXEL;
-                        /* U Y V Y */
-                        *plane++ = MAKE_U(r, g, b);
-                        *plane++ = MAKE_Y(r, g, b);
-                        *plane++ = MAKE_V(r, g, b);
-                        *plane++ = MAKE_Y(r, g, b);
-                    }
-                    plane += plane_skip;
-                    curr_row += src_pitch;
-                }
+
+            if (dst_format == SDL_PIXELFORMAT_YUY2) {
+                layout = RGB2YUV_YUYV;
+            } else if (dst_format == SDL_PIXELFORMAT_UYVY) {
+                layout = RGB2YUV_UYVY;
+            } else {
+                layout = RGB2YUV_YVYU;
             }
-            else if (dst_format == SDL_PIXELFORMAT_YVYU)
-            {
-                for (j = 0; j < height; j++) {
-                    for (i = 0; i < width_half; i++) {
-                        READ_TWO_RGB_PIXELS;
-                        /* Y V Y1 U */
-                        *plane++ = MAKE_Y(r, g, b);
-                        *plane++ = MAKE_V(R, G, B);
-                        *plane++ = MAKE_Y(r1, g1, b1);
-                        *plane++ = MAKE_U(R, G, B);
-                    }
-                    if (width_remainder) {
-                        READ_ONE_RGB_PIXEL;
-                        /* Y V Y U */
-                        *plane++ = MAKE_Y(r, g, b);
-                        *plane++ = MAKE_V(r, g, b);
-                        *plane++ = MAKE_Y(r, g, b);
-                        *plane++ = MAKE_U(r, g, b);
-                    }
-                    plane += plane_skip;
-                    curr_row += src_pitch;
-                }
+
+            /* Each row is its own pair, so the chroma averages horizontally */
+            for (j = 0; j < height; j++) {
+                const Uint8 *row = (const Uint8 *)src + j * src_pitch;
+                Uint8 *packed = (Uint8 *)dst + j * dst_pitch;
+
+                CONVERT_ROWS(row, row, packed, NULL, NULL, NULL);
             }
         }
         break;
@@ -768,15 +1774,7 @@ SDL_ConvertPixels_ARGB8888_to_YUV(int width, int height, const void *src, int sr
     default:
         return SDL_SetError("Unsupported YUV destination format: %s", SDL_GetPixelFormatName(dst_format));
     }
-#undef MAKE_Y
-#undef MAKE_U
-#undef MAKE_V
-#undef READ_2x2_PIXELS
-#undef READ_2x1_PIXELS
-#undef READ_1x2_PIXELS
-#undef READ_1x1_PIXEL
-#undef READ_TWO_RGB_PIXELS
-#undef READ_ONE_RGB_PIXEL
+#undef CONVERT_ROWS
     return 0;
 }
 
@@ -785,6 +1783,25 @@ SDL_ConvertPixels_RGB_to_YUV(int width, int height,
          Uint32 src_format, const void *src, int src_pitch,
          Uint32 dst_format, void *dst, int dst_pitch)
 {
+    RGB2YUVParams params;
+
+    if (Is16BitYUVFormat(dst_format)) {
+        /* Convert to the 8-bit format and widen that */
+        const Uint32 format = Get8BitYUVFormat(dst_format);
+        int ret;
+        void *tmp = SDL_malloc(GetYUV420Size(width, height));
+        if (tmp == NULL) {
+            return SDL_OutOfMemory();
+        }
+
+        ret = SDL_ConvertPixels_RGB_to_YUV(width, height, src_format, src, src_pitch, format, tmp, width);
+        if (ret == 0) {
+            ret = SDL_ConvertPixels_YUV8_to_YUV16(width, height, tmp, width, dst_format, dst, dst_pitch);
+        }
+        SDL_free(tmp);
+        return ret;
+    }
+
 #if 0 /* Doesn't handle odd widths */
     /* RGB24 to FOURCC */
     if (src_format == SDL_PIXELFORMAT_RGB24) {
@@ -808,12 +1825,12 @@ SDL_ConvertPixels_RGB_to_YUV(int width, int height,
     }
 #endif
 
-    /* ARGB8888 to FOURCC */
-    if (src_format == SDL_PIXELFORMAT_ARGB8888) {
-        return SDL_ConvertPixels_ARGB8888_to_YUV(width, height, src, src_pitch, dst_format, dst, dst_pitch);
+    /* 32-bit RGB formats to FOURCC */
+    if (GetRGB2YUVParams(width, height, src_format, &params)) {
+        return SDL_ConvertPixels_RGB32_to_YUV(width, height, &params, src, src_pitch, dst_format, dst, dst_pitch);
     }
 
-    /* not ARGB8888 to FOURCC : need an intermediate conversion */
+    /* not 32-bit RGB to FOURCC : need an intermediate conversion */
     {
         int ret;
         void *tmp;
@@ -832,7 +1849,8 @@ SDL_ConvertPixels_RGB_to_YUV(int width, int height,
         }
 
         /* convert tmp/ARGB8888 to dst/FOURCC */
-        ret = SDL_ConvertPixels_ARGB8888_to_YUV(width, height, tmp, tmp_pitch, dst_format, dst, dst_pitch);
+        GetRGB2YUVParams(width, height, SDL_PIXELFORMAT_ARGB8888, &params);
+        ret = SDL_ConvertPixels_RGB32_to_YUV(width, height, &params, tmp, tmp_pitch, dst_format, dst, dst_pitch);
         SDL_free(tmp);
         return ret;
     }
@@ -844,6 +1862,32 @@ SDL_ConvertPixels_YUV_to_YUV_Copy(int width, int height, Uint32 format,
 {
     int i;
 
+    if (Is16BitYUVFormat(format)) {
+        const Uint8 *src_y, *src_u, *src_v;
+        const Uint8 *dst_y, *dst_u, *dst_v;
+        Uint32 src_y_stride, src_uv_stride;
+        Uint32 dst_y_stride, dst_uv_stride;
+        const int uv_height = (height + 1) / 2;
+        /* I010 has a U and a V plane, the others one plane of U/V pairs */
+        const int uv_length = (format == SDL_PIXELFORMAT_I010) ? ((width + 1) / 2) * 2 : ((width + 1) / 2) * 4;
+
+        if (GetYUVPlanes(width, height, format, src, src_pitch, &src_y, &src_u, &src_v, &src_y_stride, &src_uv_stride) < 0 ||
+            GetYUVPlanes(width, height, format, dst, dst_pitch, &dst_y, &dst_u, &dst_v, &dst_y_stride, &dst_uv_stride) < 0) {
+            return -1;
+        }
+
+        for (i = 0; i < height; ++i) {
+            SDL_memcpy((Uint8 *)dst_y + i * dst_y_stride, src_y + i * src_y_stride, width * 2);
+        }
+        for (i = 0; i < uv_height; ++i) {
+            SDL_memcpy((Uint8 *)dst_u + i * dst_uv_stride, src_u + i * src_uv_stride, uv_length);
+            if (format == SDL_PIXELFORMAT_I010) {
+                SDL_memcpy((Uint8 *)dst_v + i * dst_uv_stride, src_v + i * src_uv_stride, uv_length);
+            }
+        }
+        return 0;
+    }
+
     if (IsPlanar2x2Format(format)) {
         /* Y plane */
         for (i = height; i--;) {
@@ -1806,6 +2850,140 @@ SDL_ConvertPixels_Packed4_to_Planar2x2(int width, int height,
     return 0;
 }
 
+/* Returns a 16-bit sample scaled to the full 16-bit range */
+static SDL_INLINE Uint16
+YUV16_ToFullRange(Uint32 format, Uint16 value)
+{
+    switch (format) {
+    case SDL_PIXELFORMAT_P010:
+        value &= 0xFFC0;
+        return value | (value >> 10);
+    case SDL_PIXELFORMAT_I010:
+        value &= 0x03FF;
+        return (Uint16)((value << 6) | (value >> 4));
+    default:
+        return value;
+    }
+}
+
+static SDL_INLINE Uint16
+YUV16_FromFullRange(Uint32 format, Uint16 value)
+{
+    switch (format) {
+    case SDL_PIXELFORMAT_P010:
+        return value & 0xFFC0;
+    case SDL_PIXELFORMAT_I010:
+        return value >> 6;
+    default:
+        return value;
+    }
+}
+
+static void
+YUV16_ConvertPlane(Uint32 src_format, const Uint8 *src, Uint32 src_stride, int src_step,
+                   Uint32 dst_format, Uint8 *dst, Uint32 dst_stride, int dst_step,
+                   int count, int rows)
+{
+    int i;
+
+    while (rows--) {
+        const Uint16 *s = (const Uint16 *)src;
+        Uint16 *d = (Uint16 *)dst;
+
+        for (i = 0; i < count; ++i) {
+            d[i * dst_step] = YUV16_FromFullRange(dst_format, YUV16_ToFullRange(src_format, s[i * src_step]));
+        }
+        src += src_stride;
+        dst += dst_stride;
+    }
+}
+
+static int
+SDL_ConvertPixels_YUV16_to_YUV16(int width, int height,
+         Uint32 src_format, const void *src, int src_pitch,
+         Uint32 dst_format, void *dst, int dst_pitch)
+{
+    const Uint8 *src_y, *src_u, *src_v;
+    const Uint8 *dst_y, *dst_u, *dst_v;
+    Uint32 src_y_stride, src_uv_stride;
+    Uint32 dst_y_stride, dst_uv_stride;
+    const int src_step = (src_format == SDL_PIXELFORMAT_I010) ? 1 : 2;
+    const int dst_step = (dst_format == SDL_PIXELFORMAT_I010) ? 1 : 2;
+    void *tmp = NULL;
+
+    if (src == dst && src_step != dst_step) {
+        /* Changing between planar and interleaved chroma needs a copy of the source */
+        const size_t size = (size_t)src_pitch * height + (size_t)((src_pitch + 3) & ~3) * ((height + 1) / 2);
+
+        tmp = SDL_malloc(size);
+        if (tmp == NULL) {
+            return SDL_OutOfMemory();
+        }
+        SDL_memcpy(tmp, src, size);
+        src = tmp;
+    }
+
+    if (GetYUVPlanes(width, height, src_format, src, src_pitch, &src_y, &src_u, &src_v, &src_y_stride, &src_uv_stride) < 0 ||
+        GetYUVPlanes(width, height, dst_format, dst, dst_pitch, &dst_y, &dst_u, &dst_v, &dst_y_stride, &dst_uv_stride) < 0) {
+        SDL_free(tmp);
+        return -1;
+    }
+
+    YUV16_ConvertPlane(src_format, src_y, src_y_stride, 1, dst_format, (Uint8 *)dst_y, dst_y_stride, 1, width, height);
+    YUV16_ConvertPlane(src_format, src_u, src_uv_stride, src_step, dst_format, (Uint8 *)dst_u, dst_uv_stride, dst_step, (width + 1) / 2, (height + 1) / 2);
+    YUV16_ConvertPlane(src_format, src_v, src_uv_stride, src_step, dst_format, (Uint8 *)dst_v, dst_uv_stride, dst_step, (width + 1) / 2, (height + 1) / 2);
+    SDL_free(tmp);
+    return 0;
+}
+
+static int
+SDL_ConvertPixels_YUV16_to_YUV(int width, int height,
+         Uint32 src_format, const void *src, int src_pitch,
+         Uint32 dst_format, void *dst, int dst_pitch)
+{
+    Uint32 format;
+    void *tmp;
+    int ret;
+
+    if (Is16BitYUVFormat(src_format) && Is16BitYUVFormat(dst_format)) {
+        return SDL_ConvertPixels_YUV16_to_YUV16(width, height, src_format, src, src_pitch, dst_format, dst, dst_pitch);
+    }
+
+    if (Is16BitYUVFormat(src_format)) {
+        format = Get8BitYUVFormat(src_format);
+        if (dst_format == format) {
+            return SDL_ConvertPixels_YUV16_to_YUV8(width, height, src_format, src, src_pitch, dst, dst_pitch);
+        }
+
+        /* Narrow to the 8-bit format and convert from that */
+        tmp = SDL_malloc(GetYUV420Size(width, height));
+        if (tmp == NULL) {
+            return SDL_OutOfMemory();
+        }
+        ret = SDL_ConvertPixels_YUV16_to_YUV8(width, height, src_format, src, src_pitch, tmp, width);
+        if (ret == 0) {
+            ret = SDL_ConvertPixels_YUV_to_YUV(width, height, format, tmp, width, dst_format, dst, dst_pitch);
+        }
+    } else {
+        format = Get8BitYUVFormat(dst_format);
+        if (src_format == format) {
+            return SDL_ConvertPixels_YUV8_to_YUV16(width, height, src, src_pitch, dst_format, dst, dst_pitch);
+        }
+
+        /* Convert to the 8-bit format and widen that */
+        tmp = SDL_malloc(GetYUV420Size(width, height));
+        if (tmp == NULL) {
+            return SDL_OutOfMemory();
+        }
+        ret = SDL_ConvertPixels_YUV_to_YUV(width, height, src_format, src, src_pitch, format, tmp, width);
+        if (ret == 0) {
+            ret = SDL_ConvertPixels_YUV8_to_YUV16(width, height, tmp, width, dst_format, dst, dst_pitch);
+        }
+    }
+    SDL_free(tmp);
+    return ret;
+}
+
 int
 SDL_ConvertPixels_YUV_to_YUV(int width, int height,
          Uint32 src_format, const void *src, int src_pitch,
@@ -1819,6 +2997,10 @@ SDL_ConvertPixels_YUV_to_YUV(int width, int height,
         return SDL_ConvertPixels_YUV_to_YUV_Copy(width, height, src_format, src, src_pitch, dst, dst_pitch);
     }
 
+    if (Is16BitYUVFormat(src_format) || Is16BitYUVFormat(dst_format)) {
+        return SDL_ConvertPixels_YUV16_to_YUV(width, height, src_format, src, src_pitch, dst_format, dst, dst_pitch);
+    }
+
     if (IsPlanar2x2Format(src_format) && IsPlanar2x2Format(dst_format)) {
         return SDL_ConvertPixels_Planar2x2_to_Planar2x2(width, height, src_format, src, src_pitch, dst_format, dst, dst_pitch);
     } else if (IsPacked4Format(src_format) && IsPacked4Format(dst_format)) {
@@ -31,6 +31,9 @@ extern int SDL_ConvertPixels_YUV_to_RGB(int width, int height, Uint32 src_format
 extern int SDL_ConvertPixels_RGB_to_YUV(int width, int height, Uint32 src_format, const void *src, int src_pitch, Uint32 dst_format, void *dst, int dst_pitch);
 extern int SDL_ConvertPixels_YUV_to_YUV(int width, int height, Uint32 src_format, const void *src, int src_pitch, Uint32 dst_format, void *dst, int dst_pitch);
 
+/* Find the planes of a contiguous YUV image as laid out by SDL_UpdateTexture() */
+extern int SDL_GetYUVPlaneLayout(int height, Uint32 format, void *yuv, int yuv_pitch, Uint8 *planes[3], int pitches[3]);
+
 #endif /* SDL_yuv_c_h_ */
 
 /* vi: set ts=4 sw=4 expandtab: */
@@ -22,11 +22,312 @@
 
 #if SDL_VIDEO_DRIVER_DUMMY
 
+#include "SDL_log.h"
+#include "SDL_mutex.h"
+#include "SDL_thread.h"
 #include "../SDL_sysvideo.h"
 #include "SDL_nullframebuffer_c.h"
 
 
 #define DUMMY_SURFACE   "_SDL_DummySurface"
+#define DUMMY_CAPTURE   "_SDL_DummyCapture"
+
+/* Frames are saved when SDL_VIDEO_DUMMY_SAVE_FRAMES is set and not empty.
+   The present only copies the frame into a free buffer and a thread per
+   window does the writing, controlled by these environment variables:
+
+   SDL_VIDEO_DUMMY_SAVE_FORMAT  "bmp" (default) for a BMP file per frame,
+                                "raw" for a stream of packed RGB24 frames,
+                                "y4m" for a YUV4MPEG2 stream of I420 frames.
+   SDL_VIDEO_DUMMY_SAVE_QUEUE   how many frames can wait to be written (4)
+   SDL_VIDEO_DUMMY_SAVE_DROP    if "1", frames are dropped and counted when
+                                the writer falls behind, instead of waiting.
+
+   Frames are numbered across all windows. Streams are named after the
+   window and their first frame, and a new one is started whenever the
+   window is resized. Saving stops at the first write that fails. The
+   window data named by DUMMY_FRAME holds the number of the last frame the
+   window presented, and DUMMY_DROPPED the number of frames it dropped, both
+   as integers cast to pointers.
+ */
+#define DUMMY_FRAME     "SDL_VIDEO_DUMMY_FRAME"
+#define DUMMY_DROPPED   "SDL_VIDEO_DUMMY_DROPPED_FRAMES"
+#define DUMMY_DEFAULT_QUEUE 4
+#define DUMMY_MAX_QUEUE     64
+
+typedef enum
+{
+    DUMMY_CAPTURE_BMP,
+    DUMMY_CAPTURE_RAW,
+    DUMMY_CAPTURE_Y4M
+} DUMMY_CaptureFormat;
+
+typedef struct
+{
+    SDL_Surface *surface;
+    int number;
+} DUMMY_Frame;
+
+typedef struct
+{
+    SDL_Thread *thread;
+    SDL_mutex *lock;        /* protects head, count, quit and failed */
+    SDL_cond *cond;         /* signaled when a frame is queued or written */
+    DUMMY_CaptureFormat format;
+    Uint32 window_id;
+    SDL_bool drop;
+    SDL_bool quit;
+    DUMMY_Frame frames[DUMMY_MAX_QUEUE];
+    int num_frames;
+    int head;               /* the oldest frame waiting to be written */
+    int count;              /* how many frames are waiting */
+    int dropped;
+    int written;
+    SDL_bool failed;        /* a write failed, so nothing more is queued */
+
+    /* Only used by the writer thread */
+    SDL_RWops *stream;
+    Uint8 *converted;       /* the frame in the format being written */
+} DUMMY_Capture;
+
+/* Returns -1 after logging why, if the frame couldn't be written */
+static int
+DUMMY_WriteFrame(DUMMY_Capture *capture, const DUMMY_Frame *frame)
+{
+    SDL_Surface *surface = frame->surface;
+    char file[128];
+    Uint32 format;
+    size_t size;
+
+    if (capture->format == DUMMY_CAPTURE_BMP) {
+        SDL_snprintf(file, sizeof(file), "SDL_window%d-%8.8d.bmp",
+                     capture->window_id, frame->number);
+        if (SDL_SaveBMP(surface, file) < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_VIDEO, "Couldn't save %s: %s", file, SDL_GetError());
+            return -1;
+        }
+        return 0;
+    }
+
+    if (!capture->stream) {
+        SDL_snprintf(file, sizeof(file), "SDL_window%d-%8.8d.%s",
+                     capture->window_id, frame->number,
+                     capture->format == DUMMY_CAPTURE_Y4M ? "y4m" : "raw");
+        capture->stream = SDL_RWFromFile(file, "wb");
+        if (!capture->stream) {
+            SDL_LogError(SDL_LOG_CATEGORY_VIDEO, "Couldn't create %s: %s", file, SDL_GetError());
+            return -1;
+        }
+        if (capture->format == DUMMY_CAPTURE_Y4M) {
+            char header[128];
+            int length = SDL_snprintf(header, sizeof(header),
+                                      "YUV4MPEG2 W%d H%d F60:1 Ip A1:1 C420jpeg\n",
+                                      surface->w, surface->h);
+            if (SDL_RWwrite(capture->stream, header, length, 1) != 1) {
+                SDL_LogError(SDL_LOG_CATEGORY_VIDEO, "Couldn't write %s: %s", file, SDL_GetError());
+                return -1;
+            }
+        }
+    }
+
+    if (capture->format == DUMMY_CAPTURE_Y4M) {
+        const int chroma = ((surface->w + 1) / 2) * ((surface->h + 1) / 2);
+        format = SDL_PIXELFORMAT_IYUV;
+        size = surface->w * surface->h + 2 * chroma;
+    } else {
+        format = SDL_PIXELFORMAT_RGB24;
+        size = surface->w * surface->h * 3;
+    }
+    if (!capture->converted) {
+        capture->converted = (Uint8 *) SDL_malloc(size);
+        if (!capture->converted) {
+            SDL_LogError(SDL_LOG_CATEGORY_VIDEO, "Out of memory converting frames");
+            return -1;
+        }
+    }
+    /* RGB888 is laid out like ARGB8888, which converts to IYUV without a copy */
+    if (SDL_ConvertPixels(surface->w, surface->h,
+                          SDL_PIXELFORMAT_ARGB8888, surface->pixels, surface->pitch,
+                          format, capture->converted,
+                          (format == SDL_PIXELFORMAT_IYUV) ? surface->w : surface->w * 3) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_VIDEO, "Couldn't convert frame %d: %s", frame->number, SDL_GetError());
+        return -1;
+    }
+
+    if ((capture->format == DUMMY_CAPTURE_Y4M && SDL_RWwrite(capture->stream, "FRAME\n", 6, 1) != 1) ||
+        SDL_RWwrite(capture->stream, capture->converted, size, 1) != 1) {
+        SDL_LogError(SDL_LOG_CATEGORY_VIDEO, "Couldn't write frame %d: %s", frame->number, SDL_GetError());
+        return -1;
+    }
+    return 0;
+}
+
+static int SDLCALL
+DUMMY_CaptureThread(void *data)
+{
+    DUMMY_Capture *capture = (DUMMY_Capture *) data;
+
+    SDL_LockMutex(capture->lock);
+    for ( ; ; ) {
+        const DUMMY_Frame *frame;
+        int status;
+
+        while (capture->count == 0 && !capture->quit) {
+            SDL_CondWait(capture->cond, capture->lock);
+        }
+        if (capture->count == 0) {
+            /* Quitting and everything has been written */
+            break;
+        }
+
+        /* The frame stays queued while it's written, so it isn't reused */
+        frame = &capture->frames[capture->head];
+        SDL_UnlockMutex(capture->lock);
+        status = capture->failed ? -1 : DUMMY_WriteFrame(capture, frame);
+        SDL_LockMutex(capture->lock);
+
+        capture->head = (capture->head + 1) % capture->num_frames;
+        --capture->count;
+        if (status == 0) {
+            ++capture->written;
+        } else if (!capture->failed) {
+            SDL_LogError(SDL_LOG_CATEGORY_VIDEO, "Window %d: no longer saving frames", capture->window_id);
+            capture->failed = SDL_TRUE;
+        }
+        SDL_CondSignal(capture->cond);
+    }
+    SDL_UnlockMutex(capture->lock);
+
+    if (capture->stream) {
+        if (SDL_RWclose(capture->stream) < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_VIDEO, "Window %d: couldn't finish saving frames: %s",
+                         capture->window_id, SDL_GetError());
+        }
+        capture->stream = NULL;
+    }
+    return 0;
+}
+
+static void
+DUMMY_DestroyCapture(DUMMY_Capture *capture)
+{
+    int i;
+
+    if (capture->thread) {
+        SDL_LockMutex(capture->lock);
+        capture->quit = SDL_TRUE;
+        SDL_CondSignal(capture->cond);
+        SDL_UnlockMutex(capture->lock);
+        SDL_WaitThread(capture->thread, NULL);
+
+        if (capture->dropped > 0) {
+            SDL_LogInfo(SDL_LOG_CATEGORY_VIDEO,
+                        "Window %d: saved %d frames, dropped %d frames",
+                        capture->window_id, capture->written, capture->dropped);
+        }
+    }
+    for (i = 0; i < capture->num_frames; ++i) {
+        SDL_FreeSurface(capture->frames[i].surface);
+    }
+    if (capture->cond) {
+        SDL_DestroyCond(capture->cond);
+    }
+    if (capture->lock) {
+        SDL_DestroyMutex(capture->lock);
+    }
+    SDL_free(capture->converted);
+    SDL_free(capture);
+}
+
+static DUMMY_Capture *
+DUMMY_CreateCapture(SDL_Window * window, const SDL_Surface *surface)
+{
+    DUMMY_Capture *capture;
+    const char *env;
+    char name[64];
+    int num_frames;
+
+    capture = (DUMMY_Capture *) SDL_calloc(1, sizeof(*capture));
+    if (!capture) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    capture->window_id = SDL_GetWindowID(window);
+
+    env = SDL_getenv("SDL_VIDEO_DUMMY_SAVE_FORMAT");
+    if (env && SDL_strcasecmp(env, "raw") == 0) {
+        capture->format = DUMMY_CAPTURE_RAW;
+    } else if (env && SDL_strcasecmp(env, "y4m") == 0) {
+        capture->format = DUMMY_CAPTURE_Y4M;
+    } else {
+        capture->format = DUMMY_CAPTURE_BMP;
+    }
+
+    env = SDL_getenv("SDL_VIDEO_DUMMY_SAVE_DROP");
+    capture->drop = (env && SDL_atoi(env) != 0);
+
+    env = SDL_getenv("SDL_VIDEO_DUMMY_SAVE_QUEUE");
+    num_frames = env ? SDL_atoi(env) : DUMMY_DEFAULT_QUEUE;
+    num_frames = SDL_max(1, SDL_min(num_frames, DUMMY_MAX_QUEUE));
+
+    for (capture->num_frames = 0; capture->num_frames < num_frames; ++capture->num_frames) {
+        SDL_Surface *frame = SDL_CreateRGBSurfaceWithFormat(0, surface->w, surface->h,
+                                 surface->format->BitsPerPixel, surface->format->format);
+        if (!frame) {
+            DUMMY_DestroyCapture(capture);
+            return NULL;
+        }
+        capture->frames[capture->num_frames].surface = frame;
+    }
+
+    capture->lock = SDL_CreateMutex();
+    capture->cond = SDL_CreateCond();
+    if (!capture->lock || !capture->cond) {
+        DUMMY_DestroyCapture(capture);
+        return NULL;
+    }
+
+    SDL_snprintf(name, sizeof(name), "SDLCapture%d", capture->window_id);
+    capture->thread = SDL_CreateThread(DUMMY_CaptureThread, name, capture);
+    if (!capture->thread) {
+        DUMMY_DestroyCapture(capture);
+        return NULL;
+    }
+    return capture;
+}
+
+/* Queue a copy of the surface for the writer thread, returns 1 if it was dropped */
+static int
+DUMMY_CaptureFrame(DUMMY_Capture *capture, const SDL_Surface *surface, int number)
+{
+    DUMMY_Frame *frame;
+
+    SDL_LockMutex(capture->lock);
+    while (capture->count == capture->num_frames && !capture->drop && !capture->failed) {
+        SDL_CondWait(capture->cond, capture->lock);
+    }
+    if (capture->failed) {
+        SDL_UnlockMutex(capture->lock);
+        return 0;
+    }
+    if (capture->count == capture->num_frames) {
+        ++capture->dropped;
+        SDL_UnlockMutex(capture->lock);
+        return 1;
+    }
+    frame = &capture->frames[(capture->head + capture->count) % capture->num_frames];
+    SDL_UnlockMutex(capture->lock);
+
+    /* The writer doesn't look at free frames, so copy without the lock */
+    SDL_memcpy(frame->surface->pixels, surface->pixels, surface->h * surface->pitch);
+    frame->number = number;
+
+    SDL_LockMutex(capture->lock);
+    ++capture->count;
+    SDL_CondSignal(capture->cond);
+    SDL_UnlockMutex(capture->lock);
+    return 0;
+}
 
 int SDL_DUMMY_CreateWindowFramebuffer(_THIS, SDL_Window * window, Uint32 * format, void ** pixels, int *pitch)
 {
@@ -36,9 +337,8 @@ int SDL_DUMMY_CreateWindowFramebuffer(_THIS, SDL_Window * window, Uint32 * forma
     int bpp;
     Uint32 Rmask, Gmask, Bmask, Amask;
 
-    /* Free the old framebuffer surface */
-    surface = (SDL_Surface *) SDL_GetWindowData(window, DUMMY_SURFACE);
-    SDL_FreeSurface(surface);
+    /* Free the old framebuffer surface, finishing any frames it saved */
+    SDL_DUMMY_DestroyWindowFramebuffer(_this, window);
 
     /* Create a new one */
     SDL_PixelFormatEnumToMasks(surface_format, &bpp, &Rmask, &Gmask, &Bmask, &Amask);
@@ -59,6 +359,7 @@ int SDL_DUMMY_CreateWindowFramebuffer(_THIS, SDL_Window * window, Uint32 * forma
 int SDL_DUMMY_UpdateWindowFramebuffer(_THIS, SDL_Window * window, const SDL_Rect * rects, int numrects)
 {
     static int frame_number;
+    const char *env;
     SDL_Surface *surface;
 
     surface = (SDL_Surface *) SDL_GetWindowData(window, DUMMY_SURFACE);
@@ -67,11 +368,23 @@ int SDL_DUMMY_UpdateWindowFramebuffer(_THIS, SDL_Window * window, const SDL_Rect
     }
 
     /* Send the data to the display */
-    if (SDL_getenv("SDL_VIDEO_DUMMY_SAVE_FRAMES")) {
-        char file[128];
-        SDL_snprintf(file, sizeof(file), "SDL_window%d-%8.8d.bmp",
-                     SDL_GetWindowID(window), ++frame_number);
-        SDL_SaveBMP(surface, file);
+    env = SDL_getenv("SDL_VIDEO_DUMMY_SAVE_FRAMES");
+    if (env && *env) {
+        DUMMY_Capture *capture = (DUMMY_Capture *) SDL_GetWindowData(window, DUMMY_CAPTURE);
+
+        if (!capture) {
+            capture = DUMMY_CreateCapture(window, surface);
+            if (!capture) {
+                return -1;
+            }
+            SDL_SetWindowData(window, DUMMY_CAPTURE, capture);
+        }
+        ++frame_number;
+        SDL_SetWindowData(window, DUMMY_FRAME, (void *) (uintptr_t) frame_number);
+        if (DUMMY_CaptureFrame(capture, surface, frame_number)) {
+            const uintptr_t dropped = (uintptr_t) SDL_GetWindowData(window, DUMMY_DROPPED);
+            SDL_SetWindowData(window, DUMMY_DROPPED, (void *) (dropped + 1));
+        }
     }
     return 0;
 }
@@ -79,6 +392,12 @@ int SDL_DUMMY_UpdateWindowFramebuffer(_THIS, SDL_Window * window, const SDL_Rect
 void SDL_DUMMY_DestroyWindowFramebuffer(_THIS, SDL_Window * window)
 {
     SDL_Surface *surface;
+    DUMMY_Capture *capture;
+
+    capture = (DUMMY_Capture *) SDL_SetWindowData(window, DUMMY_CAPTURE, NULL);
+    if (capture) {
+        DUMMY_DestroyCapture(capture);
+    }
 
     surface = (SDL_Surface *) SDL_SetWindowData(window, DUMMY_SURFACE, NULL);
     SDL_FreeSurface(surface);
@@ -248,6 +248,17 @@ __EOF__
             if (flags & SDL_COPY_MODULATE_ALPHA) {
                 ${s}A = (${s}A * modulateA) / 255;
             }
+__EOF__
+        }
+        if ( $blend ) {
+            print FILE <<__EOF__;
+            if ((flags & SDL_COPY_MODULATE_ALPHA) &&
+                (flags & (SDL_COPY_BLEND_PREMULTIPLIED|SDL_COPY_ADD_PREMULTIPLIED))) {
+                /* Premultiplied colors are scaled along with alpha */
+                ${s}R = (${s}R * modulateA) / 255;
+                ${s}G = (${s}G * modulateA) / 255;
+                ${s}B = (${s}B * modulateA) / 255;
+            }
 __EOF__
         }
     }
@@ -261,7 +272,7 @@ __EOF__
                     ${s}B = (${s}B * ${s}A) / 255;
                 }
             }
-            switch (flags & (SDL_COPY_BLEND|SDL_COPY_ADD|SDL_COPY_MOD)) {
+            switch (flags & SDL_COPY_BLEND_MASK) {
             case SDL_COPY_BLEND:
                 ${d}R = ${s}R + ((255 - ${s}A) * ${d}R) / 255;
                 ${d}G = ${s}G + ((255 - ${s}A) * ${d}G) / 255;
@@ -274,9 +285,24 @@ __EOF__
 __EOF__
         }
 
+        print FILE <<__EOF__;
+                break;
+            case SDL_COPY_BLEND_PREMULTIPLIED:
+                ${d}R = ${s}R + ((255 - ${s}A) * ${d}R) / 255; if (${d}R > 255) ${d}R = 255;
+                ${d}G = ${s}G + ((255 - ${s}A) * ${d}G) / 255; if (${d}G > 255) ${d}G = 255;
+                ${d}B = ${s}B + ((255 - ${s}A) * ${d}B) / 255; if (${d}B > 255) ${d}B = 255;
+__EOF__
+
+        if ( $dst_has_alpha ) {
+            print FILE <<__EOF__;
+                ${d}A = ${s}A + ((255 - ${s}A) * ${d}A) / 255;
+__EOF__
+        }
+
         print FILE <<__EOF__;
                 break;
             case SDL_COPY_ADD:
+            case SDL_COPY_ADD_PREMULTIPLIED:
                 ${d}R = ${s}R + ${d}R; if (${d}R > 255) ${d}R = 255;
                 ${d}G = ${s}G + ${d}G; if (${d}G > 255) ${d}G = 255;
                 ${d}B = ${s}B + ${d}B; if (${d}B > 255) ${d}B = 255;
@@ -465,7 +491,7 @@ __EOF__
                                 }
                             }
                             if ( $blend ) {
-                                $flag = "SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD";
+                                $flag = "SDL_COPY_BLEND | SDL_COPY_BLEND_PREMULTIPLIED | SDL_COPY_ADD | SDL_COPY_ADD_PREMULTIPLIED | SDL_COPY_MOD";
                                 if ( $flags eq "" ) {
                                     $flags = $flag;
                                 } else {
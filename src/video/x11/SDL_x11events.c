@@ -29,6 +29,7 @@
 #include <limits.h> /* For INT_MAX */
 
 #include "SDL_x11video.h"
+#include "SDL_x11framebuffer.h"
 #include "SDL_x11touch.h"
 #include "SDL_x11xinput2.h"
 #include "../../core/unix/SDL_poll.h"
@@ -705,6 +706,14 @@ X11_DispatchEvent(_THIS)
     }
 #endif
 
+#ifndef NO_SHARED_MEMORY
+    if (videodata->shm_completion_event &&
+        xevent.type == videodata->shm_completion_event) {
+        X11_HandleShmCompletion(videodata, (XShmCompletionEvent *) &xevent);
+        return;
+    }
+#endif
+
     /* Send a SDL_SYSWMEVENT if the application wants them */
     if (SDL_GetEventState(SDL_SYSWMEVENT) == SDL_ENABLE) {
         SDL_SysWMmsg wmmsg;
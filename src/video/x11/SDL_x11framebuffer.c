@@ -22,6 +22,7 @@
 
 #if SDL_VIDEO_DRIVER_X11
 
+#include "SDL_hints.h"
 #include "SDL_x11video.h"
 #include "SDL_x11framebuffer.h"
 
@@ -50,8 +51,185 @@ static SDL_bool have_mitshm(void)
     return SDL_FALSE;
 }
 
+/* Create an image the X server reads straight out of our memory */
+static XImage *
+X11_CreateShmImage(Display *display, Visual *visual, int depth,
+                   int w, int h, int pitch, XShmSegmentInfo *shminfo)
+{
+    XImage *ximage;
+
+    shminfo->shmid = shmget(IPC_PRIVATE, h*pitch, IPC_CREAT | 0777);
+    if ( shminfo->shmid >= 0 ) {
+        shminfo->shmaddr = (char *)shmat(shminfo->shmid, 0, 0);
+        shminfo->readOnly = False;
+        if ( shminfo->shmaddr != (char *)-1 ) {
+            shm_error = False;
+            X_handler = X11_XSetErrorHandler(shm_errhandler);
+            X11_XShmAttach(display, shminfo);
+            X11_XSync(display, False);
+            X11_XSetErrorHandler(X_handler);
+            if ( shm_error )
+                shmdt(shminfo->shmaddr);
+        } else {
+            shm_error = True;
+        }
+        shmctl(shminfo->shmid, IPC_RMID, NULL);
+    } else {
+        shm_error = True;
+    }
+    if (shm_error) {
+        return NULL;
+    }
+
+    ximage = X11_XShmCreateImage(display, visual, depth, ZPixmap,
+                                 shminfo->shmaddr, shminfo, w, h);
+    if (!ximage) {
+        X11_XShmDetach(display, shminfo);
+        X11_XSync(display, False);
+        shmdt(shminfo->shmaddr);
+    }
+    return ximage;
+}
+
+static void
+X11_DestroyShmImage(Display *display, XImage *ximage, XShmSegmentInfo *shminfo)
+{
+    XDestroyImage(ximage);
+
+    /* The server is done with the segment once the detach is processed */
+    X11_XShmDetach(display, shminfo);
+    X11_XSync(display, False);
+    shmdt(shminfo->shmaddr);
+}
+
+static void
+X11_ReleaseShmBuffer(SDL_WindowData *data, const XShmCompletionEvent *event)
+{
+    int i;
+
+    for (i = 0; i < data->num_shm_buffers; ++i) {
+        X11_ShmBuffer *buffer = &data->shm_buffers[i];
+        if (buffer->shminfo.shmseg == event->shmseg) {
+            if (buffer->pending > 0) {
+                --buffer->pending;
+            }
+            break;
+        }
+    }
+}
+
+void
+X11_HandleShmCompletion(SDL_VideoData *videodata, const XShmCompletionEvent *event)
+{
+    int i;
+
+    for (i = 0; i < videodata->numwindows; ++i) {
+        SDL_WindowData *data = videodata->windowlist[i];
+        if (data && data->xwindow == event->drawable) {
+            X11_ReleaseShmBuffer(data, event);
+            break;
+        }
+    }
+}
+
+static Bool
+X11_IsShmCompletion(Display *display, XEvent *event, XPointer arg)
+{
+    const SDL_WindowData *data = (const SDL_WindowData *) arg;
+
+    return (event->type == data->videodata->shm_completion_event &&
+            ((XShmCompletionEvent *) event)->drawable == data->xwindow);
+}
+
+/* Block until the server has read everything we put from this buffer */
+static void
+X11_WaitShmBuffer(Display *display, SDL_WindowData *data, X11_ShmBuffer *buffer)
+{
+    XEvent event;
+
+    while (buffer->pending > 0) {
+        X11_XIfEvent(display, &event, X11_IsShmCompletion, (XPointer) data);
+        X11_ReleaseShmBuffer(data, (XShmCompletionEvent *) &event);
+    }
+}
+
+/* Set up the images the updated areas get copied to, so the server can
+   read one of them while the application keeps drawing to its own */
+static void
+X11_CreateShmBuffers(Display *display, SDL_WindowData *data, int depth,
+                     int w, int h, int pitch)
+{
+    const char *hint = SDL_GetHint(SDL_HINT_VIDEO_X11_SHM_BUFFERS);
+    int num_buffers = hint ? SDL_atoi(hint) : 2;
+
+    num_buffers = SDL_min(num_buffers, X11_MAX_SHM_BUFFERS);
+    while (data->num_shm_buffers < num_buffers - 1) {
+        X11_ShmBuffer *buffer = &data->shm_buffers[data->num_shm_buffers];
+
+        buffer->ximage = X11_CreateShmImage(display, data->visual, depth,
+                                            w, h, pitch, &buffer->shminfo);
+        if (!buffer->ximage) {
+            break;
+        }
+        buffer->pending = 0;
+        ++data->num_shm_buffers;
+    }
+    data->next_shm_buffer = 0;
+
+    if (data->num_shm_buffers > 0) {
+        data->videodata->shm_completion_event =
+            X11_XShmGetEventBase(display) + ShmCompletion;
+    }
+}
+
+static void
+X11_CopyToShmBuffer(const XImage *src, XImage *dst, int x, int y, int w, int h)
+{
+    const int bpp = src->bits_per_pixel / 8;
+    const Uint8 *srcp = (const Uint8 *) src->data + y * src->bytes_per_line + x * bpp;
+    Uint8 *dstp = (Uint8 *) dst->data + y * dst->bytes_per_line + x * bpp;
+
+    while (h--) {
+        SDL_memcpy(dstp, srcp, w * bpp);
+        srcp += src->bytes_per_line;
+        dstp += dst->bytes_per_line;
+    }
+}
+
 #endif /* !NO_SHARED_MEMORY */
 
+/* Clip an update rect to the window, returns SDL_FALSE if nothing is left */
+static SDL_bool
+X11_ClipUpdateRect(SDL_Window * window, const SDL_Rect * rect,
+                   int *x, int *y, int *w, int *h)
+{
+    *x = rect->x;
+    *y = rect->y;
+    *w = rect->w;
+    *h = rect->h;
+
+    if (*w <= 0 || *h <= 0 || (*x + *w) <= 0 || (*y + *h) <= 0) {
+        /* Clipped? */
+        return SDL_FALSE;
+    }
+    if (*x < 0)
+    {
+        *w += *x;
+        *x = 0;
+    }
+    if (*y < 0)
+    {
+        *h += *y;
+        *y = 0;
+    }
+    if (*x + *w > window->w)
+        *w = window->w - *x;
+    if (*y + *h > window->h)
+        *h = window->h - *y;
+
+    return (*w > 0 && *h > 0);
+}
+
 int
 X11_CreateWindowFramebuffer(_THIS, SDL_Window * window, Uint32 * format,
                             void ** pixels, int *pitch)
@@ -87,42 +265,17 @@ X11_CreateWindowFramebuffer(_THIS, SDL_Window * window, Uint32 * format,
     /* Create the actual image */
 #ifndef NO_SHARED_MEMORY
     if (have_mitshm()) {
-        XShmSegmentInfo *shminfo = &data->shminfo;
-
-        shminfo->shmid = shmget(IPC_PRIVATE, window->h*(*pitch), IPC_CREAT | 0777);
-        if ( shminfo->shmid >= 0 ) {
-            shminfo->shmaddr = (char *)shmat(shminfo->shmid, 0, 0);
-            shminfo->readOnly = False;
-            if ( shminfo->shmaddr != (char *)-1 ) {
-                shm_error = False;
-                X_handler = X11_XSetErrorHandler(shm_errhandler);
-                X11_XShmAttach(display, shminfo);
-                X11_XSync(display, False);
-                X11_XSetErrorHandler(X_handler);
-                if ( shm_error )
-                    shmdt(shminfo->shmaddr);
-            } else {
-                shm_error = True;
-            }
-            shmctl(shminfo->shmid, IPC_RMID, NULL);
-        } else {
-            shm_error = True;
-        }
-        if (!shm_error) {
-            data->ximage = X11_XShmCreateImage(display, data->visual,
-                             vinfo.depth, ZPixmap,
-                             shminfo->shmaddr, shminfo,
-                             window->w, window->h);
-            if (!data->ximage) {
-                X11_XShmDetach(display, shminfo);
-                X11_XSync(display, False);
-                shmdt(shminfo->shmaddr);
-            } else {
-                /* Done! */
-                data->use_mitshm = SDL_TRUE;
-                *pixels = shminfo->shmaddr;
-                return 0;
-            }
+        data->ximage = X11_CreateShmImage(display, data->visual, vinfo.depth,
+                                          window->w, window->h, *pitch,
+                                          &data->shminfo);
+        if (data->ximage) {
+            X11_CreateShmBuffers(display, data, vinfo.depth,
+                                 window->w, window->h, *pitch);
+
+            /* Done! */
+            data->use_mitshm = SDL_TRUE;
+            *pixels = data->shminfo.shmaddr;
+            return 0;
         }
     }
 #endif /* not NO_SHARED_MEMORY */
@@ -151,32 +304,35 @@ X11_UpdateWindowFramebuffer(_THIS, SDL_Window * window, const SDL_Rect * rects,
     int i;
     int x, y, w ,h;
 #ifndef NO_SHARED_MEMORY
-    if (data->use_mitshm) {
-        for (i = 0; i < numrects; ++i) {
-            x = rects[i].x;
-            y = rects[i].y;
-            w = rects[i].w;
-            h = rects[i].h;
+    if (data->num_shm_buffers > 0) {
+        X11_ShmBuffer *buffer = &data->shm_buffers[data->next_shm_buffer];
 
-            if (w <= 0 || h <= 0 || (x + w) <= 0 || (y + h) <= 0) {
-                /* Clipped? */
+        /* Only wait if the server is still reading this buffer from a
+           previous frame, and then only copy the areas that changed. */
+        X11_WaitShmBuffer(display, data, buffer);
+
+        for (i = 0; i < numrects; ++i) {
+            if (!X11_ClipUpdateRect(window, &rects[i], &x, &y, &w, &h)) {
                 continue;
             }
-            if (x < 0)
-            {
-                x += w;
-                w += rects[i].x;
-            }
-            if (y < 0)
-            {
-                y += h;
-                h += rects[i].y;
-            }
-            if (x + w > window->w)
-                w = window->w - x;
-            if (y + h > window->h)
-                h = window->h - y;
+            X11_CopyToShmBuffer(data->ximage, buffer->ximage, x, y, w, h);
+            X11_XShmPutImage(display, data->xwindow, data->gc, buffer->ximage,
+                x, y, x, y, w, h, True);
+            ++buffer->pending;
+        }
+
+        if (buffer->pending > 0) {
+            data->next_shm_buffer = (data->next_shm_buffer + 1) % data->num_shm_buffers;
+        }
+        X11_XFlush(display);
+        return 0;
+    }
 
+    if (data->use_mitshm) {
+        for (i = 0; i < numrects; ++i) {
+            if (!X11_ClipUpdateRect(window, &rects[i], &x, &y, &w, &h)) {
+                continue;
+            }
             X11_XShmPutImage(display, data->xwindow, data->gc, data->ximage,
                 x, y, x, y, w, h, False);
         }
@@ -185,30 +341,9 @@ X11_UpdateWindowFramebuffer(_THIS, SDL_Window * window, const SDL_Rect * rects,
 #endif /* !NO_SHARED_MEMORY */
     {
         for (i = 0; i < numrects; ++i) {
-            x = rects[i].x;
-            y = rects[i].y;
-            w = rects[i].w;
-            h = rects[i].h;
-
-            if (w <= 0 || h <= 0 || (x + w) <= 0 || (y + h) <= 0) {
-                /* Clipped? */
+            if (!X11_ClipUpdateRect(window, &rects[i], &x, &y, &w, &h)) {
                 continue;
             }
-            if (x < 0)
-            {
-                x += w;
-                w += rects[i].x;
-            }
-            if (y < 0)
-            {
-                y += h;
-                h += rects[i].y;
-            }
-            if (x + w > window->w)
-                w = window->w - x;
-            if (y + h > window->h)
-                h = window->h - y;
-
             X11_XPutImage(display, data->xwindow, data->gc, data->ximage,
                 x, y, x, y, w, h);
         }
@@ -232,17 +367,23 @@ X11_DestroyWindowFramebuffer(_THIS, SDL_Window * window)
 
     display = data->videodata->display;
 
-    if (data->ximage) {
-        XDestroyImage(data->ximage);
+#ifndef NO_SHARED_MEMORY
+    while (data->num_shm_buffers > 0) {
+        X11_ShmBuffer *buffer = &data->shm_buffers[--data->num_shm_buffers];
+
+        X11_DestroyShmImage(display, buffer->ximage, &buffer->shminfo);
+        SDL_zerop(buffer);
+    }
+#endif /* !NO_SHARED_MEMORY */
 
+    if (data->ximage) {
 #ifndef NO_SHARED_MEMORY
         if (data->use_mitshm) {
-            X11_XShmDetach(display, &data->shminfo);
-            X11_XSync(display, False);
-            shmdt(data->shminfo.shmaddr);
+            X11_DestroyShmImage(display, data->ximage, &data->shminfo);
             data->use_mitshm = SDL_FALSE;
-        }
+        } else
 #endif /* !NO_SHARED_MEMORY */
+        XDestroyImage(data->ximage);
 
         data->ximage = NULL;
     }
@@ -138,6 +138,10 @@ typedef struct SDL_VideoData
     XkbDescPtr xkb;
 #endif
 
+#ifndef NO_SHARED_MEMORY
+    int shm_completion_event;   /* 0 until a framebuffer is buffered */
+#endif
+
     KeyCode filter_code;
     Time    filter_time;
 
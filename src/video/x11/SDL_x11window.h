@@ -40,6 +40,18 @@ typedef enum
     PENDING_FOCUS_OUT
 } PendingFocusEnum;
 
+#ifndef NO_SHARED_MEMORY
+/* The most images the X server can be reading while the application draws */
+#define X11_MAX_SHM_BUFFERS 3
+
+typedef struct
+{
+    XShmSegmentInfo shminfo;
+    XImage *ximage;
+    int pending;        /* puts the server hasn't completed yet */
+} X11_ShmBuffer;
+#endif
+
 typedef struct
 {
     SDL_Window *window;
@@ -51,6 +63,10 @@ typedef struct
     /* MIT shared memory extension information */
     SDL_bool use_mitshm;
     XShmSegmentInfo shminfo;
+    /* Copies of the framebuffer the server reads from, if buffered */
+    X11_ShmBuffer shm_buffers[X11_MAX_SHM_BUFFERS - 1];
+    int num_shm_buffers;
+    int next_shm_buffer;
 #endif
     XImage *ximage;
     GC gc;
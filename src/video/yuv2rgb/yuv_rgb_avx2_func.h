@@ -0,0 +1,363 @@
+// Copyright 2016 Adrien Descamps
+// Distributed under BSD 3-Clause License
+
+/* You need to define the following macros before including this file:
+	AVX2_FUNCTION_NAME
+	STD_FUNCTION_NAME
+	YUV_FORMAT
+	RGB_FORMAT
+*/
+
+/* This follows the SSE version, but handles a whole 32 pixel block of each
+   line in one pass. The 8 bit results are kept in pixel order, which means
+   fixing up the lane crossing of the 256 bit unpack and pack instructions
+   with a permute here and there. */
+
+#define LOAD_SI256 _mm256_loadu_si256
+#define SAVE_SI256 _mm256_storeu_si256
+
+/* Duplicates 16 chroma contributions into two registers of 16 pixels each */
+#define DUP_UV_32(X, X1, X2) \
+{ \
+	__m256i lo = _mm256_unpacklo_epi16(X, X); \
+	__m256i hi = _mm256_unpackhi_epi16(X, X); \
+	X1 = _mm256_permute2x128_si256(lo, hi, 0x20); \
+	X2 = _mm256_permute2x128_si256(lo, hi, 0x31); \
+}
+
+#define UV2RGB_32(U,V,R1,G1,B1,R2,G2,B2) \
+	r_tmp = _mm256_mullo_epi16(V, _mm256_set1_epi16(param->v_r_factor)); \
+	g_tmp = _mm256_add_epi16( \
+		_mm256_mullo_epi16(U, _mm256_set1_epi16(param->u_g_factor)), \
+		_mm256_mullo_epi16(V, _mm256_set1_epi16(param->v_g_factor))); \
+	b_tmp = _mm256_mullo_epi16(U, _mm256_set1_epi16(param->u_b_factor)); \
+	DUP_UV_32(r_tmp, R1, R2) \
+	DUP_UV_32(g_tmp, G1, G2) \
+	DUP_UV_32(b_tmp, B1, B2) \
+
+/* The sums can exceed 16 bits for saturated colors, so they saturate rather than wrap */
+#define ADD_Y2RGB_32(Y1,Y2,R1,G1,B1,R2,G2,B2) \
+	Y1 = _mm256_mullo_epi16(_mm256_sub_epi16(Y1, _mm256_set1_epi16(param->y_shift)), _mm256_set1_epi16(param->y_factor)); \
+	Y2 = _mm256_mullo_epi16(_mm256_sub_epi16(Y2, _mm256_set1_epi16(param->y_shift)), _mm256_set1_epi16(param->y_factor)); \
+	\
+	R1 = _mm256_srai_epi16(_mm256_adds_epi16(R1, Y1), PRECISION); \
+	G1 = _mm256_srai_epi16(_mm256_adds_epi16(G1, Y1), PRECISION); \
+	B1 = _mm256_srai_epi16(_mm256_adds_epi16(B1, Y1), PRECISION); \
+	R2 = _mm256_srai_epi16(_mm256_adds_epi16(R2, Y2), PRECISION); \
+	G2 = _mm256_srai_epi16(_mm256_adds_epi16(G2, Y2), PRECISION); \
+	B2 = _mm256_srai_epi16(_mm256_adds_epi16(B2, Y2), PRECISION); \
+
+/* Packs two registers of 16 bit values to 32 bytes in pixel order */
+#define PACKUS_32(X1, X2) \
+	_mm256_permute4x64_epi64(_mm256_packus_epi16(X1, X2), 0xD8)
+
+#define PACK_RGB565_32(R, G, B, RGB1, RGB2) \
+{ \
+	__m256i lo, hi; \
+\
+	lo = _mm256_and_si256(_mm256_unpacklo_epi8(_mm256_setzero_si256(), R), _mm256_set1_epi16((short)0xF800)); \
+	hi = _mm256_and_si256(_mm256_unpackhi_epi8(_mm256_setzero_si256(), R), _mm256_set1_epi16((short)0xF800)); \
+	lo = _mm256_or_si256(lo, _mm256_slli_epi16(_mm256_srli_epi16(_mm256_unpacklo_epi8(G, _mm256_setzero_si256()), 2), 5)); \
+	hi = _mm256_or_si256(hi, _mm256_slli_epi16(_mm256_srli_epi16(_mm256_unpackhi_epi8(G, _mm256_setzero_si256()), 2), 5)); \
+	lo = _mm256_or_si256(lo, _mm256_srli_epi16(_mm256_unpacklo_epi8(B, _mm256_setzero_si256()), 3)); \
+	hi = _mm256_or_si256(hi, _mm256_srli_epi16(_mm256_unpackhi_epi8(B, _mm256_setzero_si256()), 3)); \
+	RGB1 = _mm256_permute2x128_si256(lo, hi, 0x20); \
+	RGB2 = _mm256_permute2x128_si256(lo, hi, 0x31); \
+}
+
+#define SHUFFLE_RGB24(X, i) \
+	_mm256_shuffle_epi8(X, _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)avx2_rgb24_shuffle[i])))
+
+/* Each 128 bit lane interleaves its 16 pixels into 48 bytes, the lanes are then put back in order */
+#define PACK_RGB24_32(R, G, B, RGB1, RGB2, RGB3) \
+{ \
+	__m256i out1, out2, out3; \
+\
+	out1 = _mm256_or_si256(_mm256_or_si256(SHUFFLE_RGB24(R, 0), SHUFFLE_RGB24(G, 1)), SHUFFLE_RGB24(B, 2)); \
+	out2 = _mm256_or_si256(_mm256_or_si256(SHUFFLE_RGB24(R, 3), SHUFFLE_RGB24(G, 4)), SHUFFLE_RGB24(B, 5)); \
+	out3 = _mm256_or_si256(_mm256_or_si256(SHUFFLE_RGB24(R, 6), SHUFFLE_RGB24(G, 7)), SHUFFLE_RGB24(B, 8)); \
+	RGB1 = _mm256_permute2x128_si256(out1, out2, 0x20); \
+	RGB2 = _mm256_permute2x128_si256(out3, out1, 0x30); \
+	RGB3 = _mm256_permute2x128_si256(out2, out3, 0x31); \
+}
+
+#define PACK_RGBA_32(R, G, B, A, RGB1, RGB2, RGB3, RGB4) \
+{ \
+	__m256i lo_ab, hi_ab, lo_gr, hi_gr, out1, out2, out3, out4; \
+\
+	lo_ab = _mm256_unpacklo_epi8( A, B ); \
+	hi_ab = _mm256_unpackhi_epi8( A, B ); \
+	lo_gr = _mm256_unpacklo_epi8( G, R ); \
+	hi_gr = _mm256_unpackhi_epi8( G, R ); \
+	out1 = _mm256_unpacklo_epi16( lo_ab, lo_gr ); \
+	out2 = _mm256_unpackhi_epi16( lo_ab, lo_gr ); \
+	out3 = _mm256_unpacklo_epi16( hi_ab, hi_gr ); \
+	out4 = _mm256_unpackhi_epi16( hi_ab, hi_gr ); \
+	RGB1 = _mm256_permute2x128_si256(out1, out2, 0x20); \
+	RGB2 = _mm256_permute2x128_si256(out3, out4, 0x20); \
+	RGB3 = _mm256_permute2x128_si256(out1, out2, 0x31); \
+	RGB4 = _mm256_permute2x128_si256(out3, out4, 0x31); \
+}
+
+#if RGB_FORMAT == RGB_FORMAT_RGB565
+
+#define PACK_PIXEL(R, G, B) \
+	PACK_RGB565_32(R, G, B, rgb_1, rgb_2) \
+
+#define SAVE_LINE(rgb_ptr) \
+	SAVE_SI256((__m256i*)(rgb_ptr), rgb_1); \
+	SAVE_SI256((__m256i*)(rgb_ptr+32), rgb_2); \
+
+#elif RGB_FORMAT == RGB_FORMAT_RGB24
+
+#define PACK_PIXEL(R, G, B) \
+	PACK_RGB24_32(R, G, B, rgb_1, rgb_2, rgb_3) \
+
+#define SAVE_LINE(rgb_ptr) \
+	SAVE_SI256((__m256i*)(rgb_ptr), rgb_1); \
+	SAVE_SI256((__m256i*)(rgb_ptr+32), rgb_2); \
+	SAVE_SI256((__m256i*)(rgb_ptr+64), rgb_3); \
+
+#elif RGB_FORMAT == RGB_FORMAT_RGBA
+
+#define PACK_PIXEL(R, G, B) \
+	PACK_RGBA_32(R, G, B, a, rgb_1, rgb_2, rgb_3, rgb_4) \
+
+#elif RGB_FORMAT == RGB_FORMAT_BGRA
+
+#define PACK_PIXEL(R, G, B) \
+	PACK_RGBA_32(B, G, R, a, rgb_1, rgb_2, rgb_3, rgb_4) \
+
+#elif RGB_FORMAT == RGB_FORMAT_ARGB
+
+#define PACK_PIXEL(R, G, B) \
+	PACK_RGBA_32(a, R, G, B, rgb_1, rgb_2, rgb_3, rgb_4) \
+
+#elif RGB_FORMAT == RGB_FORMAT_ABGR
+
+#define PACK_PIXEL(R, G, B) \
+	PACK_RGBA_32(a, B, G, R, rgb_1, rgb_2, rgb_3, rgb_4) \
+
+#else
+#error PACK_PIXEL unimplemented
+#endif
+
+#if RGB_FORMAT == RGB_FORMAT_RGBA || RGB_FORMAT == RGB_FORMAT_BGRA || \
+    RGB_FORMAT == RGB_FORMAT_ARGB || RGB_FORMAT == RGB_FORMAT_ABGR
+
+#define SAVE_LINE(rgb_ptr) \
+	SAVE_SI256((__m256i*)(rgb_ptr), rgb_1); \
+	SAVE_SI256((__m256i*)(rgb_ptr+32), rgb_2); \
+	SAVE_SI256((__m256i*)(rgb_ptr+64), rgb_3); \
+	SAVE_SI256((__m256i*)(rgb_ptr+96), rgb_4); \
+
+#endif
+
+#if YUV_FORMAT == YUV_FORMAT_420
+
+#define READ_Y(y_ptr) \
+	y = LOAD_SI256((const __m256i*)(y_ptr)); \
+
+#define READ_UV	\
+	u = _mm_loadu_si128((const __m128i*)(u_ptr)); \
+	v = _mm_loadu_si128((const __m128i*)(v_ptr)); \
+
+#elif YUV_FORMAT == YUV_FORMAT_422
+
+#define READ_Y(y_ptr) \
+{ \
+	__m256i y1, y2; \
+	y1 = _mm256_and_si256(LOAD_SI256((const __m256i*)(y_ptr)), _mm256_set1_epi16(0xFF)); \
+	y2 = _mm256_and_si256(LOAD_SI256((const __m256i*)(y_ptr+32)), _mm256_set1_epi16(0xFF)); \
+	y = PACKUS_32(y1, y2); \
+}
+
+#define READ_UV	\
+{ \
+	__m256i u1, u2, v1, v2; \
+	u1 = _mm256_and_si256(LOAD_SI256((const __m256i*)(u_ptr)), _mm256_set1_epi32(0xFF)); \
+	u2 = _mm256_and_si256(LOAD_SI256((const __m256i*)(u_ptr+32)), _mm256_set1_epi32(0xFF)); \
+	u1 = _mm256_permute4x64_epi64(_mm256_packs_epi32(u1, u2), 0xD8); \
+	u = _mm_packus_epi16(_mm256_castsi256_si128(u1), _mm256_extracti128_si256(u1, 1)); \
+	v1 = _mm256_and_si256(LOAD_SI256((const __m256i*)(v_ptr)), _mm256_set1_epi32(0xFF)); \
+	v2 = _mm256_and_si256(LOAD_SI256((const __m256i*)(v_ptr+32)), _mm256_set1_epi32(0xFF)); \
+	v1 = _mm256_permute4x64_epi64(_mm256_packs_epi32(v1, v2), 0xD8); \
+	v = _mm_packus_epi16(_mm256_castsi256_si128(v1), _mm256_extracti128_si256(v1, 1)); \
+}
+
+#elif YUV_FORMAT == YUV_FORMAT_NV12
+
+#define READ_Y(y_ptr) \
+	y = LOAD_SI256((const __m256i*)(y_ptr)); \
+
+#define READ_UV	\
+{ \
+	__m256i u1, v1; \
+	u1 = _mm256_and_si256(LOAD_SI256((const __m256i*)(u_ptr)), _mm256_set1_epi16(0xFF)); \
+	u = _mm_packus_epi16(_mm256_castsi256_si128(u1), _mm256_extracti128_si256(u1, 1)); \
+	v1 = _mm256_and_si256(LOAD_SI256((const __m256i*)(v_ptr)), _mm256_set1_epi16(0xFF)); \
+	v = _mm_packus_epi16(_mm256_castsi256_si128(v1), _mm256_extracti128_si256(v1, 1)); \
+}
+
+#else
+#error READ_UV unimplemented
+#endif
+
+/* Converts one line of 32 pixels using the chroma contributions in r_uv_16_x, etc. */
+#define Y2RGB_32(y_ptr) \
+	r_16_1=r_uv_16_1; g_16_1=g_uv_16_1; b_16_1=b_uv_16_1; \
+	r_16_2=r_uv_16_2; g_16_2=g_uv_16_2; b_16_2=b_uv_16_2; \
+	\
+	READ_Y(y_ptr) \
+	y_16_1 = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(y)); \
+	y_16_2 = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(y, 1)); \
+	\
+	ADD_Y2RGB_32(y_16_1, y_16_2, r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2) \
+	\
+	r_8 = PACKUS_32(r_16_1, r_16_2); \
+	g_8 = PACKUS_32(g_16_1, g_16_2); \
+	b_8 = PACKUS_32(b_16_1, b_16_2); \
+
+#define YUV2RGB_32 \
+	__m256i r_tmp, g_tmp, b_tmp; \
+	__m256i r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2; \
+	__m256i r_uv_16_1, g_uv_16_1, b_uv_16_1, r_uv_16_2, g_uv_16_2, b_uv_16_2; \
+	__m256i y_16_1, y_16_2; \
+	__m256i y, u_16, v_16; \
+	__m256i r_8, g_8, b_8; \
+	__m128i u, v; \
+	\
+	READ_UV \
+	\
+	u_16 = _mm256_add_epi16(_mm256_cvtepu8_epi16(u), _mm256_set1_epi16(-128)); \
+	v_16 = _mm256_add_epi16(_mm256_cvtepu8_epi16(v), _mm256_set1_epi16(-128)); \
+	\
+	UV2RGB_32(u_16, v_16, r_uv_16_1, g_uv_16_1, b_uv_16_1, r_uv_16_2, g_uv_16_2, b_uv_16_2) \
+
+
+SDL_TARGETING("avx2") void AVX2_FUNCTION_NAME(uint32_t width, uint32_t height,
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride,
+	uint8_t *RGB, uint32_t RGB_stride,
+	YCbCrType yuv_type)
+{
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
+#if YUV_FORMAT == YUV_FORMAT_420
+	const int y_pixel_stride = 1;
+	const int uv_pixel_stride = 1;
+	const int uv_x_sample_interval = 2;
+	const int uv_y_sample_interval = 2;
+#elif YUV_FORMAT == YUV_FORMAT_422
+	const int y_pixel_stride = 2;
+	const int uv_pixel_stride = 4;
+	const int uv_x_sample_interval = 2;
+	const int uv_y_sample_interval = 1;
+#elif YUV_FORMAT == YUV_FORMAT_NV12
+	const int y_pixel_stride = 1;
+	const int uv_pixel_stride = 2;
+	const int uv_x_sample_interval = 2;
+	const int uv_y_sample_interval = 2;
+#endif
+#if RGB_FORMAT == RGB_FORMAT_RGB565
+	const int rgb_pixel_stride = 2;
+	__m256i rgb_1, rgb_2;
+#elif RGB_FORMAT == RGB_FORMAT_RGB24
+	const int rgb_pixel_stride = 3;
+	__m256i rgb_1, rgb_2, rgb_3;
+#elif RGB_FORMAT == RGB_FORMAT_RGBA || RGB_FORMAT == RGB_FORMAT_BGRA || \
+      RGB_FORMAT == RGB_FORMAT_ARGB || RGB_FORMAT == RGB_FORMAT_ABGR
+	const int rgb_pixel_stride = 4;
+	const __m256i a = _mm256_set1_epi8((char)0xFF);
+	__m256i rgb_1, rgb_2, rgb_3, rgb_4;
+#else
+#error Unknown RGB pixel size
+#endif
+	/* The interleaved chroma loads read up to 3 bytes past the end of the
+	   block, so leave the last pixels of each line to the C version */
+#if YUV_FORMAT == YUV_FORMAT_420
+	const uint32_t converted = (width & ~31);
+#else
+	const uint32_t converted = (width > 2) ? ((width-2) & ~31) : 0;
+#endif
+
+	if (converted > 0) {
+		uint32_t xpos, ypos;
+		for(ypos=0; ypos<(height-(uv_y_sample_interval-1)); ypos+=uv_y_sample_interval)
+		{
+			const uint8_t *y_ptr1=Y+ypos*Y_stride,
+				*y_ptr2=Y+(ypos+1)*Y_stride,
+				*u_ptr=U+(ypos/uv_y_sample_interval)*UV_stride,
+				*v_ptr=V+(ypos/uv_y_sample_interval)*UV_stride;
+
+			uint8_t *rgb_ptr1=RGB+ypos*RGB_stride,
+				*rgb_ptr2=RGB+(ypos+1)*RGB_stride;
+
+			for(xpos=0; xpos<converted; xpos+=32)
+			{
+				YUV2RGB_32
+
+				Y2RGB_32(y_ptr1)
+				PACK_PIXEL(r_8, g_8, b_8)
+				SAVE_LINE(rgb_ptr1)
+
+				if (uv_y_sample_interval > 1)
+				{
+					Y2RGB_32(y_ptr2)
+					PACK_PIXEL(r_8, g_8, b_8)
+					SAVE_LINE(rgb_ptr2)
+				}
+
+				y_ptr1+=32*y_pixel_stride;
+				y_ptr2+=32*y_pixel_stride;
+				u_ptr+=32*uv_pixel_stride/uv_x_sample_interval;
+				v_ptr+=32*uv_pixel_stride/uv_x_sample_interval;
+				rgb_ptr1+=32*rgb_pixel_stride;
+				rgb_ptr2+=32*rgb_pixel_stride;
+			}
+		}
+
+		/* Catch the last line, if needed */
+		if (uv_y_sample_interval == 2 && ypos == (height-1))
+		{
+			const uint8_t *y_ptr=Y+ypos*Y_stride,
+				*u_ptr=U+(ypos/uv_y_sample_interval)*UV_stride,
+				*v_ptr=V+(ypos/uv_y_sample_interval)*UV_stride;
+
+			uint8_t *rgb_ptr=RGB+ypos*RGB_stride;
+
+			STD_FUNCTION_NAME(converted, 1, y_ptr, u_ptr, v_ptr, Y_stride, UV_stride, rgb_ptr, RGB_stride, yuv_type);
+		}
+	}
+
+	/* Catch the right column, if needed */
+	if (converted != width)
+	{
+		const uint8_t *y_ptr=Y+converted*y_pixel_stride,
+			*u_ptr=U+converted*uv_pixel_stride/uv_x_sample_interval,
+			*v_ptr=V+converted*uv_pixel_stride/uv_x_sample_interval;
+
+		uint8_t *rgb_ptr=RGB+converted*rgb_pixel_stride;
+
+		STD_FUNCTION_NAME(width-converted, height, y_ptr, u_ptr, v_ptr, Y_stride, UV_stride, rgb_ptr, RGB_stride, yuv_type);
+	}
+}
+
+#undef AVX2_FUNCTION_NAME
+#undef STD_FUNCTION_NAME
+#undef YUV_FORMAT
+#undef RGB_FORMAT
+#undef LOAD_SI256
+#undef SAVE_SI256
+#undef DUP_UV_32
+#undef UV2RGB_32
+#undef ADD_Y2RGB_32
+#undef PACKUS_32
+#undef PACK_RGB565_32
+#undef SHUFFLE_RGB24
+#undef PACK_RGB24_32
+#undef PACK_RGBA_32
+#undef PACK_PIXEL
+#undef SAVE_LINE
+#undef READ_Y
+#undef READ_UV
+#undef Y2RGB_32
+#undef YUV2RGB_32
@@ -0,0 +1,273 @@
+// Copyright 2016 Adrien Descamps
+// Distributed under BSD 3-Clause License
+
+/* You need to define the following macros before including this file:
+	NEON_FUNCTION_NAME
+	STD_FUNCTION_NAME
+	YUV_FORMAT
+	RGB_FORMAT
+*/
+
+/* This does the same 16 bit arithmetic as the SSE version, on blocks of 16
+   pixels per line. The structured loads and stores take care of splitting
+   packed YUV and of interleaving the RGB output. */
+
+#define UV2RGB_16(U,V,R1,G1,B1,R2,G2,B2) \
+{ \
+	int16x8x2_t r_dup, g_dup, b_dup; \
+	r_dup = vzipq_s16(vmulq_n_s16(V, param->v_r_factor), vmulq_n_s16(V, param->v_r_factor)); \
+	g_tmp = vaddq_s16(vmulq_n_s16(U, param->u_g_factor), vmulq_n_s16(V, param->v_g_factor)); \
+	g_dup = vzipq_s16(g_tmp, g_tmp); \
+	b_dup = vzipq_s16(vmulq_n_s16(U, param->u_b_factor), vmulq_n_s16(U, param->u_b_factor)); \
+	R1 = r_dup.val[0]; G1 = g_dup.val[0]; B1 = b_dup.val[0]; \
+	R2 = r_dup.val[1]; G2 = g_dup.val[1]; B2 = b_dup.val[1]; \
+}
+
+/* The sums can exceed 16 bits for saturated colors, so they saturate rather than wrap */
+#define ADD_Y2RGB_16(Y1,Y2,R1,G1,B1,R2,G2,B2) \
+	Y1 = vmulq_n_s16(vsubq_s16(Y1, vdupq_n_s16(param->y_shift)), param->y_factor); \
+	Y2 = vmulq_n_s16(vsubq_s16(Y2, vdupq_n_s16(param->y_shift)), param->y_factor); \
+	\
+	R1 = vshrq_n_s16(vqaddq_s16(R1, Y1), PRECISION); \
+	G1 = vshrq_n_s16(vqaddq_s16(G1, Y1), PRECISION); \
+	B1 = vshrq_n_s16(vqaddq_s16(B1, Y1), PRECISION); \
+	R2 = vshrq_n_s16(vqaddq_s16(R2, Y2), PRECISION); \
+	G2 = vshrq_n_s16(vqaddq_s16(G2, Y2), PRECISION); \
+	B2 = vshrq_n_s16(vqaddq_s16(B2, Y2), PRECISION); \
+
+#define PACKUS_16(X1, X2) \
+	vcombine_u8(vqmovun_s16(X1), vqmovun_s16(X2))
+
+#if RGB_FORMAT == RGB_FORMAT_RGB565
+
+#define SAVE_LINE(rgb_ptr) \
+{ \
+	uint16x8_t rgb_1, rgb_2; \
+	rgb_1 = vshll_n_u8(vget_low_u8(r_8), 8); \
+	rgb_1 = vsriq_n_u16(rgb_1, vshll_n_u8(vget_low_u8(g_8), 8), 5); \
+	rgb_1 = vsriq_n_u16(rgb_1, vshll_n_u8(vget_low_u8(b_8), 8), 11); \
+	rgb_2 = vshll_n_u8(vget_high_u8(r_8), 8); \
+	rgb_2 = vsriq_n_u16(rgb_2, vshll_n_u8(vget_high_u8(g_8), 8), 5); \
+	rgb_2 = vsriq_n_u16(rgb_2, vshll_n_u8(vget_high_u8(b_8), 8), 11); \
+	vst1q_u16((uint16_t*)(rgb_ptr), rgb_1); \
+	vst1q_u16((uint16_t*)(rgb_ptr+16), rgb_2); \
+}
+
+#elif RGB_FORMAT == RGB_FORMAT_RGB24
+
+#define SAVE_LINE(rgb_ptr) \
+{ \
+	uint8x16x3_t rgb; \
+	rgb.val[0] = r_8; rgb.val[1] = g_8; rgb.val[2] = b_8; \
+	vst3q_u8(rgb_ptr, rgb); \
+}
+
+#else
+
+/* Byte order in memory of the 32 bit pixels, on little endian systems */
+#if RGB_FORMAT == RGB_FORMAT_RGBA
+#define PIXEL_BYTES(R, G, B, A) A, B, G, R
+#elif RGB_FORMAT == RGB_FORMAT_BGRA
+#define PIXEL_BYTES(R, G, B, A) A, R, G, B
+#elif RGB_FORMAT == RGB_FORMAT_ARGB
+#define PIXEL_BYTES(R, G, B, A) B, G, R, A
+#elif RGB_FORMAT == RGB_FORMAT_ABGR
+#define PIXEL_BYTES(R, G, B, A) R, G, B, A
+#else
+#error PACK_PIXEL unimplemented
+#endif
+
+#define STORE_PIXEL_BYTES(rgb_ptr, X0, X1, X2, X3) \
+{ \
+	uint8x16x4_t rgb; \
+	rgb.val[0] = X0; rgb.val[1] = X1; rgb.val[2] = X2; rgb.val[3] = X3; \
+	vst4q_u8(rgb_ptr, rgb); \
+}
+
+/* The extra level of macro expands PIXEL_BYTES into separate arguments */
+#define STORE_PIXEL_BYTES_(args) STORE_PIXEL_BYTES args
+
+#define SAVE_LINE(rgb_ptr) \
+	STORE_PIXEL_BYTES_((rgb_ptr, PIXEL_BYTES(r_8, g_8, b_8, a))) \
+
+#endif
+
+#if YUV_FORMAT == YUV_FORMAT_420
+
+#define READ_Y(y_ptr) \
+	y = vld1q_u8(y_ptr); \
+
+#define READ_UV	\
+	u = vld1_u8(u_ptr); \
+	v = vld1_u8(v_ptr); \
+
+#elif YUV_FORMAT == YUV_FORMAT_422
+
+#define READ_Y(y_ptr) \
+	y = vld2q_u8(y_ptr).val[0]; \
+
+#define READ_UV	\
+	u = vld4_u8(u_ptr).val[0]; \
+	v = vld4_u8(v_ptr).val[0]; \
+
+#elif YUV_FORMAT == YUV_FORMAT_NV12
+
+#define READ_Y(y_ptr) \
+	y = vld1q_u8(y_ptr); \
+
+#define READ_UV	\
+	u = vld2_u8(u_ptr).val[0]; \
+	v = vld2_u8(v_ptr).val[0]; \
+
+#else
+#error READ_UV unimplemented
+#endif
+
+/* Converts one line of 16 pixels using the chroma contributions in r_uv_16_x, etc. */
+#define Y2RGB_16(y_ptr) \
+	r_16_1=r_uv_16_1; g_16_1=g_uv_16_1; b_16_1=b_uv_16_1; \
+	r_16_2=r_uv_16_2; g_16_2=g_uv_16_2; b_16_2=b_uv_16_2; \
+	\
+	READ_Y(y_ptr) \
+	y_16_1 = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(y))); \
+	y_16_2 = vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(y))); \
+	\
+	ADD_Y2RGB_16(y_16_1, y_16_2, r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2) \
+	\
+	r_8 = PACKUS_16(r_16_1, r_16_2); \
+	g_8 = PACKUS_16(g_16_1, g_16_2); \
+	b_8 = PACKUS_16(b_16_1, b_16_2); \
+
+#define YUV2RGB_16 \
+	int16x8_t g_tmp; \
+	int16x8_t r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2; \
+	int16x8_t r_uv_16_1, g_uv_16_1, b_uv_16_1, r_uv_16_2, g_uv_16_2, b_uv_16_2; \
+	int16x8_t y_16_1, y_16_2; \
+	int16x8_t u_16, v_16; \
+	uint8x16_t y, r_8, g_8, b_8; \
+	uint8x8_t u, v; \
+	\
+	READ_UV \
+	\
+	u_16 = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(u)), vdupq_n_s16(128)); \
+	v_16 = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(v)), vdupq_n_s16(128)); \
+	\
+	UV2RGB_16(u_16, v_16, r_uv_16_1, g_uv_16_1, b_uv_16_1, r_uv_16_2, g_uv_16_2, b_uv_16_2) \
+
+
+void NEON_FUNCTION_NAME(uint32_t width, uint32_t height,
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride,
+	uint8_t *RGB, uint32_t RGB_stride,
+	YCbCrType yuv_type)
+{
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
+#if YUV_FORMAT == YUV_FORMAT_420
+	const int y_pixel_stride = 1;
+	const int uv_pixel_stride = 1;
+	const int uv_x_sample_interval = 2;
+	const int uv_y_sample_interval = 2;
+#elif YUV_FORMAT == YUV_FORMAT_422
+	const int y_pixel_stride = 2;
+	const int uv_pixel_stride = 4;
+	const int uv_x_sample_interval = 2;
+	const int uv_y_sample_interval = 1;
+#elif YUV_FORMAT == YUV_FORMAT_NV12
+	const int y_pixel_stride = 1;
+	const int uv_pixel_stride = 2;
+	const int uv_x_sample_interval = 2;
+	const int uv_y_sample_interval = 2;
+#endif
+#if RGB_FORMAT == RGB_FORMAT_RGB565
+	const int rgb_pixel_stride = 2;
+#elif RGB_FORMAT == RGB_FORMAT_RGB24
+	const int rgb_pixel_stride = 3;
+#elif RGB_FORMAT == RGB_FORMAT_RGBA || RGB_FORMAT == RGB_FORMAT_BGRA || \
+      RGB_FORMAT == RGB_FORMAT_ARGB || RGB_FORMAT == RGB_FORMAT_ABGR
+	const int rgb_pixel_stride = 4;
+	const uint8x16_t a = vdupq_n_u8(0xFF);
+#else
+#error Unknown RGB pixel size
+#endif
+	/* The interleaved chroma loads read up to 3 bytes past the end of the
+	   block, so leave the last pixels of each line to the C version */
+#if YUV_FORMAT == YUV_FORMAT_420
+	const uint32_t converted = (width & ~15);
+#else
+	const uint32_t converted = (width > 2) ? ((width-2) & ~15) : 0;
+#endif
+
+	if (converted > 0) {
+		uint32_t xpos, ypos;
+		for(ypos=0; ypos<(height-(uv_y_sample_interval-1)); ypos+=uv_y_sample_interval)
+		{
+			const uint8_t *y_ptr1=Y+ypos*Y_stride,
+				*y_ptr2=Y+(ypos+1)*Y_stride,
+				*u_ptr=U+(ypos/uv_y_sample_interval)*UV_stride,
+				*v_ptr=V+(ypos/uv_y_sample_interval)*UV_stride;
+
+			uint8_t *rgb_ptr1=RGB+ypos*RGB_stride,
+				*rgb_ptr2=RGB+(ypos+1)*RGB_stride;
+
+			for(xpos=0; xpos<converted; xpos+=16)
+			{
+				YUV2RGB_16
+
+				Y2RGB_16(y_ptr1)
+				SAVE_LINE(rgb_ptr1)
+
+				if (uv_y_sample_interval > 1)
+				{
+					Y2RGB_16(y_ptr2)
+					SAVE_LINE(rgb_ptr2)
+				}
+
+				y_ptr1+=16*y_pixel_stride;
+				y_ptr2+=16*y_pixel_stride;
+				u_ptr+=16*uv_pixel_stride/uv_x_sample_interval;
+				v_ptr+=16*uv_pixel_stride/uv_x_sample_interval;
+				rgb_ptr1+=16*rgb_pixel_stride;
+				rgb_ptr2+=16*rgb_pixel_stride;
+			}
+		}
+
+		/* Catch the last line, if needed */
+		if (uv_y_sample_interval == 2 && ypos == (height-1))
+		{
+			const uint8_t *y_ptr=Y+ypos*Y_stride,
+				*u_ptr=U+(ypos/uv_y_sample_interval)*UV_stride,
+				*v_ptr=V+(ypos/uv_y_sample_interval)*UV_stride;
+
+			uint8_t *rgb_ptr=RGB+ypos*RGB_stride;
+
+			STD_FUNCTION_NAME(converted, 1, y_ptr, u_ptr, v_ptr, Y_stride, UV_stride, rgb_ptr, RGB_stride, yuv_type);
+		}
+	}
+
+	/* Catch the right column, if needed */
+	if (converted != width)
+	{
+		const uint8_t *y_ptr=Y+converted*y_pixel_stride,
+			*u_ptr=U+converted*uv_pixel_stride/uv_x_sample_interval,
+			*v_ptr=V+converted*uv_pixel_stride/uv_x_sample_interval;
+
+		uint8_t *rgb_ptr=RGB+converted*rgb_pixel_stride;
+
+		STD_FUNCTION_NAME(width-converted, height, y_ptr, u_ptr, v_ptr, Y_stride, UV_stride, rgb_ptr, RGB_stride, yuv_type);
+	}
+}
+
+#undef NEON_FUNCTION_NAME
+#undef STD_FUNCTION_NAME
+#undef YUV_FORMAT
+#undef RGB_FORMAT
+#undef UV2RGB_16
+#undef ADD_Y2RGB_16
+#undef PACKUS_16
+#undef PIXEL_BYTES
+#undef STORE_PIXEL_BYTES
+#undef STORE_PIXEL_BYTES_
+#undef SAVE_LINE
+#undef READ_Y
+#undef READ_UV
+#undef Y2RGB_16
+#undef YUV2RGB_16
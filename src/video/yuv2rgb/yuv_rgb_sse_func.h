@@ -37,16 +37,17 @@
 	G2 = _mm_unpackhi_epi16(g_tmp, g_tmp); \
 	B2 = _mm_unpackhi_epi16(b_tmp, b_tmp); \
 
+/* The sums can exceed 16 bits for saturated colors, so they saturate rather than wrap */
 #define ADD_Y2RGB_16(Y1,Y2,R1,G1,B1,R2,G2,B2) \
 	Y1 = _mm_mullo_epi16(_mm_sub_epi16(Y1, _mm_set1_epi16(param->y_shift)), _mm_set1_epi16(param->y_factor)); \
 	Y2 = _mm_mullo_epi16(_mm_sub_epi16(Y2, _mm_set1_epi16(param->y_shift)), _mm_set1_epi16(param->y_factor)); \
 	\
-	R1 = _mm_srai_epi16(_mm_add_epi16(R1, Y1), PRECISION); \
-	G1 = _mm_srai_epi16(_mm_add_epi16(G1, Y1), PRECISION); \
-	B1 = _mm_srai_epi16(_mm_add_epi16(B1, Y1), PRECISION); \
-	R2 = _mm_srai_epi16(_mm_add_epi16(R2, Y2), PRECISION); \
-	G2 = _mm_srai_epi16(_mm_add_epi16(G2, Y2), PRECISION); \
-	B2 = _mm_srai_epi16(_mm_add_epi16(B2, Y2), PRECISION); \
+	R1 = _mm_srai_epi16(_mm_adds_epi16(R1, Y1), PRECISION); \
+	G1 = _mm_srai_epi16(_mm_adds_epi16(G1, Y1), PRECISION); \
+	B1 = _mm_srai_epi16(_mm_adds_epi16(B1, Y1), PRECISION); \
+	R2 = _mm_srai_epi16(_mm_adds_epi16(R2, Y2), PRECISION); \
+	G2 = _mm_srai_epi16(_mm_adds_epi16(G2, Y2), PRECISION); \
+	B2 = _mm_srai_epi16(_mm_adds_epi16(B2, Y2), PRECISION); \
 
 #define PACK_RGB565_32(R1, R2, G1, G2, B1, B2, RGB1, RGB2, RGB3, RGB4) \
 { \
@@ -413,9 +414,16 @@ void SSE_FUNCTION_NAME(uint32_t width, uint32_t height,
 	const int rgb_pixel_stride = 4;
 #else
 #error Unknown RGB pixel size
+#endif
+	/* The interleaved chroma loads read up to 3 bytes past the end of the
+	   block, so leave the last pixels of each line to the C version */
+#if YUV_FORMAT == YUV_FORMAT_420
+	const uint32_t converted = (width & ~31);
+#else
+	const uint32_t converted = (width > 2) ? ((width-2) & ~31) : 0;
 #endif
 
-	if (width >= 32) {
+	if (converted > 0) {
 		uint32_t xpos, ypos;
 		for(ypos=0; ypos<(height-(uv_y_sample_interval-1)); ypos+=uv_y_sample_interval)
 		{
@@ -427,7 +435,7 @@ void SSE_FUNCTION_NAME(uint32_t width, uint32_t height,
 			uint8_t *rgb_ptr1=RGB+ypos*RGB_stride,
 				*rgb_ptr2=RGB+(ypos+1)*RGB_stride;
 			
-			for(xpos=0; xpos<(width-31); xpos+=32)
+			for(xpos=0; xpos<converted; xpos+=32)
 			{
 				YUV2RGB_32
 				{
@@ -457,23 +465,20 @@ void SSE_FUNCTION_NAME(uint32_t width, uint32_t height,
 			
 			uint8_t *rgb_ptr=RGB+ypos*RGB_stride;
 
-			STD_FUNCTION_NAME(width, 1, y_ptr, u_ptr, v_ptr, Y_stride, UV_stride, rgb_ptr, RGB_stride, yuv_type);
+			STD_FUNCTION_NAME(converted, 1, y_ptr, u_ptr, v_ptr, Y_stride, UV_stride, rgb_ptr, RGB_stride, yuv_type);
 		}
 	}
 
 	/* Catch the right column, if needed */
+	if (converted != width)
 	{
-		int converted = (width & ~31);
-		if (converted != width)
-		{
-			const uint8_t *y_ptr=Y+converted*y_pixel_stride,
-				*u_ptr=U+converted*uv_pixel_stride/uv_x_sample_interval,
-				*v_ptr=V+converted*uv_pixel_stride/uv_x_sample_interval;
-			
-			uint8_t *rgb_ptr=RGB+converted*rgb_pixel_stride;
+		const uint8_t *y_ptr=Y+converted*y_pixel_stride,
+			*u_ptr=U+converted*uv_pixel_stride/uv_x_sample_interval,
+			*v_ptr=V+converted*uv_pixel_stride/uv_x_sample_interval;
+		
+		uint8_t *rgb_ptr=RGB+converted*rgb_pixel_stride;
 
-			STD_FUNCTION_NAME(width-converted, height, y_ptr, u_ptr, v_ptr, Y_stride, UV_stride, rgb_ptr, RGB_stride, yuv_type);
-		}
+		STD_FUNCTION_NAME(width-converted, height, y_ptr, u_ptr, v_ptr, Y_stride, UV_stride, rgb_ptr, RGB_stride, yuv_type);
 	}
 }
 
@@ -486,6 +491,7 @@ void SSE_FUNCTION_NAME(uint32_t width, uint32_t height,
 #undef SAVE_SI128
 #undef UV2RGB_16
 #undef ADD_Y2RGB_16
+#undef PACK_RGB565_32
 #undef PACK_RGB24_32_STEP1
 #undef PACK_RGB24_32_STEP2
 #undef PACK_RGB24_32
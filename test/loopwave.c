@@ -44,10 +44,46 @@ quit(int rc)
     exit(rc);
 }
 
+/* Show how evenly the callbacks ran, before the device goes away. Set
+   SDL_AUDIO_DEADLINE_SCHEDULING=1 in the environment to compare. */
+static void
+print_stats()
+{
+    SDL_AudioDeviceStats stats;
+    Uint32 most = 1;
+    int i;
+
+    if (SDL_GetAudioDeviceStats(device, &stats) < 0) {
+        return;
+    }
+
+    SDL_Log("%u callbacks, one every %u us, %u late\n",
+            (unsigned int) stats.callbacks, (unsigned int) stats.period_us,
+            (unsigned int) stats.late_callbacks);
+    SDL_Log("Most jitter %u us, most lateness %u us, longest callback %u us\n",
+            (unsigned int) stats.max_jitter_us, (unsigned int) stats.max_lateness_us,
+            (unsigned int) stats.max_callback_us);
+
+    for (i = 0; i < SDL_AUDIO_JITTER_BUCKETS; i++) {
+        most = SDL_max(most, stats.jitter_histogram[i]);
+    }
+    for (i = 0; i < SDL_AUDIO_JITTER_BUCKETS; i++) {
+        char bar[41];
+        const int len = (int) ((((Uint64) stats.jitter_histogram[i]) * (sizeof (bar) - 1)) / most);
+        SDL_memset(bar, '#', len);
+        bar[len] = '\0';
+        SDL_Log("jitter %s %6u us: %8u %s\n",
+                (i < SDL_AUDIO_JITTER_BUCKETS - 1) ? "< " : ">=",
+                (unsigned int) (32u << ((i < SDL_AUDIO_JITTER_BUCKETS - 1) ? i : (i - 1))),
+                (unsigned int) stats.jitter_histogram[i], bar);
+    }
+}
+
 static void
 close_audio()
 {
     if (device != 0) {
+        print_stats();
         SDL_CloseAudioDevice(device);
         device = 0;
     }
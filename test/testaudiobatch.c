@@ -0,0 +1,183 @@
+/*
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Preconverts a level's worth of sound effects, the way a game would at load
+   time, once with SDL_ConvertAudio() on one buffer after the other and once
+   with SDL_ConvertAudioBatch(), and prints the wall time of both. The sounds
+   are between a tenth of a second and four seconds of noise.
+
+   Usage: testaudiobatch [number of sounds] */
+
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define RUNS 5
+
+static const struct
+{
+    const char *name;
+    SDL_AudioFormat src_format;
+    Uint8 src_channels;
+    int src_rate;
+    SDL_AudioFormat dst_format;
+    Uint8 dst_channels;
+    int dst_rate;
+} conversions[] = {
+    { "S16 mono 22050 Hz to F32 stereo 48000 Hz", AUDIO_S16SYS, 1, 22050, AUDIO_F32SYS, 2, 48000 },
+    { "S16 stereo 44100 Hz to S16 stereo 48000 Hz", AUDIO_S16SYS, 2, 44100, AUDIO_S16SYS, 2, 48000 },
+    { "U8 mono 22050 Hz to F32 stereo 22050 Hz", AUDIO_U8, 1, 22050, AUDIO_F32SYS, 2, 22050 }
+};
+
+/* Builds the conversions and fills their buffers, returns the input size */
+static Sint64
+make_sounds(int c, SDL_AudioCVT *cvts, Uint8 **sources, int count)
+{
+    const int framesize = conversions[c].src_channels * SDL_AUDIO_BITSIZE(conversions[c].src_format) / 8;
+    Sint64 total = 0;
+    int i, j;
+
+    for (i = 0; i < count; i++) {
+        const int frames = conversions[c].src_rate / 10 + rand() % (conversions[c].src_rate * 39 / 10);
+
+        if (SDL_BuildAudioCVT(&cvts[i], conversions[c].src_format, conversions[c].src_channels, conversions[c].src_rate,
+                              conversions[c].dst_format, conversions[c].dst_channels, conversions[c].dst_rate) < 0) {
+            return -1;
+        }
+        cvts[i].len = frames * framesize;
+        cvts[i].buf = (Uint8 *) SDL_malloc(cvts[i].len * cvts[i].len_mult);
+        sources[i] = (Uint8 *) SDL_malloc(cvts[i].len);
+        if (!cvts[i].buf || !sources[i]) {
+            SDL_OutOfMemory();
+            return -1;
+        }
+        for (j = 0; j < cvts[i].len; j++) {
+            sources[i][j] = (Uint8) rand();
+        }
+        total += cvts[i].len;
+    }
+    return total;
+}
+
+static void
+reset_sounds(SDL_AudioCVT *cvts, Uint8 **sources, int count)
+{
+    int i;
+
+    for (i = 0; i < count; i++) {
+        SDL_memcpy(cvts[i].buf, sources[i], cvts[i].len);
+    }
+}
+
+/* FNV-1a over all of the converted buffers, to check both ways agree */
+static Uint32
+checksum(const SDL_AudioCVT *cvts, int count)
+{
+    Uint32 hash = 2166136261u;
+    int i, j;
+
+    for (i = 0; i < count; i++) {
+        for (j = 0; j < cvts[i].len_cvt; j++) {
+            hash = (hash ^ cvts[i].buf[j]) * 16777619u;
+        }
+    }
+    return hash;
+}
+
+int
+main(int argc, char **argv)
+{
+    const double freq = (double) SDL_GetPerformanceFrequency();
+    const int count = (argc > 1) ? SDL_atoi(argv[1]) : 256;
+    SDL_AudioCVT *cvts;
+    Uint8 **sources;
+    int c, i, run;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (count <= 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "USAGE: %s [number of sounds]", argv[0]);
+        return 1;
+    }
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    cvts = (SDL_AudioCVT *) SDL_calloc(count, sizeof (*cvts));
+    sources = (Uint8 **) SDL_calloc(count, sizeof (*sources));
+    if (!cvts || !sources) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory!\n");
+        SDL_Quit();
+        return 1;
+    }
+
+    SDL_Log("Converting %d sounds on %d CPUs, best of %d runs\n", count, SDL_GetCPUCount(), RUNS);
+
+    srand(0);
+    for (c = 0; c < SDL_arraysize(conversions); c++) {
+        Uint64 serial = ~(Uint64) 0;
+        Uint64 batch = ~(Uint64) 0;
+        Uint32 serial_hash = 0, batch_hash = 0;
+        const Sint64 total = make_sounds(c, cvts, sources, count);
+
+        if (total < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't set up the sounds: %s\n", SDL_GetError());
+            break;
+        }
+
+        for (run = 0; run < RUNS; run++) {
+            Uint64 start;
+
+            reset_sounds(cvts, sources, count);
+            start = SDL_GetPerformanceCounter();
+            for (i = 0; i < count; i++) {
+                SDL_ConvertAudio(&cvts[i]);
+            }
+            serial = SDL_min(serial, SDL_GetPerformanceCounter() - start);
+            serial_hash = checksum(cvts, count);
+
+            reset_sounds(cvts, sources, count);
+            start = SDL_GetPerformanceCounter();
+            if (SDL_ConvertAudioBatch(cvts, count) < 0) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "SDL_ConvertAudioBatch() failed: %s\n", SDL_GetError());
+            }
+            batch = SDL_min(batch, SDL_GetPerformanceCounter() - start);
+            batch_hash = checksum(cvts, count);
+        }
+
+        SDL_Log("%s, %.1f MB in:\n", conversions[c].name, total / (1024.0 * 1024.0));
+        SDL_Log("  one by one %8.2f ms, batch %8.2f ms, %.2fx%s\n",
+                serial * 1000.0 / freq, batch * 1000.0 / freq, (double) serial / (double) batch,
+                (serial_hash == batch_hash) ? "" : " (OUTPUT DIFFERS!)");
+
+        for (i = 0; i < count; i++) {
+            SDL_free(cvts[i].buf);
+            SDL_free(sources[i]);
+            cvts[i].buf = NULL;
+            sources[i] = NULL;
+        }
+    }
+
+    for (i = 0; i < count; i++) {
+        SDL_free(cvts[i].buf);
+        SDL_free(sources[i]);
+    }
+    SDL_free(sources);
+    SDL_free(cvts);
+    SDL_Quit();
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,132 @@
+/*
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Times SDL_MixAudioFormat() mixing many voices into one output buffer,
+   a callback's worth at a time, like a software mixer would. */
+
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define FREQ 48000
+#define CHANNELS 2
+#define BLOCK_FRAMES 1024
+
+static const struct
+{
+    SDL_AudioFormat format;
+    const char *name;
+} formats[] = {
+    { AUDIO_S16LSB, "S16LSB" }, { AUDIO_S16MSB, "S16MSB" },
+    { AUDIO_S32LSB, "S32LSB" }, { AUDIO_S32MSB, "S32MSB" },
+    { AUDIO_F32LSB, "F32LSB" }, { AUDIO_F32MSB, "F32MSB" }
+};
+
+/* Fill (len) bytes with quiet noise in (format), so voices rarely clip. */
+static void
+fill_noise(Uint8 *buf, const int len, const SDL_AudioFormat format)
+{
+    const int samplesize = SDL_AUDIO_BITSIZE(format) / 8;
+    int i;
+
+    for (i = 0; i < len; i += samplesize) {
+        const float sample = (((float) (rand() % 2001)) - 1000.0f) / 16000.0f;
+        if (SDL_AUDIO_ISFLOAT(format)) {
+            const float f = SDL_AUDIO_ISBIGENDIAN(format) ? SDL_SwapFloatBE(sample) : SDL_SwapFloatLE(sample);
+            SDL_memcpy(buf + i, &f, sizeof (f));
+        } else if (samplesize == 4) {
+            const Uint32 s = (Uint32) (Sint32) (sample * 2147483647.0f);
+            const Uint32 v = SDL_AUDIO_ISBIGENDIAN(format) ? SDL_SwapBE32(s) : SDL_SwapLE32(s);
+            SDL_memcpy(buf + i, &v, sizeof (v));
+        } else {
+            const Uint16 s = (Uint16) (Sint16) (sample * 32767.0f);
+            const Uint16 v = SDL_AUDIO_ISBIGENDIAN(format) ? SDL_SwapBE16(s) : SDL_SwapLE16(s);
+            SDL_memcpy(buf + i, &v, sizeof (v));
+        }
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+    int voices = 64;
+    int seconds = 10;
+    int f;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (argc > 1) {
+        voices = SDL_atoi(argv[1]);
+    }
+    if (argc > 2) {
+        seconds = SDL_atoi(argv[2]);
+    }
+    if ((voices <= 0) || (seconds <= 0)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "USAGE: %s [voices] [seconds]", argv[0]);
+        return 1;
+    }
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    SDL_Log("Mixing %d voices of %d seconds, %d Hz, %d channels, %d frames per block\n",
+            voices, seconds, FREQ, CHANNELS, BLOCK_FRAMES);
+
+    for (f = 0; f < SDL_arraysize(formats); f++) {
+        const SDL_AudioFormat format = formats[f].format;
+        const int framesize = (SDL_AUDIO_BITSIZE(format) / 8) * CHANNELS;
+        const int totalframes = FREQ * seconds;
+        const int blocklen = BLOCK_FRAMES * framesize;
+        /* Every voice plays the same 10 seconds of noise, each from its own
+           starting point, so the source data doesn't all fit in cache. */
+        Uint8 *source = (Uint8 *) SDL_malloc(totalframes * framesize);
+        Uint8 *output = (Uint8 *) SDL_malloc(blocklen);
+        Uint64 start, elapsed;
+        double ms;
+        int frame;
+
+        if (!source || !output) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory!\n");
+            SDL_free(source);
+            SDL_free(output);
+            SDL_Quit();
+            return 1;
+        }
+
+        fill_noise(source, totalframes * framesize, format);
+
+        start = SDL_GetPerformanceCounter();
+        for (frame = 0; frame + BLOCK_FRAMES <= totalframes; frame += BLOCK_FRAMES) {
+            int v;
+            SDL_memset(output, 0, blocklen);
+            for (v = 0; v < voices; v++) {
+                const int offset = (frame + (v * 7919)) % (totalframes - BLOCK_FRAMES);
+                SDL_MixAudioFormat(output, source + (offset * framesize), format, blocklen, SDL_MIX_MAXVOLUME / 2);
+            }
+        }
+        elapsed = SDL_GetPerformanceCounter() - start;
+
+        ms = ((double) elapsed * 1000.0) / ((double) SDL_GetPerformanceFrequency());
+        SDL_Log("%s: %.1f ms (%.0fx realtime)\n", formats[f].name, ms, (seconds * 1000.0) / ms);
+
+        SDL_free(source);
+        SDL_free(output);
+    }
+
+    SDL_Quit();
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,143 @@
+/*
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Measures what mixing more and more SDL_AudioVoices costs, on a device with
+   256 frame buffers.
+
+   With the dummy driver (the default), the device runs in real time, and
+   this reports how much CPU time the process used per second of playback.
+   With the disk driver, the device runs flat out, writing to /dev/null, and
+   this reports how many times faster than real time it plays the voices. */
+
+#include <stdlib.h>
+#include <time.h>
+
+#include "SDL.h"
+
+#define FREQ 48000
+#define SAMPLES 256
+#define VOICE_FREQ 44100
+#define VOICE_SECONDS 2
+
+static const int voicecounts[] = { 0, 1, 2, 4, 8, 16, 32, 64, 128, 256 };
+
+static void
+run(const int nvoices, const SDL_bool flatout, const Sint16 *noise)
+{
+    SDL_AudioVoice *voices[256];
+    SDL_AudioSpec desired, obtained;
+    SDL_AudioDeviceID dev;
+    Uint64 start, elapsed;
+    clock_t cpu;
+    double seconds;
+    int i;
+
+    SDL_zero(desired);
+    desired.freq = FREQ;
+    desired.format = AUDIO_F32SYS;
+    desired.channels = 2;
+    desired.samples = SAMPLES;
+    desired.callback = NULL;
+
+    dev = SDL_OpenAudioDevice(NULL, 0, &desired, &obtained, 0);
+    if (!dev) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't open audio: %s\n", SDL_GetError());
+        return;
+    }
+
+    /* mono at another rate, so each voice converts and resamples. */
+    for (i = 0; i < nvoices; i++) {
+        voices[i] = SDL_NewAudioVoice(dev, AUDIO_S16SYS, 1, VOICE_FREQ);
+        if (!voices[i]) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create voice: %s\n", SDL_GetError());
+            break;
+        }
+        SDL_AudioVoicePut(voices[i], noise + ((i * 7919) % VOICE_FREQ), VOICE_FREQ * VOICE_SECONDS * sizeof (Sint16));
+        SDL_SetAudioVoiceGain(voices[i], 1.0f / 16.0f);
+        SDL_SetAudioVoicePan(voices[i], ((float) (i % 9) / 4.0f) - 1.0f);
+        SDL_PlayAudioVoice(voices[i]);
+    }
+
+    start = SDL_GetPerformanceCounter();
+    cpu = clock();
+    SDL_PauseAudioDevice(dev, 0);
+
+    if (flatout && (i > 0)) {
+        while (SDL_AudioVoiceQueued(voices[0]) > 0) {
+            SDL_Delay(1);
+        }
+    } else {
+        SDL_Delay(1000);
+    }
+
+    cpu = clock() - cpu;
+    elapsed = SDL_GetPerformanceCounter() - start;
+    seconds = ((double) elapsed) / ((double) SDL_GetPerformanceFrequency());
+
+    if (!flatout) {
+        SDL_Log("%3d voices: %5.1f%% CPU\n", nvoices, (100.0 * cpu / CLOCKS_PER_SEC) / seconds);
+    } else if (i > 0) {
+        SDL_Log("%3d voices: %7.1fx realtime\n", nvoices, VOICE_SECONDS / seconds);
+    }
+
+    SDL_CloseAudioDevice(dev);
+    while (i--) {
+        SDL_FreeAudioVoice(voices[i]);
+    }
+}
+
+int
+main(int argc, char **argv)
+{
+    const char *driver = (argc > 1) ? argv[1] : "dummy";
+    const SDL_bool flatout = (SDL_strcmp(driver, "disk") == 0);
+    const int nsamples = VOICE_FREQ * (VOICE_SECONDS + 1);
+    Sint16 *noise;
+    int i;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    SDL_setenv("SDL_AUDIODRIVER", driver, 1);
+    if (flatout) {
+        SDL_setenv("SDL_DISKAUDIOFILE", "/dev/null", 1);
+        SDL_setenv("SDL_DISKAUDIODELAY", "0", 1);
+    }
+
+    if (SDL_Init(SDL_INIT_AUDIO) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    noise = (Sint16 *) SDL_malloc(nsamples * sizeof (Sint16));
+    if (!noise) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory!\n");
+        SDL_Quit();
+        return 1;
+    }
+    for (i = 0; i < nsamples; i++) {
+        noise[i] = (Sint16) ((rand() % 16384) - 8192);
+    }
+
+    SDL_Log("Mixing voices on the %s driver, %d Hz stereo, %d frame buffers\n",
+            driver, FREQ, SAMPLES);
+
+    for (i = 0; i < SDL_arraysize(voicecounts); i++) {
+        run(voicecounts[i], flatout, noise);
+    }
+
+    SDL_free(noise);
+    SDL_Quit();
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -969,6 +969,1164 @@ int audio_openCloseAudioDeviceConnected()
 
 
 
+/**
+ * \brief Resamples a sine wave and checks it against the ideal output.
+ *
+ * \sa https://wiki.libsdl.org/SDL_ConvertAudio
+ */
+int audio_resampleSine()
+{
+   /* 44100 -> 44101 needs more filter phases than the resampler keeps, and uses the nearest one */
+   const int rates[][2] = { { 44100, 48000 }, { 48000, 44100 }, { 8000, 48000 }, { 22050, 48000 }, { 44100, 44101 } };
+   const int channels[] = { 1, 2, 6, 8 };
+   const double frequency = 440.0;
+   SDL_AudioCVT cvt;
+   float *samples;
+   int r, c, i, chan, result;
+
+   for (r = 0; r < SDL_arraysize(rates); r++) {
+     for (c = 0; c < SDL_arraysize(channels); c++) {
+       const int srcrate = rates[r][0];
+       const int dstrate = rates[r][1];
+       const int chans = channels[c];
+       const int srcframes = srcrate / 10;
+       int dstframes;
+       double maxerror = 0.0;
+
+       result = SDL_BuildAudioCVT(&cvt, AUDIO_F32SYS, chans, srcrate, AUDIO_F32SYS, chans, dstrate);
+       SDLTest_AssertPass("Call to SDL_BuildAudioCVT(F32, %i, %i, F32, %i, %i)", chans, srcrate, chans, dstrate);
+       SDLTest_AssertCheck(result == 1, "Verify result value; expected: 1, got: %i", result);
+       if (result != 1) {
+         return TEST_ABORTED;
+       }
+
+       cvt.len = srcframes * chans * sizeof (float);
+       cvt.buf = (Uint8 *)SDL_malloc(cvt.len * cvt.len_mult);
+       SDLTest_AssertCheck(cvt.buf != NULL, "Check data buffer to convert is not NULL");
+       if (cvt.buf == NULL) {
+         return TEST_ABORTED;
+       }
+
+       /* Each channel gets its own phase so mixed up channels show up as errors */
+       samples = (float *)cvt.buf;
+       for (i = 0; i < srcframes; i++) {
+         for (chan = 0; chan < chans; chan++) {
+           samples[i * chans + chan] = (float)(0.5 * SDL_sin(2.0 * M_PI * frequency * i / srcrate + chan));
+         }
+       }
+
+       result = SDL_ConvertAudio(&cvt);
+       SDLTest_AssertPass("Call to SDL_ConvertAudio()");
+       SDLTest_AssertCheck(result == 0, "Verify result value; expected: 0, got: %i", result);
+       dstframes = cvt.len_cvt / (chans * sizeof (float));
+       SDLTest_AssertCheck(SDL_abs(dstframes - (int)((double)srcframes * dstrate / srcrate)) <= 1,
+         "Verify output length; expected: %i frames, got: %i", (int)((double)srcframes * dstrate / srcrate), dstframes);
+
+       /* Skip the ends, where the filter sees the silent padding */
+       samples = (float *)cvt.buf;
+       for (i = 16; i < dstframes - 16; i++) {
+         for (chan = 0; chan < chans; chan++) {
+           const double expected = 0.5 * SDL_sin(2.0 * M_PI * frequency * i / dstrate + chan);
+           const double error = SDL_fabs(samples[i * chans + chan] - expected);
+           if (error > maxerror) {
+             maxerror = error;
+           }
+         }
+       }
+       SDLTest_AssertCheck(maxerror < 0.01, "Verify %i -> %i Hz, %i channels matches the ideal sine; max error %f", srcrate, dstrate, chans, maxerror);
+
+       SDL_free(cvt.buf);
+     }
+   }
+
+   return TEST_COMPLETED;
+}
+
+/* Phase of a linear sweep from f0 to f1 Hz over (duration) seconds, at (t) seconds */
+static double
+_sweepPhase(double t, double f0, double f1, double duration)
+{
+   return 2.0 * M_PI * ((f0 * t) + (0.5 * ((f1 - f0) / duration) * t * t));
+}
+
+/**
+ * \brief Resample a sine sweep at every quality level, reporting THD+N and CPU time.
+ *
+ * \sa https://wiki.libsdl.org/SDL_AudioStreamSetResampleQuality
+ */
+int audio_resampleQuality()
+{
+   const int rates[][2] = { { 44100, 48000 }, { 48000, 44100 }, { 22050, 48000 }, { 48000, 22050 } };
+   const char *names[] = { "nearest", "linear", "cubic", "sinc-low", "sinc-high" };
+   /* THD+N each level must beat; the sweep stays well inside every filter's passband */
+   const double limits[] = { -10.0, -20.0, -35.0, -55.0, -90.0 };
+   const int iterations = 4;
+   SDL_AudioStream *stream;
+   float *input, *output;
+   int r, q, i, n, result;
+
+   result = SDL_AudioStreamSetResampleQuality(NULL, SDL_RESAMPLE_CUBIC);
+   SDLTest_AssertPass("Call to SDL_AudioStreamSetResampleQuality(NULL, ...)");
+   SDLTest_AssertCheck(result == -1, "Verify result value; expected: -1, got: %i", result);
+
+   for (r = 0; r < SDL_arraysize(rates); r++) {
+     const int srcrate = rates[r][0];
+     const int dstrate = rates[r][1];
+     const int srcframes = srcrate;
+     const double duration = (double)srcframes / srcrate;
+     const double f1 = 0.2 * SDL_min(srcrate, dstrate);
+
+     input = (float *)SDL_malloc(srcframes * sizeof (float));
+     output = (float *)SDL_malloc((((Sint64)srcframes * dstrate / srcrate) + 1024) * sizeof (float));
+     SDLTest_AssertCheck(input != NULL && output != NULL, "Check sweep buffers are not NULL");
+     if (input == NULL || output == NULL) {
+       SDL_free(input);
+       SDL_free(output);
+       return TEST_ABORTED;
+     }
+     for (i = 0; i < srcframes; i++) {
+       input[i] = (float)(0.5 * SDL_sin(_sweepPhase((double)i / srcrate, 20.0, f1, duration)));
+     }
+
+     for (q = SDL_RESAMPLE_NEAREST; q <= SDL_RESAMPLE_SINC_HIGH; q++) {
+       Uint64 best = 0;
+       double noise = 0.0, signal = 0.0, thdn;
+       int dstframes = 0;
+
+       /* Feed everything in one go: the best of a few runs is the CPU time */
+       for (n = 0; n < iterations; n++) {
+         Uint64 start;
+         stream = SDL_NewAudioStream(AUDIO_F32SYS, 1, srcrate, AUDIO_F32SYS, 1, dstrate);
+         SDLTest_AssertCheck(stream != NULL, "Verify SDL_NewAudioStream(F32, 1, %i, F32, 1, %i) succeeded", srcrate, dstrate);
+         if (stream == NULL) {
+           SDL_free(input);
+           SDL_free(output);
+           return TEST_ABORTED;
+         }
+         result = SDL_AudioStreamSetResampleQuality(stream, (SDL_AudioResampleQuality)q);
+         SDLTest_AssertCheck(result == 0, "Verify SDL_AudioStreamSetResampleQuality(%s) result; expected: 0, got: %i", names[q], result);
+
+         start = SDL_GetPerformanceCounter();
+         SDL_AudioStreamPut(stream, input, srcframes * sizeof (float));
+         SDL_AudioStreamFlush(stream);
+         dstframes = SDL_AudioStreamGet(stream, output, SDL_AudioStreamAvailable(stream)) / sizeof (float);
+         start = SDL_GetPerformanceCounter() - start;
+         if (n == 0 || start < best) {
+           best = start;
+         }
+         SDL_FreeAudioStream(stream);
+       }
+
+       /* Skip the ends, where the filter sees the silent padding */
+       for (i = dstframes / 20; i < dstframes - (dstframes / 20); i++) {
+         const double expected = 0.5 * SDL_sin(_sweepPhase((double)i / dstrate, 20.0, f1, duration));
+         noise += (output[i] - expected) * (output[i] - expected);
+         signal += expected * expected;
+       }
+       thdn = 10.0 * SDL_log10(noise / signal);
+
+       SDLTest_Log("%i -> %i Hz, %s: THD+N %.1f dB, %.2f ns/frame", srcrate, dstrate, names[q], thdn,
+                   (double)best * 1000000000.0 / SDL_GetPerformanceFrequency() / SDL_max(dstframes, 1));
+       SDLTest_AssertCheck(thdn < limits[q], "Verify %i -> %i Hz, %s THD+N; expected: < %.0f dB, got: %.1f dB", srcrate, dstrate, names[q], limits[q], thdn);
+     }
+
+     SDL_free(input);
+     SDL_free(output);
+   }
+
+   return TEST_COMPLETED;
+}
+
+/* Counts SDL allocations made while audio_streamChunks is measuring */
+static int _streamAllocations = 0;
+static SDL_malloc_func _streamMalloc;
+static SDL_calloc_func _streamCalloc;
+static SDL_realloc_func _streamRealloc;
+static SDL_free_func _streamFree;
+
+static void * SDLCALL _countingMalloc(size_t size)
+{
+   _streamAllocations++;
+   return _streamMalloc(size);
+}
+
+static void * SDLCALL _countingCalloc(size_t nmemb, size_t size)
+{
+   _streamAllocations++;
+   return _streamCalloc(nmemb, size);
+}
+
+static void * SDLCALL _countingRealloc(void *mem, size_t size)
+{
+   _streamAllocations++;
+   return _streamRealloc(mem, size);
+}
+
+/**
+ * \brief Feed an audio stream in odd sized pieces; check the output matches one big put, and puts don't allocate.
+ *
+ * \sa https://wiki.libsdl.org/SDL_AudioStreamPut
+ */
+int audio_streamChunks()
+{
+   const int srcrate = 44100;
+   const int dstrate = 48000;
+   const int srcframes = srcrate / 2;
+   const int dstframes = (int)(((Sint64)srcframes * dstrate + srcrate - 1) / srcrate);
+   const int pieces[] = { 1, 17, 441, 4096 };
+   SDL_AudioStream *stream;
+   Sint16 *input;
+   float *expected, *output;
+   double maxerror;
+   int p, i, pos, len, result, allocations;
+
+   input = (Sint16 *)SDL_malloc(srcframes * 2 * sizeof (Sint16));
+   expected = (float *)SDL_malloc(dstframes * 2 * sizeof (float));
+   output = (float *)SDL_malloc(dstframes * 2 * sizeof (float));
+   SDLTest_AssertCheck(input != NULL && expected != NULL && output != NULL, "Check stream buffers are not NULL");
+   if (input == NULL || expected == NULL || output == NULL) {
+     SDL_free(input);
+     SDL_free(expected);
+     SDL_free(output);
+     return TEST_ABORTED;
+   }
+   for (i = 0; i < srcframes * 2; i++) {
+     input[i] = (Sint16)(16000.0 * SDL_sin(2.0 * M_PI * 440.0 * (i / 2) / srcrate + (i % 2)));
+   }
+
+   /* Everything in one put is the reference */
+   stream = SDL_NewAudioStream(AUDIO_S16SYS, 2, srcrate, AUDIO_F32SYS, 2, dstrate);
+   SDLTest_AssertCheck(stream != NULL, "Verify SDL_NewAudioStream(S16, 2, %i, F32, 2, %i) succeeded", srcrate, dstrate);
+   if (stream == NULL) {
+     SDL_free(input);
+     SDL_free(expected);
+     SDL_free(output);
+     return TEST_ABORTED;
+   }
+   SDL_AudioStreamPut(stream, input, srcframes * 2 * sizeof (Sint16));
+   SDL_AudioStreamFlush(stream);
+   len = SDL_AudioStreamGet(stream, expected, dstframes * 2 * sizeof (float));
+   SDLTest_AssertCheck(len == dstframes * 2 * sizeof (float), "Verify output length; expected: %i, got: %i", (int)(dstframes * 2 * sizeof (float)), len);
+   SDL_FreeAudioStream(stream);
+
+   for (p = 0; p < SDL_arraysize(pieces); p++) {
+     stream = SDL_NewAudioStream(AUDIO_S16SYS, 2, srcrate, AUDIO_F32SYS, 2, dstrate);
+     SDLTest_AssertCheck(stream != NULL, "Verify SDL_NewAudioStream(S16, 2, %i, F32, 2, %i) succeeded", srcrate, dstrate);
+     if (stream == NULL) {
+       break;
+     }
+
+     /* Read as we go, the way an audio device does, so queue packets get
+        recycled; the first put may still grow the queue's packet pool */
+     allocations = 0;
+     len = 0;
+     for (pos = 0; pos < srcframes; pos += pieces[p]) {
+       const int frames = SDL_min(pieces[p], srcframes - pos);
+       result = SDL_AudioStreamPut(stream, input + pos * 2, frames * 2 * sizeof (Sint16));
+       if (result != 0) {
+         break;
+       }
+       len += SDL_AudioStreamGet(stream, (Uint8 *)output + len, dstframes * 2 * sizeof (float) - len);
+       if (pos == 0) {
+         SDL_GetMemoryFunctions(&_streamMalloc, &_streamCalloc, &_streamRealloc, &_streamFree);
+         SDL_SetMemoryFunctions(_countingMalloc, _countingCalloc, _countingRealloc, _streamFree);
+         _streamAllocations = 0;
+       }
+     }
+     if (pos > 0) {
+       allocations = _streamAllocations;
+       SDL_SetMemoryFunctions(_streamMalloc, _streamCalloc, _streamRealloc, _streamFree);
+     }
+     SDLTest_AssertCheck(result == 0, "Verify SDL_AudioStreamPut() in %i frame pieces succeeded", pieces[p]);
+     SDLTest_AssertCheck(allocations == 0, "Verify putting in %i frame pieces allocates nothing; got %i allocations", pieces[p], allocations);
+
+     SDL_AudioStreamFlush(stream);
+     len += SDL_AudioStreamGet(stream, (Uint8 *)output + len, dstframes * 2 * sizeof (float) - len);
+     SDLTest_AssertCheck(len == dstframes * 2 * sizeof (float), "Verify output length in %i frame pieces; expected: %i, got: %i", pieces[p], (int)(dstframes * 2 * sizeof (float)), len);
+
+     /* The resampler carries its phase from put to put, so only the converters' rounding may differ */
+     maxerror = 0.0;
+     for (i = 0; i < len / (int)sizeof (float); i++) {
+       const double error = SDL_fabs(output[i] - expected[i]);
+       if (error > maxerror) {
+         maxerror = error;
+       }
+     }
+     SDLTest_AssertCheck(maxerror < 0.0001, "Verify output in %i frame pieces matches one big put; max error %f", pieces[p], maxerror);
+
+     SDL_FreeAudioStream(stream);
+   }
+
+   SDL_free(input);
+   SDL_free(expected);
+   SDL_free(output);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * \brief Queue more than the device's queue holds, clear it, and drain it.
+ *
+ * \sa https://wiki.libsdl.org/SDL_QueueAudio
+ * \sa https://wiki.libsdl.org/SDL_GetQueuedAudioSize
+ * \sa https://wiki.libsdl.org/SDL_ClearQueuedAudio
+ */
+int audio_queueRing()
+{
+   SDL_AudioDeviceID id;
+   SDL_AudioSpec desired, obtained;
+   Uint8 data[6000];
+   Uint32 queued, underruns, overruns;
+   int result, i;
+
+   if (SDL_GetNumAudioDevices(0) <= 0) {
+     SDLTest_Log("No devices to test with");
+     return TEST_COMPLETED;
+   }
+
+   SDL_memset(data, 0x10, sizeof (data));
+
+   /* As small a queue as the hint allows: two callbacks, 4096 bytes. */
+   SDL_SetHint(SDL_HINT_AUDIO_QUEUE_SIZE, "1");
+   SDL_zero(desired);
+   desired.freq = 22050;
+   desired.format = AUDIO_S16SYS;
+   desired.channels = 2;
+   desired.samples = 512;
+   desired.callback = NULL;
+   id = SDL_OpenAudioDevice(NULL, 0, &desired, &obtained, 0);
+   SDL_SetHint(SDL_HINT_AUDIO_QUEUE_SIZE, NULL);
+   SDLTest_AssertPass("SDL_OpenAudioDevice(NULL,...) for queueing");
+   SDLTest_AssertCheck(id > 1, "Validate device ID; expected: >=2, got: %i", id);
+   if (id <= 1) {
+     return TEST_ABORTED;
+   }
+
+   result = SDL_GetQueuedAudioStats(id, &underruns, &overruns);
+   SDLTest_AssertCheck(result == 0 && underruns == 0 && overruns == 0, "Verify stats start at zero; got %i, %u underruns, %u overruns", result, (unsigned int) underruns, (unsigned int) overruns);
+
+   /* The device starts paused, so nothing drains yet. */
+   result = SDL_QueueAudio(id, data, 3000);
+   SDLTest_AssertCheck(result == 0, "Verify SDL_QueueAudio(3000) succeeded");
+   result = SDL_QueueAudio(id, data, sizeof (data));
+   SDLTest_AssertCheck(result == 0, "Verify SDL_QueueAudio(%i) past the end of the queue succeeded", (int) sizeof (data));
+   queued = SDL_GetQueuedAudioSize(id);
+   SDLTest_AssertCheck(queued == 3000 + sizeof (data), "Verify queued size; expected: %i, got: %u", 3000 + (int) sizeof (data), (unsigned int) queued);
+   SDL_GetQueuedAudioStats(id, &underruns, &overruns);
+   SDLTest_AssertCheck(overruns == 1, "Verify outgrowing the queue counts one overrun; got %u", (unsigned int) overruns);
+
+   SDL_ClearQueuedAudio(id);
+   queued = SDL_GetQueuedAudioSize(id);
+   SDLTest_AssertCheck(queued == 0, "Verify queue is empty after SDL_ClearQueuedAudio(); got: %u", (unsigned int) queued);
+
+   /* Spill over into a new block again, then let the device play it all. */
+   for (i = 0; i < 4; i++) {
+     SDL_QueueAudio(id, data, sizeof (data));
+   }
+   queued = SDL_GetQueuedAudioSize(id);
+   SDLTest_AssertCheck(queued == 4 * sizeof (data), "Verify queued size; expected: %i, got: %u", 4 * (int) sizeof (data), (unsigned int) queued);
+
+   SDL_PauseAudioDevice(id, 0);
+   for (i = 0; (i < 200) && (SDL_GetQueuedAudioSize(id) > 0); i++) {
+     SDL_Delay(10);
+   }
+   SDL_Delay(100);  /* let it run dry. */
+   SDL_PauseAudioDevice(id, 1);
+   queued = SDL_GetQueuedAudioSize(id);
+   SDLTest_AssertCheck(queued == 0, "Verify the device drained the queue; got: %u", (unsigned int) queued);
+   SDL_GetQueuedAudioStats(id, &underruns, &overruns);
+   SDLTest_AssertCheck(underruns == 1, "Verify running dry counts one underrun; got %u", (unsigned int) underruns);
+
+   SDL_CloseAudioDevice(id);
+   SDLTest_AssertPass("Call to SDL_CloseAudioDevice()");
+
+   return TEST_COMPLETED;
+}
+
+/* Reference mix of one sample for audio_mixAudioFormat(), in the native byte order. */
+static double
+_mixReferenceSample(const SDL_AudioFormat format, const double dst, const double src, const int volume)
+{
+   double sum;
+   if (SDL_AUDIO_ISFLOAT(format)) {
+     sum = dst + (double) (((float) src * (float) volume) * (1.0f / SDL_MIX_MAXVOLUME));
+     return (double) (float) SDL_max(SDL_min(sum, 3.402823466e+38), -3.402823466e+38);
+   } else {
+     const double maxval = (SDL_AUDIO_BITSIZE(format) == 16) ? 32767.0 : 2147483647.0;
+     const double scaled = src * volume / SDL_MIX_MAXVOLUME;
+     /* C division rounds toward zero */
+     sum = dst + ((scaled < 0.0) ? SDL_ceil(scaled) : SDL_floor(scaled));
+     return SDL_max(SDL_min(sum, maxval), -maxval - 1.0);
+   }
+}
+
+static double
+_mixReadSample(const SDL_AudioFormat format, const Uint8 *p)
+{
+   const SDL_bool swap = (SDL_AUDIO_ISBIGENDIAN(format) != 0) != (SDL_BYTEORDER == SDL_BIG_ENDIAN);
+   if (SDL_AUDIO_BITSIZE(format) == 16) {
+     Uint16 v;
+     SDL_memcpy(&v, p, sizeof (v));
+     return (double) (Sint16) (swap ? SDL_Swap16(v) : v);
+   } else {
+     Uint32 v;
+     float f;
+     SDL_memcpy(&v, p, sizeof (v));
+     v = swap ? SDL_Swap32(v) : v;
+     if (!SDL_AUDIO_ISFLOAT(format)) {
+       return (double) (Sint32) v;
+     }
+     SDL_memcpy(&f, &v, sizeof (f));
+     return (double) f;
+   }
+}
+
+/**
+ * \brief Mix every format with SIMD paths at odd alignments and lengths, against a reference.
+ *
+ * \sa https://wiki.libsdl.org/SDL_MixAudioFormat
+ */
+int audio_mixAudioFormat()
+{
+   static const SDL_AudioFormat formats[] = { AUDIO_S16LSB, AUDIO_S16MSB, AUDIO_S32LSB, AUDIO_S32MSB, AUDIO_F32LSB, AUDIO_F32MSB };
+   static const int volumes[] = { 1, 37, 64, SDL_MIX_MAXVOLUME };
+   const int buflen = 512;
+   /* The source is offset by up to (63 / 2) * 3 = 93 bytes, more than the destination. */
+   const int srclen = buflen + 128;
+   Uint8 *src = (Uint8 *) SDL_malloc(srclen);
+   Uint8 *dst = (Uint8 *) SDL_malloc(buflen + 64);
+   Uint8 *orig = (Uint8 *) SDL_malloc(buflen + 64);
+   int f, v, offset, len, i;
+
+   SDLTest_AssertCheck(src && dst && orig, "Allocate buffers");
+   if (!src || !dst || !orig) {
+     SDL_free(src);
+     SDL_free(dst);
+     SDL_free(orig);
+     return TEST_ABORTED;
+   }
+
+   for (f = 0; f < SDL_arraysize(formats); f++) {
+     const SDL_AudioFormat format = formats[f];
+     const int samplesize = SDL_AUDIO_BITSIZE(format) / 8;
+     int mismatches = 0;
+
+     for (v = 0; v < SDL_arraysize(volumes); v++) {
+       for (offset = 0; offset < 64; offset += samplesize) {
+         for (len = 0; len <= buflen; len += samplesize * 13) {
+           /* Loud random data, so saturation happens a lot. */
+           for (i = 0; i < srclen; i++) {
+             src[i] = (Uint8) SDLTest_RandomIntegerInRange(0, 255);
+           }
+           for (i = 0; i < buflen + 64; i++) {
+             orig[i] = (Uint8) SDLTest_RandomIntegerInRange(0, 255);
+           }
+           if (SDL_AUDIO_ISFLOAT(format)) {
+             for (i = 0; i + 4 <= srclen; i += 4) {
+               const float s = SDLTest_RandomUnitFloat() * 2.0f - 1.0f;
+               const float se = SDL_AUDIO_ISBIGENDIAN(format) ? SDL_SwapFloatBE(s) : SDL_SwapFloatLE(s);
+               SDL_memcpy(src + i, &se, 4);
+             }
+             for (i = 0; i + 4 <= buflen + 64; i += 4) {
+               const float d = SDLTest_RandomUnitFloat() * 2.0f - 1.0f;
+               const float de = SDL_AUDIO_ISBIGENDIAN(format) ? SDL_SwapFloatBE(d) : SDL_SwapFloatLE(d);
+               SDL_memcpy(orig + i, &de, 4);
+             }
+           }
+           SDL_memcpy(dst, orig, buflen + 64);
+
+           SDL_MixAudioFormat(dst + offset, src + (offset / 2) * 3, format, len, volumes[v]);
+
+           for (i = 0; i < buflen + 64; i += samplesize) {
+             double expected = _mixReadSample(format, orig + i);
+             const double got = _mixReadSample(format, dst + i);
+             if ((i >= offset) && (i < offset + len)) {
+               expected = _mixReferenceSample(format, expected, _mixReadSample(format, src + (offset / 2) * 3 + (i - offset)), volumes[v]);
+             }
+             /* floats are summed in single precision when vectorized, so allow an ulp or so */
+             if (SDL_fabs(got - expected) > (SDL_AUDIO_ISFLOAT(format) ? SDL_max(SDL_fabs(expected), 1.0) * 1e-6 : 0.0)) {
+               mismatches++;
+             }
+           }
+         }
+       }
+     }
+     SDLTest_AssertCheck(mismatches == 0, "Verify SDL_MixAudioFormat(0x%.4x) matches the reference at every alignment, length and volume; %d mismatches", format, mismatches);
+   }
+
+   SDL_free(src);
+   SDL_free(dst);
+   SDL_free(orig);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * \brief Mix voices through the disk driver and check what it wrote.
+ *
+ * \sa https://wiki.libsdl.org/SDL_NewAudioVoice
+ */
+int audio_audioVoices()
+{
+   SDL_AudioDeviceID id;
+   SDL_AudioSpec desired, obtained;
+   SDL_AudioVoice *voice, *voice2;
+   SDL_RWops *rw;
+   Sint16 *data;
+   float frame[2];
+   float last = 0.0f;
+   int result, i;
+   int played = 0, ramping = 0, badleft = 0, badright = 0, backwards = 0;
+   const int frames = 48000;
+   const char *outfile = "audio_audioVoices.raw";
+   Uint32 queued;
+
+   /* Only the disk driver lets us look at what got mixed. */
+   SDL_AudioQuit();
+   result = SDL_AudioInit("disk");
+   if (result != 0) {
+     SDLTest_Log("Disk audio driver not available, skipping");
+     SDL_AudioInit(NULL);
+     return TEST_SKIPPED;
+   }
+
+   SDL_zero(desired);
+   desired.freq = 48000;
+   desired.format = AUDIO_F32SYS;
+   desired.channels = 2;
+   desired.samples = 256;
+   desired.callback = NULL;
+   /* The disk driver writes to a file named after the device. */
+   id = SDL_OpenAudioDevice(outfile, 0, &desired, &obtained, 0);
+   SDLTest_AssertPass("SDL_OpenAudioDevice('%s',...) on the disk driver", outfile);
+   SDLTest_AssertCheck(id > 1, "Validate device ID; expected: >=2, got: %i", id);
+   if (id <= 1) {
+     SDL_AudioQuit();
+     SDL_AudioInit(NULL);
+     return TEST_ABORTED;
+   }
+
+   voice = SDL_NewAudioVoice(0, AUDIO_S16SYS, 1, 48000);
+   SDLTest_AssertCheck(voice == NULL, "Verify SDL_NewAudioVoice() on a bogus device fails");
+
+   /* Mono at half scale, at half gain, panned hard right. */
+   voice = SDL_NewAudioVoice(id, AUDIO_S16SYS, 1, 48000);
+   data = (Sint16 *) SDL_malloc(frames * sizeof (Sint16));
+   SDLTest_AssertCheck(voice != NULL, "Verify SDL_NewAudioVoice() succeeded");
+   SDLTest_AssertCheck(data != NULL, "Verify buffer allocated");
+   if ((voice == NULL) || (data == NULL)) {
+     SDL_free(data);
+     SDL_FreeAudioVoice(voice);
+     SDL_CloseAudioDevice(id);
+     remove(outfile);
+     SDL_AudioQuit();
+     SDL_AudioInit(NULL);
+     return TEST_ABORTED;
+   }
+   for (i = 0; i < frames; i++) {
+     data[i] = 16384;
+   }
+   result = SDL_AudioVoicePut(voice, data, 3);
+   SDLTest_AssertCheck(result == -1, "Verify SDL_AudioVoicePut() rejects a partial frame");
+   result = SDL_AudioVoicePut(voice, data, frames * sizeof (Sint16));
+   SDLTest_AssertCheck(result == 0, "Verify SDL_AudioVoicePut() succeeded");
+   queued = SDL_AudioVoiceQueued(voice);
+   SDLTest_AssertCheck(queued == frames * sizeof (Sint16), "Verify queued size; expected: %i, got: %u", frames * (int) sizeof (Sint16), (unsigned int) queued);
+   SDL_free(data);
+
+   SDL_SetAudioVoiceGain(voice, 0.5f);
+   SDL_SetAudioVoicePan(voice, 1.0f);
+   result = SDL_PlayAudioVoice(voice);
+   SDLTest_AssertCheck(result == 0, "Verify SDL_PlayAudioVoice() succeeded");
+   result = SDL_PlayAudioVoice(voice);
+   SDLTest_AssertCheck(result == 0, "Verify playing a playing voice succeeds");
+
+   /* A voice freed while playing gets retired by the audio thread. */
+   voice2 = SDL_NewAudioVoice(id, AUDIO_F32SYS, 2, 22050);
+   SDLTest_AssertCheck(voice2 != NULL, "Verify second SDL_NewAudioVoice() succeeded");
+   SDL_PlayAudioVoice(voice2);
+   SDL_FreeAudioVoice(voice2);
+   SDLTest_AssertPass("Call to SDL_FreeAudioVoice() on a playing voice");
+
+   SDL_PauseAudioDevice(id, 0);
+   SDL_Delay(200);
+   SDL_SetAudioVoiceGain(voice, 1.0f);  /* ramps up to full scale. */
+   SDL_Delay(100);
+   SDL_StopAudioVoice(voice);
+   SDL_Delay(50);
+   SDL_PauseAudioDevice(id, 1);
+
+   queued = SDL_AudioVoiceQueued(voice);
+   SDLTest_AssertCheck(queued > 0 && queued < frames * sizeof (Sint16), "Verify stopping keeps the rest queued; got: %u", (unsigned int) queued);
+
+   SDL_CloseAudioDevice(id);
+   SDLTest_AssertPass("Call to SDL_CloseAudioDevice()");
+   result = SDL_PlayAudioVoice(voice);
+   SDLTest_AssertCheck(result == -1, "Verify playing a voice on a closed device fails");
+   SDL_FreeAudioVoice(voice);
+   SDLTest_AssertPass("Call to SDL_FreeAudioVoice() after closing its device");
+
+   /* Left should be silent; right starts at 0.25, ramps up and holds at 0.5. */
+   rw = SDL_RWFromFile(outfile, "rb");
+   SDLTest_AssertCheck(rw != NULL, "Verify the disk driver's output can be opened");
+   if (rw != NULL) {
+     while (SDL_RWread(rw, frame, sizeof (frame), 1) == 1) {
+       if (frame[0] != 0.0f) {
+         badleft++;
+       }
+       if (frame[1] == 0.0f) {
+         continue;
+       }
+       if (((played == 0) && (frame[1] != 0.25f)) || (frame[1] < 0.25f) || (frame[1] > 0.5f)) {
+         badright++;
+       } else if (frame[1] < last) {
+         backwards++;
+       } else if (frame[1] > 0.25f && frame[1] < 0.5f) {
+         ramping++;
+       }
+       last = frame[1];
+       played++;
+     }
+     SDL_RWclose(rw);
+   }
+   remove(outfile);
+   SDLTest_AssertCheck(played > 0, "Verify the voice played; got %i frames", played);
+   SDLTest_AssertCheck(badleft == 0, "Verify pan silenced the left channel; got %i nonzero frames", badleft);
+   SDLTest_AssertCheck(badright == 0, "Verify the right channel stayed within the gains; got %i bad frames", badright);
+   SDLTest_AssertCheck(backwards == 0, "Verify the gain only went up; got %i frames going down", backwards);
+   SDLTest_AssertCheck(ramping > 0, "Verify the gain change ramped; got %i frames in between", ramping);
+   SDLTest_AssertCheck(last == 0.5f, "Verify the ramp ended at full gain; got %f", last);
+
+   SDL_AudioQuit();
+   SDL_AudioInit(NULL);
+   return TEST_COMPLETED;
+}
+
+/* Callback for audio_deviceStats(); just plays silence. */
+static void SDLCALL _audio_statsCallback(void *userdata, Uint8 *stream, int len)
+{
+   SDL_memset(stream, 0, len);
+}
+
+/**
+ * \brief Check callback timing stats, with and without deadline scheduling.
+ *
+ * \sa https://wiki.libsdl.org/SDL_GetAudioDeviceStats
+ */
+int audio_deviceStats()
+{
+   SDL_AudioDeviceID id;
+   SDL_AudioSpec desired, obtained;
+   SDL_AudioDeviceStats stats;
+   Uint32 total, expected;
+   Uint64 start;
+   double seconds;
+   int result, mode, i;
+
+   if (SDL_GetNumAudioDevices(0) <= 0) {
+     SDLTest_Log("No devices to test with");
+     return TEST_COMPLETED;
+   }
+
+   result = SDL_GetAudioDeviceStats(0, &stats);
+   SDLTest_AssertCheck(result == -1, "Verify SDL_GetAudioDeviceStats() on a bogus device fails");
+
+   for (mode = 0; mode < 2; mode++) {
+     SDL_SetHint(SDL_HINT_AUDIO_DEADLINE_SCHEDULING, mode ? "1" : "0");
+     SDL_zero(desired);
+     desired.freq = 48000;
+     desired.format = AUDIO_S16SYS;
+     desired.channels = 2;
+     desired.samples = 256;
+     desired.callback = _audio_statsCallback;
+     id = SDL_OpenAudioDevice(NULL, 0, &desired, &obtained, 0);
+     SDL_SetHint(SDL_HINT_AUDIO_DEADLINE_SCHEDULING, NULL);
+     SDLTest_AssertCheck(id > 1, "Validate device ID; expected: >=2, got: %i", id);
+     if (id <= 1) {
+       return TEST_ABORTED;
+     }
+
+     result = SDL_GetAudioDeviceStats(id, NULL);
+     SDLTest_AssertCheck(result == -1, "Verify SDL_GetAudioDeviceStats() with NULL stats fails");
+
+     SDL_Delay(50);  /* paused devices don't time callbacks. */
+     result = SDL_GetAudioDeviceStats(id, &stats);
+     SDLTest_AssertCheck(result == 0 && stats.callbacks == 0, "Verify no callbacks were timed while paused; got %u", (unsigned int) stats.callbacks);
+     SDLTest_AssertCheck(stats.period_us == 5333, "Verify period; expected: 5333, got: %u", (unsigned int) stats.period_us);
+
+     start = SDL_GetPerformanceCounter();
+     SDL_PauseAudioDevice(id, 0);
+     SDL_Delay(500);
+     SDL_PauseAudioDevice(id, 1);
+     seconds = (double) (SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+
+     SDL_GetAudioDeviceStats(id, &stats);
+     total = 0;
+     for (i = 0; i < SDL_AUDIO_JITTER_BUCKETS; i++) {
+       total += stats.jitter_histogram[i];
+     }
+     expected = (Uint32) (seconds * 48000.0 / 256.0);
+     SDLTest_Log("%s scheduling: %u callbacks (%u expected), %u late, jitter up to %u us, lateness up to %u us",
+                 mode ? "Deadline" : "Delay", (unsigned int) stats.callbacks, (unsigned int) expected,
+                 (unsigned int) stats.late_callbacks, (unsigned int) stats.max_jitter_us,
+                 (unsigned int) stats.max_lateness_us);
+     SDLTest_AssertCheck(stats.callbacks > 0, "Verify callbacks were timed; got %u", (unsigned int) stats.callbacks);
+     SDLTest_AssertCheck(total == stats.callbacks - 1, "Verify the histogram holds all but the first callback; expected: %u, got: %u", (unsigned int) stats.callbacks - 1, (unsigned int) total);
+     if (mode) {
+       /* deadlines don't drift, so there's one callback per period, give or take scheduling hiccups. */
+       SDLTest_AssertCheck(stats.callbacks >= expected * 9 / 10 && stats.callbacks <= expected + 2, "Verify deadline scheduling kept pace; expected about %u, got %u", (unsigned int) expected, (unsigned int) stats.callbacks);
+     }
+
+     SDL_CloseAudioDevice(id);
+   }
+
+   return TEST_COMPLETED;
+}
+
+/* Builds a stereo 22050 Hz WAVE file in memory with (datalen) bytes of random
+   data. The data chunk header claims (claimedlen) bytes. */
+static Uint8 *_audio_makeWAV(Uint16 tag, Uint16 bits, Uint16 blockalign, Uint16 samplesperblock,
+                             Uint32 datalen, Uint32 claimedlen, Uint32 *wavlen)
+{
+   const Sint16 coeffs[14] = { 256, 0, 512, -256, 0, 0, 192, 64, 240, 0, 460, -208, 392, -232 };
+   const Uint32 fmtlen = (tag == 0x0002) ? 50 : (tag == 0x0011) ? 20 : 16;
+   const Uint32 len = 12 + 8 + fmtlen + 8 + datalen;
+   Uint8 *wav = (Uint8 *) SDL_malloc(len);
+   Uint8 *p = wav;
+   Uint32 i;
+
+#define PUT16(v) do { *p++ = (Uint8) ((v) & 0xff); *p++ = (Uint8) (((v) >> 8) & 0xff); } while (0)
+#define PUT32(v) do { PUT16((v) & 0xffff); PUT16(((Uint32) (v)) >> 16); } while (0)
+   if (wav == NULL) {
+     return NULL;
+   }
+   SDL_memcpy(p, "RIFF", 4); p += 4;
+   PUT32(len - 8 + (claimedlen - datalen));
+   SDL_memcpy(p, "WAVEfmt ", 8); p += 8;
+   PUT32(fmtlen);
+   PUT16(tag);
+   PUT16(2);
+   PUT32(22050);
+   PUT32(22050 * blockalign);
+   PUT16(blockalign);
+   PUT16(bits);
+   if (tag == 0x0011) {
+     PUT16(2);
+     PUT16(samplesperblock);
+   } else if (tag == 0x0002) {
+     PUT16(32);
+     PUT16(samplesperblock);
+     PUT16(7);
+     for (i = 0; i < 14; i++) {
+       PUT16((Uint16) coeffs[i]);
+     }
+   }
+   SDL_memcpy(p, "data", 4); p += 4;
+   PUT32(claimedlen);
+   for (i = 0; i < datalen; i++) {
+     p[i] = (Uint8) SDLTest_RandomIntegerInRange(0, 255);
+   }
+   if (tag == 0x0002) {
+     /* MS ADPCM blocks start with one valid predictor index per channel. */
+     for (i = 0; i + 1 < datalen; i += blockalign) {
+       p[i] = (Uint8) SDLTest_RandomIntegerInRange(0, 6);
+       p[i + 1] = (Uint8) SDLTest_RandomIntegerInRange(0, 6);
+     }
+   }
+#undef PUT16
+#undef PUT32
+
+   *wavlen = len;
+   return wav;
+}
+
+/**
+ * \brief Stream WAVE files of every encoding and check they decode like SDL_LoadWAV_RW.
+ *
+ * \sa https://wiki.libsdl.org/SDL_OpenWAVStream_RW
+ * \sa https://wiki.libsdl.org/SDL_WAVStreamRead
+ * \sa https://wiki.libsdl.org/SDL_WAVStreamSeek
+ */
+int audio_wavStream()
+{
+   const struct {
+     Uint16 tag, bits, blockalign, samplesperblock;
+     Uint32 datalen;
+     const char *name;
+   } files[] = {
+     { 0x0001, 16, 4, 0, 40000 * 4 + 3, "16-bit PCM" },
+     { 0x0001, 24, 6, 0, 10000 * 6, "24-bit PCM" },
+     { 0x0007, 8, 2, 0, 9999 * 2, "mu-law" },
+     { 0x0011, 4, 1024, 1017, 1024 * 10 + 700, "IMA ADPCM" },
+     { 0x0002, 4, 1024, 1012, 1024 * 10 + 700, "MS ADPCM" }
+   };
+   const int chunksizes[] = { 1, 1000, 3331, 65536 };
+   SDL_AudioSpec loadspec, streamspec;
+   SDL_WAVStream *wav;
+   Uint8 *loaded, *streamed;
+   Uint32 loadedlen;
+   char *truncation = NULL;
+   int result = TEST_COMPLETED;
+   int f, variant, i;
+
+   SDLTest_AssertCheck(SDL_OpenWAVStream_RW(NULL, 0, &streamspec) == NULL, "Verify SDL_OpenWAVStream_RW() with NULL src fails");
+   SDLTest_AssertCheck(SDL_WAVStreamRead(NULL, &streamspec, 4) == -1, "Verify SDL_WAVStreamRead() with NULL stream fails");
+   SDLTest_AssertCheck(SDL_WAVStreamLength(NULL) == -1, "Verify SDL_WAVStreamLength() with NULL stream fails");
+   SDL_CloseWAVStream(NULL);
+
+   /* The truncation hint is changed below, so put it back afterwards. */
+   if (SDL_GetHint(SDL_HINT_WAVE_TRUNCATION) != NULL) {
+     truncation = SDL_strdup(SDL_GetHint(SDL_HINT_WAVE_TRUNCATION));
+   }
+
+   for (f = 0; f < SDL_arraysize(files); f++) {
+     /* plain, cut short, and cut short with partial blocks decoded. */
+     for (variant = 0; variant < 3; variant++) {
+       const Uint32 claimed = files[f].datalen + ((variant > 0) ? 5000 : 0);
+       Uint32 wavlen, pos, framesize;
+       Sint64 frames;
+       Uint8 *file = _audio_makeWAV(files[f].tag, files[f].bits, files[f].blockalign, files[f].samplesperblock,
+                                    files[f].datalen, claimed, &wavlen);
+       SDL_AudioStream *stream;
+
+       SDLTest_AssertCheck(file != NULL, "Build %s WAVE file", files[f].name);
+       if (file == NULL) {
+         result = TEST_ABORTED;
+         goto done;
+       }
+
+       SDL_SetHint(SDL_HINT_WAVE_TRUNCATION, (variant == 2) ? "dropframe" : "dropblock");
+       loaded = NULL;
+       loadedlen = 0;
+       if (SDL_LoadWAV_RW(SDL_RWFromConstMem(file, wavlen), 1, &loadspec, &loaded, &loadedlen) == NULL) {
+         SDLTest_AssertCheck(SDL_FALSE, "Load %s WAVE file, variant %d: %s", files[f].name, variant, SDL_GetError());
+         SDL_free(file);
+         continue;
+       }
+
+       wav = SDL_OpenWAVStream_RW(SDL_RWFromConstMem(file, wavlen), 1, &streamspec);
+       SDLTest_AssertCheck(wav != NULL, "Open %s WAVE stream, variant %d", files[f].name, variant);
+       if (wav == NULL) {
+         SDL_FreeWAV(loaded);
+         SDL_free(file);
+         continue;
+       }
+       SDLTest_AssertCheck(streamspec.format == loadspec.format && streamspec.channels == loadspec.channels && streamspec.freq == loadspec.freq,
+                           "Verify the stream has the loaded format; expected: 0x%x, got: 0x%x", loadspec.format, streamspec.format);
+       framesize = (SDL_AUDIO_BITSIZE(streamspec.format) / 8) * streamspec.channels;
+       frames = SDL_WAVStreamLength(wav);
+       SDLTest_AssertCheck(frames * framesize == loadedlen, "Verify %s length; expected: %u, got: %d",
+                           files[f].name, (unsigned int) (loadedlen / framesize), (int) frames);
+
+       streamed = (Uint8 *) SDL_malloc(loadedlen + 65536);
+       if (streamed == NULL) {
+         SDL_CloseWAVStream(wav);
+         SDL_FreeWAV(loaded);
+         SDL_free(file);
+         result = TEST_ABORTED;
+         goto done;
+       }
+
+       /* Read all of it in odd sizes; short reads only come at the end. */
+       pos = 0;
+       for (i = 0; ; i++) {
+         const int want = chunksizes[i % SDL_arraysize(chunksizes)] * framesize + ((i & 1) ? framesize - 1 : 0);
+         const int got = SDL_WAVStreamRead(wav, streamed + pos, want);
+         if (got <= 0) {
+           SDLTest_AssertCheck(got == 0, "Verify the read at the end returns 0; got: %d", got);
+           break;
+         }
+         pos += got;
+       }
+       SDLTest_AssertCheck(pos == loadedlen && SDL_memcmp(streamed, loaded, loadedlen) == 0,
+                           "Verify reading %s decodes the same as loading; expected %u bytes, got %u",
+                           files[f].name, (unsigned int) loadedlen, (unsigned int) pos);
+
+       /* Seek to random frames, including across block boundaries. */
+       for (i = 0; i < 10 && frames > 0; i++) {
+         const Sint64 frame = SDLTest_RandomIntegerInRange(0, (Sint32) frames - 1);
+         const Uint32 want = SDL_min((Uint32) (frames - frame) * framesize, 2000 * framesize);
+         SDLTest_AssertCheck(SDL_WAVStreamSeek(wav, frame) == 0 && SDL_WAVStreamTell(wav) == frame, "Seek to frame %d", (int) frame);
+         SDLTest_AssertCheck(SDL_WAVStreamRead(wav, streamed, want) == (int) want && SDL_memcmp(streamed, loaded + frame * framesize, want) == 0,
+                             "Verify %s from frame %d matches", files[f].name, (int) frame);
+       }
+
+       /* Decode straight into an audio stream that doesn't convert. */
+       SDL_WAVStreamSeek(wav, 0);
+       stream = SDL_NewAudioStream(streamspec.format, streamspec.channels, streamspec.freq,
+                                   streamspec.format, streamspec.channels, streamspec.freq);
+       SDLTest_AssertCheck(stream != NULL, "Create audio stream");
+       if (stream != NULL) {
+         while (SDL_WAVStreamPut(wav, stream, 5000 * framesize) > 0) {
+         }
+         SDL_AudioStreamFlush(stream);
+         pos = (Uint32) SDL_AudioStreamGet(stream, streamed, loadedlen + 65536);
+         SDLTest_AssertCheck(pos == loadedlen && SDL_memcmp(streamed, loaded, loadedlen) == 0,
+                             "Verify putting %s into an audio stream decodes the same as loading; expected %u bytes, got %u",
+                             files[f].name, (unsigned int) loadedlen, (unsigned int) pos);
+         SDL_FreeAudioStream(stream);
+       }
+
+       SDL_free(streamed);
+       SDL_CloseWAVStream(wav);
+       SDL_FreeWAV(loaded);
+       SDL_free(file);
+     }
+   }
+
+done:
+   /* dropblock is what happens without the hint, too. */
+   SDL_SetHint(SDL_HINT_WAVE_TRUNCATION, truncation ? truncation : "dropblock");
+   SDL_free(truncation);
+   return result;
+}
+
+/* Reference IMA ADPCM step, straight from the specification. */
+static Sint32 _audio_imaStep(Sint32 sample, Sint32 *index, Uint8 nybble)
+{
+   static const Sint32 steps[89] = {
+     7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+     50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+     253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+     1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+     3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442,
+     11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+   };
+   static const Sint32 adjust[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
+   const Sint32 step = steps[*index];
+   Sint32 delta = step >> 3;
+
+   if (nybble & 4) delta += step;
+   if (nybble & 2) delta += step >> 1;
+   if (nybble & 1) delta += step >> 2;
+   if (nybble & 8) delta = -delta;
+   *index = SDL_min(SDL_max(*index + adjust[nybble & 7], 0), 88);
+   return SDL_min(SDL_max(sample + delta, -32768), 32767);
+}
+
+/* Reference MS ADPCM step, straight from the specification. */
+static Sint32 _audio_msStep(Sint32 *s1, Sint32 *s2, Sint32 *delta, const Sint16 *coeff, Uint8 nybble)
+{
+   static const Sint32 adaptive[16] = { 230, 230, 230, 230, 307, 409, 512, 614, 768, 614, 512, 409, 307, 230, 230, 230 };
+   Sint32 sample = (*s1 * coeff[0] + *s2 * coeff[1]) / 256 + *delta * (nybble >= 8 ? nybble - 16 : nybble);
+   sample = SDL_min(SDL_max(sample, -32768), 32767);
+   *delta = SDL_min(SDL_max(*delta * adaptive[nybble] / 256, 16), 65535);
+   *s2 = *s1;
+   *s1 = sample;
+   return sample;
+}
+
+/**
+ * \brief Decode A-law, mu-law, MS ADPCM and IMA ADPCM and compare with reference decoders.
+ *
+ * \sa https://wiki.libsdl.org/SDL_LoadWAV_RW
+ */
+int audio_wavDecode()
+{
+   const Sint16 coeffs[14] = { 256, 0, 512, -256, 0, 0, 192, 64, 240, 0, 460, -208, 392, -232 };
+   const struct {
+     Uint16 tag, bits, blockalign, samplesperblock;
+     Uint32 datalen;
+     const char *name;
+   } files[] = {
+     { 0x0006, 8, 2, 0, 5001 * 2, "A-law" },
+     { 0x0007, 8, 2, 0, 5001 * 2, "mu-law" },
+     { 0x0002, 4, 1024, 1012, 1024 * 5, "MS ADPCM" },
+     /* 1011 samples after the header is not a multiple of 8, so each block
+        ends with a partial sub-block. */
+     { 0x0011, 4, 1024, 1012, 1024 * 5, "IMA ADPCM" }
+   };
+   int f;
+
+   for (f = 0; f < SDL_arraysize(files); f++) {
+     Uint32 wavlen, len, i, mismatches = 0;
+     Uint8 *file = _audio_makeWAV(files[f].tag, files[f].bits, files[f].blockalign, files[f].samplesperblock,
+                                  files[f].datalen, files[f].datalen, &wavlen);
+     const Uint8 *data;
+     Sint16 *decoded = NULL;
+     Sint16 *expected;
+     SDL_AudioSpec spec;
+
+     SDLTest_AssertCheck(file != NULL, "Build %s WAVE file", files[f].name);
+     if (file == NULL) {
+       return TEST_ABORTED;
+     }
+     data = file + wavlen - files[f].datalen;
+
+     if (SDL_LoadWAV_RW(SDL_RWFromConstMem(file, wavlen), 1, &spec, (Uint8 **) &decoded, &len) == NULL) {
+       SDLTest_AssertCheck(SDL_FALSE, "Load %s WAVE file: %s", files[f].name, SDL_GetError());
+       SDL_free(file);
+       continue;
+     }
+     SDLTest_AssertCheck(spec.format == AUDIO_S16SYS && spec.channels == 2, "Verify %s decodes to stereo S16SYS", files[f].name);
+
+     expected = (Sint16 *) SDL_calloc(1, len + 4);
+     if (expected == NULL) {
+       SDL_FreeWAV((Uint8 *) decoded);
+       SDL_free(file);
+       return TEST_ABORTED;
+     }
+
+     if (files[f].tag == 0x0006 || files[f].tag == 0x0007) {
+       for (i = 0; i < files[f].datalen; i++) {
+         if (files[f].tag == 0x0006) {
+           const Uint8 a = data[i] ^ 0x55;
+           const Sint32 exponent = (a & 0x70) >> 4;
+           Sint32 value = ((a & 0x0f) << 4) + 8;
+           if (exponent > 0) {
+             value = (value + 0x100) << (exponent - 1);
+           }
+           expected[i] = (Sint16) ((a & 0x80) ? value : -value);
+         } else {
+           const Uint8 u = ~data[i];
+           const Sint32 exponent = (u >> 4) & 7;
+           const Sint32 value = ((((u & 0x0f) << 3) + 0x84) << exponent) - 0x84;
+           expected[i] = (Sint16) ((u & 0x80) ? -value : value);
+         }
+       }
+     } else {
+       const Uint32 spb = files[f].samplesperblock;
+       Uint32 block;
+       for (block = 0; block < files[f].datalen / files[f].blockalign; block++) {
+         const Uint8 *b = data + block * files[f].blockalign;
+         Sint16 *out = expected + block * spb * 2;
+         int c;
+         for (c = 0; c < 2; c++) {
+           Uint32 n;
+           if (files[f].tag == 0x0011) {
+             /* Header, then each channel's nibbles in 4 byte groups. */
+             Sint32 sample = (Sint16) (b[c * 4] | (b[c * 4 + 1] << 8));
+             Sint32 index = SDL_min(SDL_max((Sint8) b[c * 4 + 2], 0), 88);
+             out[c] = (Sint16) sample;
+             for (n = 0; n < spb - 1; n++) {
+               const Uint8 byte = b[8 + (n / 8) * 8 + c * 4 + (n % 8) / 2];
+               sample = _audio_imaStep(sample, &index, (n & 1) ? (byte >> 4) : (byte & 0x0f));
+               out[(n + 1) * 2 + c] = (Sint16) sample;
+             }
+           } else {
+             /* Header, then alternating nibbles, left channel high. */
+             Sint32 delta = (Sint16) (b[2 + c * 2] | (b[3 + c * 2] << 8));
+             Sint32 s1 = (Sint16) (b[6 + c * 2] | (b[7 + c * 2] << 8));
+             Sint32 s2 = (Sint16) (b[10 + c * 2] | (b[11 + c * 2] << 8));
+             delta &= 0xffff;
+             out[c] = (Sint16) s2;
+             out[2 + c] = (Sint16) s1;
+             for (n = 0; n < spb - 2; n++) {
+               const Uint8 byte = b[14 + n];
+               out[(n + 2) * 2 + c] = (Sint16) _audio_msStep(&s1, &s2, &delta, coeffs + b[c] * 2, c ? (byte & 0x0f) : (byte >> 4));
+             }
+           }
+         }
+       }
+     }
+
+     for (i = 0; i < len / 2; i++) {
+       if (decoded[i] != expected[i]) {
+         if (mismatches++ == 0) {
+           SDLTest_Log("%s: first mismatch at sample %u, expected %d, got %d", files[f].name, (unsigned int) i, expected[i], decoded[i]);
+         }
+       }
+     }
+     SDLTest_AssertCheck(len == files[f].datalen / files[f].blockalign * (spec.channels * 2 * (files[f].samplesperblock ? files[f].samplesperblock : 1)),
+                         "Verify %s decoded length; got %u bytes", files[f].name, (unsigned int) len);
+     SDLTest_AssertCheck(mismatches == 0, "Verify %s matches the reference decoder; %u of %u samples differ", files[f].name, (unsigned int) mismatches, (unsigned int) (len / 2));
+
+     SDL_free(expected);
+     SDL_FreeWAV((Uint8 *) decoded);
+     SDL_free(file);
+   }
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * \brief Convert a batch of buffers in parallel and compare with converting them one by one.
+ *
+ * \sa https://wiki.libsdl.org/SDL_ConvertAudioBatch
+ */
+int audio_convertAudioBatch()
+{
+   const int count = 32;
+   SDL_AudioCVT serial[32];
+   SDL_AudioCVT batch[32];
+   Uint8 *saved;
+   int i, result, mismatches = 0;
+
+   for (i = 0; i < count; i++) {
+     const SDL_AudioFormat srcfmt = _audioFormats[SDLTest_RandomIntegerInRange(0, _numAudioFormats - 1)];
+     const Uint8 srcchans = _audioChannels[SDLTest_RandomIntegerInRange(0, _numAudioChannels - 1)];
+     const int srcrate = _audioFrequencies[SDLTest_RandomIntegerInRange(0, _numAudioFrequencies - 1)];
+     const SDL_AudioFormat dstfmt = _audioFormats[SDLTest_RandomIntegerInRange(0, _numAudioFormats - 1)];
+     const Uint8 dstchans = _audioChannels[SDLTest_RandomIntegerInRange(0, _numAudioChannels - 1)];
+     const int dstrate = _audioFrequencies[SDLTest_RandomIntegerInRange(0, _numAudioFrequencies - 1)];
+     const int frames = SDLTest_RandomIntegerInRange(1, 20000);
+     int j;
+
+     result = SDL_BuildAudioCVT(&serial[i], srcfmt, srcchans, srcrate, dstfmt, dstchans, dstrate);
+     SDLTest_AssertCheck(result >= 0, "Call to SDL_BuildAudioCVT(%d), expected >= 0, got: %d", i, result);
+     if (result < 0) {
+       return TEST_ABORTED;
+     }
+     serial[i].len = frames * srcchans * SDL_AUDIO_BITSIZE(srcfmt) / 8;
+     serial[i].buf = (Uint8 *) SDL_malloc(serial[i].len * serial[i].len_mult);
+     SDLTest_AssertCheck(serial[i].buf != NULL, "Allocate buffer %d", i);
+     if (serial[i].buf == NULL) {
+       return TEST_ABORTED;
+     }
+     for (j = 0; j < serial[i].len; j++) {
+       serial[i].buf[j] = SDLTest_RandomUint8();
+     }
+
+     batch[i] = serial[i];
+     batch[i].buf = (Uint8 *) SDL_malloc(serial[i].len * serial[i].len_mult);
+     if (batch[i].buf == NULL) {
+       return TEST_ABORTED;
+     }
+     SDL_memcpy(batch[i].buf, serial[i].buf, serial[i].len);
+   }
+
+   for (i = 0; i < count; i++) {
+     result = SDL_ConvertAudio(&serial[i]);
+     SDLTest_AssertCheck(result == 0, "Call to SDL_ConvertAudio(%d), expected 0, got: %d", i, result);
+   }
+   result = SDL_ConvertAudioBatch(batch, count);
+   SDLTest_AssertPass("Call to SDL_ConvertAudioBatch(cvts, %d)", count);
+   SDLTest_AssertCheck(result == 0, "Verify result value; expected: 0, got: %d", result);
+
+   for (i = 0; i < count; i++) {
+     if (batch[i].len_cvt != serial[i].len_cvt ||
+         SDL_memcmp(batch[i].buf, serial[i].buf, serial[i].len_cvt) != 0) {
+       SDLTest_Log("Conversion %d differs: len_cvt %d vs %d", i, batch[i].len_cvt, serial[i].len_cvt);
+       mismatches++;
+     }
+   }
+   SDLTest_AssertCheck(mismatches == 0, "Verify batch matches serial conversion; %d of %d differ", mismatches, count);
+
+   /* Nothing gets converted when one of the buffers is missing. */
+   saved = batch[0].buf;
+   batch[0].buf = NULL;
+   batch[1].len_cvt = -1;
+   result = SDL_ConvertAudioBatch(batch, count);
+   SDLTest_AssertPass("Call to SDL_ConvertAudioBatch(cvts, %d) with a NULL buffer", count);
+   SDLTest_AssertCheck(result == -1, "Verify result value; expected: -1, got: %d", result);
+   SDLTest_AssertCheck(batch[1].len_cvt == -1, "Verify no conversion ran; len_cvt: %d", batch[1].len_cvt);
+   batch[0].buf = saved;
+
+   result = SDL_ConvertAudioBatch(NULL, 1);
+   SDLTest_AssertCheck(result == -1, "Call to SDL_ConvertAudioBatch(NULL, 1), expected -1, got: %d", result);
+   result = SDL_ConvertAudioBatch(batch, -1);
+   SDLTest_AssertCheck(result == -1, "Call to SDL_ConvertAudioBatch(cvts, -1), expected -1, got: %d", result);
+   result = SDL_ConvertAudioBatch(NULL, 0);
+   SDLTest_AssertCheck(result == 0, "Call to SDL_ConvertAudioBatch(NULL, 0), expected 0, got: %d", result);
+
+   for (i = 0; i < count; i++) {
+     SDL_free(serial[i].buf);
+     SDL_free(batch[i].buf);
+   }
+
+   return TEST_COMPLETED;
+}
+
 /* ================= Test Case References ================== */
 
 /* Audio test cases */
@@ -1022,11 +2180,43 @@ static const SDLTest_TestCaseReference audioTest14 =
 static const SDLTest_TestCaseReference audioTest15 =
         { (SDLTest_TestCaseFp)audio_pauseUnpauseAudio, "audio_pauseUnpauseAudio", "Pause and Unpause audio for various audio specs while testing callback.", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference audioTest16 =
+        { (SDLTest_TestCaseFp)audio_resampleSine, "audio_resampleSine", "Resample a sine wave and check it against the ideal output.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest17 =
+        { (SDLTest_TestCaseFp)audio_resampleQuality, "audio_resampleQuality", "Resample a sine sweep at every quality level, reporting THD+N and CPU time.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest18 =
+        { (SDLTest_TestCaseFp)audio_streamChunks, "audio_streamChunks", "Feed an audio stream in odd sized pieces without allocating or drifting.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest19 =
+        { (SDLTest_TestCaseFp)audio_queueRing, "audio_queueRing", "Queue audio past the end of the queue, clear it and drain it, checking the counters.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest20 =
+        { (SDLTest_TestCaseFp)audio_mixAudioFormat, "audio_mixAudioFormat", "Mix S16, S32 and F32 in both byte orders at odd alignments and check saturation.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest21 =
+        { (SDLTest_TestCaseFp)audio_audioVoices, "audio_audioVoices", "Mix voices through the disk driver, checking gain, pan and ramping.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest22 =
+        { (SDLTest_TestCaseFp)audio_deviceStats, "audio_deviceStats", "Check callback timing stats with and without deadline scheduling.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest23 =
+        { (SDLTest_TestCaseFp)audio_wavStream, "audio_wavStream", "Stream, seek and put WAVE files of every encoding, comparing with SDL_LoadWAV_RW.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest24 =
+        { (SDLTest_TestCaseFp)audio_wavDecode, "audio_wavDecode", "Decode companded and ADPCM WAVE files and compare with reference decoders.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest25 =
+        { (SDLTest_TestCaseFp)audio_convertAudioBatch, "audio_convertAudioBatch", "Convert a batch of buffers in parallel and compare with converting them one by one.", TEST_ENABLED };
+
 /* Sequence of Audio test cases */
 static const SDLTest_TestCaseReference *audioTests[] =  {
     &audioTest1, &audioTest2, &audioTest3, &audioTest4, &audioTest5, &audioTest6,
     &audioTest7, &audioTest8, &audioTest9, &audioTest10, &audioTest11,
-    &audioTest12, &audioTest13, &audioTest14, &audioTest15, NULL
+    &audioTest12, &audioTest13, &audioTest14, &audioTest15, &audioTest16,
+    &audioTest17, &audioTest18, &audioTest19,
+    &audioTest20, &audioTest21, &audioTest22, &audioTest23, &audioTest24, &audioTest25, NULL
 };
 
 /* Audio test suite (global) */
@@ -79,7 +79,7 @@ char* _RGBPixelFormatsVerbose[] =
   };
 
 /* Definition of all Non-RGB formats used to test pixel conversions */
-const int _numNonRGBPixelFormats = 7;
+const int _numNonRGBPixelFormats = 23;
 Uint32 _nonRGBPixelFormats[] =
   {
     SDL_PIXELFORMAT_YV12,
@@ -88,7 +88,23 @@ Uint32 _nonRGBPixelFormats[] =
     SDL_PIXELFORMAT_UYVY,
     SDL_PIXELFORMAT_YVYU,
     SDL_PIXELFORMAT_NV12,
-    SDL_PIXELFORMAT_NV21
+    SDL_PIXELFORMAT_NV21,
+    SDL_PIXELFORMAT_P010,
+    SDL_PIXELFORMAT_P016,
+    SDL_PIXELFORMAT_I010,
+    SDL_PIXELFORMAT_BC1,
+    SDL_PIXELFORMAT_BC2,
+    SDL_PIXELFORMAT_BC3,
+    SDL_PIXELFORMAT_BC4,
+    SDL_PIXELFORMAT_BC5,
+    SDL_PIXELFORMAT_BC7,
+    SDL_PIXELFORMAT_ETC2_RGB8,
+    SDL_PIXELFORMAT_ETC2_RGB8A1,
+    SDL_PIXELFORMAT_ETC2_RGBA8,
+    SDL_PIXELFORMAT_ASTC_4x4,
+    SDL_PIXELFORMAT_ASTC_5x5,
+    SDL_PIXELFORMAT_ASTC_6x6,
+    SDL_PIXELFORMAT_ASTC_8x8
   };
 char* _nonRGBPixelFormatsVerbose[] =
   {
@@ -98,7 +114,23 @@ char* _nonRGBPixelFormatsVerbose[] =
     "SDL_PIXELFORMAT_UYVY",
     "SDL_PIXELFORMAT_YVYU",
     "SDL_PIXELFORMAT_NV12",
-    "SDL_PIXELFORMAT_NV21"
+    "SDL_PIXELFORMAT_NV21",
+    "SDL_PIXELFORMAT_P010",
+    "SDL_PIXELFORMAT_P016",
+    "SDL_PIXELFORMAT_I010",
+    "SDL_PIXELFORMAT_BC1",
+    "SDL_PIXELFORMAT_BC2",
+    "SDL_PIXELFORMAT_BC3",
+    "SDL_PIXELFORMAT_BC4",
+    "SDL_PIXELFORMAT_BC5",
+    "SDL_PIXELFORMAT_BC7",
+    "SDL_PIXELFORMAT_ETC2_RGB8",
+    "SDL_PIXELFORMAT_ETC2_RGB8A1",
+    "SDL_PIXELFORMAT_ETC2_RGBA8",
+    "SDL_PIXELFORMAT_ASTC_4x4",
+    "SDL_PIXELFORMAT_ASTC_5x5",
+    "SDL_PIXELFORMAT_ASTC_6x6",
+    "SDL_PIXELFORMAT_ASTC_8x8"
   };
 
 /* Definition of some invalid formats for negative tests */
@@ -500,6 +532,75 @@ pixels_calcGammaRamp(void *arg)
   return TEST_COMPLETED;
 }
 
+/**
+ * @brief Call to SDL_ConvertPixels with block compressed source formats
+ *
+ * @sa http://wiki.libsdl.org/moin.fcg/SDL_ConvertPixels
+ */
+int
+pixels_convertCompressed(void *arg)
+{
+  /* A BC1 block, red and blue endpoints with the four palette entries across the first row */
+  const Uint8 bc1[8] = { 0x00, 0xF8, 0x1F, 0x00, 0xE4, 0x00, 0x00, 0x00 };
+  const Uint32 bc1_row[4] = { 0xFFFF0000, 0xFF0000FF, 0xFFAA0055, 0xFF5500AA };
+  /* An ASTC void extent block, a constant orange color */
+  const Uint8 astc[16] = { 0xFC, 0xFD, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                           0xFF, 0xFF, 0x80, 0x80, 0x00, 0x00, 0xFF, 0xFF };
+  Uint8 src[4 * 16];
+  Uint32 dst[6 * 6];
+  Uint8 abgr[4 * 4 * 4];
+  int result;
+  int i, x, y;
+
+  /* Decode a single BC1 block */
+  result = SDL_ConvertPixels(4, 4, SDL_PIXELFORMAT_BC1, bc1, 8, SDL_PIXELFORMAT_ARGB8888, dst, 4 * 4);
+  SDLTest_AssertPass("Call to SDL_ConvertPixels(BC1 -> ARGB8888)");
+  SDLTest_AssertCheck(result == 0, "Verify result value; expected: 0, got: %i", result);
+  for (i = 0; i < 4; i++) {
+    SDLTest_AssertCheck(dst[i] == bc1_row[i], "Verify pixel %i; expected: 0x%.8x, got: 0x%.8x", i, bc1_row[i], dst[i]);
+  }
+  for (i = 4; i < 16; i++) {
+    SDLTest_AssertCheck(dst[i] == bc1_row[0], "Verify pixel %i; expected: 0x%.8x, got: 0x%.8x", i, bc1_row[0], dst[i]);
+  }
+
+  /* Decode to a format other than ARGB8888 */
+  result = SDL_ConvertPixels(4, 4, SDL_PIXELFORMAT_BC1, bc1, 8, SDL_PIXELFORMAT_ABGR8888, abgr, 4 * 4);
+  SDLTest_AssertPass("Call to SDL_ConvertPixels(BC1 -> ABGR8888)");
+  SDLTest_AssertCheck(result == 0, "Verify result value; expected: 0, got: %i", result);
+  SDLTest_AssertCheck(*(Uint32 *)&abgr[4] == 0xFFFF0000, "Verify pixel 1; expected: 0xffff0000, got: 0x%.8x", *(Uint32 *)&abgr[4]);
+
+  /* Decode an image that doesn't fill the edge blocks */
+  for (i = 0; i < 4; i++) {
+    SDL_memcpy(&src[i * 16], astc, sizeof(astc));
+  }
+  SDL_memset(dst, 0, sizeof(dst));
+  result = SDL_ConvertPixels(6, 6, SDL_PIXELFORMAT_ASTC_4x4, src, 2 * 16, SDL_PIXELFORMAT_ARGB8888, dst, 6 * 4);
+  SDLTest_AssertPass("Call to SDL_ConvertPixels(ASTC_4x4 -> ARGB8888)");
+  SDLTest_AssertCheck(result == 0, "Verify result value; expected: 0, got: %i", result);
+  for (y = 0; y < 6; y++) {
+    for (x = 0; x < 6; x++) {
+      if (dst[y * 6 + x] != 0xFFFF8000) {
+        break;
+      }
+    }
+    SDLTest_AssertCheck(x == 6, "Verify row %i; expected: 0xffff8000, got: 0x%.8x at %i", y, x < 6 ? dst[y * 6 + x] : 0, x);
+  }
+
+  /* Copying between the same compressed format */
+  SDL_memset(src, 0, sizeof(src));
+  result = SDL_ConvertPixels(4, 4, SDL_PIXELFORMAT_BC1, bc1, 8, SDL_PIXELFORMAT_BC1, src, 8);
+  SDLTest_AssertPass("Call to SDL_ConvertPixels(BC1 -> BC1)");
+  SDLTest_AssertCheck(result == 0, "Verify result value; expected: 0, got: %i", result);
+  SDLTest_AssertCheck(SDL_memcmp(src, bc1, sizeof(bc1)) == 0, "Verify the block was copied");
+
+  /* Negative case: encoding isn't supported */
+  result = SDL_ConvertPixels(4, 4, SDL_PIXELFORMAT_ARGB8888, dst, 4 * 4, SDL_PIXELFORMAT_BC1, src, 8);
+  SDLTest_AssertPass("Call to SDL_ConvertPixels(ARGB8888 -> BC1)");
+  SDLTest_AssertCheck(result == -1, "Verify result value; expected: -1, got: %i", result);
+
+  return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Pixels test cases */
@@ -515,9 +616,12 @@ static const SDLTest_TestCaseReference pixelsTest3 =
 static const SDLTest_TestCaseReference pixelsTest4 =
         { (SDLTest_TestCaseFp)pixels_getPixelFormatName, "pixels_getPixelFormatName", "Call to SDL_GetPixelFormatName", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference pixelsTest5 =
+        { (SDLTest_TestCaseFp)pixels_convertCompressed, "pixels_convertCompressed", "Call to SDL_ConvertPixels with block compressed formats", TEST_ENABLED };
+
 /* Sequence of Pixels test cases */
 static const SDLTest_TestCaseReference *pixelsTests[] =  {
-    &pixelsTest1, &pixelsTest2, &pixelsTest3, &pixelsTest4, NULL
+    &pixelsTest1, &pixelsTest2, &pixelsTest3, &pixelsTest4, &pixelsTest5, NULL
 };
 
 /* Pixels test suite (global) */
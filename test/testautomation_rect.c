@@ -1574,6 +1574,91 @@ int rect_testRectEqualsParam(void *arg)
     return TEST_COMPLETED;
 }
 
+/* !
+ * \brief Tests SDL_CoalesceRects() with overlapping, abutting, contained, offscreen and empty rects
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_CoalesceRects
+ */
+int rect_testCoalesceRects(void *arg)
+{
+    const int width = 100;
+    const int height = 80;
+    const struct {
+        const char *name;
+        SDL_Rect rects[4];
+        int numrects;
+        int expectedCount;
+    } cases[] = {
+        { "contained", { { 10, 10, 40, 40 }, { 20, 20, 5, 5 } }, 2, 1 },
+        { "abutting", { { 0, 0, 30, 20 }, { 30, 0, 20, 20 }, { 0, 20, 50, 10 } }, 3, 1 },
+        { "overlapping", { { 10, 50, 30, 10 }, { 25, 50, 30, 10 } }, 2, 1 },
+        { "crossing", { { 50, 0, 10, 40 }, { 30, 20, 50, 10 } }, 2, 2 },
+        { "apart", { { 0, 0, 10, 10 }, { 20, 20, 10, 10 } }, 2, 2 },
+        { "offscreen", { { 200, 0, 10, 10 }, { -20, -20, 10, 10 }, { 0, 80, 10, 10 } }, 3, 0 },
+        { "empty", { { 5, 5, 0, 10 }, { 5, 5, 10, 0 }, { 5, 5, -3, 10 } }, 3, 0 },
+        { "clipped", { { 90, 70, 30, 30 }, { -5, -5, 10, 10 } }, 2, 2 },
+    };
+    SDL_Rect rects[4];
+    int i, j, x, y, count, missing, extra;
+
+    for (i = 0; i < SDL_arraysize(cases); i++) {
+        SDL_memcpy(rects, cases[i].rects, sizeof(rects));
+        count = SDL_CoalesceRects(width, height, rects, cases[i].numrects);
+        SDLTest_AssertCheck(count == cases[i].expectedCount,
+            "Check number of %s rects, expected: %d, got: %d", cases[i].name, cases[i].expectedCount, count);
+        if (count < 0) {
+            continue;
+        }
+
+        /* Every pixel must be covered by the result exactly when it's covered by the input */
+        missing = 0;
+        extra = 0;
+        for (y = -1; y <= height; y++) {
+            for (x = -1; x <= width; x++) {
+                const SDL_Point point = { x, y };
+                SDL_bool inInput = SDL_FALSE;
+                SDL_bool inResult = SDL_FALSE;
+                if (x >= 0 && x < width && y >= 0 && y < height) {
+                    for (j = 0; j < cases[i].numrects; j++) {
+                        inInput |= SDL_PointInRect(&point, &cases[i].rects[j]);
+                    }
+                }
+                for (j = 0; j < count; j++) {
+                    inResult |= SDL_PointInRect(&point, &rects[j]);
+                }
+                missing += (inInput && !inResult);
+                extra += (!inInput && inResult);
+            }
+        }
+        SDLTest_AssertCheck(missing == 0 && extra == 0,
+            "Check %s rects cover exactly their union, got: %d pixels missing, %d extra", cases[i].name, missing, extra);
+    }
+
+    return TEST_COMPLETED;
+}
+
+/* !
+ * \brief Negative tests against SDL_CoalesceRects() with invalid parameters
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_CoalesceRects
+ */
+int rect_testCoalesceRectsParam(void *arg)
+{
+    SDL_Rect rect = { 0, 0, 10, 10 };
+    int result;
+
+    result = SDL_CoalesceRects(100, 100, NULL, 1);
+    SDLTest_AssertCheck(result == -1, "Check that function returns -1 when rects is NULL, got: %d", result);
+    result = SDL_CoalesceRects(100, 100, NULL, 0);
+    SDLTest_AssertCheck(result == 0, "Check that function returns 0 when rects is NULL and numrects is 0, got: %d", result);
+    result = SDL_CoalesceRects(100, 100, &rect, -1);
+    SDLTest_AssertCheck(result == -1, "Check that function returns -1 when numrects is negative, got: %d", result);
+
+    return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Rect test cases */
@@ -1673,6 +1758,14 @@ static const SDLTest_TestCaseReference rectTest28 =
 static const SDLTest_TestCaseReference rectTest29 =
         { (SDLTest_TestCaseFp)rect_testRectEqualsParam, "rect_testRectEqualsParam", "Negative tests against SDL_RectEquals with invalid parameters", TEST_ENABLED };
 
+/* SDL_CoalesceRects */
+
+static const SDLTest_TestCaseReference rectTest30 =
+        { (SDLTest_TestCaseFp)rect_testCoalesceRects, "rect_testCoalesceRects", "Tests SDL_CoalesceRects with overlapping, abutting, contained, offscreen and empty rects", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference rectTest31 =
+        { (SDLTest_TestCaseFp)rect_testCoalesceRectsParam, "rect_testCoalesceRectsParam", "Negative tests against SDL_CoalesceRects with invalid parameters", TEST_ENABLED };
+
 
 /* !
  * \brief Sequence of Rect test cases; functions that handle simple rectangles including overlaps and merges.
@@ -1683,7 +1776,7 @@ static const SDLTest_TestCaseReference rectTest29 =
 static const SDLTest_TestCaseReference *rectTests[] =  {
     &rectTest1, &rectTest2, &rectTest3, &rectTest4, &rectTest5, &rectTest6, &rectTest7, &rectTest8, &rectTest9, &rectTest10, &rectTest11, &rectTest12, &rectTest13, &rectTest14,
     &rectTest15, &rectTest16, &rectTest17, &rectTest18, &rectTest19, &rectTest20, &rectTest21, &rectTest22, &rectTest23, &rectTest24, &rectTest25, &rectTest26, &rectTest27,
-    &rectTest28, &rectTest29, NULL
+    &rectTest28, &rectTest29, &rectTest30, &rectTest31, NULL
 };
 
 
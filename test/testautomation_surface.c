@@ -200,6 +200,523 @@ void _testBlitBlendMode(int mode)
     face = NULL;
 }
 
+/* SDL_BLIT_CPU_FEATURES values (SDL_CPU_* in SDL_blit.h) that force each
+   of the SIMD alpha blitters. "0" leaves only the scalar ones. */
+static const struct
+{
+    const char *name;
+    const char *features;
+} _blitPaths[] = {
+    { "SSE2", "8" },
+    { "AVX2", "72" },
+    { "NEON", "128" }
+};
+
+static SDL_bool
+_hasBlitPath(int path)
+{
+    switch (path) {
+    case 0: return SDL_HasSSE2();
+    case 1: return SDL_HasAVX2();
+    case 2: return SDL_HasNEON();
+    }
+    return SDL_FALSE;
+}
+
+/* Makes the next blit from src choose its blitter with only these CPU features */
+static void
+_setBlitPath(SDL_Surface *src, const char *features)
+{
+    SDL_BlendMode mode;
+
+    SDL_setenv("SDL_BLIT_CPU_FEATURES", features, 1);
+
+    /* changing the blend mode makes SDL pick the blitter again */
+    SDL_GetSurfaceBlendMode(src, &mode);
+    SDL_SetSurfaceBlendMode(src, (mode == SDL_BLENDMODE_NONE) ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+    SDL_SetSurfaceBlendMode(src, mode);
+}
+
+/* Blits src over a copy of orig into dst at rect, with the given CPU features */
+static int
+_blitWithPath(SDL_Surface *src, SDL_Surface *orig, SDL_Surface *dst, SDL_Rect *rect, const char *features)
+{
+    SDL_Rect dstrect = *rect;
+    _setBlitPath(src, features);
+    SDL_memcpy(dst->pixels, orig->pixels, dst->h * dst->pitch);
+    return SDL_BlitSurface(src, NULL, dst, &dstrect);
+}
+
+static int
+_countMismatches(SDL_Surface *a, SDL_Surface *b)
+{
+    const int rowlen = a->w * a->format->BytesPerPixel;
+    int y, x, failures = 0;
+
+    for (y = 0; y < a->h; y++) {
+        const Uint8 *pa = (const Uint8 *)a->pixels + y * a->pitch;
+        const Uint8 *pb = (const Uint8 *)b->pixels + y * b->pitch;
+        if (SDL_memcmp(pa, pb, rowlen) != 0) {
+            for (x = 0; x < rowlen; x += a->format->BytesPerPixel) {
+                if (SDL_memcmp(pa + x, pb + x, a->format->BytesPerPixel) != 0) {
+                    failures++;
+                }
+            }
+        }
+    }
+    return failures;
+}
+
+static Uint32
+_getPixel(SDL_Surface *surface, int x, int y)
+{
+    const Uint8 *p = (const Uint8 *)surface->pixels + y * surface->pitch + x * surface->format->BytesPerPixel;
+    return (surface->format->BytesPerPixel == 4) ? *(const Uint32 *)p : *(const Uint16 *)p;
+}
+
+/**
+ * Helper that blits the face onto the BlitBlend image with per-pixel or
+ * per-surface alpha through each SIMD blitter the CPU has, and checks every
+ * pixel against what the scalar blitter produced.
+ */
+static void
+_testBlitAlphaExact(Uint32 srcFormat, Uint32 dstFormat, int alphamod)
+{
+    SDL_Surface *face, *background, *src, *dst, *expected, *orig;
+    SDL_Rect rect;
+    int ret, i, path;
+    int failures[SDL_arraysize(_blitPaths)];
+
+    face = SDLTest_ImageFace();
+    background = SDLTest_ImageBlitBlend();
+    SDLTest_AssertCheck(face != NULL && background != NULL, "Verify test images are not NULL");
+    if (face == NULL || background == NULL) {
+        SDL_FreeSurface(face);
+        SDL_FreeSurface(background);
+        return;
+    }
+
+    SDL_zero(failures);
+    src = SDL_ConvertSurfaceFormat(face, srcFormat, 0);
+    dst = SDL_ConvertSurfaceFormat(background, dstFormat, 0);
+    expected = SDL_ConvertSurfaceFormat(background, dstFormat, 0);
+    orig = SDL_ConvertSurfaceFormat(background, dstFormat, 0);
+    SDLTest_AssertCheck(src != NULL && dst != NULL && expected != NULL && orig != NULL, "Verify converted surfaces are not NULL");
+    if (src != NULL && dst != NULL && expected != NULL && orig != NULL) {
+        SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_BLEND);
+        SDL_SetSurfaceAlphaMod(src, (Uint8)alphamod);
+
+        /* Odd offsets and widths exercise the vector loop tails */
+        for (i = 0; i < 4; i++) {
+            rect.x = 3 + i * 13;
+            rect.y = 2 + i * 7;
+            rect.w = src->w - i;
+            rect.h = src->h;
+            ret = _blitWithPath(src, orig, expected, &rect, "0");
+            SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface with the scalar blitter, expected: 0, got: %i", ret);
+
+            for (path = 0; path < SDL_arraysize(_blitPaths); path++) {
+                if (_hasBlitPath(path)) {
+                    ret = _blitWithPath(src, orig, dst, &rect, _blitPaths[path].features);
+                    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface with %s, expected: 0, got: %i", _blitPaths[path].name, ret);
+                    failures[path] += _countMismatches(expected, dst);
+                }
+            }
+        }
+        for (path = 0; path < SDL_arraysize(_blitPaths); path++) {
+            if (_hasBlitPath(path)) {
+                SDLTest_AssertCheck(failures[path] == 0, "Validate %s blended pixels of %s -> %s against the scalar blitter, expected: 0 mismatches, got: %i",
+                                    _blitPaths[path].name, SDL_GetPixelFormatName(srcFormat), SDL_GetPixelFormatName(dstFormat), failures[path]);
+            }
+        }
+    }
+
+    SDL_FreeSurface(src);
+    SDL_FreeSurface(dst);
+    SDL_FreeSurface(expected);
+    SDL_FreeSurface(orig);
+    SDL_FreeSurface(face);
+    SDL_FreeSurface(background);
+}
+
+/**
+ * Helper that blits a premultiplied source with runs of fully transparent,
+ * fully opaque and translucent pixels through each SIMD blitter the CPU has,
+ * and checks every pixel against what the scalar blitter produced. The
+ * destination has junk in its unused bits, which the blitters must clear
+ * the same way.
+ */
+static void
+_testBlitPremultipliedExact(Uint32 srcFormat, Uint32 dstFormat, SDL_BlendMode blendMode)
+{
+    const int w = 67, h = 23;
+    SDL_Surface *src, *dst, *expected, *orig;
+    SDL_Rect rect;
+    Uint32 seed = 12345;
+    int ret, i, x, y, path;
+    int failures[SDL_arraysize(_blitPaths)];
+
+    SDL_zero(failures);
+    src = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, srcFormat);
+    dst = SDL_CreateRGBSurfaceWithFormat(0, w + 48, h + 24, 32, dstFormat);
+    expected = SDL_CreateRGBSurfaceWithFormat(0, w + 48, h + 24, 32, dstFormat);
+    orig = SDL_CreateRGBSurfaceWithFormat(0, w + 48, h + 24, 32, dstFormat);
+    SDLTest_AssertCheck(src != NULL && dst != NULL && expected != NULL && orig != NULL, "Verify surfaces are not NULL");
+    if (src != NULL && dst != NULL && expected != NULL && orig != NULL) {
+        for (y = 0; y < h; y++) {
+            Uint32 *pixels = (Uint32 *)((Uint8 *)src->pixels + y * src->pitch);
+            for (x = 0; x < w; x++) {
+                /* runs of 8, so whole vectors are transparent or opaque */
+                const int run = (x / 8 + y) % 3;
+                const Uint8 a = (run == 0) ? 0 : (run == 1) ? 255 : (Uint8)(x * 7 + y * 13);
+                seed = seed * 1103515245 + 12345;
+                pixels[x] = SDL_MapRGBA(src->format, (Uint8)((seed >> 8) % (a + 1)), (Uint8)((seed >> 16) % (a + 1)), (Uint8)((seed >> 24) % (a + 1)), a);
+            }
+        }
+        for (y = 0; y < orig->h; y++) {
+            Uint32 *pixels = (Uint32 *)((Uint8 *)orig->pixels + y * orig->pitch);
+            for (x = 0; x < orig->w; x++) {
+                seed = seed * 1103515245 + 12345;
+                pixels[x] = seed;
+            }
+        }
+        SDL_SetSurfaceBlendMode(src, blendMode);
+
+        /* Odd offsets and widths exercise the vector loop tails */
+        for (i = 0; i < 4; i++) {
+            rect.x = 3 + i * 13;
+            rect.y = 2 + i * 7;
+            rect.w = w - i;
+            rect.h = h;
+            ret = _blitWithPath(src, orig, expected, &rect, "0");
+            SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface with the scalar blitter, expected: 0, got: %i", ret);
+
+            for (path = 0; path < SDL_arraysize(_blitPaths); path++) {
+                if (_hasBlitPath(path)) {
+                    ret = _blitWithPath(src, orig, dst, &rect, _blitPaths[path].features);
+                    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface with %s, expected: 0, got: %i", _blitPaths[path].name, ret);
+                    failures[path] += _countMismatches(expected, dst);
+                }
+            }
+        }
+        for (path = 0; path < SDL_arraysize(_blitPaths); path++) {
+            if (_hasBlitPath(path)) {
+                SDLTest_AssertCheck(failures[path] == 0, "Validate %s premultiplied blend mode %i of %s -> %s against the scalar blitter, expected: 0 mismatches, got: %i",
+                                    _blitPaths[path].name, (int)blendMode, SDL_GetPixelFormatName(srcFormat), SDL_GetPixelFormatName(dstFormat), failures[path]);
+            }
+        }
+    }
+
+    SDL_FreeSurface(src);
+    SDL_FreeSurface(dst);
+    SDL_FreeSurface(expected);
+    SDL_FreeSurface(orig);
+}
+
+/**
+ * Helper that premultiplies the face with a gradient of alpha values, blits it
+ * with one of the premultiplied blend modes and checks every pixel.
+ */
+static void
+_testBlitPremultiplied(Uint32 srcFormat, Uint32 dstFormat, SDL_BlendMode blendMode)
+{
+    SDL_Surface *face, *background, *src, *premultiplied, *roundtrip, *dst, *orig;
+    SDL_BlendMode mode;
+    Uint32 *pixels;
+    Uint8 r, g, b, a, pr, pg, pb, pa, dr, dg, db, da;
+    int ret, x, y;
+    int failures = 0;
+
+    face = SDLTest_ImageFace();
+    background = SDLTest_ImageBlitBlend();
+    SDLTest_AssertCheck(face != NULL && background != NULL, "Verify test images are not NULL");
+    if (face == NULL || background == NULL) {
+        SDL_FreeSurface(face);
+        SDL_FreeSurface(background);
+        return;
+    }
+
+    /* Straight alpha source with every alpha value somewhere in it */
+    src = SDL_ConvertSurfaceFormat(face, srcFormat, 0);
+    SDLTest_AssertCheck(src != NULL, "Verify converted source is not NULL");
+    if (src == NULL) {
+        SDL_FreeSurface(face);
+        SDL_FreeSurface(background);
+        return;
+    }
+    for (y = 0; y < src->h; y++) {
+        pixels = (Uint32 *)((Uint8 *)src->pixels + y * src->pitch);
+        for (x = 0; x < src->w; x++) {
+            SDL_GetRGBA(pixels[x], src->format, &r, &g, &b, &a);
+            pixels[x] = SDL_MapRGBA(src->format, r, g, b, (Uint8)(x * 7 + y * 13));
+        }
+    }
+
+    premultiplied = SDL_ConvertSurface(src, src->format, SDL_PREMULTIPLIED);
+    SDLTest_AssertCheck(premultiplied != NULL, "Verify premultiplied surface is not NULL");
+    if (premultiplied == NULL) {
+        SDL_FreeSurface(src);
+        SDL_FreeSurface(face);
+        SDL_FreeSurface(background);
+        return;
+    }
+    SDLTest_AssertCheck((premultiplied->flags & SDL_PREMULTIPLIED) != 0, "Verify SDL_PREMULTIPLIED flag is set");
+    SDL_GetSurfaceBlendMode(premultiplied, &mode);
+    SDLTest_AssertCheck(mode == SDL_BLENDMODE_BLEND_PREMULTIPLIED, "Verify blend mode, expected: %i, got: %i", SDL_BLENDMODE_BLEND_PREMULTIPLIED, mode);
+
+    /* Colors are scaled by alpha, and converting back restores them as closely as 8 bits allow */
+    roundtrip = SDL_ConvertSurface(premultiplied, src->format, 0);
+    SDLTest_AssertCheck(roundtrip != NULL && !(roundtrip->flags & SDL_PREMULTIPLIED), "Verify straight alpha surface is not NULL and not premultiplied");
+    for (y = 0; roundtrip && y < src->h; y++) {
+        for (x = 0; x < src->w; x++) {
+            SDL_GetRGBA(_getPixel(src, x, y), src->format, &r, &g, &b, &a);
+            SDL_GetRGBA(_getPixel(premultiplied, x, y), src->format, &pr, &pg, &pb, &pa);
+            if (pa != a || pr != r * a / 255 || pg != g * a / 255 || pb != b * a / 255) {
+                failures++;
+            }
+            SDL_GetRGBA(_getPixel(roundtrip, x, y), src->format, &pr, &pg, &pb, &pa);
+            if (a && (pa != a || SDL_abs(pr - r) > 255 / a || SDL_abs(pg - g) > 255 / a || SDL_abs(pb - b) > 255 / a)) {
+                failures++;
+            }
+        }
+    }
+    SDLTest_AssertCheck(failures == 0, "Validate premultiplied conversion of %s, expected: 0 mismatches, got: %i",
+                        SDL_GetPixelFormatName(srcFormat), failures);
+    SDL_FreeSurface(roundtrip);
+
+    /* Blit, offset so the vector loops have tails to take care of */
+    failures = 0;
+    dst = SDL_ConvertSurfaceFormat(background, dstFormat, 0);
+    orig = SDL_ConvertSurfaceFormat(background, dstFormat, 0);
+    SDLTest_AssertCheck(dst != NULL && orig != NULL, "Verify converted surfaces are not NULL");
+    if (dst != NULL && orig != NULL) {
+        SDL_Rect rect;
+        rect.x = 5;
+        rect.y = 3;
+        rect.w = premultiplied->w - 3;
+        rect.h = premultiplied->h;
+        SDL_SetSurfaceBlendMode(premultiplied, blendMode);
+        ret = SDL_BlitSurface(premultiplied, NULL, dst, &rect);
+        SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface, expected: 0, got: %i", ret);
+
+        for (y = 0; y < dst->h; y++) {
+            for (x = 0; x < dst->w; x++) {
+                Uint32 expected = _getPixel(orig, x, y);
+                if (x >= rect.x && x < rect.x + rect.w && y >= rect.y && y < rect.y + rect.h) {
+                    SDL_GetRGBA(_getPixel(premultiplied, x - rect.x, y - rect.y), premultiplied->format, &pr, &pg, &pb, &pa);
+                    SDL_GetRGBA(expected, dst->format, &dr, &dg, &db, &da);
+                    if (blendMode == SDL_BLENDMODE_BLEND_PREMULTIPLIED) {
+                        dr = (Uint8)SDL_min(255, pr + dr * (255 - pa) / 255);
+                        dg = (Uint8)SDL_min(255, pg + dg * (255 - pa) / 255);
+                        db = (Uint8)SDL_min(255, pb + db * (255 - pa) / 255);
+                        da = (Uint8)(pa + da * (255 - pa) / 255);
+                    } else {
+                        dr = (Uint8)SDL_min(255, pr + dr);
+                        dg = (Uint8)SDL_min(255, pg + dg);
+                        db = (Uint8)SDL_min(255, pb + db);
+                    }
+                    expected = SDL_MapRGBA(dst->format, dr, dg, db, da);
+                }
+                if (_getPixel(dst, x, y) != expected) {
+                    failures++;
+                }
+            }
+        }
+        SDLTest_AssertCheck(failures == 0, "Validate premultiplied blit of %s -> %s, expected: 0 mismatches, got: %i",
+                            SDL_GetPixelFormatName(srcFormat), SDL_GetPixelFormatName(dstFormat), failures);
+    }
+
+    SDL_FreeSurface(src);
+    SDL_FreeSurface(premultiplied);
+    SDL_FreeSurface(dst);
+    SDL_FreeSurface(orig);
+    SDL_FreeSurface(face);
+    SDL_FreeSurface(background);
+}
+
+/**
+ * Helper that fills a few overlapping and partially clipped rectangles and
+ * checks that exactly the pixels inside them changed.
+ */
+static void
+_testFillRects(Uint32 format, int w, int h)
+{
+    SDL_Surface *surface;
+    SDL_Rect rects[5];
+    SDL_Rect clip;
+    Uint32 color;
+    Uint8 expected[4];
+    int ret, bpp, x, y, i;
+    int failures = 0;
+
+    surface = SDL_CreateRGBSurfaceWithFormat(0, w, h, 0, format);
+    SDLTest_AssertCheck(surface != NULL, "Verify surface is not NULL");
+    if (surface == NULL) {
+        return;
+    }
+    bpp = surface->format->BytesPerPixel;
+    SDL_memset(surface->pixels, 0x5A, surface->h * surface->pitch);
+
+    clip.x = 3;
+    clip.y = 5;
+    clip.w = w - 10;
+    clip.h = h - 7;
+    SDL_SetClipRect(surface, &clip);
+
+    rects[0].x = 0;             rects[0].y = 0;         rects[0].w = w;     rects[0].h = h / 3;
+    rects[1].x = 1;             rects[1].y = h / 4;     rects[1].w = 77;    rects[1].h = h / 2;
+    rects[2].x = w / 2 + 1;     rects[2].y = h / 2;     rects[2].w = w;     rects[2].h = h;
+    rects[3].x = w / 3;         rects[3].y = h / 5;     rects[3].w = 1;     rects[3].h = 1;
+    rects[4].x = -10;           rects[4].y = h - 3;     rects[4].w = w / 2; rects[4].h = 9;
+
+    color = SDL_MapRGB(surface->format, 0x12, 0x34, 0x56);
+    ret = SDL_FillRects(surface, rects, SDL_arraysize(rects), color);
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_FillRects, expected: 0, got: %i", ret);
+
+    SDL_memcpy(expected, &color, sizeof(expected));
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+    if (bpp == 3) {
+        expected[0] = expected[1];
+        expected[1] = expected[2];
+        expected[2] = expected[3];
+    } else if (bpp == 2) {
+        expected[0] = expected[2];
+        expected[1] = expected[3];
+    } else if (bpp == 1) {
+        expected[0] = expected[3];
+    }
+#endif
+
+    for (y = 0; y < h; ++y) {
+        for (x = 0; x < w; ++x) {
+            const Uint8 *pixel = (const Uint8 *)surface->pixels + y * surface->pitch + x * bpp;
+            SDL_bool filled = SDL_FALSE;
+            SDL_Point point;
+            point.x = x;
+            point.y = y;
+            if (SDL_PointInRect(&point, &clip)) {
+                for (i = 0; i < SDL_arraysize(rects); ++i) {
+                    if (SDL_PointInRect(&point, &rects[i])) {
+                        filled = SDL_TRUE;
+                    }
+                }
+            }
+            for (i = 0; i < bpp; ++i) {
+                if (pixel[i] != (filled ? expected[i] : 0x5A)) {
+                    ++failures;
+                    break;
+                }
+            }
+        }
+    }
+    SDLTest_AssertCheck(failures == 0, "Verify fill of %s %dx%d, expected: 0 mismatches, got: %d",
+                        SDL_GetPixelFormatName(format), w, h, failures);
+
+    SDL_FreeSurface(surface);
+}
+
+/**
+ * Helper that checks that RLE accelerated blits, prepared ahead of time with
+ * SDL_PrepareSurfaceRLE(), give the same result as regular ones.
+ */
+static void
+_testBlitRLE(Uint32 srcFormat, Uint32 dstFormat, SDL_bool colorkey, int w, int h, int allowable_error)
+{
+    SDL_Surface *pattern, *src, *rle, *dst, *reference;
+    SDL_Rect srcrect, dstrect;
+    Uint32 *pixels;
+    Uint8 a;
+    int ret, x, y, i;
+
+    /* Opaque, translucent and transparent runs of all lengths, some blank
+       lines, and blank lines at the bottom */
+    pattern = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDLTest_AssertCheck(pattern != NULL, "Verify pattern surface is not NULL");
+    if (pattern == NULL) {
+        return;
+    }
+    for (y = 0; y < h; y++) {
+        pixels = (Uint32 *)((Uint8 *)pattern->pixels + y * pattern->pitch);
+        for (x = 0; x < w; x++) {
+            switch ((x / (1 + y % 9) + y / 3) % 5) {
+            case 0:
+            case 1:
+                a = 0;
+                break;
+            case 2:
+                a = colorkey ? 255 : (Uint8)(x * 3 + y);
+                break;
+            default:
+                a = 255;
+                break;
+            }
+            if (y % 61 == 7 || y >= h - 10) {
+                a = 0;
+            }
+            if (a == 0) {
+                pixels[x] = SDL_MapRGBA(pattern->format, 255, 0, 255, 0);
+            } else {
+                pixels[x] = SDL_MapRGBA(pattern->format, (Uint8)(x + y), (Uint8)(x * y), (Uint8)(y * 5), a);
+            }
+        }
+    }
+
+    src = SDL_ConvertSurfaceFormat(pattern, srcFormat, 0);
+    SDL_FreeSurface(pattern);
+    SDLTest_AssertCheck(src != NULL, "Verify source surface is not NULL");
+    if (src == NULL) {
+        return;
+    }
+    if (colorkey) {
+        SDL_SetColorKey(src, SDL_TRUE, SDL_MapRGB(src->format, 255, 0, 255));
+    } else {
+        SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_BLEND);
+    }
+    rle = SDL_ConvertSurface(src, src->format, 0);
+    dst = SDL_CreateRGBSurfaceWithFormat(0, w + 20, h + 20, 0, dstFormat);
+    reference = SDL_CreateRGBSurfaceWithFormat(0, w + 20, h + 20, 0, dstFormat);
+    SDLTest_AssertCheck(rle != NULL && dst != NULL && reference != NULL, "Verify surfaces are not NULL");
+    if (rle == NULL || dst == NULL || reference == NULL) {
+        SDL_FreeSurface(src);
+        SDL_FreeSurface(rle);
+        SDL_FreeSurface(dst);
+        SDL_FreeSurface(reference);
+        return;
+    }
+    for (i = 0; i < dst->h * dst->pitch; i++) {
+        ((Uint8 *)dst->pixels)[i] = ((Uint8 *)reference->pixels)[i] = (Uint8)(i * 7 + i / 1000);
+    }
+
+    ret = SDL_PrepareSurfaceRLE(rle, dst);
+    SDLTest_AssertPass("Call to SDL_PrepareSurfaceRLE()");
+    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_PrepareSurfaceRLE, expected: 0, got: %i", ret);
+    SDLTest_AssertCheck((rle->flags & SDL_RLEACCEL) != 0, "Verify surface is RLE accelerated");
+
+    /* Unclipped, then clipped on every side */
+    for (i = 0; i < 2; i++) {
+        srcrect.x = i ? w / 3 : 0;
+        srcrect.y = i ? h / 4 : 0;
+        srcrect.w = i ? w / 2 : w;
+        srcrect.h = i ? h : h;
+        dstrect.x = i ? -5 : 10;
+        dstrect.y = i ? h / 2 : 10;
+        ret = SDL_BlitSurface(rle, &srcrect, dst, &dstrect);
+        SDLTest_AssertCheck(ret == 0, "Verify result from blitting RLE surface, expected: 0, got: %i", ret);
+        dstrect.x = i ? -5 : 10;
+        dstrect.y = i ? h / 2 : 10;
+        ret = SDL_BlitSurface(src, &srcrect, reference, &dstrect);
+        SDLTest_AssertCheck(ret == 0, "Verify result from blitting surface, expected: 0, got: %i", ret);
+    }
+    ret = SDLTest_CompareSurfaces(dst, reference, allowable_error);
+    SDLTest_AssertCheck(ret == 0, "Verify RLE blit of %s onto %s %dx%d, expected: 0, got: %i",
+                        SDL_GetPixelFormatName(srcFormat), SDL_GetPixelFormatName(dstFormat), w, h, ret);
+
+    SDL_FreeSurface(src);
+    SDL_FreeSurface(rle);
+    SDL_FreeSurface(dst);
+    SDL_FreeSurface(reference);
+}
+
 /* Helper to check that a file exists */
 void
 _AssertFileExist(const char *filename)
@@ -588,6 +1105,448 @@ surface_testBlitBlendLoop(void *arg) {
 
 }
 
+/**
+ * @brief Tests that the SIMD alpha blitters match the scalar ones exactly.
+ */
+int
+surface_testBlitAlphaExact(void *arg)
+{
+   char *features = SDL_getenv("SDL_BLIT_CPU_FEATURES") ? SDL_strdup(SDL_getenv("SDL_BLIT_CPU_FEATURES")) : NULL;
+
+   /* Per-pixel alpha */
+   _testBlitAlphaExact(SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ARGB8888, 255);
+   _testBlitAlphaExact(SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_ABGR8888, 255);
+   _testBlitAlphaExact(SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB888, 255);
+   _testBlitAlphaExact(SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB565, 255);
+   _testBlitAlphaExact(SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_BGR565, 255);
+   _testBlitAlphaExact(SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB555, 255);
+
+   /* Per-surface alpha */
+   _testBlitAlphaExact(SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_RGB888, 77);
+   _testBlitAlphaExact(SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_RGB888, 128);
+   _testBlitAlphaExact(SDL_PIXELFORMAT_BGR888, SDL_PIXELFORMAT_BGR888, 200);
+   _testBlitAlphaExact(SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_RGB565, 77);
+   _testBlitAlphaExact(SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_RGB565, 128);
+   _testBlitAlphaExact(SDL_PIXELFORMAT_RGB555, SDL_PIXELFORMAT_RGB555, 200);
+
+   /* Premultiplied alpha, onto destinations with and without alpha */
+   _testBlitPremultipliedExact(SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ARGB8888, SDL_BLENDMODE_BLEND_PREMULTIPLIED);
+   _testBlitPremultipliedExact(SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB888, SDL_BLENDMODE_BLEND_PREMULTIPLIED);
+   _testBlitPremultipliedExact(SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_ABGR8888, SDL_BLENDMODE_BLEND_PREMULTIPLIED);
+   _testBlitPremultipliedExact(SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ARGB8888, SDL_BLENDMODE_ADD_PREMULTIPLIED);
+   _testBlitPremultipliedExact(SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB888, SDL_BLENDMODE_ADD_PREMULTIPLIED);
+
+   /* "" goes back to what the CPU has */
+   SDL_setenv("SDL_BLIT_CPU_FEATURES", features ? features : "", 1);
+   SDL_free(features);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests SDL_FillRects() with clipping and overlapping rectangles.
+ */
+int
+surface_testFillRects(void *arg)
+{
+   const Uint32 formats[] = {
+       SDL_PIXELFORMAT_INDEX8, SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_RGB24, SDL_PIXELFORMAT_ARGB8888
+   };
+   int i;
+
+   for (i = 0; i < SDL_arraysize(formats); ++i) {
+       /* Small enough to be filled in one go */
+       _testFillRects(formats[i], 133, 71);
+       /* Big enough to be split into bands */
+       _testFillRects(formats[i], 1501, 1203);
+   }
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests premultiplied alpha conversion, SDL_PremultiplyAlpha() and the premultiplied blend modes.
+ */
+int
+surface_testPremultipliedAlpha(void *arg)
+{
+   const SDL_BlendMode modes[] = { SDL_BLENDMODE_BLEND_PREMULTIPLIED, SDL_BLENDMODE_ADD_PREMULTIPLIED };
+   SDL_Surface *face, *converted, *premultiplied;
+   Uint32 *pixels;
+   int ret, i;
+
+   for (i = 0; i < SDL_arraysize(modes); ++i) {
+       _testBlitPremultiplied(SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ARGB8888, modes[i]);
+       _testBlitPremultiplied(SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_ABGR8888, modes[i]);
+       _testBlitPremultiplied(SDL_PIXELFORMAT_RGBA8888, SDL_PIXELFORMAT_RGBA8888, modes[i]);
+       _testBlitPremultiplied(SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB888, modes[i]);
+       _testBlitPremultiplied(SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ABGR8888, modes[i]);
+       _testBlitPremultiplied(SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB565, modes[i]);
+   }
+
+   /* SDL_PremultiplyAlpha() matches converting to a premultiplied surface */
+   face = SDLTest_ImageFace();
+   SDLTest_AssertCheck(face != NULL, "Verify face surface is not NULL");
+   if (face == NULL) {
+       return TEST_ABORTED;
+   }
+   converted = SDL_ConvertSurfaceFormat(face, SDL_PIXELFORMAT_ABGR8888, SDL_PREMULTIPLIED);
+   premultiplied = SDL_CreateRGBSurfaceWithFormat(0, face->w, face->h, 32, SDL_PIXELFORMAT_ABGR8888);
+   SDLTest_AssertCheck(converted != NULL && premultiplied != NULL, "Verify surfaces are not NULL");
+   if (converted != NULL && premultiplied != NULL) {
+       ret = SDL_PremultiplyAlpha(face->w, face->h, face->format->format, face->pixels, face->pitch,
+                                  premultiplied->format->format, premultiplied->pixels, premultiplied->pitch);
+       SDLTest_AssertPass("Call to SDL_PremultiplyAlpha()");
+       SDLTest_AssertCheck(ret == 0, "Verify result from SDL_PremultiplyAlpha, expected: 0, got: %i", ret);
+       ret = SDLTest_CompareSurfaces(premultiplied, converted, 0);
+       SDLTest_AssertCheck(ret == 0, "Validate result from SDLTest_CompareSurfaces, expected: 0, got: %i", ret);
+
+       pixels = (Uint32 *)premultiplied->pixels;
+       ret = SDL_PremultiplyAlpha(1, 1, SDL_PIXELFORMAT_ARGB8888, pixels, 4, SDL_PIXELFORMAT_RGB888, pixels, 4);
+       SDLTest_AssertCheck(ret == -1, "Verify SDL_PremultiplyAlpha fails without destination alpha, expected: -1, got: %i", ret);
+   }
+   SDL_FreeSurface(converted);
+   SDL_FreeSurface(premultiplied);
+   SDL_FreeSurface(face);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests RLE encoding ahead of time and RLE accelerated blits.
+ */
+int
+surface_testBlitRLE(void *arg)
+{
+   SDL_Surface *face, *dst;
+   int ret;
+
+   /* Small sprites are encoded in one go, big ones in bands of lines */
+   _testBlitRLE(SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_RGB888, SDL_TRUE, 64, 48, 0);
+   _testBlitRLE(SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_RGB888, SDL_TRUE, 701, 533, 0);
+   _testBlitRLE(SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_RGB565, SDL_TRUE, 701, 533, 0);
+   _testBlitRLE(SDL_PIXELFORMAT_RGB24, SDL_PIXELFORMAT_RGB24, SDL_TRUE, 701, 533, 0);
+   _testBlitRLE(SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB888, SDL_FALSE, 64, 48, 12);
+   _testBlitRLE(SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB888, SDL_FALSE, 701, 533, 12);
+   _testBlitRLE(SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_BGR888, SDL_FALSE, 701, 533, 12);
+   _testBlitRLE(SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB565, SDL_FALSE, 701, 533, 300);
+
+   /* Surfaces without a colorkey or blending can't be RLE accelerated */
+   face = SDLTest_ImageFace();
+   dst = SDL_CreateRGBSurfaceWithFormat(0, 32, 32, 0, SDL_PIXELFORMAT_RGB888);
+   SDLTest_AssertCheck(face != NULL && dst != NULL, "Verify surfaces are not NULL");
+   if (face != NULL && dst != NULL) {
+       SDL_SetSurfaceBlendMode(face, SDL_BLENDMODE_NONE);
+       ret = SDL_PrepareSurfaceRLE(face, dst);
+       SDLTest_AssertCheck(ret == -1, "Verify result from SDL_PrepareSurfaceRLE without blending, expected: -1, got: %i", ret);
+       ret = SDL_PrepareSurfaceRLE(NULL, dst);
+       SDLTest_AssertCheck(ret == -1, "Verify result from SDL_PrepareSurfaceRLE(NULL), expected: -1, got: %i", ret);
+       ret = SDL_BlitSurface(face, NULL, dst, NULL);
+       SDLTest_AssertCheck(ret == 0, "Verify surface can still be blitted, expected: 0, got: %i", ret);
+   }
+   SDL_FreeSurface(face);
+   SDL_FreeSurface(dst);
+
+   return TEST_COMPLETED;
+}
+
+/* Build an uncompressed BMP file in memory, with alpha in the given rows of 32-bit images */
+static Uint8 *
+_buildBMP(int bpp, int w, int h, SDL_bool topDown, int alphaRow, int colors, size_t *size)
+{
+   const int pitch = ((w * bpp / 8) + 3) & ~3;
+   const int paletteSize = (bpp == 8) ? colors * 4 : 0;
+   const Uint32 offBits = 14 + 40 + paletteSize;
+   Uint8 *bmp;
+   Uint8 *p;
+   int i, x, y;
+
+   *size = offBits + pitch * h;
+   bmp = (Uint8 *)SDL_calloc(1, *size);
+   if (bmp == NULL) {
+       return NULL;
+   }
+   p = bmp;
+#define PUT16(v) do { *p++ = (Uint8)(v); *p++ = (Uint8)((v) >> 8); } while (0)
+#define PUT32(v) do { PUT16((v) & 0xFFFF); PUT16(((Uint32)(v)) >> 16); } while (0)
+   *p++ = 'B'; *p++ = 'M';
+   PUT32((Uint32)*size);
+   PUT32(0);
+   PUT32(offBits);
+   PUT32(40);
+   PUT32(w);
+   PUT32(topDown ? -h : h);
+   PUT16(1);
+   PUT16(bpp);
+   PUT32(0);   /* BI_RGB */
+   PUT32(pitch * h);
+   PUT32(0);
+   PUT32(0);
+   PUT32((bpp == 8) ? colors : 0);
+   PUT32(0);
+#undef PUT16
+#undef PUT32
+   for (i = 0; i < paletteSize; ++i) {
+       *p++ = (Uint8)(i * 5);
+   }
+   for (y = 0; y < h; ++y) {
+       for (x = 0; x < w * bpp / 8; ++x) {
+           p[x] = (Uint8)(x * 7 + y * 13);
+           if (bpp == 8) {
+               p[x] %= colors;
+           } else if (bpp == 32 && (x % 4) == 3) {
+               p[x] = (alphaRow == y) ? (Uint8)(x + 1) : 0;
+           }
+       }
+       p += pitch;
+   }
+   return bmp;
+}
+
+/* Check a loaded surface against the BMP it came from */
+static void
+_checkLoadedBMP(SDL_Surface *surface, const Uint8 *bmp, int bpp, int w, int h, SDL_bool topDown, SDL_bool hasAlpha, const char *source)
+{
+   const int pitch = ((w * bpp / 8) + 3) & ~3;
+   const Uint8 *pixels = bmp + (bmp[10] | (bmp[11] << 8) | (bmp[12] << 16) | (bmp[13] << 24));
+   int x, y, mismatches = 0;
+
+   SDLTest_AssertCheck(surface->w == w && surface->h == h, "Verify %s surface size, expected: %dx%d, got: %dx%d", source, w, h, surface->w, surface->h);
+   SDLTest_AssertCheck(surface->format->BitsPerPixel == bpp, "Verify %s surface depth, expected: %d, got: %d", source, bpp, surface->format->BitsPerPixel);
+   if (surface->w != w || surface->h != h || surface->format->BitsPerPixel != bpp) {
+       return;
+   }
+   for (y = 0; y < h; ++y) {
+       const Uint8 *src = pixels + (topDown ? y : h - 1 - y) * pitch;
+       const Uint8 *dst = (const Uint8 *)surface->pixels + y * surface->pitch;
+       if (bpp == 32) {
+           for (x = 0; x < w; ++x) {
+               Uint32 expected, actual;
+               SDL_memcpy(&expected, src + x * 4, 4);
+               expected = SDL_SwapLE32(expected);
+               if (!hasAlpha) {
+                   expected |= 0xFF000000;
+               }
+               actual = ((const Uint32 *)dst)[x];
+               if (actual != expected) {
+                   ++mismatches;
+               }
+           }
+       } else if (SDL_memcmp(src, dst, w * bpp / 8) != 0) {
+           ++mismatches;
+       }
+   }
+   SDLTest_AssertCheck(mismatches == 0, "Verify %s pixels match the BMP data, got %d mismatches", source, mismatches);
+}
+
+/**
+ * @brief Tests loading uncompressed BMP images from memory and from files.
+ */
+int
+surface_testLoadBitmapFormats(void *arg)
+{
+   const struct {
+       int bpp;
+       int w, h;
+       SDL_bool topDown;
+       int alphaRow;
+   } cases[] = {
+       { 8, 37, 21, SDL_FALSE, -1 },
+       { 24, 37, 21, SDL_FALSE, -1 },
+       { 24, 640, 300, SDL_TRUE, -1 },
+       { 32, 37, 21, SDL_FALSE, -1 },
+       { 32, 37, 21, SDL_TRUE, -1 },
+       { 32, 641, 400, SDL_FALSE, 399 },   /* alpha only in the last row of the file */
+       { 32, 641, 400, SDL_TRUE, 0 },
+       { 32, 641, 400, SDL_FALSE, -1 },
+   };
+   const char *sampleFilename = "testLoadBitmapFormats.bmp";
+   int i;
+
+   for (i = 0; i < SDL_arraysize(cases); ++i) {
+       const int h = cases[i].h;
+       const SDL_bool hasAlpha = (cases[i].alphaRow >= 0);
+       size_t size = 0;
+       Uint8 *bmp = _buildBMP(cases[i].bpp, cases[i].w, h, cases[i].topDown, cases[i].alphaRow, 200, &size);
+       SDL_RWops *rw;
+       SDL_Surface *surface;
+
+       SDLTest_AssertCheck(bmp != NULL, "Verify BMP data was built");
+       if (bmp == NULL) {
+           return TEST_ABORTED;
+       }
+
+       /* From read-only memory, leaving the stream after the pixels */
+       rw = SDL_RWFromConstMem(bmp, (int)size);
+       surface = SDL_LoadBMP_RW(rw, 0);
+       SDLTest_AssertCheck(surface != NULL, "Verify %d-bpp BMP loads from memory: %s", cases[i].bpp, surface ? "" : SDL_GetError());
+       if (surface != NULL) {
+           _checkLoadedBMP(surface, bmp, cases[i].bpp, cases[i].w, h, cases[i].topDown, hasAlpha, "memory");
+           SDL_FreeSurface(surface);
+       }
+       SDLTest_AssertCheck(SDL_RWtell(rw) == (Sint64)size, "Verify stream position after loading, expected: %d, got: %d", (int)size, (int)SDL_RWtell(rw));
+       SDL_RWclose(rw);
+
+       /* From a file, which is read in blocks */
+       rw = SDL_RWFromFile(sampleFilename, "wb");
+       SDLTest_AssertCheck(rw != NULL, "Verify sample file was opened for writing");
+       if (rw != NULL) {
+           SDL_RWwrite(rw, bmp, 1, size);
+           SDL_RWclose(rw);
+           surface = SDL_LoadBMP(sampleFilename);
+           SDLTest_AssertCheck(surface != NULL, "Verify %d-bpp BMP loads from a file: %s", cases[i].bpp, surface ? "" : SDL_GetError());
+           if (surface != NULL) {
+               _checkLoadedBMP(surface, bmp, cases[i].bpp, cases[i].w, h, cases[i].topDown, hasAlpha, "file");
+               SDL_FreeSurface(surface);
+           }
+       }
+
+       /* Truncated pixel data is an error, not a partial image */
+       rw = SDL_RWFromConstMem(bmp, (int)size - 1);
+       surface = SDL_LoadBMP_RW(rw, 1);
+       SDLTest_AssertCheck(surface == NULL, "Verify truncated %d-bpp BMP fails to load", cases[i].bpp);
+       SDL_FreeSurface(surface);
+
+       SDL_free(bmp);
+   }
+
+   /* 8-bit pixels must stay within the palette */
+   {
+       size_t size = 0;
+       Uint8 *bmp = _buildBMP(8, 37, 21, SDL_FALSE, -1, 200, &size);
+       SDL_Surface *surface;
+       if (bmp != NULL) {
+           bmp[size - 40] = 250;   /* first pixel of the last row */
+           surface = SDL_LoadBMP_RW(SDL_RWFromConstMem(bmp, (int)size), 1);
+           SDLTest_AssertCheck(surface == NULL, "Verify BMP with out of palette pixels fails to load");
+           SDL_FreeSurface(surface);
+           SDL_free(bmp);
+       }
+   }
+
+   unlink(sampleFilename);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests that freed surface pixels are recycled through the surface pool.
+ */
+int
+surface_testSurfacePool(void *arg)
+{
+   SDL_Surface *surface, *dst;
+   Uint64 hits, misses, hits2, misses2;
+   size_t cached;
+   const Uint32 *pixels;
+   int i, dirty, ret;
+
+   SDL_TrimSurfacePool(0);
+   SDLTest_AssertPass("Call to SDL_TrimSurfacePool(0)");
+   SDL_GetSurfacePoolStats(NULL, NULL, &cached);
+   SDLTest_AssertCheck(cached == 0, "Verify pool is empty after trimming, got: %i bytes", (int)cached);
+
+   /* Free a dirty surface, then create one of the same size again */
+   surface = SDL_CreateRGBSurfaceWithFormat(0, 256, 200, 0, SDL_PIXELFORMAT_ARGB8888);
+   SDLTest_AssertCheck(surface != NULL, "Verify surface is not NULL");
+   if (surface == NULL) {
+       return TEST_ABORTED;
+   }
+   SDL_FillRect(surface, NULL, 0xFFFFFFFF);
+   SDL_FreeSurface(surface);
+   SDL_GetSurfacePoolStats(&hits, &misses, &cached);
+   SDLTest_AssertCheck(cached >= 256 * 200 * 4, "Verify freed pixels are kept in the pool, got: %i bytes", (int)cached);
+
+   surface = SDL_CreateRGBSurfaceWithFormat(0, 256, 200, 0, SDL_PIXELFORMAT_ARGB8888);
+   SDLTest_AssertCheck(surface != NULL, "Verify recycled surface is not NULL");
+   if (surface == NULL) {
+       return TEST_ABORTED;
+   }
+   SDL_GetSurfacePoolStats(&hits2, &misses2, NULL);
+   SDLTest_AssertCheck(hits2 == hits + 1, "Verify pool hits, expected: %i, got: %i", (int)(hits + 1), (int)hits2);
+   SDLTest_AssertCheck(misses2 == misses, "Verify pool misses, expected: %i, got: %i", (int)misses, (int)misses2);
+   SDLTest_AssertCheck((surface->flags & SDL_POOLED) != 0, "Verify surface has the SDL_POOLED flag");
+   pixels = (const Uint32 *)surface->pixels;
+   dirty = 0;
+   for (i = 0; i < surface->w * surface->h; ++i) {
+       if (pixels[i] != 0) {
+           ++dirty;
+       }
+   }
+   SDLTest_AssertCheck(dirty == 0, "Verify recycled pixels are cleared, got %i dirty pixels", dirty);
+
+   /* RLE encoding releases and restores pooled pixels */
+   SDL_FillRect(surface, NULL, 0xFFFF0000);
+   dst = SDL_CreateRGBSurfaceWithFormat(0, 256, 200, 0, SDL_PIXELFORMAT_RGB888);
+   SDLTest_AssertCheck(dst != NULL, "Verify destination surface is not NULL");
+   if (dst != NULL) {
+       SDL_SetSurfaceRLE(surface, 1);
+       ret = SDL_BlitSurface(surface, NULL, dst, NULL);
+       SDLTest_AssertCheck(ret == 0, "Verify result from RLE blit, expected: 0, got: %i", ret);
+       SDLTest_AssertCheck((surface->flags & SDL_RLEACCEL) != 0, "Verify surface is RLE accelerated");
+       ret = SDL_LockSurface(surface);
+       SDLTest_AssertCheck(ret == 0 && surface->pixels != NULL, "Verify RLE surface can be locked");
+       if (ret == 0) {
+           pixels = (const Uint32 *)surface->pixels;
+           SDLTest_AssertCheck(pixels[0] == 0xFFFF0000, "Verify restored pixel, expected: 0xFFFF0000, got: 0x%.8x", pixels[0]);
+           SDL_UnlockSurface(surface);
+       }
+       SDL_FreeSurface(dst);
+   }
+   SDL_FreeSurface(surface);
+
+   /* Converting doesn't clear recycled pixels, but must clear the row padding */
+   surface = SDL_CreateRGBSurfaceWithFormat(0, 255, 200, 0, SDL_PIXELFORMAT_RGB24);
+   SDLTest_AssertCheck(surface != NULL, "Verify padded surface is not NULL");
+   if (surface == NULL) {
+       return TEST_ABORTED;
+   }
+   SDL_memset(surface->pixels, 0xFF, surface->h * surface->pitch);
+   SDL_FreeSurface(surface);
+   surface = SDL_CreateRGBSurfaceWithFormat(0, 255, 200, 0, SDL_PIXELFORMAT_ARGB8888);
+   SDLTest_AssertCheck(surface != NULL, "Verify source surface is not NULL");
+   if (surface == NULL) {
+       return TEST_ABORTED;
+   }
+   SDL_GetSurfacePoolStats(&hits, NULL, NULL);
+   dst = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_RGB24, 0);
+   SDLTest_AssertCheck(dst != NULL, "Verify converted surface is not NULL");
+   SDL_FreeSurface(surface);
+   if (dst == NULL) {
+       return TEST_ABORTED;
+   }
+   SDL_GetSurfacePoolStats(&hits2, NULL, NULL);
+   SDLTest_AssertCheck(hits2 == hits + 1, "Verify converted surface reuses pooled pixels, expected: %i hits, got: %i", (int)(hits + 1), (int)hits2);
+   dirty = 0;
+   for (i = 0; i < dst->h; ++i) {
+       const Uint8 *row = (const Uint8 *)dst->pixels + i * dst->pitch;
+       int x;
+       for (x = dst->w * 3; x < dst->pitch; ++x) {
+           if (row[x] != 0) {
+               ++dirty;
+           }
+       }
+   }
+   SDLTest_AssertCheck(dirty == 0, "Verify row padding is cleared, got %i dirty bytes", dirty);
+   SDL_FreeSurface(dst);
+
+   /* Trimming releases the cached memory */
+   SDL_TrimSurfacePool(0);
+   SDL_GetSurfacePoolStats(NULL, NULL, &cached);
+   SDLTest_AssertCheck(cached == 0, "Verify pool is empty after trimming, got: %i bytes", (int)cached);
+
+   /* A pool size of 0 disables recycling */
+   SDL_SetHint(SDL_HINT_SURFACE_POOL_SIZE, "0");
+   surface = SDL_CreateRGBSurfaceWithFormat(0, 256, 200, 0, SDL_PIXELFORMAT_ARGB8888);
+   SDLTest_AssertCheck(surface != NULL, "Verify surface is not NULL");
+   SDL_FreeSurface(surface);
+   SDL_GetSurfacePoolStats(NULL, NULL, &cached);
+   SDLTest_AssertCheck(cached == 0, "Verify nothing is pooled with SDL_HINT_SURFACE_POOL_SIZE=0, got: %i bytes", (int)cached);
+   SDL_SetHint(SDL_HINT_SURFACE_POOL_SIZE, "");
+
+   return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Surface test cases */
@@ -630,11 +1589,30 @@ static const SDLTest_TestCaseReference surfaceTest11 =
 static const SDLTest_TestCaseReference surfaceTest12 =
         { (SDLTest_TestCaseFp)surface_testBlitBlendMod, "surface_testBlitBlendMod", "Tests blitting routines with mod blending mode.", TEST_ENABLED};
 
+static const SDLTest_TestCaseReference surfaceTest13 =
+        { (SDLTest_TestCaseFp)surface_testBlitAlphaExact, "surface_testBlitAlphaExact", "Tests that the SIMD alpha blitters match the scalar ones.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest14 =
+        { (SDLTest_TestCaseFp)surface_testFillRects, "surface_testFillRects", "Tests filling clipped and overlapping rectangles.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest15 =
+        { (SDLTest_TestCaseFp)surface_testPremultipliedAlpha, "surface_testPremultipliedAlpha", "Tests premultiplied alpha conversion and blending.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest16 =
+        { (SDLTest_TestCaseFp)surface_testBlitRLE, "surface_testBlitRLE", "Tests RLE encoding ahead of time and RLE accelerated blits.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest17 =
+        { (SDLTest_TestCaseFp)surface_testLoadBitmapFormats, "surface_testLoadBitmapFormats", "Tests loading uncompressed BMP images from memory and files.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest18 =
+        { (SDLTest_TestCaseFp)surface_testSurfacePool, "surface_testSurfacePool", "Tests recycling surface pixels through the surface pool.", TEST_ENABLED};
+
 /* Sequence of Surface test cases */
 static const SDLTest_TestCaseReference *surfaceTests[] =  {
     &surfaceTest1, &surfaceTest2, &surfaceTest3, &surfaceTest4, &surfaceTest5,
     &surfaceTest6, &surfaceTest7, &surfaceTest8, &surfaceTest9, &surfaceTest10,
-    &surfaceTest11, &surfaceTest12, NULL
+    &surfaceTest11, &surfaceTest12, &surfaceTest13, &surfaceTest14,
+    &surfaceTest15, &surfaceTest16, &surfaceTest17, &surfaceTest18, NULL
 };
 
 /* Surface test suite (global) */
@@ -55,6 +55,43 @@ void _destroyVideoSuiteTestWindow(SDL_Window *window)
   }
 }
 
+/*
+ * Count the pixels of a frame in a raw stream saved by the dummy driver
+ * that aren't red inside rect and 0x204080 outside of it
+ */
+int _countSavedFrameMismatches(SDL_RWops *rw, int frame, int w, int h, const SDL_Rect *rect)
+{
+  const int pitch = w * 3;
+  Uint8 *row;
+  int x, y;
+  int mismatches = 0;
+
+  row = (Uint8 *)SDL_malloc(pitch);
+  if (row == NULL) {
+    return -1;
+  }
+  if (SDL_RWseek(rw, (Sint64)frame * h * pitch, RW_SEEK_SET) < 0) {
+    SDL_free(row);
+    return -1;
+  }
+  for (y = 0; y < h; y++) {
+    if (SDL_RWread(rw, row, pitch, 1) != 1) {
+      SDL_free(row);
+      return -1;
+    }
+    for (x = 0; x < w; x++) {
+      const Uint8 *pixel = &row[x * 3];
+      if (rect != NULL && x >= rect->x && x < rect->x + rect->w && y >= rect->y && y < rect->y + rect->h) {
+        mismatches += (pixel[0] != 0xff || pixel[1] != 0 || pixel[2] != 0);
+      } else {
+        mismatches += (pixel[0] != 0x20 || pixel[1] != 0x40 || pixel[2] != 0x80);
+      }
+    }
+  }
+  SDL_free(row);
+  return mismatches;
+}
+
 /* Test case functions */
 
 /**
@@ -1720,6 +1757,122 @@ video_getSetWindowData(void *arg)
   return returnValue;
 }
 
+/**
+ * @brief Tests SDL_UpdateWindowSurfaceRects with overlapping, clipped and empty rects,
+ * and what gets presented when the dummy driver can save it
+ *
+ * @sa http://wiki.libsdl.org/moin.fcg/SDL_UpdateWindowSurfaceRects
+ */
+int
+video_updateWindowSurfaceRects(void *arg)
+{
+  const char* title = "video_updateWindowSurfaceRects Test Window";
+  SDL_Window* window;
+  SDL_Surface* surface;
+  SDL_Rect rects[6];
+  const char *driver;
+  char *saveFrames = NULL;
+  char *saveFormat = NULL;
+  SDL_bool saving;
+  char file[64];
+  SDL_RWops *rw;
+  Sint64 size;
+  int w, h;
+  int result;
+  int i;
+
+  /* The dummy driver can save what it presents, so check that too */
+  driver = SDL_GetCurrentVideoDriver();
+  saving = (driver != NULL && SDL_strcmp(driver, "dummy") == 0);
+  if (saving) {
+    if (SDL_getenv("SDL_VIDEO_DUMMY_SAVE_FRAMES")) saveFrames = SDL_strdup(SDL_getenv("SDL_VIDEO_DUMMY_SAVE_FRAMES"));
+    if (SDL_getenv("SDL_VIDEO_DUMMY_SAVE_FORMAT")) saveFormat = SDL_strdup(SDL_getenv("SDL_VIDEO_DUMMY_SAVE_FORMAT"));
+    SDL_setenv("SDL_VIDEO_DUMMY_SAVE_FRAMES", "1", 1);
+    SDL_setenv("SDL_VIDEO_DUMMY_SAVE_FORMAT", "raw", 1);
+  }
+
+  /* Call against new test window */
+  window = _createVideoSuiteTestWindow(title);
+  if (window == NULL) {
+    result = -1;
+    goto restore;
+  }
+  surface = SDL_GetWindowSurface(window);
+  SDLTest_AssertPass("Call to SDL_GetWindowSurface()");
+  SDLTest_AssertCheck(surface != NULL, "Validate that returned surface is not NULL");
+  if (surface == NULL) {
+    _destroyVideoSuiteTestWindow(window);
+    result = -1;
+    goto restore;
+  }
+  w = surface->w;
+  h = surface->h;
+
+  /* Overlapping, adjacent, contained, offscreen and empty rects */
+  rects[0].x = -10; rects[0].y = -10; rects[0].w = 50; rects[0].h = 50;
+  rects[1].x = 10; rects[1].y = 10; rects[1].w = 20; rects[1].h = 20;
+  rects[2].x = 40; rects[2].y = 0; rects[2].w = 20; rects[2].h = 40;
+  rects[3].x = surface->w - 5; rects[3].y = surface->h - 5; rects[3].w = 100; rects[3].h = 100;
+  rects[4].x = surface->w + 10; rects[4].y = 0; rects[4].w = 10; rects[4].h = 10;
+  rects[5].x = 0; rects[5].y = 0; rects[5].w = 0; rects[5].h = 10;
+
+  SDL_FillRect(surface, NULL, SDL_MapRGB(surface->format, 0x20, 0x40, 0x80));
+  result = SDL_UpdateWindowSurfaceRects(window, rects, SDL_arraysize(rects));
+  SDLTest_AssertPass("Call to SDL_UpdateWindowSurfaceRects(...,%d)", (int)SDL_arraysize(rects));
+  SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0, got: %d", result);
+
+  /* The stream is named after the window and the number of its first frame */
+  SDL_snprintf(file, sizeof(file), "SDL_window%u-%8.8d.raw", (unsigned int)SDL_GetWindowID(window),
+               (int)(size_t)SDL_GetWindowData(window, "SDL_VIDEO_DUMMY_FRAME"));
+
+  /* The caller's rects are left alone */
+  SDLTest_AssertCheck(rects[0].x == -10 && rects[0].w == 50, "Validate that the rects were not modified");
+
+  /* Only offscreen rects */
+  result = SDL_UpdateWindowSurfaceRects(window, &rects[4], 2);
+  SDLTest_AssertPass("Call to SDL_UpdateWindowSurfaceRects() with offscreen rects");
+  SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0, got: %d", result);
+
+  /* Several frames in a row */
+  for (i = 0; i < 4; i++) {
+    SDL_FillRect(surface, &rects[1], SDL_MapRGB(surface->format, 0xff, 0, 0));
+    result = SDL_UpdateWindowSurfaceRects(window, &rects[1], 1);
+    SDLTest_AssertCheck(result == 0, "Validate result of update %d; expected: 0, got: %d", i, result);
+  }
+
+  /* Clean up, which finishes writing the saved frames */
+  _destroyVideoSuiteTestWindow(window);
+
+  /* Every update presented the whole surface */
+  if (saving) {
+    rw = SDL_RWFromFile(file, "rb");
+    SDLTest_AssertCheck(rw != NULL, "Validate that the presented frames were saved to %s", file);
+    if (rw != NULL) {
+      size = SDL_RWsize(rw);
+      SDLTest_AssertCheck(size == (Sint64)6 * w * h * 3, "Validate saved size; expected: 6 frames of %dx%d, got: %" SDL_PRIs64 " bytes", w, h, size);
+      if (size == (Sint64)6 * w * h * 3) {
+        result = _countSavedFrameMismatches(rw, 0, w, h, NULL);
+        SDLTest_AssertCheck(result == 0, "Validate the first presented frame; expected: 0 wrong pixels, got: %d", result);
+        result = _countSavedFrameMismatches(rw, 5, w, h, &rects[1]);
+        SDLTest_AssertCheck(result == 0, "Validate the last presented frame; expected: 0 wrong pixels, got: %d", result);
+      }
+      SDL_RWclose(rw);
+      remove(file);
+    }
+  }
+  result = 0;
+
+restore:
+  if (saving) {
+    SDL_setenv("SDL_VIDEO_DUMMY_SAVE_FRAMES", saveFrames ? saveFrames : "", 1);
+    SDL_setenv("SDL_VIDEO_DUMMY_SAVE_FORMAT", saveFormat ? saveFormat : "", 1);
+    SDL_free(saveFrames);
+    SDL_free(saveFormat);
+  }
+
+  return (result == 0) ? TEST_COMPLETED : TEST_ABORTED;
+}
+
 
 /* ================= Test References ================== */
 
@@ -1793,13 +1946,16 @@ static const SDLTest_TestCaseReference videoTest22 =
 static const SDLTest_TestCaseReference videoTest23 =
         { (SDLTest_TestCaseFp)video_getSetWindowData, "video_getSetWindowData",  "Checks SDL_SetWindowData and SDL_GetWindowData positive and negative cases", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference videoTest24 =
+        { (SDLTest_TestCaseFp)video_updateWindowSurfaceRects, "video_updateWindowSurfaceRects",  "Checks SDL_UpdateWindowSurfaceRects with overlapping, clipped and empty rects", TEST_ENABLED };
+
 /* Sequence of Video test cases */
 static const SDLTest_TestCaseReference *videoTests[] =  {
     &videoTest1, &videoTest2, &videoTest3, &videoTest4, &videoTest5, &videoTest6,
     &videoTest7, &videoTest8, &videoTest9, &videoTest10, &videoTest11, &videoTest12,
     &videoTest13, &videoTest14, &videoTest15, &videoTest16, &videoTest17,
     &videoTest18, &videoTest19, &videoTest20, &videoTest21, &videoTest22,
-    &videoTest23, NULL
+    &videoTest23, &videoTest24, NULL
 };
 
 /* Video test suite (global) */
@@ -0,0 +1,700 @@
+/*
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Simple program to measure the speed of the software blitters and fills, of loading BMP files, and of decoding compressed textures */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "SDL.h"
+
+/* Sprite sheets for the RLE tests are made of cells this big */
+#define SPRITE_SIZE 64
+
+static const struct {
+    const char *name;
+    Uint32 format;
+} formats[] = {
+    { "ARGB8888", SDL_PIXELFORMAT_ARGB8888 },
+    { "ABGR8888", SDL_PIXELFORMAT_ABGR8888 },
+    { "RGBA8888", SDL_PIXELFORMAT_RGBA8888 },
+    { "BGRA8888", SDL_PIXELFORMAT_BGRA8888 },
+    { "RGB888", SDL_PIXELFORMAT_RGB888 },
+    { "BGR888", SDL_PIXELFORMAT_BGR888 },
+    { "RGB565", SDL_PIXELFORMAT_RGB565 },
+    { "BGR565", SDL_PIXELFORMAT_BGR565 },
+    { "RGB555", SDL_PIXELFORMAT_RGB555 },
+    { "RGB24", SDL_PIXELFORMAT_RGB24 },
+};
+
+typedef struct
+{
+    Uint32 src_format;
+    Uint32 dst_format;
+    SDL_BlendMode blend_mode;
+    int alpha_mod;
+    SDL_bool fill;
+    SDL_bool rle;
+    SDL_bool loadbmp;
+    SDL_bool churn;
+    SDL_bool compressed;
+} BlitTest;
+
+/* The cases we care most about when nothing is given on the command line */
+static const BlitTest default_tests[] = {
+    { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ARGB8888, SDL_BLENDMODE_NONE, 255 },
+    { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ARGB8888, SDL_BLENDMODE_BLEND, 255 },
+    { SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_ABGR8888, SDL_BLENDMODE_BLEND, 255 },
+    { SDL_PIXELFORMAT_RGBA8888, SDL_PIXELFORMAT_RGBA8888, SDL_BLENDMODE_BLEND, 255 },
+    { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB888, SDL_BLENDMODE_BLEND, 255 },
+    { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ARGB8888, SDL_BLENDMODE_BLEND_PREMULTIPLIED, 255 },
+    { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB888, SDL_BLENDMODE_BLEND_PREMULTIPLIED, 255 },
+    { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ARGB8888, SDL_BLENDMODE_ADD_PREMULTIPLIED, 255 },
+    { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB565, SDL_BLENDMODE_BLEND, 255 },
+    { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB555, SDL_BLENDMODE_BLEND, 255 },
+    { SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_RGB888, SDL_BLENDMODE_BLEND, 128 },
+    { SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_RGB888, SDL_BLENDMODE_BLEND, 77 },
+    { SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_RGB565, SDL_BLENDMODE_BLEND, 77 },
+    { SDL_PIXELFORMAT_RGB555, SDL_PIXELFORMAT_RGB555, SDL_BLENDMODE_BLEND, 77 },
+};
+
+static Uint32 seed = 0x12345678;
+
+static Uint32
+random_pixel(void)
+{
+    seed = seed * 1103515245 + 12345;
+    return seed;
+}
+
+static Uint32
+format_from_name(const char *name)
+{
+    int i;
+    for (i = 0; i < SDL_arraysize(formats); ++i) {
+        if (SDL_strcasecmp(name, formats[i].name) == 0) {
+            return formats[i].format;
+        }
+    }
+    return SDL_PIXELFORMAT_UNKNOWN;
+}
+
+static const char *
+format_name(Uint32 format)
+{
+    const char *name = SDL_GetPixelFormatName(format);
+    if (SDL_strncmp(name, "SDL_PIXELFORMAT_", 16) == 0) {
+        name += 16;
+    }
+    return name;
+}
+
+static const char *
+blend_mode_name(SDL_BlendMode mode)
+{
+    switch (mode) {
+    case SDL_BLENDMODE_NONE:
+        return "none";
+    case SDL_BLENDMODE_BLEND:
+        return "blend";
+    case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
+        return "pblend";
+    case SDL_BLENDMODE_ADD:
+        return "add";
+    case SDL_BLENDMODE_ADD_PREMULTIPLIED:
+        return "padd";
+    case SDL_BLENDMODE_MOD:
+        return "mod";
+    default:
+        return "custom";
+    }
+}
+
+/* Fill the source like a sprite: a third transparent, a third opaque, a third in between */
+static SDL_Surface *
+create_source(Uint32 format, int w, int h)
+{
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, w, h, 0, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Surface *converted;
+    int x, y;
+
+    if (!surface) {
+        return NULL;
+    }
+    for (y = 0; y < h; ++y) {
+        Uint32 *row = (Uint32 *)((Uint8 *)surface->pixels + y * surface->pitch);
+        for (x = 0; x < w; ++x) {
+            Uint32 pixel = random_pixel() & 0x00FFFFFF;
+            switch ((x / 16 + y) % 3) {
+            case 0:
+                break;
+            case 1:
+                pixel |= 0xFF000000;
+                break;
+            default:
+                pixel |= (random_pixel() >> 8) & 0xFF000000;
+                break;
+            }
+            row[x] = pixel;
+        }
+    }
+    converted = SDL_ConvertSurfaceFormat(surface, format, 0);
+    SDL_FreeSurface(surface);
+    return converted;
+}
+
+/* Fill the source like a sprite sheet: each cell holds a round sprite with a
+   soft edge, surrounded by the given percentage of transparent pixels.
+   Formats without alpha get a colorkey instead. */
+static SDL_Surface *
+create_sprite_sheet(Uint32 format, int w, int h, int transparent)
+{
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, w, h, 0, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Surface *converted;
+    const float radius = SDL_sqrtf((100 - transparent) * SPRITE_SIZE * SPRITE_SIZE / (100.0f * 3.14159265f));
+    int x, y;
+
+    if (!surface) {
+        return NULL;
+    }
+    for (y = 0; y < h; ++y) {
+        Uint32 *row = (Uint32 *)((Uint8 *)surface->pixels + y * surface->pitch);
+        for (x = 0; x < w; ++x) {
+            const float dx = (float)(x % SPRITE_SIZE) - SPRITE_SIZE / 2 + 0.5f;
+            const float dy = (float)(y % SPRITE_SIZE) - SPRITE_SIZE / 2 + 0.5f;
+            const float edge = radius - SDL_sqrtf(dx * dx + dy * dy);
+            if (edge <= 0.0f) {
+                row[x] = 0x00FF00FF;
+            } else if (edge < 2.0f) {
+                row[x] = (random_pixel() & 0x007F7F7F) | ((Uint32)(edge * 127.0f) << 24);
+            } else {
+                row[x] = (random_pixel() & 0x007F7F7F) | 0xFF000000;
+            }
+        }
+    }
+    converted = SDL_ConvertSurfaceFormat(surface, format, 0);
+    SDL_FreeSurface(surface);
+    if (converted) {
+        if (converted->format->Amask) {
+            SDL_SetSurfaceBlendMode(converted, SDL_BLENDMODE_BLEND);
+        } else {
+            SDL_SetColorKey(converted, SDL_TRUE, SDL_MapRGB(converted->format, 0xFF, 0x00, 0xFF));
+        }
+    }
+    return converted;
+}
+
+static SDL_Surface *
+create_destination(Uint32 format, int w, int h)
+{
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, w, h, 0, format);
+    int y;
+
+    if (!surface) {
+        return NULL;
+    }
+    for (y = 0; y < h; ++y) {
+        Uint8 *row = (Uint8 *)surface->pixels + y * surface->pitch;
+        int x;
+        for (x = 0; x < surface->pitch; ++x) {
+            row[x] = (Uint8)(random_pixel() >> 16);
+        }
+    }
+    return surface;
+}
+
+static int
+run_fill_test(const BlitTest *test, int w, int h, int iterations)
+{
+    SDL_Surface *dst = create_destination(test->dst_format, w, h);
+    Uint32 color;
+    Uint64 start, elapsed;
+    double ms, mbytes;
+    int i;
+
+    if (!dst) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create surface: %s\n", SDL_GetError());
+        return -1;
+    }
+    color = SDL_MapRGBA(dst->format, 0x12, 0x34, 0x56, 0x78);
+
+    /* Warm up */
+    SDL_FillRect(dst, NULL, color);
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < iterations; ++i) {
+        SDL_FillRect(dst, NULL, color);
+    }
+    elapsed = SDL_GetPerformanceCounter() - start;
+
+    ms = (double)elapsed * 1000.0 / SDL_GetPerformanceFrequency();
+    mbytes = ((double)dst->pitch * h * iterations) / (ms * 1000.0);
+    SDL_Log("fill %-9s: %8.3f ms per fill, %8.1f MB/s\n",
+            format_name(test->dst_format), ms / iterations, mbytes);
+
+    SDL_FreeSurface(dst);
+    return 0;
+}
+
+static int
+run_test(const BlitTest *test, int w, int h, int iterations)
+{
+    SDL_Surface *src = create_source(test->src_format, w, h);
+    SDL_Surface *dst = create_destination(test->dst_format, w, h);
+    Uint64 start, elapsed;
+    double ms, mpixels;
+    int i;
+
+    if (!src || !dst) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create surfaces: %s\n", SDL_GetError());
+        SDL_FreeSurface(src);
+        SDL_FreeSurface(dst);
+        return -1;
+    }
+    if (test->blend_mode == SDL_BLENDMODE_BLEND_PREMULTIPLIED ||
+        test->blend_mode == SDL_BLENDMODE_ADD_PREMULTIPLIED) {
+        SDL_Surface *premultiplied = SDL_ConvertSurface(src, src->format, SDL_PREMULTIPLIED);
+        SDL_FreeSurface(src);
+        src = premultiplied;
+        if (!src) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't premultiply source: %s\n", SDL_GetError());
+            SDL_FreeSurface(dst);
+            return -1;
+        }
+    }
+    SDL_SetSurfaceBlendMode(src, test->blend_mode);
+    SDL_SetSurfaceAlphaMod(src, (Uint8)test->alpha_mod);
+
+    /* Warm up, this also builds the blit mapping */
+    SDL_BlitSurface(src, NULL, dst, NULL);
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < iterations; ++i) {
+        SDL_BlitSurface(src, NULL, dst, NULL);
+    }
+    elapsed = SDL_GetPerformanceCounter() - start;
+
+    ms = (double)elapsed * 1000.0 / SDL_GetPerformanceFrequency();
+    mpixels = ((double)w * h * iterations) / (ms * 1000.0);
+    SDL_Log("%-9s -> %-9s %-6s alpha %3d: %8.3f ms per blit, %8.1f Mpixels/s\n",
+            format_name(test->src_format), format_name(test->dst_format),
+            blend_mode_name(test->blend_mode), test->alpha_mod,
+            ms / iterations, mpixels);
+
+    SDL_FreeSurface(src);
+    SDL_FreeSurface(dst);
+    return 0;
+}
+
+static double
+time_blits(SDL_Surface *src, SDL_Surface *dst, int iterations)
+{
+    Uint64 start, elapsed;
+    int i;
+
+    /* Warm up, this also builds the blit mapping */
+    SDL_BlitSurface(src, NULL, dst, NULL);
+
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < iterations; ++i) {
+        SDL_BlitSurface(src, NULL, dst, NULL);
+    }
+    elapsed = SDL_GetPerformanceCounter() - start;
+
+    return (double)elapsed * 1000.0 / SDL_GetPerformanceFrequency() / iterations;
+}
+
+static int
+run_rle_test(const BlitTest *test, int w, int h, int iterations)
+{
+    static const int transparent[] = { 10, 50, 90 };
+    int t;
+
+    for (t = 0; t < SDL_arraysize(transparent); ++t) {
+        SDL_Surface *src = create_sprite_sheet(test->src_format, w, h, transparent[t]);
+        SDL_Surface *dst = create_destination(test->dst_format, w, h);
+        SDL_Surface *rle = NULL;
+        const int encodes = SDL_max(iterations / 10, 1);
+        Uint64 start, elapsed = 0;
+        double encode_ms, blit_ms, rle_ms;
+        int i;
+
+        if (!src || !dst) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create surfaces: %s\n", SDL_GetError());
+            SDL_FreeSurface(src);
+            SDL_FreeSurface(dst);
+            return -1;
+        }
+        SDL_SetSurfaceAlphaMod(src, (Uint8)test->alpha_mod);
+
+        /* Encoding throws away the pixels, so each pass needs a fresh copy */
+        for (i = 0; i < encodes; ++i) {
+            SDL_FreeSurface(rle);
+            rle = SDL_ConvertSurface(src, src->format, 0);
+            if (!rle) {
+                break;
+            }
+            start = SDL_GetPerformanceCounter();
+            if (SDL_PrepareSurfaceRLE(rle, dst) < 0) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't RLE encode surface: %s\n", SDL_GetError());
+                break;
+            }
+            elapsed += SDL_GetPerformanceCounter() - start;
+        }
+        if (i < encodes) {
+            SDL_FreeSurface(rle);
+            SDL_FreeSurface(src);
+            SDL_FreeSurface(dst);
+            return -1;
+        }
+        encode_ms = (double)elapsed * 1000.0 / SDL_GetPerformanceFrequency() / encodes;
+
+        blit_ms = time_blits(src, dst, iterations);
+        rle_ms = time_blits(rle, dst, iterations);
+
+        SDL_Log("%-9s -> %-9s %-8s alpha %3d, %2d%% transparent: encode %8.3f ms, blit %8.3f ms, RLE blit %8.3f ms\n",
+                format_name(test->src_format), format_name(test->dst_format),
+                src->format->Amask ? "blend" : "colorkey", test->alpha_mod, transparent[t],
+                encode_ms, blit_ms, rle_ms);
+
+        SDL_FreeSurface(rle);
+        SDL_FreeSurface(src);
+        SDL_FreeSurface(dst);
+    }
+    return 0;
+}
+
+/* An uncompressed bottom-up BMP file, with no alpha in the 32-bit pixels */
+static Uint8 *
+create_bmp(int bpp, int w, int h, size_t *size)
+{
+    const int pitch = ((w * bpp / 8) + 3) & ~3;
+    const Uint32 header[13] = {
+        0, 0, 14 + 40,                  /* bfSize is filled in below */
+        40, (Uint32)w, (Uint32)h, 1 | (bpp << 16), 0, (Uint32)(pitch * h), 0, 0, 0, 0
+    };
+    Uint8 *bmp;
+    int i;
+
+    *size = 14 + 40 + (size_t)pitch * h;
+    bmp = (Uint8 *)SDL_malloc(*size);
+    if (!bmp) {
+        return NULL;
+    }
+    /* The header fields after the magic line up with 32-bit little endian words */
+    for (i = 0; i < SDL_arraysize(header); ++i) {
+        const Uint32 value = SDL_SwapLE32(i == 0 ? (Uint32)*size : header[i]);
+        SDL_memcpy(bmp + 2 + i * 4, &value, 4);
+    }
+    bmp[0] = 'B';
+    bmp[1] = 'M';
+    for (i = 14 + 40; i < (int)*size; ++i) {
+        bmp[i] = (Uint8)((bpp == 32 && ((i - (14 + 40)) & 3) == 3) ? 0 : random_pixel() >> 16);
+    }
+    return bmp;
+}
+
+static int
+run_loadbmp_test(int w, int h, int iterations)
+{
+    static const int depths[] = { 24, 32 };
+    const char *filename = "testblitspeed.bmp";
+    int d;
+
+    for (d = 0; d < SDL_arraysize(depths); ++d) {
+        size_t size = 0;
+        Uint8 *bmp = create_bmp(depths[d], w, h, &size);
+        SDL_RWops *rw;
+        Uint64 start, memory_elapsed = 0, file_elapsed = 0;
+        double memory_ms, file_ms;
+        int i;
+
+        if (!bmp) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory\n");
+            return -1;
+        }
+        rw = SDL_RWFromFile(filename, "wb");
+        if (!rw || SDL_RWwrite(rw, bmp, 1, size) != size) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't write %s: %s\n", filename, SDL_GetError());
+            if (rw) {
+                SDL_RWclose(rw);
+            }
+            SDL_free(bmp);
+            return -1;
+        }
+        SDL_RWclose(rw);
+
+        for (i = 0; i < iterations; ++i) {
+            SDL_Surface *surface;
+
+            start = SDL_GetPerformanceCounter();
+            surface = SDL_LoadBMP_RW(SDL_RWFromConstMem(bmp, (int)size), 1);
+            memory_elapsed += SDL_GetPerformanceCounter() - start;
+            if (!surface) {
+                break;
+            }
+            SDL_FreeSurface(surface);
+
+            start = SDL_GetPerformanceCounter();
+            surface = SDL_LoadBMP(filename);
+            file_elapsed += SDL_GetPerformanceCounter() - start;
+            if (!surface) {
+                break;
+            }
+            SDL_FreeSurface(surface);
+        }
+        SDL_free(bmp);
+        remove(filename);
+        if (i < iterations) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't load BMP: %s\n", SDL_GetError());
+            return -1;
+        }
+
+        memory_ms = (double)memory_elapsed * 1000.0 / SDL_GetPerformanceFrequency() / iterations;
+        file_ms = (double)file_elapsed * 1000.0 / SDL_GetPerformanceFrequency() / iterations;
+        SDL_Log("SDL_LoadBMP %2d-bpp: memory %8.3f ms (%6.0f MB/s), file %8.3f ms (%6.0f MB/s)\n",
+                depths[d], memory_ms, size / (memory_ms * 1000.0), file_ms, size / (file_ms * 1000.0));
+    }
+    return 0;
+}
+
+/* Create, convert and free scratch surfaces the way text and sprite rendering do */
+static int
+run_churn_test(const BlitTest *test, int w, int h, int iterations)
+{
+    static const char *modes[] = { "0", "" };
+    const int sizes[][2] = { { 24, 32 }, { 64, 64 }, { 200, 48 }, { w / 4, h / 4 } };
+    int m;
+
+    for (m = 0; m < SDL_arraysize(modes); ++m) {
+        Uint64 start, elapsed, hits, misses, hits2, misses2;
+        size_t cached;
+        int i, s;
+
+        SDL_SetHint(SDL_HINT_SURFACE_POOL_SIZE, modes[m]);
+        SDL_TrimSurfacePool(0);
+        SDL_GetSurfacePoolStats(&hits, &misses, NULL);
+
+        start = SDL_GetPerformanceCounter();
+        for (i = 0; i < iterations; ++i) {
+            for (s = 0; s < SDL_arraysize(sizes); ++s) {
+                SDL_Surface *src, *dst;
+
+                src = SDL_CreateRGBSurfaceWithFormat(0, sizes[s][0], sizes[s][1], 0, test->src_format);
+                if (!src) {
+                    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create surface: %s\n", SDL_GetError());
+                    return -1;
+                }
+                dst = SDL_ConvertSurfaceFormat(src, test->dst_format, 0);
+                SDL_FreeSurface(src);
+                if (!dst) {
+                    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't convert surface: %s\n", SDL_GetError());
+                    return -1;
+                }
+                SDL_FreeSurface(dst);
+            }
+        }
+        elapsed = SDL_GetPerformanceCounter() - start;
+
+        SDL_GetSurfacePoolStats(&hits2, &misses2, &cached);
+        SDL_Log("Surface churn, pool %-8s: %8.3f us/iteration, %d hits, %d misses, %d bytes cached\n",
+                *modes[m] ? "disabled" : "enabled",
+                (double)elapsed * 1000000.0 / SDL_GetPerformanceFrequency() / iterations,
+                (int)(hits2 - hits), (int)(misses2 - misses), (int)cached);
+    }
+    SDL_SetHint(SDL_HINT_SURFACE_POOL_SIZE, "");
+    return 0;
+}
+
+/* Decode random blocks the way SDL_UpdateTexture() does when the renderer can't sample the format */
+static int
+run_compressed_test(int w, int h, int iterations)
+{
+    static const Uint32 compressed_formats[] = {
+        SDL_PIXELFORMAT_BC1, SDL_PIXELFORMAT_BC3, SDL_PIXELFORMAT_BC4, SDL_PIXELFORMAT_BC5,
+        SDL_PIXELFORMAT_BC7, SDL_PIXELFORMAT_ETC2_RGB8, SDL_PIXELFORMAT_ETC2_RGBA8,
+        SDL_PIXELFORMAT_ASTC_4x4, SDL_PIXELFORMAT_ASTC_6x6, SDL_PIXELFORMAT_ASTC_8x8
+    };
+    const int dst_pitch = w * 4;
+    Uint32 *dst = (Uint32 *)SDL_malloc(dst_pitch * h);
+    int f;
+
+    if (!dst) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory\n");
+        return -1;
+    }
+    for (f = 0; f < SDL_arraysize(compressed_formats); ++f) {
+        const Uint32 format = compressed_formats[f];
+        const int block_bytes = (format == SDL_PIXELFORMAT_BC1 || format == SDL_PIXELFORMAT_BC4 ||
+                                 format == SDL_PIXELFORMAT_ETC2_RGB8) ? 8 : 16;
+        int block_w = 4, block_h = 4;
+        int src_pitch, rows, size, i;
+        Uint32 *src;
+        Uint64 start, elapsed;
+        double ms;
+
+        if (format == SDL_PIXELFORMAT_ASTC_6x6) {
+            block_w = block_h = 6;
+        } else if (format == SDL_PIXELFORMAT_ASTC_8x8) {
+            block_w = block_h = 8;
+        }
+        src_pitch = ((w + block_w - 1) / block_w) * block_bytes;
+        rows = (h + block_h - 1) / block_h;
+        size = src_pitch * rows;
+        src = (Uint32 *)SDL_malloc(size);
+        if (!src) {
+            SDL_free(dst);
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory\n");
+            return -1;
+        }
+        for (i = 0; i < size / 4; ++i) {
+            src[i] = random_pixel();
+        }
+
+        start = SDL_GetPerformanceCounter();
+        for (i = 0; i < iterations; ++i) {
+            if (SDL_ConvertPixels(w, h, format, src, src_pitch, SDL_PIXELFORMAT_ARGB8888, dst, dst_pitch) < 0) {
+                break;
+            }
+        }
+        elapsed = SDL_GetPerformanceCounter() - start;
+        SDL_free(src);
+        if (i < iterations) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't decode %s: %s\n", format_name(format), SDL_GetError());
+            SDL_free(dst);
+            return -1;
+        }
+
+        ms = (double)elapsed * 1000.0 / SDL_GetPerformanceFrequency() / iterations;
+        SDL_Log("Decode %-12s: %8.3f ms (%6.1f Mpixels/s), %8d bytes, %4.1f%% of ARGB8888\n",
+                format_name(format), ms, (double)w * h / (ms * 1000.0), size, size * 100.0 / (dst_pitch * h));
+    }
+    SDL_free(dst);
+    return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+    BlitTest test;
+    SDL_bool custom = SDL_FALSE;
+    int w = 1920, h = 1080;
+    int iterations = 100;
+    int arg;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    test.src_format = SDL_PIXELFORMAT_ARGB8888;
+    test.dst_format = SDL_PIXELFORMAT_ARGB8888;
+    test.blend_mode = SDL_BLENDMODE_BLEND;
+    test.alpha_mod = 255;
+    test.fill = SDL_FALSE;
+    test.rle = SDL_FALSE;
+    test.loadbmp = SDL_FALSE;
+    test.churn = SDL_FALSE;
+    test.compressed = SDL_FALSE;
+
+    for (arg = 1; arg < argc; ++arg) {
+        const char *next = (arg + 1 < argc) ? argv[arg + 1] : NULL;
+        if (SDL_strcmp(argv[arg], "--srcformat") == 0 && next) {
+            test.src_format = format_from_name(next);
+            custom = SDL_TRUE;
+            ++arg;
+        } else if (SDL_strcmp(argv[arg], "--dstformat") == 0 && next) {
+            test.dst_format = format_from_name(next);
+            custom = SDL_TRUE;
+            ++arg;
+        } else if (SDL_strcmp(argv[arg], "--blendmode") == 0 && next) {
+            if (SDL_strcmp(next, "none") == 0) {
+                test.blend_mode = SDL_BLENDMODE_NONE;
+            } else if (SDL_strcmp(next, "blend") == 0) {
+                test.blend_mode = SDL_BLENDMODE_BLEND;
+            } else if (SDL_strcmp(next, "pblend") == 0) {
+                test.blend_mode = SDL_BLENDMODE_BLEND_PREMULTIPLIED;
+            } else if (SDL_strcmp(next, "add") == 0) {
+                test.blend_mode = SDL_BLENDMODE_ADD;
+            } else if (SDL_strcmp(next, "padd") == 0) {
+                test.blend_mode = SDL_BLENDMODE_ADD_PREMULTIPLIED;
+            } else if (SDL_strcmp(next, "mod") == 0) {
+                test.blend_mode = SDL_BLENDMODE_MOD;
+            } else {
+                break;
+            }
+            custom = SDL_TRUE;
+            ++arg;
+        } else if (SDL_strcmp(argv[arg], "--alphamod") == 0 && next) {
+            test.alpha_mod = SDL_atoi(next);
+            custom = SDL_TRUE;
+            ++arg;
+        } else if (SDL_strcmp(argv[arg], "--fill") == 0) {
+            test.fill = SDL_TRUE;
+            custom = SDL_TRUE;
+        } else if (SDL_strcmp(argv[arg], "--rle") == 0) {
+            test.rle = SDL_TRUE;
+        } else if (SDL_strcmp(argv[arg], "--loadbmp") == 0) {
+            test.loadbmp = SDL_TRUE;
+        } else if (SDL_strcmp(argv[arg], "--churn") == 0) {
+            test.churn = SDL_TRUE;
+        } else if (SDL_strcmp(argv[arg], "--compressed") == 0) {
+            test.compressed = SDL_TRUE;
+        } else if (SDL_strcmp(argv[arg], "--width") == 0 && next) {
+            w = SDL_atoi(next);
+            ++arg;
+        } else if (SDL_strcmp(argv[arg], "--height") == 0 && next) {
+            h = SDL_atoi(next);
+            ++arg;
+        } else if (SDL_strcmp(argv[arg], "--iterations") == 0 && next) {
+            iterations = SDL_atoi(next);
+            ++arg;
+        } else {
+            break;
+        }
+    }
+    if (arg < argc || test.src_format == SDL_PIXELFORMAT_UNKNOWN ||
+        test.dst_format == SDL_PIXELFORMAT_UNKNOWN || w <= 0 || h <= 0 || iterations <= 0) {
+        SDL_Log("Usage: %s [--srcformat FORMAT] [--dstformat FORMAT] [--blendmode none|blend|pblend|add|padd|mod] [--alphamod N] [--fill] [--rle] [--loadbmp] [--churn] [--compressed] [--width N] [--height N] [--iterations N]\n", argv[0]);
+        return 1;
+    }
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    SDL_Log("%dx%d, %d iterations, SSE2 %s, AVX2 %s, NEON %s\n", w, h, iterations,
+            SDL_HasSSE2() ? "yes" : "no", SDL_HasAVX2() ? "yes" : "no", SDL_HasNEON() ? "yes" : "no");
+
+    if (test.loadbmp) {
+        run_loadbmp_test(w, h, iterations);
+    } else if (test.churn) {
+        run_churn_test(&test, w, h, iterations);
+    } else if (test.compressed) {
+        run_compressed_test(w, h, iterations);
+    } else if (test.fill) {
+        run_fill_test(&test, w, h, iterations);
+    } else if (test.rle) {
+        run_rle_test(&test, w, h, iterations);
+    } else if (custom) {
+        run_test(&test, w, h, iterations);
+    } else {
+        int i;
+        for (i = 0; i < SDL_arraysize(default_tests); ++i) {
+            run_test(&default_tests[i], w, h, iterations);
+        }
+    }
+
+    SDL_Quit();
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
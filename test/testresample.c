@@ -12,6 +12,84 @@
 
 #include "SDL.h"
 
+/* Time SDL_ConvertAudio() and SDL_AudioStream on one second of generated F32 audio */
+static int
+benchmark(const int channels, const int iterations)
+{
+    static const int rates[][2] = {
+        { 44100, 48000 }, { 48000, 44100 }, { 22050, 48000 }, { 48000, 96000 }, { 96000, 48000 }
+    };
+    int r;
+
+    for (r = 0; r < SDL_arraysize(rates); ++r) {
+        const int srcrate = rates[r][0];
+        const int dstrate = rates[r][1];
+        const int len = srcrate * channels * (int) sizeof (float);
+        const int outmax = dstrate * channels * (int) sizeof (float) + 4096;
+        float *samples = (float *) SDL_malloc(len);
+        Uint8 *out = NULL;
+        SDL_AudioCVT cvt;
+        SDL_AudioStream *stream = NULL;
+        Uint64 start, cvt_elapsed = 0, stream_elapsed = 0;
+        double cvt_ms, stream_ms;
+        int i, outlen = 0, allocations = 0;
+
+        SDL_zero(cvt);
+        if (!samples || SDL_BuildAudioCVT(&cvt, AUDIO_F32SYS, channels, srcrate, AUDIO_F32SYS, channels, dstrate) < 0 ||
+            (cvt.buf = (Uint8 *) SDL_malloc(len * cvt.len_mult)) == NULL ||
+            (stream = SDL_NewAudioStream(AUDIO_F32SYS, channels, srcrate, AUDIO_F32SYS, channels, dstrate)) == NULL ||
+            (out = (Uint8 *) SDL_malloc(outmax)) == NULL) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't set up %d -> %d: %s\n", srcrate, dstrate, SDL_GetError());
+            SDL_FreeAudioStream(stream);
+            SDL_free(cvt.buf);
+            SDL_free(out);
+            SDL_free(samples);
+            return 1;
+        }
+        for (i = 0; i < len / (int) sizeof (float); ++i) {
+            samples[i] = SDL_sinf((float) (i / channels) * 2.0f * 3.14159265f * (440.0f + (i % channels) * 110.0f) / srcrate) * 0.5f;
+        }
+
+        for (i = 0; i < iterations; ++i) {
+            SDL_memcpy(cvt.buf, samples, len);
+            cvt.len = len;
+            start = SDL_GetPerformanceCounter();
+            SDL_ConvertAudio(&cvt);
+            cvt_elapsed += SDL_GetPerformanceCounter() - start;
+
+            /* Feed the stream in device sized pieces, the way audio callbacks do.
+               The first pass grows the stream's queue; after that, nothing should stay allocated. */
+            if (i == 1) {
+                allocations = SDL_GetNumAllocations();
+            }
+            start = SDL_GetPerformanceCounter();
+            {
+                const int chunk = 1024 * channels * (int) sizeof (float);
+                int pos;
+                for (pos = 0; pos < len; pos += chunk) {
+                    SDL_AudioStreamPut(stream, (Uint8 *) samples + pos, SDL_min(chunk, len - pos));
+                }
+                outlen = SDL_AudioStreamGet(stream, out, outmax);
+            }
+            stream_elapsed += SDL_GetPerformanceCounter() - start;
+        }
+        if (iterations > 1) {
+            allocations = SDL_GetNumAllocations() - allocations;
+        }
+
+        cvt_ms = (double) cvt_elapsed * 1000.0 / SDL_GetPerformanceFrequency() / iterations;
+        stream_ms = (double) stream_elapsed * 1000.0 / SDL_GetPerformanceFrequency() / iterations;
+        SDL_Log("%5d -> %5d, %d channels: SDL_ConvertAudio %7.3f ms (%6.0fx realtime), SDL_AudioStream %7.3f ms (%6.0fx realtime, %d bytes), %d allocations kept\n",
+                srcrate, dstrate, channels, cvt_ms, 1000.0 / cvt_ms, stream_ms, 1000.0 / stream_ms, outlen, allocations);
+
+        SDL_FreeAudioStream(stream);
+        SDL_free(cvt.buf);
+        SDL_free(out);
+        SDL_free(samples);
+    }
+    return 0;
+}
+
 int
 main(int argc, char **argv)
 {
@@ -29,8 +107,20 @@ main(int argc, char **argv)
     /* Enable standard application logging */
     SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
 
+    if (argc >= 2 && SDL_strcmp(argv[1], "--benchmark") == 0) {
+        int retval;
+        if (SDL_Init(SDL_INIT_AUDIO) == -1) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "SDL_Init() failed: %s\n", SDL_GetError());
+            return 2;
+        }
+        retval = benchmark((argc >= 3) ? SDL_atoi(argv[2]) : 2, (argc >= 4) ? SDL_atoi(argv[3]) : 20);
+        SDL_Quit();
+        return retval;
+    }
+
     if (argc != 5) {
         SDL_Log("USAGE: %s in.wav out.wav newfreq newchans\n", argv[0]);
+        SDL_Log("       %s --benchmark [channels] [iterations]\n", argv[0]);
         return 1;
     }
 
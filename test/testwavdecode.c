@@ -0,0 +1,225 @@
+/*
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Times SDL_LoadWAV_RW() decoding A-law, mu-law, MS ADPCM and IMA ADPCM,
+   on short sounds the size of sample.wav and on ten minute tracks, and
+   prints a checksum of the decoded audio so different builds can be
+   compared. Any WAVE files given on the command line are timed too. */
+
+#include <stdlib.h>
+
+#include "SDL.h"
+
+static const struct
+{
+    const char *name;
+    Uint16 tag;
+    Uint16 channels;
+    Uint16 bits;
+    Uint16 blockalign;
+    Uint16 samplesperblock;
+} formats[] = {
+    { "A-law stereo", 0x0006, 2, 8, 2, 0 },
+    { "mu-law stereo", 0x0007, 2, 8, 2, 0 },
+    { "MS ADPCM mono", 0x0002, 1, 4, 512, 1012 },
+    { "MS ADPCM stereo", 0x0002, 2, 4, 1024, 1012 },
+    { "IMA ADPCM mono", 0x0011, 1, 4, 512, 1017 },
+    { "IMA ADPCM stereo", 0x0011, 2, 4, 1024, 1017 },
+    { "IMA ADPCM 5.1", 0x0011, 6, 4, 3072, 1017 }
+};
+
+static const struct
+{
+    const char *name;
+    int freq;
+    int seconds;
+} lengths[] = {
+    { "11 s at 22050 Hz", 22050, 11 },
+    { "10 min at 44100 Hz", 44100, 600 }
+};
+
+static void
+put16(Uint8 **p, Uint16 v)
+{
+    *(*p)++ = (Uint8) (v & 0xff);
+    *(*p)++ = (Uint8) (v >> 8);
+}
+
+static void
+put32(Uint8 **p, Uint32 v)
+{
+    put16(p, (Uint16) (v & 0xffff));
+    put16(p, (Uint16) (v >> 16));
+}
+
+/* A WAVE file of random data, which decodes to noise. */
+static Uint8 *
+make_wav(const int f, const int freq, const int seconds, size_t *len)
+{
+    static const Sint16 coeffs[14] = { 256, 0, 512, -256, 0, 0, 192, 64, 240, 0, 460, -208, 392, -232 };
+    const Uint16 tag = formats[f].tag;
+    const Uint16 blockalign = formats[f].blockalign;
+    const Uint32 frames = (Uint32) freq * seconds;
+    const Uint32 fmtlen = (tag == 0x0002) ? 50 : (tag == 0x0011) ? 20 : 18;
+    Uint32 datalen, i;
+    Uint8 *wav, *p;
+
+    if (formats[f].samplesperblock) {
+        datalen = ((frames + formats[f].samplesperblock - 1) / formats[f].samplesperblock) * blockalign;
+    } else {
+        datalen = frames * blockalign;
+    }
+
+    wav = (Uint8 *) SDL_malloc(28 + fmtlen + datalen);
+    if (!wav) {
+        return NULL;
+    }
+
+    p = wav;
+    SDL_memcpy(p, "RIFF", 4); p += 4;
+    put32(&p, 20 + fmtlen + datalen);
+    SDL_memcpy(p, "WAVEfmt ", 8); p += 8;
+    put32(&p, fmtlen);
+    put16(&p, tag);
+    put16(&p, formats[f].channels);
+    put32(&p, freq);
+    put32(&p, (Uint32) freq * blockalign / (formats[f].samplesperblock ? formats[f].samplesperblock : 1));
+    put16(&p, blockalign);
+    put16(&p, formats[f].bits);
+    if (tag == 0x0002) {
+        put16(&p, 32);
+        put16(&p, formats[f].samplesperblock);
+        put16(&p, 7);
+        for (i = 0; i < 14; i++) {
+            put16(&p, (Uint16) coeffs[i]);
+        }
+    } else if (tag == 0x0011) {
+        put16(&p, 2);
+        put16(&p, formats[f].samplesperblock);
+    } else {
+        put16(&p, 0);
+    }
+    SDL_memcpy(p, "data", 4); p += 4;
+    put32(&p, datalen);
+
+    for (i = 0; i < datalen; i++) {
+        p[i] = (Uint8) rand();
+    }
+    if (tag == 0x0002) {
+        /* Each block starts with a predictor index per channel. */
+        for (i = 0; i < datalen; i += blockalign) {
+            Uint16 c;
+            for (c = 0; c < formats[f].channels; c++) {
+                p[i + c] = (Uint8) (rand() % 7);
+            }
+        }
+    }
+
+    *len = 28 + fmtlen + datalen;
+    return wav;
+}
+
+/* FNV-1a, to tell whether two builds decode the same. */
+static Uint32
+checksum(const Uint8 *buf, Uint32 len)
+{
+    Uint32 hash = 2166136261u;
+    Uint32 i;
+    for (i = 0; i < len; i++) {
+        hash = (hash ^ buf[i]) * 16777619u;
+    }
+    return hash;
+}
+
+/* Loads the WAVE data repeatedly for at least half a second. */
+static void
+bench(const char *name, const char *length, const Uint8 *wav, const size_t len)
+{
+    const double freq = (double) SDL_GetPerformanceFrequency();
+    Uint64 start, elapsed = 0;
+    Uint64 decoded = 0;
+    Uint32 hash = 0;
+    int runs = 0;
+
+    do {
+        SDL_AudioSpec spec;
+        Uint8 *buf;
+        Uint32 buflen;
+
+        start = SDL_GetPerformanceCounter();
+        if (!SDL_LoadWAV_RW(SDL_RWFromConstMem(wav, (int) len), 1, &spec, &buf, &buflen)) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "%s: %s\n", name, SDL_GetError());
+            return;
+        }
+        elapsed += SDL_GetPerformanceCounter() - start;
+
+        if (runs++ == 0) {
+            hash = checksum(buf, buflen);
+        }
+        decoded += buflen;
+        SDL_FreeWAV(buf);
+    } while (elapsed < freq / 2);
+
+    SDL_Log("%-18s %-20s %8.2f ms per load, %7.1f MB/s decoded, checksum %08x\n",
+            name, length, (elapsed * 1000.0 / freq) / runs,
+            (decoded / (1024.0 * 1024.0)) / (elapsed / freq), (unsigned int) hash);
+}
+
+int
+main(int argc, char **argv)
+{
+    int f, l, i;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    srand(0);
+    for (l = 0; l < SDL_arraysize(lengths); l++) {
+        for (f = 0; f < SDL_arraysize(formats); f++) {
+            size_t len;
+            Uint8 *wav = make_wav(f, lengths[l].freq, lengths[l].seconds, &len);
+            if (!wav) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory!\n");
+                SDL_Quit();
+                return 1;
+            }
+            bench(formats[f].name, lengths[l].name, wav, len);
+            SDL_free(wav);
+        }
+    }
+
+    for (i = 1; i < argc; i++) {
+        SDL_RWops *rw = SDL_RWFromFile(argv[i], "rb");
+        Sint64 size = rw ? SDL_RWsize(rw) : -1;
+        Uint8 *wav = (size > 0) ? (Uint8 *) SDL_malloc((size_t) size) : NULL;
+
+        if (wav && SDL_RWread(rw, wav, (size_t) size, 1) == 1) {
+            bench(argv[i], "", wav, (size_t) size);
+        } else {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't read %s: %s\n", argv[i], SDL_GetError());
+        }
+        SDL_free(wav);
+        if (rw) {
+            SDL_RWclose(rw);
+        }
+    }
+
+    SDL_Quit();
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,186 @@
+/*
+  Copyright (C) 1997-2019 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Compares SDL_LoadWAV_RW() with SDL_OpenWAVStream_RW(): how long it takes
+   until the first sample is ready, how long decoding all of it takes, and
+   the peak memory use. Run it once per mode, since peak memory only grows.
+
+   Without a file, it makes up ten minutes of 44.1 kHz stereo IMA ADPCM in
+   memory, so both modes start from the same baseline. */
+
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#ifdef __LINUX__
+#include <sys/resource.h>
+#endif
+
+#define MINUTES 10
+#define FREQ 44100
+#define BLOCKALIGN 2048
+#define SAMPLESPERBLOCK 2041
+
+/* Peak resident memory in KiB, or -1 if unknown. */
+static long
+peak_rss(void)
+{
+#ifdef __LINUX__
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        return usage.ru_maxrss;
+    }
+#endif
+    return -1;
+}
+
+static void
+put16(Uint8 **p, Uint16 v)
+{
+    *(*p)++ = (Uint8) (v & 0xff);
+    *(*p)++ = (Uint8) (v >> 8);
+}
+
+static void
+put32(Uint8 **p, Uint32 v)
+{
+    put16(p, (Uint16) (v & 0xffff));
+    put16(p, (Uint16) (v >> 16));
+}
+
+/* Stereo IMA ADPCM of random noise. */
+static Uint8 *
+make_wav(size_t *len)
+{
+    const Uint32 blocks = (Uint32) ((Uint64) FREQ * 60 * MINUTES / SAMPLESPERBLOCK);
+    const Uint32 datalen = blocks * BLOCKALIGN;
+    Uint8 *wav = (Uint8 *) SDL_malloc(48 + datalen);
+    Uint8 *p = wav;
+    Uint32 i;
+
+    if (!wav) {
+        return NULL;
+    }
+
+    SDL_memcpy(p, "RIFF", 4); p += 4;
+    put32(&p, 40 + datalen);
+    SDL_memcpy(p, "WAVEfmt ", 8); p += 8;
+    put32(&p, 20);
+    put16(&p, 0x0011);
+    put16(&p, 2);
+    put32(&p, FREQ);
+    put32(&p, (Uint32) ((Uint64) FREQ * BLOCKALIGN / SAMPLESPERBLOCK));
+    put16(&p, BLOCKALIGN);
+    put16(&p, 4);
+    put16(&p, 2);
+    put16(&p, SAMPLESPERBLOCK);
+    SDL_memcpy(p, "data", 4); p += 4;
+    put32(&p, datalen);
+    for (i = 0; i < datalen; i++) {
+        p[i] = (Uint8) rand();
+    }
+
+    *len = 48 + datalen;
+    return wav;
+}
+
+int
+main(int argc, char **argv)
+{
+    const SDL_bool stream = (argc > 1) && (SDL_strcmp(argv[1], "stream") == 0);
+    const double freq = (double) SDL_GetPerformanceFrequency();
+    Uint8 *file = NULL;
+    size_t filelen = 0;
+    SDL_RWops *rw;
+    SDL_AudioSpec spec;
+    Uint64 start, first, done;
+    Uint64 decoded = 0;
+    long baseline;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if ((argc < 2) || (!stream && SDL_strcmp(argv[1], "load") != 0)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "USAGE: %s <load|stream> [file.wav]", argv[0]);
+        return 1;
+    }
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    if (argc > 2) {
+        rw = SDL_RWFromFile(argv[2], "rb");
+    } else {
+        file = make_wav(&filelen);
+        rw = file ? SDL_RWFromConstMem(file, (int) filelen) : NULL;
+    }
+    if (!rw) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't open the WAVE data: %s\n", SDL_GetError());
+        SDL_free(file);
+        SDL_Quit();
+        return 1;
+    }
+
+    baseline = peak_rss();
+    start = SDL_GetPerformanceCounter();
+
+    if (stream) {
+        Uint8 buf[16384];
+        SDL_WAVStream *wav = SDL_OpenWAVStream_RW(rw, 1, &spec);
+        int len;
+
+        if (!wav) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't open WAVE stream: %s\n", SDL_GetError());
+            SDL_free(file);
+            SDL_Quit();
+            return 1;
+        }
+
+        len = SDL_WAVStreamRead(wav, buf, sizeof (buf));
+        first = SDL_GetPerformanceCounter();
+        while (len > 0) {
+            decoded += len;
+            len = SDL_WAVStreamRead(wav, buf, sizeof (buf));
+        }
+        done = SDL_GetPerformanceCounter();
+        SDL_CloseWAVStream(wav);
+    } else {
+        Uint8 *buf;
+        Uint32 len;
+
+        if (!SDL_LoadWAV_RW(rw, 1, &spec, &buf, &len)) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't load WAVE data: %s\n", SDL_GetError());
+            SDL_free(file);
+            SDL_Quit();
+            return 1;
+        }
+        first = done = SDL_GetPerformanceCounter();
+        decoded = len;
+        SDL_FreeWAV(buf);
+    }
+
+    SDL_Log("%s: %.1f MB decoded, first sample after %.3f ms, all of it after %.1f ms\n",
+            stream ? "SDL_OpenWAVStream_RW" : "SDL_LoadWAV_RW", decoded / (1024.0 * 1024.0),
+            (first - start) * 1000.0 / freq, (done - start) * 1000.0 / freq);
+    if (baseline >= 0) {
+        SDL_Log("Peak RSS: %ld KiB, %ld KiB above the %ld KiB before decoding\n",
+                peak_rss(), peak_rss() - baseline, baseline);
+    }
+
+    SDL_free(file);
+    SDL_Quit();
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
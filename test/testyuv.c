@@ -18,8 +18,8 @@
 #include "testyuv_cvt.h"
 
 
-/* 422 (YUY2, etc) formats are the largest */
-#define MAX_YUV_SURFACE_SIZE(W, H, P)  (H*4*(W+P+1)/2)
+/* 16-bit 420 (P010, etc) formats are the largest */
+#define MAX_YUV_SURFACE_SIZE(W, H, P)  (((H)+1)*3*(2*(W)+(P)+4)/2)
 
 
 /* Return true if the YUV format is packed pixels */
@@ -30,6 +30,23 @@ static SDL_bool is_packed_yuv_format(Uint32 format)
             format == SDL_PIXELFORMAT_YVYU);
 }
 
+/* Return true if the YUV format has 16-bit samples */
+static SDL_bool is_16bit_yuv_format(Uint32 format)
+{
+    return (format == SDL_PIXELFORMAT_P010 ||
+            format == SDL_PIXELFORMAT_P016 ||
+            format == SDL_PIXELFORMAT_I010);
+}
+
+/* Return the pitch of a YUV image with extra padding, kept even for 16-bit samples */
+static int calculate_padded_yuv_pitch(Uint32 format, int width, int extra_pitch)
+{
+    if (is_16bit_yuv_format(format)) {
+        extra_pitch = (extra_pitch + 1) & ~1;
+    }
+    return CalculateYUVPitch(format, width) + extra_pitch;
+}
+
 /* Create a surface with a good pattern for verifying YUV conversion */
 static SDL_Surface *generate_test_pattern(int pattern_size)
 {
@@ -42,7 +59,7 @@ static SDL_Surface *generate_test_pattern(int pattern_size)
 
         /* R, G, B in alternating horizontal bands */
         for (y = 0; y < pattern->h; y += thickness) {
-            for (i = 0; i < thickness; ++i) {
+            for (i = 0; i < thickness && (y + i) < pattern->h; ++i) {
                 p = (Uint8 *)pattern->pixels + (y + i) * pattern->pitch + ((y/thickness) % 3);
                 for (x = 0; x < pattern->w; ++x) {
                     *p = 0xFF;
@@ -120,7 +137,10 @@ static int run_automated_tests(int pattern_size, int extra_pitch)
         SDL_PIXELFORMAT_NV21,
         SDL_PIXELFORMAT_YUY2,
         SDL_PIXELFORMAT_UYVY,
-        SDL_PIXELFORMAT_YVYU
+        SDL_PIXELFORMAT_YVYU,
+        SDL_PIXELFORMAT_P010,
+        SDL_PIXELFORMAT_P016,
+        SDL_PIXELFORMAT_I010
     };
     int i, j;
     SDL_Surface *pattern = generate_test_pattern(pattern_size);
@@ -150,7 +170,7 @@ static int run_automated_tests(int pattern_size, int extra_pitch)
 
     /* Verify conversion to YUV formats */
     for (i = 0; i < SDL_arraysize(formats); ++i) {
-        yuv1_pitch = CalculateYUVPitch(formats[i], pattern->w) + extra_pitch;
+        yuv1_pitch = calculate_padded_yuv_pitch(formats[i], pattern->w, extra_pitch);
         if (SDL_ConvertPixels(pattern->w, pattern->h, pattern->format->format, pattern->pixels, pattern->pitch, formats[i], yuv1, yuv1_pitch) < 0) {
             SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't convert %s to %s: %s\n", SDL_GetPixelFormatName(pattern->format->format), SDL_GetPixelFormatName(formats[i]), SDL_GetError());
             goto done;
@@ -164,8 +184,8 @@ static int run_automated_tests(int pattern_size, int extra_pitch)
     /* Verify conversion between YUV formats */
     for (i = 0; i < SDL_arraysize(formats); ++i) {
         for (j = 0; j < SDL_arraysize(formats); ++j) {
-            yuv1_pitch = CalculateYUVPitch(formats[i], pattern->w) + extra_pitch;
-            yuv2_pitch = CalculateYUVPitch(formats[j], pattern->w) + extra_pitch;
+            yuv1_pitch = calculate_padded_yuv_pitch(formats[i], pattern->w, extra_pitch);
+            yuv2_pitch = calculate_padded_yuv_pitch(formats[j], pattern->w, extra_pitch);
             if (SDL_ConvertPixels(pattern->w, pattern->h, pattern->format->format, pattern->pixels, pattern->pitch, formats[i], yuv1, yuv1_pitch) < 0) {
                 SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't convert %s to %s: %s\n", SDL_GetPixelFormatName(pattern->format->format), SDL_GetPixelFormatName(formats[i]), SDL_GetError());
                 goto done;
@@ -188,9 +208,13 @@ static int run_automated_tests(int pattern_size, int extra_pitch)
                 /* Can't change plane vs packed pixel layout in-place */
                 continue;
             }
+            if (is_16bit_yuv_format(formats[i]) != is_16bit_yuv_format(formats[j])) {
+                /* Can't change the sample size in-place */
+                continue;
+            }
 
-            yuv1_pitch = CalculateYUVPitch(formats[i], pattern->w) + extra_pitch;
-            yuv2_pitch = CalculateYUVPitch(formats[j], pattern->w) + extra_pitch;
+            yuv1_pitch = calculate_padded_yuv_pitch(formats[i], pattern->w, extra_pitch);
+            yuv2_pitch = calculate_padded_yuv_pitch(formats[j], pattern->w, extra_pitch);
             if (SDL_ConvertPixels(pattern->w, pattern->h, pattern->format->format, pattern->pixels, pattern->pitch, formats[i], yuv1, yuv1_pitch) < 0) {
                 SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't convert %s to %s: %s\n", SDL_GetPixelFormatName(pattern->format->format), SDL_GetPixelFormatName(formats[i]), SDL_GetError());
                 goto done;
@@ -216,6 +240,656 @@ done:
     return result;
 }
 
+/* Copy the two pixel wide column of a YUV image starting at pixel x into its own image */
+static void extract_yuv_column(Uint32 format, const Uint8 *src, int w, int h, int x, Uint8 *dst)
+{
+    const int pitch = CalculateYUVPitch(format, w);
+    const int uv_w = (w + 1) / 2;
+    const int uv_h = (h + 1) / 2;
+    int row, plane;
+
+    if (is_packed_yuv_format(format)) {
+        for (row = 0; row < h; ++row) {
+            SDL_memcpy(dst + row * 4, src + row * pitch + x * 2, 4);
+        }
+        return;
+    }
+
+    for (row = 0; row < h; ++row) {
+        SDL_memcpy(dst + row * 2, src + row * pitch + x, 2);
+    }
+    src += pitch * h;
+    dst += 2 * h;
+
+    if (format == SDL_PIXELFORMAT_NV12 || format == SDL_PIXELFORMAT_NV21) {
+        for (row = 0; row < uv_h; ++row) {
+            SDL_memcpy(dst + row * 2, src + row * uv_w * 2 + x, 2);
+        }
+    } else {
+        for (plane = 0; plane < 2; ++plane) {
+            for (row = 0; row < uv_h; ++row) {
+                dst[row] = src[row * uv_w + x / 2];
+            }
+            src += uv_w * uv_h;
+            dst += uv_h;
+        }
+    }
+}
+
+/* The SIMD converters only handle whole blocks of pixels and leave the rest
+   of each line to the C version. Converting a two pixel wide image always
+   goes through the C version, so converting a wide image a column at a time
+   gives a reference that the SIMD output has to match exactly. */
+static int run_yuv_to_rgb_exactness_tests(void)
+{
+    const Uint32 yuv_formats[] = {
+        SDL_PIXELFORMAT_YV12,
+        SDL_PIXELFORMAT_IYUV,
+        SDL_PIXELFORMAT_NV12,
+        SDL_PIXELFORMAT_NV21,
+        SDL_PIXELFORMAT_YUY2,
+        SDL_PIXELFORMAT_UYVY,
+        SDL_PIXELFORMAT_YVYU
+    };
+    const Uint32 rgb_formats[] = {
+        SDL_PIXELFORMAT_RGB565,
+        SDL_PIXELFORMAT_RGB24,
+        SDL_PIXELFORMAT_RGBA8888,
+        SDL_PIXELFORMAT_BGRA8888,
+        SDL_PIXELFORMAT_ARGB8888,
+        SDL_PIXELFORMAT_ABGR8888
+    };
+    const SDL_YUV_CONVERSION_MODE modes[] = {
+        SDL_YUV_CONVERSION_JPEG,
+        SDL_YUV_CONVERSION_BT601,
+        SDL_YUV_CONVERSION_BT709
+    };
+    const SDL_YUV_CONVERSION_MODE saved_mode = SDL_GetYUVConversionMode();
+    const int w = 100, h = 5;
+    const int yuv_len = MAX_YUV_SURFACE_SIZE(w, h, 0);
+    Uint8 *yuv = (Uint8 *)SDL_malloc(yuv_len);
+    Uint8 *column = (Uint8 *)SDL_malloc(MAX_YUV_SURFACE_SIZE(2, h, 0));
+    Uint8 *rgb = (Uint8 *)SDL_malloc(w * h * 4);
+    Uint8 *rgb_column = (Uint8 *)SDL_malloc(2 * h * 4);
+    int i, j, m, x, row;
+    int result = -1;
+
+    if (!yuv || !column || !rgb || !rgb_column) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory");
+        goto done;
+    }
+
+    /* Random data, with plenty of saturated values to exercise the clamping */
+    srand(1);
+    for (i = 0; i < yuv_len; ++i) {
+        const int r = rand();
+        yuv[i] = (r & 0x300) ? (Uint8)r : ((r & 0x400) ? 0xFF : 0x00);
+    }
+
+    for (m = 0; m < SDL_arraysize(modes); ++m) {
+        SDL_SetYUVConversionMode(modes[m]);
+        for (i = 0; i < SDL_arraysize(yuv_formats); ++i) {
+            const int yuv_pitch = CalculateYUVPitch(yuv_formats[i], w);
+            for (j = 0; j < SDL_arraysize(rgb_formats); ++j) {
+                const int bpp = SDL_BYTESPERPIXEL(rgb_formats[j]);
+
+                if (SDL_ConvertPixels(w, h, yuv_formats[i], yuv, yuv_pitch, rgb_formats[j], rgb, w * bpp) < 0) {
+                    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't convert %s to %s: %s\n", SDL_GetPixelFormatName(yuv_formats[i]), SDL_GetPixelFormatName(rgb_formats[j]), SDL_GetError());
+                    goto done;
+                }
+                for (x = 0; x < w; x += 2) {
+                    extract_yuv_column(yuv_formats[i], yuv, w, h, x, column);
+                    if (SDL_ConvertPixels(2, h, yuv_formats[i], column, CalculateYUVPitch(yuv_formats[i], 2), rgb_formats[j], rgb_column, 2 * bpp) < 0) {
+                        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't convert %s to %s: %s\n", SDL_GetPixelFormatName(yuv_formats[i]), SDL_GetPixelFormatName(rgb_formats[j]), SDL_GetError());
+                        goto done;
+                    }
+                    for (row = 0; row < h; ++row) {
+                        if (SDL_memcmp(rgb + row * w * bpp + x * bpp, rgb_column + row * 2 * bpp, 2 * bpp) != 0) {
+                            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Conversion from %s to %s differs from the reference at %d,%d\n", SDL_GetPixelFormatName(yuv_formats[i]), SDL_GetPixelFormatName(rgb_formats[j]), x, row);
+                            goto done;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    result = 0;
+
+done:
+    SDL_SetYUVConversionMode(saved_mode);
+    SDL_free(yuv);
+    SDL_free(column);
+    SDL_free(rgb);
+    SDL_free(rgb_column);
+    return result;
+}
+
+/* Converting a large frame in bands on several threads has to give the same
+   result as converting it in one go */
+static int run_threaded_conversion_tests(void)
+{
+    const Uint32 yuv_formats[] = {
+        SDL_PIXELFORMAT_YV12,
+        SDL_PIXELFORMAT_NV21,
+        SDL_PIXELFORMAT_YUY2
+    };
+    const Uint32 rgb_formats[] = {
+        SDL_PIXELFORMAT_ARGB8888,
+        SDL_PIXELFORMAT_RGB24,
+        SDL_PIXELFORMAT_RGB555
+    };
+    const char *saved_hint = SDL_GetHint(SDL_HINT_YUV_CONVERSION_THREADS);
+    char *saved = saved_hint ? SDL_strdup(saved_hint) : NULL;
+    const int w = 1922, h = 1083;
+    const int yuv_len = MAX_YUV_SURFACE_SIZE(w, h, 0);
+    Uint8 *yuv = (Uint8 *)SDL_malloc(yuv_len);
+    Uint8 *rgb1 = (Uint8 *)SDL_malloc(w * h * 4);
+    Uint8 *rgb2 = (Uint8 *)SDL_malloc(w * h * 4);
+    int i, j;
+    int result = -1;
+
+    if (!yuv || !rgb1 || !rgb2) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory");
+        goto done;
+    }
+    for (i = 0; i < yuv_len; ++i) {
+        yuv[i] = (Uint8)(i * 7 + (i / w) * 13);
+    }
+
+    for (i = 0; i < SDL_arraysize(yuv_formats); ++i) {
+        const int yuv_pitch = CalculateYUVPitch(yuv_formats[i], w);
+        for (j = 0; j < SDL_arraysize(rgb_formats); ++j) {
+            const int pitch = w * SDL_BYTESPERPIXEL(rgb_formats[j]);
+
+            SDL_SetHint(SDL_HINT_YUV_CONVERSION_THREADS, "1");
+            if (SDL_ConvertPixels(w, h, yuv_formats[i], yuv, yuv_pitch, rgb_formats[j], rgb1, pitch) < 0) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't convert %s to %s: %s\n", SDL_GetPixelFormatName(yuv_formats[i]), SDL_GetPixelFormatName(rgb_formats[j]), SDL_GetError());
+                goto done;
+            }
+            SDL_SetHint(SDL_HINT_YUV_CONVERSION_THREADS, "7");
+            if (SDL_ConvertPixels(w, h, yuv_formats[i], yuv, yuv_pitch, rgb_formats[j], rgb2, pitch) < 0) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't convert %s to %s: %s\n", SDL_GetPixelFormatName(yuv_formats[i]), SDL_GetPixelFormatName(rgb_formats[j]), SDL_GetError());
+                goto done;
+            }
+            if (SDL_memcmp(rgb1, rgb2, pitch * h) != 0) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Threaded conversion from %s to %s differs\n", SDL_GetPixelFormatName(yuv_formats[i]), SDL_GetPixelFormatName(rgb_formats[j]));
+                goto done;
+            }
+        }
+    }
+
+    result = 0;
+
+done:
+    SDL_SetHint(SDL_HINT_YUV_CONVERSION_THREADS, saved);
+    SDL_free(saved);
+    SDL_free(yuv);
+    SDL_free(rgb1);
+    SDL_free(rgb2);
+    return result;
+}
+
+/* The 16-bit formats have to narrow to exactly the samples of the 8-bit format
+   with the same layout, widen back from them losslessly, and convert to RGB
+   the same way that format does */
+static int run_16bit_yuv_tests(void)
+{
+    const Uint32 formats[] = {
+        SDL_PIXELFORMAT_P010,
+        SDL_PIXELFORMAT_P016,
+        SDL_PIXELFORMAT_I010
+    };
+    const int w = 1921, h = 1083;
+    const int samples = w * h + 2 * ((w + 1) / 2) * ((h + 1) / 2);
+    Uint16 *yuv16 = (Uint16 *)SDL_malloc(samples * sizeof(Uint16));
+    Uint8 *yuv8 = (Uint8 *)SDL_malloc(samples);
+    Uint8 *expected = (Uint8 *)SDL_malloc(samples);
+    Uint8 *rgb1 = (Uint8 *)SDL_malloc(w * h * 4);
+    Uint8 *rgb2 = (Uint8 *)SDL_malloc(w * h * 4);
+    int i, j;
+    int result = -1;
+
+    if (!yuv16 || !yuv8 || !expected || !rgb1 || !rgb2) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory");
+        goto done;
+    }
+
+    for (i = 0; i < SDL_arraysize(formats); ++i) {
+        const Uint32 format8 = (formats[i] == SDL_PIXELFORMAT_I010) ? SDL_PIXELFORMAT_IYUV : SDL_PIXELFORMAT_NV12;
+        const int shift = (formats[i] == SDL_PIXELFORMAT_I010) ? 2 : 8;
+
+        for (j = 0; j < samples; ++j) {
+            yuv16[j] = (Uint16)((j * 40503) ^ (j >> 5));
+            expected[j] = (Uint8)SDL_min(yuv16[j] >> shift, 255);
+        }
+
+        if (SDL_ConvertPixels(w, h, formats[i], yuv16, w * 2, format8, yuv8, w) < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't convert %s to %s: %s\n", SDL_GetPixelFormatName(formats[i]), SDL_GetPixelFormatName(format8), SDL_GetError());
+            goto done;
+        }
+        if (SDL_memcmp(yuv8, expected, samples) != 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Narrowing %s to %s gave the wrong samples\n", SDL_GetPixelFormatName(formats[i]), SDL_GetPixelFormatName(format8));
+            goto done;
+        }
+
+        if (SDL_ConvertPixels(w, h, formats[i], yuv16, w * 2, SDL_PIXELFORMAT_ARGB8888, rgb1, w * 4) < 0 ||
+            SDL_ConvertPixels(w, h, format8, yuv8, w, SDL_PIXELFORMAT_ARGB8888, rgb2, w * 4) < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't convert %s to RGB: %s\n", SDL_GetPixelFormatName(formats[i]), SDL_GetError());
+            goto done;
+        }
+        if (SDL_memcmp(rgb1, rgb2, w * h * 4) != 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Converting %s to RGB differs from %s\n", SDL_GetPixelFormatName(formats[i]), SDL_GetPixelFormatName(format8));
+            goto done;
+        }
+
+        if (SDL_ConvertPixels(w, h, format8, yuv8, w, formats[i], yuv16, w * 2) < 0 ||
+            SDL_ConvertPixels(w, h, formats[i], yuv16, w * 2, format8, expected, w) < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't convert between %s and %s: %s\n", SDL_GetPixelFormatName(format8), SDL_GetPixelFormatName(formats[i]), SDL_GetError());
+            goto done;
+        }
+        if (SDL_memcmp(yuv8, expected, samples) != 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Widening %s to %s and back lost precision\n", SDL_GetPixelFormatName(format8), SDL_GetPixelFormatName(formats[i]));
+            goto done;
+        }
+    }
+
+    result = 0;
+
+done:
+    SDL_free(yuv16);
+    SDL_free(yuv8);
+    SDL_free(expected);
+    SDL_free(rgb1);
+    SDL_free(rgb2);
+    return result;
+}
+
+/* Number of planes and bytes per row of plane 'plane' for the 8-bit planar formats */
+static int get_plane_layout(Uint32 format, int w, int h, int plane, int *row_bytes, int *rows)
+{
+    const int nplanes = (format == SDL_PIXELFORMAT_NV12 || format == SDL_PIXELFORMAT_NV21) ? 2 : 3;
+
+    if (plane == 0) {
+        *row_bytes = w;
+        *rows = h;
+    } else {
+        *row_bytes = ((w + 1) / 2) * (nplanes == 2 ? 2 : 1);
+        *rows = (h + 1) / 2;
+    }
+    return nplanes;
+}
+
+/* Copy separately allocated planes to another set of planes, returning the number of bytes copied */
+static int copy_planes(Uint32 format, int w, int h, Uint8 *src[3], const int src_pitches[3], Uint8 *dst[3], const int dst_pitches[3])
+{
+    int plane, nplanes = 1, row, row_bytes, rows;
+    int copied = 0;
+
+    for (plane = 0; plane < nplanes; ++plane) {
+        nplanes = get_plane_layout(format, w, h, plane, &row_bytes, &rows);
+        for (row = 0; row < rows; ++row) {
+            SDL_memcpy(dst[plane] + row * dst_pitches[plane], src[plane] + row * src_pitches[plane], row_bytes);
+        }
+        copied += row_bytes * rows;
+    }
+    return copied;
+}
+
+/* Draw a texture to the whole target and read the result back */
+static int render_texture(SDL_Renderer *renderer, SDL_Texture *texture, Uint8 *rgb, int rgb_pitch)
+{
+    SDL_RenderClear(renderer);
+    if (SDL_RenderCopy(renderer, texture, NULL, NULL) < 0 ||
+        SDL_RenderReadPixels(renderer, NULL, SDL_PIXELFORMAT_ARGB8888, rgb, rgb_pitch) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't render texture: %s\n", SDL_GetError());
+        return -1;
+    }
+    return 0;
+}
+
+/* Check that textures updated from separate planes match ones updated from a contiguous buffer */
+static int run_planar_texture_tests(void)
+{
+    const Uint32 formats[] = {
+        SDL_PIXELFORMAT_NV12,
+        SDL_PIXELFORMAT_NV21,
+        SDL_PIXELFORMAT_IYUV,
+        SDL_PIXELFORMAT_YV12
+    };
+    const int w = 641, h = 361;
+    const int rgb_pitch = w * 4;
+    const int contiguous_pitch = w;
+    SDL_Surface *target = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer *renderer = target ? SDL_CreateSoftwareRenderer(target) : NULL;
+    Uint8 *contiguous = (Uint8 *)SDL_malloc(MAX_YUV_SURFACE_SIZE(w, h, 0));
+    Uint8 *expected = (Uint8 *)SDL_malloc(rgb_pitch * h);
+    Uint8 *actual = (Uint8 *)SDL_malloc(rgb_pitch * h);
+    Uint8 *planes[3] = { NULL, NULL, NULL };
+    int pitches[3];
+    int i, j, plane;
+    int result = -1;
+
+    if (!renderer || !contiguous || !expected || !actual) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't set up renderer: %s\n", SDL_GetError());
+        goto done;
+    }
+
+    /* Decoder style output: separately allocated planes with padded rows */
+    for (plane = 0; plane < 3; ++plane) {
+        int row_bytes, rows;
+        get_plane_layout(SDL_PIXELFORMAT_IYUV, w, h, plane, &row_bytes, &rows);
+        pitches[plane] = 2 * row_bytes + 64;
+        planes[plane] = (Uint8 *)SDL_malloc(pitches[plane] * rows);
+        if (!planes[plane]) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory");
+            goto done;
+        }
+        for (j = 0; j < pitches[plane] * rows; ++j) {
+            planes[plane][j] = (Uint8)((j * 2654435761u) >> (8 + plane));
+        }
+    }
+
+    for (i = 0; i < SDL_arraysize(formats); ++i) {
+        const Uint32 format = formats[i];
+        const SDL_bool nv = (format == SDL_PIXELFORMAT_NV12 || format == SDL_PIXELFORMAT_NV21);
+        SDL_Texture *texture = SDL_CreateTexture(renderer, format, SDL_TEXTUREACCESS_STREAMING, w, h);
+        SDL_Rect rect;
+        Uint8 *contiguous_planes[3];
+        int contiguous_pitches[3];
+        Uint8 *locked_planes[3];
+        int locked_pitches[3];
+        Uint64 before;
+        int copied, contiguous_copied, planar_copied;
+
+        if (!texture) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create %s texture: %s\n", SDL_GetPixelFormatName(format), SDL_GetError());
+            goto done;
+        }
+
+        /* The reference: pack the planes into one buffer and update the texture with that */
+        contiguous_planes[0] = contiguous;
+        contiguous_pitches[0] = contiguous_pitch;
+        contiguous_planes[1] = contiguous_planes[0] + contiguous_pitch * h;
+        contiguous_pitches[1] = nv ? 2 * ((contiguous_pitch + 1) / 2) : (contiguous_pitch + 1) / 2;
+        contiguous_planes[2] = contiguous_planes[1] + contiguous_pitches[1] * ((h + 1) / 2);
+        contiguous_pitches[2] = contiguous_pitches[1];
+        copied = copy_planes(format, w, h, planes, pitches, contiguous_planes, contiguous_pitches);
+        before = SDL_GetYUVTextureCopyBytes();
+        if (SDL_UpdateTexture(texture, NULL, contiguous, contiguous_pitch) < 0) {
+            goto destroy;
+        }
+        contiguous_copied = copied + (int)(SDL_GetYUVTextureCopyBytes() - before);
+        if (render_texture(renderer, texture, expected, rgb_pitch) < 0) {
+            goto destroy;
+        }
+        SDL_Log("%-24s SDL_UpdateTexture: %d bytes copied per frame, %d by the application\n", SDL_GetPixelFormatName(format), contiguous_copied, copied);
+
+        /* Updating straight from the decoder planes */
+        SDL_memset(actual, 0, rgb_pitch * h);
+        before = SDL_GetYUVTextureCopyBytes();
+        if (nv) {
+            if (SDL_UpdateNVTexture(texture, NULL, planes[0], pitches[0], planes[1], pitches[1]) < 0) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't update %s texture: %s\n", SDL_GetPixelFormatName(format), SDL_GetError());
+                goto destroy;
+            }
+        } else {
+            /* YV12 stores the V plane first */
+            Uint8 *u = (format == SDL_PIXELFORMAT_YV12) ? planes[2] : planes[1];
+            Uint8 *v = (format == SDL_PIXELFORMAT_YV12) ? planes[1] : planes[2];
+            if (SDL_UpdateYUVTexture(texture, NULL, planes[0], pitches[0], u, pitches[1], v, pitches[2]) < 0) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't update %s texture: %s\n", SDL_GetPixelFormatName(format), SDL_GetError());
+                goto destroy;
+            }
+        }
+        planar_copied = (int)(SDL_GetYUVTextureCopyBytes() - before);
+        if (render_texture(renderer, texture, actual, rgb_pitch) < 0) {
+            goto destroy;
+        }
+        if (SDL_memcmp(expected, actual, rgb_pitch * h) != 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Planar update of %s texture differs from contiguous update\n", SDL_GetPixelFormatName(format));
+            goto destroy;
+        }
+        SDL_Log("%-24s %s: %d bytes copied per frame\n", SDL_GetPixelFormatName(format), nv ? "SDL_UpdateNVTexture" : "SDL_UpdateYUVTexture", planar_copied);
+        if (planar_copied >= contiguous_copied) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Planar update of %s texture doesn't copy less than a contiguous update\n", SDL_GetPixelFormatName(format));
+            goto destroy;
+        }
+
+        /* Writing the planes into the locked texture memory */
+        SDL_memset(actual, 0, rgb_pitch * h);
+        if (SDL_LockTexturePlanes(texture, NULL, locked_planes, locked_pitches) < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't lock %s texture planes: %s\n", SDL_GetPixelFormatName(format), SDL_GetError());
+            goto destroy;
+        }
+        if ((nv && locked_planes[2] != NULL) || (!nv && locked_planes[2] == NULL)) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Locking %s texture returned the wrong number of planes\n", SDL_GetPixelFormatName(format));
+            SDL_UnlockTexture(texture);
+            goto destroy;
+        }
+        copied = copy_planes(format, w, h, planes, pitches, locked_planes, locked_pitches);
+        before = SDL_GetYUVTextureCopyBytes();
+        SDL_UnlockTexture(texture);
+        copied += (int)(SDL_GetYUVTextureCopyBytes() - before);
+        if (render_texture(renderer, texture, actual, rgb_pitch) < 0) {
+            goto destroy;
+        }
+        if (SDL_memcmp(expected, actual, rgb_pitch * h) != 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Locked plane update of %s texture differs from contiguous update\n", SDL_GetPixelFormatName(format));
+            goto destroy;
+        }
+        SDL_Log("%-24s SDL_LockTexturePlanes: %d bytes copied per frame\n", SDL_GetPixelFormatName(format), copied);
+        if (copied >= contiguous_copied) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Locked plane update of %s texture doesn't copy less than a contiguous update\n", SDL_GetPixelFormatName(format));
+            goto destroy;
+        }
+
+        /* Partial updates must touch the same texels as contiguous ones */
+        rect.x = 64;
+        rect.y = 32;
+        rect.w = 301;
+        rect.h = 199;
+        if (SDL_LockTexturePlanes(texture, &rect, locked_planes, locked_pitches) == 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Locking part of a %s texture's planes should fail\n", SDL_GetPixelFormatName(format));
+            SDL_UnlockTexture(texture);
+            goto destroy;
+        }
+        if (nv) {
+            contiguous_pitches[1] = 2 * ((contiguous_pitch + 1) / 2);
+            contiguous_planes[1] = contiguous_planes[0] + contiguous_pitch * rect.h;
+            copy_planes(format, rect.w, rect.h, planes, pitches, contiguous_planes, contiguous_pitches);
+            if (SDL_UpdateTexture(texture, &rect, contiguous, contiguous_pitch) < 0 ||
+                render_texture(renderer, texture, expected, rgb_pitch) < 0) {
+                goto destroy;
+            }
+            /* Scramble the rect with different samples so the planar update has to fix it up */
+            if (SDL_UpdateNVTexture(texture, &rect, planes[0] + 1, pitches[0], planes[1] + 2, pitches[1]) < 0 ||
+                SDL_UpdateNVTexture(texture, &rect, planes[0], pitches[0], planes[1], pitches[1]) < 0 ||
+                render_texture(renderer, texture, actual, rgb_pitch) < 0) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't update part of %s texture: %s\n", SDL_GetPixelFormatName(format), SDL_GetError());
+                goto destroy;
+            }
+            if (SDL_memcmp(expected, actual, rgb_pitch * h) != 0) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Partial planar update of %s texture differs from contiguous update\n", SDL_GetPixelFormatName(format));
+                goto destroy;
+            }
+        } else if (SDL_UpdateNVTexture(texture, NULL, planes[0], pitches[0], planes[1], pitches[1]) == 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "SDL_UpdateNVTexture() should reject %s textures\n", SDL_GetPixelFormatName(format));
+            goto destroy;
+        }
+
+        SDL_DestroyTexture(texture);
+        continue;
+
+destroy:
+        SDL_DestroyTexture(texture);
+        goto done;
+    }
+
+    result = 0;
+
+done:
+    for (plane = 0; plane < 3; ++plane) {
+        SDL_free(planes[plane]);
+    }
+    SDL_free(contiguous);
+    SDL_free(expected);
+    SDL_free(actual);
+    if (renderer) {
+        SDL_DestroyRenderer(renderer);
+    }
+    SDL_FreeSurface(target);
+    return result;
+}
+
+/* Time converting a w x h frame from one format to another */
+static int time_conversion(int w, int h, Uint32 src_format, const void *src, int src_pitch, Uint32 dst_format, void *dst, int dst_pitch, int iterations)
+{
+    Uint64 start, elapsed;
+    double ms;
+    int n;
+
+    start = SDL_GetPerformanceCounter();
+    for (n = 0; n < iterations; ++n) {
+        if (SDL_ConvertPixels(w, h, src_format, src, src_pitch, dst_format, dst, dst_pitch) < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't convert %s to %s: %s\n", SDL_GetPixelFormatName(src_format), SDL_GetPixelFormatName(dst_format), SDL_GetError());
+            return -1;
+        }
+    }
+    elapsed = SDL_GetPerformanceCounter() - start;
+    ms = (double)elapsed * 1000.0 / SDL_GetPerformanceFrequency() / iterations;
+    SDL_Log("%-24s -> %-24s %6.2f ms/frame, %7.1f Mpixels/s\n",
+            SDL_GetPixelFormatName(src_format), SDL_GetPixelFormatName(dst_format),
+            ms, (w * h) / (ms * 1000.0));
+    return 0;
+}
+
+/* Time converting a 1080p frame from each RGB format to each YUV format and back */
+static int run_benchmark(int iterations)
+{
+    const Uint32 rgb_formats[] = {
+        SDL_PIXELFORMAT_ARGB8888,
+        SDL_PIXELFORMAT_ABGR8888,
+        SDL_PIXELFORMAT_RGBA8888,
+        SDL_PIXELFORMAT_BGRA8888,
+        SDL_PIXELFORMAT_RGB24,
+        SDL_PIXELFORMAT_RGB565
+    };
+    const Uint32 yuv_formats[] = {
+        SDL_PIXELFORMAT_YV12,
+        SDL_PIXELFORMAT_IYUV,
+        SDL_PIXELFORMAT_NV12,
+        SDL_PIXELFORMAT_NV21,
+        SDL_PIXELFORMAT_YUY2,
+        SDL_PIXELFORMAT_UYVY,
+        SDL_PIXELFORMAT_YVYU,
+        SDL_PIXELFORMAT_P010,
+        SDL_PIXELFORMAT_I010
+    };
+    const int w = 1920, h = 1080;
+    const int rgb_pitch = w * 4;
+    Uint8 *rgb = (Uint8 *)SDL_malloc(rgb_pitch * h);
+    Uint8 *yuv = (Uint8 *)SDL_malloc(MAX_YUV_SURFACE_SIZE(w, h, 0));
+    int i, j;
+    int result = -1;
+
+    if (!rgb || !yuv) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory");
+        goto done;
+    }
+    for (i = 0; i < rgb_pitch * h; ++i) {
+        rgb[i] = (Uint8)(i * 7 + (i / rgb_pitch) * 13);
+    }
+
+    for (i = 0; i < SDL_arraysize(rgb_formats); ++i) {
+        for (j = 0; j < SDL_arraysize(yuv_formats); ++j) {
+            const int pitch = w * SDL_BYTESPERPIXEL(rgb_formats[i]);
+            if (time_conversion(w, h, rgb_formats[i], rgb, pitch, yuv_formats[j], yuv, CalculateYUVPitch(yuv_formats[j], w), iterations) < 0) {
+                goto done;
+            }
+        }
+    }
+
+    for (j = 0; j < SDL_arraysize(yuv_formats); ++j) {
+        const int yuv_pitch = CalculateYUVPitch(yuv_formats[j], w);
+        if (SDL_ConvertPixels(w, h, SDL_PIXELFORMAT_ARGB8888, rgb, rgb_pitch, yuv_formats[j], yuv, yuv_pitch) < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't convert to %s: %s\n", SDL_GetPixelFormatName(yuv_formats[j]), SDL_GetError());
+            goto done;
+        }
+        for (i = 0; i < SDL_arraysize(rgb_formats); ++i) {
+            const int pitch = w * SDL_BYTESPERPIXEL(rgb_formats[i]);
+            if (time_conversion(w, h, yuv_formats[j], yuv, yuv_pitch, rgb_formats[i], rgb, pitch, iterations) < 0) {
+                goto done;
+            }
+        }
+    }
+
+    /* Narrowing 16-bit frames to the 8-bit format with the same layout */
+    for (j = 0; j < SDL_arraysize(yuv_formats); ++j) {
+        if (is_16bit_yuv_format(yuv_formats[j])) {
+            const Uint32 format8 = (yuv_formats[j] == SDL_PIXELFORMAT_I010) ? SDL_PIXELFORMAT_IYUV : SDL_PIXELFORMAT_NV12;
+            if (time_conversion(w, h, yuv_formats[j], yuv, CalculateYUVPitch(yuv_formats[j], w), format8, rgb, w, iterations) < 0) {
+                goto done;
+            }
+        }
+    }
+
+    result = 0;
+
+done:
+    SDL_free(rgb);
+    SDL_free(yuv);
+    return result;
+}
+
+/* Time converting a 4K frame to RGB on one thread and on all of the CPU cores */
+static int run_threaded_benchmark(int iterations)
+{
+    const Uint32 yuv_formats[] = {
+        SDL_PIXELFORMAT_IYUV,
+        SDL_PIXELFORMAT_NV12,
+        SDL_PIXELFORMAT_YUY2
+    };
+    const char *threads[] = { "1", "0" };
+    const char *saved_hint = SDL_GetHint(SDL_HINT_YUV_CONVERSION_THREADS);
+    char *saved = saved_hint ? SDL_strdup(saved_hint) : NULL;
+    const int w = 3840, h = 2160;
+    const int rgb_pitch = w * 4;
+    const int yuv_len = MAX_YUV_SURFACE_SIZE(w, h, 0);
+    Uint8 *rgb = (Uint8 *)SDL_malloc(rgb_pitch * h);
+    Uint8 *yuv = (Uint8 *)SDL_malloc(yuv_len);
+    int i, j;
+    int result = -1;
+
+    if (!rgb || !yuv) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory");
+        goto done;
+    }
+    for (i = 0; i < yuv_len; ++i) {
+        yuv[i] = (Uint8)(i * 7 + (i / w) * 13);
+    }
+
+    SDL_Log("Converting %dx%d frames with %d CPU cores\n", w, h, SDL_GetCPUCount());
+    for (j = 0; j < SDL_arraysize(threads); ++j) {
+        SDL_SetHint(SDL_HINT_YUV_CONVERSION_THREADS, threads[j]);
+        SDL_Log("%s=%s\n", SDL_HINT_YUV_CONVERSION_THREADS, threads[j]);
+        for (i = 0; i < SDL_arraysize(yuv_formats); ++i) {
+            if (time_conversion(w, h, yuv_formats[i], yuv, CalculateYUVPitch(yuv_formats[i], w), SDL_PIXELFORMAT_ARGB8888, rgb, rgb_pitch, iterations) < 0) {
+                goto done;
+            }
+        }
+    }
+
+    result = 0;
+
+done:
+    SDL_SetHint(SDL_HINT_YUV_CONVERSION_THREADS, saved);
+    SDL_free(saved);
+    SDL_free(rgb);
+    SDL_free(yuv);
+    return result;
+}
+
 int
 main(int argc, char **argv)
 {
@@ -265,6 +939,7 @@ main(int argc, char **argv)
     Uint8 *raw_yuv;
     Uint32 then, now, i, iterations = 100;
     SDL_bool should_run_automated_tests = SDL_FALSE;
+    SDL_bool should_run_benchmark = SDL_FALSE;
 
     while (argv[arg] && *argv[arg] == '-') {
         if (SDL_strcmp(argv[arg], "--jpeg") == 0) {
@@ -289,6 +964,12 @@ main(int argc, char **argv)
             yuv_format = SDL_PIXELFORMAT_NV12;
         } else if (SDL_strcmp(argv[arg], "--nv21") == 0) {
             yuv_format = SDL_PIXELFORMAT_NV21;
+        } else if (SDL_strcmp(argv[arg], "--p010") == 0) {
+            yuv_format = SDL_PIXELFORMAT_P010;
+        } else if (SDL_strcmp(argv[arg], "--p016") == 0) {
+            yuv_format = SDL_PIXELFORMAT_P016;
+        } else if (SDL_strcmp(argv[arg], "--i010") == 0) {
+            yuv_format = SDL_PIXELFORMAT_I010;
         } else if (SDL_strcmp(argv[arg], "--rgb555") == 0) {
             rgb_format = SDL_PIXELFORMAT_RGB555;
         } else if (SDL_strcmp(argv[arg], "--rgb565") == 0) {
@@ -305,8 +986,10 @@ main(int argc, char **argv)
             rgb_format = SDL_PIXELFORMAT_BGRA8888;
         } else if (SDL_strcmp(argv[arg], "--automated") == 0) {
             should_run_automated_tests = SDL_TRUE;
+        } else if (SDL_strcmp(argv[arg], "--benchmark") == 0) {
+            should_run_benchmark = SDL_TRUE;
         } else {
-            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Usage: %s [--jpeg|--bt601|-bt709|--auto] [--yv12|--iyuv|--yuy2|--uyvy|--yvyu|--nv12|--nv21] [--rgb555|--rgb565|--rgb24|--argb|--abgr|--rgba|--bgra] [image_filename]\n", argv[0]);
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Usage: %s [--jpeg|--bt601|-bt709|--auto] [--yv12|--iyuv|--yuy2|--uyvy|--yvyu|--nv12|--nv21|--p010|--p016|--i010] [--rgb555|--rgb565|--rgb24|--argb|--abgr|--rgba|--bgra] [--automated|--benchmark] [image_filename]\n", argv[0]);
             return 1;
         }
         ++arg;
@@ -323,6 +1006,30 @@ main(int argc, char **argv)
                 return 2;
             }
         }
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Running automated test, YUV to RGB conversion matches the C reference\n");
+        if (run_yuv_to_rgb_exactness_tests() < 0) {
+            return 2;
+        }
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Running automated test, threaded YUV to RGB conversion\n");
+        if (run_threaded_conversion_tests() < 0) {
+            return 2;
+        }
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Running automated test, 16-bit YUV formats\n");
+        if (run_16bit_yuv_tests() < 0) {
+            return 2;
+        }
+        SDL_LogInfo(SDL_LOG_CATEGORY_APPLICATION, "Running automated test, planar texture updates\n");
+        if (run_planar_texture_tests() < 0) {
+            return 2;
+        }
+        return 0;
+    }
+
+    /* Run the RGB and YUV conversion benchmark */
+    if (should_run_benchmark) {
+        if (run_benchmark(iterations) < 0 || run_threaded_benchmark(iterations) < 0) {
+            return 2;
+        }
         return 0;
     }
 
@@ -259,6 +259,39 @@ static void ConvertRGBtoPacked4(Uint32 format, Uint8 *src, int pitch, Uint8 *out
     }
 }
 
+/* The 16-bit formats are generated from the 8-bit format with the same layout,
+   widening each sample the way SDL_ConvertPixels() does */
+static SDL_bool ConvertRGBtoYUV16(Uint32 format, Uint8 *src, int pitch, Uint8 *out, int w, int h, SDL_YUV_CONVERSION_MODE mode, int monochrome, int luminance)
+{
+    const Uint32 format8 = (format == SDL_PIXELFORMAT_I010) ? SDL_PIXELFORMAT_IYUV : SDL_PIXELFORMAT_NV12;
+    const int samples = w * h + 2 * ((w + 1) / 2) * ((h + 1) / 2);
+    Uint8 *yuv8 = (Uint8 *)SDL_malloc(samples);
+    Uint16 *yuv16 = (Uint16 *)out;
+    int i;
+
+    if (!yuv8) {
+        return SDL_FALSE;
+    }
+
+    ConvertRGBtoPlanar2x2(format8, src, pitch, yuv8, w, h, mode, monochrome, luminance);
+    for (i = 0; i < samples; ++i) {
+        const Uint16 value = (Uint16)(yuv8[i] * 257);
+        switch (format) {
+        case SDL_PIXELFORMAT_P010:
+            yuv16[i] = value & 0xFFC0;
+            break;
+        case SDL_PIXELFORMAT_I010:
+            yuv16[i] = value >> 6;
+            break;
+        default:
+            yuv16[i] = value;
+            break;
+        }
+    }
+    SDL_free(yuv8);
+    return SDL_TRUE;
+}
+
 SDL_bool ConvertRGBtoYUV(Uint32 format, Uint8 *src, int pitch, Uint8 *out, int w, int h, SDL_YUV_CONVERSION_MODE mode, int monochrome, int luminance)
 {
     switch (format)
@@ -274,6 +307,10 @@ SDL_bool ConvertRGBtoYUV(Uint32 format, Uint8 *src, int pitch, Uint8 *out, int w
     case SDL_PIXELFORMAT_YVYU:
         ConvertRGBtoPacked4(format, src, pitch, out, w, h, mode, monochrome, luminance);
         return SDL_TRUE;
+    case SDL_PIXELFORMAT_P010:
+    case SDL_PIXELFORMAT_P016:
+    case SDL_PIXELFORMAT_I010:
+        return ConvertRGBtoYUV16(format, src, pitch, out, w, h, mode, monochrome, luminance);
     default:
         return SDL_FALSE;
     }
@@ -292,6 +329,10 @@ int CalculateYUVPitch(Uint32 format, int width)
     case SDL_PIXELFORMAT_UYVY:
     case SDL_PIXELFORMAT_YVYU:
         return 4*((width + 1)/2);
+    case SDL_PIXELFORMAT_P010:
+    case SDL_PIXELFORMAT_P016:
+    case SDL_PIXELFORMAT_I010:
+        return 2*width;
     default:
         return 0;
     }